@@ -0,0 +1,301 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/SAAILodScheduler.h"
+#include "GameFramework/SAWorldEntity.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace SA
+{
+	namespace AILodSchedulerTests
+	{
+		using glm::vec3;
+		using ETier = AILodScheduler::ETier;
+
+		class AILodScheduler_UnitTest : public SA::UnitTest
+		{
+		public:
+			AILodScheduler_UnitTest()
+			{
+				testNamespace = "AILodScheduler:";
+			}
+
+		protected:
+			/** stands in for a brain; remembers how often and with how much time it was ticked */
+			class CountingTicker : public ITickable
+			{
+			public:
+				virtual bool tick(float dt_sec) override
+				{
+					++numTicks;
+					receivedDt += dt_sec;
+					for (size_t work = 0; work < workPerTick; ++work)
+					{
+						busyWork = busyWork * 1.0001f + 1.f;
+					}
+					if (onTick) { onTick(); }
+					return bKeepTicking;
+				}
+			public:
+				size_t numTicks = 0;
+				double receivedDt = 0.0;
+				size_t workPerTick = 0;
+				float busyWork = 0.f;
+				bool bKeepTicking = true;
+				std::function<void()> onTick;
+			};
+
+			struct Agent
+			{
+				sp<WorldEntity> anchor;
+				sp<CountingTicker> ticker;
+			};
+
+			/** camera at the origin looking down -z */
+			static void setCamera(AILodScheduler& scheduler)
+			{
+				const glm::mat4 view = glm::lookAt(vec3(0.f), vec3(0.f, 0.f, -1.f), vec3(0.f, 1.f, 0.f));
+				const glm::mat4 projection = glm::perspective(glm::radians(45.f), 1.f, 0.1f, 20000.f);
+				scheduler.setViewers(std::vector<vec3>{ vec3(0.f) }, projection * view);
+			}
+
+			static Agent addAgent(AILodScheduler& scheduler, const vec3& position)
+			{
+				Transform xform;
+				xform.position = position;
+				Agent agent{ new_sp<WorldEntity>(xform), new_sp<CountingTicker>() };
+				scheduler.addAgent(agent.ticker.get(), agent.anchor);
+				scheduler.registerTicker(agent.ticker, agent.ticker.get());
+				return agent;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_TiersFromCameras : public AILodScheduler_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Agents are tiered by camera distance, dropped a tier offscreen, and left at full rate without a camera";
+
+				AILodScheduler scheduler;
+				const std::vector<Agent> agents = {
+					addAgent(scheduler, vec3(0.f, 0.f, -100.f)),
+					addAgent(scheduler, vec3(0.f, 0.f, -500.f)),
+					addAgent(scheduler, vec3(0.f, 0.f, -2000.f)),
+					addAgent(scheduler, vec3(0.f, 0.f, -5000.f)),
+					addAgent(scheduler, vec3(0.f, 0.f, 100.f)),		//behind the camera
+					addAgent(scheduler, vec3(0.f, 0.f, 5000.f)),	//behind and already in the last tier
+				};
+				const std::vector<ETier> expected = { ETier::FULL, ETier::HALF, ETier::QUARTER, ETier::EIGHTH, ETier::HALF, ETier::EIGHTH };
+
+				scheduler.tick(0.01f);
+				for (const Agent& agent : agents)
+				{
+					if (scheduler.getAgentTier(agent.ticker.get()) != ETier::FULL)
+					{
+						errorMessage = "agents were slowed down with no camera";
+						return false;
+					}
+				}
+
+				setCamera(scheduler);
+				scheduler.tick(0.01f);
+				for (size_t agentIdx = 0; agentIdx < agents.size(); ++agentIdx)
+				{
+					if (scheduler.getAgentTier(agents[agentIdx].ticker.get()) != expected[agentIdx])
+					{
+						errorMessage = "wrong tier for agent " + std::to_string(agentIdx);
+						return false;
+					}
+				}
+				if (scheduler.getTierStats(ETier::FULL).numAgents != 1 || scheduler.getTierStats(ETier::HALF).numAgents != 2
+					|| scheduler.getTierStats(ETier::QUARTER).numAgents != 1 || scheduler.getTierStats(ETier::EIGHTH).numAgents != 2)
+				{
+					errorMessage = "tier stats do not match the tiers";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_ReducedRateKeepsTime : public AILodScheduler_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Reduced rate agents get all their time, and a tier's ticks are spread evenly over frames";
+
+				AILodScheduler scheduler;
+				setCamera(scheduler);
+				std::vector<Agent> agents;
+				for (size_t agentIdx = 0; agentIdx < 80; ++agentIdx)
+				{
+					agents.push_back(addAgent(scheduler, vec3(float(agentIdx), 0.f, -5000.f))); //all in the eighth rate tier
+				}
+
+				const float dt = 0.01f;
+				const size_t numFrames = 64;
+				size_t fewestTicks = agents.size();
+				size_t mostTicks = 0;
+				for (size_t frame = 0; frame < numFrames; ++frame)
+				{
+					scheduler.tick(dt);
+					const size_t ticksThisFrame = scheduler.getTierStats(ETier::EIGHTH).numTicks;
+					fewestTicks = std::min(fewestTicks, ticksThisFrame);
+					mostTicks = std::max(mostTicks, ticksThisFrame);
+				}
+
+				if (mostTicks - fewestTicks > 1)
+				{
+					errorMessage = "ticks bunched up on some frames: " + std::to_string(fewestTicks) + " to " + std::to_string(mostTicks) + " per frame";
+					return false;
+				}
+				for (const Agent& agent : agents)
+				{
+					//whatever an agent has not received yet is only the time since its last tick, less than one interval
+					const double notYetReceived = numFrames * dt - agent.ticker->receivedDt;
+					if (agent.ticker->numTicks != numFrames / 8 || notYetReceived < -0.0001 || notYetReceived > 7 * dt + 0.0001)
+					{
+						errorMessage = "an agent was ticked the wrong number of times or lost time";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_PlayerRelevantAtFullRate : public AILodScheduler_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Agents relevant to a player tick every frame, and tickers can come and go mid tick";
+
+				AILodScheduler scheduler;
+				setCamera(scheduler);
+				Agent fighting = addAgent(scheduler, vec3(0.f, 0.f, 8000.f));
+				Agent ignored = addAgent(scheduler, vec3(10.f, 0.f, 8000.f));
+				const WorldEntity* fightingAnchor = fighting.anchor.get();
+				scheduler.setPlayerRelevance([fightingAnchor](const WorldEntity& anchor) { return &anchor == fightingAnchor; });
+
+				//a task of the ignored agent's tree; it finishes after its first tick and starts a follow up task
+				sp<CountingTicker> followUp = new_sp<CountingTicker>();
+				sp<CountingTicker> task = new_sp<CountingTicker>();
+				task->bKeepTicking = false;
+				task->onTick = [&scheduler, &followUp, &ignored]() { scheduler.registerTicker(followUp, ignored.ticker.get()); };
+				scheduler.registerTicker(task, ignored.ticker.get());
+
+				for (size_t frame = 0; frame < 16; ++frame)
+				{
+					scheduler.tick(0.01f);
+				}
+
+				if (fighting.ticker->numTicks != 16 || scheduler.getNumPlayerRelevantAgents() != 1)
+				{
+					errorMessage = "player relevant agent was not ticked every frame";
+					return false;
+				}
+				if (ignored.ticker->numTicks != 2)
+				{
+					errorMessage = "far offscreen agent should tick at an eighth of the rate";
+					return false;
+				}
+				if (task->numTicks != 1 || scheduler.hasRegisteredTicker(task) || !scheduler.hasRegisteredTicker(followUp) || followUp->numTicks != 1)
+				{
+					errorMessage = "tickers added or removed while ticking were not handled";
+					return false;
+				}
+
+				//agents that leave fall back to full rate for any ticker still registered against them
+				scheduler.removeAgent(ignored.ticker.get());
+				scheduler.removeTicker(ignored.ticker);
+				scheduler.tick(0.01f);
+				if (followUp->numTicks != 2 || scheduler.hasRegisteredTicker(ignored.ticker) || scheduler.getNumAgents() != 1)
+				{
+					errorMessage = "removing an agent left stale state";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_LargeBattle : public AILodScheduler_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "2000 brains spread through a battle, no camera (full rate) vs tiered by the camera";
+
+				AILodScheduler scheduler;
+				std::vector<Agent> agents;
+				for (size_t agentIdx = 0; agentIdx < 2000; ++agentIdx)
+				{
+					//a ring of ships out to 6000 units, so every tier is populated
+					const float angle = float(agentIdx) * 2.39996f;
+					const float radius = 50.f + 3.f * float(agentIdx);
+					agents.push_back(addAgent(scheduler, vec3(radius * std::cos(angle), 0.f, radius * std::sin(angle))));
+					agents.back().ticker->workPerTick = 2000;
+				}
+
+				using Clock = std::chrono::high_resolution_clock;
+				const size_t numFrames = 64;
+				Clock::time_point start = Clock::now();
+				for (size_t frame = 0; frame < numFrames; ++frame)
+				{
+					scheduler.tick(0.016f);
+				}
+				const double fullRateMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / numFrames;
+
+				setCamera(scheduler);
+				start = Clock::now();
+				for (size_t frame = 0; frame < numFrames; ++frame)
+				{
+					scheduler.tick(0.016f);
+				}
+				const double tieredMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / numFrames;
+
+				std::cout << "\t\t" << "full rate " << fullRateMs << "ms/frame | tiered " << tieredMs << "ms/frame, tiering " << scheduler.getTieringMs() << "ms" << std::endl;
+				static const char* tierNames[] = { "full", "half", "quarter", "eighth" };
+				for (size_t tierIdx = 0; tierIdx < AILodScheduler::NUM_TIERS; ++tierIdx)
+				{
+					const AILodScheduler::TierStats& stats = scheduler.getTierStats(ETier(tierIdx));
+					std::cout << "\t\t\t" << tierNames[tierIdx] << ": " << stats.numAgents << " agents, " << stats.numTicks << " ticked last frame in " << stats.tickMs << "ms" << std::endl;
+				}
+
+				if (tieredMs >= fullRateMs)
+				{
+					errorMessage = "tiering did not save any time";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class AILodSchedulerTestSuite : public SA::TestSuite
+		{
+		public:
+			AILodSchedulerTestSuite()
+			{
+				testName = "AI LOD SCHEDULER TEST SUITE";
+
+				addTest(new_sp<Test_TiersFromCameras>());
+				addTest(new_sp<Test_ReducedRateKeepsTime>());
+				addTest(new_sp<Test_PlayerRelevantAtFullRate>());
+				addTest(new_sp<Benchmark_LargeBattle>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getAILodSchedulerTestSuite()
+	{
+		return new_sp<SA::AILodSchedulerTests::AILodSchedulerTestSuite>();
+	}
+}
@@ -0,0 +1,263 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/Audio/AudioDecoder.h"
+#include "GameFramework/Audio/AudioStream.h"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+
+#include <Libraries/dr_lib/dr_wav.h>
+
+namespace SA
+{
+	namespace AudioStreamTests
+	{
+		class AudioStream_UnitTest : public SA::UnitTest
+		{
+		public:
+			AudioStream_UnitTest()
+			{
+				testNamespace = "AudioStream:";
+			}
+
+		protected:
+			/** a deterministic stereo sound where every sample is distinct enough to catch dropped or repeated frames */
+			static std::vector<int16_t> makeSamples(uint64_t numFrames)
+			{
+				std::vector<int16_t> samples(size_t(numFrames * 2));
+				for (uint64_t frame = 0; frame < numFrames; ++frame)
+				{
+					samples[size_t(frame * 2)] = int16_t(frame * 7 % 65521);
+					samples[size_t(frame * 2 + 1)] = int16_t(-int32_t(frame % 30011));
+				}
+				return samples;
+			}
+
+			/** writes the samples to a throwaway wav in the temp directory */
+			static std::string makeWavFile(const char* name, const std::vector<int16_t>& samples)
+			{
+				std::string path = (std::filesystem::temp_directory_path() / name).string();
+
+				drwav_data_format format;
+				format.container = drwav_container_riff;
+				format.format = DR_WAVE_FORMAT_PCM;
+				format.channels = 2;
+				format.sampleRate = 44100;
+				format.bitsPerSample = 16;
+
+				drwav wav;
+				if (drwav_init_file_write(&wav, path.c_str(), &format, nullptr))
+				{
+					drwav_write_pcm_frames(&wav, samples.size() / 2, samples.data());
+					drwav_uninit(&wav);
+				}
+				return path;
+			}
+
+			static void removeFile(const std::string& path)
+			{
+				std::error_code ec;
+				std::filesystem::remove(path, ec);
+			}
+
+			/** stands in for the audio device: takes every chunk the stream has, like the api queue would */
+			static void drainInto(AudioStream& stream, std::vector<int16_t>& outSamples)
+			{
+				while (const AudioStream::Chunk* chunk = stream.peekChunk())
+				{
+					outSamples.insert(outSamples.end(), chunk->samples.begin(), chunk->samples.begin() + chunk->numFrames * stream.getChannels());
+					stream.popChunk();
+				}
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_StreamMatchesSource : public AudioStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Streaming through the decoder thread reproduces the sound exactly";
+
+				const std::vector<int16_t> source = makeSamples(100000);
+				const std::string path = makeWavFile("sa_audiostream_match.wav", source);
+
+				sp<AudioDecoder> decoder = AudioDecoder::open(path);
+				if (!decoder || decoder->getChannels() != 2 || decoder->getTotalFrames() != 100000)
+				{
+					removeFile(path);
+					errorMessage = "decoder did not read the wav header";
+					return false;
+				}
+
+				std::vector<int16_t> streamed;
+				{
+					sp<AudioStream> stream = new_sp<AudioStream>(decoder, 1000, 3, /*bLooping*/false);
+					AudioStreamDecoderThread decoderThread;
+					decoderThread.addStream(stream);
+
+					using Clock = std::chrono::steady_clock;
+					Clock::time_point giveUp = Clock::now() + std::chrono::seconds(10);
+					while (!stream->isFinished() && Clock::now() < giveUp)
+					{
+						drainInto(*stream, streamed);
+						decoderThread.wake();
+					}
+					decoderThread.removeStream(stream);
+				}
+				removeFile(path);
+
+				if (streamed != source)
+				{
+					errorMessage = "streamed samples differ from the source";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_LoopingIsSeamless : public AudioStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Looping streams wrap to the start with no gap, even mid chunk";
+
+				const std::vector<int16_t> source = makeSamples(2500); //not a multiple of the chunk size
+				const std::string path = makeWavFile("sa_audiostream_loop.wav", source);
+
+				sp<AudioStream> stream = new_sp<AudioStream>(AudioDecoder::open(path), 1024, 2, /*bLooping*/true);
+				std::vector<int16_t> streamed;
+				while (streamed.size() < source.size() * 3)
+				{
+					if (!stream->decodeNextChunk())
+					{
+						break;
+					}
+					drainInto(*stream, streamed);
+				}
+				removeFile(path);
+
+				if (streamed.size() < source.size() * 3 || stream->isFinished())
+				{
+					errorMessage = "looping stream ended";
+					return false;
+				}
+				for (size_t sampleIdx = 0; sampleIdx < streamed.size(); ++sampleIdx)
+				{
+					if (streamed[sampleIdx] != source[sampleIdx % source.size()])
+					{
+						errorMessage = "loop point dropped or repeated frames";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_ResidencyAndFormats : public AudioStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Stream residency is bounded and unknown formats are rejected";
+
+				const std::vector<int16_t> source = makeSamples(44100 * 30); //30 seconds
+				const std::string path = makeWavFile("sa_audiostream_long.wav", source);
+
+				sp<AudioDecoder> decoder = AudioDecoder::open(path);
+				sp<AudioStream> stream = new_sp<AudioStream>(decoder, 8192, 4, /*bLooping*/false);
+				const size_t fullBytes = source.size() * sizeof(int16_t);
+				const bool bBounded = stream->getResidentBytes() == 8192 * 4 * 2 * sizeof(int16_t) && stream->getResidentBytes() * 40 < fullBytes;
+				const float durationSec = decoder->getDurationSec();
+				stream = nullptr;
+				decoder = nullptr;
+				removeFile(path);
+
+				if (!bBounded)
+				{
+					errorMessage = "stream holds more than its ring of chunks";
+					return false;
+				}
+				if (std::abs(durationSec - 30.f) > 0.001f)
+				{
+					errorMessage = "duration from the header is wrong";
+					return false;
+				}
+				if (AudioDecoder::open(path) || AudioDecoder::open("sound.ogg"))
+				{
+					errorMessage = "missing file or unknown format produced a decoder";
+					return false;
+				}
+
+				sp<AudioStream> nullStream = new_sp<AudioStream>(nullptr, 8192, 4, false);
+				if (nullStream->decodeNextChunk() || !nullStream->isFinished())
+				{
+					errorMessage = "stream without a decoder should be finished";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_TimeToFirstAudio : public AudioStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Time until a long sound can start playing, streamed vs fully decoded";
+
+				const std::vector<int16_t> source = makeSamples(44100 * 60); //a minute of music
+				const std::string path = makeWavFile("sa_audiostream_bench.wav", source);
+
+				using Clock = std::chrono::high_resolution_clock;
+				//a full decode the way resident sounds are loaded
+				Clock::time_point start = Clock::now();
+				sp<AudioDecoder> fullDecoder = AudioDecoder::open(path);
+				std::vector<int16_t> fullDecode(size_t(fullDecoder->getTotalFrames() * fullDecoder->getChannels()));
+				fullDecoder->readFrames(fullDecode.data(), fullDecoder->getTotalFrames());
+				const double fullMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				start = Clock::now();
+				sp<AudioStream> stream = new_sp<AudioStream>(AudioDecoder::open(path), 8192, 4, /*bLooping*/false);
+				while (stream->decodeNextChunk()) {} //what the audio system primes before playing
+				const double streamMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+				removeFile(path);
+
+				const size_t fullBytes = fullDecode.size() * sizeof(int16_t);
+				std::cout << "\t\t" << "full decode " << fullMs << "ms, " << fullBytes / 1024 << "KB resident | stream "
+					<< streamMs << "ms, " << stream->getResidentBytes() / 1024 << "KB resident" << std::endl;
+
+				if (fullDecode != source)
+				{
+					errorMessage = "full decode differs from the source";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class AudioStreamTestSuite : public SA::TestSuite
+		{
+		public:
+			AudioStreamTestSuite()
+			{
+				testName = "AUDIO STREAM TEST SUITE";
+
+				addTest(new_sp<Test_StreamMatchesSource>());
+				addTest(new_sp<Test_LoopingIsSeamless>());
+				addTest(new_sp<Test_ResidencyAndFormats>());
+				addTest(new_sp<Benchmark_TimeToFirstAudio>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getAudioStreamTestSuite()
+	{
+		return new_sp<SA::AudioStreamTests::AudioStreamTestSuite>();
+	}
+}
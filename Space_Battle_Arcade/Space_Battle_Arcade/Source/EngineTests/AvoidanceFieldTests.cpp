@@ -0,0 +1,463 @@
+#include "EngineTestSuite.h"
+#include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SpatialHashingComponent.h"
+#include "Tools/Algorithms/SphereAvoidance/AvoidanceField.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include <glm/gtx/norm.hpp>
+
+namespace SA
+{
+	namespace AvoidanceFieldTests
+	{
+		using glm::vec3;
+		using glm::vec4;
+		using glm::quat;
+
+		class AvoidanceField_UnitTest : public SA::UnitTest
+		{
+		public:
+			AvoidanceField_UnitTest()
+			{
+				testNamespace = "AvoidanceField:";
+			}
+
+		protected:
+			/** what ships did before fields: dampen against every sphere in turn */
+			static vec3 perSphereVelocity(const std::vector<AvoidanceFieldSphere>& spheres, const vec3& position, vec3 velocity_n)
+			{
+				for (const AvoidanceFieldSphere& sphere : spheres)
+				{
+					const vec3 toMe_v = position - sphere.position;
+					const float distance = glm::length(toMe_v);
+					if (distance >= sphere.radius || distance <= 0.f)
+					{
+						continue;
+					}
+					const float strength = avoidanceStrength(distance, sphere.radius, sphere.radiusFractForMaxAvoidance);
+					if (strength > 0.01f)
+					{
+						dampenAvoidanceVelocity(velocity_n, toMe_v / distance, strength);
+					}
+				}
+				return velocity_n;
+			}
+
+			/** what ships do with fields: one dampening along the summed push */
+			static vec3 fieldVelocity(const vec4& push, vec3 velocity_n)
+			{
+				const float pushLength = glm::length(vec3(push));
+				const float strength = glm::min(pushLength, 1.f);
+				if (strength > 0.01f)
+				{
+					dampenAvoidanceVelocity(velocity_n, vec3(push) / pushLength, strength);
+				}
+				return velocity_n;
+			}
+
+			static float angleDegrees(const vec3& a_n, const vec3& b_n)
+			{
+				return glm::degrees(std::acos(glm::clamp(glm::dot(a_n, b_n), -1.f, 1.f)));
+			}
+
+			static vec3 randomDirection(std::mt19937& rng)
+			{
+				std::normal_distribution<float> normal;
+				vec3 dir{ normal(rng), normal(rng), normal(rng) };
+				return glm::length2(dir) > 0.f ? glm::normalize(dir) : vec3(1.f, 0.f, 0.f);
+			}
+
+			/** a clump of overlapping spheres, like an asteroid's avoid mesh */
+			static void addCluster(std::vector<AvoidanceFieldSphere>& spheres, std::mt19937& rng, const vec3& center, size_t count, float spread)
+			{
+				std::uniform_real_distribution<float> radiusDist(0.5f * spread, spread);
+				for (size_t sphereIdx = 0; sphereIdx < count; ++sphereIdx)
+				{
+					spheres.push_back(AvoidanceFieldSphere{ center + randomDirection(rng) * (0.5f * spread), radiusDist(rng), 0.8f });
+				}
+			}
+
+			/** random points where at least one sphere pushes, with random headings */
+			static void samplePoints(const std::vector<AvoidanceFieldSphere>& spheres, std::mt19937& rng, size_t count, std::vector<vec3>& outPoints, std::vector<vec3>& outVelocities)
+			{
+				std::uniform_int_distribution<size_t> sphereDist(0, spheres.size() - 1);
+				std::uniform_real_distribution<float> unit(0.f, 1.f);
+				while (outPoints.size() < count)
+				{
+					const AvoidanceFieldSphere& sphere = spheres[sphereDist(rng)];
+					outPoints.push_back(sphere.position + randomDirection(rng) * (sphere.radius * std::cbrt(unit(rng))));
+					outVelocities.push_back(randomDirection(rng));
+				}
+			}
+
+			static std::array<glm::vec4, 8> boxCorners(const vec3& center, const vec3& halfExtents)
+			{
+				std::array<glm::vec4, 8> corners;
+				for (size_t cornerIdx = 0; cornerIdx < corners.size(); ++cornerIdx)
+				{
+					const vec3 signs{ cornerIdx & 1 ? 1.f : -1.f, cornerIdx & 2 ? 1.f : -1.f, cornerIdx & 4 ? 1.f : -1.f };
+					corners[cornerIdx] = glm::vec4(center + signs * halfExtents, 1.f);
+				}
+				return corners;
+			}
+
+			struct AngleErrors
+			{
+				float mean = 0.f;
+				float p99 = 0.f;
+				float max = 0.f;
+			};
+
+			static AngleErrors summarize(std::vector<float>& errors)
+			{
+				AngleErrors result;
+				if (errors.empty())
+				{
+					return result;
+				}
+				std::sort(errors.begin(), errors.end());
+				for (float error : errors) { result.mean += error; }
+				result.mean /= float(errors.size());
+				result.p99 = errors[std::min(errors.size() - 1, size_t(0.99 * double(errors.size())))];
+				result.max = errors.back();
+				return result;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SingleSphereMatchesPerSphere : public AvoidanceField_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "A lone sphere's field steers ships the same as the per sphere computation, within interpolation error";
+
+				const std::vector<AvoidanceFieldSphere> spheres = { AvoidanceFieldSphere{ vec3(-13.f, 7.f, 120.f), 40.f, 0.8f } };
+				AvoidanceField field;
+				field.build(spheres, AvoidanceField::chooseCellSize(spheres));
+
+				//corners are evaluated exactly
+				const vec3 corner = vec3(glm::floor(spheres[0].position / field.getCellSize()) + 1.f) * field.getCellSize();
+				if (glm::length(field.sample(corner) - AvoidanceField::evaluate(spheres, corner)) > 0.0001f)
+				{
+					errorMessage = "a grid corner does not hold the exact push";
+					return false;
+				}
+
+				std::mt19937 rng(24);
+				std::vector<vec3> points, velocities;
+				samplePoints(spheres, rng, 20000, points, velocities);
+				std::vector<float> errors;
+				for (size_t pointIdx = 0; pointIdx < points.size(); ++pointIdx)
+				{
+					const vec3 expected = perSphereVelocity(spheres, points[pointIdx], velocities[pointIdx]);
+					const vec3 actual = fieldVelocity(field.sample(points[pointIdx]), velocities[pointIdx]);
+					errors.push_back(angleDegrees(expected, actual));
+				}
+
+				const AngleErrors result = summarize(errors);
+				std::cout << "\t\t" << "steering error mean " << result.mean << " p99 " << result.p99 << " max " << result.max << " degrees" << std::endl;
+				if (result.mean > 1.f || result.p99 > 10.f)
+				{
+					errorMessage = "lone sphere field steers differently from the sphere";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_ClusterAccuracy : public AvoidanceField_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Overlapping asteroid spheres: field steering vs dampening against each sphere in turn";
+
+				std::mt19937 rng(7);
+				std::vector<AvoidanceFieldSphere> spheres;
+				addCluster(spheres, rng, vec3(0.f), 12, 60.f);
+				addCluster(spheres, rng, vec3(400.f, -50.f, 90.f), 8, 35.f);
+				addCluster(spheres, rng, vec3(-300.f, 200.f, -250.f), 20, 90.f);
+
+				AvoidanceField field;
+				field.build(spheres, AvoidanceField::chooseCellSize(spheres));
+
+				//the per sphere result depends on the order spheres are visited, which the spatial hash walk never fixed
+				std::vector<AvoidanceFieldSphere> reversedSpheres(spheres.rbegin(), spheres.rend());
+
+				std::vector<vec3> points, velocities;
+				samplePoints(spheres, rng, 20000, points, velocities);
+				std::vector<float> errors, orderErrors, approachErrors;
+				size_t headingIntoSphere = 0;
+				size_t fieldStillHeadingIn = 0;
+				for (size_t pointIdx = 0; pointIdx < points.size(); ++pointIdx)
+				{
+					const vec3& point = points[pointIdx];
+					const vec3 expected = perSphereVelocity(spheres, point, velocities[pointIdx]);
+					const vec3 actual = fieldVelocity(field.sample(point), velocities[pointIdx]);
+					errors.push_back(angleDegrees(expected, actual));
+					orderErrors.push_back(angleDegrees(expected, perSphereVelocity(reversedSpheres, point, velocities[pointIdx])));
+
+					//approaching: not yet inside any sphere's full strength core, where ships are actually steered
+					const bool bInsideCore = std::any_of(spheres.begin(), spheres.end(), [&point](const AvoidanceFieldSphere& sphere)
+						{ return glm::distance(point, sphere.position) < sphere.radius * sphere.radiusFractForMaxAvoidance; });
+					if (!bInsideCore)
+					{
+						approachErrors.push_back(errors.back());
+					}
+
+					//what matters most: where the exact push says we are heading in, the field must turn us out
+					const vec3 exactPush = vec3(AvoidanceField::evaluate(spheres, point));
+					if (glm::length2(exactPush) > 0.25f && glm::dot(velocities[pointIdx], exactPush) < 0.f)
+					{
+						++headingIntoSphere;
+						fieldStillHeadingIn += glm::dot(actual, exactPush) < glm::dot(velocities[pointIdx], exactPush) ? 1 : 0;
+					}
+				}
+
+				const AngleErrors result = summarize(errors);
+				const AngleErrors orderResult = summarize(orderErrors);
+				const AngleErrors approachResult = summarize(approachErrors);
+				std::cout << "\t\t" << spheres.size() << " spheres, " << field.getNumBricks() << " bricks, steering error in degrees vs per sphere:" << std::endl;
+				std::cout << "\t\t\t" << "field: mean " << result.mean << " p99 " << result.p99 << " | approaching (" << approachErrors.size() << " samples): mean " << approachResult.mean << " p99 " << approachResult.p99 << std::endl;
+				std::cout << "\t\t\t" << "per sphere in reverse order: mean " << orderResult.mean << " p99 " << orderResult.p99 << std::endl;
+				std::cout << "\t\t\t" << fieldStillHeadingIn << " of " << headingIntoSphere << " samples heading into spheres were not turned away" << std::endl;
+				if (approachResult.mean > 5.f || approachResult.p99 > 45.f)
+				{
+					errorMessage = "field steering of approaching ships strayed too far from the per sphere computation";
+					return false;
+				}
+				if (result.mean > 2.5f * orderResult.mean)
+				{
+					errorMessage = "inside overlapping spheres the field strays much further than the per sphere computation's own order dependence";
+					return false;
+				}
+				if (fieldStillHeadingIn * 1000 > headingIntoSphere) //allow a handful right at cell corners where pushes flip direction
+				{
+					errorMessage = std::to_string(fieldStillHeadingIn) + " of " + std::to_string(headingIntoSphere) + " samples heading into spheres were not turned away";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_RigidFrame : public AvoidanceField_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "A carrier's field baked in its own frame matches its spheres after the carrier moves and turns";
+
+				std::mt19937 rng(3);
+				std::vector<AvoidanceFieldSphere> localSpheres;
+				for (float along = -200.f; along <= 200.f; along += 50.f)
+				{
+					localSpheres.push_back(AvoidanceFieldSphere{ vec3(0.f, 0.f, along), 45.f, 0.8f }); //a hull
+				}
+				localSpheres.push_back(AvoidanceFieldSphere{ vec3(0.f, 60.f, -150.f), 30.f, 0.5f });	//a bridge
+				AvoidanceField field;
+				field.build(localSpheres, AvoidanceField::chooseCellSize(localSpheres));
+
+				for (size_t poseIdx = 0; poseIdx < 8; ++poseIdx)
+				{
+					const vec3 framePosition = randomDirection(rng) * 3000.f;
+					const quat frameRotation = glm::angleAxis(float(poseIdx) * 0.8f, randomDirection(rng));
+
+					std::vector<AvoidanceFieldSphere> worldSpheres = localSpheres;
+					for (AvoidanceFieldSphere& sphere : worldSpheres)
+					{
+						sphere.position = framePosition + frameRotation * sphere.position;
+					}
+
+					std::vector<vec3> points, velocities;
+					samplePoints(worldSpheres, rng, 500, points, velocities);
+					std::vector<float> errors;
+					for (size_t pointIdx = 0; pointIdx < points.size(); ++pointIdx)
+					{
+						const vec4 worldField = AvoidanceField::evaluate(worldSpheres, points[pointIdx]);
+						const vec4 framed = field.sampleInFrame(points[pointIdx], framePosition, frameRotation);
+						if (glm::length(worldField) > 0.2f && glm::dot(vec3(worldField), vec3(framed)) <= 0.f)
+						{
+							errorMessage = "push from a moved carrier points the wrong way";
+							return false;
+						}
+						errors.push_back(angleDegrees(fieldVelocity(worldField, velocities[pointIdx]), fieldVelocity(framed, velocities[pointIdx])));
+					}
+					const AngleErrors result = summarize(errors);
+					if (result.mean > 1.f)
+					{
+						errorMessage = "carrier field drifted from its spheres, mean error " + std::to_string(result.mean) + " degrees";
+						return false;
+					}
+				}
+
+				if (field.sampleInFrame(vec3(5000.f), vec3(0.f), quat(1.f, 0.f, 0.f, 0.f)) != vec4(0.f))
+				{
+					errorMessage = "points outside the carrier bounds should not be pushed";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_SparseStorage : public AvoidanceField_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Only bricks near spheres are stored, on both sides of the origin, and empty space is never pushed";
+
+				//two far apart asteroids; a dense grid over their bounds would be mostly empty
+				const std::vector<AvoidanceFieldSphere> spheres = {
+					AvoidanceFieldSphere{ vec3(-2000.f, -1500.f, -1800.f), 50.f, 0.8f },
+					AvoidanceFieldSphere{ vec3(2000.f, 1500.f, 1800.f), 50.f, 0.8f },
+				};
+				AvoidanceField field;
+				field.build(spheres, AvoidanceField::chooseCellSize(spheres));
+
+				const float brickSize = field.getCellSize() * AvoidanceField::BRICK_CELLS;
+				const double denseBricks = double(4000.f / brickSize) * double(3000.f / brickSize) * double(3600.f / brickSize);
+				std::cout << "\t\t" << field.getNumBricks() << " bricks (" << field.getMemoryBytes() / 1024 << "KB) vs " << size_t(denseBricks) << " dense" << std::endl;
+				if (double(field.getNumBricks()) > denseBricks * 0.01)
+				{
+					errorMessage = "field is not sparse";
+					return false;
+				}
+
+				for (const AvoidanceFieldSphere& sphere : spheres)
+				{
+					const vec3 nearSurface = sphere.position + vec3(0.85f * sphere.radius, 0.f, 0.f);
+					if (field.sample(nearSurface).x <= 0.f)
+					{
+						errorMessage = "sphere on one side of the origin does not push";
+						return false;
+					}
+				}
+				if (field.sample(vec3(0.f)) != vec4(0.f) || field.sample(vec3(-2000.f, -1500.f, -1700.f)) != vec4(0.f))
+				{
+					errorMessage = "empty space was pushed";
+					return false;
+				}
+
+				field.build({}, 1.f);
+				if (!field.isEmpty() || field.sample(vec3(2000.f, 1500.f, 1800.f)) != vec4(0.f))
+				{
+					errorMessage = "rebuilding without spheres left old bricks";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_ShipsInAsteroidField : public AvoidanceField_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Avoidance for ships flying through asteroids: spatial hash walk and per sphere dampening vs field samples";
+
+				std::mt19937 rng(11);
+				std::vector<AvoidanceFieldSphere> spheres;
+				std::uniform_real_distribution<float> placement(-2000.f, 2000.f);
+				for (size_t asteroidIdx = 0; asteroidIdx < 40; ++asteroidIdx)
+				{
+					addCluster(spheres, rng, vec3(placement(rng), placement(rng), placement(rng)), 8, 60.f);
+				}
+
+				AvoidanceField field;
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point start = Clock::now();
+				field.build(spheres, AvoidanceField::chooseCellSize(spheres));
+				const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				//ships near asteroids, where the avoidance work is
+				std::vector<vec3> points, velocities;
+				samplePoints(spheres, rng, 200000, points, velocities);
+
+				//the grid walk ships did before fields, on the same grid the space levels create for avoidance spheres
+				SH::SpatialHashGrid<AvoidanceFieldSphere> grid(vec3(128.f));
+				std::vector<std::unique_ptr<SH::HashEntry<AvoidanceFieldSphere>>> gridEntries;
+				for (AvoidanceFieldSphere& sphere : spheres)
+				{
+					gridEntries.push_back(grid.insert(sphere, boxCorners(sphere.position, vec3(sphere.radius))));
+				}
+
+				vec3 checksum{ 0.f };
+				std::vector<sp<const SH::HashCell<AvoidanceFieldSphere>>> nearbyCells;
+				std::vector<AvoidanceFieldSphere*> uniqueSpheres;
+				start = Clock::now();
+				for (size_t pointIdx = 0; pointIdx < points.size(); ++pointIdx)
+				{
+					uniqueSpheres.clear();
+					grid.lookupCellsForOOB(boxCorners(points[pointIdx], vec3(4.f)), nearbyCells);
+					for (const sp<const SH::HashCell<AvoidanceFieldSphere>>& cell : nearbyCells)
+					{
+						for (const sp<SH::GridNode<AvoidanceFieldSphere>>& node : cell->nodeBucket)
+						{
+							if (std::find(uniqueSpheres.begin(), uniqueSpheres.end(), &node->element) == uniqueSpheres.end())
+							{
+								uniqueSpheres.push_back(&node->element);
+							}
+						}
+					}
+
+					vec3 velocity_n = velocities[pointIdx];
+					for (AvoidanceFieldSphere* sphere : uniqueSpheres)
+					{
+						const vec3 toMe_v = points[pointIdx] - sphere->position;
+						const float strength = avoidanceStrength(glm::length(toMe_v), sphere->radius, sphere->radiusFractForMaxAvoidance);
+						if (strength > 0.01f)
+						{
+							dampenAvoidanceVelocity(velocity_n, glm::normalize(toMe_v), strength);
+						}
+					}
+					checksum += velocity_n;
+				}
+				const double gridWalkMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				start = Clock::now();
+				for (size_t pointIdx = 0; pointIdx < points.size(); ++pointIdx)
+				{
+					checksum += fieldVelocity(field.sample(points[pointIdx]), velocities[pointIdx]);
+				}
+				const double fieldMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				std::cout << "\t\t" << points.size() << " ships, " << spheres.size() << " spheres: grid walk " << gridWalkMs << "ms | field " << fieldMs << "ms" << std::endl;
+				std::cout << "\t\t" << "field build " << buildMs << "ms, " << field.getNumBricks() << " bricks, " << field.getMemoryBytes() / 1024 << "KB, cell size " << field.getCellSize() << " (checksum " << checksum.x << ")" << std::endl;
+
+				if (fieldMs >= gridWalkMs)
+				{
+					errorMessage = "field sampling was not faster than the grid walk";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class AvoidanceFieldTestSuite : public SA::TestSuite
+		{
+		public:
+			AvoidanceFieldTestSuite()
+			{
+				testName = "AVOIDANCE FIELD TEST SUITE";
+
+				addTest(new_sp<Test_SingleSphereMatchesPerSphere>());
+				addTest(new_sp<Test_ClusterAccuracy>());
+				addTest(new_sp<Test_RigidFrame>());
+				addTest(new_sp<Test_SparseStorage>());
+				addTest(new_sp<Benchmark_ShipsInAsteroidField>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getAvoidanceFieldTestSuite()
+	{
+		return new_sp<SA::AvoidanceFieldTests::AvoidanceFieldTestSuite>();
+	}
+}
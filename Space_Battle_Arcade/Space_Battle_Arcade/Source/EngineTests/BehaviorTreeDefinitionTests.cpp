@@ -0,0 +1,349 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/SABehaviorTree.h"
+#include "GameFramework/SARandomNumberGenerationSystem.h"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace SA
+{
+	namespace BehaviorTreeDefinitionTests
+	{
+		using namespace BehaviorTree;
+
+		class BehaviorTreeDefinition_UnitTest : public SA::UnitTest
+		{
+		public:
+			BehaviorTreeDefinition_UnitTest()
+			{
+				testNamespace = "BehaviorTreeDefinition:";
+			}
+		};
+
+		/** Appends a letter to the tree's trace; optionally closes the release gate so the next wait blocks again */
+		class Task_Append : public Task
+		{
+		public:
+			Task_Append(const std::string& name, char letter, bool bClosesGate)
+				: Task(name), letter(letter), bClosesGate(bClosesGate)
+			{}
+		protected:
+			virtual void beginTask() override
+			{
+				Memory& memory = getMemory();
+				ScopedUpdateNotifier<std::string> trace;
+				if (memory.getWriteValueAs<std::string>("trace", trace))
+				{
+					trace.get().push_back(letter);
+				}
+				if (bClosesGate)
+				{
+					memory.replaceValue("gate_open", new_sp<PrimitiveWrapper<bool>>(false));
+				}
+				evaluationResult = true;
+			}
+			virtual void taskCleanup() override {}
+			virtual void handleNodeAborted() override {}
+		private:
+			const char letter;
+			const bool bClosesGate;
+		};
+
+		/** Holds its tree mid sequence until the tree's memory opens the gate */
+		class Task_WaitForGate : public Task
+		{
+		public:
+			Task_WaitForGate(const std::string& name) : Task(name) {}
+		protected:
+			virtual bool isProcessing() const override
+			{
+				const bool* bGateOpen = getMemory().getReadValueAs<bool>("gate_open");
+				return bStartedTask && !(bGateOpen && *bGateOpen);
+			}
+			virtual bool result() const override { return true; }
+			virtual void beginTask() override {}
+			virtual void taskCleanup() override {}
+			virtual void handleNodeAborted() override {}
+		};
+
+		static MemoryInitializer makeGateMemory()
+		{
+			return MemoryInitializer{
+				{ "trace", new_sp<PrimitiveWrapper<std::string>>(std::string{}) },
+				{ "gate_open", new_sp<PrimitiveWrapper<bool>>(false) }
+			};
+		}
+
+		static std::string getTrace(const Tree& tree)
+		{
+			const std::string* trace = tree.getMemory().getReadValueAs<std::string>("trace");
+			return trace ? *trace : std::string("<missing>");
+		}
+
+		/** root selector -> sequence(a, wait, b) ; the selector is only there to put a shared node above a shared node */
+		template<typename MakeTask>
+		static sp<NodeBase> makeGateTree(MakeTask makeTask)
+		{
+			return new_sp<Selector>("root", MakeChildren{
+				new_sp<Sequence>("gated_sequence", MakeChildren{
+					makeTask(std::string("append_a"), 'a', false),
+					makeTask(std::string("wait"), '\0', false),
+					makeTask(std::string("append_b"), 'b', true)
+				})
+			});
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_TreesKeepSeparateState : public BehaviorTreeDefinition_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Trees built from one definition keep separate execution state, and match a privately built tree";
+
+				auto perAgentTask = [](const std::string& name, char letter, bool bClosesGate) -> sp<NodeBase>
+				{
+					return name == "wait" ? perAgentNode<Task_WaitForGate>(name) : perAgentNode<Task_Append>(name, letter, bClosesGate);
+				};
+				auto privateTask = [](const std::string& name, char letter, bool bClosesGate) -> sp<NodeBase>
+				{
+					return name == "wait" ? sp<NodeBase>(new_sp<Task_WaitForGate>(name)) : sp<NodeBase>(new_sp<Task_Append>(name, letter, bClosesGate));
+				};
+
+				sp<const TreeDefinition> definition = new_sp<TreeDefinition>("gate_tree", makeGateTree(perAgentTask));
+				sp<Tree> agentA = new_sp<Tree>(definition, makeGateMemory());
+				sp<Tree> agentB = new_sp<Tree>(definition, makeGateMemory());
+				sp<Tree> privateB = new_sp<Tree>("gate_tree", makeGateTree(privateTask), makeGateMemory());
+
+				const std::vector<sp<Tree>> trees = { agentA, agentB, privateB };
+				for (const sp<Tree>& tree : trees) { tree->start(); }
+				auto tickAll = [&trees]() { for (const sp<Tree>& tree : trees) { tree->tick(0.016f); } };
+
+				tickAll(); //everyone appends a and waits at the gate
+				if (getTrace(*agentA) != "a" || getTrace(*agentB) != "a" || getTrace(*privateB) != "a")
+				{
+					errorMessage = "trees did not stop at the gate";
+					return false;
+				}
+
+				//open only B's gates; A must stay parked mid sequence while B finishes and loops back around
+				agentB->getMemory().replaceValue("gate_open", new_sp<PrimitiveWrapper<bool>>(true));
+				privateB->getMemory().replaceValue("gate_open", new_sp<PrimitiveWrapper<bool>>(true));
+				tickAll();
+				if (getTrace(*agentA) != "a" || getTrace(*agentB) != "aba" || getTrace(*agentB) != getTrace(*privateB))
+				{
+					errorMessage = "a tree advanced on another tree's state";
+					return false;
+				}
+
+				agentA->getMemory().replaceValue("gate_open", new_sp<PrimitiveWrapper<bool>>(true));
+				tickAll();
+				if (getTrace(*agentA) != "aba" || getTrace(*agentB) != "aba" || getTrace(*privateB) != "aba")
+				{
+					errorMessage = "tree did not resume where it was parked";
+					return false;
+				}
+
+				for (const sp<Tree>& tree : trees) { tree->stop(); }
+				return true;
+			}
+		};
+
+		class Test_DefinitionLayout : public BehaviorTreeDefinition_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Definitions count their nodes and reject nodes that cannot be shared";
+
+				sp<TreeDefinition> definition = new_sp<TreeDefinition>("layout_tree", makeGateTree(
+					[](const std::string& name, char letter, bool bClosesGate) { return perAgentNode<Task_Append>(name, letter, bClosesGate); }
+				));
+				if (definition->getNumNodes() != 5 || definition->getNumPerAgentNodes() != 3)
+				{
+					errorMessage = "wrong node counts";
+					return false;
+				}
+
+				bool bRejected = false;
+				try
+				{
+					new_sp<TreeDefinition>("bad_tree", makeGateTree(
+						[](const std::string& name, char letter, bool bClosesGate) { return sp<NodeBase>(new_sp<Task_Append>(name, letter, bClosesGate)); }
+					));
+				}
+				catch (const std::runtime_error&)
+				{
+					bRejected = true;
+				}
+				if (!bRejected)
+				{
+					errorMessage = "a task with its own state was accepted as shared";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_RandomChoicesPerTree : public BehaviorTreeDefinition_UnitTest
+		{
+			/** sequence(random(a, b), wait) ; each opening of the gate lets the tree make one more random choice */
+			template<typename MakeTask>
+			static sp<NodeBase> makeRandomTree(MakeTask makeTask)
+			{
+				return new_sp<Sequence>("root", MakeChildren{
+					new_sp<Random>("pick", Chances{ {"append_a", 1}, {"append_b", 1} }, MakeChildren{
+						makeTask(std::string("append_a"), 'a', true),
+						makeTask(std::string("append_b"), 'b', true)
+					}),
+					makeTask(std::string("wait"), '\0', false)
+				});
+			}
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Trees sharing a random node each draw from their own generator";
+
+				auto perAgentTask = [](const std::string& name, char letter, bool bClosesGate) -> sp<NodeBase>
+				{
+					return name == "wait" ? perAgentNode<Task_WaitForGate>(name) : perAgentNode<Task_Append>(name, letter, bClosesGate);
+				};
+				auto privateTask = [](const std::string& name, char letter, bool bClosesGate) -> sp<NodeBase>
+				{
+					return name == "wait" ? sp<NodeBase>(new_sp<Task_WaitForGate>(name)) : sp<NodeBase>(new_sp<Task_Append>(name, letter, bClosesGate));
+				};
+
+				sp<const TreeDefinition> definition = new_sp<TreeDefinition>("random_tree", makeRandomTree(perAgentTask));
+				const std::vector<sp<Tree>> trees = {
+					new_sp<Tree>(definition, makeGateMemory()),
+					new_sp<Tree>(definition, makeGateMemory()),
+					new_sp<Tree>("random_tree", makeRandomTree(privateTask), makeGateMemory())
+				};
+
+				//same seed, separate generators; if the shared node drew from one generator, interleaving the trees would split its sequence between them
+				sp<RNGSystem> rngSystem = new_sp<RNGSystem>();
+				for (const sp<Tree>& tree : trees)
+				{
+					tree->setRNG(rngSystem->getSeededRNG(7));
+					tree->start();
+				}
+
+				for (size_t choice = 0; choice < 32; ++choice)
+				{
+					for (const sp<Tree>& tree : trees)
+					{
+						tree->getMemory().replaceValue("gate_open", new_sp<PrimitiveWrapper<bool>>(true));
+						tree->tick(0.016f);
+					}
+				}
+
+				const std::string trace = getTrace(*trees[0]);
+				if (trace.size() != 32 || trace.find('a') == std::string::npos || trace.find('b') == std::string::npos)
+				{
+					errorMessage = "random node did not make one choice per tick: " + trace;
+					return false;
+				}
+				for (const sp<Tree>& tree : trees)
+				{
+					if (getTrace(*tree) != trace)
+					{
+						errorMessage = "trees with the same seed made different choices: " + trace + " vs " + getTrace(*tree);
+						return false;
+					}
+					tree->stop();
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_BuildBrains : public BehaviorTreeDefinition_UnitTest
+		{
+			/** roughly the fighter tree's shape: a state selector over a few sequences of tasks */
+			template<typename MakeTask>
+			static sp<NodeBase> makeFighterShapedTree(MakeTask makeTask)
+			{
+				MakeChildren states;
+				for (int stateIdx = 0; stateIdx < 4; ++stateIdx)
+				{
+					const std::string prefix = "state" + std::to_string(stateIdx);
+					states.push_back(new_sp<Sequence>(prefix + "_sequence", MakeChildren{
+						makeTask(prefix + "_setup"),
+						new_sp<Selector>(prefix + "_choice", MakeChildren{ makeTask(prefix + "_x"), makeTask(prefix + "_y") }),
+						makeTask(prefix + "_act")
+					}));
+				}
+				return new_sp<Selector>("state_selector", states);
+			}
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Building 400 fighter shaped brains, private trees vs a shared definition";
+
+				const size_t numBrains = 400;
+				using Clock = std::chrono::high_resolution_clock;
+
+				std::vector<sp<Tree>> privateTrees;
+				privateTrees.reserve(numBrains);
+				Clock::time_point start = Clock::now();
+				for (size_t brainIdx = 0; brainIdx < numBrains; ++brainIdx)
+				{
+					privateTrees.push_back(new_sp<Tree>("fighter", makeFighterShapedTree(
+						[](const std::string& name) { return sp<NodeBase>(new_sp<Task_Append>(name, 'x', false)); }), makeGateMemory()));
+				}
+				const double privateMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				std::vector<sp<Tree>> sharedTrees;
+				sharedTrees.reserve(numBrains);
+				start = Clock::now();
+				sp<const TreeDefinition> definition = new_sp<TreeDefinition>("fighter", makeFighterShapedTree(
+					[](const std::string& name) { return perAgentNode<Task_Append>(name, 'x', false); }));
+				for (size_t brainIdx = 0; brainIdx < numBrains; ++brainIdx)
+				{
+					sharedTrees.push_back(new_sp<Tree>(definition, makeGateMemory()));
+				}
+				const double sharedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				std::cout << "\t\t" << numBrains << " brains, " << definition->getNumNodes() << " nodes each | private trees " << privateMs
+					<< "ms, " << definition->getNumNodes() << " node objects per brain | shared definition " << sharedMs << "ms, "
+					<< definition->getNumPerAgentNodes() << " node objects per brain" << std::endl;
+
+				//both kinds of brain should do the same work
+				privateTrees[0]->start();
+				sharedTrees[0]->start();
+				privateTrees[0]->tick(0.016f);
+				sharedTrees[0]->tick(0.016f);
+				if (getTrace(*privateTrees[0]) != getTrace(*sharedTrees[0]) || getTrace(*sharedTrees[0]).empty())
+				{
+					errorMessage = "shared and private brains did different work";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class BehaviorTreeDefinitionTestSuite : public SA::TestSuite
+		{
+		public:
+			BehaviorTreeDefinitionTestSuite()
+			{
+				testName = "BEHAVIOR TREE DEFINITION TEST SUITE";
+
+				addTest(new_sp<Test_TreesKeepSeparateState>());
+				addTest(new_sp<Test_DefinitionLayout>());
+				addTest(new_sp<Test_RandomChoicesPerTree>());
+				addTest(new_sp<Benchmark_BuildBrains>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getBehaviorTreeDefinitionTestSuite()
+	{
+		return new_sp<SA::BehaviorTreeDefinitionTests::BehaviorTreeDefinitionTestSuite>();
+	}
+}
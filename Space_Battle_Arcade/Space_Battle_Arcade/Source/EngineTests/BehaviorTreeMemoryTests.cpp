@@ -0,0 +1,338 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/SABehaviorTree.h"
+
+#include <chrono>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+namespace SA
+{
+	namespace BehaviorTreeMemoryTests
+	{
+		using namespace BehaviorTree;
+
+		class BehaviorTreeMemory_UnitTest : public SA::UnitTest
+		{
+		public:
+			BehaviorTreeMemory_UnitTest()
+			{
+				testNamespace = "BehaviorTreeMemory:";
+			}
+		};
+
+		struct TestTarget : public GameEntity
+		{
+			int hits = 0;
+		};
+		struct OtherTarget : public GameEntity {};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// keys
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_KeyInterning : public BehaviorTreeMemory_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Keys with the same name intern to the same slot";
+
+				MemoryKey a("interning_test_a");
+				MemoryKey aAgain(std::string("interning_test_a"));
+				MemoryKey b("interning_test_b");
+
+				if (a != aAgain || a.getId() != aAgain.getId() || a == b)
+				{
+					errorMessage = "interned ids do not match names";
+					return false;
+				}
+				if (a.getName() != "interning_test_a" || &a.getName() != &aAgain.getName() || !(std::string("interning_test_b") == b))
+				{
+					errorMessage = "interned names are wrong or not shared";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_KeyAndStringAccessAgree : public BehaviorTreeMemory_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Interned and string keys reach the same values, and casts follow replacements";
+
+				Memory memory;
+				const MemoryKey targetKey("agree_test_target");
+				const MemoryKey countKey("agree_test_count");
+
+				sp<TestTarget> target = new_sp<TestTarget>();
+				memory.replaceValue("agree_test_target", target);
+				memory.replaceValue(countKey, new_sp<PrimitiveWrapper<int>>(5));
+
+				if (memory.getReadValueAs<TestTarget>(targetKey) != target.get()
+					|| memory.getReadValueAs<TestTarget>(std::string("agree_test_target")) != target.get())
+				{
+					errorMessage = "key and string reads disagree";
+					return false;
+				}
+				const int* count = memory.getReadValueAs<int>("agree_test_count");
+				if (!count || *count != 5 || memory.getReadValueAs<int>(countKey) != count)
+				{
+					errorMessage = "primitive read failed";
+					return false;
+				}
+
+				//a read as the wrong type must fail, and must not stop that type being read once the value is replaced with it
+				if (memory.getReadValueAs<OtherTarget>(targetKey) != nullptr)
+				{
+					errorMessage = "read as wrong type returned a value";
+					return false;
+				}
+				sp<OtherTarget> other = new_sp<OtherTarget>();
+				memory.replaceValue(targetKey, other);
+				if (memory.getReadValueAs<OtherTarget>(targetKey) != other.get() || memory.getReadValueAs<TestTarget>(targetKey) != nullptr)
+				{
+					errorMessage = "cached cast survived a replace";
+					return false;
+				}
+
+				//values stored through the base type still resolve to their real type
+				memory.replaceValue<GameEntity>(targetKey, target);
+				if (memory.getReadValueAs<TestTarget>(targetKey) != target.get() || memory.getMemoryReference<TestTarget>(targetKey).get() != target.get())
+				{
+					errorMessage = "value stored as base type could not be read as its real type";
+					return false;
+				}
+
+				if (!memory.removeValue(targetKey) || memory.hasValue(targetKey) || memory.getReadValueAs<TestTarget>(targetKey) != nullptr)
+				{
+					errorMessage = "removed value is still readable";
+					return false;
+				}
+				if (!memory.eraseEntry(countKey) || memory.hasValue("agree_test_count"))
+				{
+					errorMessage = "erased entry is still present";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_ConcurrentReads : public BehaviorTreeMemory_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Const reads from several threads see the stored values; reads do not write to memory";
+
+				Memory memory;
+				const MemoryKey targetKey("concurrent_test_target");
+				const MemoryKey countKey("concurrent_test_count");
+				sp<TestTarget> target = new_sp<TestTarget>();
+				memory.replaceValue(targetKey, target);
+				memory.replaceValue(countKey, new_sp<PrimitiveWrapper<int>>(11));
+
+				const Memory& readOnlyMemory = memory;
+				const size_t numThreads = 4;
+				std::vector<int> numBadReads(numThreads, 0);
+				std::vector<std::thread> readers;
+				for (size_t threadIdx = 0; threadIdx < numThreads; ++threadIdx)
+				{
+					readers.emplace_back([&, threadIdx]()
+					{
+						for (int read = 0; read < 10000; ++read)
+						{
+							//mix the stored types with types that need a dynamic cast
+							const int* count = readOnlyMemory.getReadValueAs<int>(countKey);
+							bool bGoodRead = count && *count == 11
+								&& readOnlyMemory.getReadValueAs<TestTarget>(targetKey) == target.get()
+								&& readOnlyMemory.getReadValueAs<GameEntity>(targetKey) == target.get()
+								&& readOnlyMemory.getReadValueAs<OtherTarget>(targetKey) == nullptr
+								&& readOnlyMemory.getReadValueAs<float>(countKey) == nullptr;
+							numBadReads[threadIdx] += bGoodRead ? 0 : 1;
+						}
+					});
+				}
+				for (std::thread& reader : readers) { reader.join(); }
+
+				for (int badReads : numBadReads)
+				{
+					if (badReads != 0)
+					{
+						errorMessage = "a thread read a wrong value";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// delegates
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_DelegatesFire : public BehaviorTreeMemory_UnitTest
+		{
+			struct Listener : public GameEntity
+			{
+				void handleModified(const std::string& key, const GameEntity* value) { ++numModified; lastKey = key; }
+				void handleReplaced(const std::string& key, const GameEntity* oldValue, const GameEntity* newValue) { ++numReplaced; lastKey = key; }
+				int numModified = 0;
+				int numReplaced = 0;
+				std::string lastKey;
+			};
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Writes and replaces through interned keys fire delegates";
+
+				Memory memory;
+				const MemoryKey targetKey("delegate_test_target");
+				sp<Listener> listener = new_sp<Listener>();
+				memory.getModifiedDelegate(targetKey).addWeakObj(listener, &Listener::handleModified);
+				memory.getReplacedDelegate("delegate_test_target").addWeakObj(listener, &Listener::handleReplaced);
+
+				memory.replaceValue(targetKey, new_sp<TestTarget>());
+				if (listener->numReplaced != 1 || listener->numModified != 1 || listener->lastKey != "delegate_test_target")
+				{
+					errorMessage = "replace did not broadcast with the key name";
+					return false;
+				}
+
+				{
+					ScopedUpdateNotifier<TestTarget> writable;
+					if (!memory.getWriteValueAs(targetKey, writable))
+					{
+						errorMessage = "could not get write access";
+						return false;
+					}
+					writable.get().hits++;
+				}
+				if (listener->numModified != 2 || listener->numReplaced != 1)
+				{
+					errorMessage = "write did not broadcast modified";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+		/** Reads a few values and writes one every tick, roughly what a ship's per tick nodes do. KeyType is std::string for the old access pattern. */
+		template<typename KeyType>
+		class Task_TouchMemory : public Task
+		{
+		public:
+			Task_TouchMemory(const KeyType& targetKey, const KeyType& positionKey, const KeyType& stateKey, const KeyType& counterKey)
+				: Task("touch_memory"), targetKey(targetKey), positionKey(positionKey), stateKey(stateKey), counterKey(counterKey)
+			{}
+		protected:
+			virtual void beginTask() override
+			{
+				Memory& memory = getMemory();
+				const TestTarget* target = memory.getReadValueAs<TestTarget>(targetKey);
+				const glm::vec3* position = memory.getReadValueAs<glm::vec3>(positionKey);
+				const int* state = memory.getReadValueAs<int>(stateKey);
+
+				ScopedUpdateNotifier<int> counter;
+				if (memory.getWriteValueAs(counterKey, counter))
+				{
+					counter.get() += int(target != nullptr) + int(position != nullptr) + (state ? *state : 0);
+				}
+				evaluationResult = true;
+			}
+			virtual void taskCleanup() override {}
+			virtual void handleNodeAborted() override {}
+		private:
+			const KeyType targetKey;
+			const KeyType positionKey;
+			const KeyType stateKey;
+			const KeyType counterKey;
+		};
+
+		class Benchmark_TickBrains : public BehaviorTreeMemory_UnitTest
+		{
+			template<typename KeyType>
+			static std::vector<sp<Tree>> makeBrains(size_t numBrains)
+			{
+				std::vector<sp<Tree>> brains;
+				for (size_t brainIdx = 0; brainIdx < numBrains; ++brainIdx)
+				{
+					auto touch = [](){ return new_sp<Task_TouchMemory<KeyType>>("bench_target", "bench_position", "bench_state", "bench_counter"); };
+					brains.push_back(new_sp<Tree>("bench_brain",
+						new_sp<Sequence>("root", MakeChildren{ touch(), touch(), touch(), touch() }),
+						MemoryInitializer{
+							{ "bench_target", new_sp<TestTarget>() },
+							{ "bench_position", new_sp<PrimitiveWrapper<glm::vec3>>(glm::vec3(1.f)) },
+							{ "bench_state", new_sp<PrimitiveWrapper<int>>(1) },
+							{ "bench_counter", new_sp<PrimitiveWrapper<int>>(0) }
+						}
+					));
+					brains.back()->start();
+				}
+				return brains;
+			}
+
+			static double tickBrainsMs(const std::vector<sp<Tree>>& brains, int frames)
+			{
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point start = Clock::now();
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					for (const sp<Tree>& brain : brains)
+					{
+						brain->tick(0.016f);
+					}
+				}
+				return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+			}
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Behavior tree tick benchmark, 500 brains";
+
+				const size_t numBrains = 500;
+				const int frames = 200;
+				std::vector<sp<Tree>> stringBrains = makeBrains<std::string>(numBrains);
+				std::vector<sp<Tree>> keyBrains = makeBrains<MemoryKey>(numBrains);
+
+				const double stringMs = tickBrainsMs(stringBrains, frames);
+				const double keyMs = tickBrainsMs(keyBrains, frames);
+
+				std::cout << "\t\t" << numBrains << " brains | string keys " << stringMs << "ms/frame | interned keys " << keyMs << "ms/frame" << std::endl;
+
+				const int* stringCounter = stringBrains[0]->getMemory().getReadValueAs<int>("bench_counter");
+				const int* keyCounter = keyBrains[0]->getMemory().getReadValueAs<int>("bench_counter");
+				if (!stringCounter || !keyCounter || *stringCounter != *keyCounter || *keyCounter == 0)
+				{
+					errorMessage = "string and interned key brains did different work";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class BehaviorTreeMemoryTestSuite : public SA::TestSuite
+		{
+		public:
+			BehaviorTreeMemoryTestSuite()
+			{
+				testName = "BEHAVIOR TREE MEMORY TEST SUITE";
+
+				addTest(new_sp<Test_KeyInterning>());
+				addTest(new_sp<Test_KeyAndStringAccessAgree>());
+				addTest(new_sp<Test_ConcurrentReads>());
+				addTest(new_sp<Test_DelegatesFire>());
+				addTest(new_sp<Benchmark_TickBrains>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getBehaviorTreeMemoryTestSuite()
+	{
+		return new_sp<SA::BehaviorTreeMemoryTests::BehaviorTreeMemoryTestSuite>();
+	}
+}
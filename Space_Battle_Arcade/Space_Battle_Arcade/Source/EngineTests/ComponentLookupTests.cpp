@@ -0,0 +1,237 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/Components/SAComponentEntity.h"
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <typeindex>
+
+namespace SA
+{
+	namespace ComponentLookupTests
+	{
+		class ComponentLookup_UnitTest : public SA::UnitTest
+		{
+		public:
+			ComponentLookup_UnitTest()
+			{
+				testNamespace = "ComponentLookup:";
+			}
+		};
+
+		/** stand ins for the collision and team components queried in the projectile and targeting loops */
+		struct TestCollisionComponent : public GameComponentBase { int collisionMask = 0; };
+		struct TestTeamComponent : public GameComponentBase { size_t team = 0; };
+		struct TestUnusedComponent : public GameComponentBase {};
+
+		struct TestEntity : public GameplayComponentEntity {};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_IdsAreDense : public ComponentLookup_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Component ids are unique, non zero and fit the slot array";
+
+				const size_t ids[] = { GameComponentId<TestCollisionComponent>::value, GameComponentId<TestTeamComponent>::value, GameComponentId<TestUnusedComponent>::value };
+				for (size_t idx = 0; idx < 3; ++idx)
+				{
+					if (ids[idx] == 0 || ids[idx] >= MAX_GAME_COMPONENT_TYPES)
+					{
+						errorMessage = "component id outside of the slot array";
+						return false;
+					}
+					for (size_t otherIdx = idx + 1; otherIdx < 3; ++otherIdx)
+					{
+						if (ids[idx] == ids[otherIdx])
+						{
+							errorMessage = "two component types share an id";
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_CreateGetDelete : public ComponentLookup_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Create, get, has and delete only touch their own component";
+
+				sp<TestEntity> entity = new_sp<TestEntity>();
+				if (entity->hasGameComponent<TestCollisionComponent>() || entity->getGameComponent<TestTeamComponent>() != nullptr)
+				{
+					errorMessage = "fresh entity reported a component";
+					return false;
+				}
+
+				TestCollisionComponent* collision = entity->createGameComponent<TestCollisionComponent>();
+				entity->createGameComponent<TestTeamComponent>();
+				const TestEntity& constEntity = *entity;
+				if (collision == nullptr 
+					|| entity->getGameComponent<TestCollisionComponent>() != collision 
+					|| constEntity.getGameComponent<TestCollisionComponent>() != collision
+					|| !constEntity.hasGameComponent<TestTeamComponent>()
+					|| entity->hasGameComponent<TestUnusedComponent>())
+				{
+					errorMessage = "created components were not found in their slots";
+					return false;
+				}
+
+				entity->deleteGameComponent<TestCollisionComponent>();
+				if (entity->hasGameComponent<TestCollisionComponent>() || !entity->hasGameComponent<TestTeamComponent>())
+				{
+					errorMessage = "delete removed the wrong component";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_CollisionLoopLookup : public ComponentLookup_UnitTest
+		{
+			/** the lookup game components used before ids: a per type static index claimed on first call and a lazily grown vector */
+			struct LazyIndexEntity
+			{
+				static size_t& nextIndex() { static size_t next = 0; return next; }
+
+				template<typename ComponentType>
+				static size_t typeIndex()
+				{
+					static size_t this_type_index = nextIndex()++; //guarded on every call
+					return this_type_index;
+				}
+
+				template<typename ComponentType>
+				ComponentType* get()
+				{
+					const size_t index = typeIndex<ComponentType>();
+					if (components.size() < index + 1) { return nullptr; }
+					return static_cast<ComponentType*>(components[index].get());
+				}
+
+				template<typename ComponentType>
+				void create()
+				{
+					const size_t index = typeIndex<ComponentType>();
+					if (components.size() < index + 1) { components.resize(index + 1); }
+					components[index] = new_sp<ComponentType>();
+				}
+
+				std::vector<sp<GameComponentBase>> components;
+			};
+
+			/** associative lookup, as system components do */
+			struct MapEntity
+			{
+				template<typename ComponentType>
+				ComponentType* get()
+				{
+					static std::type_index typeIndex = typeid(ComponentType);
+					auto findResult = components.find(typeIndex);
+					return findResult != components.end() ? static_cast<ComponentType*>(findResult->second.get()) : nullptr;
+				}
+
+				std::map<std::type_index, sp<GameComponentBase>> components;
+			};
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Collision loop component lookups: map vs lazy index vs dense id";
+
+				const size_t numEntities = 2000;
+				const int passes = 50;
+				std::mt19937 rng(11);
+				std::uniform_int_distribution<int> coin(0, 3);
+
+				std::vector<sp<TestEntity>> entities;
+				std::vector<LazyIndexEntity> lazyEntities(numEntities);
+				std::vector<MapEntity> mapEntities(numEntities);
+				for (size_t entityIdx = 0; entityIdx < numEntities; ++entityIdx)
+				{
+					entities.push_back(new_sp<TestEntity>());
+					lazyEntities[entityIdx].create<TestTeamComponent>();
+					mapEntities[entityIdx].components[typeid(TestTeamComponent)] = new_sp<TestTeamComponent>();
+					entities.back()->createGameComponent<TestTeamComponent>();
+					if (coin(rng) != 0) //most candidates are collidable
+					{
+						lazyEntities[entityIdx].create<TestCollisionComponent>();
+						mapEntities[entityIdx].components[typeid(TestCollisionComponent)] = new_sp<TestCollisionComponent>();
+						entities.back()->createGameComponent<TestCollisionComponent>();
+					}
+				}
+
+				//each pass: a projectile checks every candidate for collision then team, like the projectile and ship collision loops
+				using Clock = std::chrono::high_resolution_clock;
+				size_t mapHits = 0, lazyHits = 0, idHits = 0;
+
+				Clock::time_point start = Clock::now();
+				for (int pass = 0; pass < passes; ++pass)
+				{
+					for (MapEntity& entity : mapEntities)
+					{
+						if (entity.get<TestCollisionComponent>() && entity.get<TestTeamComponent>()) { ++mapHits; }
+					}
+				}
+				const double mapUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / passes;
+
+				start = Clock::now();
+				for (int pass = 0; pass < passes; ++pass)
+				{
+					for (LazyIndexEntity& entity : lazyEntities)
+					{
+						if (entity.get<TestCollisionComponent>() && entity.get<TestTeamComponent>()) { ++lazyHits; }
+					}
+				}
+				const double lazyUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / passes;
+
+				start = Clock::now();
+				for (int pass = 0; pass < passes; ++pass)
+				{
+					for (const sp<TestEntity>& entity : entities)
+					{
+						if (entity->getGameComponent<TestCollisionComponent>() && entity->getGameComponent<TestTeamComponent>()) { ++idHits; }
+					}
+				}
+				const double idUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / passes;
+
+				std::cout << "\t\t" << numEntities << " candidates | map " << mapUs << "us | lazy index " << lazyUs << "us | dense id " << idUs << "us per pass" << std::endl;
+
+				if (mapHits != idHits || lazyHits != idHits)
+				{
+					errorMessage = "lookup schemes disagree on which candidates have components";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class ComponentLookupTestSuite : public SA::TestSuite
+		{
+		public:
+			ComponentLookupTestSuite()
+			{
+				testName = "COMPONENT LOOKUP TEST SUITE";
+
+				addTest(new_sp<Test_IdsAreDense>());
+				addTest(new_sp<Test_CreateGetDelete>());
+				addTest(new_sp<Benchmark_CollisionLoopLookup>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getComponentLookupTestSuite()
+	{
+		return new_sp<SA::ComponentLookupTests::ComponentLookupTestSuite>();
+	}
+}
@@ -0,0 +1,395 @@
+#include "EngineTestSuite.h"
+#include "Tools/ModelLoading/SACookedAsset.h"
+#include "ReferenceCode/OpenGL/Algorithms/SeparatingAxisTheorem/SATComponent.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace SA
+{
+	namespace CookedAssetTests
+	{
+		using glm::vec2; using glm::vec3; using glm::vec4;
+		using TriangleProcessor = SAT::DynamicTriangleMeshShape::TriangleProcessor;
+
+		class CookedAsset_UnitTest : public SA::UnitTest
+		{
+		public:
+			CookedAsset_UnitTest()
+			{
+				testNamespace = "CookedAsset:";
+			}
+
+		protected:
+			/** a throwaway "source" file in the temp directory; the cooked blob is written beside it */
+			static std::string makeSourceFile(const char* name, const std::string& contents)
+			{
+				std::string path = (std::filesystem::temp_directory_path() / name).string();
+				std::ofstream file(path, std::ios::binary | std::ios::trunc);
+				file << contents;
+				return path;
+			}
+
+			static void removeSourceFile(const std::string& path)
+			{
+				std::error_code ec;
+				std::filesystem::remove(path, ec);
+				std::filesystem::remove(getCookedPath(path), ec);
+			}
+
+			/** a closed uv sphere, roughly the triangle count of the carrier's collision parts */
+			static std::vector<TriangleProcessor::TriangleCCW> makeSphereTriangles(int rings, int segments)
+			{
+				auto pointAt = [rings, segments](int ring, int segment)
+				{
+					float theta = glm::pi<float>() * ring / rings;
+					float phi = 2.f * glm::pi<float>() * (segment % segments) / segments;
+					return vec4(glm::sin(theta) * glm::cos(phi), glm::cos(theta), glm::sin(theta) * glm::sin(phi), 1.f);
+				};
+
+				std::vector<TriangleProcessor::TriangleCCW> triangles;
+				for (int ring = 0; ring < rings; ++ring)
+				{
+					for (int segment = 0; segment < segments; ++segment)
+					{
+						vec4 a = pointAt(ring, segment), b = pointAt(ring + 1, segment);
+						vec4 c = pointAt(ring + 1, segment + 1), d = pointAt(ring, segment + 1);
+						if (ring != 0) { triangles.push_back({ a, b, d }); }
+						if (ring != rings - 1) { triangles.push_back({ b, c, d }); }
+					}
+				}
+				return triangles;
+			}
+
+			static CookedHullData toCookedHull(const TriangleProcessor& processor)
+			{
+				CookedHullData hull;
+				hull.points = processor.getPoints();
+				for (const SAT::Shape::EdgePointIndices& edge : processor.getEdgeIndices())
+				{
+					hull.edges.emplace_back(edge.indexA, edge.indexB);
+				}
+				for (const SAT::Shape::FacePointIndices& face : processor.getFaceIndices())
+				{
+					hull.faces.emplace_back(face.edge1.indexA, face.edge1.indexB, face.edge2.indexA, face.edge2.indexB);
+				}
+				return hull;
+			}
+
+			static CookedAssetData makeAssetData()
+			{
+				CookedAssetData data;
+				data.aabbMin = vec3(-1.f, -2.f, -3.f);
+				data.aabbMax = vec3(1.f, 2.f, 3.f);
+				for (int meshIdx = 0; meshIdx < 2; ++meshIdx)
+				{
+					CookedMeshData mesh;
+					for (int vertIdx = 0; vertIdx < 5 + meshIdx; ++vertIdx)
+					{
+						float v = float(vertIdx + 10 * meshIdx);
+						mesh.vertices.push_back(Vertex{ vec3(v, v + 0.5f, -v), vec3(0.f, 1.f, 0.f), vec2(v * 0.1f, 0.25f) });
+						mesh.normalData.push_back(NormalData{ vec3(1.f, 0.f, 0.f), vec3(0.f, 0.f, v) });
+					}
+					mesh.indices = { 0, 1, 2, 2, 3, 4 };
+					mesh.textures.push_back(CookedTextureRef{ "texture_diffuse", "Textures/hull_" + std::to_string(meshIdx) + ".png" });
+					mesh.textures.push_back(CookedTextureRef{ "texture_normalmap", "GameData/engine_assets/NormalMap_Default.png" });
+					data.meshes.push_back(mesh);
+				}
+				data.bHasHull = true;
+				data.hull = toCookedHull(TriangleProcessor(makeSphereTriangles(4, 6), 0.001f));
+				return data;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_RoundTrip : public CookedAsset_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Meshes, textures, AABB and hull read back from the mapping exactly as written";
+
+				std::string sourcePath = makeSourceFile("sa_cooked_roundtrip.obj", "o roundtrip\n");
+				CookedAssetData written = makeAssetData();
+				if (!writeCookedAsset(sourcePath, written))
+				{
+					errorMessage = "failed to write cooked asset";
+					removeSourceFile(sourcePath);
+					return false;
+				}
+
+				bool bPassed = true;
+				sp<CookedAsset> cooked = CookedAsset::open(sourcePath);
+				if (!cooked || cooked->getNumMeshes() != written.meshes.size() || !cooked->hasHull())
+				{
+					errorMessage = "cooked asset did not open or lost its tables";
+					bPassed = false;
+				}
+				else if (cooked->getAABBMin() != written.aabbMin || cooked->getAABBMax() != written.aabbMax)
+				{
+					errorMessage = "AABB mismatch";
+					bPassed = false;
+				}
+
+				for (uint32_t meshIdx = 0; bPassed && meshIdx < cooked->getNumMeshes(); ++meshIdx)
+				{
+					const CookedMeshData& expected = written.meshes[meshIdx];
+					CookedAsset::MeshView view = cooked->getMesh(meshIdx);
+					bool bSameSizes = view.numVertices == expected.vertices.size() && view.numIndices == expected.indices.size() && view.textures.size() == expected.textures.size();
+					if (!bSameSizes
+						|| std::memcmp(view.vertices, expected.vertices.data(), expected.vertices.size() * sizeof(Vertex)) != 0
+						|| std::memcmp(view.normalData, expected.normalData.data(), expected.normalData.size() * sizeof(NormalData)) != 0
+						|| std::memcmp(view.indices, expected.indices.data(), expected.indices.size() * sizeof(uint32_t)) != 0)
+					{
+						errorMessage = "mesh data mismatch";
+						bPassed = false;
+						break;
+					}
+					if (reinterpret_cast<uintptr_t>(view.vertices) % alignof(Vertex) != 0)
+					{
+						errorMessage = "vertex view is not aligned for in place reads";
+						bPassed = false;
+						break;
+					}
+					for (size_t textureIdx = 0; textureIdx < expected.textures.size(); ++textureIdx)
+					{
+						if (view.textures[textureIdx].type != expected.textures[textureIdx].type || view.textures[textureIdx].path != expected.textures[textureIdx].path)
+						{
+							errorMessage = "texture reference mismatch";
+							bPassed = false;
+						}
+					}
+				}
+
+				if (bPassed)
+				{
+					CookedAsset::HullView hull = cooked->getHull();
+					if (hull.numPoints != written.hull.points.size() || hull.numEdges != written.hull.edges.size() || hull.numFaces != written.hull.faces.size()
+						|| !std::equal(hull.points, hull.points + hull.numPoints, written.hull.points.begin())
+						|| !std::equal(hull.edges, hull.edges + hull.numEdges, written.hull.edges.begin())
+						|| !std::equal(hull.faces, hull.faces + hull.numFaces, written.hull.faces.begin()))
+					{
+						errorMessage = "hull data mismatch";
+						bPassed = false;
+					}
+				}
+
+				cooked = nullptr; //unmap before removing the files
+				removeSourceFile(sourcePath);
+				return bPassed;
+			}
+		};
+
+		class Test_ConcurrentWriters : public CookedAsset_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Cooking the same asset from several threads leaves one valid blob and no temp files";
+
+				std::string sourcePath = makeSourceFile("sa_cooked_concurrent.obj", "o concurrent\n");
+				const CookedAssetData written = makeAssetData();
+
+				constexpr int numWriters = 4;
+				constexpr int writesPerThread = 8;
+				std::vector<char> writerSucceeded(numWriters, 0);
+				std::vector<std::thread> writers;
+				for (int writerIdx = 0; writerIdx < numWriters; ++writerIdx)
+				{
+					writers.emplace_back([&, writerIdx]()
+					{
+						bool bAllWritten = true;
+						for (int writeIdx = 0; writeIdx < writesPerThread; ++writeIdx)
+						{
+							bAllWritten &= writeCookedAsset(sourcePath, written);
+						}
+						writerSucceeded[writerIdx] = bAllWritten;
+					});
+				}
+				for (std::thread& writer : writers)
+				{
+					writer.join();
+				}
+
+				bool bPassed = true;
+				if (std::find(writerSucceeded.begin(), writerSucceeded.end(), 0) != writerSucceeded.end())
+				{
+					errorMessage = "a concurrent write failed";
+					bPassed = false;
+				}
+
+				sp<CookedAsset> cooked = CookedAsset::open(sourcePath);
+				if (bPassed && (!cooked || cooked->getNumMeshes() != written.meshes.size() || !cooked->hasHull()))
+				{
+					errorMessage = "cooked asset is damaged after concurrent writes";
+					bPassed = false;
+				}
+				cooked = nullptr;
+
+				const std::string tempPrefix = std::filesystem::path(getCookedPath(sourcePath)).filename().string() + ".";
+				std::error_code ec;
+				for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(std::filesystem::temp_directory_path(), ec))
+				{
+					const std::string fileName = entry.path().filename().string();
+					if (fileName.compare(0, tempPrefix.size(), tempPrefix) == 0 && entry.path().extension() == ".tmp")
+					{
+						errorMessage = "a temp file was left behind";
+						bPassed = false;
+						std::filesystem::remove(entry.path(), ec);
+					}
+				}
+
+				removeSourceFile(sourcePath);
+				return bPassed;
+			}
+		};
+
+		class Test_RejectsStaleOrDamaged : public CookedAsset_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Edited sources, truncated blobs and other versions fall back instead of loading";
+
+				std::string sourcePath = makeSourceFile("sa_cooked_stale.obj", "o stale\n");
+				const std::string cookedPath = getCookedPath(sourcePath);
+				bool bPassed = true;
+
+				if (CookedAsset::open(sourcePath))
+				{
+					errorMessage = "opened a cooked asset that was never written";
+					bPassed = false;
+				}
+
+				//source edited after cooking
+				writeCookedAsset(sourcePath, makeAssetData());
+				makeSourceFile("sa_cooked_stale.obj", "o stale\nv 0 0 0\n");
+				if (bPassed && CookedAsset::open(sourcePath))
+				{
+					errorMessage = "stale cooked asset was accepted after the source changed";
+					bPassed = false;
+				}
+
+				//truncated blob
+				writeCookedAsset(sourcePath, makeAssetData());
+				std::error_code ec;
+				std::filesystem::resize_file(cookedPath, std::filesystem::file_size(cookedPath, ec) / 2, ec);
+				if (bPassed && CookedAsset::open(sourcePath))
+				{
+					errorMessage = "truncated cooked asset was accepted";
+					bPassed = false;
+				}
+
+				//blob from a different layout version
+				writeCookedAsset(sourcePath, makeAssetData());
+				{
+					std::fstream blob(cookedPath, std::ios::binary | std::ios::in | std::ios::out);
+					uint32_t otherVersion = COOKED_ASSET_VERSION + 1;
+					blob.seekp(4);
+					blob.write(reinterpret_cast<const char*>(&otherVersion), sizeof(otherVersion));
+				}
+				if (bPassed && CookedAsset::open(sourcePath))
+				{
+					errorMessage = "cooked asset from another version was accepted";
+					bPassed = false;
+				}
+
+				//recooking recovers
+				writeCookedAsset(sourcePath, makeAssetData());
+				if (bPassed && !CookedAsset::open(sourcePath))
+				{
+					errorMessage = "recooked asset was rejected";
+					bPassed = false;
+				}
+
+				removeSourceFile(sourcePath);
+				return bPassed;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_HullLoad : public CookedAsset_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Collision hull from triangle processing vs mapped cooked hull";
+
+				std::vector<TriangleProcessor::TriangleCCW> triangles = makeSphereTriangles(24, 32);
+				std::string sourcePath = makeSourceFile("sa_cooked_bench.coll.obj", "o bench\n");
+
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point start = Clock::now();
+				TriangleProcessor processed(triangles, 0.001f);
+				const double processMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				CookedAssetData data;
+				data.bHasHull = true;
+				data.hull = toCookedHull(processed);
+				writeCookedAsset(sourcePath, data);
+
+				const int loads = 50;
+				size_t loadedPoints = 0;
+				bool bSameHull = true;
+				start = Clock::now();
+				for (int load = 0; load < loads; ++load)
+				{
+					sp<CookedAsset> cooked = CookedAsset::open(sourcePath);
+					if (!cooked)
+					{
+						bSameHull = false;
+						break;
+					}
+					CookedAsset::HullView hull = cooked->getHull();
+					std::vector<SAT::Shape::EdgePointIndices> edges;
+					std::vector<SAT::Shape::FacePointIndices> faces;
+					for (uint32_t idx = 0; idx < hull.numEdges; ++idx) { edges.push_back({ hull.edges[idx].x, hull.edges[idx].y }); }
+					for (uint32_t idx = 0; idx < hull.numFaces; ++idx) { faces.push_back({ { hull.faces[idx].x, hull.faces[idx].y }, { hull.faces[idx].z, hull.faces[idx].w } }); }
+					TriangleProcessor fromCooked(std::vector<vec4>(hull.points, hull.points + hull.numPoints), std::move(edges), std::move(faces));
+
+					loadedPoints += fromCooked.getPoints().size();
+					bSameHull &= fromCooked.getPoints() == processed.getPoints()
+						&& fromCooked.getEdgeIndices().size() == processed.getEdgeIndices().size()
+						&& fromCooked.getFaceIndices().size() == processed.getFaceIndices().size();
+				}
+				const double cookedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / loads;
+
+				std::cout << "\t\t" << triangles.size() << " triangles, " << processed.getPoints().size() << " points | process " << processMs << "ms | cooked " << cookedMs << "ms" << std::endl;
+
+				removeSourceFile(sourcePath);
+				if (!bSameHull || loadedPoints == 0)
+				{
+					errorMessage = "cooked hull differs from the processed hull";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class CookedAssetTestSuite : public SA::TestSuite
+		{
+		public:
+			CookedAssetTestSuite()
+			{
+				testName = "COOKED ASSET TEST SUITE";
+
+				addTest(new_sp<Test_RoundTrip>());
+				addTest(new_sp<Test_RejectsStaleOrDamaged>());
+				addTest(new_sp<Test_ConcurrentWriters>());
+				addTest(new_sp<Benchmark_HullLoad>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getCookedAssetTestSuite()
+	{
+		return new_sp<SA::CookedAssetTests::CookedAssetTestSuite>();
+	}
+}
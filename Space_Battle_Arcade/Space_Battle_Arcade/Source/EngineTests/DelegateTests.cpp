@@ -1,6 +1,9 @@
 #include "EngineTestSuite.h"
 #include "Tools/DataStructures/MultiDelegate.h"
 
+#include <chrono>
+#include <map>
+
 namespace SA
 {
 	namespace DelegateTests
@@ -845,6 +848,200 @@ namespace SA
 			}
 		};
 
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Test nested broadcasts and queued remove-alls
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ReentrantBroadcast : public MultiDelegate_UnitTest
+		{
+			struct User : public GameEntity
+			{
+				sp<MultiDelegate<int>> delegate = nullptr;
+				int calls = 0;
+				void handleCount(int /*depth*/) { calls++; }
+				void handleRebroadcast(int depth)
+				{
+					if (depth == 0)
+					{
+						//adds and removes made inside the nested broadcast must wait for the outer broadcast to finish
+						delegate->addStrongObj(sp_this(), &User::handleCount);
+						delegate->removeStrong(sp_this(), &User::handleCount);
+						delegate->broadcast(depth + 1);
+					}
+				}
+				void handleRemoveAll(int /*depth*/) { delegate->removeAll(sp_this()); }
+			};
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Test Reentrant Broadcast";
+
+				sp<User> user = new_sp<User>();
+				sp<MultiDelegate<int>> delegate = new_sp<MultiDelegate<int>>();
+				user->delegate = delegate;
+
+				delegate->addStrongObj(user, &User::handleRebroadcast);
+				delegate->addStrongObj(user, &User::handleCount);
+				delegate->broadcast(0);
+				if (user->calls != 2)
+				{
+					errorMessage = "nested broadcast did not reach the existing subscriber exactly once per broadcast";
+					return false;
+				}
+				if (delegate->numStrong() != 2)
+				{
+					errorMessage = "queued operations from a nested broadcast were not applied after the outer broadcast";
+					return false;
+				}
+
+				//a remove-all queued during one broadcast must not keep removing the object on later broadcasts
+				delegate->removeAll(user);
+				delegate->addWeakObj(user, &User::handleRemoveAll);
+				delegate->broadcast(1);
+				delegate->addWeakObj(user, &User::handleCount);
+				user->calls = 0;
+				delegate->broadcast(1);
+				delegate->broadcast(1);
+				if (user->calls != 2 || !delegate->hasBoundWeak(*user))
+				{
+					errorMessage = "binding added after a queued remove-all was removed again";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Test weak subscribers are kept alive for their own callback
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_WeakSubscriberPinnedDuringCallback : public MultiDelegate_UnitTest
+		{
+			struct User : public GameEntity
+			{
+				sp<User>* lastOwner = nullptr;
+				bool* bDestroyed = nullptr;
+				~User() { *bDestroyed = true; }
+				void handleReleaseSelf()
+				{
+					//drops the last strong reference to this object while its callback is on the stack
+					bool* bDestroyedFlag = bDestroyed;
+					lastOwner->reset();
+					bAliveAfterReleaseResult = !*bDestroyedFlag;
+				}
+				static bool bAliveAfterReleaseResult;
+			};
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Test Weak Subscriber Pinned During Callback";
+
+				bool bDestroyed = false;
+				sp<User> owner = new_sp<User>();
+				owner->lastOwner = &owner;
+				owner->bDestroyed = &bDestroyed;
+
+				MultiDelegate<> delegate;
+				delegate.addWeakObj(owner, &User::handleReleaseSelf);
+				User::bAliveAfterReleaseResult = false;
+				delegate.broadcast();
+
+				if (!User::bAliveAfterReleaseResult)
+				{
+					errorMessage = "weak subscriber was destroyed while its own callback was running";
+					return false;
+				}
+				if (!bDestroyed)
+				{
+					errorMessage = "weak subscriber was not released after the broadcast";
+					return false;
+				}
+				delegate.broadcast();
+				if (delegate.numWeak() != 0)
+				{
+					errorMessage = "released weak subscriber was not cleaned up";
+					return false;
+				}
+				return true;
+			}
+		};
+		bool Test_WeakSubscriberPinnedDuringCallback::User::bAliveAfterReleaseResult = false;
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Broadcast benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_Broadcast : public MultiDelegate_UnitTest
+		{
+			struct User : public GameEntity
+			{
+				void handler(float dt_sec) { accumulated += dt_sec; }
+				float accumulated = 0.f;
+			};
+
+			/** the previous storage scheme: address ordered multimaps of shared subscribers with virtual invoke, weak ones locked per call */
+			struct MapSubscriber
+			{
+				virtual ~MapSubscriber() = default;
+				virtual void invoke(float dt_sec) = 0;
+			};
+			struct MapWeakSubscriber : public MapSubscriber
+			{
+				wp<User> weakObj;
+				void(User::*boundFunc)(float);
+				virtual void invoke(float dt_sec) override
+				{
+					if (sp<User> obj = weakObj.lock()) { ((*obj).*boundFunc)(dt_sec); }
+				}
+			};
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Weak broadcast benchmark, tick style delegate";
+
+				const int numSubscribers = 2000;
+				const int broadcasts = 500;
+				std::vector<sp<User>> users;
+				MultiDelegate<float> delegate;
+				std::multimap<GameEntity*, sp<MapSubscriber>> mapSubscribers;
+				for (int userIdx = 0; userIdx < numSubscribers; ++userIdx)
+				{
+					users.push_back(new_sp<User>());
+					delegate.addWeakObj(users.back(), &User::handler);
+
+					sp<MapWeakSubscriber> mapSub = new_sp<MapWeakSubscriber>();
+					mapSub->weakObj = users.back();
+					mapSub->boundFunc = &User::handler;
+					mapSubscribers.emplace(users.back().get(), mapSub);
+				}
+
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point start = Clock::now();
+				for (int broadcast = 0; broadcast < broadcasts; ++broadcast)
+				{
+					for (const auto& key_value_pair : mapSubscribers)
+					{
+						sp<MapSubscriber> subscriber = key_value_pair.second;
+						subscriber->invoke(1.f);
+					}
+				}
+				const double mapUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / broadcasts;
+
+				start = Clock::now();
+				for (int broadcast = 0; broadcast < broadcasts; ++broadcast)
+				{
+					delegate.broadcast(1.f);
+				}
+				const double flatUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / broadcasts;
+
+				std::cout << "\t\t" << numSubscribers << " weak subscribers | map of shared subscribers " << mapUs << "us | flat bindings " << flatUs << "us" << std::endl;
+
+				if (users.front()->accumulated != 2.f * broadcasts)
+				{
+					errorMessage = "subscribers did not receive every broadcast";
+					return false;
+				}
+				return true;
+			}
+		};
+
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/// Container test suite
 		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -869,6 +1066,9 @@ namespace SA
 				addTest(new_sp<Test_PassingDelegateAsParam>());
 				addTest(new_sp<Test_ExpiredWeakBindingsRemoved>());
 				addTest(new_sp<Test_NumStrongBindings>());
+				addTest(new_sp<Test_ReentrantBroadcast>());
+				addTest(new_sp<Test_WeakSubscriberPinnedDuringCallback>());
+				addTest(new_sp<Benchmark_Broadcast>());
 			}
 		};
 	}
@@ -5,10 +5,50 @@
 namespace SA
 {
 	sp<SA::TestSuite> getDelegateTestSuite();
+	sp<SA::TestSuite> getJobSystemTestSuite();
+	sp<SA::TestSuite> getParticleTestSuite();
+	sp<SA::TestSuite> getRenderFrameTestSuite();
+	sp<SA::TestSuite> getModelInstanceStreamTestSuite();
+	sp<SA::TestSuite> getFrustumCullingTestSuite();
+	sp<SA::TestSuite> getBehaviorTreeMemoryTestSuite();
+	sp<SA::TestSuite> getSATKernelTestSuite();
+	sp<SA::TestSuite> getGJKTestSuite();
+	sp<SA::TestSuite> getTimerQueueTestSuite();
+	sp<SA::TestSuite> getComponentLookupTestSuite();
+	sp<SA::TestSuite> getCookedAssetTestSuite();
+	sp<SA::TestSuite> getLightClusterTestSuite();
+	sp<SA::TestSuite> getAudioStreamTestSuite();
+	sp<SA::TestSuite> getTeamSpatialQueryTestSuite();
+	sp<SA::TestSuite> getBehaviorTreeDefinitionTestSuite();
+	sp<SA::TestSuite> getAILodSchedulerTestSuite();
+	sp<SA::TestSuite> getAvoidanceFieldTestSuite();
+	sp<SA::TestSuite> getLogBackendTestSuite();
+	sp<SA::TestSuite> getProjectileStoreTestSuite();
+	sp<SA::TestSuite> getProjectileCollisionTestSuite();
 
 	EngineTestSuite::EngineTestSuite()
 	{
 		addTest(getDelegateTestSuite());
+		addTest(getJobSystemTestSuite());
+		addTest(getParticleTestSuite());
+		addTest(getRenderFrameTestSuite());
+		addTest(getModelInstanceStreamTestSuite());
+		addTest(getFrustumCullingTestSuite());
+		addTest(getBehaviorTreeMemoryTestSuite());
+		addTest(getSATKernelTestSuite());
+		addTest(getGJKTestSuite());
+		addTest(getTimerQueueTestSuite());
+		addTest(getComponentLookupTestSuite());
+		addTest(getCookedAssetTestSuite());
+		addTest(getLightClusterTestSuite());
+		addTest(getAudioStreamTestSuite());
+		addTest(getTeamSpatialQueryTestSuite());
+		addTest(getBehaviorTreeDefinitionTestSuite());
+		addTest(getAILodSchedulerTestSuite());
+		addTest(getAvoidanceFieldTestSuite());
+		addTest(getLogBackendTestSuite());
+		addTest(getProjectileStoreTestSuite());
+		addTest(getProjectileCollisionTestSuite());
 	}
 }
 
@@ -0,0 +1,237 @@
+#include "EngineTestSuite.h"
+#include "Rendering/FrustumCulling.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace SA
+{
+	namespace FrustumCullingTests
+	{
+		using glm::vec3; using glm::vec4; using glm::mat4;
+
+		class FrustumCulling_UnitTest : public SA::UnitTest
+		{
+		public:
+			FrustumCulling_UnitTest()
+			{
+				testNamespace = "FrustumCulling:";
+			}
+		protected:
+			/** camera at the origin looking down -z */
+			static mat4 makeProjectionView(float farPlane)
+			{
+				mat4 projection = glm::perspective(glm::radians(45.f), 1.f, 0.1f, farPlane);
+				mat4 view = glm::lookAt(vec3(0.f), vec3(0.f, 0.f, -1.f), vec3(0.f, 1.f, 0.f));
+				return projection * view;
+			}
+
+			struct Sphere
+			{
+				vec3 center;
+				float radius;
+			};
+
+			static std::vector<Sphere> makeRandomSpheres(size_t count, unsigned int seed)
+			{
+				std::mt19937 rng(seed);
+				std::uniform_real_distribution<float> posDist(-3000.f, 3000.f);
+				std::uniform_real_distribution<float> radiusDist(1.f, 50.f);
+				std::vector<Sphere> spheres(count);
+				for (Sphere& sphere : spheres)
+				{
+					sphere.center = vec3(posDist(rng), posDist(rng), posDist(rng));
+					sphere.radius = radiusDist(rng);
+				}
+				return spheres;
+			}
+
+			/** the straightforward per object test the batched culler replaces */
+			static bool referenceIsVisible(const FrustumPlanes& frustum, const Sphere& sphere, const vec3& cameraPosition, float maxDrawDistance)
+			{
+				for (const vec4& plane : frustum.planes)
+				{
+					if (glm::dot(vec3(plane), sphere.center) + plane.w < -sphere.radius)
+					{
+						return false;
+					}
+				}
+				return glm::length(sphere.center - cameraPosition) <= maxDrawDistance + sphere.radius;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_KnownSpheres : public FrustumCulling_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Spheres inside, outside, and straddling the frustum";
+
+				struct Case { Sphere sphere; bool bExpectVisible; uint8_t expectedLod; const char* description; };
+				const Case cases[] = {
+					{ { vec3(0.f, 0.f, -10.f), 1.f },		true,	0, "in front" },
+					{ { vec3(0.f, 0.f, 10.f), 1.f },		false,	0, "behind" },
+					{ { vec3(0.f, 0.f, 10.f), 15.f },		true,	0, "behind but straddling the near plane" },
+					{ { vec3(100.f, 0.f, -10.f), 1.f },		false,	0, "off to the side" },
+					{ { vec3(100.f, 0.f, -10.f), 200.f },	true,	0, "off to the side but large enough to be seen" },
+					{ { vec3(0.f, 0.f, -300.f), 1.f },		true,	1, "second lod bucket" },
+					{ { vec3(0.f, 0.f, -2000.f), 1.f },		true,	2, "third lod bucket" },
+					{ { vec3(0.f, 0.f, -5000.f), 1.f },		false,	3, "past max draw distance" },
+					{ { vec3(0.f, 0.f, -20000.f), 1.f },	false,	3, "past the far plane" },
+				};
+
+				FrustumCuller culler;
+				culler.setLodDistances({ 250.f, 1000.f, 4000.f });
+				culler.setMaxDrawDistance(4500.f);
+				for (const Case& testCase : cases)
+				{
+					culler.addSphere(testCase.sphere.center, testCase.sphere.radius);
+				}
+				culler.cull(makeProjectionView(10000.f), vec3(0.f));
+
+				const std::vector<uint32_t>& visible = culler.getVisibleIndices();
+				for (uint32_t caseIdx = 0; caseIdx < std::size(cases); ++caseIdx)
+				{
+					const bool bVisible = std::find(visible.begin(), visible.end(), caseIdx) != visible.end();
+					if (bVisible != cases[caseIdx].bExpectVisible)
+					{
+						errorMessage = std::string("wrong visibility for sphere ") + cases[caseIdx].description;
+						return false;
+					}
+					if (bVisible && culler.getLodHint(caseIdx) != cases[caseIdx].expectedLod)
+					{
+						errorMessage = std::string("wrong lod for sphere ") + cases[caseIdx].description;
+						return false;
+					}
+				}
+
+				culler.acceptAll();
+				if (culler.getVisibleIndices().size() != std::size(cases))
+				{
+					errorMessage = "accept all dropped spheres";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_MatchesReference : public FrustumCulling_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Batched cull matches the per object test";
+
+				const float maxDrawDistance = 2500.f;
+				const mat4 projection_view = makeProjectionView(5000.f);
+				const FrustumPlanes frustum = FrustumPlanes::fromProjectionView(projection_view);
+				std::vector<Sphere> spheres = makeRandomSpheres(10000, 5);
+
+				FrustumCuller culler;
+				culler.setMaxDrawDistance(maxDrawDistance);
+				for (const Sphere& sphere : spheres)
+				{
+					culler.addSphere(sphere.center, sphere.radius);
+				}
+				culler.cull(projection_view, vec3(0.f));
+
+				std::vector<uint32_t> expectedVisible;
+				for (uint32_t sphereIdx = 0; sphereIdx < spheres.size(); ++sphereIdx)
+				{
+					if (referenceIsVisible(frustum, spheres[sphereIdx], vec3(0.f), maxDrawDistance))
+					{
+						expectedVisible.push_back(sphereIdx);
+					}
+				}
+
+				if (expectedVisible.empty() || expectedVisible.size() == spheres.size())
+				{
+					errorMessage = "test data does not exercise culling";
+					return false;
+				}
+				if (culler.getVisibleIndices() != expectedVisible)
+				{
+					errorMessage = "visible list differs from reference; got " + std::to_string(culler.getVisibleIndices().size())
+						+ " expected " + std::to_string(expectedVisible.size());
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_Cull : public FrustumCulling_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Frustum cull benchmark";
+
+				const size_t count = 20000;
+				const int frames = 100;
+				const float maxDrawDistance = 2500.f;
+				const mat4 projection_view = makeProjectionView(5000.f);
+				std::vector<Sphere> spheres = makeRandomSpheres(count, 9);
+
+				FrustumCuller culler;
+				culler.setMaxDrawDistance(maxDrawDistance);
+				using Clock = std::chrono::high_resolution_clock;
+
+				for (const Sphere& sphere : spheres)
+				{
+					culler.addSphere(sphere.center, sphere.radius);
+				}
+
+				Clock::time_point start = Clock::now();
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					culler.cull(projection_view, vec3(0.f));
+				}
+				double batchedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+				size_t referenceVisible = 0;
+				start = Clock::now();
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					referenceVisible = 0;
+					const FrustumPlanes frustum = FrustumPlanes::fromProjectionView(projection_view);
+					for (const Sphere& sphere : spheres)
+					{
+						referenceVisible += size_t(referenceIsVisible(frustum, sphere, vec3(0.f), maxDrawDistance));
+					}
+				}
+				double referenceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+				std::cout << "\t\t" << count << " spheres, " << culler.getVisibleIndices().size() << " visible | batched " << batchedMs
+					<< "ms | per object " << referenceMs << "ms" << std::endl;
+				return referenceVisible == culler.getVisibleIndices().size();
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class FrustumCullingTestSuite : public SA::TestSuite
+		{
+		public:
+			FrustumCullingTestSuite()
+			{
+				testName = "FRUSTUM CULLING TEST SUITE";
+
+				addTest(new_sp<Test_KnownSpheres>());
+				addTest(new_sp<Test_MatchesReference>());
+				addTest(new_sp<Benchmark_Cull>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getFrustumCullingTestSuite()
+	{
+		return new_sp<SA::FrustumCullingTests::FrustumCullingTestSuite>();
+	}
+}
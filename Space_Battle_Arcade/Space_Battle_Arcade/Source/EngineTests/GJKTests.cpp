@@ -0,0 +1,302 @@
+#include "EngineTestSuite.h"
+#include "ReferenceCode/OpenGL/Algorithms/GJK/GJKNarrowphase.h"
+#include "SATTestShapes.h"
+
+#include <chrono>
+#include <random>
+
+namespace SA
+{
+	namespace GJKTests
+	{
+		using glm::vec3; using glm::vec4; using glm::mat4;
+		using namespace SATTestShapes;
+
+		class GJK_UnitTest : public SA::UnitTest
+		{
+		public:
+			GJK_UnitTest()
+			{
+				testNamespace = "GJK:";
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// known configurations
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_KnownContacts : public GJK_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Depth, normal, and contact point for overlapping and separated cubes";
+
+				SAT::CubeShape moving, stationary;
+				stationary.updateTransform(mat4(1.f));
+				moving.updateTransform(glm::translate(mat4(1.f), vec3(0.75f, 0.1f, 0.f)));
+
+				GJK::ContactResult contact;
+				if (!GJK::penetration(moving, stationary, contact) || !contact.bColliding)
+				{
+					errorMessage = "overlapping cubes did not collide";
+					return false;
+				}
+				if (glm::abs(contact.penetrationDepth - 0.25f) > 1e-3f || glm::length(contact.normal - vec3(1.f, 0.f, 0.f)) > 1e-3f)
+				{
+					errorMessage = "wrong penetration depth or normal";
+					return false;
+				}
+				//the touching faces are x = 0.5 on the stationary cube and x = 0.25 on the moving one, within both cubes' y/z span
+				vec3 contactPoint = contact.getContactPoint();
+				if (glm::abs(contact.pointOnStationary.x - 0.5f) > 1e-3f || glm::abs(contact.pointOnMoving.x - 0.25f) > 1e-3f
+					|| glm::abs(contactPoint.y) > 0.5f || glm::abs(contactPoint.z) > 0.5f)
+				{
+					errorMessage = "contact points are not on the touching faces";
+					return false;
+				}
+
+				moving.updateTransform(glm::translate(mat4(1.f), vec3(3.f, 0.f, 0.f)));
+				if (GJK::penetration(moving, stationary, contact) || contact.bColliding || GJK::intersects(moving, stationary))
+				{
+					errorMessage = "separated cubes collided";
+					return false;
+				}
+				if (glm::abs(contact.distance - 2.f) > 1e-3f || glm::length(contact.normal - vec3(1.f, 0.f, 0.f)) > 1e-3f)
+				{
+					errorMessage = "wrong separation distance or normal";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_EarlyOut : public GJK_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Distance queries stop once shapes are proven farther than the early out";
+
+				sp<SAT::Shape> moving = makeShape(EKind::CAPSULE);
+				sp<SAT::Shape> stationary = makeShape(EKind::BOX_HULL);
+				stationary->updateTransform(mat4(1.f));
+				moving->updateTransform(glm::translate(mat4(1.f), vec3(0.f, 0.f, 50.f)));
+
+				GJK::ContactResult contact;
+				if (GJK::closestPoints(*moving, *stationary, contact, 10.f))
+				{
+					errorMessage = "far shapes reported within the early out distance";
+					return false;
+				}
+				if (contact.bColliding || contact.distance <= 10.f || contact.distance > 50.f)
+				{
+					errorMessage = "early out did not report a valid lower bound";
+					return false;
+				}
+
+				if (!GJK::closestPoints(*moving, *stationary, contact, 100.f) || glm::abs(contact.distance - 48.5f) > 1e-3f)
+				{
+					errorMessage = "distance within the early out is wrong";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// agreement with SAT
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_MatchesSAT : public GJK_UnitTest
+		{
+			/** For convex polytopes SAT's minimum overlap over face and edge x edge axes is the exact penetration depth, so both must agree */
+			bool matchesSAT(EKind movingKind, EKind stationaryKind, unsigned int seed, int iterations)
+			{
+				const float tolerance = 2e-3f;
+				std::mt19937 rng(seed);
+				sp<SAT::Shape> moving = makeShape(movingKind);
+				sp<SAT::Shape> stationary = makeShape(stationaryKind);
+
+				int numCollisions = 0;
+				int numSeparated = 0;
+				for (int iteration = 0; iteration < iterations; ++iteration)
+				{
+					const mat4 movingXform = makeRandomTransform(rng, 2.f);
+					moving->updateTransform(movingXform);
+					stationary->updateTransform(makeRandomTransform(rng, 2.f));
+
+					vec4 satMTV;
+					bool bSATHit = SAT::Shape::CollisionTest(*moving, *stationary, satMTV);
+					GJK::ContactResult contact;
+					bool bGJKHit = GJK::penetration(*moving, *stationary, contact);
+					const float satDepth = glm::length(vec3(satMTV)) / SAT::Shape::floatMTVCorrectionFactor;
+
+					if (bSATHit != bGJKHit)
+					{
+						//grazing contacts can round either way
+						if (satDepth > tolerance || contact.penetrationDepth > tolerance || (!bGJKHit && contact.distance > tolerance))
+						{
+							errorMessage = "hit result differs from SAT on iteration " + std::to_string(iteration);
+							return false;
+						}
+						continue;
+					}
+
+					if (!bGJKHit)
+					{
+						++numSeparated;
+
+						//the witness points bound the distance from above; SAT still separating just short of it bounds it from below
+						if (glm::abs(glm::length(contact.pointOnMoving - contact.pointOnStationary) - contact.distance) > tolerance)
+						{
+							errorMessage = "closest points do not match distance on iteration " + std::to_string(iteration);
+							return false;
+						}
+						if (contact.distance > 0.01f)
+						{
+							moving->updateTransform(glm::translate(mat4(1.f), -contact.normal * (contact.distance - 0.01f)) * movingXform);
+							if (SAT::Shape::CollisionTest(*moving, *stationary))
+							{
+								errorMessage = "shapes touched before covering the reported distance on iteration " + std::to_string(iteration);
+								return false;
+							}
+						}
+						continue;
+					}
+					++numCollisions;
+
+					if (glm::abs(contact.penetrationDepth - satDepth) > tolerance * glm::max(1.f, satDepth))
+					{
+						errorMessage = "penetration depth differs from SAT on iteration " + std::to_string(iteration);
+						return false;
+					}
+
+					//pushing out along the reported normal by slightly more than the depth separates the shapes
+					moving->updateTransform(glm::translate(mat4(1.f), contact.normal * (contact.penetrationDepth + 0.01f)) * movingXform);
+					if (SAT::Shape::CollisionTest(*moving, *stationary))
+					{
+						errorMessage = "pushing out along the normal did not separate on iteration " + std::to_string(iteration);
+						return false;
+					}
+				}
+
+				if (numCollisions == 0 || numSeparated == 0)
+				{
+					errorMessage = "random placements did not exercise both hits and misses";
+					return false;
+				}
+				return true;
+			}
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Penetration depth and separation agree with SAT for cube, capsule, and mesh hulls";
+
+				const std::pair<EKind, EKind> pairs[] = {
+					{ EKind::CUBE, EKind::CUBE },
+					{ EKind::CAPSULE, EKind::CAPSULE },
+					{ EKind::CAPSULE, EKind::BOX_HULL },
+					{ EKind::BOX_HULL, EKind::BOX_HULL },
+					{ EKind::CUBE, EKind::BOX_HULL },
+				};
+				unsigned int seed = 7;
+				for (const std::pair<EKind, EKind>& pair : pairs)
+				{
+					if (!matchesSAT(pair.first, pair.second, seed++, 2000))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_GJKvsSAT : public GJK_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "GJK/EPA vs SAT benchmark, ship capsule against hull parts";
+
+				using Clock = std::chrono::high_resolution_clock;
+				const size_t numPlacements = 64;
+				const int repeats = 500;
+
+				std::mt19937 rng(17);
+				std::vector<sp<SAT::Shape>> ships, hulls;
+				for (size_t idx = 0; idx < numPlacements; ++idx)
+				{
+					ships.push_back(makeShape(EKind::CAPSULE));
+					ships.back()->updateTransform(makeRandomTransform(rng, 2.f));
+					hulls.push_back(makeShape(EKind::BOX_HULL));
+					hulls.back()->updateTransform(makeRandomTransform(rng, 2.f));
+				}
+
+				size_t satHits = 0, gjkHits = 0;
+				vec4 mtv;
+				Clock::time_point start = Clock::now();
+				for (int repeat = 0; repeat < repeats; ++repeat)
+				{
+					for (size_t idx = 0; idx < numPlacements; ++idx)
+					{
+						satHits += size_t(SAT::Shape::CollisionTest(*ships[idx], *hulls[idx], mtv));
+					}
+				}
+				double satMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+
+				GJK::ContactResult contact;
+				start = Clock::now();
+				for (int repeat = 0; repeat < repeats; ++repeat)
+				{
+					for (size_t idx = 0; idx < numPlacements; ++idx)
+					{
+						gjkHits += size_t(GJK::penetration(*ships[idx], *hulls[idx], contact));
+					}
+				}
+				double gjkMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+
+				start = Clock::now();
+				size_t boolHits = 0;
+				for (int repeat = 0; repeat < repeats; ++repeat)
+				{
+					for (size_t idx = 0; idx < numPlacements; ++idx)
+					{
+						boolHits += size_t(GJK::intersects(*ships[idx], *hulls[idx]));
+					}
+				}
+				double boolMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+
+				std::cout << "\t\t" << numPlacements << " pairs, " << gjkHits / repeats << " hits | SAT " << satMs << "ms | GJK+EPA " << gjkMs
+					<< "ms | GJK overlap only " << boolMs << "ms" << std::endl;
+
+				if (gjkHits != satHits || boolHits != satHits)
+				{
+					errorMessage = "GJK and SAT disagree on benchmark placements";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class GJKTestSuite : public SA::TestSuite
+		{
+		public:
+			GJKTestSuite()
+			{
+				testName = "GJK TEST SUITE";
+
+				addTest(new_sp<Test_KnownContacts>());
+				addTest(new_sp<Test_EarlyOut>());
+				addTest(new_sp<Test_MatchesSAT>());
+				addTest(new_sp<Benchmark_GJKvsSAT>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getGJKTestSuite()
+	{
+		return new_sp<SA::GJKTests::GJKTestSuite>();
+	}
+}
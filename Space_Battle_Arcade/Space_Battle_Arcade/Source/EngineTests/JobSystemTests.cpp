@@ -0,0 +1,327 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/SAJobSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace SA
+{
+	namespace JobSystemTests
+	{
+		class JobSystem_UnitTest : public SA::UnitTest
+		{
+		public:
+			JobSystem_UnitTest()
+			{
+				testNamespace = "JobSystem:";
+			}
+		protected:
+			//more workers than most test machines have cores, so stealing and contention still happen on small machines
+			static constexpr size_t testWorkers = 4;
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// parallel for
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ParallelForVisitsEachIndexOnce : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "ParallelFor visits every index exactly once";
+
+				for (size_t numWorkers : { size_t(0), testWorkers })
+				{
+					JobSystem jobSystem(numWorkers);
+
+					const size_t count = 10007; //prime, so the last batch is partial
+					std::vector<std::atomic<int>> visits(count);
+					for (std::atomic<int>& visit : visits) { visit = 0; }
+
+					jobSystem.parallelFor(count, 64, [&visits](size_t idx) { visits[idx].fetch_add(1); });
+
+					for (size_t idx = 0; idx < count; ++idx)
+					{
+						if (visits[idx].load() != 1)
+						{
+							errorMessage = "index " + std::to_string(idx) + " visited " + std::to_string(visits[idx].load()) + " times with " + std::to_string(numWorkers) + " workers";
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_NestedParallelFor : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Nested ParallelFor completes";
+
+				JobSystem jobSystem(testWorkers);
+				const size_t outer = 32;
+				const size_t inner = 256;
+				std::atomic<size_t> total{ 0 };
+
+				//inner loops wait from inside jobs; waiting runs other jobs, so this must not deadlock
+				jobSystem.parallelFor(outer, 1, [&](size_t) {
+					jobSystem.parallelFor(inner, 16, [&](size_t) { total.fetch_add(1); });
+				});
+
+				if (total.load() != outer * inner)
+				{
+					errorMessage = "expected " + std::to_string(outer * inner) + " inner iterations, got " + std::to_string(total.load());
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// counters and dependencies
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_Dependencies : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Jobs scheduled after a counter wait for all of its jobs";
+
+				JobSystem jobSystem(testWorkers);
+				const size_t numProducers = 64;
+
+				std::vector<int> produced(numProducers, 0);
+				std::atomic<bool> bConsumerSawAll{ false };
+				std::atomic<bool> bFinalRanAfterConsumer{ false };
+				std::atomic<bool> bConsumerDone{ false };
+
+				JobCounter producers;
+				JobCounter consumer;
+				JobCounter finalJob;
+
+				//chain is scheduled before the producers so the continuations are definitely deferred
+				JobCounter gate;
+				jobSystem.run([]() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }, &gate);
+				for (size_t idx = 0; idx < numProducers; ++idx)
+				{
+					jobSystem.runAfter(gate, [&produced, idx]() { produced[idx] = int(idx) + 1; }, &producers);
+				}
+				jobSystem.runAfter(producers, [&]() {
+					bool bAll = true;
+					for (size_t idx = 0; idx < numProducers; ++idx) { bAll &= produced[idx] == int(idx) + 1; }
+					bConsumerSawAll = bAll;
+					bConsumerDone = true;
+				}, &consumer);
+				jobSystem.runAfter(consumer, [&]() { bFinalRanAfterConsumer = bConsumerDone.load(); }, &finalJob);
+
+				//waiting on the end of the chain must also wait on everything before it
+				jobSystem.waitFor(finalJob);
+				jobSystem.waitFor(gate);
+
+				if (!producers.isDone() || !consumer.isDone())
+				{
+					errorMessage = "waiting on the last job returned before its dependencies finished";
+					return false;
+				}
+				if (!bConsumerSawAll)
+				{
+					errorMessage = "dependent job ran before all producers finished";
+					return false;
+				}
+				if (!bFinalRanAfterConsumer)
+				{
+					errorMessage = "chained job ran before its dependency";
+					return false;
+				}
+
+				//depending on a counter that is already done runs right away
+				JobCounter alreadyDone;
+				JobCounter immediate;
+				bool bRan = false;
+				jobSystem.runAfter(alreadyDone, [&bRan]() { bRan = true; }, &immediate);
+				jobSystem.waitFor(immediate);
+				if (!bRan)
+				{
+					errorMessage = "job depending on a finished counter never ran";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_HeadlessRunsOnWaitingThread : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Zero workers runs every job on the waiting thread";
+
+				JobSystem jobSystem(0);
+				if (jobSystem.getThreadCount() != 1)
+				{
+					errorMessage = "zero worker job system reports more than one thread";
+					return false;
+				}
+
+				const std::thread::id testThread = std::this_thread::get_id();
+				bool bAllOnTestThread = true;
+				std::vector<int> order;
+
+				JobCounter first;
+				JobCounter second;
+				jobSystem.run([&]() { order.push_back(1); bAllOnTestThread &= std::this_thread::get_id() == testThread; }, &first);
+				jobSystem.runAfter(first, [&]() { order.push_back(2); bAllOnTestThread &= std::this_thread::get_id() == testThread; }, &second);
+
+				if (order.size() != 0)
+				{
+					errorMessage = "job ran before anything waited for it";
+					return false;
+				}
+
+				jobSystem.waitFor(second);
+				if (!bAllOnTestThread || order != std::vector<int>{1, 2})
+				{
+					errorMessage = "jobs did not run in dependency order on the waiting thread";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// frame scratch
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_FrameScratch : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Frame scratch alignment, overflow and reset";
+
+				FrameScratchAllocator scratch(256);
+				char* byte = scratch.allocateArray<char>(1);
+				double* doubles = scratch.allocateArray<double>(4);
+				if (reinterpret_cast<uintptr_t>(doubles) % alignof(double) != 0 || static_cast<void*>(doubles) == static_cast<void*>(byte))
+				{
+					errorMessage = "allocation not aligned";
+					return false;
+				}
+
+				//overflow into more blocks, including one allocation larger than a block
+				scratch.allocate(200);
+				scratch.allocate(1000);
+				const size_t usedBeforeReset = scratch.getBytesUsed();
+				scratch.reset();
+				if (scratch.getBytesUsed() != 0)
+				{
+					errorMessage = "reset did not release memory";
+					return false;
+				}
+
+				//after reset the merged block should hold last frame's usage without chaining
+				char* first = static_cast<char*>(scratch.allocate(1, 1));
+				char* last = static_cast<char*>(scratch.allocate(usedBeforeReset - 1, 1));
+				if (last != first + 1)
+				{
+					errorMessage = "reset did not merge last frame's blocks";
+					return false;
+				}
+
+				//each thread gets its own allocator
+				JobSystem jobSystem(testWorkers);
+				std::vector<FrameScratchAllocator*> allocatorsUsed(64, nullptr);
+				jobSystem.parallelFor(allocatorsUsed.size(), 1, [&](size_t idx) {
+					FrameScratchAllocator& threadScratch = jobSystem.getFrameScratch();
+					int* values = threadScratch.allocateArray<int>(16);
+					for (int valueIdx = 0; valueIdx < 16; ++valueIdx) { values[valueIdx] = int(idx); }
+					allocatorsUsed[idx] = &threadScratch;
+				});
+				for (FrameScratchAllocator* allocator : allocatorsUsed)
+				{
+					if (!allocator)
+					{
+						errorMessage = "frame scratch not returned to a job";
+						return false;
+					}
+				}
+				jobSystem.resetFrameScratch();
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_ParallelFor : public JobSystem_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "ParallelFor benchmark";
+
+				const size_t count = 1 << 18;
+				std::vector<float> serialResults(count);
+				std::vector<float> parallelResults(count);
+				auto work = [](size_t idx) {
+					float value = float(idx);
+					for (int iteration = 0; iteration < 64; ++iteration) { value = std::sqrt(value * value + 1.f); }
+					return value;
+				};
+
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point serialStart = Clock::now();
+				for (size_t idx = 0; idx < count; ++idx) { serialResults[idx] = work(idx); }
+				double serialMs = std::chrono::duration<double, std::milli>(Clock::now() - serialStart).count();
+
+				JobSystem jobSystem;
+				Clock::time_point parallelStart = Clock::now();
+				jobSystem.parallelFor(count, 1024, [&](size_t idx) { parallelResults[idx] = work(idx); });
+				double parallelMs = std::chrono::duration<double, std::milli>(Clock::now() - parallelStart).count();
+
+				//cost of a frame's worth of tiny jobs, which is mostly scheduling overhead
+				const size_t numTinyJobs = 10000;
+				std::atomic<size_t> tinyJobsRan{ 0 };
+				JobCounter tinyJobs;
+				Clock::time_point tinyStart = Clock::now();
+				for (size_t idx = 0; idx < numTinyJobs; ++idx)
+				{
+					jobSystem.run([&tinyJobsRan]() { tinyJobsRan.fetch_add(1, std::memory_order_relaxed); }, &tinyJobs);
+				}
+				jobSystem.waitFor(tinyJobs);
+				double tinyMs = std::chrono::duration<double, std::milli>(Clock::now() - tinyStart).count();
+
+				std::cout << "\t\t" << jobSystem.getThreadCount() << " threads | serial " << serialMs << "ms | parallelFor " << parallelMs
+					<< "ms | " << numTinyJobs << " empty jobs " << tinyMs << "ms" << std::endl;
+
+				if (serialResults != parallelResults || tinyJobsRan.load() != numTinyJobs)
+				{
+					errorMessage = "parallel results differ from serial results";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class JobSystemTestSuite : public SA::TestSuite
+		{
+		public:
+			JobSystemTestSuite()
+			{
+				testName = "JOB SYSTEM TEST SUITE";
+
+				addTest(new_sp<Test_ParallelForVisitsEachIndexOnce>());
+				addTest(new_sp<Test_NestedParallelFor>());
+				addTest(new_sp<Test_Dependencies>());
+				addTest(new_sp<Test_HeadlessRunsOnWaitingThread>());
+				addTest(new_sp<Test_FrameScratch>());
+				addTest(new_sp<Benchmark_ParallelFor>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getJobSystemTestSuite()
+	{
+		return new_sp<SA::JobSystemTests::JobSystemTestSuite>();
+	}
+}
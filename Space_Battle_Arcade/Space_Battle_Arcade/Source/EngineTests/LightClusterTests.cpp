@@ -0,0 +1,258 @@
+#include "EngineTestSuite.h"
+#include "Rendering/Lights/LightClusterGrid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace SA
+{
+	namespace LightClusterTests
+	{
+		using glm::vec2; using glm::vec3; using glm::vec4; using glm::mat4;
+
+		class LightCluster_UnitTest : public SA::UnitTest
+		{
+		public:
+			LightCluster_UnitTest()
+			{
+				testNamespace = "LightClusters:";
+			}
+		protected:
+			static mat4 makeProjection(float farPlane) { return glm::perspective(glm::radians(90.f), 16.f / 9.f, 1.f, farPlane); }
+
+			/** camera at the origin looking down -z */
+			static mat4 makeView() { return glm::lookAt(vec3(0.f), vec3(0.f, 0.f, -1.f), vec3(0.f, 1.f, 0.f)); }
+
+			static bool isVisible(const LightClusterGrid& grid, uint32_t lightIdx)
+			{
+				const std::vector<uint32_t>& visible = grid.getVisibleLights();
+				return std::find(visible.begin(), visible.end(), lightIdx) != visible.end();
+			}
+
+			/** whether a view space point is inside the frustum of the last bin */
+			static bool inFrustum(const LightClusterGrid& grid, const mat4& projection, const vec3& point_v)
+			{
+				const float depth = -point_v.z;
+				if (depth < grid.getNear() || depth > grid.getFar())
+				{
+					return false;
+				}
+				const vec4 clip = projection * vec4(point_v, 1.f);
+				const vec2 ndc = vec2(clip) / clip.w;
+				return !glm::any(glm::lessThan(ndc, vec2(-1.f))) && !glm::any(glm::greaterThan(ndc, vec2(1.f)));
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_KnownLights : public LightCluster_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Lights in front, behind, off screen, past far, and around the camera";
+
+				struct Case { vec3 position; float radius; bool bExpectVisible; const char* description; };
+				const Case cases[] = {
+					{ vec3(0.f, 0.f, -10.f), 1.f,		true,	"in front" },
+					{ vec3(0.f, 0.f, 10.f), 1.f,		false,	"behind" },
+					{ vec3(500.f, 0.f, -10.f), 1.f,		false,	"off to the side" },
+					{ vec3(0.f, 0.f, -2000.f), 5.f,		false,	"past the far plane" },
+					{ vec3(0.f, 0.f, 2.f), 50.f,		true,	"around the camera" },
+				};
+
+				LightClusterGrid grid;
+				for (const Case& testCase : cases)
+				{
+					grid.addLight(testCase.position, testCase.radius, 1.f);
+				}
+				const mat4 projection = makeProjection(1000.f);
+				grid.bin(makeView(), projection);
+
+				for (uint32_t caseIdx = 0; caseIdx < std::size(cases); ++caseIdx)
+				{
+					if (isVisible(grid, caseIdx) != cases[caseIdx].bExpectVisible)
+					{
+						errorMessage = std::string("wrong visibility for light ") + cases[caseIdx].description;
+						return false;
+					}
+				}
+
+				if (grid.getVisibleLights().front() != 4)
+				{
+					errorMessage = "the light surrounding the camera should rank most important";
+					return false;
+				}
+
+				grid.acceptAll();
+				if (grid.getVisibleLights().size() != std::size(cases))
+				{
+					errorMessage = "accept all dropped lights";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_ConservativeBinning : public LightCluster_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Every light that reaches a point inside the frustum is kept";
+
+				std::mt19937 rng(21);
+				std::uniform_real_distribution<float> xyDist(-600.f, 600.f);
+				std::uniform_real_distribution<float> depthDist(-150.f, 900.f);
+				std::uniform_real_distribution<float> radiusDist(1.f, 40.f);
+				std::uniform_real_distribution<float> unitDist(-1.f, 1.f);
+
+				const mat4 view = glm::lookAt(vec3(30.f, -20.f, 10.f), vec3(40.f, 0.f, -300.f), vec3(0.f, 1.f, 0.f));
+				const mat4 projection = makeProjection(800.f);
+
+				LightClusterGrid grid;
+				std::vector<vec3> positions;
+				std::vector<float> radii;
+				for (int lightIdx = 0; lightIdx < 3000; ++lightIdx)
+				{
+					const vec3 position_v(xyDist(rng), xyDist(rng), -depthDist(rng));
+					positions.push_back(vec3(glm::inverse(view) * vec4(position_v, 1.f)));
+					radii.push_back(radiusDist(rng));
+					grid.addLight(positions.back(), radii.back(), 1.f);
+				}
+				grid.bin(view, projection);
+
+				size_t numSamplesChecked = 0;
+				for (uint32_t lightIdx = 0; lightIdx < positions.size(); ++lightIdx)
+				{
+					const vec3 center_v = vec3(view * vec4(positions[lightIdx], 1.f));
+					for (int sample = 0; sample < 16; ++sample)
+					{
+						vec3 offset(unitDist(rng), unitDist(rng), unitDist(rng));
+						if (glm::length(offset) > 1.f) { continue; }
+
+						if (inFrustum(grid, projection, center_v + offset * radii[lightIdx]))
+						{
+							++numSamplesChecked;
+							if (!isVisible(grid, lightIdx))
+							{
+								errorMessage = "a light that reaches into the frustum was culled";
+								return false;
+							}
+						}
+					}
+				}
+
+				if (numSamplesChecked < 1000 || grid.getVisibleLights().size() == positions.size())
+				{
+					errorMessage = "test data does not exercise culling";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_BudgetKeepsMostImportant : public LightCluster_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Over budget lights drop least important first";
+
+				LightClusterGrid grid;
+				grid.setLightBudget(10);
+				for (int lightIdx = 0; lightIdx < 100; ++lightIdx)
+				{
+					//same size and place, brightness decides
+					grid.addLight(vec3(0.f, 0.f, -50.f), 5.f, float((lightIdx * 37) % 100));
+				}
+				grid.bin(makeView(), makeProjection(1000.f));
+
+				const std::vector<uint32_t>& visible = grid.getVisibleLights();
+				if (visible.size() != 10 || grid.getNumDroppedByBudget() != 90)
+				{
+					errorMessage = "light budget not applied";
+					return false;
+				}
+				for (size_t rank = 0; rank < visible.size(); ++rank)
+				{
+					//brightness (lightIdx * 37) % 100 is a permutation of 0..99, so the kept lights are 99 down to 90
+					if ((visible[rank] * 37) % 100 != 99 - rank)
+					{
+						errorMessage = "kept lights are not the brightest, in order";
+						return false;
+					}
+				}
+
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_Binning : public LightCluster_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Binning cost and lights left for the light pass in a projectile heavy scene";
+
+				const int numLights = 4000;
+				const int frames = 100;
+				std::mt19937 rng(3);
+				std::uniform_real_distribution<float> posDist(-2000.f, 2000.f);
+				std::uniform_real_distribution<float> radiusDist(5.f, 30.f);
+
+				LightClusterGrid grid;
+				grid.setLightBudget(512);
+				for (int lightIdx = 0; lightIdx < numLights; ++lightIdx)
+				{
+					grid.addLight(vec3(posDist(rng), posDist(rng), posDist(rng)), radiusDist(rng), 1.f);
+				}
+
+				const mat4 view = makeView();
+				const mat4 projection = makeProjection(3000.f);
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point start = Clock::now();
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					grid.bin(view, projection);
+				}
+				const double binMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+				std::cout << "\t\t" << numLights << " lights | bin " << binMs << "ms/frame | light pass draws " << grid.getVisibleLights().size()
+					<< " (" << grid.getNumDroppedByBudget() << " over budget)" << std::endl;
+
+				if (grid.getVisibleLights().empty() || grid.getVisibleLights().size() >= size_t(numLights))
+				{
+					errorMessage = "binning did not cull anything";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class LightClusterTestSuite : public SA::TestSuite
+		{
+		public:
+			LightClusterTestSuite()
+			{
+				testName = "LIGHT CLUSTER TEST SUITE";
+
+				addTest(new_sp<Test_KnownLights>());
+				addTest(new_sp<Test_ConservativeBinning>());
+				addTest(new_sp<Test_BudgetKeepsMostImportant>());
+				addTest(new_sp<Benchmark_Binning>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getLightClusterTestSuite()
+	{
+		return new_sp<SA::LightClusterTests::LightClusterTestSuite>();
+	}
+}
@@ -0,0 +1,496 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/SALogBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace SA
+{
+	namespace LogBackendTests
+	{
+		using namespace logging;
+
+		class LogBackend_UnitTest : public SA::UnitTest
+		{
+		public:
+			LogBackend_UnitTest()
+			{
+				testNamespace = "LogBackend:";
+			}
+
+		protected:
+			static std::string tempPath(const char* name)
+			{
+				return (std::filesystem::temp_directory_path() / name).string();
+			}
+
+			static void removeFile(const std::string& path)
+			{
+				std::error_code ec;
+				std::filesystem::remove(path, ec);
+			}
+
+			static AsyncLogBackend::Config quietConfig()
+			{
+				AsyncLogBackend::Config config;
+				config.bWriteConsole = false;
+				return config;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_BinaryRoundTrip : public LogBackend_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Records written to a binary log decode back exactly, long messages are truncated, and cut short logs decode up to the cut";
+
+				const std::string path = tempPath("sa_logbackend_roundtrip.salog");
+				const uint16_t alpha = getCategoryId("LogTest_Alpha");
+				const uint16_t beta = getCategoryId("LogTest_Beta");
+				const std::string spansSlots(300, 'm');
+				const std::string tooLong(AsyncLogBackend::MAX_PAYLOAD_BYTES + 1000, 't');
+				{
+					AsyncLogBackend::Config config = quietConfig();
+					config.binaryLogPath = path;
+					AsyncLogBackend backend(config);
+					backend.push(alpha, LogLevel::LOG, 1, "hello");
+					backend.push(beta, LogLevel::LOG_WARNING, 2, "");
+					backend.push(alpha, LogLevel::LOG_ERROR, 3, spansSlots.c_str());
+					backend.push(beta, LogLevel::LOG, 4, tooLong.c_str());
+				}
+
+				std::vector<DecodedRecord> records;
+				std::string error;
+				{
+					std::ifstream in(path, std::ios::binary);
+					if (!readBinaryLog(in, records, error) || records.size() != 4)
+					{
+						errorMessage = "could not read the log back: " + error;
+						return false;
+					}
+				}
+
+				const DecodedRecord& first = records[0];
+				const DecodedRecord& last = records[3];
+				if (first.category != "LogTest_Alpha" || first.payload != "hello" || first.header.frame != 1 || first.header.level != LogLevel::LOG
+					|| records[1].category != "LogTest_Beta" || !records[1].payload.empty() || records[1].header.level != LogLevel::LOG_WARNING
+					|| records[2].payload != spansSlots || records[2].header.level != LogLevel::LOG_ERROR)
+				{
+					errorMessage = "decoded records do not match what was logged";
+					return false;
+				}
+				if (last.payload.size() != AsyncLogBackend::MAX_PAYLOAD_BYTES || !(last.header.flags & RECORD_FLAG_TRUNCATED))
+				{
+					errorMessage = "long message was not truncated and flagged";
+					return false;
+				}
+				for (size_t recordIdx = 1; recordIdx < records.size(); ++recordIdx)
+				{
+					if (records[recordIdx].header.timestampNs < records[recordIdx - 1].header.timestampNs)
+					{
+						errorMessage = "timestamps went backwards";
+						return false;
+					}
+				}
+
+				//a crash mid write leaves a partial record; everything before it still decodes
+				std::error_code ec;
+				std::filesystem::resize_file(path, std::filesystem::file_size(path, ec) - 10, ec);
+				std::ifstream cutShort(path, std::ios::binary);
+				std::ostringstream text;
+				const bool bDecoded = decodeBinaryLog(cutShort, text, error);
+				if (bDecoded || text.str().find("ERROR   LogTest_Alpha [3] : mmm") == std::string::npos || text.str().find("[4]") != std::string::npos)
+				{
+					errorMessage = "cut short log should fail but still decode the complete records";
+					return false;
+				}
+
+				std::istringstream notALog("just some text, no header");
+				if (decodeBinaryLog(notALog, text, error))
+				{
+					errorMessage = "decoded something that is not a binary log";
+					return false;
+				}
+
+				removeFile(path);
+				return true;
+			}
+		};
+
+		class Test_ConcurrentProducers : public LogBackend_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Four threads logging through a small ring: every record arrives once, in each thread's order";
+
+				constexpr size_t NUM_THREADS = 4;
+				constexpr size_t PER_THREAD = 25000;
+				const uint16_t categoryId = getCategoryId("LogTest_Concurrent");
+
+				std::vector<std::vector<size_t>> received(NUM_THREADS);
+				size_t malformed = 0;
+				AsyncLogBackend::Config config = quietConfig();
+				config.ringSlots = 1024; //wraps around hundreds of times
+				config.errorRetries = UINT32_MAX; //errors wait for room, so nothing is dropped and every record can be checked
+				config.extraSink = [&received, &malformed](const DecodedRecord& record)
+				{
+					size_t thread = 0, index = 0;
+					if (sscanf(record.payload.c_str(), "t%zu i%zu", &thread, &index) != 2 || thread >= NUM_THREADS)
+					{
+						++malformed;
+						return;
+					}
+					received[thread].push_back(index);
+				};
+
+				AsyncLogBackend backend(config);
+				std::vector<std::thread> producers;
+				for (size_t thread = 0; thread < NUM_THREADS; ++thread)
+				{
+					producers.emplace_back([&backend, categoryId, thread]()
+					{
+						char msg[256];
+						for (size_t index = 0; index < PER_THREAD; ++index)
+						{
+							//lengths vary so records take one to three slots
+							snprintf(msg, sizeof(msg), "t%zu i%zu %.*s", thread, index, int(index % 97), "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+							backend.push(categoryId, LogLevel::LOG_ERROR, index, msg);
+						}
+					});
+				}
+				for (std::thread& producer : producers)
+				{
+					producer.join();
+				}
+				backend.flush();
+
+				const AsyncLogBackend::Stats stats = backend.getStats();
+				if (malformed != 0 || stats.numWritten != NUM_THREADS * PER_THREAD || stats.numDropped[2] != 0)
+				{
+					errorMessage = "records were lost or corrupted: " + std::to_string(stats.numWritten) + " written, " + std::to_string(malformed) + " malformed";
+					return false;
+				}
+				for (const std::vector<size_t>& indices : received)
+				{
+					for (size_t index = 0; index < indices.size(); ++index)
+					{
+						if (indices[index] != index)
+						{
+							errorMessage = "a thread's records arrived out of order or twice";
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_FilteringAndDropPolicy : public LogBackend_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Category levels filter at runtime, and a full ring drops records by level and reports it";
+
+				////////////////////////////////////////////////////////
+				// filtering
+				////////////////////////////////////////////////////////
+				setCategoryLevel("LogTest_Filtered", LogLevel::LOG_WARNING);
+				const bool bOwnLevel = !isEnabled("LogTest_Filtered", LogLevel::LOG) && isEnabled("LogTest_Filtered", LogLevel::LOG_WARNING);
+				setDefaultLevel(LogLevel::LOG_ERROR);
+				const bool bDefaultLevel = !isEnabled("LogTest_Default", LogLevel::LOG_WARNING) && isEnabled("LogTest_Filtered", LogLevel::LOG_WARNING);
+				setDefaultLevel(LogLevel::LOG);
+				const bool bDefaultRestored = isEnabled("LogTest_Default", LogLevel::LOG) && !isEnabled("LogTest_Filtered", LogLevel::LOG);
+				setCategoryLevel("LogTest_Filtered", LogLevel::LOG);
+				if (!bOwnLevel || !bDefaultLevel || !bDefaultRestored)
+				{
+					errorMessage = "category levels did not filter as set";
+					return false;
+				}
+
+				////////////////////////////////////////////////////////
+				// overload: hold the writer in its sink so the ring cannot drain
+				////////////////////////////////////////////////////////
+				std::atomic<bool> bWriterHeld{ false };
+				std::atomic<bool> bReleaseWriter{ false };
+				std::vector<DecodedRecord> sunk;
+				AsyncLogBackend::Config config = quietConfig();
+				config.ringSlots = 64;
+				config.errorRetries = 50;
+				config.extraSink = [&](const DecodedRecord& record)
+				{
+					sunk.push_back(record);
+					bWriterHeld = true;
+					while (!bReleaseWriter) { std::this_thread::yield(); }
+				};
+
+				AsyncLogBackend backend(config);
+				const uint16_t categoryId = getCategoryId("LogTest_Overload");
+				backend.push(categoryId, LogLevel::LOG, 0, "first");
+				while (!bWriterHeld) { std::this_thread::yield(); } //within a flush interval the writer takes "first" out of the ring and waits in the sink
+
+				size_t accepted = 0;
+				for (size_t idx = 0; idx < 200; ++idx) { accepted += backend.push(categoryId, LogLevel::LOG, 1, "x") ? 1 : 0; }
+				for (size_t idx = 0; idx < 10; ++idx) { accepted += backend.push(categoryId, LogLevel::LOG_WARNING, 1, "x") ? 1 : 0; }
+				for (size_t idx = 0; idx < 5; ++idx) { accepted += backend.push(categoryId, LogLevel::LOG_ERROR, 1, "x") ? 1 : 0; }
+				if (accepted != backend.getRingSlots())
+				{
+					errorMessage = "a full ring should accept exactly its slots, accepted " + std::to_string(accepted);
+					return false;
+				}
+
+				bReleaseWriter = true;
+				backend.flush();
+				const AsyncLogBackend::Stats stats = backend.getStats();
+				const std::array<uint64_t, NUM_LOG_LEVELS> expectedDrops = { 200 - backend.getRingSlots(), 10, 5 };
+				if (stats.numDropped != expectedDrops || stats.numWritten != 1 + backend.getRingSlots())
+				{
+					errorMessage = "drop counts do not add up";
+					return false;
+				}
+
+				auto droppedRecord = std::find_if(sunk.begin(), sunk.end(), [](const DecodedRecord& record) { return record.header.type == ERecordType::DROPPED; });
+				if (droppedRecord == sunk.end() || droppedRecord->dropped.byLevel[0] != expectedDrops[0] || droppedRecord->dropped.byLevel[2] != 5
+					|| droppedRecord->header.level != LogLevel::LOG_ERROR)
+				{
+					errorMessage = "drops were not reported in the log";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_BackendLifetime : public LogBackend_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "A running backend is never replaced, and flushing from the writer thread returns";
+
+				//the game may already have started the backend SA::log uses; leave it as found
+				const bool bWasRunning = getAsyncBackend() != nullptr;
+				if (!bWasRunning && !startAsyncBackend(quietConfig()))
+				{
+					errorMessage = "could not start a backend when none was running";
+					return false;
+				}
+				AsyncLogBackend* running = getAsyncBackend();
+				const bool bReplaced = startAsyncBackend(quietConfig());
+				const bool bSameBackend = getAsyncBackend() == running;
+				if (!bWasRunning)
+				{
+					stopAsyncBackend();
+				}
+				if (bReplaced || !bSameBackend)
+				{
+					errorMessage = "starting a second backend replaced the running one";
+					return false;
+				}
+
+				//a sink that flushes must not wait on the writer it is running on
+				AsyncLogBackend* sinkBackend = nullptr;
+				size_t numSunk = 0;
+				AsyncLogBackend::Config config = quietConfig();
+				config.extraSink = [&](const DecodedRecord& /*record*/)
+				{
+					sinkBackend->flush();
+					++numSunk;
+				};
+				{
+					AsyncLogBackend backend(config);
+					sinkBackend = &backend;
+					backend.push(getCategoryId("LogTest_Lifetime"), LogLevel::LOG_ERROR, 0, "flushed from the sink");
+					backend.flush();
+				}
+				if (numSunk != 1)
+				{
+					errorMessage = "record was not written";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_StopWhileLogging : public LogBackend_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Stopping the backend while other threads log never frees it under them";
+
+				//stopping the game's own backend would lose its config; the race is only checked when nothing else owns it
+				if (getAsyncBackend() != nullptr)
+				{
+					std::cout << "\t\tgame log backend is running, skipped" << std::endl;
+					return true;
+				}
+
+				constexpr size_t NUM_THREADS = 3;
+				constexpr size_t NUM_RESTARTS = 200;
+				const uint16_t categoryId = getCategoryId("LogTest_StopWhileLogging");
+
+				std::atomic<bool> bLogging{ true };
+				std::atomic<size_t> numPushed{ 0 };
+				std::vector<std::thread> producers;
+				for (size_t thread = 0; thread < NUM_THREADS; ++thread)
+				{
+					producers.emplace_back([&]()
+					{
+						while (bLogging.load())
+						{
+							if (pushToAsyncBackend(categoryId, LogLevel::LOG, 0, "logged across a backend restart"))
+							{
+								++numPushed;
+							}
+						}
+					});
+				}
+
+				size_t numStarted = 0;
+				for (size_t restart = 0; restart < NUM_RESTARTS; ++restart)
+				{
+					numStarted += startAsyncBackend(quietConfig()) ? 1 : 0;
+					std::this_thread::yield();
+					stopAsyncBackend();
+				}
+				bLogging = false;
+				for (std::thread& producer : producers)
+				{
+					producer.join();
+				}
+
+				if (numStarted != NUM_RESTARTS || getAsyncBackend() != nullptr)
+				{
+					errorMessage = "backend did not start and stop cleanly while threads were logging";
+					return false;
+				}
+				if (pushToAsyncBackend(categoryId, LogLevel::LOG, 0, "no backend"))
+				{
+					errorMessage = "push reported success with no backend running";
+					return false;
+				}
+				std::cout << "\t\t" << numPushed.load() << " records pushed across " << NUM_RESTARTS << " restarts" << std::endl;
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_ProducerCost : public LogBackend_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Cost of a log call on the logging thread: synchronous stream write vs async push";
+
+				using Clock = std::chrono::steady_clock;
+				constexpr size_t NUM_CALLS = 100000;
+				const char* msg = "Task_Ship_MoveToLocation: target location reached, selecting next waypoint";
+				const std::string syncPath = tempPath("sa_logbackend_sync.txt");
+				const std::string asyncPath = tempPath("sa_logbackend_async.salog");
+
+				//what log() did before: build the frame string, write the line and flush it
+				double syncNs = 0.0;
+				{
+					std::ofstream syncFile(syncPath, std::ios::trunc);
+					Clock::time_point start = Clock::now();
+					for (size_t call = 0; call < NUM_CALLS; ++call)
+					{
+						std::string frame = "[" + std::to_string(call) + "]";
+						syncFile << "Task_Ship_MoveToLocation" << " " << frame << " : " << msg << std::endl;
+					}
+					syncNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / NUM_CALLS;
+				}
+
+				AsyncLogBackend::Config config = quietConfig();
+				config.binaryLogPath = asyncPath;
+				const uint16_t categoryId = getCategoryId("Task_Ship_MoveToLocation");
+
+				//one producer, timing every call for the tail
+				std::vector<double> callNs(NUM_CALLS);
+				AsyncLogBackend::Stats singleStats;
+				{
+					AsyncLogBackend backend(config);
+					for (size_t call = 0; call < NUM_CALLS; ++call)
+					{
+						Clock::time_point start = Clock::now();
+						getCategoryId("Task_Ship_MoveToLocation"); //what log() does before pushing
+						backend.push(categoryId, LogLevel::LOG, call, msg);
+						callNs[call] = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+					}
+					backend.flush();
+					singleStats = backend.getStats();
+				}
+				double asyncMeanNs = 0.0;
+				for (double ns : callNs) { asyncMeanNs += ns; }
+				asyncMeanNs /= NUM_CALLS;
+				std::sort(callNs.begin(), callNs.end());
+
+				//four producers at once
+				constexpr size_t NUM_THREADS = 4;
+				double contendedNs = 0.0;
+				AsyncLogBackend::Stats contendedStats;
+				{
+					AsyncLogBackend backend(config);
+					std::vector<std::thread> producers;
+					Clock::time_point start = Clock::now();
+					for (size_t thread = 0; thread < NUM_THREADS; ++thread)
+					{
+						producers.emplace_back([&backend, categoryId, msg]()
+						{
+							for (size_t call = 0; call < NUM_CALLS; ++call)
+							{
+								backend.push(categoryId, LogLevel::LOG, call, msg);
+							}
+						});
+					}
+					for (std::thread& producer : producers) { producer.join(); }
+					contendedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / NUM_CALLS;
+					backend.flush();
+					contendedStats = backend.getStats();
+				}
+
+				std::cout << "\t\t" << "sync write+flush " << syncNs << "ns/call | async push mean " << asyncMeanNs << "ns, p50 " << callNs[NUM_CALLS / 2]
+					<< "ns, p99 " << callNs[NUM_CALLS * 99 / 100] << "ns, max " << callNs.back() << "ns (" << singleStats.numDropped[0] << " dropped)" << std::endl;
+				std::cout << "\t\t" << NUM_THREADS << " producers: " << contendedNs << "ns per call per thread, " << contendedStats.numWritten << " written, "
+					<< contendedStats.numDropped[0] << " dropped, ring high water " << contendedStats.slotsHighWater << " slots" << std::endl;
+
+				removeFile(syncPath);
+				removeFile(asyncPath);
+				if (asyncMeanNs >= syncNs)
+				{
+					errorMessage = "async push was not cheaper than a synchronous write";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class LogBackendTestSuite : public SA::TestSuite
+		{
+		public:
+			LogBackendTestSuite()
+			{
+				testName = "LOG BACKEND TEST SUITE";
+
+				addTest(new_sp<Test_BinaryRoundTrip>());
+				addTest(new_sp<Test_ConcurrentProducers>());
+				addTest(new_sp<Test_FilteringAndDropPolicy>());
+				addTest(new_sp<Test_BackendLifetime>());
+				addTest(new_sp<Test_StopWhileLogging>());
+				addTest(new_sp<Benchmark_ProducerCost>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getLogBackendTestSuite()
+	{
+		return new_sp<SA::LogBackendTests::LogBackendTestSuite>();
+	}
+}
@@ -0,0 +1,192 @@
+#include "EngineTestSuite.h"
+#include "Rendering/ModelInstanceStream.h"
+
+#include <chrono>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace SA
+{
+	namespace ModelInstanceStreamTests
+	{
+		using glm::vec3; using glm::vec4; using glm::mat4;
+
+		class ModelInstanceStream_UnitTest : public SA::UnitTest
+		{
+		public:
+			ModelInstanceStream_UnitTest()
+			{
+				testNamespace = "ModelInstanceStream:";
+			}
+		protected:
+			/** parallel arrays like the projectile store; instance idx is encoded in the transform and color */
+			struct SourceInstances
+			{
+				void generate(size_t count, size_t numModels, unsigned int seed)
+				{
+					std::mt19937 rng(seed);
+					std::uniform_int_distribution<int> modelDist(0, int(numModels) - 1);
+					xforms.resize(count);
+					colors.resize(count);
+					modelIds.resize(count);
+					for (size_t idx = 0; idx < count; ++idx)
+					{
+						xforms[idx] = glm::translate(mat4(1.f), vec3(float(idx), 0.f, 0.f));
+						colors[idx] = vec3(float(idx), 0.5f, 0.25f);
+						modelIds[idx] = uint16_t(modelDist(rng));
+					}
+				}
+
+				std::vector<mat4> xforms;
+				std::vector<vec3> colors;
+				std::vector<uint16_t> modelIds;
+			};
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// grouping
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_GroupsByModel : public ModelInstanceStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Instances are grouped into one contiguous batch per model";
+
+				const size_t numModels = 5;
+				SourceInstances source;
+				source.generate(1000, numModels, 7);
+				source.modelIds[0] = 3; //make sure at least one model is unused
+				for (uint16_t& modelId : source.modelIds) { modelId = modelId == 1 ? 2 : modelId; }
+
+				ModelInstanceStream stream;
+				stream.build(source.xforms.data(), source.colors.data(), source.modelIds.data(), source.modelIds.size(), numModels);
+
+				if (stream.size() != source.modelIds.size())
+				{
+					errorMessage = "stream lost or duplicated instances";
+					return false;
+				}
+
+				uint32_t expectedFirst = 0;
+				for (const ModelInstanceBatch& batch : stream.getBatches())
+				{
+					if (batch.firstInstance != expectedFirst || batch.numInstances == 0 || batch.modelId == 1)
+					{
+						errorMessage = "batches are not contiguous, or an empty model produced a batch";
+						return false;
+					}
+					expectedFirst += batch.numInstances;
+
+					//instances keep their relative order within a model, and carry their own transform and color
+					float previousIdx = -1.f;
+					for (uint32_t instanceIdx = batch.firstInstance; instanceIdx < batch.firstInstance + batch.numInstances; ++instanceIdx)
+					{
+						const ModelInstance& instance = stream.getInstances()[instanceIdx];
+						const float sourceIdx = instance.model[3].x;
+						if (sourceIdx <= previousIdx
+							|| source.modelIds[size_t(sourceIdx)] != batch.modelId
+							|| instance.color != vec4(source.colors[size_t(sourceIdx)], 1.f))
+						{
+							errorMessage = "instance " + std::to_string(instanceIdx) + " is in the wrong batch, order, or has the wrong color";
+							return false;
+						}
+						previousIdx = sourceIdx;
+					}
+				}
+				if (expectedFirst != stream.size())
+				{
+					errorMessage = "batches do not cover the stream";
+					return false;
+				}
+
+				stream.build(nullptr, nullptr, nullptr, 0, numModels);
+				if (stream.size() != 0 || stream.getBatches().size() != 0)
+				{
+					errorMessage = "empty build left instances behind";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_ReusesBuffers : public ModelInstanceStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Rebuilding a stream no larger than before does not reallocate";
+
+				SourceInstances source;
+				source.generate(4096, 3, 11);
+
+				ModelInstanceStream stream;
+				stream.build(source.xforms.data(), source.colors.data(), source.modelIds.data(), source.modelIds.size(), 3);
+				const ModelInstance* firstBuffer = stream.getInstances().data();
+
+				for (unsigned int frame = 0; frame < 10; ++frame)
+				{
+					source.generate(4096 - frame * 100, 3, frame);
+					stream.clear();
+					stream.build(source.xforms.data(), source.colors.data(), source.modelIds.data(), source.modelIds.size(), 3);
+					if (stream.getInstances().data() != firstBuffer)
+					{
+						errorMessage = "instance buffer reallocated on frame " + std::to_string(frame);
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_BuildStream : public ModelInstanceStream_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Instance stream build benchmark";
+
+				const size_t count = 20000;
+				const size_t numModels = 4;
+				const int frames = 100;
+				SourceInstances source;
+				source.generate(count, numModels, 3);
+
+				ModelInstanceStream stream;
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point start = Clock::now();
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					stream.build(source.xforms.data(), source.colors.data(), source.modelIds.data(), count, numModels);
+				}
+				double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				std::cout << "\t\t" << count << " projectiles, " << numModels << " models | build " << totalMs / frames << "ms/frame | "
+					<< stream.getBatches().size() << " draw calls instead of " << count << std::endl;
+				return stream.size() == count;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class ModelInstanceStreamTestSuite : public SA::TestSuite
+		{
+		public:
+			ModelInstanceStreamTestSuite()
+			{
+				testName = "MODEL INSTANCE STREAM TEST SUITE";
+
+				addTest(new_sp<Test_GroupsByModel>());
+				addTest(new_sp<Test_ReusesBuffers>());
+				addTest(new_sp<Benchmark_BuildStream>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getModelInstanceStreamTestSuite()
+	{
+		return new_sp<SA::ModelInstanceStreamTests::ModelInstanceStreamTestSuite>();
+	}
+}
@@ -0,0 +1,313 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/SAParticleSystem.h"
+#include "GameFramework/EngineParticles/ParticleInstanceData.h"
+#include "Tools/DataStructures/SATransform.h"
+#include "Tools/SAUtilities.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace SA
+{
+	namespace ParticleTests
+	{
+		using glm::vec3; using glm::vec4; using glm::mat4;
+
+		class Particle_UnitTest : public SA::UnitTest
+		{
+		public:
+			Particle_UnitTest()
+			{
+				testNamespace = "Particles:";
+			}
+
+		protected:
+			template<typename T>
+			static void addFrame(std::vector<Particle::KeyFrame<T>>& frames, const T& start, const T& end, float durationSec, size_t dataIdx)
+			{
+				frames.emplace_back();
+				frames.back().startValue = start;
+				frames.back().endValue = end;
+				frames.back().durationSec = durationSec;
+				frames.back().dataIdx = dataIdx;
+			}
+
+			/** An effect that only grows, like the built in explosion */
+			static sp<Particle::Effect> makeScaleEffect()
+			{
+				sp<Particle::Effect> effect = new_sp<Particle::Effect>();
+				effect->keyFrameChains.emplace_back();
+				addFrame(effect->keyFrameChains.back().vec3KeyFrames, vec3(0.25f), vec3(3.f), 1.5f, MutableEffectData::SCALE_VEC3_IDX);
+				effect->updateEffectDuration();
+				return effect;
+			}
+
+			static bool nearlyEqual(float a, float b) { return std::abs(a - b) <= 1e-4f * std::max(1.f, std::abs(b)); }
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// compiled keyframes match per particle evaluation
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_CompiledMatchesChains : public Particle_UnitTest
+		{
+			template<typename T>
+			static float trackDuration(const std::vector<Particle::KeyFrame<T>>& frames)
+			{
+				float duration = 0.f;
+				for (const Particle::KeyFrame<T>& frame : frames) { duration += frame.durationSec; }
+				return duration;
+			}
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Compiled keyframes match keyframe chains";
+
+				Particle::Effect effect;
+				effect.keyFrameChains.emplace_back();
+				{
+					Particle::KeyFrameChain& chain = effect.keyFrameChains.back();
+					addFrame(chain.vec3KeyFrames, vec3(0.25f), vec3(3.f), 1.5f, MutableEffectData::SCALE_VEC3_IDX);
+					addFrame(chain.vec3KeyFrames, vec3(3.f), vec3(1.f, 2.f, 0.5f), 0.5f, MutableEffectData::SCALE_VEC3_IDX);
+					addFrame(chain.floatKeyFrames, 0.f, 10.f, 2.f, 0);
+				}
+				effect.keyFrameChains.emplace_back();
+				{
+					Particle::KeyFrameChain& chain = effect.keyFrameChains.back();
+					addFrame(chain.vec3KeyFrames, vec3(0.f), vec3(1.f, 2.f, 3.f), 1.f, MutableEffectData::POS_VEC3_IDX);
+					addFrame(chain.vec4KeyFrames, vec4(1.f, 0.f, 0.f, 1.f), vec4(0.f, 0.f, 1.f, 0.f), 0.75f, 1);
+				}
+				effect.updateEffectDuration();
+
+				Particle::CompiledKeyFrames compiled;
+				compiled.compile(effect);
+
+				std::vector<float> times;
+				for (float time = 0.f; time < 2.5f; time += 0.0625f) { times.push_back(time); }
+				std::vector<float> lanes(compiled.numLanes() * times.size());
+				compiled.evaluate(times.data(), 0, times.size(), times.size(), lanes.data());
+
+				for (size_t timeIdx = 0; timeIdx < times.size(); ++timeIdx)
+				{
+					//per particle reference; finished tracks are held at their end value
+					MutableEffectData expected;
+					expected.floatsArray.assign(1, 0.f);
+					expected.vec3Array = { vec3(0.f), vec3(0.f), vec3(1.f) };
+					expected.vec4Array.assign(2, vec4(0.f));
+					for (const Particle::KeyFrameChain& chain : effect.keyFrameChains)
+					{
+						const float time = times[timeIdx];
+						Particle::KeyFrameChain::updateFrames(expected.floatsArray, chain.floatKeyFrames, std::min(time, trackDuration(chain.floatKeyFrames)));
+						Particle::KeyFrameChain::updateFrames(expected.vec3Array, chain.vec3KeyFrames, std::min(time, trackDuration(chain.vec3KeyFrames)));
+						Particle::KeyFrameChain::updateFrames(expected.vec4Array, chain.vec4KeyFrames, std::min(time, trackDuration(chain.vec4KeyFrames)));
+					}
+
+					auto lane = [&](size_t laneIdx) { return lanes[laneIdx * times.size() + timeIdx]; };
+					bool bMatches = nearlyEqual(lane(0), expected.floatsArray[0]);
+					for (size_t vec3Idx = 0; vec3Idx < 3; ++vec3Idx)
+					{
+						for (size_t component = 0; component < 3; ++component)
+						{
+							bMatches &= nearlyEqual(lane(compiled.vec3Lane(vec3Idx) + component), expected.vec3Array[vec3Idx][int(component)]);
+						}
+					}
+					for (size_t component = 0; component < 4; ++component)
+					{
+						bMatches &= nearlyEqual(lane(compiled.vec4LaneStart + 4 + component), expected.vec4Array[1][int(component)]);
+					}
+
+					if (!bMatches)
+					{
+						errorMessage = "compiled keyframes differ from keyframe chains at time " + std::to_string(times[timeIdx]);
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_InstanceMatrices : public Particle_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Instance matrices match transform composition";
+
+				//rotation and position on their own chains so they animate alongside the scale
+				sp<Particle::Effect> spinningEffect = makeScaleEffect();
+				spinningEffect->keyFrameChains.emplace_back();
+				addFrame(spinningEffect->keyFrameChains.back().vec3KeyFrames, vec3(0.f), vec3(90.f, 45.f, 10.f), 1.f, MutableEffectData::ROT_VEC3_IDX);
+				spinningEffect->keyFrameChains.emplace_back();
+				addFrame(spinningEffect->keyFrameChains.back().vec3KeyFrames, vec3(0.f), vec3(4.f, 5.f, 6.f), 2.f, MutableEffectData::POS_VEC3_IDX);
+				spinningEffect->updateEffectDuration();
+
+				for (const sp<Particle::Effect>& effect : { makeScaleEffect(), spinningEffect })
+				{
+					EffectInstanceData eid;
+					eid.initialize(effect);
+
+					Transform groupXform;
+					groupXform.position = vec3(10.f, -3.f, 7.f);
+					groupXform.rotQuat = glm::angleAxis(glm::radians(30.f), glm::normalize(vec3(1.f, 1.f, 0.f)));
+					groupXform.scale = vec3(2.f);
+					const mat4 groupModelMat = groupXform.getModelMatrix();
+
+					const std::vector<float> times = { 0.f, 0.4f, 1.1f, 3.f };
+					eid.clearFrameData();
+					for (float time : times) { eid.addInstance(time, groupModelMat); }
+					eid.prepareInstanceBuffers();
+					eid.updateInstances(0, eid.numInstancesThisFrame);
+
+					for (size_t instanceIdx = 0; instanceIdx < times.size(); ++instanceIdx)
+					{
+						MutableEffectData expected;
+						expected.vec3Array = { vec3(0.f), vec3(0.f), vec3(1.f) };
+						for (const Particle::KeyFrameChain& chain : effect->keyFrameChains)
+						{
+							//each chain here is a single frame; clamp so finished frames hold their end value
+							Particle::KeyFrameChain::updateFrames(expected.vec3Array, chain.vec3KeyFrames, std::min(times[instanceIdx], chain.vec3KeyFrames[0].durationSec));
+						}
+
+						Transform effectXform;
+						effectXform.position = expected.vec3Array[MutableEffectData::POS_VEC3_IDX];
+						effectXform.rotQuat = Utils::degreesVecToQuat(expected.vec3Array[MutableEffectData::ROT_VEC3_IDX]);
+						effectXform.scale = expected.vec3Array[MutableEffectData::SCALE_VEC3_IDX];
+						const mat4 expectedModel = groupModelMat * effectXform.getModelMatrix();
+
+						const mat4& model = eid.mat4Data[instanceIdx * eid.numMat4PerInstance];
+						for (int column = 0; column < 4; ++column)
+						{
+							for (int row = 0; row < 4; ++row)
+							{
+								if (!nearlyEqual(model[column][row], expectedModel[column][row]))
+								{
+									errorMessage = "model matrix mismatch for instance " + std::to_string(instanceIdx);
+									return false;
+								}
+							}
+						}
+						const vec4& builtinVec4 = eid.vec4Data[instanceIdx * eid.numVec4PerInstance];
+						if (builtinVec4.x != times[instanceIdx] || builtinVec4.y != *effect->effectDuration)
+						{
+							errorMessage = "built in vec4 should hold time alive and effect duration";
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_50kEffects : public Particle_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "50k live effects benchmark";
+
+				const size_t numEffects = 50000;
+				const size_t numFrames = 100;
+				sp<Particle::Effect> effect = makeScaleEffect();
+
+				std::vector<float> times(numEffects);
+				std::vector<mat4> groupModelMats(numEffects);
+				for (size_t idx = 0; idx < numEffects; ++idx)
+				{
+					times[idx] = 1.5f * float(idx) / float(numEffects);
+					groupModelMats[idx] = glm::translate(mat4(1.f), vec3(float(idx), 0.f, 0.f));
+				}
+
+				using Clock = std::chrono::high_resolution_clock;
+
+				//batched path, as the particle system runs it
+				EffectInstanceData eid;
+				eid.initialize(effect);
+				const mat4* steadyStateBuffer = nullptr;
+				bool bReallocatedInSteadyState = false;
+				double batchedMs = 0.0;
+				for (size_t frame = 0; frame < numFrames + 1; ++frame)
+				{
+					Clock::time_point start = Clock::now();
+					eid.clearFrameData();
+					for (size_t idx = 0; idx < numEffects; ++idx) { eid.addInstance(times[idx], groupModelMats[idx]); }
+					eid.prepareInstanceBuffers();
+					eid.updateInstances(0, eid.numInstancesThisFrame);
+					double frameMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+					//first frame grows the buffers from the spawn estimate; it is not timed
+					if (frame == 0)
+					{
+						steadyStateBuffer = eid.mat4Data.data();
+						continue;
+					}
+					batchedMs += frameMs;
+					bReallocatedInSteadyState |= eid.mat4Data.data() != steadyStateBuffer;
+				}
+
+				//per particle path, for comparison; evaluates each particle's chains then packages it
+				MutableEffectData particleData;
+				particleData.vec3Array = { vec3(0.f), vec3(0.f), vec3(1.f) };
+				std::vector<mat4> perParticleMat4s;
+				std::vector<vec4> perParticleVec4s;
+				double perParticleMs = 0.0;
+				for (size_t frame = 0; frame < numFrames; ++frame)
+				{
+					Clock::time_point start = Clock::now();
+					perParticleMat4s.clear();
+					perParticleVec4s.clear();
+					for (size_t idx = 0; idx < numEffects; ++idx)
+					{
+						for (const Particle::KeyFrameChain& chain : effect->keyFrameChains) { chain.update(particleData, times[idx]); }
+						Transform effectXform;
+						effectXform.position = particleData.vec3Array[MutableEffectData::POS_VEC3_IDX];
+						effectXform.rotQuat = Utils::degreesVecToQuat(particleData.vec3Array[MutableEffectData::ROT_VEC3_IDX]);
+						effectXform.scale = particleData.vec3Array[MutableEffectData::SCALE_VEC3_IDX];
+						perParticleMat4s.push_back(groupModelMats[idx] * effectXform.getModelMatrix());
+						perParticleVec4s.push_back(vec4(times[idx], *effect->effectDuration, 0.f, 0.f));
+					}
+					perParticleMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+				}
+
+				const double toNsPerParticle = 1e6 / double(numFrames * numEffects);
+				std::cout << "\t\t" << numEffects << " effects | batched " << batchedMs * toNsPerParticle << " ns/particle (" << batchedMs / numFrames
+					<< " ms/frame) | per particle " << perParticleMs * toNsPerParticle << " ns/particle (" << perParticleMs / numFrames << " ms/frame)" << std::endl;
+
+				if (bReallocatedInSteadyState)
+				{
+					errorMessage = "instance buffers reallocated after reaching peak size";
+					return false;
+				}
+				for (size_t idx = 0; idx < numEffects; idx += 997)
+				{
+					if (!nearlyEqual(eid.mat4Data[idx][0][0], perParticleMat4s[idx][0][0]) || !nearlyEqual(eid.mat4Data[idx][3][0], perParticleMat4s[idx][3][0]))
+					{
+						errorMessage = "batched results differ from per particle results";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class ParticleTestSuite : public SA::TestSuite
+		{
+		public:
+			ParticleTestSuite()
+			{
+				testName = "PARTICLE TEST SUITE";
+
+				addTest(new_sp<Test_CompiledMatchesChains>());
+				addTest(new_sp<Test_InstanceMatrices>());
+				addTest(new_sp<Benchmark_50kEffects>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getParticleTestSuite()
+	{
+		return new_sp<SA::ParticleTests::ParticleTestSuite>();
+	}
+}
@@ -0,0 +1,329 @@
+#include "EngineTestSuite.h"
+#include "Game/GameSystems/SystemData/SAProjectileCollision.h"
+#include "Game/GameSystems/SystemData/SAProjectileStore.h"
+#include "GameFramework/SACollisionUtils.h"
+#include "GameFramework/SAWorldEntity.h"
+#include "GameFramework/Components/CollisionComponent.h"
+#include "ReferenceCode/OpenGL/Algorithms/SeparatingAxisTheorem/SATComponent.h"
+
+#include <cmath>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/matrix_operation.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+namespace SA
+{
+	namespace ProjectileCollisionTests
+	{
+		using glm::vec3; using glm::vec4; using glm::mat3; using glm::mat4;
+
+		constexpr float MISS = -1.f;
+
+		class ProjectileCollision_UnitTest : public SA::UnitTest
+		{
+		public:
+			ProjectileCollision_UnitTest()
+			{
+				testNamespace = "ProjectileCollision:";
+			}
+
+		protected:
+			struct SegmentCase
+			{
+				vec3 origin;
+				vec3 delta;
+				vec3 padding;
+				float expectedEnterT; //MISS for segments that should not hit
+			};
+
+			/** segments against the unit cube [-0.5, 0.5]^3 */
+			static std::vector<SegmentCase> unitCubeCases()
+			{
+				return {
+					{ vec3(-2.f, 0.f, 0.f), vec3(4.f, 0.f, 0.f), vec3(0.f), 0.375f },
+					{ vec3(2.f, 0.f, 0.f), vec3(-4.f, 0.f, 0.f), vec3(0.f), 0.375f },
+					{ vec3(0.f, 0.f, -3.f), vec3(0.f, 0.f, 6.f), vec3(0.f), 2.5f / 6.f },
+					{ vec3(3.f, 3.f, 3.f), vec3(-6.f), vec3(0.f), 2.5f / 6.f },
+					{ vec3(0.1f, 0.2f, -0.3f), vec3(1.f), vec3(0.f), 0.f },				//starts inside
+					{ vec3(-2.f, 0.f, 0.f), vec3(1.f, 0.f, 0.f), vec3(0.f), MISS },		//stops short
+					{ vec3(-2.f, 0.55f, 0.f), vec3(4.f, 0.f, 0.f), vec3(0.f), MISS },		//passes just above
+					{ vec3(-2.f, 0.55f, 0.f), vec3(4.f, 0.f, 0.f), vec3(0.1f), 0.35f },	//padding reaches the cube
+					{ vec3(-2.f, 0.6f, 0.f), vec3(4.f, 0.f, 0.f), vec3(0.f, 0.05f, 0.f), MISS },
+				};
+			}
+
+			static bool enterMatches(bool bHit, float enterT, float expectedEnterT)
+			{
+				return expectedEnterT == MISS ? !bHit : (bHit && std::abs(enterT - expectedEnterT) < 1e-4f);
+			}
+
+			/** a unit cube box entity with a single cube collision shape filling its OBB */
+			struct TestWorld
+			{
+				SH::SpatialHashGrid<WorldEntity> grid{ vec3(4.f) }; //declared first so grid entries are removed before it goes away
+				std::vector<sp<WorldEntity>> entities;
+				std::vector<std::unique_ptr<SH::HashEntry<WorldEntity>>> gridEntries;
+				ProjectileStore projectiles;
+				ProjectileOwnerTable owners;
+				std::vector<vec3> segmentStarts;
+
+				sp<WorldEntity> addBox(const vec3& position)
+				{
+					Transform xform;
+					xform.position = position;
+					sp<WorldEntity> entity = new_sp<WorldEntity>(xform);
+
+					sp<CollisionData> collisionData = new_sp<CollisionData>();
+					std::array<vec4, 8>& localAABB = collisionData->getLocalAABB();
+					for (size_t corner = 0; corner < 8; ++corner)
+					{
+						localAABB[corner] = vec4(corner & 1 ? 0.5f : -0.5f, corner & 2 ? 0.5f : -0.5f, corner & 4 ? 0.5f : -0.5f, 1.f);
+					}
+					CollisionData::ShapeData shapeData{ mat4(1.f), new_sp<SAT::CubeShape>(), ECollisionShape::CUBE };
+					collisionData->addNewCollisionShape(shapeData);
+					collisionData->updateToNewWorldTransform(xform.getModelMatrix());
+
+					entity->createGameComponent<CollisionComponent>()->setCollisionData(collisionData);
+					gridEntries.push_back(grid.insert(*entity, collisionData->getWorldOBB()));
+					entities.push_back(entity);
+					return entity;
+				}
+
+				/** places a projectile as the projectile system leaves it after a move: at the segment end, with its collision box stretched over the segment */
+				size_t addProjectile(const vec3& start, const vec3& end, const vec3& aabbSize, const sp<WorldEntity>& owner = nullptr)
+				{
+					const vec3 direction_n = glm::normalize(end - start);
+					const float dt_distance = glm::length(end - start);
+
+					const size_t projectileIdx = projectiles.add();
+					projectiles.positions[projectileIdx] = end;
+					projectiles.directions_n[projectileIdx] = direction_n;
+					projectiles.directionQuats[projectileIdx] = glm::rotation(vec3(0.f, 0.f, -1.f), direction_n);
+					projectiles.aabbSizes[projectileIdx] = aabbSize;
+					projectiles.ownerIds[projectileIdx] = owner ? owners.acquire(owner) : ProjectileOwnerTable::NO_OWNER;
+
+					mat4 collisionXform = glm::translate(mat4(1.f), end) * glm::toMat4(projectiles.directionQuats[projectileIdx]);
+					collisionXform = glm::translate(collisionXform, vec3(0.f, 0.f, dt_distance / 2.f));
+					projectiles.collisionXforms[projectileIdx] = glm::scale(collisionXform, vec3(aabbSize.x, aabbSize.y, dt_distance));
+
+					segmentStarts.resize(projectiles.size());
+					segmentStarts[projectileIdx] = start;
+					return projectileIdx;
+				}
+			};
+
+			static const ProjectileCollisionPhase::Hit* findHit(const std::vector<ProjectileCollisionPhase::Hit>& hits, size_t projectileIdx)
+			{
+				for (const ProjectileCollisionPhase::Hit& hit : hits)
+				{
+					if (hit.projectileIdx == projectileIdx)
+					{
+						return &hit;
+					}
+				}
+				return nullptr;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// kernels
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SegmentsVsUnitCube : public ProjectileCollision_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Batched slab test enters the padded unit cube at the right t and misses cleanly";
+
+				//several copies so the batch is longer than a vector register and has a scalar tail
+				const std::vector<SegmentCase> cases = unitCubeCases();
+				SegmentBatch batch;
+				for (size_t copy = 0; copy < 3; ++copy)
+				{
+					for (const SegmentCase& segmentCase : cases)
+					{
+						batch.push(segmentCase.origin, segmentCase.delta, segmentCase.padding);
+					}
+				}
+
+				std::vector<float> enterT;
+				segmentsVsUnitCube(batch, enterT);
+				if (enterT.size() != batch.size())
+				{
+					errorMessage = "one entry t per segment was not written";
+					return false;
+				}
+				for (size_t batchIdx = 0; batchIdx < enterT.size(); ++batchIdx)
+				{
+					const SegmentCase& segmentCase = cases[batchIdx % cases.size()];
+					if (!enterMatches(enterT[batchIdx] <= 1.f, enterT[batchIdx], segmentCase.expectedEnterT))
+					{
+						errorMessage = "segment " + std::to_string(batchIdx % cases.size()) + " entered at " + std::to_string(enterT[batchIdx]);
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_SegmentVsConvexShape : public ProjectileCollision_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Swept box vs convex shape agrees with the slab kernel, on transformed shapes and with rotated boxes";
+
+				std::vector<vec3> faceAxes;
+				SAT::CubeShape cube;
+				cube.updateTransform(mat4(1.f));
+
+				for (const SegmentCase& segmentCase : unitCubeCases())
+				{
+					float enterT = MISS;
+					const bool bHit = segmentVsConvexShape(segmentCase.origin, segmentCase.origin + segmentCase.delta, glm::diagonal3x3(segmentCase.padding), cube, faceAxes, enterT);
+					if (!enterMatches(bHit, enterT, segmentCase.expectedEnterT))
+					{
+						errorMessage = "unit cube case entered at " + std::to_string(enterT);
+						return false;
+					}
+				}
+
+				//a bare segment is exact, so against a transformed cube it must match the slab kernel run in the cube's local space
+				mat4 cubeXform = glm::translate(mat4(1.f), vec3(10.f, -3.f, 2.f));
+				cubeXform = glm::rotate(cubeXform, glm::radians(40.f), glm::normalize(vec3(1.f, 2.f, 0.5f)));
+				cubeXform = glm::scale(cubeXform, vec3(3.f, 1.f, 2.f));
+				cube.updateTransform(cubeXform);
+				const mat4 worldToCube = glm::inverse(cubeXform);
+
+				std::mt19937 rng(21);
+				std::uniform_real_distribution<float> posDist(-4.f, 4.f);
+				size_t numHits = 0;
+				for (size_t segmentIdx = 0; segmentIdx < 2000; ++segmentIdx)
+				{
+					const vec3 start = vec3(10.f, -3.f, 2.f) + vec3(posDist(rng), posDist(rng), posDist(rng));
+					const vec3 end = vec3(10.f, -3.f, 2.f) + vec3(posDist(rng), posDist(rng), posDist(rng));
+
+					SegmentBatch batch;
+					batch.push(vec3(worldToCube * vec4(start, 1.f)), vec3(worldToCube * vec4(end - start, 0.f)), vec3(0.f));
+					std::vector<float> slabT;
+					segmentsVsUnitCube(batch, slabT);
+					const bool bSlabHit = slabT[0] <= 1.f;
+
+					float enterT = MISS;
+					const bool bHit = segmentVsConvexShape(start, end, mat3(0.f), cube, faceAxes, enterT);
+					if (bHit != bSlabHit || (bHit && std::abs(enterT - slabT[0]) > 1e-3f))
+					{
+						errorMessage = "transformed cube disagrees with the slab kernel in its local space";
+						return false;
+					}
+					numHits += bHit ? 1 : 0;
+				}
+				if (numHits == 0)
+				{
+					errorMessage = "no random segment hit the transformed cube, so nothing was compared";
+					return false;
+				}
+
+				//a box rotated about the travel direction reaches further than its half extents along the face normals
+				cube.updateTransform(mat4(1.f));
+				const mat3 rotatedHalfAxes = mat3(glm::rotate(mat4(1.f), glm::radians(45.f), vec3(0.f, 0.f, 1.f))) * glm::diagonal3x3(vec3(0.1f, 0.1f, 0.f));
+				float enterT = MISS;
+				const float expectedT = (2.f - 0.5f - 0.1f * std::sqrt(2.f)) / 4.f;
+				if (!segmentVsConvexShape(vec3(-2.f, 0.f, 0.f), vec3(2.f, 0.f, 0.f), rotatedHalfAxes, cube, faceAxes, enterT) || std::abs(enterT - expectedT) > 1e-4f)
+				{
+					errorMessage = "rotated box did not enter by its projected radius";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// phase
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_ClosestHitSelection : public ProjectileCollision_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Each projectile reports its closest hit, measured from the segment start, skipping owners and spent projectiles";
+
+				//kept off the grid's cell boundaries, as line traces along a boundary are ambiguous about which cells they visit
+				const vec3 origin(1.3f, 1.7f, 2.1f);
+				TestWorld world;
+				sp<WorldEntity> nearBox = world.addBox(origin + vec3(5.f, 0.f, 0.f));
+				sp<WorldEntity> farBox = world.addBox(origin + vec3(10.f, 0.f, 0.f));
+
+				//the whole frame's travel is 20 units, so entering up to half a segment early would be plain to see
+				const vec3 crossSection(0.2f, 0.2f, 1.f);
+				const vec3 travel(20.f, 0.f, 0.f);
+				const vec3 above(0.f, 0.55f, 0.f);
+				const vec3 clear(0.f, 0.75f, 0.f);
+				const size_t throughBoth = world.addProjectile(origin, origin + travel, crossSection);
+				const size_t fromNearBox = world.addProjectile(origin, origin + travel, crossSection, nearBox);
+				const size_t grazing = world.addProjectile(origin + above, origin + above + travel, crossSection);
+				const size_t passingAbove = world.addProjectile(origin + clear, origin + clear + travel, crossSection);
+				const size_t alreadyHit = world.addProjectile(origin, origin + travel, crossSection);
+				world.projectiles.flags[alreadyHit] |= ProjectileStore::FLAG_HIT;
+				const size_t fromBehind = world.addProjectile(origin + travel, origin, crossSection);
+
+				ProjectileCollisionPhase phase;
+				std::vector<ProjectileCollisionPhase::Hit> hits;
+				phase.run(world.projectiles, world.segmentStarts, world.owners, world.grid, hits);
+
+				auto expectHit = [&](size_t projectileIdx, const sp<WorldEntity>& entity, float distance, const char* failMessage)
+				{
+					const ProjectileCollisionPhase::Hit* hit = findHit(hits, projectileIdx);
+					if (!hit || hit->entity != entity.get() || std::abs(hit->hitDistance - distance) > 1e-3f)
+					{
+						errorMessage = failMessage;
+						return false;
+					}
+					return true;
+				};
+
+				if (!expectHit(throughBoth, nearBox, 4.5f, "projectile through both boxes did not hit the near face of the near box")
+					|| !expectHit(fromNearBox, farBox, 9.5f, "projectile hit its owner instead of the box behind it")
+					|| !expectHit(grazing, nearBox, 4.5f, "projectile's cross section did not sweep into a box its center line misses")
+					|| !expectHit(fromBehind, farBox, 9.5f, "projectile fired the other way did not hit the far box first"))
+				{
+					return false;
+				}
+				if (findHit(hits, passingAbove) || findHit(hits, alreadyHit))
+				{
+					errorMessage = "a projectile clear of the boxes or already spent reported a hit";
+					return false;
+				}
+				for (size_t hitIdx = 1; hitIdx < hits.size(); ++hitIdx)
+				{
+					if (hits[hitIdx - 1].projectileIdx >= hits[hitIdx].projectileIdx)
+					{
+						errorMessage = "hits are not one per projectile in projectile order";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class ProjectileCollisionTestSuite : public SA::TestSuite
+		{
+		public:
+			ProjectileCollisionTestSuite()
+			{
+				testName = "PROJECTILE COLLISION TEST SUITE";
+
+				addTest(new_sp<Test_SegmentsVsUnitCube>());
+				addTest(new_sp<Test_SegmentVsConvexShape>());
+				addTest(new_sp<Test_ClosestHitSelection>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getProjectileCollisionTestSuite()
+	{
+		return new_sp<SA::ProjectileCollisionTests::ProjectileCollisionTestSuite>();
+	}
+}
@@ -0,0 +1,348 @@
+#include "EngineTestSuite.h"
+#include "Game/GameSystems/SystemData/SAProjectileStore.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace SA
+{
+	namespace ProjectileStoreTests
+	{
+		using glm::vec3;
+
+		class ProjectileStore_UnitTest : public SA::UnitTest
+		{
+		public:
+			ProjectileStore_UnitTest()
+			{
+				testNamespace = "ProjectileStore:";
+			}
+		protected:
+			/** tags a projectile through a few arrays so a swap that misses one is caught */
+			static void writeTag(ProjectileStore& store, size_t denseIdx, int tag)
+			{
+				store.positions[denseIdx] = vec3(float(tag));
+				store.speeds[denseIdx] = float(tag);
+				store.damages[denseIdx] = tag;
+				store.teams[denseIdx] = size_t(tag);
+				store.collisionXforms[denseIdx] = glm::mat4(float(tag));
+			}
+
+			static bool hasTag(const ProjectileStore& store, size_t denseIdx, int tag)
+			{
+				return store.positions[denseIdx] == vec3(float(tag))
+					&& store.speeds[denseIdx] == float(tag)
+					&& store.damages[denseIdx] == tag
+					&& store.teams[denseIdx] == size_t(tag)
+					&& store.collisionXforms[denseIdx] == glm::mat4(float(tag));
+			}
+
+			/** attachments are only compared by identity here, so a non-owning fake pointer stands in for a real light */
+			static sp<PointLight_Deferred> makeFakeLight(int tag)
+			{
+				return sp<PointLight_Deferred>(reinterpret_cast<PointLight_Deferred*>(size_t(tag + 1) * 16), [](PointLight_Deferred*) {});
+			}
+
+			/** every array holds one entry per projectile */
+			static bool arraysAgree(const ProjectileStore& store)
+			{
+				const size_t num = store.size();
+				return store.directions_n.size() == num && store.speeds.size() == num && store.lifetimeSecs.size() == num
+					&& store.timesAlive.size() == num && store.flags.size() == num && store.directionQuats.size() == num
+					&& store.aabbSizes.size() == num && store.traceStartPositions.size() == num && store.offsetStartPositions.size() == num
+					&& store.offsetTraceCorrectionDistances.size() == num && store.damages.size() == num && store.teams.size() == num
+					&& store.ownerIds.size() == num && store.colors.size() == num && store.modelIds.size() == num
+					&& store.collisionXforms.size() == num && store.renderXforms.size() == num && store.handleSlots.size() == num;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_Spawn : public ProjectileStore_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Spawning appends zeroed projectiles with valid handles";
+
+				ProjectileStore store;
+				std::vector<ProjectileHandle> handles;
+				for (int tag = 0; tag < 10; ++tag)
+				{
+					const size_t denseIdx = store.add();
+					if (denseIdx != size_t(tag) || store.speeds[denseIdx] != 0.f || store.flags[denseIdx] != 0
+						|| store.ownerIds[denseIdx] != ProjectileOwnerTable::NO_OWNER || store.getAttachments(denseIdx).soundEmitter)
+					{
+						errorMessage = "new projectile was not appended with default data";
+						return false;
+					}
+					writeTag(store, denseIdx, tag);
+					handles.push_back(store.getHandle(denseIdx));
+				}
+
+				if (store.size() != 10 || !arraysAgree(store))
+				{
+					errorMessage = "arrays disagree on the projectile count";
+					return false;
+				}
+				for (int tag = 0; tag < 10; ++tag)
+				{
+					if (!store.isValid(handles[tag]) || store.getDenseIndex(handles[tag]) != size_t(tag) || !hasTag(store, size_t(tag), tag))
+					{
+						errorMessage = "handle does not find its projectile";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_Expiry : public ProjectileStore_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Expired projectiles are removed and their handles go stale";
+
+				ProjectileStore store;
+				std::vector<ProjectileHandle> handles;
+				for (int tag = 0; tag < 20; ++tag)
+				{
+					const size_t denseIdx = store.add();
+					writeTag(store, denseIdx, tag);
+					store.lifetimeSecs[denseIdx] = 1.f;
+					store.timesAlive[denseIdx] = (tag % 3 == 0) ? 2.f : 0.5f; //every third projectile has outlived its lifetime
+					handles.push_back(store.getHandle(denseIdx));
+				}
+
+				//same walk as the projectile system; removal swaps the last projectile into the current index
+				size_t denseIdx = 0;
+				while (denseIdx < store.size())
+				{
+					if (store.timesAlive[denseIdx] > store.lifetimeSecs[denseIdx])
+					{
+						store.removeAt(denseIdx);
+					}
+					else
+					{
+						++denseIdx;
+					}
+				}
+
+				if (store.size() != 13 || !arraysAgree(store))
+				{
+					errorMessage = "wrong number of projectiles left after expiry";
+					return false;
+				}
+				for (int tag = 0; tag < 20; ++tag)
+				{
+					const bool bExpired = tag % 3 == 0;
+					if (store.isValid(handles[tag]) == bExpired)
+					{
+						errorMessage = bExpired ? "expired projectile's handle is still valid" : "live projectile's handle went stale";
+						return false;
+					}
+					if (!bExpired && !hasTag(store, store.getDenseIndex(handles[tag]), tag))
+					{
+						errorMessage = "live projectile's data was lost during expiry";
+						return false;
+					}
+				}
+
+				//recycled slots must not revive old handles
+				for (int tag = 100; tag < 110; ++tag)
+				{
+					writeTag(store, store.add(), tag);
+				}
+				for (int tag = 0; tag < 20; tag += 3)
+				{
+					if (store.isValid(handles[tag]))
+					{
+						errorMessage = "stale handle aliased a recycled slot";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_SwapRemoveIndexStability : public ProjectileStore_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Handles and attachments follow projectiles through random swap removals";
+
+				std::mt19937 rng(5);
+				ProjectileStore store;
+				std::vector<ProjectileHandle> liveHandles;
+				std::vector<int> liveTags;
+				std::vector<ProjectileHandle> deadHandles;
+				int nextTag = 0;
+
+				for (int step = 0; step < 5000; ++step)
+				{
+					if (liveHandles.empty() || rng() % 3 != 0)
+					{
+						const size_t denseIdx = store.add();
+						writeTag(store, denseIdx, nextTag);
+						store.getAttachments(denseIdx).pointLight = makeFakeLight(nextTag);
+						liveHandles.push_back(store.getHandle(denseIdx));
+						liveTags.push_back(nextTag++);
+					}
+					else
+					{
+						const size_t pick = rng() % liveHandles.size();
+						store.removeAt(store.getDenseIndex(liveHandles[pick]));
+						deadHandles.push_back(liveHandles[pick]);
+						liveHandles[pick] = liveHandles.back();
+						liveHandles.pop_back();
+						liveTags[pick] = liveTags.back();
+						liveTags.pop_back();
+					}
+				}
+
+				if (store.size() != liveHandles.size() || !arraysAgree(store))
+				{
+					errorMessage = "arrays disagree on the projectile count";
+					return false;
+				}
+				for (size_t liveIdx = 0; liveIdx < liveHandles.size(); ++liveIdx)
+				{
+					const int tag = liveTags[liveIdx];
+					if (!store.isValid(liveHandles[liveIdx]))
+					{
+						errorMessage = "live projectile's handle went stale";
+						return false;
+					}
+					const size_t denseIdx = store.getDenseIndex(liveHandles[liveIdx]);
+					if (!hasTag(store, denseIdx, tag) || store.getAttachments(denseIdx).pointLight != makeFakeLight(tag))
+					{
+						errorMessage = "swap removal separated a projectile from its data or attachments";
+						return false;
+					}
+					if (store.getHandle(denseIdx).slot != liveHandles[liveIdx].slot)
+					{
+						errorMessage = "dense index and handle slot disagree";
+						return false;
+					}
+				}
+				for (const ProjectileHandle& deadHandle : deadHandles)
+				{
+					if (store.isValid(deadHandle))
+					{
+						errorMessage = "removed projectile's handle is still valid";
+						return false;
+					}
+				}
+
+				store.clear();
+				for (const ProjectileHandle& liveHandle : liveHandles)
+				{
+					if (store.isValid(liveHandle))
+					{
+						errorMessage = "clear left a handle valid";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_LargeBattle : public ProjectileStore_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Spawn, tick and expire with 20k+ projectiles in flight";
+
+				const size_t numProjectiles = 24000;
+				const int frames = 60;
+				const float dt_sec = 1.f / 60.f;
+				std::mt19937 rng(9);
+				std::uniform_real_distribution<float> lifetimeDist(0.5f, 2.f);
+
+				ProjectileStore store;
+				store.reserve(numProjectiles);
+				const vec3* reservedPositions = nullptr;
+
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point start = Clock::now();
+				size_t numExpired = 0;
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					//top the battle back up to the target before ticking
+					while (store.size() < numProjectiles)
+					{
+						const size_t denseIdx = store.add();
+						store.directions_n[denseIdx] = vec3(0.f, 0.f, -1.f);
+						store.speeds[denseIdx] = 100.f;
+						store.lifetimeSecs[denseIdx] = lifetimeDist(rng);
+					}
+					if (!reservedPositions)
+					{
+						reservedPositions = store.positions.data();
+					}
+
+					for (size_t denseIdx = 0; denseIdx < store.size(); ++denseIdx)
+					{
+						store.positions[denseIdx] += store.directions_n[denseIdx] * store.speeds[denseIdx] * dt_sec;
+						store.timesAlive[denseIdx] += dt_sec;
+					}
+
+					size_t denseIdx = 0;
+					while (denseIdx < store.size())
+					{
+						if (store.timesAlive[denseIdx] > store.lifetimeSecs[denseIdx])
+						{
+							store.removeAt(denseIdx);
+							++numExpired;
+						}
+						else
+						{
+							++denseIdx;
+						}
+					}
+				}
+				const double frameMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+				std::cout << "\t\t" << numProjectiles << " projectiles | " << frameMs << "ms/frame spawn+tick+expire | " << numExpired << " expired over " << frames << " frames" << std::endl;
+
+				if (store.positions.data() != reservedPositions)
+				{
+					errorMessage = "store reallocated although it was reserved for the battle size";
+					return false;
+				}
+				if (numExpired == 0 || !arraysAgree(store))
+				{
+					errorMessage = "projectiles did not expire or arrays disagree";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class ProjectileStoreTestSuite : public SA::TestSuite
+		{
+		public:
+			ProjectileStoreTestSuite()
+			{
+				testName = "PROJECTILE STORE TEST SUITE";
+
+				addTest(new_sp<Test_Spawn>());
+				addTest(new_sp<Test_Expiry>());
+				addTest(new_sp<Test_SwapRemoveIndexStability>());
+				addTest(new_sp<Benchmark_LargeBattle>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getProjectileStoreTestSuite()
+	{
+		return new_sp<SA::ProjectileStoreTests::ProjectileStoreTestSuite>();
+	}
+}
@@ -0,0 +1,339 @@
+#include "EngineTestSuite.h"
+#include "Rendering/RenderData.h"
+#include "GameFramework/RenderModelEntity.h"
+#include "GameFramework/EngineParticles/ParticleInstanceData.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace SA
+{
+	namespace RenderFrameTests
+	{
+		using glm::vec3; using glm::vec4; using glm::mat4;
+
+		class RenderFrame_UnitTest : public SA::UnitTest
+		{
+		public:
+			RenderFrame_UnitTest()
+			{
+				testNamespace = "RenderFrame:";
+			}
+		protected:
+			static constexpr uint32_t numDirLights = 4;
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// ring delay
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_RingDelay : public RenderFrame_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Render reads the frame that is delay frames old";
+
+				for (uint8_t delay = 0; delay <= RenderFrameRing::MAX_DELAY_FRAMES; ++delay)
+				{
+					RenderFrameRing ring(numDirLights);
+					ring.setDelayFrames(delay);
+
+					for (uint64_t frame = 0; frame < 10; ++frame)
+					{
+						//reads made while simulating, before this frame is cached, see the previous cached frame
+						if (frame > 0 && ring.read(frame).dt_sec != float(frame - 1 - std::min<uint64_t>(delay, frame - 1)))
+						{
+							errorMessage = "read before caching frame " + std::to_string(frame) + " did not use the newest cached frame";
+							return false;
+						}
+
+						ring.beginWrite(frame).dt_sec = float(frame);
+
+						//early frames have nothing old enough, so render the oldest cached frame
+						const float expectedFrame = float(frame - std::min<uint64_t>(delay, frame));
+						if (ring.read(frame).dt_sec != expectedFrame)
+						{
+							errorMessage = "delay " + std::to_string(delay) + " on frame " + std::to_string(frame) + " read frame "
+								+ std::to_string(ring.read(frame).dt_sec) + " expected " + std::to_string(expectedFrame);
+							return false;
+						}
+					}
+				}
+
+				RenderFrameRing ring(numDirLights);
+				ring.setDelayFrames(RenderFrameRing::MAX_DELAY_FRAMES + 5);
+				if (ring.getDelayFrames() != RenderFrameRing::MAX_DELAY_FRAMES)
+				{
+					errorMessage = "delay was not clamped";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// render only sees snapshots
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_SnapshotIsolatedFromLiveState : public RenderFrame_UnitTest
+		{
+			/** live simulation state for a frame; every value encodes the frame it was simulated on */
+			static void simulateFrame(uint64_t frame, EffectInstanceData& liveParticles, RenderModelEntity& liveEntity)
+			{
+				//instance count changes each frame so buffers both grow and shrink
+				const size_t numInstances = 1 + frame % 4;
+				liveParticles.numInstancesThisFrame = numInstances;
+				liveParticles.mat4Data.resize(std::max(liveParticles.mat4Data.size(), numInstances * liveParticles.numMat4PerInstance));
+				liveParticles.vec4Data.resize(std::max(liveParticles.vec4Data.size(), numInstances * liveParticles.numVec4PerInstance));
+				for (size_t idx = 0; idx < numInstances; ++idx)
+				{
+					liveParticles.mat4Data[idx] = glm::translate(mat4(1.f), vec3(float(frame)));
+					liveParticles.vec4Data[idx] = vec4(float(frame));
+				}
+
+				Transform xform;
+				xform.position = vec3(float(frame));
+				liveEntity.setTransform(xform);
+			}
+
+			static void cacheFrame(RenderData& frameData, const EffectInstanceData& liveParticles, const RenderModelEntity& liveEntity)
+			{
+				frameData.particleBatches.resize(1);
+				frameData.particleBatches[0].copyFrom(liveParticles);
+				frameData.addEntity(liveEntity);
+			}
+
+			/** what a renderer would draw; returns false if anything did not come from expectedFrame */
+			bool renderMatchesFrame(const RenderData& frameData, uint64_t expectedFrame)
+			{
+				const float expected = float(expectedFrame);
+				const RenderData::ParticleBatchSnapshot& batch = frameData.particleBatches[0];
+				if (batch.numInstances != 1 + expectedFrame % 4 || batch.mat4Data.size() != batch.numInstances)
+				{
+					errorMessage = "particle instance count is not from frame " + std::to_string(expectedFrame);
+					return false;
+				}
+				for (size_t idx = 0; idx < batch.numInstances; ++idx)
+				{
+					if (batch.mat4Data[idx][3] != vec4(vec3(expected), 1.f) || batch.vec4Data[idx] != vec4(expected))
+					{
+						errorMessage = "particle instance data is not from frame " + std::to_string(expectedFrame);
+						return false;
+					}
+				}
+				if (frameData.entities.size() != 1 || frameData.entities[0].modelMatrix[3] != vec4(vec3(expected), 1.f))
+				{
+					errorMessage = "entity transform is not from frame " + std::to_string(expectedFrame);
+					return false;
+				}
+				return true;
+			}
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Render data is a copy that later simulation does not change";
+
+				for (uint8_t delay = 0; delay <= RenderFrameRing::MAX_DELAY_FRAMES; ++delay)
+				{
+					RenderFrameRing ring(numDirLights);
+					ring.setDelayFrames(delay);
+
+					EffectInstanceData liveParticles;
+					sp<RenderModelEntity> liveEntity = new_sp<RenderModelEntity>(nullptr);
+
+					for (uint64_t frame = 0; frame < 12; ++frame)
+					{
+						simulateFrame(frame, liveParticles, *liveEntity);
+						cacheFrame(ring.beginWrite(frame), liveParticles, *liveEntity);
+
+						//the next frame's simulation runs before (or while) this frame is drawn
+						simulateFrame(frame + 1, liveParticles, *liveEntity);
+
+						const uint64_t renderedFrame = frame - std::min<uint64_t>(delay, frame);
+						if (!renderMatchesFrame(ring.read(frame), renderedFrame))
+						{
+							errorMessage += " (delay " + std::to_string(delay) + ", frame " + std::to_string(frame) + ")";
+							return false;
+						}
+					}
+
+					//live state going away entirely must not affect what render holds
+					liveParticles = EffectInstanceData{};
+					if (!renderMatchesFrame(ring.read(11), 11 - delay))
+					{
+						errorMessage += " after live data was released";
+						return false;
+					}
+
+					//snapshots must not keep destroyed entities alive while they wait in older ring slots
+					wp<RenderModelEntity> releasedEntity = liveEntity;
+					liveEntity = nullptr;
+					if (!releasedEntity.expired())
+					{
+						errorMessage = "a frame snapshot kept a released entity alive (delay " + std::to_string(delay) + ")";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_RenderNeverTouchesLiveEntities : public RenderFrame_UnitTest
+		{
+			/** Stands in for a ship: a tinted hull plus a placement. Counts every time anything reads it for drawing. */
+			class TrackedEntity : public RenderModelEntity
+			{
+			public:
+				TrackedEntity(uint64_t inFrame, size_t& inNumReads)
+					: RenderModelEntity(nullptr), frame(inFrame), numReads(inNumReads)
+				{}
+				virtual void cacheDraws(RenderData& frameData, const mat4& modelMatrix) const override
+				{
+					++numReads;
+					frameData.modelDraws.push_back(RenderData::ModelDraw{ nullptr, modelMatrix, vec3(float(frame)) });
+					frameData.modelDraws.push_back(RenderData::ModelDraw{ nullptr, glm::translate(modelMatrix, vec3(0.f, 1.f, 0.f)), std::nullopt });
+				}
+			private:
+				uint64_t frame;
+				size_t& numReads;
+			};
+
+			static constexpr size_t numEntities = 3;
+
+			/** the previous frame's entities are destroyed and replaced, like ships dying and respawning mid battle */
+			static void simulateFrame(uint64_t frame, std::vector<sp<TrackedEntity>>& liveEntities, size_t& numReads)
+			{
+				liveEntities.clear();
+				for (size_t entityIdx = 0; entityIdx < numEntities; ++entityIdx)
+				{
+					Transform xform;
+					xform.position = vec3(float(frame), float(entityIdx), 0.f);
+					liveEntities.push_back(new_sp<TrackedEntity>(frame, numReads));
+					liveEntities.back()->setTransform(xform);
+				}
+			}
+
+			static void cacheFrame(uint64_t frame, RenderData& frameData, const std::vector<sp<TrackedEntity>>& liveEntities)
+			{
+				for (const sp<TrackedEntity>& entity : liveEntities)
+				{
+					const mat4 modelMatrix = entity->getTransform().getModelMatrix();
+					frameData.addEntity(*entity, modelMatrix);
+					frameData.highlights.push_back(RenderData::HighlightSnapshot{ frameData.snapshotEntity(*entity, modelMatrix), frame % 2 == 0 });
+				}
+				frameData.playerEntities.push_back(frameData.snapshotEntity(*liveEntities[0], liveEntities[0]->getTransform().getModelMatrix()));
+			}
+
+			/** walks the draws the way the level render does; returns false if any draw is not from expectedFrame */
+			bool drawSnapshot(const RenderData& frameData, const RenderData::EntitySnapshot& snapshot, size_t entityIdx, uint64_t expectedFrame)
+			{
+				const vec4 expectedPosition = vec4(float(expectedFrame), float(entityIdx), 0.f, 1.f);
+				if (snapshot.numDraws != 2 || snapshot.modelMatrix[3] != expectedPosition
+					|| snapshot.firstDraw + snapshot.numDraws > frameData.modelDraws.size())
+				{
+					errorMessage = "entity snapshot is not from frame " + std::to_string(expectedFrame);
+					return false;
+				}
+				const RenderData::ModelDraw& hull = frameData.modelDraws[snapshot.firstDraw];
+				const RenderData::ModelDraw& placement = frameData.modelDraws[snapshot.firstDraw + 1];
+				if (hull.modelMatrix[3] != expectedPosition || !hull.tint || *hull.tint != vec3(float(expectedFrame))
+					|| placement.modelMatrix[3] != expectedPosition + vec4(0.f, 1.f, 0.f, 0.f) || placement.tint)
+				{
+					errorMessage = "draws are not from frame " + std::to_string(expectedFrame);
+					return false;
+				}
+				return true;
+			}
+
+			bool renderFrame(const RenderData& frameData, uint64_t expectedFrame)
+			{
+				if (frameData.entities.size() != numEntities || frameData.highlights.size() != numEntities || frameData.playerEntities.size() != 1)
+				{
+					errorMessage = "snapshot counts are not from a single frame";
+					return false;
+				}
+				for (size_t entityIdx = 0; entityIdx < numEntities; ++entityIdx)
+				{
+					const RenderData::HighlightSnapshot& highlight = frameData.highlights[entityIdx];
+					if (!drawSnapshot(frameData, frameData.entities[entityIdx], entityIdx, expectedFrame)
+						|| !drawSnapshot(frameData, highlight.entity, entityIdx, expectedFrame))
+					{
+						return false;
+					}
+					if (highlight.bFriendly != (expectedFrame % 2 == 0))
+					{
+						errorMessage = "highlight color is not from frame " + std::to_string(expectedFrame);
+						return false;
+					}
+				}
+				return drawSnapshot(frameData, frameData.playerEntities[0], 0, expectedFrame);
+			}
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Render draws entities the simulation has since destroyed without reading them";
+
+				for (uint8_t delay = 0; delay <= RenderFrameRing::MAX_DELAY_FRAMES; ++delay)
+				{
+					RenderFrameRing ring(numDirLights);
+					ring.setDelayFrames(delay);
+
+					size_t numReads = 0;
+					std::vector<sp<TrackedEntity>> liveEntities;
+					std::vector<std::vector<wp<TrackedEntity>>> cachedEntities; //indexed by frame
+
+					for (uint64_t frame = 0; frame < 12; ++frame)
+					{
+						simulateFrame(frame, liveEntities, numReads);
+						cacheFrame(frame, ring.beginWrite(frame), liveEntities);
+						cachedEntities.emplace_back(liveEntities.begin(), liveEntities.end());
+
+						//the next frame simulates while this frame is drawn, destroying every entity it was cached from
+						simulateFrame(frame + 1, liveEntities, numReads);
+
+						const uint64_t renderedFrame = frame - std::min<uint64_t>(delay, frame);
+						for (const wp<TrackedEntity>& entity : cachedEntities[renderedFrame])
+						{
+							if (!entity.expired())
+							{
+								errorMessage = "a frame snapshot kept a destroyed entity alive (delay " + std::to_string(delay) + ")";
+								return false;
+							}
+						}
+
+						const size_t numReadsBeforeRender = numReads;
+						if (!renderFrame(ring.read(frame), renderedFrame))
+						{
+							errorMessage += " (delay " + std::to_string(delay) + ", frame " + std::to_string(frame) + ")";
+							return false;
+						}
+						if (numReads != numReadsBeforeRender)
+						{
+							errorMessage = "render read a live entity (delay " + std::to_string(delay) + ", frame " + std::to_string(frame) + ")";
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class RenderFrameTestSuite : public SA::TestSuite
+		{
+		public:
+			RenderFrameTestSuite()
+			{
+				testName = "RENDER FRAME TEST SUITE";
+
+				addTest(new_sp<Test_RingDelay>());
+				addTest(new_sp<Test_SnapshotIsolatedFromLiveState>());
+				addTest(new_sp<Test_RenderNeverTouchesLiveEntities>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getRenderFrameTestSuite()
+	{
+		return new_sp<SA::RenderFrameTests::RenderFrameTestSuite>();
+	}
+}
@@ -0,0 +1,414 @@
+#include "EngineTestSuite.h"
+#include "SATTestShapes.h"
+
+#include <chrono>
+#include <random>
+
+#include <glm/gtx/norm.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace SA
+{
+	namespace SATKernelTests
+	{
+		using glm::vec3; using glm::vec4; using glm::mat4;
+		using namespace SATTestShapes;
+
+		class SATKernel_UnitTest : public SA::UnitTest
+		{
+		public:
+			SATKernel_UnitTest()
+			{
+				testNamespace = "SATKernel:";
+			}
+
+		protected:
+			/** The collision test before the specialized kernels: gather every axis into a fresh vector, then project every point */
+			static bool referenceCollisionTest(const SAT::Shape& moving, const SAT::Shape& stationary, vec4& outMTV, std::vector<vec3>* outCandidateMTVs = nullptr)
+			{
+				auto projectPoints = [](const SAT::Shape& shape, const vec3& axis)
+				{
+					SAT::ProjectionRange range;
+					for (const vec4& pnt : shape.getTransformedPoints())
+					{
+						float projection = glm::dot(vec3(pnt), axis);
+						range.max = range.max > projection ? range.max : projection;
+						range.min = range.min < projection ? range.min : projection;
+					}
+					return range;
+				};
+
+				//axes are rebuilt from the debug indices, as they were on every call before axes were cached per transform
+				auto appendFaceAxes = [](const SAT::Shape& shape, std::vector<vec3>& outAxes)
+				{
+					const std::vector<vec4>& pnts = shape.getTransformedPoints();
+					for (const SAT::Shape::FacePointIndices& face : shape.getDebugFaceIdxs())
+					{
+						vec3 e1 = pnts[face.edge1.indexA] - pnts[face.edge1.indexB];
+						vec3 e2 = pnts[face.edge2.indexA] - pnts[face.edge2.indexB];
+						outAxes.push_back(glm::normalize(glm::cross(e1, e2)));
+					}
+				};
+
+				std::vector<vec3> normalizedAxes;
+				appendFaceAxes(moving, normalizedAxes);
+				appendFaceAxes(stationary, normalizedAxes);
+				for (const SAT::Shape::EdgePointIndices& movEdgeIdx : moving.getDebugEdgeIdxs())
+				{
+					for (const SAT::Shape::EdgePointIndices& statEdgeIdx : stationary.getDebugEdgeIdxs())
+					{
+						vec3 movEdge = moving.getTransformedPoints()[movEdgeIdx.indexA] - moving.getTransformedPoints()[movEdgeIdx.indexB];
+						vec3 statEdge = stationary.getTransformedPoints()[statEdgeIdx.indexA] - stationary.getTransformedPoints()[statEdgeIdx.indexB];
+						vec3 axis = glm::normalize(glm::cross(movEdge, statEdge));
+						if (!glm::isnan(axis.x) && !glm::isnan(axis.y) && !glm::isnan(axis.z))
+						{
+							normalizedAxes.push_back(axis);
+						}
+					}
+				}
+
+				vec3 mtv(0.f);
+				for (const vec3& axis : normalizedAxes)
+				{
+					SAT::ProjectionRange movProj = projectPoints(moving, axis);
+					SAT::ProjectionRange staProj = projectPoints(stationary, axis);
+					if (movProj.max < staProj.min || staProj.max < movProj.min)
+					{
+						outMTV = vec4(0.f);
+						return false;
+					}
+					vec3 candidateMTV = SAT::Shape::calculateMinimumTranslationVec(axis, movProj, staProj);
+					if (outCandidateMTVs)
+					{
+						outCandidateMTVs->push_back(candidateMTV * SAT::Shape::floatMTVCorrectionFactor);
+					}
+					if (glm::length2(candidateMTV) < glm::length2(mtv) || glm::length2(mtv) == 0.f)
+					{
+						mtv = candidateMTV;
+					}
+				}
+				outMTV = vec4(mtv, 0.f) * SAT::Shape::floatMTVCorrectionFactor;
+				return true;
+			}
+
+			/** Runs random placements of a shape pair through both tests; projections round differently, so near ties and grazing contacts get a tolerance */
+			bool matchesReference(EKind movingKind, EKind stationaryKind, unsigned int seed, int iterations)
+			{
+				const float tolerance = 1e-3f;
+				std::mt19937 rng(seed);
+				sp<SAT::Shape> moving = makeShape(movingKind);
+				sp<SAT::Shape> stationary = makeShape(stationaryKind);
+
+				int numCollisions = 0;
+				int numSeparated = 0;
+				for (int iteration = 0; iteration < iterations; ++iteration)
+				{
+					moving->updateTransform(makeRandomTransform(rng, 1.5f));
+					stationary->updateTransform(makeRandomTransform(rng, 1.5f));
+
+					vec4 kernelMTV, referenceMTV;
+					std::vector<vec3> candidateMTVs;
+					bool bKernelHit = SAT::Shape::CollisionTest(*moving, *stationary, kernelMTV);
+					bool bReferenceHit = referenceCollisionTest(*moving, *stationary, referenceMTV, &candidateMTVs);
+
+					if (bKernelHit != bReferenceHit)
+					{
+						if (glm::length(referenceMTV) > tolerance && glm::length(kernelMTV) > tolerance)
+						{
+							errorMessage = "collision result differs from reference on iteration " + std::to_string(iteration);
+							return false;
+						}
+						continue;
+					}
+					if (!bKernelHit)
+					{
+						++numSeparated;
+						continue;
+					}
+					++numCollisions;
+
+					const float referenceLength = glm::length(referenceMTV);
+					if (glm::abs(glm::length(kernelMTV) - referenceLength) > tolerance)
+					{
+						errorMessage = "mtv length differs from reference on iteration " + std::to_string(iteration);
+						return false;
+					}
+
+					//the kernel must pick the reference's mtv, or another axis whose overlap is tied with it
+					bool bFoundMatch = false;
+					for (const vec3& candidate : candidateMTVs)
+					{
+						if (glm::abs(glm::length(candidate) - referenceLength) <= tolerance && glm::length(candidate - vec3(kernelMTV)) <= tolerance)
+						{
+							bFoundMatch = true;
+							break;
+						}
+					}
+					if (!bFoundMatch)
+					{
+						errorMessage = "mtv direction differs from reference on iteration " + std::to_string(iteration);
+						return false;
+					}
+				}
+
+				if (numCollisions == 0 || numSeparated == 0)
+				{
+					errorMessage = "random placements did not exercise both hits and misses";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_BoxBoxMatchesReference : public SATKernel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Cube vs cube closed form kernel matches the reference MTV";
+				return matchesReference(EKind::CUBE, EKind::CUBE, 11, 5000);
+			}
+		};
+
+		class Test_ConvexMatchesReference : public SATKernel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Capsule and mesh kernels match the reference MTV";
+
+				const std::pair<EKind, EKind> pairs[] = {
+					{ EKind::CAPSULE, EKind::CAPSULE },
+					{ EKind::OCTAHEDRON, EKind::CAPSULE },
+					{ EKind::OCTAHEDRON, EKind::OCTAHEDRON },
+					{ EKind::CUBE, EKind::OCTAHEDRON },
+					{ EKind::CAPSULE, EKind::CUBE },
+				};
+				unsigned int seed = 21;
+				for (const std::pair<EKind, EKind>& pair : pairs)
+				{
+					if (!matchesReference(pair.first, pair.second, seed++, 2000))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_KnownBoxOverlap : public SATKernel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Cube overlapping another along x is pushed back along x";
+
+				SAT::CubeShape moving, stationary;
+				stationary.updateTransform(mat4(1.f));
+				moving.updateTransform(glm::translate(mat4(1.f), vec3(0.75f, 0.1f, 0.f)));
+
+				vec4 mtv;
+				if (!SAT::Shape::CollisionTest(moving, stationary, mtv))
+				{
+					errorMessage = "overlapping cubes did not collide";
+					return false;
+				}
+				const vec3 expected = vec3(0.25f, 0.f, 0.f) * SAT::Shape::floatMTVCorrectionFactor;
+				if (glm::length(vec3(mtv) - expected) > 1e-4f)
+				{
+					errorMessage = "unexpected mtv";
+					return false;
+				}
+
+				moving.updateTransform(glm::translate(mat4(1.f), vec3(1.25f, 0.f, 0.f)));
+				if (SAT::Shape::CollisionTest(moving, stationary, mtv) || mtv != vec4(0.f))
+				{
+					errorMessage = "separated cubes collided";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_AlignedHullsDropDuplicateAxes : public SATKernel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Hulls sharing a rotation, where every edge x edge axis repeats a face axis, keep the reference MTV";
+
+				std::mt19937 rng(17);
+				std::uniform_real_distribution<float> rotDist(0.f, 360.f);
+				sp<SAT::Shape> moving = makeShape(EKind::BOX_HULL);
+				sp<SAT::Shape> stationary = makeShape(EKind::BOX_HULL);
+				sp<SAT::Shape> stationaryCube = makeShape(EKind::CUBE);
+
+				for (int iteration = 0; iteration < 200; ++iteration)
+				{
+					const glm::quat rotation = SAT::convertVecOfRotationsToQuat(vec3(rotDist(rng), rotDist(rng), rotDist(rng)));
+					const mat4 rotationMat = glm::toMat4(rotation);
+					const mat4 hullToUnitCube = glm::scale(mat4(1.f), vec3(0.5f, 2.f, 1.f)); //BOX_HULL is 2 x 0.5 x 1
+					stationary->updateTransform(rotationMat * hullToUnitCube);
+					stationaryCube->updateTransform(rotationMat);
+					moving->updateTransform(rotationMat * glm::translate(mat4(1.f), vec3(0.75f, 0.1f, 0.f)) * hullToUnitCube);
+
+					//overlap is 0.25 along the shared local x axis
+					const vec3 expected = rotation * vec3(0.25f, 0.f, 0.f) * SAT::Shape::floatMTVCorrectionFactor;
+					for (const sp<SAT::Shape>& other : { stationary, stationaryCube })
+					{
+						vec4 kernelMTV, referenceMTV;
+						if (!SAT::Shape::CollisionTest(*moving, *other, kernelMTV) || !referenceCollisionTest(*moving, *other, referenceMTV))
+						{
+							errorMessage = "aligned overlapping hulls did not collide on iteration " + std::to_string(iteration);
+							return false;
+						}
+						if (glm::length(vec3(kernelMTV) - expected) > 1e-3f || glm::length(vec3(referenceMTV) - expected) > 1e-3f)
+						{
+							errorMessage = "aligned hulls gave an unexpected mtv on iteration " + std::to_string(iteration);
+							return false;
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_MeshCornersShared : public SATKernel_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Triangle mesh corners are stored once, even with float noise between copies";
+
+				if (makeShape(EKind::BOX_HULL)->getLocalPoints().size() != 8 || makeShape(EKind::OCTAHEDRON)->getLocalPoints().size() != 6)
+				{
+					errorMessage = "shared corners were stored more than once";
+					return false;
+				}
+
+				using Tri = SAT::DynamicTriangleMeshShape::TriangleProcessor::TriangleCCW;
+				const vec4 noise(1e-7f, -1e-7f, 0.f, 0.f);
+				std::vector<Tri> triangles = {
+					Tri{ vec4(0, 0, 0, 1), vec4(1, 0, 0, 1), vec4(0, 1, 0, 1) },
+					Tri{ vec4(1, 0, 0, 1) + noise, vec4(1, 1, 0, 1), vec4(0, 1, 0, 1) - noise }
+				};
+				SAT::DynamicTriangleMeshShape::TriangleProcessor processor(triangles, 0.001f);
+				if (processor.getPoints().size() != 4)
+				{
+					errorMessage = "corners a float rounding apart were not merged";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_CollisionTests : public SATKernel_UnitTest
+		{
+			struct PairTiming
+			{
+				double kernelMs = 0.0;
+				double referenceMs = 0.0;
+			};
+
+			static PairTiming timePair(EKind movingKind, EKind stationaryKind, size_t numPlacements, int repeats)
+			{
+				using Clock = std::chrono::high_resolution_clock;
+
+				std::mt19937 rng(3);
+				std::vector<mat4> placements;
+				for (size_t idx = 0; idx < numPlacements * 2; ++idx)
+				{
+					placements.push_back(makeRandomTransform(rng, 1.5f));
+				}
+				//transforms are updated outside the timed loops; ships update them once per tick regardless of how many tests follow
+				std::vector<sp<SAT::Shape>> movingShapes, stationaryShapes;
+				for (size_t idx = 0; idx < numPlacements; ++idx)
+				{
+					movingShapes.push_back(makeShape(movingKind));
+					movingShapes.back()->updateTransform(placements[idx * 2]);
+					stationaryShapes.push_back(makeShape(stationaryKind));
+					stationaryShapes.back()->updateTransform(placements[idx * 2 + 1]);
+				}
+
+				PairTiming timing;
+				size_t kernelHits = 0, referenceHits = 0;
+				vec4 mtv;
+
+				Clock::time_point start = Clock::now();
+				for (int repeat = 0; repeat < repeats; ++repeat)
+				{
+					for (size_t idx = 0; idx < numPlacements; ++idx)
+					{
+						kernelHits += size_t(SAT::Shape::CollisionTest(*movingShapes[idx], *stationaryShapes[idx], mtv));
+					}
+				}
+				timing.kernelMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+
+				start = Clock::now();
+				for (int repeat = 0; repeat < repeats; ++repeat)
+				{
+					for (size_t idx = 0; idx < numPlacements; ++idx)
+					{
+						referenceHits += size_t(referenceCollisionTest(*movingShapes[idx], *stationaryShapes[idx], mtv));
+					}
+				}
+				timing.referenceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repeats;
+
+				if (kernelHits == 0)
+				{
+					timing.kernelMs = -1.0; //flag degenerate data to the caller
+				}
+				return timing;
+			}
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "SAT collision test throughput";
+
+				//few enough shapes to stay in cache, like one ship's shape tested against everything near it in a tick
+				const size_t numPlacements = 64;
+				const int repeats = 1000;
+				const std::pair<EKind, EKind> pairs[] = { { EKind::CUBE, EKind::CUBE }, { EKind::CAPSULE, EKind::CAPSULE }, { EKind::OCTAHEDRON, EKind::CUBE } };
+				const char* names[] = { "cube/cube", "capsule/capsule", "mesh/cube" };
+
+				for (size_t pairIdx = 0; pairIdx < std::size(pairs); ++pairIdx)
+				{
+					PairTiming timing = timePair(pairs[pairIdx].first, pairs[pairIdx].second, numPlacements, repeats);
+					if (timing.kernelMs < 0.0)
+					{
+						errorMessage = "benchmark placements never collided";
+						return false;
+					}
+					std::cout << "\t\t" << names[pairIdx] << " x" << numPlacements << " | kernel " << timing.kernelMs << "ms | previous implementation " << timing.referenceMs << "ms" << std::endl;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class SATKernelTestSuite : public SA::TestSuite
+		{
+		public:
+			SATKernelTestSuite()
+			{
+				testName = "SAT KERNEL TEST SUITE";
+
+				addTest(new_sp<Test_KnownBoxOverlap>());
+				addTest(new_sp<Test_BoxBoxMatchesReference>());
+				addTest(new_sp<Test_ConvexMatchesReference>());
+				addTest(new_sp<Test_AlignedHullsDropDuplicateAxes>());
+				addTest(new_sp<Test_MeshCornersShared>());
+				addTest(new_sp<Benchmark_CollisionTests>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getSATKernelTestSuite()
+	{
+		return new_sp<SA::SATKernelTests::SATKernelTestSuite>();
+	}
+}
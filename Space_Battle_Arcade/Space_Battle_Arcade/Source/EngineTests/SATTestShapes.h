@@ -0,0 +1,77 @@
+#pragma once
+#include "ReferenceCode/OpenGL/Algorithms/SeparatingAxisTheorem/SATComponent.h"
+#include "ReferenceCode/OpenGL/Algorithms/SeparatingAxisTheorem/SATUnitTestUtils.h"
+
+#include <random>
+#include <vector>
+
+namespace SA
+{
+	/** Shapes and random placements shared by the collision kernel tests */
+	namespace SATTestShapes
+	{
+		enum class EKind { CUBE, CAPSULE, BOX_HULL, OCTAHEDRON };
+
+		/** BOX_HULL is a triangulated box, like the carrier's .coll.*.obj parts, so it goes through the DynamicTriangleMeshShape path.
+			OCTAHEDRON has one stretched tip, so its face and edge axes differ from the cube and capsule's. */
+		inline sp<SAT::Shape> makeShape(EKind kind)
+		{
+			using glm::vec3; using glm::vec4;
+			using Tri = SAT::DynamicTriangleMeshShape::TriangleProcessor::TriangleCCW;
+
+			std::vector<Tri> triangles;
+			if (kind == EKind::CUBE)
+			{
+				return new_sp<SAT::CubeShape>();
+			}
+			else if (kind == EKind::CAPSULE)
+			{
+				return new_sp<SAT::PolygonCapsuleShape>();
+			}
+			else if (kind == EKind::BOX_HULL)
+			{
+				const vec3 size(2.f, 0.5f, 1.f);
+				auto corner = [&size](int x, int y, int z) { return vec4(size.x * (x - 0.5f), size.y * (y - 0.5f), size.z * (z - 0.5f), 1.f); };
+				auto quad = [&triangles](const vec4& a, const vec4& b, const vec4& c, const vec4& d)
+				{
+					triangles.push_back(Tri{ a, b, c });
+					triangles.push_back(Tri{ a, c, d });
+				};
+				quad(corner(0, 0, 1), corner(1, 0, 1), corner(1, 1, 1), corner(0, 1, 1));
+				quad(corner(1, 0, 0), corner(0, 0, 0), corner(0, 1, 0), corner(1, 1, 0));
+				quad(corner(1, 0, 1), corner(1, 0, 0), corner(1, 1, 0), corner(1, 1, 1));
+				quad(corner(0, 0, 0), corner(0, 0, 1), corner(0, 1, 1), corner(0, 1, 0));
+				quad(corner(0, 1, 1), corner(1, 1, 1), corner(1, 1, 0), corner(0, 1, 0));
+				quad(corner(0, 0, 0), corner(1, 0, 0), corner(1, 0, 1), corner(0, 0, 1));
+			}
+			else
+			{
+				const vec4 top(0, 1.5f, 0, 1), bottom(0, -1, 0, 1);
+				const vec4 ring[4] = { vec4(1, 0, 0, 1), vec4(0, 0, -1, 1), vec4(-1, 0, 0, 1), vec4(0, 0, 1, 1) };
+				for (int ringIdx = 0; ringIdx < 4; ++ringIdx)
+				{
+					const vec4& a = ring[ringIdx];
+					const vec4& b = ring[(ringIdx + 1) % 4];
+					triangles.push_back(Tri{ a, b, top });
+					triangles.push_back(Tri{ b, a, bottom });
+				}
+			}
+			SAT::DynamicTriangleMeshShape::TriangleProcessor processor(triangles, 0.001f);
+			return new_sp<SAT::DynamicTriangleMeshShape>(processor);
+		}
+
+		/** Positions within spread of the origin on each axis, any rotation, and non uniform scale */
+		inline glm::mat4 makeRandomTransform(std::mt19937& rng, float spread)
+		{
+			std::uniform_real_distribution<float> posDist(-spread, spread);
+			std::uniform_real_distribution<float> rotDist(0.f, 360.f);
+			std::uniform_real_distribution<float> scaleDist(0.5f, 2.f);
+
+			SAT::ColumnBasedTransform transform;
+			transform.position = glm::vec3(posDist(rng), posDist(rng), posDist(rng));
+			transform.rotQuat = SAT::convertVecOfRotationsToQuat(glm::vec3(rotDist(rng), rotDist(rng), rotDist(rng)));
+			transform.scale = glm::vec3(scaleDist(rng), scaleDist(rng), scaleDist(rng));
+			return transform.getModelMatrix();
+		}
+	}
+}
@@ -0,0 +1,397 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/SATeamSpatialQueries.h"
+#include "GameFramework/SAWorldEntity.h"
+#include "GameFramework/Components/GameplayComponents.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include <glm/gtx/norm.hpp>
+
+namespace SA
+{
+	namespace TeamSpatialQueryTests
+	{
+		using glm::vec3;
+		using Hit = TeamSpatialQueries::Hit;
+
+		class TeamSpatialQuery_UnitTest : public SA::UnitTest
+		{
+		public:
+			TeamSpatialQuery_UnitTest()
+			{
+				testNamespace = "TeamSpatialQueries:";
+			}
+
+		protected:
+			struct TestWorld
+			{
+				std::vector<sp<WorldEntity>> entities; //in the order they were added to the queries
+				TeamSpatialQueries queries;
+			};
+
+			static sp<WorldEntity> makeEntity(const vec3& position, size_t team)
+			{
+				Transform xform;
+				xform.position = position;
+				sp<WorldEntity> entity = new_sp<WorldEntity>(xform);
+				entity->createGameComponent<TeamComponent>();
+				entity->getGameComponent<TeamComponent>()->setTeam(team);
+				return entity;
+			}
+
+			static void populate(TestWorld& world, size_t numEntities, size_t numTeams, float extent, uint32_t seed)
+			{
+				std::mt19937 rng(seed);
+				std::uniform_real_distribution<float> posDist(-extent, extent);
+				for (size_t entityIdx = 0; entityIdx < numEntities; ++entityIdx)
+				{
+					world.entities.push_back(makeEntity(vec3(posDist(rng), posDist(rng), posDist(rng)), entityIdx % numTeams));
+					world.queries.addEntity(world.entities.back());
+				}
+				world.queries.refresh();
+			}
+
+			static size_t teamOf(const WorldEntity& entity) { return entity.getGameComponent<TeamComponent>()->getTeam(); }
+
+			/** the answer the queries should give, by checking every entity; ties go to the earlier added entity */
+			static std::vector<Hit> bruteForceNearest(const TestWorld& world, const vec3& position, size_t team, size_t k, float maxDistance, bool bEnemies = true)
+			{
+				std::vector<Hit> hits;
+				for (const sp<WorldEntity>& entity : world.entities)
+				{
+					const float distance2 = glm::distance2(entity->getWorldPosition(), position);
+					if ((teamOf(*entity) != team) == bEnemies && distance2 <= maxDistance * maxDistance)
+					{
+						hits.push_back(Hit{ entity.get(), distance2 });
+					}
+				}
+				std::stable_sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) { return a.distance2 < b.distance2; });
+				hits.resize(std::min(hits.size(), k));
+				return hits;
+			}
+
+			static bool sameHits(const std::vector<Hit>& a, const std::vector<Hit>& b)
+			{
+				return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const Hit& x, const Hit& y) { return x.entity == y.entity; });
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// correctness
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_NearestMatchesBruteForce : public TeamSpatialQuery_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "k nearest enemies and allies match a linear search, for small and huge search radii";
+
+				TestWorld world;
+				populate(world, 2000, 3, 1000.f, 7);
+
+				std::mt19937 rng(11);
+				std::uniform_real_distribution<float> posDist(-1100.f, 1100.f);
+				const float radii[] = { 30.f, 120.f, 400.f, 100000.f };
+				TeamSpatialQueries::QueryScratch scratch;
+				std::vector<Hit> hits;
+				for (int queryIdx = 0; queryIdx < 400; ++queryIdx)
+				{
+					const vec3 position(posDist(rng), posDist(rng), posDist(rng));
+					const size_t team = size_t(queryIdx % 3);
+					const size_t k = size_t(1 + queryIdx % 8);
+					const float maxDistance = radii[queryIdx % std::size(radii)];
+
+					world.queries.kNearestEnemies(position, team, k, maxDistance, scratch, hits);
+					if (!sameHits(hits, bruteForceNearest(world, position, team, k, maxDistance)))
+					{
+						errorMessage = "nearest enemies differ from a linear search";
+						return false;
+					}
+
+					world.queries.kNearestAllies(position, team, k, maxDistance, scratch, hits);
+					if (!sameHits(hits, bruteForceNearest(world, position, team, k, maxDistance, false)))
+					{
+						errorMessage = "nearest allies differ from a linear search";
+						return false;
+					}
+				}
+
+				//batched form returns the same answers
+				std::vector<TeamSpatialQueries::NearestQuery> batch;
+				for (int queryIdx = 0; queryIdx < 50; ++queryIdx)
+				{
+					batch.push_back({ vec3(posDist(rng), posDist(rng), posDist(rng)), size_t(queryIdx % 3), 4, 300.f });
+				}
+				std::vector<Hit> batchHits;
+				std::vector<size_t> offsets;
+				world.queries.kNearestEnemies(batch, scratch, batchHits, offsets);
+				for (size_t queryIdx = 0; queryIdx < batch.size(); ++queryIdx)
+				{
+					std::vector<Hit> queryHits(batchHits.begin() + offsets[queryIdx], batchHits.begin() + offsets[queryIdx + 1]);
+					if (!sameHits(queryHits, bruteForceNearest(world, batch[queryIdx].position, batch[queryIdx].team, 4, 300.f)))
+					{
+						errorMessage = "batched query differs from a single query";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_ConeMatchesBruteForce : public TeamSpatialQuery_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Enemies in cone match a linear search";
+
+				TestWorld world;
+				populate(world, 1500, 2, 600.f, 5);
+
+				std::mt19937 rng(13);
+				std::uniform_real_distribution<float> unitDist(-1.f, 1.f);
+				TeamSpatialQueries::QueryScratch scratch;
+				std::vector<Hit> hits;
+				size_t numHits = 0;
+				for (int queryIdx = 0; queryIdx < 200; ++queryIdx)
+				{
+					const vec3 apex = vec3(unitDist(rng), unitDist(rng), unitDist(rng)) * 500.f;
+					vec3 dir = vec3(unitDist(rng), unitDist(rng), unitDist(rng));
+					if (glm::length2(dir) < 0.01f) { continue; }
+					dir = glm::normalize(dir);
+					const float halfAngle = glm::radians(5.f + float(queryIdx % 60));
+					const size_t team = size_t(queryIdx % 2);
+					const float maxDistance = 100.f + float(queryIdx % 5) * 150.f;
+
+					world.queries.enemiesInCone(apex, dir, halfAngle, team, maxDistance, scratch, hits);
+					numHits += hits.size();
+
+					std::vector<Hit> expected;
+					for (const sp<WorldEntity>& entity : world.entities)
+					{
+						const vec3 toEntity = entity->getWorldPosition() - apex;
+						const float distance2 = glm::length2(toEntity);
+						if (teamOf(*entity) != team && distance2 <= maxDistance * maxDistance
+							&& glm::dot(toEntity, dir) >= glm::cos(halfAngle) * glm::sqrt(distance2))
+						{
+							expected.push_back(Hit{ entity.get(), distance2 });
+						}
+					}
+					std::stable_sort(expected.begin(), expected.end(), [](const Hit& a, const Hit& b) { return a.distance2 < b.distance2; });
+					if (!sameHits(hits, expected))
+					{
+						errorMessage = "cone query differs from a linear search";
+						return false;
+					}
+				}
+				if (numHits == 0)
+				{
+					errorMessage = "test data does not exercise cone queries";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_IncrementalUpdates : public TeamSpatialQuery_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Movement, team changes, removal, and destroyed entities are picked up by refresh";
+
+				TestWorld world;
+				populate(world, 800, 2, 400.f, 3);
+
+				std::mt19937 rng(17);
+				std::uniform_real_distribution<float> stepDist(-40.f, 40.f);
+				std::uniform_real_distribution<float> posDist(-450.f, 450.f);
+				TeamSpatialQueries::QueryScratch scratch;
+				std::vector<Hit> hits;
+				for (int frame = 0; frame < 30; ++frame)
+				{
+					for (size_t entityIdx = 0; entityIdx < world.entities.size(); ++entityIdx)
+					{
+						WorldEntity& entity = *world.entities[entityIdx];
+						Transform xform = entity.getTransform();
+						xform.position += vec3(stepDist(rng), stepDist(rng), stepDist(rng));
+						entity.setTransform(xform);
+						if ((entityIdx + frame) % 97 == 0)
+						{
+							entity.getGameComponent<TeamComponent>()->setTeam(1 - teamOf(entity)); //defected
+						}
+					}
+					if (frame % 5 == 0)
+					{
+						world.queries.removeEntity(world.entities.back().get());
+						world.entities.pop_back();
+					}
+					if (frame == 10)
+					{
+						world.entities.erase(world.entities.begin()); //destroyed without being removed
+					}
+					world.queries.refresh();
+
+					for (int queryIdx = 0; queryIdx < 20; ++queryIdx)
+					{
+						const vec3 position(posDist(rng), posDist(rng), posDist(rng));
+						world.queries.kNearestEnemies(position, size_t(queryIdx % 2), 5, 200.f, scratch, hits);
+						if (!sameHits(hits, bruteForceNearest(world, position, size_t(queryIdx % 2), 5, 200.f)))
+						{
+							errorMessage = "queries are stale after refresh";
+							return false;
+						}
+					}
+				}
+
+				if (world.queries.getNumEntities() != world.entities.size())
+				{
+					errorMessage = "removed or destroyed entities are still tracked";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_ConcurrentQueries : public TeamSpatialQuery_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Queries from several threads, each with its own scratch, match single threaded answers";
+
+				TestWorld world;
+				populate(world, 1500, 3, 800.f, 29);
+
+				std::mt19937 rng(31);
+				std::uniform_real_distribution<float> posDist(-850.f, 850.f);
+				std::vector<vec3> positions;
+				for (int queryIdx = 0; queryIdx < 2000; ++queryIdx)
+				{
+					positions.push_back(vec3(posDist(rng), posDist(rng), posDist(rng)));
+				}
+
+				const size_t numThreads = 4;
+				std::vector<std::vector<Hit>> threadHits(numThreads);
+				std::vector<std::thread> threads;
+				for (size_t threadIdx = 0; threadIdx < numThreads; ++threadIdx)
+				{
+					threads.emplace_back([&world, &positions, &threadHits, threadIdx]()
+					{
+						TeamSpatialQueries::QueryScratch scratch;
+						std::vector<Hit> hits;
+						for (size_t queryIdx = 0; queryIdx < positions.size(); ++queryIdx)
+						{
+							world.queries.kNearestEnemies(positions[queryIdx], queryIdx % 3, 3, 250.f, scratch, hits);
+							threadHits[threadIdx].insert(threadHits[threadIdx].end(), hits.begin(), hits.end());
+						}
+					});
+				}
+				for (std::thread& thread : threads)
+				{
+					thread.join();
+				}
+
+				std::vector<Hit> expected;
+				for (size_t queryIdx = 0; queryIdx < positions.size(); ++queryIdx)
+				{
+					std::vector<Hit> queryHits = bruteForceNearest(world, positions[queryIdx], queryIdx % 3, 3, 250.f);
+					expected.insert(expected.end(), queryHits.begin(), queryHits.end());
+				}
+				for (const std::vector<Hit>& hits : threadHits)
+				{
+					if (!sameHits(hits, expected))
+					{
+						errorMessage = "a concurrent query returned a different answer";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_NearestEnemy : public TeamSpatialQuery_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Every ship finding its nearest enemy: tree queries vs a linear walk";
+
+				const size_t numShips = 3000;
+				TestWorld world;
+				populate(world, numShips, 2, 1500.f, 23);
+
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point start = Clock::now();
+				world.queries.refresh();
+				const double refreshMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				TeamSpatialQueries::QueryScratch scratch;
+				std::vector<Hit> hits;
+				size_t treeFound = 0;
+				start = Clock::now();
+				for (const sp<WorldEntity>& ship : world.entities)
+				{
+					treeFound += world.queries.kNearestEnemies(ship->getWorldPosition(), teamOf(*ship), 1, 400.f, scratch, hits);
+				}
+				const double treeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				//what the LINEAR_SEARCH target finder did; per entity team lookup on every other entity
+				size_t linearFound = 0;
+				start = Clock::now();
+				for (const sp<WorldEntity>& ship : world.entities)
+				{
+					const size_t myTeam = teamOf(*ship);
+					const vec3 myPos = ship->getWorldPosition();
+					const WorldEntity* best = nullptr;
+					float bestLen2 = 400.f * 400.f;
+					for (const sp<WorldEntity>& other : world.entities)
+					{
+						const TeamComponent* teamCom = other->getGameComponent<TeamComponent>();
+						const float len2 = glm::distance2(other->getWorldPosition(), myPos);
+						if (teamCom && teamCom->getTeam() != myTeam && len2 < bestLen2)
+						{
+							best = other.get();
+							bestLen2 = len2;
+						}
+					}
+					linearFound += best ? 1 : 0;
+				}
+				const double linearMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				std::cout << "\t\t" << numShips << " ships | refresh " << refreshMs << "ms | tree " << treeMs << "ms | linear " << linearMs << "ms" << std::endl;
+
+				if (treeFound != linearFound)
+				{
+					errorMessage = "tree and linear search found a different number of targets";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class TeamSpatialQueryTestSuite : public SA::TestSuite
+		{
+		public:
+			TeamSpatialQueryTestSuite()
+			{
+				testName = "TEAM SPATIAL QUERY TEST SUITE";
+
+				addTest(new_sp<Test_NearestMatchesBruteForce>());
+				addTest(new_sp<Test_ConeMatchesBruteForce>());
+				addTest(new_sp<Test_IncrementalUpdates>());
+				addTest(new_sp<Test_ConcurrentQueries>());
+				addTest(new_sp<Benchmark_NearestEnemy>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getTeamSpatialQueryTestSuite()
+	{
+		return new_sp<SA::TeamSpatialQueryTests::TeamSpatialQueryTestSuite>();
+	}
+}
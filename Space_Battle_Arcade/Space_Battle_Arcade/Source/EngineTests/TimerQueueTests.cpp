@@ -0,0 +1,294 @@
+#include "EngineTestSuite.h"
+#include "GameFramework/TimeManagement/TimerQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace SA
+{
+	namespace TimerQueueTests
+	{
+		class TimerQueue_UnitTest : public SA::UnitTest
+		{
+		public:
+			TimerQueue_UnitTest()
+			{
+				testNamespace = "TimerQueue:";
+			}
+		};
+
+		/** records which timers fired, in order */
+		struct TimerProbe : public GameEntity
+		{
+			int id = 0;
+			std::vector<int>* firedLog = nullptr;
+			void handleFired() { firedLog->push_back(id); }
+		};
+
+		static sp<Timer> makeTimer(std::vector<int>& firedLog, int id, float duration, bool bLoop = false, float delay = 0.f)
+		{
+			sp<TimerProbe> probe = new_sp<TimerProbe>();
+			probe->id = id;
+			probe->firedLog = &firedLog;
+			sp<MultiDelegate<>> callback = new_sp<MultiDelegate<>>();
+			callback->addStrongObj(probe, &TimerProbe::handleFired);
+
+			sp<Timer> timer = new_sp<Timer>();
+			timer->set(callback, duration, bLoop, delay);
+			return timer;
+		}
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// ordering
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Test_FiresInDeadlineOrder : public TimerQueue_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Timers fire earliest deadline first, ties in schedule order, only once the clock passes them";
+
+				std::vector<int> firedLog;
+				std::vector<sp<Timer>> finished;
+				TimerQueue queue;
+				queue.schedule(makeTimer(firedLog, 3, 3.f), 0.0);
+				queue.schedule(makeTimer(firedLog, 1, 1.f), 0.0);
+				queue.schedule(makeTimer(firedLog, 2, 1.f), 0.0);
+				queue.schedule(makeTimer(firedLog, 4, 0.5f, false, 3.f), 0.0);	//delayed past the 3 second timer
+
+				queue.fireExpired(1.0, finished);
+				if (!firedLog.empty())
+				{
+					errorMessage = "a timer fired on its deadline rather than after it";
+					return false;
+				}
+
+				queue.fireExpired(10.0, finished);
+				if (firedLog != std::vector<int>{ 1, 2, 3, 4 } || finished.size() != 4 || !queue.empty())
+				{
+					errorMessage = "timers fired out of deadline order or were not finished";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_LoopsCatchUp : public TimerQueue_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Looping timers fire once per elapsed period and stay scheduled";
+
+				std::vector<int> firedLog;
+				std::vector<sp<Timer>> finished;
+				TimerQueue queue;
+				sp<Timer> looping = makeTimer(firedLog, 7, 0.5f, true);
+				queue.schedule(looping, 0.0);
+
+				queue.fireExpired(1.6, finished);
+				if (firedLog.size() != 3 || !finished.empty() || !looping->isScheduled())
+				{
+					errorMessage = "a long frame did not fire every elapsed period";
+					return false;
+				}
+
+				queue.fireExpired(1.7, finished);
+				queue.fireExpired(2.01, finished);
+				if (firedLog.size() != 4)
+				{
+					errorMessage = "loop period drifted after catching up";
+					return false;
+				}
+
+				sp<Timer> zeroLoop = makeTimer(firedLog, 8, 0.f, true);
+				queue.schedule(zeroLoop, 2.01);
+				queue.fireExpired(2.02, finished);
+				if (std::count(firedLog.begin(), firedLog.end(), 8) != 1)
+				{
+					errorMessage = "zero length loop should fire exactly once per advance";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		class Test_UnscheduleAnywhere : public TimerQueue_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Unscheduling from anywhere in the heap keeps the remaining order";
+
+				std::vector<int> firedLog;
+				std::vector<sp<Timer>> finished;
+				std::vector<sp<Timer>> timers;
+				std::vector<float> durations;
+				std::mt19937 rng(13);
+				std::uniform_real_distribution<float> durationDist(0.f, 10.f);
+				TimerQueue queue;
+				for (int timerIdx = 0; timerIdx < 500; ++timerIdx)
+				{
+					durations.push_back(durationDist(rng));
+					timers.push_back(makeTimer(firedLog, timerIdx, durations.back()));
+					queue.schedule(timers.back(), 0.0);
+				}
+				for (size_t timerIdx = 0; timerIdx < timers.size(); timerIdx += 3)
+				{
+					queue.unschedule(*timers[timerIdx]);
+				}
+
+				queue.fireExpired(100.0, finished);
+				if (finished.size() != timers.size() - (timers.size() + 2) / 3 || !queue.empty())
+				{
+					errorMessage = "wrong number of timers fired after unscheduling";
+					return false;
+				}
+				for (size_t logIdx = 0; logIdx < firedLog.size(); ++logIdx)
+				{
+					if (firedLog[logIdx] % 3 == 0)
+					{
+						errorMessage = "an unscheduled timer fired";
+						return false;
+					}
+					if (logIdx > 0 && durations[firedLog[logIdx]] < durations[firedLog[logIdx - 1]])
+					{
+						errorMessage = "timers fired out of order after unscheduling";
+						return false;
+					}
+				}
+				return true;
+			}
+		};
+
+		class Test_UnboundDelegatesFinish : public TimerQueue_UnitTest
+		{
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Timers whose delegates lost their bindings finish without firing";
+
+				std::vector<int> firedLog;
+				std::vector<sp<Timer>> finished;
+				TimerQueue queue;
+				sp<Timer> timer = new_sp<Timer>();
+				timer->set(new_sp<MultiDelegate<>>(), 1.f, true, 0.f);
+				queue.schedule(timer, 0.0);
+
+				queue.fireExpired(5.0, finished);
+				if (finished.size() != 1 || timer->isScheduled())
+				{
+					errorMessage = "unbound looping timer was kept alive";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// benchmark
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class Benchmark_PendingTimers : public TimerQueue_UnitTest
+		{
+			/** the per frame walk TimeManager used before the queue; every timer is visited every frame */
+			struct WalkedTimer
+			{
+				sp<MultiDelegate<>> userCallback;
+				float durationSecs = 0.f;
+				float currentTime = 0.f;
+				bool bLoop = true;
+
+				bool update(float dt_dilatedSecs)
+				{
+					if (!userCallback || userCallback->numBound() == 0) { return true; }
+					currentTime += dt_dilatedSecs;
+					while (currentTime > durationSecs)
+					{
+						userCallback->broadcast();
+						currentTime -= durationSecs;
+						if (!bLoop) { return true; }
+					}
+					return false;
+				}
+			};
+
+			virtual bool runInternal(bool stopOnFail = false) override
+			{
+				testName = "Per frame cost with thousands of pending AI timers";
+
+				const int numTimers = 5000;
+				const int frames = 300;
+				const float dt_sec = 1.f / 60.f;
+				std::mt19937 rng(5);
+				std::uniform_real_distribution<float> periodDist(0.5f, 8.f);	//service and fire rate style periods
+
+				std::vector<int> walkLog;
+				std::vector<int> queueLog;
+				std::vector<WalkedTimer> walked;
+				TimerQueue queue;
+				for (int timerIdx = 0; timerIdx < numTimers; ++timerIdx)
+				{
+					float period = periodDist(rng);
+					sp<Timer> timer = makeTimer(queueLog, timerIdx, period, true);
+					queue.schedule(timer, 0.0);
+
+					WalkedTimer walkedTimer;
+					walkedTimer.userCallback = makeTimer(walkLog, timerIdx, period, true)->getUserCallback();
+					walkedTimer.durationSecs = period;
+					walked.push_back(walkedTimer);
+				}
+
+				using Clock = std::chrono::high_resolution_clock;
+				Clock::time_point start = Clock::now();
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					for (WalkedTimer& timer : walked)
+					{
+						timer.update(dt_sec);
+					}
+				}
+				const double walkMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+				std::vector<sp<Timer>> finished;
+				double clockSecs = 0.0;
+				start = Clock::now();
+				for (int frame = 0; frame < frames; ++frame)
+				{
+					clockSecs += dt_sec;
+					queue.fireExpired(clockSecs, finished);
+				}
+				const double queueMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+
+				std::cout << "\t\t" << numTimers << " timers, " << queueLog.size() << " fires | walk " << walkMs << "ms/frame | queue " << queueMs << "ms/frame" << std::endl;
+
+				//accumulating float dt and a double clock may disagree on a fire that lands on the last frame's boundary
+				if (queueLog.size() + 5 < walkLog.size() || walkLog.size() + 5 < queueLog.size())
+				{
+					errorMessage = "queue and walk fired a different number of times";
+					return false;
+				}
+				return true;
+			}
+		};
+
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/// Container test suite
+		/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		class TimerQueueTestSuite : public SA::TestSuite
+		{
+		public:
+			TimerQueueTestSuite()
+			{
+				testName = "TIMER QUEUE TEST SUITE";
+
+				addTest(new_sp<Test_FiresInDeadlineOrder>());
+				addTest(new_sp<Test_LoopsCatchUp>());
+				addTest(new_sp<Test_UnscheduleAnywhere>());
+				addTest(new_sp<Test_UnboundDelegatesFinish>());
+				addTest(new_sp<Benchmark_PendingTimers>());
+			}
+		};
+	}
+
+	sp<SA::TestSuite> getTimerQueueTestSuite()
+	{
+		return new_sp<SA::TimerQueueTests::TimerQueueTestSuite>();
+	}
+}
@@ -1,7 +1,9 @@
 #pragma once
+#include "GameFramework/SABehaviorTree.h"
 
 namespace SA
 {
-	const char* const BT_TargetKey = "target";
-	const char* const BT_AttackersKey = "activeAttackersKey";
-}
\ No newline at end of file
+	//interned once at startup; memory lookups with these index a slot rather than hashing a string
+	inline const BehaviorTree::MemoryKey BT_TargetKey{ "target" };
+	inline const BehaviorTree::MemoryKey BT_AttackersKey{ "activeAttackersKey" };
+}
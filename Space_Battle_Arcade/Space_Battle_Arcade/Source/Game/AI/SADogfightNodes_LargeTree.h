@@ -106,9 +106,9 @@ namespace SA
 		private:
 			void handleTargetReplaced(const std::string& key, const GameEntity* oldValue, const GameEntity* newValue);
 		protected: //node properties
-			const std::string targetArrangement_Key;
-			const std::string brain_Key;
-			const std::string target_Key;
+			const MemoryKey targetArrangement_Key;
+			const MemoryKey brain_Key;
+			const MemoryKey target_Key;
 		protected: //cached values
 			fwp<TargetIs> targetArrangment;
 			fwp<ShipAIBrain> myBrain;
@@ -146,8 +146,8 @@ namespace SA
 			fwp<ShipInputRequest> inputRequestLoc;
 			TargetIs arrangement;
 		private: //node properties
-			const std::string comboListKey;
-			const std::string inputRequestKey;
+			const MemoryKey comboListKey;
+			const MemoryKey inputRequestKey;
 		};
 
 		////////////////////////////////////////////////////////
@@ -169,7 +169,7 @@ namespace SA
 			virtual void postConstruct() override;
 
 		private:
-			const std::string comboList_Key;
+			const MemoryKey comboList_Key;
 		private:
 			fwp<ComboList> comboList;
 			sp<RNG> rng;
@@ -195,7 +195,7 @@ namespace SA
 			virtual void handleNodeAborted() override {}
 			virtual void taskCleanup() override {};
 		private: //node properties 
-			const std::string inputRequest_key;
+			const MemoryKey inputRequest_key;
 		private:
 			fwp<ShipInputRequest> inputRequest;
 		};
@@ -233,7 +233,7 @@ namespace SA
 		private:
 			virtual void handleNodeAborted() override {}
 		private: //node properties
-			const std::string memoryKey;
+			const MemoryKey memoryKey;
 			const TargetIs value;
 		private:
 			sp<TargetIs> cachedValue = nullptr;
@@ -290,7 +290,7 @@ namespace SA
 			virtual void notifyTreeEstablished() override;
 
 		private:
-			const std::string inputRequests_key;
+			const MemoryKey inputRequests_key;
 		private:
 			fwp<ShipInputRequest> inputRequest;
 		};
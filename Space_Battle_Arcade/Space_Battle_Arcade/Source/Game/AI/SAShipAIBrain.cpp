@@ -55,6 +55,11 @@ namespace SA
 		return controlledTarget.get();
 	}
 
+	SA::WorldEntity* ShipAIBrain::getLodAnchor()
+	{
+		return controlledTarget.get();
+	}
+
 	////////////////////////////////////////////////////////
 	// ContinuousFireBrain
 	////////////////////////////////////////////////////////
@@ -431,17 +436,19 @@ namespace SA
 
 
 		using namespace BehaviorTree;
-		behaviorTree =
-			new_sp<Tree>("fighter-tree-root",
-				new_sp<Decorator_FighterStateSetter>("decor_state_setter", stateKey, targetKey, activeAttackers_Key,
-				new_sp<Service_TargetFinder>("service_targetFinder", 1.0f, true, brainKey, targetKey, activeAttackers_Key, stateKey,
-				new_sp<Service_AttackerSetter>("service_attacker_setter", 0.5f, true, activeAttackers_Key, targetKey, brainKey,
-				new_sp<Service_OpportunisiticShots>("service_opportunisiticShots", 0.1f, true, brainKey, targetKey, secondaryTargetsKey, stateKey,
+
+		//every fighter runs the same structure; built once, then each brain only constructs the nodes that keep their own state
+		static const sp<const TreeDefinition> fighterTreeDefinition =
+			new_sp<TreeDefinition>("fighter-tree-root",
+				perAgentNode<Decorator_FighterStateSetter>("decor_state_setter", stateKey, targetKey, activeAttackers_Key,
+				perAgentNode<Service_TargetFinder>("service_targetFinder", 1.0f, true, brainKey, targetKey, activeAttackers_Key, stateKey,
+				perAgentNode<Service_AttackerSetter>("service_attacker_setter", 0.5f, true, activeAttackers_Key, targetKey, brainKey,
+				perAgentNode<Service_OpportunisiticShots>("service_opportunisiticShots", 0.1f, true, brainKey, targetKey, secondaryTargetsKey, stateKey,
 					new_sp<Loop>("fighter-inf-loop", 0,
 						new_sp<Selector>("state_selector", MakeChildren{
-							new_sp<Decorator_Aborting_Is<MentalState_Fighter>>("dec_evade_state", stateKey, OP::EQUAL, MentalState_Fighter::EVADE, AbortPreference::ABORT_ON_MODIFY,
+							perAgentNode<Decorator_Aborting_Is<MentalState_Fighter>>("dec_evade_state", stateKey, OP::EQUAL, MentalState_Fighter::EVADE, AbortPreference::ABORT_ON_MODIFY,
 								new_sp<Sequence>("EvadeToDogfight", MakeChildren{
-									new_sp<Task_FindDogfightLocation>("task_findDFLoc", dogFightLoc_Key, brainKey),
+									perAgentNode<Task_FindDogfightLocation>("task_findDFLoc", dogFightLoc_Key, brainKey),
 									new_sp<Loop>("evade-loop", 0,
 										new_sp<Random>("RandomSelector",
 											Chances{
@@ -449,28 +456,32 @@ namespace SA
 												{"spiral_spin", 1}
 											},
 											MakeChildren{
-												new_sp<Task_EvadePatternSpiral>("spiral_evade", dogFightLoc_Key, brainKey, 5.0f),
-												new_sp<Task_EvadePatternSpin>("spiral_spin", dogFightLoc_Key, brainKey, 5.0f)
+												perAgentNode<Task_EvadePatternSpiral>("spiral_evade", dogFightLoc_Key, brainKey, 5.0f),
+												perAgentNode<Task_EvadePatternSpin>("spiral_spin", dogFightLoc_Key, brainKey, 5.0f)
 											}
 										)
 									)
 								})
 							),
-							new_sp<Decorator_Aborting_Is<MentalState_Fighter>>("dec_attack_state", stateKey, OP::EQUAL, MentalState_Fighter::ATTACK_FIGHTER, AbortPreference::ABORT_ON_MODIFY,
-								new_sp<Task_DogfightNode>("Task_Dogfight", brainKey, targetKey, secondaryTargetsKey)
+							perAgentNode<Decorator_Aborting_Is<MentalState_Fighter>>("dec_attack_state", stateKey, OP::EQUAL, MentalState_Fighter::ATTACK_FIGHTER, AbortPreference::ABORT_ON_MODIFY,
+								perAgentNode<Task_DogfightNode>("Task_Dogfight", brainKey, targetKey, secondaryTargetsKey)
 							),
-							new_sp<Decorator_Aborting_Is<MentalState_Fighter>>("dec_attack_state", stateKey, OP::EQUAL, MentalState_Fighter::ATTACK_OBJECTIVE, AbortPreference::ABORT_ON_MODIFY,
-								new_sp<Task_AttackObjective>("Task_AttackObject", brainKey, targetKey)
+							perAgentNode<Decorator_Aborting_Is<MentalState_Fighter>>("dec_attack_state", stateKey, OP::EQUAL, MentalState_Fighter::ATTACK_OBJECTIVE, AbortPreference::ABORT_ON_MODIFY,
+								perAgentNode<Task_AttackObjective>("Task_AttackObject", brainKey, targetKey)
 							),
-							new_sp<Decorator_Aborting_Is<MentalState_Fighter>>("dec_wander_state", stateKey, OP::EQUAL, MentalState_Fighter::WANDER, AbortPreference::ABORT_ON_MODIFY,
+							perAgentNode<Decorator_Aborting_Is<MentalState_Fighter>>("dec_wander_state", stateKey, OP::EQUAL, MentalState_Fighter::WANDER, AbortPreference::ABORT_ON_MODIFY,
 								new_sp<Sequence>("Sequence_MoveToNewLocation", MakeChildren{
-									new_sp<Task_FindRandomLocationNearby>(wanderLocKey, originKey, 400.0f),
-									new_sp<Task_Ship_MoveToLocation>(brainKey, wanderLocKey, 45.0f)
+									perAgentNode<Task_FindRandomLocationNearby>(wanderLocKey, originKey, 400.0f),
+									perAgentNode<Task_Ship_MoveToLocation>(brainKey, wanderLocKey, 45.0f)
 								})
 							)
 						})
 					)
-				)))),
+				))))
+			);
+
+		behaviorTree =
+			new_sp<Tree>(fighterTreeDefinition,
 				MemoryInitializer
 				{
 					{ brainKey, sp_this() },
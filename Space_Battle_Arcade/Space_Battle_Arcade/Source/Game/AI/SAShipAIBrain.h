@@ -34,6 +34,9 @@ namespace SA
 		const Ship* getControlledTarget() const;
 		wp<Ship> getWeakControlledTarget() { return controlledTarget; }
 		
+	protected:
+		virtual WorldEntity* getLodAnchor() override;
+
 	protected:
 		lp<Ship> controlledTarget;
 		wp<LevelBase> wpLevel;
@@ -449,7 +449,7 @@ namespace SA
 
 		void Service_TargetFinder::resetSearchData()
 		{
-			//currentSearchMethod = SearchMethod::NEARBY_HASH_CELLS;
+			//currentSearchMethod = SearchMethod::NEAREST_ENEMY;
 			//currentSearchMethod = SearchMethod::LINEAR_SEARCH; 
 			currentSearchMethod = SearchMethod::COMMANDER_ASSIGNED;
 		}
@@ -471,6 +471,7 @@ namespace SA
 
 				sp<WorldEntity> bestSoFar = nullptr;
 				std::optional<float> bestSoFarLen2;
+				bool bSearchNearestEnemy = currentSearchMethod == SearchMethod::NEAREST_ENEMY;
 
 				if (currentSearchMethod == SearchMethod::COMMANDER_ASSIGNED)
 				{
@@ -478,14 +479,15 @@ namespace SA
 					{
 						if (TeamCommander* teamCommander = spaceLevel->getTeamCommander(cachedTeamIdx))
 						{
-							if (sp<WorldEntity> target = teamCommander->getTarget())
+							if (sp<WorldEntity> target = teamCommander->getTarget(myPos))
 							{
 								bestSoFar = target;
 								setTarget(target, true);
 							}
 							else
 							{
-								//AdvanceState(); #TODO have this check other methods by switching the current search enum or some mechanism
+								//every enemy near us is already assigned, fall back to whatever enemy is closest
+								bSearchNearestEnemy = true;
 							}
 						}
 					}
@@ -494,34 +496,9 @@ namespace SA
 						log("Service_TargetFinder", LogLevel::LOG_ERROR, "Could not cast to correct level type");
 					}
 				}
-				else if(currentSearchMethod == SearchMethod::NEARBY_HASH_CELLS)
-				{
-					SH::SpatialHashGrid<WorldEntity>& worldGrid = level->getWorldGrid();
-
-					std::vector<sp<const SH::HashCell<WorldEntity>>> nearbyCells; //#optimize constructing vectors has been seen to be slow before, perhaps make this static if it is only going to be used within a single thread
-					glm::vec4 center = glm::vec4(myPos, 1.0f);
-					float radius = 20.f;
-
-					const std::array<glm::vec4, 8> worldSpaceBox =
-					{
-						center + vec4(-radius, radius, radius, 0),
-						center + vec4(radius, radius, radius, 0),
-
-						center + vec4(-radius, -radius, radius, 0),
-						center + vec4(radius, -radius, radius, 0),
-
-						center + vec4(-radius, radius, -radius, 0),
-						center + vec4(radius, radius, -radius, 0),
-
-						center + vec4(-radius, -radius, -radius, 0),
-						center + vec4(radius, -radius, -radius, 0),
-					};
-					worldGrid.lookupCellsForOOB(worldSpaceBox, nearbyCells);
-
-				}
 				else if (currentSearchMethod == SearchMethod::LINEAR_SEARCH)
 				{
-					const std::set<sp<WorldEntity>>& worldEntities = level->getWorldEntities();
+					const LevelBase::WorldEntitySet& worldEntities = level->getWorldEntities();
 					for (const sp<WorldEntity>& entity : worldEntities)
 					{
 						if(TeamComponent* TeamCom = entity->getGameComponent<TeamComponent>())
@@ -551,6 +528,14 @@ namespace SA
 					}
 				}
 
+				if (bSearchNearestEnemy)
+				{
+					if (level->getTeamQueries().kNearestEnemies(myPos, cachedTeamIdx, 1, nearestEnemySearchDistance, nearestEnemyScratch, nearestEnemyHits) > 0)
+					{
+						bestSoFar = nearestEnemyHits[0].entity->requestTypedReference_Nonsafe<WorldEntity>().lock();
+					}
+				}
+
 				if (bestSoFar)
 				{
 					setTarget(bestSoFar);
@@ -656,7 +641,7 @@ namespace SA
 		// Service_AttackerSetter
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-		void modifyAttackers(lp<TargetType>& target, bool bAdd, sp<TargetType>& myShip, const std::string& attackersKey)
+		void modifyAttackers(lp<TargetType>& target, bool bAdd, sp<TargetType>& myShip, const MemoryKey& attackersKey)
 		{
 			if (BrainComponent* brainComp = target->getGameComponent<BrainComponent>())
 			{
@@ -715,7 +700,7 @@ namespace SA
 				ScopedUpdateNotifier<TargetType> target_writable;
 				if (memory.getWriteValueAs(targetKey, target_writable))
 				{
-					handleTargetReplaced(targetKey, nullptr, &target_writable.get());
+					handleTargetReplaced(targetKey.getName(), nullptr, &target_writable.get());
 				}
 			}
 		}
@@ -1099,7 +1084,8 @@ namespace SA
 			static LevelSystem& levelSystem = GameBase::get().getLevelSystem();
 			if (const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel())
 			{
-				currentLevel->getWorldTimeManager()->registerTicker(sp_this());
+				//ticks at the tier of the brain running this tree
+				currentLevel->getAILodScheduler().registerTicker(sp_this(), &getTree());
 			}
 
 		}
@@ -1111,7 +1097,7 @@ namespace SA
 			static LevelSystem& levelSystem = GameBase::get().getLevelSystem();
 			if (const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel())
 			{
-				currentLevel->getWorldTimeManager()->removeTicker(sp_this());
+				currentLevel->getAILodScheduler().removeTicker(sp_this());
 			}
 		}
 
@@ -2,6 +2,7 @@
 #include <cstdint>
 
 #include "GameFramework/SABehaviorTree.h"
+#include "GameFramework/SATeamSpatialQueries.h"
 #include "GameFramework/SATimeManagementSystem.h"
 #include "Game/SAShip.h"
 #include "Tools/DataStructures/SATransform.h"
@@ -86,8 +87,8 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			virtual void taskCleanup() override {};
 
 		private:
-			const std::string outputLocation_MemoryKey;
-			const std::string inputLocation_MemoryKey;
+			const MemoryKey outputLocation_MemoryKey;
+			const MemoryKey inputLocation_MemoryKey;
 			const float radius;
 			sp<RNG> rng;
 		};
@@ -112,8 +113,8 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			virtual void handleNodeAborted() override {}	//immediate return; no need to cancel timers
 			virtual void taskCleanup() override {};
 		private:
-			const std::string outputLocation_MemoryKey;
-			const std::string shipBrain_MemoryKey;
+			const MemoryKey outputLocation_MemoryKey;
+			const MemoryKey shipBrain_MemoryKey;
 		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -142,8 +143,8 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 
 		private:
 			//memory keys
-			const std::string shipBrain_MemoryKey;
-			const std::string targetLoc_MemoryKey;
+			const MemoryKey shipBrain_MemoryKey;
+			const MemoryKey targetLoc_MemoryKey;
 			const float timeoutSecs;
 
 			//cached state
@@ -209,9 +210,9 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			float prefDistTarget2 = 100.0f;
 
 		private: //node properties
-			const std::string shipBrain_MemoryKey;
-			const std::string target_MemoryKey;
-			const std::string activeAttackers_MemoryKey;
+			const MemoryKey shipBrain_MemoryKey;
+			const MemoryKey target_MemoryKey;
+			const MemoryKey activeAttackers_MemoryKey;
 			float preferredDistanceToTarget = 30.0f;
 		};
 
@@ -223,8 +224,8 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			enum class SearchMethod
 			{
 				COMMANDER_ASSIGNED,
-				NEARBY_HASH_CELLS, //#TODO remove these if they don't get used
-				LINEAR_SEARCH,
+				NEAREST_ENEMY,
+				LINEAR_SEARCH, //reference for NEAREST_ENEMY, walks every world entity
 			};
 
 		private:
@@ -263,10 +264,10 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			lp<Ship> myShip; //this should be easily refactorable to generic type if needed, ship reference can be kept too for ship specific details. changing type to worldentity->ship for avoidance
 			
 		private:
-			const std::string brainKey;
-			const std::string targetKey;
-			const std::string activeAttackersKey;
-			const std::string stateKey;
+			const MemoryKey brainKey;
+			const MemoryKey targetKey;
+			const MemoryKey activeAttackersKey;
+			const MemoryKey stateKey;
 		private:
 			ShipAIBrain* owningBrain = nullptr;
 			ActiveAttackers* attackers = nullptr;
@@ -274,6 +275,9 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			sp<TargetType> currentTarget;
 			lp<const PrimitiveWrapper<MentalState_Fighter>> stateRef = nullptr;
 			float preferredTargetMaxDistance = 200.f;
+			float nearestEnemySearchDistance = 5000.f;
+			TeamSpatialQueries::QueryScratch nearestEnemyScratch;
+			std::vector<TeamSpatialQueries::Hit> nearestEnemyHits;
 			bool bCommanderProvidedTarget = false;
 			bool bEvaluateActiveAttackersOnNextTick = false;
 			bool bTargetIsPlayer = false;
@@ -324,9 +328,9 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			
 			virtual void handleNodeAborted() override {}
 		private: //keys
-			const std::string attackersKey;
-			const std::string targetKey;
-			const std::string brainKey;
+			const MemoryKey attackersKey;
+			const MemoryKey targetKey;
+			const MemoryKey brainKey;
 		private: //data
 			struct Data
 			{
@@ -384,10 +388,10 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			float lastShotTimestamp = 0.f;
 
 		private: //node properties
-			const std::string brainKey;
-			const std::string targetKey;
-			const std::string secondaryTargetsKey;
-			const std::string stateKey;
+			const MemoryKey brainKey;
+			const MemoryKey targetKey;
+			const MemoryKey secondaryTargetsKey;
+			const MemoryKey stateKey;
 			float fireRadius_cosTheta = glm::cos(10 * glm::pi<float>()/180);
 			float shootRandomOffsetStrength = 1.0f;
 			float shootCooldown = 1.1f;
@@ -442,9 +446,9 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			sp<MultiDelegate<>> deferredStateChangeTimer;
 			sp<RNG> rng;
 		private:
-			const std::string stateKey;
-			const std::string targetKey;
-			const std::string activeAttackersKey;
+			const MemoryKey stateKey;
+			const MemoryKey targetKey;
+			const MemoryKey activeAttackersKey;
 		};
 
 
@@ -471,8 +475,8 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			virtual void handleNodeAborted() override {}
 			virtual void taskCleanup() override {};
 		private:
-			const std::string entityKey;
-			const std::string writeLocKey;
+			const MemoryKey entityKey;
+			const MemoryKey writeLocKey;
 		};
 
 
@@ -502,8 +506,8 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 		private:
 			sp<RNG> rng;
 		private:
-			const std::string writeLocationKey;
-			const std::string brainKey;
+			const MemoryKey writeLocationKey;
+			const MemoryKey brainKey;
 			float maxRandomPointRadius = 300.f;
 			float minRandomPointRadius = 10.f;
 			float maxTravelDistance = 200.f;
@@ -549,8 +553,8 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 				float totalTravelDistance = 0.f;
 			} base; //data
 		private: //node properties
-			const std::string targetLocKey;
-			const std::string brainKey;
+			const MemoryKey targetLocKey;
+			const MemoryKey brainKey;
 			float timeoutSecs;
 		};
 		
@@ -896,9 +900,9 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			DogFightComboProccessor comboProcessor;
 			bool bTargetIsPlayer = false;
 		private: //node properties
-			const std::string brain_key;
-			const std::string target_key;
-			const std::string secondaryTarget_key;
+			const MemoryKey brain_key;
+			const MemoryKey target_key;
+			const MemoryKey secondaryTarget_key;
 			float variabilityIntervalSec = 3.0f;
 		};
 
@@ -955,8 +959,8 @@ LogShipNodeDebugMessage(this->getTree(), *this, message);
 			float timestamp_timoutDiveBomb = 0.f;
 			State state = State::SET_UP_RUN;
 		private: //node properties
-			const std::string brain_key;
-			const std::string target_key;
+			const MemoryKey brain_key;
+			const MemoryKey target_key;
 			sp<RNG> rng = nullptr;
 		};
 
@@ -14,6 +14,35 @@ namespace SA
 {
 
 	/*static*/ sp<ConfigBase> ConfigBase::load(std::string filePath, const std::function<sp<ConfigBase>()>& configFactory)
+	{
+		std::string modPath;
+		std::string fileAsStr;
+		if (readConfigFile(filePath, modPath, fileAsStr))
+		{
+			sp<ConfigBase> newConfig = configFactory();
+			newConfig->deserialize(fileAsStr);
+			newConfig->owningModDir = modPath;
+
+			return newConfig;
+		}
+
+		return nullptr;
+	}
+
+	bool ConfigBase::loadFromFile(std::string filePath)
+	{
+		std::string modPath;
+		std::string fileAsStr;
+		if (readConfigFile(filePath, modPath, fileAsStr))
+		{
+			deserialize(fileAsStr);
+			owningModDir = modPath;
+			return true;
+		}
+		return false;
+	}
+
+	/*static*/ bool ConfigBase::readConfigFile(std::string& filePath, std::string& outModPath, std::string& outFileContents)
 	{
 		//replace windows filepath separators with unix separators
 		for (uint32_t charIdx = 0; charIdx < filePath.size(); ++charIdx)
@@ -48,22 +77,18 @@ namespace SA
 				std::stringstream ss;
 				ss << inFile.rdbuf();
 
-				std::string fileAsStr = ss.str();
-				if (fileAsStr.length() == 0)
-				
+				outFileContents = ss.str();
+				if (outFileContents.length() == 0)
 				{
 					log(__FUNCTION__, LogLevel::LOG_ERROR, "loading empty config");
 				}
 
-				sp<ConfigBase> newConfig = configFactory();
-				newConfig->deserialize(fileAsStr);
-				newConfig->owningModDir = modPath;
-
-				return newConfig;
+				outModPath = modPath;
+				return true;
 			}
 		}
 
-		return nullptr;
+		return false;
 	}
 
 	std::string ConfigBase::serialize()
@@ -14,6 +14,9 @@ namespace SA
 	public:
 		/* @param configFactor constructs a child class of ConfigBase */
 		static sp<ConfigBase> load(std::string filePath, const std::function<sp<ConfigBase>()>& configFactory);
+
+		/** Deserializes an already constructed config from a file. Only touches this config, so different configs may load concurrently (see ModSystem). */
+		bool loadFromFile(std::string filePath);
 		virtual std::string getRepresentativeFilePath() = 0;
 
 		std::string serialize();
@@ -25,6 +28,8 @@ namespace SA
 		const std::string& getOwningModDir() const { return owningModDir; }
 	protected:
 		void save(); //access restricted, only allow certain classes to save this.
+	private:
+		static bool readConfigFile(std::string& inOutFilePath, std::string& outModPath, std::string& outFileContents);
 	public: //public as these are modifying entirely external data
 		virtual void onSerialize(json& outData) = 0;
 		virtual void onDeserialize(const json& inData) = 0;
@@ -512,6 +512,34 @@ namespace SA
 		return primaryFireProjectile;
 	}
 
+	size_t SpawnConfig::resolveReferences(PrivateKey key, const std::map<std::string, sp<ProjectileConfig>>& projectileConfigs, const std::map<std::string, sp<SpawnConfig>>& spawnConfigs)
+	{
+		size_t numUnresolved = 0;
+
+		if (primaryProjectileConfigName.size() > 0)
+		{
+			auto findResult = projectileConfigs.find(primaryProjectileConfigName);
+			if (findResult != projectileConfigs.end())
+			{
+				primaryFireProjectile = findResult->second;
+			}
+			else
+			{
+				++numUnresolved;
+			}
+		}
+
+		for (const std::string& spawnableName : spawnableConfigsByName)
+		{
+			if (spawnConfigs.find(spawnableName) == spawnConfigs.end())
+			{
+				++numUnresolved;
+			}
+		}
+
+		return numUnresolved;
+	}
+
 	Transform SpawnConfig::getModelXform() const
 	{
 		Transform xform;
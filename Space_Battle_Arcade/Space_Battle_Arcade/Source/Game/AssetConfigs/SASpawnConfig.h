@@ -1,4 +1,5 @@
 #pragma once
+#include <map>
 #include <string>
 #include <vector>
 
@@ -64,6 +65,7 @@ namespace SA
 	class SpawnConfig final : public ConfigBase
 	{
 		friend class ModelConfigurerEditor_Level;
+	public:
 		class PrivateKey
 		{
 			friend class Mod;
@@ -93,6 +95,10 @@ namespace SA
 		const glm::vec3 getModelFacingDir_n() { return modelFacingDir; }
 		const glm::quat getModelDefaultRotation();
 		const std::vector<glm::vec3>& getFireLocationOffsets() const { return fireLocationOffsets; }
+		const std::vector<CollisionShapeSubConfig>& getCollisionShapes() const { return shapes; }
+
+		/** Binds name references to configs of the owning mod once every config is loaded. Returns the number of names that did not resolve. */
+		size_t resolveReferences(PrivateKey key, const std::map<std::string, sp<ProjectileConfig>>& projectileConfigs, const std::map<std::string, sp<SpawnConfig>>& spawnConfigs);
 
 #define AUDIO_GETTER_SETTER(sfx_member)\
 		const SoundEffectSubConfig& getConfig_##sfx_member() const { return sfx_member; }\
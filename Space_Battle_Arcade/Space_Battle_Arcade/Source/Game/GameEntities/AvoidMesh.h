@@ -30,6 +30,7 @@ namespace SA
 		virtual void postConstruct() override;
 		virtual void render(Shader& shader) override;
 		virtual void setTransform(const Transform& inTransform) override;
+		const std::vector<sp<class AvoidanceSphere>>& getAvoidanceSpheres() const { return avoidanceSpheres; }
 	private:
 		void updateAvoidanceSpheres();
 		void updateCollision();
@@ -1,6 +1,7 @@
 #include "Game/GameModes/ServerGameMode_CarrierTakedown.h"
 #include <string>
 #include <memory>
+#include "Game/AI/GlobalSpaceArcadeBehaviorTreeKeys.h"
 #include "Game/AI/SAShipBehaviorTreeNodes.h"
 #include "Game/AssetConfigs/SASettingsProfileConfig.h"
 #include "Game/Components/FighterSpawnComponent.h"
@@ -448,10 +449,6 @@ namespace SA
 
 	void ServerGameMode_CarrierTakedown::targetPlayerHeartBeat()
 	{
-		std::string BT_TargetKey = "target"; //#TODO need global lookup for these strings
-		std::string BT_AttackerKey = "activeAttackersKey";
-
-
 		targetPlayerHeartbeatData.accumulatedTime += targetPlayerHeartbeatConfig.heartBeatSec;
 
 		if (bool bWaitedLongEnough = targetPlayerHeartbeatData.accumulatedTime >= targetPlayerHeartbeatData.waitSec)
@@ -472,9 +469,9 @@ namespace SA
 						{
 							if (const BehaviorTree::Tree* tree = brain->getTree())
 							{
-								if (tree->getMemory().hasValue(BT_AttackerKey))
+								if (tree->getMemory().hasValue(BT_AttackersKey))
 								{
-									if (const BehaviorTree::ActiveAttackers* activeAttackers = tree->getMemory().getReadValueAs<BehaviorTree::ActiveAttackers>(BT_AttackerKey))
+									if (const BehaviorTree::ActiveAttackers* activeAttackers = tree->getMemory().getReadValueAs<BehaviorTree::ActiveAttackers>(BT_AttackersKey))
 									{
 										//BehaviorTree::cleanActiveAttackers(*activeAttackers);
 
@@ -502,7 +499,7 @@ namespace SA
 			myTeamData.clear();
 
 			//loop through all ships and find the carriers, then set those; this is going to be slow
-			const std::set<sp<WorldEntity>>& worldEntities = level->getWorldEntities();
+			const LevelBase::WorldEntitySet& worldEntities = level->getWorldEntities();
 			for (const sp<WorldEntity>& worldEntity : worldEntities)
 			{
 				sp<Ship> asShip = std::dynamic_pointer_cast<Ship>(worldEntity);
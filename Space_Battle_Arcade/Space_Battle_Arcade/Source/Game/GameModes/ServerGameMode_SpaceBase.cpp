@@ -2,6 +2,8 @@
 
 #include "Game/AI/GlobalSpaceArcadeBehaviorTreeKeys.h"
 #include "Game/AssetConfigs/DifficultyConfig.h"
+#include "Game/Components/FighterSpawnComponent.h"
+#include "Game/Components/ShipEnergyComponent.h"
 #include "Game/GameSystems/SAModSystem.h"
 #include "Game/Levels/SASpaceLevelBase.h"
 #include "Game/SAPlayer.h"
@@ -12,6 +14,7 @@
 #include "GameFramework/SAGameBase.h"
 #include "GameFramework/SAPlayerBase.h"
 #include "GameFramework/SAPlayerSystem.h"
+#include "GameFramework/SATeamSpatialQueries.h"
 #include "Rendering/Camera/SACameraBase.h"
 #include "Tools/Algorithms/AmortizeLoopTool.h"
 #include "Tools/PlatformUtils.h"
@@ -408,6 +411,59 @@ namespace SA
 		}
 		amort_fillUnfilledHits.updateStart(unfilledObjectiveHits);
 
+		/////////////////////////////////////////////////////////////////////////////////////
+		// find attacking and defending placements a target
+		// o(p * log n) : each placement asks the level for its nearest fighter rather than testing every ship against every placement
+		/////////////////////////////////////////////////////////////////////////////////////
+		if (turretsNeedingTarget.size() > 0 || healersNeedingTarget.size() > 0)
+		{
+			if (sp<SpaceLevelBase> level = weakOwningLevel.lock())
+			{
+				const TeamSpatialQueries& teamQueries = level->getTeamQueries();
+				static const TeamSpatialQueries::Filter fighterShipsOnly = [](const WorldEntity& entity)
+				{
+					return entity.hasGameComponent<ShipEnergyComponent>() && !entity.hasGameComponent<FighterSpawnComponent>();
+				};
+
+				size_t stopIdx = AMORTIZE_OBJECTIVE_TARGETING_IN_SHIP_WALK ? amort_turrets.getStopIdxSafe(turretsNeedingTarget) : turretsNeedingTarget.size();
+				size_t startIdx = AMORTIZE_OBJECTIVE_TARGETING_IN_SHIP_WALK ? amort_turrets.getStartIdx() : 0;
+
+				//walk backwards so swap and popback only moves turrets we have already visited (or are outside this tick's range)
+				for (size_t attackPlacementIdx = stopIdx; attackPlacementIdx > startIdx; --attackPlacementIdx)
+				{
+					//turret is guaranteed to be valid due to prefiltering at top of this function
+					lp<ShipPlacementEntity>& turret = turretsNeedingTarget[attackPlacementIdx - 1];
+					float maxDistance = glm::sqrt(turret->getMaxTargetDistance2());
+					if (teamQueries.kNearestEnemies(turret->getWorldPosition(), turret->getTeamData().team, 1, maxDistance, placementQueryScratch, placementQueryHits, fighterShipsOnly) > 0)
+					{
+						turret->setTarget(placementQueryHits[0].entity->requestTypedReference_Nonsafe<WorldEntity>());
+						if (!DEBUG_HITCH_NEVER_CLEAR_PLACEMENTS)
+						{
+							Utils::swapAndPopback(turretsNeedingTarget, attackPlacementIdx - 1);
+						}
+					}
+				}
+
+				stopIdx = AMORTIZE_OBJECTIVE_TARGETING_IN_SHIP_WALK ? amort_healers.getStopIdxSafe(healersNeedingTarget) : healersNeedingTarget.size();
+				startIdx = AMORTIZE_OBJECTIVE_TARGETING_IN_SHIP_WALK ? amort_healers.getStartIdx() : 0;
+
+				for (size_t defPlacementIdx = stopIdx; defPlacementIdx > startIdx; --defPlacementIdx)
+				{
+					//healer is guaranteed to be valid due to prefiltering at top of this function
+					lp<ShipPlacementEntity>& healer = healersNeedingTarget[defPlacementIdx - 1];
+					float maxDistance = glm::sqrt(healer->getMaxTargetDistance2());
+					if (teamQueries.kNearestAllies(healer->getWorldPosition(), healer->getTeamData().team, 1, maxDistance, placementQueryScratch, placementQueryHits, fighterShipsOnly) > 0)
+					{
+						healer->setTarget(placementQueryHits[0].entity->requestTypedReference_Nonsafe<WorldEntity>());
+						if (!DEBUG_HITCH_NEVER_CLEAR_PLACEMENTS)
+						{
+							Utils::swapAndPopback(healersNeedingTarget, defPlacementIdx - 1);
+						}
+					}
+				}
+			}
+		}
+
 		////////////////////////////////////////////////////////
 		// O(~n) : walk over ships
 		////////////////////////////////////////////////////////
@@ -421,8 +477,6 @@ namespace SA
 			//onWalkedShip.broadcast(ship); //probably should do this last as results could kill a ship and null it out?
 
 			bool bIsCarrier = ship->getFighterComp() != nullptr;
-			vec3 shipPosition = ship->getWorldPosition();
-			size_t shipTeam = ship->getTeam();
 
 			////////////////////////////////////////////////////////
 			// handle target player heartbeat
@@ -432,65 +486,6 @@ namespace SA
 				ship->TryTargetPlayer();
 			}
 
-			////////////////////////////////////////////////////////
-			// find attacking placements a target
-			// o(n*ap)
-			////////////////////////////////////////////////////////
-			if (turretsNeedingTarget.size() > 0 && !bIsCarrier)
-			{
-				std::optional<size_t> removeIdx;
-				for (size_t attackPlacementIdx = amort_turrets.getStartIdx();
-						attackPlacementIdx < turretsNeedingTarget.size() 
-						&& !removeIdx.has_value()
-						&& (AMORTIZE_OBJECTIVE_TARGETING_IN_SHIP_WALK && attackPlacementIdx < amort_turrets.getStopIdxNonsafe());
-					++attackPlacementIdx)
-				{
-					//turret is guaranteed to be valid due to prefiltering at top of this function
-					lp<ShipPlacementEntity>& turret = turretsNeedingTarget[attackPlacementIdx];
-					if (turret->getTeamData().team != shipTeam
-						&& glm::distance2(turret->getWorldPosition(), shipPosition) < turret->getMaxTargetDistance2())
-					{
-						sp<Ship> shipAsSP = ship;
-						turret->setTarget(shipAsSP);
-						removeIdx = attackPlacementIdx;
-					}
-				}
-				if (removeIdx.has_value() && !DEBUG_HITCH_NEVER_CLEAR_PLACEMENTS)
-				{
-					Utils::swapAndPopback(turretsNeedingTarget, *removeIdx);
-				}
-			}
-
-			////////////////////////////////////////////////////////
-			// find defending placements a target
-			// o(n*dp)
-			////////////////////////////////////////////////////////
-			if (healersNeedingTarget.size() > 0 && !bIsCarrier)
-			{
-				std::optional<size_t> removeIdx;
-				for (size_t defPlacementIdx = amort_healers.getStartIdx(); 
-						defPlacementIdx < healersNeedingTarget.size()
-						&& !removeIdx.has_value()
-						&& (AMORTIZE_OBJECTIVE_TARGETING_IN_SHIP_WALK && defPlacementIdx < amort_healers.getStopIdxNonsafe());
-					++defPlacementIdx)
-				{
-					//healer is guaranteed to be valid due to prefiltering at top of this function
-					lp<ShipPlacementEntity>& healer = healersNeedingTarget[defPlacementIdx];
-
-					if (healer->getTeamData().team == shipTeam
-						&& glm::distance2(healer->getWorldPosition(), shipPosition) < healer->getMaxTargetDistance2())
-					{
-						sp<Ship> shipAsSP = ship;
-						healer->setTarget(shipAsSP);
-						removeIdx = defPlacementIdx;
-					}
-				}
-				if (removeIdx.has_value() && !DEBUG_HITCH_NEVER_CLEAR_PLACEMENTS)
-				{
-					Utils::swapAndPopback(healersNeedingTarget, *removeIdx);
-				}
-			}
-
 			////////////////////////////////////////////////////////
 			// objective hits
 			////////////////////////////////////////////////////////
@@ -5,6 +5,7 @@
 #include "Game/SAShip.h" //must include this to use lifetime pointers ATOW #nextengine don't let lifetime points screw up using forward declarations
 #include "Tools/Algorithms/AmortizeLoopTool.h"
 #include "GameFramework/GameMode/ServerGameMode_Base.h"
+#include "GameFramework/SATeamSpatialQueries.h"
 
 namespace SA
 {
@@ -117,6 +118,8 @@ namespace SA
 		AmortizeLoopTool amort_fillUnfilledHits;
 		AmortizeLoopTool amort_processUnfilledHits;
 		AmortizeLoopTool amort_processFilledHits;
+		TeamSpatialQueries::QueryScratch placementQueryScratch;
+		std::vector<TeamSpatialQueries::Hit> placementQueryHits;
 	private: //time
 		float accumulatedTimeSec = 0.f;
 		float timestamp_lastPlayerTeamRefresh = 0.f;
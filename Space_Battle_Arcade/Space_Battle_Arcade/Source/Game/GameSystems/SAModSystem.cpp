@@ -1,7 +1,11 @@
 #include "SAModSystem.h"
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <set>
 #include <system_error>
 #include <sstream>
 
@@ -9,6 +13,10 @@
 #include "Game/AssetConfigs/SAProjectileConfig.h"
 #include "GameFramework/SALog.h"
 #include "GameFramework/SAGameBase.h"
+#include "GameFramework/SAAssetSystem.h"
+#include "GameFramework/SAAudioSystem.h"
+#include "GameFramework/Audio/AudioDecoder.h"
+#include "GameFramework/SAJobSystem.h"
 #include "Libraries/nlohmann/json.hpp"
 #include "Game/AssetConfigs/SASettingsProfileConfig.h"
 #include "Game/AssetConfigs/CampaignConfig.h"
@@ -20,6 +28,7 @@
 #include "Tools/PlatformUtils.h"
 #include "Game/SpaceArcade.h"
 #include "Game/Levels/LevelConfigs/SpaceLevelConfig.h"
+#include "Tools/ModelLoading/SACookedAsset.h"
 
 using json = nlohmann::json;
 
@@ -445,6 +454,21 @@ namespace SA
 		modName = newModName;
 	}
 
+	size_t Mod::resolveConfigReferences(PrivateKey key)
+	{
+		size_t numUnresolved = 0;
+		for (const auto& spawnConfigIter : spawnConfigsByName)
+		{
+			numUnresolved += spawnConfigIter.second->resolveReferences(SpawnConfig::PrivateKey{}, projectileConfigsByName, spawnConfigsByName);
+		}
+
+		if (numUnresolved > 0)
+		{
+			logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "Mod %s has %zu config references that name missing configs", modName.c_str(), numUnresolved);
+		}
+		return numUnresolved;
+	}
+
 	void Mod::postConstruct()
 	{
 		Parent::postConstruct();
@@ -465,6 +489,7 @@ namespace SA
 	void ModSystem::refreshModList()
 	{
 		std::map<std::string, sp<Mod>> deletedMods = loadedMods;
+		std::vector<sp<Mod>> newMods;
 
 		//std::cout << "mod system current path:" << std::filesystem::current_path().string() << std::endl;
 
@@ -529,7 +554,7 @@ namespace SA
 							if(loadedMods.find(modName) == loadedMods.end())
 							{
 								loadedMods.insert({ modName, mod });
-								loadConfigs(mod);
+								newMods.push_back(mod);
 							}
 							else
 							{
@@ -559,6 +584,9 @@ namespace SA
 		}
 
 		rebuildModArrayView();
+
+		//configs are parsed in the background; getActiveMod/getMods and the configs loaded future wait on them
+		startConfigLoads(newMods);
 	}
 
 	bool ModSystem::setActiveMod(const std::string& modName)
@@ -574,6 +602,11 @@ namespace SA
 		{
 			sp<Mod> newMod = requestModIter->second;
 
+			if (onActiveModChanging.numBound() > 0)
+			{
+				//listeners read configs from the new mod
+				waitForConfigLoads();
+			}
 			onActiveModChanging.broadcast(activeMod, newMod);
 
 			activeMod = newMod;
@@ -791,7 +824,8 @@ namespace SA
 
 	void ModSystem::shutdown()
 	{
-		
+		//jobs reference the pending load; let them finish before it is released
+		waitForConfigLoads();
 	}
 
 	void ModSystem::rebuildModArrayView()
@@ -804,53 +838,374 @@ namespace SA
 		}
 	}
 
-	/* 
-		@param assetLocation - should be relative to the mod directory; eg "Assets/SpawnConfigs/"
-	*/
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Async config loading
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	using LoadClock = std::chrono::steady_clock;
+
+	static double msSince(LoadClock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(LoadClock::now() - start).count();
+	}
+
+	struct ConfigCategory
+	{
+		/** relative to the mod directory; eg "Assets/SpawnConfigs/" */
+		const char* assetLocation = "";
+		std::function<sp<ConfigBase>()> factoryMethod;
+		std::function<void(Mod&, const sp<ConfigBase>&)> addToMod;
+	};
+
 	template<typename T>
-	static void loadConfig(sp<Mod>& mod,
-		const std::string& assetLocation,
-		void(Mod::*addConfigFunc)(const sp<T>&),
-		const std::function<sp<ConfigBase>()>& factoryMethod
-	)
+	static ConfigCategory makeConfigCategory(const char* assetLocation, void(Mod::*addConfigFunc)(const sp<T>&))
+	{
+		ConfigCategory category;
+		category.assetLocation = assetLocation;
+		category.factoryMethod = []() -> sp<ConfigBase> { return new_sp<T>(); };
+		category.addToMod = [addConfigFunc](Mod& mod, const sp<ConfigBase>& baseConfig)
+		{
+			//while I am trying dynamic casts, this should NOT be happening every tick and is probably okay; 
+			//alternatively ConfigBase could be a template, but that requires it to expose a lot to header (filesystem, etc).
+			if (sp<T> derivedConfig = std::dynamic_pointer_cast<T>(baseConfig))
+			{
+				(mod.*addConfigFunc)(derivedConfig);
+			}
+			else
+			{
+				log("ModSystem", LogLevel::LOG_ERROR, "Failed to typecast loaded config");
+			}
+		};
+		return category;
+	}
+
+	/** configs are added to a mod in this order; later categories may look up earlier ones when added */
+	static const std::vector<ConfigCategory>& getConfigCategories()
+	{
+		static const std::vector<ConfigCategory> categories = {
+			makeConfigCategory<SpawnConfig>("Assets/SpawnConfigs/", &Mod::addSpawnConfig),
+			makeConfigCategory<SpaceLevelConfig>("Assets/Levels/", &Mod::addLevelConfig),
+			makeConfigCategory<ProjectileConfig>("Assets/ProjectileConfigs/", &Mod::addProjectileConfig),
+			makeConfigCategory<SettingsProfileConfig>("Assets/Settings/", &Mod::addSettingsProfileConfig),
+			makeConfigCategory<CampaignConfig>("Assets/Campaigns/", &Mod::addCampaignConfig),
+			makeConfigCategory<SaveGameConfig>("GameSaves/", &Mod::addSaveGameConfig)
+		};
+		return categories;
+	}
+
+	/** reads a file through a small buffer so the OS has it cached by the time the game thread loads it; returns bytes read */
+	static size_t prefetchFile(const std::string& filePath)
+	{
+		std::ifstream file(filePath, std::ios::binary);
+		if (!file.is_open())
+		{
+			return 0;
+		}
+
+		char buffer[64 * 1024];
+		size_t totalBytes = 0;
+		while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+		{
+			totalBytes += size_t(file.gcount());
+		}
+		return totalBytes;
+	}
+
+	struct ModSystem::PendingConfigLoad
 	{
-		const std::string CONFIG_DIR = mod->getModDirectoryPath() + assetLocation;  
+		struct ConfigFile
+		{
+			sp<Mod> mod;
+			sp<ConfigBase> config;
+			std::string filePath;
+			size_t categoryIdx = 0;
+
+			//written by the job that parses this file
+			bool bLoaded = false;
+			double parseMs = 0.0;
+		};
+
+		struct SoundFile
+		{
+			std::string filePath;
+			sp<SoundRawData> decoded = nullptr;
+			float durationSec = 0.f;
+			bool bMeasured = false; //false if the file could not be opened
+		};
+
+		std::vector<ConfigFile> configFiles;
+		std::vector<sp<Mod>> mods;
+		bool bDecodeSounds = false;
+
+		//written by the prefetch job once parsing is done; only read on the game thread after prefetchJobs finishes
+		std::vector<std::string> modelFiles;
+		std::vector<SoundFile> soundFiles;
+		std::atomic<size_t> prefetchedBytes{ 0 };
+		double parseWallMs = 0.0;
+		double prefetchWallMs = 0.0;
+
+		LoadClock::time_point startTime;
+		double gameThreadWaitMs = 0.0;
+
+		JobCounter parseJobs;
+		JobCounter prefetchJobs;
+	};
+
+	void ModSystem::startConfigLoads(const std::vector<sp<Mod>>& newMods)
+	{
+		//a refresh while a load is in flight publishes that load first so configs are always added in discovery order
+		waitForConfigLoads();
+
+		const bool bPreviousLoadPublished = configsLoadedFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		if (newMods.empty())
+		{
+			if (!bPreviousLoadPublished)
+			{
+				configsLoadedPromise.set_value(); //nothing to load
+			}
+			return;
+		}
 
-		std::error_code dir_iter_ec;
-		for (const std::filesystem::directory_entry& directory_entry : std::filesystem::directory_iterator(CONFIG_DIR, dir_iter_ec))
+		if (bPreviousLoadPublished)
 		{
-			const std::filesystem::path& filePathObj = directory_entry.path();
-			if (filePathObj.has_extension() && filePathObj.extension().string() == ".json")
+			//waiters on the old future are done; hand out a new one for this load
+			configsLoadedPromise = std::promise<void>{};
+			configsLoadedFuture = configsLoadedPromise.get_future().share();
+		}
+
+		sp<PendingConfigLoad> load = new_sp<PendingConfigLoad>();
+		load->startTime = LoadClock::now();
+		load->mods = newMods;
+#if USE_OPENAL_API
+		load->bDecodeSounds = !GameBase::isHeadless();
+#endif //USE_OPENAL_API
+
+		//enumerate and construct on the game thread; config constructors may touch engine systems (eg the window system)
+		const std::vector<ConfigCategory>& categories = getConfigCategories();
+		for (const sp<Mod>& mod : newMods)
+		{
+			for (size_t categoryIdx = 0; categoryIdx < categories.size(); ++categoryIdx)
 			{
-				sp<ConfigBase> baseConfig = ConfigBase::load(filePathObj.string(), factoryMethod);
+				const std::string CONFIG_DIR = mod->getModDirectoryPath() + categories[categoryIdx].assetLocation;
 
-				//while I am trying dynamic casts, this should NOT be happening every tick and is probably okay; 
-				//alternatively ConfigBase could be a template, but that requires it to expose a lot to header (filesystem, etc).
-				if (sp<T> derivedConfig = std::dynamic_pointer_cast<T>(baseConfig))
+				std::error_code dir_iter_ec;
+				for (const std::filesystem::directory_entry& directory_entry : std::filesystem::directory_iterator(CONFIG_DIR, dir_iter_ec))
 				{
-					((*mod).*addConfigFunc)(derivedConfig);
+					const std::filesystem::path& filePathObj = directory_entry.path();
+					if (filePathObj.has_extension() && filePathObj.extension().string() == ".json")
+					{
+						PendingConfigLoad::ConfigFile configFile;
+						configFile.mod = mod;
+						configFile.config = categories[categoryIdx].factoryMethod();
+						configFile.filePath = filePathObj.string();
+						configFile.categoryIdx = categoryIdx;
+						load->configFiles.push_back(std::move(configFile));
+					}
 				}
-				else
+				if (dir_iter_ec)
 				{
-					log("ModSystem", LogLevel::LOG_ERROR, "Failed to typecast loaded config");
+					log("ModSystem", LogLevel::LOG_ERROR, "Failed to create a directory iterator over files in startConfigLoads.");
 				}
 			}
 		}
-		if (dir_iter_ec)
+
+		//jobs hold a raw pointer; the load is only released after both counters are waited on
+		PendingConfigLoad* loadPtr = load.get();
+		JobSystem& jobSystem = GameBase::get().getJobSystem();
+
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		// parse each config file in its own job; each job only touches its own config object
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		for (size_t fileIdx = 0; fileIdx < load->configFiles.size(); ++fileIdx)
 		{
-			log("ModSystem", LogLevel::LOG_ERROR, "Failed to create a directory iterator over files in loadConfig.");
+			jobSystem.run([loadPtr, fileIdx]()
+			{
+				PendingConfigLoad::ConfigFile& configFile = loadPtr->configFiles[fileIdx];
+				LoadClock::time_point parseStart = LoadClock::now();
+				try
+				{
+					configFile.bLoaded = configFile.config->loadFromFile(configFile.filePath);
+				}
+				catch (const std::exception&)
+				{
+					//malformed json; reported when the load publishes, logging is not thread safe
+					configFile.bLoaded = false;
+				}
+				configFile.parseMs = msSince(parseStart);
+			}, &load->parseJobs);
 		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		// once parsed, warm up the files the configs reference and decode their sounds
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		jobSystem.runAfter(load->parseJobs, [loadPtr, &jobSystem]()
+		{
+			loadPtr->parseWallMs = msSince(loadPtr->startTime);
+
+			std::set<std::string> modelFiles;
+			std::set<std::string> soundFiles;
+			for (const PendingConfigLoad::ConfigFile& configFile : loadPtr->configFiles)
+			{
+				SpawnConfig* spawnConfig = dynamic_cast<SpawnConfig*>(configFile.config.get());
+				if (!configFile.bLoaded || !spawnConfig)
+				{
+					continue;
+				}
+
+				//match the paths the game thread will later load with, so cached entries are hit
+				const std::string modDir = configFile.mod->getModDirectoryPath() + std::string("/");
+				if (spawnConfig->getModelFilePath().size() > 0)
+				{
+					modelFiles.insert(spawnConfig->getModelFilePath());
+				}
+				for (const CollisionShapeSubConfig& shape : spawnConfig->getCollisionShapes())
+				{
+					if (shape.modelFilePath.size() > 0)
+					{
+						modelFiles.insert(modDir + shape.modelFilePath);
+					}
+				}
+				for (const SoundEffectSubConfig* sfx : { &spawnConfig->getConfig_sfx_engineLoop(), &spawnConfig->getConfig_sfx_projectileLoop(), &spawnConfig->getConfig_sfx_explosion(), &spawnConfig->getConfig_sfx_muzzle() })
+				{
+					if (sfx->assetPath.size() > 0)
+					{
+						soundFiles.insert(modDir + sfx->assetPath);
+					}
+				}
+			}
+
+			loadPtr->modelFiles.assign(modelFiles.begin(), modelFiles.end());
+			for (const std::string& soundFile : soundFiles)
+			{
+				loadPtr->soundFiles.push_back(PendingConfigLoad::SoundFile{ soundFile, nullptr });
+			}
+
+			//models are only warmed; constructing them uploads to the GPU, which must happen on the game thread
+			for (size_t modelIdx = 0; modelIdx < loadPtr->modelFiles.size(); ++modelIdx)
+			{
+				jobSystem.run([loadPtr, modelIdx]()
+				{
+					const std::string& modelFile = loadPtr->modelFiles[modelIdx];
+					size_t numBytes = CookedAsset::open(modelFile) ? prefetchFile(getCookedPath(modelFile)) : prefetchFile(modelFile);
+					loadPtr->prefetchedBytes.fetch_add(numBytes, std::memory_order_relaxed);
+				}, &loadPtr->prefetchJobs);
+			}
+
+			for (size_t soundIdx = 0; soundIdx < loadPtr->soundFiles.size(); ++soundIdx)
+			{
+				jobSystem.run([loadPtr, soundIdx]()
+				{
+					PendingConfigLoad::SoundFile& soundFile = loadPtr->soundFiles[soundIdx];
+					//measuring mp3 length scans the file; do it once here, off the game thread, and hand it to the audio system
+					if (sp<AudioDecoder> header = AudioDecoder::open(soundFile.filePath))
+					{
+						soundFile.durationSec = header->getDurationSec();
+						soundFile.bMeasured = true;
+					}
+					if (loadPtr->bDecodeSounds && !(soundFile.bMeasured && AudioSystem::shouldStreamSound(soundFile.durationSec, /*bIsMusic*/false)))
+					{
+						soundFile.decoded = AssetSystem::decodeSound(soundFile.filePath);
+					}
+					else
+					{
+						loadPtr->prefetchedBytes.fetch_add(prefetchFile(soundFile.filePath), std::memory_order_relaxed);
+					}
+				}, &loadPtr->prefetchJobs);
+			}
+		}, &load->prefetchJobs);
+
+		pendingConfigLoad = load;
 	}
 
+	void ModSystem::waitForConfigLoads()
+	{
+		if (!pendingConfigLoad)
+		{
+			return;
+		}
+
+		LoadClock::time_point waitStart = LoadClock::now();
+		JobSystem& jobSystem = GameBase::get().getJobSystem();
+		jobSystem.waitFor(pendingConfigLoad->parseJobs);
+		jobSystem.waitFor(pendingConfigLoad->prefetchJobs);
+		pendingConfigLoad->gameThreadWaitMs += msSince(waitStart);
+
+		publishConfigLoads();
+	}
+
+	void ModSystem::tick(float deltaSec)
+	{
+		if (pendingConfigLoad && pendingConfigLoad->parseJobs.isDone() && pendingConfigLoad->prefetchJobs.isDone())
+		{
+			waitForConfigLoads();
+		}
+	}
 
-	void ModSystem::loadConfigs(sp<Mod>& mod)
+	void ModSystem::publishConfigLoads()
 	{
-		loadConfig<SpawnConfig>(mod, "Assets/SpawnConfigs/", &Mod::addSpawnConfig, [](){ return new_sp<SpawnConfig>(); });
-		loadConfig<SpaceLevelConfig>(mod, "Assets/Levels/", &Mod::addLevelConfig, []() { return new_sp<SpaceLevelConfig>(); });
-		loadConfig<ProjectileConfig>(mod, "Assets/ProjectileConfigs/", &Mod::addProjectileConfig, []() { return new_sp<ProjectileConfig>(); });
-		loadConfig<SettingsProfileConfig>(mod, "Assets/Settings/", &Mod::addSettingsProfileConfig, []() { return new_sp<SettingsProfileConfig>(); });
-		loadConfig<CampaignConfig>(mod, "Assets/Campaigns/", &Mod::addCampaignConfig, []() { return new_sp<CampaignConfig>(); });
-		loadConfig<SaveGameConfig>(mod, "GameSaves/", &Mod::addSaveGameConfig, []() { return new_sp<SaveGameConfig>(); });
+		//clear the pending load first; adding configs may call back into getActiveMod/getMods
+		sp<PendingConfigLoad> load = pendingConfigLoad;
+		pendingConfigLoad = nullptr;
+
+		LoadClock::time_point publishStart = LoadClock::now();
+		const std::vector<ConfigCategory>& categories = getConfigCategories();
+
+		std::vector<size_t> filesPerCategory(categories.size(), 0);
+		std::vector<double> parseMsPerCategory(categories.size(), 0.0);
+		size_t numFailed = 0;
+		for (const PendingConfigLoad::ConfigFile& configFile : load->configFiles)
+		{
+			filesPerCategory[configFile.categoryIdx] += 1;
+			parseMsPerCategory[configFile.categoryIdx] += configFile.parseMs;
+
+			if (configFile.bLoaded)
+			{
+				categories[configFile.categoryIdx].addToMod(*configFile.mod, configFile.config);
+			}
+			else
+			{
+				++numFailed;
+				logf_sa(__FUNCTION__, LogLevel::LOG_ERROR, "Failed to load config %s", configFile.filePath.c_str());
+			}
+		}
+
+		size_t numUnresolved = 0;
+		for (const sp<Mod>& mod : load->mods)
+		{
+			numUnresolved += mod->resolveConfigReferences(Mod::PrivateKey{});
+		}
+
+		size_t numDecodedSounds = 0;
+		AssetSystem& assetSystem = GameBase::get().getAssetSystem();
+		AudioSystem& audioSystem = GameBase::get().getAudioSystem();
+		for (const PendingConfigLoad::SoundFile& soundFile : load->soundFiles)
+		{
+			if (soundFile.bMeasured)
+			{
+				audioSystem.cacheSoundDuration(soundFile.filePath, soundFile.durationSec);
+			}
+			if (soundFile.decoded)
+			{
+				assetSystem.addDecodedSound(soundFile.filePath, soundFile.decoded);
+				++numDecodedSounds;
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		// load profile
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		logf_sa(__FUNCTION__, LogLevel::LOG, "Loaded %zu config files from %zu mods (%zu failed, %zu unresolved references) in %.2fms; parse %.2fms, game thread blocked %.2fms, publish %.2fms",
+			load->configFiles.size(), load->mods.size(), numFailed, numUnresolved, msSince(load->startTime), load->parseWallMs, load->gameThreadWaitMs, msSince(publishStart));
+		for (size_t categoryIdx = 0; categoryIdx < categories.size(); ++categoryIdx)
+		{
+			if (filesPerCategory[categoryIdx] > 0)
+			{
+				logf_sa(__FUNCTION__, LogLevel::LOG, "\t%s: %zu files, %.2fms parsing", categories[categoryIdx].assetLocation, filesPerCategory[categoryIdx], parseMsPerCategory[categoryIdx]);
+			}
+		}
+		logf_sa(__FUNCTION__, LogLevel::LOG, "\tprefetched %zu models and %zu sounds (%zu decoded), %zu bytes read",
+			load->modelFiles.size(), load->soundFiles.size(), numDecodedSounds, load->prefetchedBytes.load(std::memory_order_relaxed));
+
+		configsLoadedPromise.set_value();
 	}
 
 	//void ModSystem::loadSpawnConfigs(sp<Mod>& mod)
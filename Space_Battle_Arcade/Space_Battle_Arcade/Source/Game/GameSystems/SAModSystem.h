@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include <map>
 #include <vector>
 #include <string>
@@ -161,6 +162,9 @@ namespace SA
 
 	public: //locked methods for construction
 		void setModName(PrivateKey key, const std::string& newModName);
+
+		/** Binds config references by name once all of this mod's configs are added. Returns the number of names that did not resolve. */
+		size_t resolveConfigReferences(PrivateKey key);
 	protected:
 		virtual void postConstruct() override;
 	private:
@@ -196,7 +200,7 @@ namespace SA
 		/* returns true if requested mod is now the active mod */
 		bool setActiveMod(const std::string& modName);
 		void writeModConfigFile();
-		const sp<Mod>& getActiveMod() { return activeMod; }
+		const sp<Mod>& getActiveMod() { if (pendingConfigLoad) { waitForConfigLoads(); } return activeMod; }
 
 		bool createNewMod(const std::string& modName);
 		bool deleteMod(const std::string& modName);
@@ -204,17 +208,35 @@ namespace SA
 		/** Be mindful of adding adding/removing mods while iterating over this array; 
 		it is a view of the current mod list, not the actual container. 
 		Changes to the mod list will influence the return value that will invalidate any iterators*/
-		inline const std::vector<sp<Mod>>& getMods() { return modArrayView; }
+		inline const std::vector<sp<Mod>>& getMods() { if (pendingConfigLoad) { waitForConfigLoads(); } return modArrayView; }
+
+		////////////////////////////////////////////////////////
+		// Async config loading
+		//	Config files are parsed on the job system and their models/sounds prefetched; 
+		//	results are added to mods on the game thread once every job is done.
+		////////////////////////////////////////////////////////
+		/** Becomes ready once the configs found by the latest refreshModList are added to their mods. */
+		std::shared_future<void> getConfigsLoadedFuture() const { return configsLoadedFuture; }
+		bool hasPendingConfigLoads() const { return pendingConfigLoad != nullptr; }
+
+		/** Game thread only. Helps the job system finish any pending loads, then publishes them. No-op when nothing is pending. */
+		void waitForConfigLoads();
 
 	private:
 		virtual void initSystem() override;
+		virtual void tick(float deltaSec) override;
 		virtual void shutdown() override;
 
 		void rebuildModArrayView();
 
-		void loadConfigs(sp<Mod>& mod);
-		//void loadSpawnConfigs(sp<Mod>& mod);
+		void startConfigLoads(const std::vector<sp<Mod>>& newMods);
+		void publishConfigLoads();
 	private:
+		struct PendingConfigLoad;
+		sp<PendingConfigLoad> pendingConfigLoad = nullptr;
+		std::promise<void> configsLoadedPromise;
+		std::shared_future<void> configsLoadedFuture = configsLoadedPromise.get_future().share();
+
 		sp<Mod> activeMod = nullptr;
 
 		//Mods
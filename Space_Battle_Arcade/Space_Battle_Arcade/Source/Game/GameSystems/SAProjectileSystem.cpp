@@ -19,49 +19,52 @@
 #include "Rendering/DeferredRendering/DeferredRendererStateMachine.h"
 #include "Rendering/DeferredRendering/DeferredRenderingShaders.h"
 #include "Rendering/RenderData.h"
+#include "Rendering/ModelInstanceBuffer.h"
 #include "Tools/PlatformUtils.h"
 
 namespace SA
 {
 	///////////////////////////////////////////////////////////////////////////////////////////////
-	// Actual Projectile Instances; these system is responsible for creating these instances
+	// Projectile simulation
 	///////////////////////////////////////////////////////////////////////////////////////////////
-	void Projectile::tick(float dt_sec, LevelBase& currentLevel)
+	void ProjectileSystem::tickProjectile(size_t projectileIdx, float dt_sec)
 	{
-		using glm::mat4; using glm::vec3; using glm::quat; using glm::vec4;
+		//a projectile that hit something last frame was already stretched to the hit location; let it render for a frame then release it
+		if (activeProjectiles.flags[projectileIdx] & ProjectileStore::FLAG_HIT)
+		{
+			activeProjectiles.flags[projectileIdx] |= ProjectileStore::FLAG_FORCE_RELEASE;
+			segmentStarts[projectileIdx] = activeProjectiles.positions[projectileIdx];
+			return;
+		}
 
-		//#optimize perhaps cache level system in local static for perf; profiler may cacn help to determine if this is worth it
-		timeAlive += dt_sec;
+		activeProjectiles.timesAlive[projectileIdx] += dt_sec;
 
-		float dt_distance = dt_sec * speed;
+		float dt_distance = dt_sec * activeProjectiles.speeds[projectileIdx];
 
-		stretchToDistance(dt_distance, true, currentLevel);
+		segmentStarts[projectileIdx] = stretchToDistance(projectileIdx, dt_distance);
 	}
 
-	void Projectile::stretchToDistance(float dt_distance, float bDoCollisionTest, LevelBase& currentLevel)
+	glm::vec3 ProjectileSystem::stretchToDistance(size_t idx, float dt_distance)
 	{
 		using glm::mat4; using glm::vec3; using glm::quat; using glm::vec4;
 
-		//if the projectile hit its target, change logic so it just stretches to hit location
-		if (bHit)
-		{
-			forceRelease = true;
-			return;
-		}
+		ProjectileStore& store = activeProjectiles;
 
 		//#optimize investigate whether some of the matrices below can be cached once (eg fire rotation? offsetDirection?)
-		vec3 start = xform.position;
+		const vec3 direction_n = store.directions_n[idx];
+		vec3 start = store.positions[idx];
 
-		if(bCorrectPosition)
+		if(store.flags[idx] & ProjectileStore::FLAG_CORRECT_POSITION)
 		{
-			vec3 originalOffset_v = offsetStartPos - traceStartPos;
-			vec3 toCurPos_v = xform.position - traceStartPos; //hypotenuse 
+			const vec3& traceStartPos = store.traceStartPositions[idx];
+			vec3 originalOffset_v = store.offsetStartPositions[idx] - traceStartPos;
+			vec3 toCurPos_v = start - traceStartPos; //hypotenuse 
 			vec3 projOntoCenteredLine_v = Utils::project(toCurPos_v, direction_n); //ie the line as if we fired from center of ship, 
 
 
 			//consider the triangle made from the projection, and the vector to current position from trace start. the "opposite" line is same as in SOA 
 			vec3 triOpposite_v = toCurPos_v - projOntoCenteredLine_v;
-			float blendAlpha = glm::clamp(1.f - glm::length(projOntoCenteredLine_v) / offsetTraceCorrectionDistance, 0.f, 1.f); //[0,1]
+			float blendAlpha = glm::clamp(1.f - glm::length(projOntoCenteredLine_v) / store.offsetTraceCorrectionDistances[idx], 0.f, 1.f); //[0,1]
 			vec3 correctedPosition = (blendAlpha * originalOffset_v) + projOntoCenteredLine_v + traceStartPos;
 
 			//slide this position into place so that it gradually aligns with the trace from center of spawn
@@ -69,10 +72,10 @@ namespace SA
 		}
 
 		vec3 end = start + dt_distance * direction_n;
-		vec3 offsetDir = glm::normalize(start - end);
 		float offsetLength = dt_distance / 2;
 		vec3 zOffset = vec3(0, 0, offsetLength);
 
+		const vec3& aabbSize = store.aabbSizes[idx];
 		vec3 modelScaleStrech(1.f);
 		modelScaleStrech.z = dt_distance / aabbSize.z;
 
@@ -80,116 +83,60 @@ namespace SA
 		collisionBoxScaleStretch.z = dt_distance;
 
 		mat4 transToEnd_rotToFireDir_zOffset = glm::translate(glm::mat4(1.f), end);
-		transToEnd_rotToFireDir_zOffset = transToEnd_rotToFireDir_zOffset * glm::toMat4(directionQuat); //#TODO this could also be xform.rot... which to use?
+		transToEnd_rotToFireDir_zOffset = transToEnd_rotToFireDir_zOffset * glm::toMat4(store.directionQuats[idx]);
 		transToEnd_rotToFireDir_zOffset = glm::translate(transToEnd_rotToFireDir_zOffset, zOffset);
 
 		//model matrix composition: translateToEnd * rotateToFireDirection * OffsetZValueSoTipAtPoint * StretchToFitDistance
-		collisionXform = glm::scale(transToEnd_rotToFireDir_zOffset, collisionBoxScaleStretch);
-		renderXform = glm::scale(transToEnd_rotToFireDir_zOffset, modelScaleStrech);
+		store.collisionXforms[idx] = glm::scale(transToEnd_rotToFireDir_zOffset, collisionBoxScaleStretch);
+		store.renderXforms[idx] = glm::scale(transToEnd_rotToFireDir_zOffset, modelScaleStrech);
 
 		// models parallel to z
-		xform.position = end;
+		store.positions[idx] = end;
 #if _WIN32 && _DEBUG
 		if (Utils::anyValueNAN(start)){__debugbreak();}
 		if (Utils::anyValueNAN(end)) {__debugbreak();}
 #endif //_WIN32
 
-		if (soundEmitter)
+		ProjectileAttachments& attachments = store.getAttachments(idx);
+		if (attachments.soundEmitter)
 		{
-			soundEmitter->setPosition(end);
-			soundEmitter->setVelocity(speed * direction_n);
+			attachments.soundEmitter->setPosition(end);
+			attachments.soundEmitter->setVelocity(store.speeds[idx] * direction_n);
 		}
 
-		if (pointLight)
+		if (attachments.pointLight)
 		{
-			pointLight->setPosition(end);
+			attachments.pointLight->setPosition(end);
 		}
 
-		//collision check
-		if (bDoCollisionTest && !bHit)
-		{
-			SH::SpatialHashGrid<WorldEntity>& worldGrid = currentLevel.getWorldGrid();
-
-			/* #optimize #alternative collision. perhaps simple ray casts would be faster; it will require that triangles for collision shapes are available
-				This method isn't going to be ideal for large structures, because the distance to the center of the shape collided with isn't going
-				to produce a distance to generate an accurate end point; a ray trace will however. Plus it will probably be more efficient than
-				a cube x cube collision test.
-			*/
-			std::vector<std::shared_ptr<const SH::HashCell<WorldEntity>>> cells;
-			worldGrid.lookupCellsForLine(start, end, cells);
-
-			//#optimize below may be slow; but don't want a bunch of collisions with same objects that occupy large # of cells (eg large ship)
-			static std::set<WorldEntity*> potentialCollisions;
-			potentialCollisions.clear(); //absolute must do this since it is a static local
-
-			for (sp<const SH::HashCell<WorldEntity>> cell : cells)
-			{
-				for (std::shared_ptr<SH::GridNode<WorldEntity>> gridNode : cell->nodeBucket)
-				{
-					potentialCollisions.insert(&gridNode->element);
-				}
-			}
-
-			static sp<SAT::Shape> projectileShape = new_sp<SAT::CubeShape>();
-			projectileShape->updateTransform(collisionXform);
-
-			float smallestDistanceCollision_2 = std::numeric_limits<float>::infinity();
-			WorldEntity* collidingEntity = nullptr;
-
-			for (WorldEntity* entity : potentialCollisions)
-			{
-				CollisionComponent* collisionComp = entity->getGameComponent<CollisionComponent>();
-				if (collisionComp && entity != owner.get())
-				{
-					const CollisionData* colisionData = collisionComp->getCollisionData();
-					const sp<const SAT::Shape>& OBBShape = colisionData->getOBBShape();
-
-					glm::vec4 obbMTV;
-					if (SAT::Shape::CollisionTest(*projectileShape, *OBBShape, obbMTV))
-					{
-						//#TODO perhaps this shouldn't find the closest shape it collided with? will be redundant
-						for (const CollisionData::ConstShapeData& shapeData : colisionData->getConstShapeData())
-						{
-							glm::vec4 mtv;
-							if (SAT::Shape::CollisionTest(*projectileShape, *shapeData.shape, mtv))
-							{
-								vec3 shapeOrigin = vec3(shapeData.shape->getTransformedOrigin());
-
-								//it would be better to use distance the contact point, but that isn't available in my SAT implementation
-								//perhaps I will change that if I figure out an efficient means to get the contact point
-								float distToShapOri = glm::length2(shapeOrigin - start); //get distance from start to shape ori
-								if (distToShapOri < smallestDistanceCollision_2)
-								{
-									smallestDistanceCollision_2 = distToShapOri;
-									collidingEntity = entity;
-								}
-							}
-						}
-					}
-				}
-			}
+		return start;
+	}
 
-			if (collidingEntity)
-			{
-				float maxHitDistance = 10.f; //I believe with large shapes this doesn't look good, so clamp it. it is using distance to shape origin.
-				float hitDistance = glm::clamp<float>(glm::sqrt(smallestDistanceCollision_2), 0.f, maxHitDistance);
-				glm::vec3 hit = start + (-offsetDir * hitDistance / 2.f); //div by 2 may not be right theoretically, but hit distance appears too far and this seems to fix
+	void ProjectileSystem::resolveProjectileHit(const ProjectileCollisionPhase::Hit& hit)
+	{
+		//note: don't hold references into the store across the hit notification, a hit may spawn projectiles and reallocate the arrays
+		const size_t idx = hit.projectileIdx;
+		const glm::vec3 start = segmentStarts[idx];
+		const glm::vec3 hitLocation = start + activeProjectiles.directions_n[idx] * hit.hitDistance;
 
-				//#TODO #componentize this interface to be a component to avoid dynamic cast. This will require comp delegate notify owner though, which may be slower than dyn cast; profiling and optimizatin likely needed.
-				if (IProjectileHitNotifiable* toNotify = dynamic_cast<IProjectileHitNotifiable*>(collidingEntity))
-				{
-					toNotify->notifyProjectileCollision(*this, hit);
-				}
+		//#TODO #componentize this interface to be a component to avoid dynamic cast. This will require comp delegate notify owner though, which may be slower than dyn cast; profiling and optimizatin likely needed.
+		if (IProjectileHitNotifiable* toNotify = dynamic_cast<IProjectileHitNotifiable*>(hit.entity))
+		{
+			Projectile hitProjectile;
+			hitProjectile.position = activeProjectiles.positions[idx];
+			hitProjectile.direction_n = activeProjectiles.directions_n[idx];
+			hitProjectile.damage = activeProjectiles.damages[idx];
+			hitProjectile.team = activeProjectiles.teams[idx];
+			hitProjectile.owner = projectileOwners.resolve(activeProjectiles.ownerIds[idx]);
+			toNotify->notifyProjectileCollision(hitProjectile, hitLocation);
+		}
 
-				//recalculate end point etc so visuals don't go through
-				xform.position = start;
-				stretchToDistance(hitDistance, false, currentLevel);
+		//recalculate end point etc so visuals don't go through
+		activeProjectiles.positions[idx] = start;
+		stretchToDistance(idx, hit.hitDistance);
 
-				//make sure this projectile will expire on next tick!
-				hitLocation = hit;
-				bHit = true;
-			}
-		}
+		//make sure this projectile will expire on next tick!
+		activeProjectiles.flags[idx] |= ProjectileStore::FLAG_HIT;
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -204,48 +151,64 @@ namespace SA
 
 			if (!worldTM->isTimeFrozen())
 			{
-				auto iter = std::begin(activeProjectiles);
-				auto end = std::end(activeProjectiles);
-				while (iter != end)
+				const float dt_sec = worldTM->getDeltaTimeSecs();
+
+				//move every projectile first so collision can be tested as one batch
+				const size_t numTickedProjectiles = activeProjectiles.size();
+				segmentStarts.resize(numTickedProjectiles);
+				for (size_t projectileIdx = 0; projectileIdx < numTickedProjectiles; ++projectileIdx)
+				{
+					tickProjectile(projectileIdx, dt_sec);
+				}
+
+				collisionPhase.run(activeProjectiles, segmentStarts, projectileOwners, currentLevel->getWorldGrid(), frameHits);
+
+				//hit notifications may spawn projectiles; those are appended so the dense indices of the hits stay valid until removal below
+				for (const ProjectileCollisionPhase::Hit& hit : frameHits)
+				{
+					resolveProjectileHit(hit);
+				}
+
+				//removal swaps the last projectile into the current index, so only advance when nothing was removed
+				size_t projectileIdx = 0;
+				while (projectileIdx < activeProjectiles.size())
 				{
-					//since projectiles may expire, we want need to remove them from the set of active projectiles
-					//we can do this while iterating over std::set, but we need to take care. Removing an interator
-					//only invalidates that iterator, but if it is invalidated we cannot get the next iterator from it.
-					//So, we copy the iterator and immediately get the next iterator; meaning removing the copy doesn't
-					//affect our ability to get the next iterator
-					auto iterCopy = iter;
-					++iter; 
-					
-					const sp<Projectile>& projectile = *iterCopy;
-					projectile->tick(worldTM->getDeltaTimeSecs(), *currentLevel);
-
-					if (projectile->timeAlive > projectile->lifetimeSec || projectile->forceRelease)
+					bool bExpired = activeProjectiles.timesAlive[projectileIdx] > activeProjectiles.lifetimeSecs[projectileIdx];
+					bool bForceRelease = activeProjectiles.flags[projectileIdx] & ProjectileStore::FLAG_FORCE_RELEASE;
+					if (bExpired || bForceRelease)
+					{
+						releaseProjectile(projectileIdx);
+					}
+					else
 					{
-						if (projectile->soundEmitter)
-						{
-							projectile->soundEmitter->stop();
-							sfxPool.releaseInstance(projectile->soundEmitter);
-							projectile->soundEmitter = nullptr;
-						}
-
-						if (projectile->pointLight)
-						{
-							lightPool.releaseInstance(projectile->pointLight);
-							projectile->pointLight = nullptr;
-						}
-				
-						//note: this projectile will keep any sp alive, so clear before release if needed
-						objPool.releaseInstance(projectile);
-
-						//removing iterator from set does not invalidate other iterators; 
-						//IMPORANT: this must after releasing to pool, otherwise the smart pointer will be deleted
-						activeProjectiles.erase(iterCopy); //#TODO #performance swap and pop will probably greatly speed this up; there might be a reason we need it in a set though
+						++projectileIdx;
 					}
 				}
 			}
 		}
 	}
 
+	void ProjectileSystem::releaseProjectile(size_t projectileIdx)
+	{
+		ProjectileAttachments& attachments = activeProjectiles.getAttachments(projectileIdx);
+		if (attachments.soundEmitter)
+		{
+			attachments.soundEmitter->stop();
+			sfxPool.releaseInstance(attachments.soundEmitter);
+		}
+
+		if (attachments.pointLight)
+		{
+			attachments.pointLight->getMutableUserData().bActive = false; //pooled lights stay registered with the render system
+			lightPool.releaseInstance(attachments.pointLight);
+		}
+
+		projectileOwners.release(activeProjectiles.ownerIds[projectileIdx]);
+
+		//store clears the attachments of the removed slot
+		activeProjectiles.removeAt(projectileIdx);
+	}
+
 	void ProjectileSystem::handlePostLevelChange(const sp<LevelBase>& previousLevel, const sp<LevelBase>& newCurrentLevel)
 	{
 		sfxPool.clear();
@@ -256,13 +219,21 @@ namespace SA
 		RenderSystem& renderSystem = GameBase::get().getRenderSystem();
 		if (const RenderData* frd = renderSystem.getFrameRenderData_Read(GameBase::get().getFrameNumber()))
 		{
+			if (frd->projectileInstances.size() == 0)
+			{
+				return;
+			}
+			instanceBuffer->upload(frd->projectileInstances);
+
 			if (DeferredRendererStateMachine* deferredRenderer = renderSystem.getDeferredRenderer())
 			{
 				if (deferedShaded_EmissiveModelShader)
 				{
 					deferedShaded_EmissiveModelShader->use();
 					deferredRenderer->configureShaderForGBufferWrite(*deferedShaded_EmissiveModelShader);
-					renderProjectiles(*deferedShaded_EmissiveModelShader);
+					deferedShaded_EmissiveModelShader->setUniformMatrix4fv("view", 1, GL_FALSE, glm::value_ptr(frd->view));
+					deferedShaded_EmissiveModelShader->setUniformMatrix4fv("projection", 1, GL_FALSE, glm::value_ptr(frd->projection));
+					renderProjectiles(*deferedShaded_EmissiveModelShader, *frd);
 				}
 				else { STOP_DEBUGGER_HERE(); }
 			}
@@ -274,7 +245,7 @@ namespace SA
 					forwardShaded_EmissiveModelShader->use();
 					forwardShaded_EmissiveModelShader->setUniformMatrix4fv("view", 1, GL_FALSE, glm::value_ptr(frd->view));
 					forwardShaded_EmissiveModelShader->setUniformMatrix4fv("projection", 1, GL_FALSE, glm::value_ptr(frd->projection));
-					renderProjectiles(*forwardShaded_EmissiveModelShader);
+					renderProjectiles(*forwardShaded_EmissiveModelShader, *frd);
 				}
 				else { STOP_DEBUGGER_HERE(); }
 			}
@@ -289,87 +260,96 @@ namespace SA
 
 		GameBase::get().onRenderDispatch.addWeakObj(sp_this(), &ProjectileSystem::handleRenderDispatch);
 
-		forwardShaded_EmissiveModelShader = new_sp<SA::Shader>(forwardShadedModel_SimpleLighting_vertSrc, forwardShadedModel_Emissive_fragSrc, false);
-		deferedShaded_EmissiveModelShader = new_sp<SA::Shader>(gbufferShader_vs, gbufferShader_emissive_fs, false);
+		forwardShaded_EmissiveModelShader = new_sp<SA::Shader>(forwardShadedModel_InstancedEmissive_vertSrc, forwardShadedModel_InstancedEmissive_fragSrc, false);
+		deferedShaded_EmissiveModelShader = new_sp<SA::Shader>(gbufferShader_instancedEmissive_vs, gbufferShader_instancedEmissive_fs, false);
+		instanceBuffer = new_sp<ModelInstanceBuffer>();
 
 		//have pools reserve underlying memory for estimates on how many we expect to be in pool concurrently
 		size_t estimateNumberConcurrentProjectiles = 300;
-		objPool.reserve(estimateNumberConcurrentProjectiles);
+		activeProjectiles.reserve(GameBase::getConstants().PROJECTILE_RESERVE); //sized for the largest battles so the dense arrays don't reallocate mid fight
 		sfxPool.reserve(estimateNumberConcurrentProjectiles);
 		lightPool.reserve(estimateNumberConcurrentProjectiles);
 	}
 
 	void ProjectileSystem::spawnProjectile(const ProjectileSystem::SpawnData& spawnData, const ProjectileConfig& projectileTypeHandle)
 	{
-		sp<Projectile> spawned = objPool.getInstance();
-
 		//#optimize note there may some optimized functions in glm to do this work
 		glm::vec3 projectileSystemForward(0, 0, -1);
 		glm::quat spawnRotation = Utils::getRotationBetween(projectileSystemForward, spawnData.direction_n);
 
-		spawned->xform.rotQuat = spawnRotation;
-		spawned->xform.position = spawnData.start;
-		spawned->damage = spawnData.damage;
-		spawned->color = spawnData.color * (GameBase::get().getRenderSystem().isUsingHDR() ? 4.f : 1.f); //make color glow if using HDR //@hdr_tweak
-		spawned->team = spawnData.team;
-		spawned->owner = spawnData.owner;
-		spawned->direction_n = spawnData.direction_n;
-		spawned->renderXform = glm::scale(glm::mat4(1.f), { 0, 0, 0 });
-
-		spawned->bHit = false;
-		spawned->forceRelease = false;
-
-		spawned->distanceStretchScale = 1;
-		spawned->directionQuat = spawnRotation;
-
-		spawned->speed = projectileTypeHandle.getSpeed();
-		spawned->model = projectileTypeHandle.getModel();
-		spawned->lifetimeSec = projectileTypeHandle.getLifetimeSecs();
-		spawned->aabbSize = projectileTypeHandle.getAABBsize();
-
-		spawned->soundEmitter = spawnSfxEffect(spawnData.sfx, spawnData.start);
-		spawned->pointLight = spawnPointLight(spawnData);
-
-		spawned->bCorrectPosition = spawnData.traceStart.has_value();
-		spawned->traceStartPos = spawnData.traceStart.value_or(glm::vec3(0.f));
-		spawned->offsetTraceCorrectionDistance = 30.f; //hardcoded for now, perhaps should be tweakable per model as size of model may vary
-		spawned->offsetStartPos = spawned->xform.position;
-		
-		spawned->timeAlive = 0.f;
 #if _WIN32 && _DEBUG
 		if (Utils::anyValueNAN(spawnRotation)) { __debugbreak(); return; }
 		if (Utils::anyValueNAN(spawnData.start)) { __debugbreak(); return; }
 #endif
 
-		activeProjectiles.insert( spawned );
+		ProjectileStore& store = activeProjectiles;
+		size_t idx = store.add();
+
+		store.positions[idx] = spawnData.start;
+		store.directions_n[idx] = spawnData.direction_n;
+		store.directionQuats[idx] = spawnRotation;
+		store.damages[idx] = spawnData.damage;
+		store.colors[idx] = spawnData.color * (GameBase::get().getRenderSystem().isUsingHDR() ? 4.f : 1.f); //make color glow if using HDR //@hdr_tweak
+		store.teams[idx] = spawnData.team;
+		store.ownerIds[idx] = projectileOwners.acquire(spawnData.owner);
+		store.renderXforms[idx] = glm::scale(glm::mat4(1.f), { 0, 0, 0 });
+
+		store.speeds[idx] = projectileTypeHandle.getSpeed();
+		store.modelIds[idx] = store.getModelId(projectileTypeHandle.getModel());
+		store.lifetimeSecs[idx] = projectileTypeHandle.getLifetimeSecs();
+		store.aabbSizes[idx] = projectileTypeHandle.getAABBsize();
+
+		store.flags[idx] = spawnData.traceStart.has_value() ? ProjectileStore::FLAG_CORRECT_POSITION : 0;
+		store.traceStartPositions[idx] = spawnData.traceStart.value_or(glm::vec3(0.f));
+		store.offsetTraceCorrectionDistances[idx] = 30.f; //hardcoded for now, perhaps should be tweakable per model as size of model may vary
+		store.offsetStartPositions[idx] = spawnData.start;
+
+		store.timesAlive[idx] = 0.f;
+
+		//spawning attachments may not touch the store, but look the projectile up by handle anyways so this stays safe if that changes
+		ProjectileHandle handle = store.getHandle(idx);
+		sp<AudioEmitter> soundEmitter = spawnSfxEffect(spawnData.sfx, spawnData.start);
+		sp<PointLight_Deferred> pointLight = spawnPointLight(spawnData);
+
+		ProjectileAttachments& attachments = store.getAttachments(store.getDenseIndex(handle));
+		attachments.soundEmitter = soundEmitter;
+		attachments.pointLight = pointLight;
 	}
 
 	void ProjectileSystem::unspawnAllProjectiles()
 	{
-		activeProjectiles.clear();
+		while (activeProjectiles.size() > 0)
+		{
+			releaseProjectile(activeProjectiles.size() - 1);
+		}
+	}
+
+	void ProjectileSystem::cacheRenderData(RenderData& frameRenderData) const
+	{
+		//built at the end of simulation so render only has to upload it
+		frameRenderData.projectileInstances.build(activeProjectiles.renderXforms.data(), activeProjectiles.colors.data(), activeProjectiles.modelIds.data(),
+			activeProjectiles.size(), activeProjectiles.getNumModels());
 	}
 
-	void ProjectileSystem::renderProjectiles(Shader& projectileShader) const
+	void ProjectileSystem::renderProjectiles(Shader& projectileShader, const RenderData& frameRenderData)
 	{
-		//#optimize potential optimization is to use instanced rendering to reduce draw call number
-		//#TODO perhaps projectile should be made a full class and encapsulate this logic
 		//#TODO refactor so projectile system is self-sufficient and doesn't rely on Game to call "render". 
-		//#TODO refactor so instance rendered, set of uniforms can define instance
 
-		//invariant: shader uniforms pre-configured
-		for (const sp<Projectile>& projectile : activeProjectiles)
+		//invariant: shader uniforms pre-configured and instance stream uploaded
+		//model ids stay valid across frames since the model table is only appended to
+		for (const ModelInstanceBatch& batch : frameRenderData.projectileInstances.getBatches())
 		{
-			projectileShader.setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(projectile->renderXform));
-			projectileShader.setUniform3f("lightColor", projectile->color); //#TODO this uniform name is very specific to emissive shader; either need a callback to configure uniforms unique to projectile or move shader here; NOTE: this perf loss scales linearly, adding this one uniform drops fps by 0.1
-			projectile->model->draw(projectileShader, false); //not binding materials projectiles don't use materials and this is causing a gl error when attempting ot bind a normal map texture
+			const sp<const Model3D>& model = activeProjectiles.getModel(batch.modelId);
+			instanceBuffer->bindInstanceAttributes(*model, batch.firstInstance);
+			model->drawInstanced(projectileShader, batch.numInstances, false); //not binding materials projectiles don't use materials and this is causing a gl error when attempting ot bind a normal map texture
 		}
 	}
 
 	void ProjectileSystem::renderProjectileBoundingBoxes(Shader& debugShader, const glm::vec3& color, const glm::mat4& view, const glm::mat4& perspective) const
 	{
-		for (const sp<Projectile>& projectile : activeProjectiles)
+		for (const glm::mat4& collisionXform : activeProjectiles.collisionXforms)
 		{
-			Utils::renderDebugWireCube(debugShader, color, projectile->collisionXform, view, perspective);
+			Utils::renderDebugWireCube(debugShader, color, collisionXform, view, perspective);
 		}
 	}
 
@@ -9,6 +9,8 @@
 #include "ReferenceCode/OpenGL/Algorithms/SeparatingAxisTheorem/SATComponent.h"
 #include "Tools/DataStructures/SATransform.h"
 #include "Tools/DataStructures/ObjectPools.h"
+#include "Game/GameSystems/SystemData/SAProjectileStore.h"
+#include "Game/GameSystems/SystemData/SAProjectileCollision.h"
 #include "Game/AssetConfigs/SoundEffectSubConfig.h"
 #include <optional>
 #include "Rendering/Lights/PointLight_Deferred.h"
@@ -21,45 +23,23 @@ namespace SA
 	class WorldEntity;
 	class AudioEmitter;
 	class PointLight_Deferred;
+	struct RenderData;
+	class ModelInstanceBuffer;
 
 	struct SoundEffectSubConfig;
 
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
-	// Actual Projectile Instances; these system is responsible for creating these instances
-	//
+	// Projectile hit information; projectiles themselves live in the ProjectileSystem's ProjectileStore.
+	// This is built when a hit is detected and handed to the entity that was hit.
 	///////////////////////////////////////////////////////////////////////////////////////////////
 	struct Projectile
 	{
-		//#note When adding a field to this struct, make sure it is properly initialized in ProjectileSystem::spawnProjectile
-
-		Transform xform; 
+		glm::vec3 position;
 		glm::vec3 direction_n;
-		glm::vec3 hitLocation;
-		glm::vec3 aabbSize;
-		glm::vec3 color;
-		glm::vec3 traceStartPos;
-		glm::vec3 offsetStartPos;
-		glm::quat directionQuat; //#TODO maybe? duplicate info in xform
-		glm::mat4 collisionXform;
-		glm::mat4 renderXform;
-		float distanceStretchScale;
-		float speed;
-		float lifetimeSec;
-		float timeAlive;
-		float offsetTraceCorrectionDistance;
-		sp<WorldEntity> owner;
 		int damage;
 		size_t team;
-		bool forceRelease;
-		bool bHit;
-		bool bCorrectPosition;
-		sp<const Model3D> model;
-		sp<AudioEmitter> soundEmitter = nullptr;
-		sp<PointLight_Deferred> pointLight = nullptr;
-
-		void tick(float dt_sec, LevelBase&);
-		void stretchToDistance(float distance, float bDoCollisionTest, LevelBase& currentLevel);
+		sp<WorldEntity> owner;
 	};
 
 	///////////////////////////////////////////////////////////////////////////////////////////////
@@ -79,7 +59,7 @@ namespace SA
 	///////////////////////////////////////////////////////////////////////////////////////////////
 	struct IProjectileHitNotifiable
 	{
-		friend Projectile;
+		friend ProjectileSystem;
 	private:
 		virtual void notifyProjectileCollision(const Projectile& hitProjectile, glm::vec3 hitLoc) = 0;
 	};
@@ -108,7 +88,9 @@ namespace SA
 		void spawnProjectile(const SpawnData& spawnData, const ProjectileConfig& projectileTypeHandle);
 		void unspawnAllProjectiles();
 
-		void renderProjectiles(Shader& projectileShader) const;
+		/** Copies projectile instances into the frame's render data; render only draws from that copy */
+		void cacheRenderData(RenderData& frameRenderData) const;
+		void renderProjectiles(Shader& projectileShader, const RenderData& frameRenderData);
 		void renderProjectileBoundingBoxes(Shader& debugShader, const glm::vec3& color, const glm::mat4& view, const glm::mat4& perspective) const;
 
 		sp<AudioEmitter> spawnSfxEffect(const SoundEffectSubConfig& sfx, glm::vec3 position);
@@ -121,18 +103,28 @@ namespace SA
 		void handlePostLevelChange(const sp<LevelBase>& previousLevel, const sp<LevelBase>& newCurrentLevel);
 		void handleRenderDispatch(float dtSec);
 
+		void tickProjectile(size_t projectileIdx, float dt_sec);
+		/** updates transforms and attachments so the projectile spans distance from its position; returns the start of that span */
+		glm::vec3 stretchToDistance(size_t projectileIdx, float distance);
+		void resolveProjectileHit(const ProjectileCollisionPhase::Hit& hit);
+		void releaseProjectile(size_t projectileIdx);
+
 	private:
 		bool bAutomaticTickProjectiles = true;
 		bool bEnableProjectilePointLights = true;
-		SP_SimpleObjectPool<Projectile> objPool;
 		SP_SimpleObjectPool_RestrictedConstruction<AudioEmitter> sfxPool;
 		SP_SimpleObjectPool_RestrictedConstruction<PointLight_Deferred> lightPool;
 
 		sp<Shader> forwardShaded_EmissiveModelShader;
 		sp<Shader> deferedShaded_EmissiveModelShader;
+		sp<ModelInstanceBuffer> instanceBuffer;
+
+		/** live projectiles as parallel arrays; removal is swap and pop so iterate by index */
+		ProjectileStore activeProjectiles;
+		ProjectileOwnerTable projectileOwners;
 
-		//this is not the most cache coherent design, but wanting to get working prototype before spending time on optimizations
-		//one potential cache friend optimization is to not use sp, and store in a large std::vector that does swap removes (with objects maintaing idices)
-		std::set<sp<Projectile>> activeProjectiles;
+		ProjectileCollisionPhase collisionPhase;
+		std::vector<glm::vec3> segmentStarts; //where each projectile's segment started this frame, by dense index
+		std::vector<ProjectileCollisionPhase::Hit> frameHits;
 	};
 }
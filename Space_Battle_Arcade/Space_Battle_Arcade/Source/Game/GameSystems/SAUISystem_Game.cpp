@@ -465,13 +465,38 @@ namespace SA
 		return (*_camera).get();
 	}
 
+	const RenderData* GameUIRenderData::cameraFrame()
+	{
+		//the camera render drew this frame with, which may trail the live camera
+		const RenderData* frameRenderData = renderData();
+		return frameRenderData && frameRenderData->bHasCameraFrustum ? frameRenderData : nullptr;
+	}
+
+	glm::vec3 GameUIRenderData::camPos()
+	{
+		if (!_camPos)
+		{
+			if (const RenderData* frameRenderData = cameraFrame())
+			{
+				_camPos = frameRenderData->camera.position;
+			}
+
+			if (!_camPos)
+			{
+				_camPos = glm::vec3{ 0.f };
+			}
+		}
+
+		return *_camPos;
+	}
+
 	glm::vec3 GameUIRenderData::camUp()
 	{
 		if (!_camUp)
 		{
-			if (CameraBase* cam = camera())
+			if (const RenderData* frameRenderData = cameraFrame())
 			{
-				_camUp = glm::vec3(cam->getUp());
+				_camUp = frameRenderData->camera.up;
 			}
 
 			if (!_camUp)
@@ -487,9 +512,9 @@ namespace SA
 	{
 		if (!_camRight)
 		{
-			if (CameraBase* cam = camera())
+			if (const RenderData* frameRenderData = cameraFrame())
 			{
-				_camRight = glm::vec3(cam->getRight());
+				_camRight = frameRenderData->camera.right;
 			}
 
 			if (!_camRight)
@@ -505,11 +530,9 @@ namespace SA
 	{
 		if (!_camRot)
 		{
-			//dyn cast :( but cameras were not built to use transforms. Next time they will be!
-			//if (QuaternionCamera* quatCam = dynamic_cast<QuaternionCamera*>(camera())) //adding getQuat to interface and testing
-			if(CameraBase* quatCam = camera())
+			if (const RenderData* frameRenderData = cameraFrame())
 			{
-				_camRot = quatCam->getQuat();
+				_camRot = frameRenderData->camera.rotation;
 			}
 
 			//if we didn't find it, cache a unit quaternion
@@ -542,21 +565,22 @@ namespace SA
 		return *_frameRenderData;
 	}
 
-	void calculateHUDData3D(HUDData3D& _hudData3D, const CameraBase& gameCam, struct GameUIRenderData& uiData)
+	void calculateHUDData3D(HUDData3D& _hudData3D, const RenderData& cameraFrame, struct GameUIRenderData& uiData)
 	{
-		_hudData3D.camPos = gameCam.getPosition();
-		_hudData3D.camUp = gameCam.getUp();
-		_hudData3D.camRight = gameCam.getRight();
-		_hudData3D.camFront = gameCam.getFront();
+		const RenderData::CameraSnapshot& gameCam = cameraFrame.camera;
+		_hudData3D.camPos = gameCam.position;
+		_hudData3D.camUp = gameCam.up;
+		_hudData3D.camRight = gameCam.right;
+		_hudData3D.camFront = gameCam.front;
 
-		float FOVy_deg = gameCam.getFOV() / 2.f;
+		float FOVy_deg = gameCam.fovY_deg / 2.f;
 		float FOVy_rad = glm::radians(FOVy_deg);
 
 		//drawing out triangle with fovy, tan(theta) = y / z;
 		// y = tan(theta) * z
 		_hudData3D.savezoneMax_y = glm::tan(FOVy_rad) * _hudData3D.frontOffsetDist;
 		_hudData3D.savezoneMax_x = _hudData3D.savezoneMax_y * uiData.aspect();
-		_hudData3D.cameraNearPlane = gameCam.getNear();
+		_hudData3D.cameraNearPlane = gameCam.nearZ;
 
 		_hudData3D.textScale = 0.1f * (_hudData3D.frontOffsetDist / 10.f); //0.1 works good at distance 10.f; scale recommend text scale based on relation to 10
 	}
@@ -567,9 +591,9 @@ namespace SA
 		{
 			_hudData3D = HUDData3D{};
 
-			if (SA::CameraBase* gameCam = camera())
+			if (const RenderData* frameRenderData = cameraFrame())
 			{
-				calculateHUDData3D(*_hudData3D, *gameCam, *this);
+				calculateHUDData3D(*_hudData3D, *frameRenderData, *this);
 			}
 
 			//if (!_hudData3D)
@@ -90,7 +90,7 @@ namespace SA
 		float cameraNearPlane = 1.f;
 		float textScale = 1.f;
 	};
-	void calculateHUDData3D(HUDData3D& hud, const CameraBase& camera, struct GameUIRenderData& uiData);
+	void calculateHUDData3D(HUDData3D& hud, const RenderData& cameraFrame, struct GameUIRenderData& uiData);
 
 	struct GameUIRenderData
 	{
@@ -101,7 +101,8 @@ namespace SA
 		glm::ivec2			framebuffer_Size();
 		int					frameBuffer_MinDimension();
 		glm::mat4			orthographicProjection_m();
-		CameraBase*			camera();
+		CameraBase*			camera();				//live camera; drawing should use the cam accessors below, which match the frame being rendered
+		glm::vec3			camPos();
 		glm::vec3			camUp();
 		glm::vec3			camRight();
 		glm::quat			camQuat();
@@ -110,12 +111,14 @@ namespace SA
 		float				aspect();
 	private:
 		void calculateFramebufferMetrics();
+		const RenderData* cameraFrame(); //render data, if it captured a camera
 	private: //use accessors to lazy calculate these fields per invocation; allows sharing of data that has already been calculated
 		optional<float>				_dt_sec;
 		optional<glm::ivec2>		_framebuffer_Size;
 		optional<int>				_frameBuffer_MinDimension;
 		optional<glm::mat4>			_orthographicProjection_m;
 		optional <sp<CameraBase> >	_camera;
+		optional<glm::vec3>			_camPos;
 		optional<glm::vec3>			_camUp;
 		optional<glm::vec3>			_camRight;
 		optional<glm::quat>			_camRot;
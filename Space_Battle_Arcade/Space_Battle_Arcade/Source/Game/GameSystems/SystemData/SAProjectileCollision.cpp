@@ -0,0 +1,305 @@
+#include "SAProjectileCollision.h"
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include "Game/GameSystems/SystemData/SAProjectileStore.h"
+#include "GameFramework/SACollisionUtils.h"
+#include "GameFramework/SAWorldEntity.h"
+#include "GameFramework/Components/CollisionComponent.h"
+#include "ReferenceCode/OpenGL/Algorithms/SeparatingAxisTheorem/SATComponent.h"
+
+namespace SA
+{
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Segment-vs-box kernels
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SegmentBatch::clear()
+	{
+		originX.clear(); originY.clear(); originZ.clear();
+		deltaX.clear(); deltaY.clear(); deltaZ.clear();
+		paddingX.clear(); paddingY.clear(); paddingZ.clear();
+	}
+
+	void SegmentBatch::reserve(size_t count)
+	{
+		originX.reserve(count); originY.reserve(count); originZ.reserve(count);
+		deltaX.reserve(count); deltaY.reserve(count); deltaZ.reserve(count);
+		paddingX.reserve(count); paddingY.reserve(count); paddingZ.reserve(count);
+	}
+
+	void SegmentBatch::push(const glm::vec3& origin, const glm::vec3& delta, const glm::vec3& padding)
+	{
+		originX.push_back(origin.x); originY.push_back(origin.y); originZ.push_back(origin.z);
+		deltaX.push_back(delta.x); deltaY.push_back(delta.y); deltaZ.push_back(delta.z);
+		paddingX.push_back(padding.x); paddingY.push_back(padding.y); paddingZ.push_back(padding.z);
+	}
+
+	/** clamp tiny deltas away from zero so the slab math never divides by zero; a parallel segment then gets slab t values of +-huge */
+	static inline float safeDelta(float delta)
+	{
+		constexpr float epsilon = 1e-12f;
+		return std::abs(delta) < epsilon ? std::copysign(epsilon, delta) : delta;
+	}
+
+	void segmentsVsUnitCube(const SegmentBatch& segments, std::vector<float>& outEnterT)
+	{
+		const size_t count = segments.size();
+		outEnterT.resize(count);
+
+		const float* ox = segments.originX.data(); const float* oy = segments.originY.data(); const float* oz = segments.originZ.data();
+		const float* dx = segments.deltaX.data(); const float* dy = segments.deltaY.data(); const float* dz = segments.deltaZ.data();
+		const float* px = segments.paddingX.data(); const float* py = segments.paddingY.data(); const float* pz = segments.paddingZ.data();
+		float* out = outEnterT.data();
+
+		//keep this loop free of branches and calls that can't be inlined; it is written so that the compiler emits SIMD for it
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float invDx = 1.f / safeDelta(dx[i]);
+			const float invDy = 1.f / safeDelta(dy[i]);
+			const float invDz = 1.f / safeDelta(dz[i]);
+
+			const float tx1 = (-0.5f - px[i] - ox[i]) * invDx, tx2 = (0.5f + px[i] - ox[i]) * invDx;
+			const float ty1 = (-0.5f - py[i] - oy[i]) * invDy, ty2 = (0.5f + py[i] - oy[i]) * invDy;
+			const float tz1 = (-0.5f - pz[i] - oz[i]) * invDz, tz2 = (0.5f + pz[i] - oz[i]) * invDz;
+
+			const float tEnter = std::max(std::max(std::min(tx1, tx2), std::min(ty1, ty2)), std::max(std::min(tz1, tz2), 0.f));
+			const float tExit = std::min(std::min(std::max(tx1, tx2), std::max(ty1, ty2)), std::min(std::max(tz1, tz2), 1.f));
+
+			out[i] = tEnter <= tExit ? tEnter : 2.f;
+		}
+	}
+
+	/** radius of a box, given by its half extent vectors, projected onto axis */
+	static inline float boxRadiusOnAxis(const glm::mat3& boxHalfAxes, const glm::vec3& axis)
+	{
+		return std::abs(glm::dot(boxHalfAxes[0], axis)) + std::abs(glm::dot(boxHalfAxes[1], axis)) + std::abs(glm::dot(boxHalfAxes[2], axis));
+	}
+
+	bool segmentVsConvexShape(const glm::vec3& start, const glm::vec3& end, const glm::mat3& boxHalfAxes, const SAT::Shape& shape,
+		std::vector<glm::vec3>& faceAxes, float& outEnterT)
+	{
+		faceAxes.clear();
+		shape.appendFaceAxes(faceAxes);
+
+		const glm::vec3 delta = end - start;
+		float tEnter = 0.f;
+		float tExit = 1.f;
+
+		//a convex shape is the intersection of the slabs along each of its face normals
+		for (const glm::vec3& axis : faceAxes)
+		{
+			SAT::ProjectionRange shapeRange = shape.projectToAxis(axis);
+			const float boxRadius = boxRadiusOnAxis(boxHalfAxes, axis);
+			shapeRange.min -= boxRadius;
+			shapeRange.max += boxRadius;
+			float startProj = glm::dot(start, axis);
+			float deltaProj = glm::dot(delta, axis);
+
+			if (std::abs(deltaProj) < 1e-12f)
+			{
+				if (startProj < shapeRange.min || startProj > shapeRange.max)
+				{
+					return false;
+				}
+				continue;
+			}
+
+			float t1 = (shapeRange.min - startProj) / deltaProj;
+			float t2 = (shapeRange.max - startProj) / deltaProj;
+			tEnter = std::max(tEnter, std::min(t1, t2));
+			tExit = std::min(tExit, std::max(t1, t2));
+			if (tEnter > tExit)
+			{
+				return false;
+			}
+		}
+
+		outEnterT = tEnter;
+		return true;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Batched projectile collision
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	/** half extent vectors of the projectile's cross section. The collision box is already stretched over the whole segment along its
+		local z (the travel axis), so sweeping that extent too would enter shapes up to half a segment early; only the cross section is swept. */
+	static inline glm::mat3 projectileHalfAxes(const ProjectileStore& projectiles, size_t projectileIdx)
+	{
+		glm::mat3 halfAxes = glm::mat3(projectiles.collisionXforms[projectileIdx]) * 0.5f;
+		halfAxes[2] = glm::vec3(0.f);
+		return halfAxes;
+	}
+
+	ProjectileCollisionPhase::ProjectileCollisionPhase()
+	{
+		projectileShape = new_sp<SAT::CubeShape>();
+	}
+
+	void ProjectileCollisionPhase::run(const ProjectileStore& projectiles,
+		const std::vector<glm::vec3>& segmentStarts,
+		const ProjectileOwnerTable& owners,
+		SH::SpatialHashGrid<WorldEntity>& worldGrid,
+		std::vector<Hit>& outHits)
+	{
+		outHits.clear();
+
+		const size_t numProjectiles = projectiles.size();
+		closestHitDistances.assign(numProjectiles, std::numeric_limits<float>::infinity());
+		closestHitEntities.assign(numProjectiles, nullptr);
+
+		gatherCandidates(projectiles, segmentStarts, owners, worldGrid);
+
+		//candidates are sorted by entity spawn order, so each entity's segments are contiguous and can be tested as one batch;
+		//entities are visited in the same order every run, so equal distance hits always go to the earliest spawned entity
+		size_t groupStart = 0;
+		while (groupStart < candidates.size())
+		{
+			size_t groupEnd = groupStart + 1;
+			while (groupEnd < candidates.size() && candidates[groupEnd].entity == candidates[groupStart].entity)
+			{
+				++groupEnd;
+			}
+			testEntity(*candidates[groupStart].entity, groupStart, groupEnd, projectiles, segmentStarts);
+			groupStart = groupEnd;
+		}
+
+		for (size_t projectileIdx = 0; projectileIdx < numProjectiles; ++projectileIdx)
+		{
+			if (closestHitEntities[projectileIdx])
+			{
+				outHits.push_back(Hit{ projectileIdx, closestHitEntities[projectileIdx], closestHitDistances[projectileIdx] });
+			}
+		}
+	}
+
+	void ProjectileCollisionPhase::gatherCandidates(const ProjectileStore& projectiles, const std::vector<glm::vec3>& segmentStarts, const ProjectileOwnerTable& owners, SH::SpatialHashGrid<WorldEntity>& worldGrid)
+	{
+		cellSegments.clear();
+		candidates.clear();
+
+		const uint8_t skipFlags = ProjectileStore::FLAG_HIT | ProjectileStore::FLAG_FORCE_RELEASE;
+		for (size_t projectileIdx = 0; projectileIdx < projectiles.size(); ++projectileIdx)
+		{
+			if (projectiles.flags[projectileIdx] & skipFlags)
+			{
+				continue;
+			}
+
+			worldGrid.lookupCellsForLine(segmentStarts[projectileIdx], projectiles.positions[projectileIdx], cellsScratch);
+			for (const sp<const SH::HashCell<WorldEntity>>& cell : cellsScratch)
+			{
+				cellSegments.push_back(CellSegment{ cell.get(), uint32_t(projectileIdx) });
+			}
+		}
+
+		//bucket segments by cell so each cell's node list is walked once for all the projectiles passing through it
+		std::sort(cellSegments.begin(), cellSegments.end(),
+			[](const CellSegment& a, const CellSegment& b) { return a.cell < b.cell || (a.cell == b.cell && a.projectileIdx < b.projectileIdx); });
+
+		size_t bucketStart = 0;
+		while (bucketStart < cellSegments.size())
+		{
+			const SH::HashCell<WorldEntity>* cell = cellSegments[bucketStart].cell;
+			size_t bucketEnd = bucketStart + 1;
+			while (bucketEnd < cellSegments.size() && cellSegments[bucketEnd].cell == cell)
+			{
+				++bucketEnd;
+			}
+
+			for (const sp<SH::GridNode<WorldEntity>>& gridNode : cell->nodeBucket)
+			{
+				WorldEntity* entity = &gridNode->element;
+				for (size_t segmentIdx = bucketStart; segmentIdx < bucketEnd; ++segmentIdx)
+				{
+					uint32_t projectileIdx = cellSegments[segmentIdx].projectileIdx;
+					if (entity != owners.getRawOwner(projectiles.ownerIds[projectileIdx]))
+					{
+						candidates.push_back(Candidate{ entity, projectileIdx });
+					}
+				}
+			}
+			bucketStart = bucketEnd;
+		}
+
+		//large entities span many cells; collapse the duplicate pairs that produces.
+		//entities that were never spawned all have spawn id 0; their address still keeps each one's candidates together
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+		{
+			const uint64_t aSpawnId = a.entity->getSpawnId(), bSpawnId = b.entity->getSpawnId();
+			if (aSpawnId != bSpawnId)
+			{
+				return aSpawnId < bSpawnId;
+			}
+			return a.entity < b.entity || (a.entity == b.entity && a.projectileIdx < b.projectileIdx);
+		});
+		candidates.erase(std::unique(candidates.begin(), candidates.end(),
+			[](const Candidate& a, const Candidate& b) { return a.entity == b.entity && a.projectileIdx == b.projectileIdx; }), candidates.end());
+	}
+
+	void ProjectileCollisionPhase::testEntity(WorldEntity& entity, size_t firstCandidate, size_t endCandidate, const ProjectileStore& projectiles, const std::vector<glm::vec3>& segmentStarts)
+	{
+		using glm::vec3; using glm::vec4; using glm::mat4;
+
+		CollisionComponent* collisionComp = entity.getGameComponent<CollisionComponent>();
+		const CollisionData* collisionData = collisionComp ? collisionComp->getCollisionData() : nullptr;
+		if (!collisionData)
+		{
+			return;
+		}
+
+		//move segments into the OBB's local space, where the OBB is the unit cube; t values are the same in both spaces.
+		//the projectile's box is swept, not just its center line, so each segment carries the box's extent along the OBB's axes
+		const mat4 worldToOBB = glm::inverse(collisionData->getOBBShape()->getTransform());
+		const glm::mat3 worldToOBB_dir = glm::mat3(worldToOBB);
+		localSegments.clear();
+		for (size_t candidateIdx = firstCandidate; candidateIdx < endCandidate; ++candidateIdx)
+		{
+			uint32_t projectileIdx = candidates[candidateIdx].projectileIdx;
+			const vec3& start = segmentStarts[projectileIdx];
+			const vec3& end = projectiles.positions[projectileIdx];
+			const glm::mat3 localHalfAxes = worldToOBB_dir * projectileHalfAxes(projectiles, projectileIdx);
+			const vec3 localPadding = glm::abs(localHalfAxes[0]) + glm::abs(localHalfAxes[1]) + glm::abs(localHalfAxes[2]);
+			localSegments.push(vec3(worldToOBB * vec4(start, 1.f)), vec3(worldToOBB * vec4(end - start, 0.f)), localPadding);
+		}
+		segmentsVsUnitCube(localSegments, enterT);
+
+		for (size_t batchIdx = 0; batchIdx < enterT.size(); ++batchIdx)
+		{
+			if (enterT[batchIdx] > 1.f)
+			{
+				continue;
+			}
+
+			//OBB confirmed, test the swept projectile box against the detailed shapes
+			uint32_t projectileIdx = candidates[firstCandidate + batchIdx].projectileIdx;
+			const vec3& start = segmentStarts[projectileIdx];
+			const vec3& end = projectiles.positions[projectileIdx];
+			const float segmentLength = glm::length(end - start);
+			projectileShape->updateTransform(projectiles.collisionXforms[projectileIdx]);
+
+			for (const CollisionData::ConstShapeData& shapeData : collisionData->getConstShapeData())
+			{
+				if (SAT::Shape::CollisionTest(*projectileShape, *shapeData.shape))
+				{
+					float shapeEnterT;
+					if (!segmentVsConvexShape(start, end, projectileHalfAxes(projectiles, projectileIdx), *shapeData.shape, faceAxes, shapeEnterT))
+					{
+						//the box overlaps the shape at the segment end so the swept test should not miss; guard against float error anyway
+						shapeEnterT = enterT[batchIdx];
+					}
+
+					float hitDistance = shapeEnterT * segmentLength;
+					if (hitDistance < closestHitDistances[projectileIdx])
+					{
+						closestHitDistances[projectileIdx] = hitDistance;
+						closestHitEntities[projectileIdx] = &entity;
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "GameFramework/SAGameEntity.h"
+#include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SpatialHashingComponent.h"
+
+namespace SAT
+{
+	class Shape;
+}
+
+namespace SA
+{
+	class WorldEntity;
+	class ProjectileStore;
+	class ProjectileOwnerTable;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Segment-vs-box kernels
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	/** Segments in structure of arrays form so the slab kernel can process several at once.
+		Segments are parameterized as origin + t * delta, with t in [0, 1]. Padding is the half extent of the box swept along the segment. */
+	struct SegmentBatch
+	{
+		void clear();
+		void reserve(size_t count);
+		void push(const glm::vec3& origin, const glm::vec3& delta, const glm::vec3& padding);
+		size_t size() const { return originX.size(); }
+
+		std::vector<float> originX, originY, originZ;
+		std::vector<float> deltaX, deltaY, deltaZ;
+		std::vector<float> paddingX, paddingY, paddingZ;
+	};
+
+	/** Slab test of every segment against the box [-0.5, 0.5]^3 (the SAT::CubeShape unit cube), grown by each segment's padding.
+		Writes the entry t for hits, or a value > 1 for misses; segments starting inside the box enter at 0.
+		Branch free over the batch so the compiler can vectorize it. */
+	void segmentsVsUnitCube(const SegmentBatch& segments, std::vector<float>& outEnterT);
+
+	/** Entry t of a box swept along segment [start, end] into a transformed convex SAT shape, by treating each face axis as a slab.
+		boxHalfAxes columns are the box's half extent vectors; a zero matrix tests the bare segment, which is exact.
+		With a box, each slab is grown by the box's radius on that axis; only the shape's face axes are used, so near the shape's edges
+		this enters slightly early. Returns false on a miss. Requires the shape to enumerate every face normal, which SAT already requires.
+		faceAxesScratch is caller owned so concurrent callers do not share a buffer. */
+	bool segmentVsConvexShape(const glm::vec3& start, const glm::vec3& end, const glm::mat3& boxHalfAxes, const SAT::Shape& shape,
+		std::vector<glm::vec3>& faceAxesScratch, float& outEnterT);
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Batched projectile collision
+	//
+	// Runs once per frame after every projectile has been moved. Broadphase buckets the projectile
+	// segments by spatial hash cell to gather candidate entities. Narrowphase slab tests each entity's
+	// OBB against all of its candidate segments in one batch, and only segments that pass go on to the
+	// SAT test against the entity's collision shapes.
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	class ProjectileCollisionPhase
+	{
+	public:
+		struct Hit
+		{
+			size_t projectileIdx;
+			WorldEntity* entity;
+			float hitDistance;	//distance from the segment start to where it enters the hit shape
+		};
+
+	public:
+		ProjectileCollisionPhase();
+
+		/** segmentStarts are indexed by projectile dense index; segment ends are the store's current positions.
+			Projectiles flagged as hit or force released are skipped. outHits holds the closest hit per projectile, ordered by projectile index. */
+		void run(const ProjectileStore& projectiles,
+			const std::vector<glm::vec3>& segmentStarts,
+			const ProjectileOwnerTable& owners,
+			SH::SpatialHashGrid<WorldEntity>& worldGrid,
+			std::vector<Hit>& outHits);
+
+	private:
+		void gatherCandidates(const ProjectileStore& projectiles, const std::vector<glm::vec3>& segmentStarts, const ProjectileOwnerTable& owners, SH::SpatialHashGrid<WorldEntity>& worldGrid);
+		void testEntity(WorldEntity& entity, size_t firstCandidate, size_t endCandidate, const ProjectileStore& projectiles, const std::vector<glm::vec3>& segmentStarts);
+
+	private:
+		struct CellSegment
+		{
+			const SH::HashCell<WorldEntity>* cell;
+			uint32_t projectileIdx;
+		};
+		struct Candidate
+		{
+			WorldEntity* entity;
+			uint32_t projectileIdx;
+		};
+
+		//scratch buffers; kept between frames so steady state does not allocate
+		std::vector<std::shared_ptr<const SH::HashCell<WorldEntity>>> cellsScratch;
+		std::vector<CellSegment> cellSegments;
+		std::vector<Candidate> candidates;
+		SegmentBatch localSegments;
+		std::vector<float> enterT;
+		std::vector<glm::vec3> faceAxes;
+		std::vector<float> closestHitDistances;
+		std::vector<WorldEntity*> closestHitEntities;
+		sp<SAT::Shape> projectileShape;
+	};
+}
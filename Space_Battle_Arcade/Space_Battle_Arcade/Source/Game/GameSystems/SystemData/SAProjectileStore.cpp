@@ -0,0 +1,285 @@
+#include "SAProjectileStore.h"
+#include <cassert>
+
+namespace SA
+{
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Owner table
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	uint32_t ProjectileOwnerTable::acquire(const sp<WorldEntity>& owner)
+	{
+		if (!owner)
+		{
+			return NO_OWNER;
+		}
+
+		auto iter = rawToId.find(owner.get());
+		if (iter != rawToId.end())
+		{
+			uint32_t ownerId = iter->second;
+			//a destroyed owner's address may have been reused by a new entity; only share the id if it is really the same owner
+			if (!owners[ownerId].expired())
+			{
+				++refCounts[ownerId];
+				return ownerId;
+			}
+
+			//stale id stays alive until its remaining projectiles release it, but it can no longer be looked up by address
+			rawToId.erase(iter);
+		}
+
+		uint32_t ownerId;
+		if (freeIds.size() > 0)
+		{
+			ownerId = freeIds.back();
+			freeIds.pop_back();
+			owners[ownerId] = owner;
+			rawOwners[ownerId] = owner.get();
+			refCounts[ownerId] = 1;
+		}
+		else
+		{
+			ownerId = static_cast<uint32_t>(owners.size());
+			owners.push_back(owner);
+			rawOwners.push_back(owner.get());
+			refCounts.push_back(1);
+		}
+		rawToId[owner.get()] = ownerId;
+		return ownerId;
+	}
+
+	void ProjectileOwnerTable::release(uint32_t ownerId)
+	{
+		if (ownerId == NO_OWNER)
+		{
+			return;
+		}
+
+		assert(refCounts[ownerId] > 0);
+		if (--refCounts[ownerId] == 0)
+		{
+			auto iter = rawToId.find(rawOwners[ownerId]);
+			if (iter != rawToId.end() && iter->second == ownerId)
+			{
+				rawToId.erase(iter);
+			}
+			owners[ownerId].reset();
+			rawOwners[ownerId] = nullptr;
+			freeIds.push_back(ownerId);
+		}
+	}
+
+	void ProjectileOwnerTable::clear()
+	{
+		owners.clear();
+		rawOwners.clear();
+		refCounts.clear();
+		freeIds.clear();
+		rawToId.clear();
+	}
+
+	sp<WorldEntity> ProjectileOwnerTable::resolve(uint32_t ownerId) const
+	{
+		return ownerId != NO_OWNER ? owners[ownerId].lock() : nullptr;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Projectile store
+	///////////////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	static inline void swapPop(std::vector<T>& vec, size_t idx)
+	{
+		if (idx != vec.size() - 1)
+		{
+			vec[idx] = std::move(vec.back());
+		}
+		vec.pop_back();
+	}
+
+	size_t ProjectileStore::add()
+	{
+		uint32_t slot;
+		if (freeSlots.size() > 0)
+		{
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			slot = static_cast<uint32_t>(slotToDense.size());
+			slotToDense.push_back(0);
+			slotGenerations.push_back(0);
+			attachmentsBySlot.emplace_back();
+		}
+
+		size_t denseIdx = size();
+		slotToDense[slot] = static_cast<uint32_t>(denseIdx);
+
+		positions.emplace_back(0.f);
+		directions_n.emplace_back(0.f);
+		speeds.push_back(0.f);
+		lifetimeSecs.push_back(0.f);
+		timesAlive.push_back(0.f);
+		flags.push_back(0);
+
+		directionQuats.emplace_back(1.f, 0.f, 0.f, 0.f);
+		aabbSizes.emplace_back(1.f);
+		traceStartPositions.emplace_back(0.f);
+		offsetStartPositions.emplace_back(0.f);
+		offsetTraceCorrectionDistances.push_back(0.f);
+
+		damages.push_back(0);
+		teams.push_back(0);
+		ownerIds.push_back(ProjectileOwnerTable::NO_OWNER);
+
+		colors.emplace_back(0.f);
+		modelIds.push_back(0);
+		collisionXforms.emplace_back(1.f);
+		renderXforms.emplace_back(1.f);
+
+		handleSlots.push_back(slot);
+
+		return denseIdx;
+	}
+
+	void ProjectileStore::removeAt(size_t denseIdx)
+	{
+		assert(denseIdx < size());
+
+		//retire the handle; bumping generation makes any outstanding handles stale
+		uint32_t removedSlot = handleSlots[denseIdx];
+		++slotGenerations[removedSlot];
+		attachmentsBySlot[removedSlot] = ProjectileAttachments{};
+		freeSlots.push_back(removedSlot);
+
+		//the last projectile is about to move into denseIdx, point its handle at the new location
+		uint32_t movedSlot = handleSlots.back();
+		slotToDense[movedSlot] = static_cast<uint32_t>(denseIdx);
+
+		swapPop(positions, denseIdx);
+		swapPop(directions_n, denseIdx);
+		swapPop(speeds, denseIdx);
+		swapPop(lifetimeSecs, denseIdx);
+		swapPop(timesAlive, denseIdx);
+		swapPop(flags, denseIdx);
+
+		swapPop(directionQuats, denseIdx);
+		swapPop(aabbSizes, denseIdx);
+		swapPop(traceStartPositions, denseIdx);
+		swapPop(offsetStartPositions, denseIdx);
+		swapPop(offsetTraceCorrectionDistances, denseIdx);
+
+		swapPop(damages, denseIdx);
+		swapPop(teams, denseIdx);
+		swapPop(ownerIds, denseIdx);
+
+		swapPop(colors, denseIdx);
+		swapPop(modelIds, denseIdx);
+		swapPop(collisionXforms, denseIdx);
+		swapPop(renderXforms, denseIdx);
+
+		swapPop(handleSlots, denseIdx);
+	}
+
+	void ProjectileStore::clear()
+	{
+		//retire every live handle rather than resetting generations, so old handles can't alias new projectiles
+		for (uint32_t slot : handleSlots)
+		{
+			++slotGenerations[slot];
+			attachmentsBySlot[slot] = ProjectileAttachments{};
+			freeSlots.push_back(slot);
+		}
+
+		positions.clear();
+		directions_n.clear();
+		speeds.clear();
+		lifetimeSecs.clear();
+		timesAlive.clear();
+		flags.clear();
+
+		directionQuats.clear();
+		aabbSizes.clear();
+		traceStartPositions.clear();
+		offsetStartPositions.clear();
+		offsetTraceCorrectionDistances.clear();
+
+		damages.clear();
+		teams.clear();
+		ownerIds.clear();
+
+		colors.clear();
+		modelIds.clear();
+		collisionXforms.clear();
+		renderXforms.clear();
+
+		handleSlots.clear();
+	}
+
+	void ProjectileStore::reserve(size_t count)
+	{
+		positions.reserve(count);
+		directions_n.reserve(count);
+		speeds.reserve(count);
+		lifetimeSecs.reserve(count);
+		timesAlive.reserve(count);
+		flags.reserve(count);
+
+		directionQuats.reserve(count);
+		aabbSizes.reserve(count);
+		traceStartPositions.reserve(count);
+		offsetStartPositions.reserve(count);
+		offsetTraceCorrectionDistances.reserve(count);
+
+		damages.reserve(count);
+		teams.reserve(count);
+		ownerIds.reserve(count);
+
+		colors.reserve(count);
+		modelIds.reserve(count);
+		collisionXforms.reserve(count);
+		renderXforms.reserve(count);
+
+		handleSlots.reserve(count);
+
+		slotToDense.reserve(count);
+		slotGenerations.reserve(count);
+		attachmentsBySlot.reserve(count);
+		freeSlots.reserve(count);
+	}
+
+	ProjectileHandle ProjectileStore::getHandle(size_t denseIdx) const
+	{
+		ProjectileHandle handle;
+		handle.slot = handleSlots[denseIdx];
+		handle.generation = slotGenerations[handle.slot];
+		return handle;
+	}
+
+	bool ProjectileStore::isValid(const ProjectileHandle& handle) const
+	{
+		return handle.slot < slotGenerations.size() && slotGenerations[handle.slot] == handle.generation;
+	}
+
+	size_t ProjectileStore::getDenseIndex(const ProjectileHandle& handle) const
+	{
+		assert(isValid(handle));
+		return slotToDense[handle.slot];
+	}
+
+	uint16_t ProjectileStore::getModelId(const sp<const Model3D>& model)
+	{
+		//there are only a handful of projectile models, a linear scan is cheaper than hashing
+		for (size_t modelIdx = 0; modelIdx < models.size(); ++modelIdx)
+		{
+			if (models[modelIdx] == model)
+			{
+				return static_cast<uint16_t>(modelIdx);
+			}
+		}
+		models.push_back(model);
+		return static_cast<uint16_t>(models.size() - 1);
+	}
+}
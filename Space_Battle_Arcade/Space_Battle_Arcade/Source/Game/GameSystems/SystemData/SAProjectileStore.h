@@ -0,0 +1,132 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "GameFramework/SAGameEntity.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace SA
+{
+	class WorldEntity;
+	class Model3D;
+	class AudioEmitter;
+	class PointLight_Deferred;
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Stable reference to a projectile. Dense indices change as projectiles are swap-removed,
+	// handles do not; a handle goes stale (fails isValid) once its projectile is removed.
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	struct ProjectileHandle
+	{
+		static constexpr uint32_t INVALID_SLOT = ~uint32_t(0);
+		uint32_t slot = INVALID_SLOT;
+		uint32_t generation = 0;
+	};
+
+	/** Objects that follow a projectile around; these are cold data so they live by handle slot rather than in the dense arrays */
+	struct ProjectileAttachments
+	{
+		sp<AudioEmitter> soundEmitter = nullptr;
+		sp<PointLight_Deferred> pointLight = nullptr;
+	};
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Owners are referred to by small ids so projectiles don't hold strong references to ships.
+	// Ids are reference counted by the projectiles using them and recycled once unused.
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	class ProjectileOwnerTable
+	{
+	public:
+		static constexpr uint32_t NO_OWNER = ~uint32_t(0);
+
+		uint32_t acquire(const sp<WorldEntity>& owner);
+		void release(uint32_t ownerId);
+		void clear();
+
+		/** May return null if the owner was destroyed while its projectiles were still in flight */
+		sp<WorldEntity> resolve(uint32_t ownerId) const;
+
+		/** Only for identity comparisons; never dereference as the owner may have been destroyed */
+		const WorldEntity* getRawOwner(uint32_t ownerId) const { return ownerId != NO_OWNER ? rawOwners[ownerId] : nullptr; }
+
+	private:
+		std::vector<wp<WorldEntity>> owners;
+		std::vector<const WorldEntity*> rawOwners;
+		std::vector<uint32_t> refCounts;
+		std::vector<uint32_t> freeIds;
+		std::unordered_map<const WorldEntity*, uint32_t> rawToId;
+	};
+
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	// Structure of arrays projectile storage.
+	//
+	// Every array is indexed by the same dense index; index i across all arrays is a single projectile.
+	// Removal swaps the last projectile into the removed index, so iterate with an index and do not
+	// advance it after a removal. Use handles to refer to a projectile across frames.
+	///////////////////////////////////////////////////////////////////////////////////////////////
+	class ProjectileStore
+	{
+	public:
+		enum Flags : uint8_t
+		{
+			FLAG_HIT = 1 << 0,
+			FLAG_FORCE_RELEASE = 1 << 1,
+			FLAG_CORRECT_POSITION = 1 << 2,
+		};
+
+		/** Appends a projectile with zeroed data, caller fills in the arrays at the returned dense index */
+		size_t add();
+		void removeAt(size_t denseIdx);
+		void clear();
+		void reserve(size_t count);
+
+		size_t size() const { return positions.size(); }
+
+		ProjectileHandle getHandle(size_t denseIdx) const;
+		bool isValid(const ProjectileHandle& handle) const;
+		size_t getDenseIndex(const ProjectileHandle& handle) const;
+
+		ProjectileAttachments& getAttachments(size_t denseIdx) { return attachmentsBySlot[handleSlots[denseIdx]]; }
+		const ProjectileAttachments& getAttachments(size_t denseIdx) const { return attachmentsBySlot[handleSlots[denseIdx]]; }
+
+		/** Model lookup table; projectiles only store the small id */
+		uint16_t getModelId(const sp<const Model3D>& model);
+		const sp<const Model3D>& getModel(uint16_t modelId) const { return models[modelId]; }
+		size_t getNumModels() const { return models.size(); }
+
+	public: //dense arrays, hot data first
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec3> directions_n;
+		std::vector<float> speeds;
+		std::vector<float> lifetimeSecs;
+		std::vector<float> timesAlive;
+		std::vector<uint8_t> flags;
+
+		std::vector<glm::quat> directionQuats;
+		std::vector<glm::vec3> aabbSizes;
+		std::vector<glm::vec3> traceStartPositions;
+		std::vector<glm::vec3> offsetStartPositions;
+		std::vector<float> offsetTraceCorrectionDistances;
+
+		std::vector<int> damages;
+		std::vector<size_t> teams;
+		std::vector<uint32_t> ownerIds;
+
+		std::vector<glm::vec3> colors;
+		std::vector<uint16_t> modelIds;
+		std::vector<glm::mat4> collisionXforms;
+		std::vector<glm::mat4> renderXforms;
+
+		std::vector<uint32_t> handleSlots;
+
+	private: //sparse handle data, indexed by handle slot
+		std::vector<uint32_t> slotToDense;
+		std::vector<uint32_t> slotGenerations;
+		std::vector<ProjectileAttachments> attachmentsBySlot;
+		std::vector<uint32_t> freeSlots;
+
+		std::vector<sp<const Model3D>> models;
+	};
+}
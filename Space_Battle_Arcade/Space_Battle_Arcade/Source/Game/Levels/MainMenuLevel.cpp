@@ -25,6 +25,7 @@
 #include "Game/SAPlayer.h"
 #include "GameFramework/SAAudioSystem.h"
 #include "Game/AssetConfigs/SASettingsProfileConfig.h"
+#include "Game/GameSystems/SAModSystem.h"
 
 namespace SA
 {
@@ -248,6 +249,9 @@ namespace SA
 
 	void MainMenuLevel::handleMainMenuStartupDelayOver()
 	{
+		//mod configs load in the background during the startup delay; screens read them once activated
+		SpaceArcade::get().getModSystem()->waitForConfigLoads();
+
 		mainMenuScreen->activate(true); 
 
 		static bool firstLoad = true;
@@ -28,7 +28,9 @@
 #include "GameFramework/SALog.h"
 #include "Tools/PlatformUtils.h"
 #include "Game/SAShip.h"
+#include "Game/SAShipPlacements.h"
 #include "Game/Components/FighterSpawnComponent.h"
+#include "Game/Components/ShipEnergyComponent.h"
 #include "Game/GameSystems/SAModSystem.h"
 #include "Game/SpaceArcade.h"
 #include "Game/OptionalCompilationMacros.h"
@@ -47,11 +49,28 @@
 #include "Game/GameEntities/AvoidMesh.h"
 #include "Game/UI/GameUI/SAHUD.h"
 #include "Game/Rendering/CustomGameShaders.h"
+#include "GameFramework/Components/GameplayComponents.h"
+#include "GameFramework/SAAILodScheduler.h"
 
 namespace SA
 {
 	using namespace glm;
 
+	/** Draws a snapshot's models; render never needs the entity they came from */
+	static void renderSnapshot(const RenderData& frameData, const RenderData::EntitySnapshot& snapshot, Shader& shader)
+	{
+		for (uint32_t drawIdx = snapshot.firstDraw; drawIdx < snapshot.firstDraw + snapshot.numDraws; ++drawIdx)
+		{
+			const RenderData::ModelDraw& draw = frameData.modelDraws[drawIdx];
+			shader.setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(draw.modelMatrix));
+			if (draw.tint)
+			{
+				shader.setUniform3f("objectTint", *draw.tint);
+			}
+			draw.model->draw(shader);
+		}
+	}
+
 	void SpaceLevelBase::render(float dt_sec, const glm::mat4& view, const glm::mat4& projection)
 	{
 		using glm::vec3; using glm::mat4;
@@ -60,13 +79,10 @@ namespace SA
 
 		sj.tick(dt_sec);
 
-		const sp<PlayerBase>& zeroPlayer = game.getPlayerSystem().getPlayer(0);
 		const RenderData* FRD = game.getRenderSystem().getFrameRenderData_Read(game.getFrameNumber());
 
-		if (zeroPlayer && FRD)
+		if (FRD)
 		{
-			const sp<CameraBase>& camera = zeroPlayer->getCamera();
-
 #if !IGNORE_INCOMPLETE_DEFERRED_RENDER_CODE
 			todo_update_star_FIELD_shader_to_be_deferred;
 			todo_update_star_shader_to_be_deferred;
@@ -103,70 +119,6 @@ namespace SA
 			}
 			ec(glClear(GL_DEPTH_BUFFER_BIT));
 
-			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			// prepare stencil highlight data
-			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-			const std::vector<sp<PlayerBase>>& allPlayers = game.getPlayerSystem().getAllPlayers();
-			if (game.bEnableStencilHighlights)
-			{
-				if (game.bOnlyHighlightTargets)
-				{
-					for (const sp<PlayerBase>& player : allPlayers)
-					{
-						if (IControllable* controlTarget = player->getControlTarget())
-						{
-							if (WorldEntity* controlTarget_we = controlTarget->asWorldEntity())
-							{
-								if (const BrainComponent* brainComp = controlTarget_we->getGameComponent<BrainComponent>())
-								{
-									if (const BehaviorTree::Tree* tree = brainComp->getTree())
-									{
-										BehaviorTree::Memory& memory = tree->getMemory();
-										if (const BehaviorTree::ActiveAttackers* attackerMap = memory.getReadValueAs<BehaviorTree::ActiveAttackers>(BT_AttackersKey))
-										{
-											for (auto& iter : *attackerMap)
-											{
-												if (iter.second.attacker)
-												{
-													//dynamic cast sucks, but this will likely only be a few per frame. alternatively could set up a component for this. #nextengine in general, find a design to remove this issue of subclass casting
-													if (RenderModelEntity* attacker = dynamic_cast<RenderModelEntity*>(iter.second.attacker.fastGet()))
-													{
-														stencilHighlightEntities.push_back(attacker);
-													}
-												}
-											}
-										}
-									}
-								}
-							}
-						}
-					}
-				}
-				else /*Render all ship highlights. */
-				{
-					//since we're going to be rendering a whole bunch of highlights, reserve the array size to match upper bound of what we're rendering.
-					stencilHighlightEntities.reserve(renderEntities.size()); 
-
-					for (const sp<RenderModelEntity>& renderEntity : renderEntities)
-					{
-						//don't render carrier ships with highlights
-						if (renderEntity)
-						{
-							//ideally I'd would do this this in a more systemic way, but running out of time to finish this. check if this is a spawner (carrier) and don't highlight. 
-							//Perhaps a highlight component could be added and that could be checked for a more roboust system.
-							if (!renderEntity->hasGameComponent<FighterSpawnComponent>()
-								&& ! renderEntity->hasGameComponent<OwningPlayerComponent>()//make sure it isn't player
-								&& renderEntity->hasGameComponent<TeamComponent>() //make sure its not an asteroid
-							)
-							{
-								stencilHighlightEntities.push_back(renderEntity.get());
-							}
-						}
-					}
-				}
-			}
-
-
 #if !IGNORE_INCOMPLETE_DEFERRED_RENDER_CODE
 			todo_update_model_shader_to_be_deferred;
 #endif //IGNORE_INCOMPLETE_DEFERRED_RENDER_CODE
@@ -193,7 +145,7 @@ namespace SA
 			{
 				FRD->dirLights[light].applyToShader(*forwardShadedModelShader, light);
 			}
-			forwardShadedModelShader->setUniform3f("cameraPosition", camera->getPosition());
+			forwardShadedModelShader->setUniform3f("cameraPosition", FRD->playerCamerasPositions[0]);
 			forwardShadedModelShader->setUniform1i("material.shininess", 32);
 
 			bool bShouldRenderWorldUnits = true;
@@ -208,18 +160,17 @@ namespace SA
 				// render scaled up ship with highlight shader, but only if passes stencil and depth test.
 				////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 				uint32_t stencilHighlightBit = 1; //#stencil todo - define this in a global place so that all stencil bits can been seen in one location
-				if (stencilHighlightEntities.size() > 0)
+				if (FRD->highlights.size() > 0)
 				{
 					//prepare_stencil_write;
 					ec(glEnable(GL_STENCIL_TEST));
 					ec(glStencilFunc(GL_ALWAYS, stencilHighlightBit, 0xFF)); //configure the bit to write/read
 					ec(glStencilMask(0xFF)); //enable writing to all bits of the stencil buffer
 					ec(glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE));
-					for (RenderModelEntity* highlightEntity : stencilHighlightEntities)
+					for (const RenderData::HighlightSnapshot& highlight : FRD->highlights)
 					{
 						//render like normal, but writing to stencil buffer so that highlight will not overwrite object
-						forwardShadedModelShader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(highlightEntity->getTransform().getModelMatrix()));
-						highlightEntity->render(*forwardShadedModelShader);
+						renderSnapshot(*FRD, highlight.entity, *forwardShadedModelShader);
 					}
 					//clear_stencil_write;
 					ec(glStencilMask(0)); //disable writing to stencil buffer
@@ -228,16 +179,19 @@ namespace SA
 				////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 				// regular rendering pass
 				////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-				for (const sp<RenderModelEntity>& entity : renderEntities) 
+				for (const RenderData::EntitySnapshot& entitySnapshot : FRD->entities) 
 				{
-					forwardShadedModelShader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(entity->getTransform().getModelMatrix()));
-					entity->render(*forwardShadedModelShader);
+					renderSnapshot(*FRD, entitySnapshot, *forwardShadedModelShader);
+				}
+				for (const mat4& healSeeker : FRD->healSeekers)
+				{
+					CommunicationPlacement::renderHealSeeker(healSeeker, FRD->projection_view);
 				}
 
 				////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 				// highlight pass
 				////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-				if (stencilHighlightEntities.size() > 0)
+				if (FRD->highlights.size() > 0)
 				{
 					ec(glStencilFunc(GL_NOTEQUAL, stencilHighlightBit, 0xFF)); //only render if we haven't stenciled this area
 
@@ -251,42 +205,17 @@ namespace SA
 					highlightForwardModelShader->setUniformMatrix4fv("view", 1, GL_FALSE, glm::value_ptr(FRD->view));
 					highlightForwardModelShader->setUniformMatrix4fv("projection", 1, GL_FALSE, glm::value_ptr(FRD->projection));
 
-					//set highligh color, this will be enemy color unless game is in mode where all highlights are rendered, then we will change based on if we're rendering a teammate or an enemy
-					size_t playerTeam = 0;
-					if (SAPlayer* player = dynamic_cast<SAPlayer*>(GameBase::get().getPlayerSystem().getPlayer(0).get()))
-					{
-						playerTeam = player->getCurrentTeamIdx();
-					}
+					//enemy color unless game is in mode where all highlights are rendered, then the snapshot says whether each one is a teammate
 					/*vec3 highlightColor = vec3(0.8f);*/
 					float highlightHdrMultiplier = GameBase::get().getRenderSystem().isUsingHDR() ? 2.f : 1.f;//@hdr_tweak
 					vec3 enemyHighlightColor = vec3(0.5f, 0, 0) * highlightHdrMultiplier;
 					vec3 teamHighlightColor = vec3(vec2(0.1f), 0.5f) * highlightHdrMultiplier;
-					vec3 highlightColor = enemyHighlightColor;
-					highlightForwardModelShader->setUniform3f("color", highlightColor);
 
-					for (RenderModelEntity* highlightEntity : stencilHighlightEntities)
+					for (const RenderData::HighlightSnapshot& highlight : FRD->highlights)
 					{
-						//set color to team color? will require component or something to get that information
-						highlightForwardModelShader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(highlightEntity->getTransform().getModelMatrix()));
-						
-						if (!game.bOnlyHighlightTargets)
-						{
-							//if rendering all ships, their color needs to match whether they're an enemy or a friendly
-							if (TeamComponent* teamComp = highlightEntity->getGameComponent<TeamComponent>())
-							{
-								highlightColor = (teamComp->getTeam() == playerTeam) ? teamHighlightColor : enemyHighlightColor;
-							}
-							else
-							{
-								//no team component, assume enemy;
-								highlightColor = enemyHighlightColor;
-							}
-							highlightForwardModelShader->setUniform3f("color", highlightColor);
-						}
-
-						highlightEntity->render(*highlightForwardModelShader);
+						highlightForwardModelShader->setUniform3f("color", highlight.bFriendly ? teamHighlightColor : enemyHighlightColor);
+						renderSnapshot(*FRD, highlight.entity, *highlightForwardModelShader);
 					}
-					stencilHighlightEntities.clear(); //clear raw pointers so they will be regenerated next frame
 
 					//clean up stencil state so that other features can use stencil buffer
 					ec(glStencilMask(0xFF));
@@ -310,10 +239,9 @@ namespace SA
 					}
 
 					//ec(glDisable(GL_DEPTH_TEST));
-					for (const sp<RenderModelEntity>& entity : renderEntities)
+					for (const RenderData::EntitySnapshot& entitySnapshot : FRD->entities)
 					{
-						debugNormalMapShader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(entity->getTransform().getModelMatrix()));
-						entity->render(*debugNormalMapShader);
+						renderSnapshot(*FRD, entitySnapshot, *debugNormalMapShader);
 					}
 					//ec(glEnable(GL_DEPTH_TEST));
 				}
@@ -321,13 +249,9 @@ namespace SA
 			else
 			{
 				//special case, we want to still render the player while star jumping
-				const std::vector<sp<PlayerBase>>& allPlayers = GameBase::get().getPlayerSystem().getAllPlayers();
-				for (const sp<PlayerBase>& player : allPlayers)
+				for (const RenderData::EntitySnapshot& playerSnapshot : FRD->playerEntities)
 				{
-					if (RenderModelEntity* playerModel = dynamic_cast<RenderModelEntity*>(player->getControlTarget()))
-					{
-						playerModel->render(*forwardShadedModelShader);
-					}
+					renderSnapshot(*FRD, playerSnapshot, *forwardShadedModelShader);
 				}
 			}
 		}
@@ -337,6 +261,122 @@ namespace SA
 		}
 	}
 
+	void SpaceLevelBase::cacheRenderData_v(RenderData& frameRenderData, const std::vector<const RenderModelEntity*>& visibleEntities)
+	{
+		LevelBase::cacheRenderData_v(frameRenderData, visibleEntities);
+
+		SpaceArcade& game = SpaceArcade::get();
+		const std::vector<sp<PlayerBase>>& allPlayers = game.getPlayerSystem().getAllPlayers();
+
+		size_t playerTeam = 0;
+		if (SAPlayer* player = dynamic_cast<SAPlayer*>(game.getPlayerSystem().getPlayer(0).get()))
+		{
+			playerTeam = player->getCurrentTeamIdx();
+		}
+		const bool bHighlightAttackers = game.bEnableStencilHighlights && game.bOnlyHighlightTargets;
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// players: hud values, their control targets and who is attacking them
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		frameRenderData.playerHUDs.resize(allPlayers.size());
+		for (size_t playerIdx = 0; playerIdx < allPlayers.size(); ++playerIdx)
+		{
+			RenderData::PlayerHUDSnapshot& hud = frameRenderData.playerHUDs[playerIdx];
+			if (SAPlayer* player = dynamic_cast<SAPlayer*>(allPlayers[playerIdx].get()))
+			{
+				hud.bCanDilateTime = player->canDilateTime();
+			}
+
+			IControllable* controlTarget = allPlayers[playerIdx]->getControlTarget();
+			hud.bHasControlTarget = controlTarget != nullptr;
+			if (RenderModelEntity* playerModel = dynamic_cast<RenderModelEntity*>(controlTarget))
+			{
+				//cached every frame so a star jump starting on a delayed frame still has the player to draw
+				frameRenderData.playerEntities.push_back(frameRenderData.snapshotEntity(*playerModel, playerModel->getTransform().getModelMatrix()));
+			}
+
+			WorldEntity* controlTarget_we = controlTarget ? controlTarget->asWorldEntity() : nullptr;
+			if (!controlTarget_we)
+			{
+				continue;
+			}
+			if (const HitPointComponent* hpComp = controlTarget_we->getGameComponent<HitPointComponent>())
+			{
+				hud.health = glm::vec2(hpComp->getHP().current, hpComp->getHP().max);
+			}
+			if (const ShipEnergyComponent* energyComp = controlTarget_we->getGameComponent<ShipEnergyComponent>())
+			{
+				hud.energy = glm::vec2(energyComp->getEnergy(), energyComp->getMaxEnergy());
+			}
+
+			if (const BrainComponent* brainComp = controlTarget_we->getGameComponent<BrainComponent>())
+			{
+				if (const BehaviorTree::Tree* tree = brainComp->getTree())
+				{
+					BehaviorTree::Memory& memory = tree->getMemory();
+					if (const BehaviorTree::ActiveAttackers* attackerMap = memory.getReadValueAs<BehaviorTree::ActiveAttackers>(BT_AttackersKey))
+					{
+						uint32_t attackerIdx = 0;
+						for (auto& iter : *attackerMap)
+						{
+							if (iter.second.attacker)
+							{
+								WorldEntity* attacker = iter.second.attacker.fastGet();
+								frameRenderData.playerAttackers.push_back(RenderData::AttackerSnapshot{ controlTarget_we->getWorldPosition(), attacker->getWorldPosition(), attackerIdx });
+
+								//dynamic cast sucks, but this will likely only be a few per frame. alternatively could set up a component for this. #nextengine in general, find a design to remove this issue of subclass casting
+								RenderModelEntity* attackerModel = bHighlightAttackers ? dynamic_cast<RenderModelEntity*>(attacker) : nullptr;
+								if (attackerModel)
+								{
+									//attackers may be outside the cull, so they get draws of their own
+									frameRenderData.highlights.push_back(RenderData::HighlightSnapshot{ frameRenderData.snapshotEntity(*attackerModel, attackerModel->getTransform().getModelMatrix()), false });
+								}
+							}
+							attackerIdx++;
+						}
+					}
+				}
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// highlight every visible ship
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		if (game.bEnableStencilHighlights && !game.bOnlyHighlightTargets)
+		{
+			//since we're going to be rendering a whole bunch of highlights, reserve the array size to match upper bound of what we're rendering.
+			frameRenderData.highlights.reserve(visibleEntities.size());
+			for (size_t visibleIdx = 0; visibleIdx < visibleEntities.size(); ++visibleIdx)
+			{
+				const RenderModelEntity& renderEntity = *visibleEntities[visibleIdx];
+
+				//ideally I'd would do this this in a more systemic way, but running out of time to finish this. check if this is a spawner (carrier) and don't highlight. 
+				//Perhaps a highlight component could be added and that could be checked for a more roboust system.
+				if (!renderEntity.hasGameComponent<FighterSpawnComponent>()
+					&& !renderEntity.hasGameComponent<OwningPlayerComponent>()//make sure it isn't player
+				)
+				{
+					if (const TeamComponent* teamComp = renderEntity.getGameComponent<TeamComponent>()) //make sure its not an asteroid
+					{
+						//the visible entity's draws are reused; if rendering all ships, their color needs to match whether they're an enemy or a friendly
+						frameRenderData.highlights.push_back(RenderData::HighlightSnapshot{ frameRenderData.entities[visibleIdx], teamComp->getTeam() == playerTeam });
+					}
+				}
+			}
+		}
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// game mode progress for the hud
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		if (ServerGameMode_SpaceBase* serverGameMode = getServerGameMode_SpaceBase())
+		{
+			for (const GameModeTeamData& teamData : serverGameMode->getTeamData())
+			{
+				frameRenderData.teamObjectivesAlive.push_back(teamData.percentAlive_Objectives);
+			}
+		}
+	}
+
 	TeamCommander* SpaceLevelBase::getTeamCommander(size_t teamIdx)
 	{
 		return teamIdx < commanders.size() ? commanders[teamIdx].get() : nullptr;
@@ -651,10 +691,60 @@ namespace SA
 		levelSystem.loadLevel(mainMenuLevel);
 	}
 
+	/** Ships a player is fighting never have their ai slowed down, however far from the camera they are */
+	static bool isFightingPlayer(const WorldEntity& ship)
+	{
+		static PlayerSystem& playerSystem = GameBase::get().getPlayerSystem();
+		for (const sp<PlayerBase>& player : playerSystem.getAllPlayers())
+		{
+			IControllable* controlTarget = player->getControlTarget();
+			WorldEntity* playerShip = controlTarget ? controlTarget->asWorldEntity() : nullptr;
+			if (!playerShip)
+			{
+				continue;
+			}
+			if (playerShip == &ship)
+			{
+				return true;
+			}
+
+			//the ship is targeting the player
+			const BrainComponent* brainComp = ship.getGameComponent<BrainComponent>();
+			if (const BehaviorTree::Tree* tree = brainComp ? brainComp->getTree() : nullptr)
+			{
+				if (tree->getMemory().getReadValueAs<WorldEntity>(BT_TargetKey) == playerShip)
+				{
+					return true;
+				}
+			}
+
+			//the player is targeting the ship, or the ship is attacking the player
+			const BrainComponent* playerBrainComp = playerShip->getGameComponent<BrainComponent>();
+			if (const BehaviorTree::Tree* playerTree = playerBrainComp ? playerBrainComp->getTree() : nullptr)
+			{
+				BehaviorTree::Memory& memory = playerTree->getMemory();
+				if (memory.getReadValueAs<WorldEntity>(BT_TargetKey) == &ship)
+				{
+					return true;
+				}
+				if (const BehaviorTree::ActiveAttackers* attackers = memory.getReadValueAs<BehaviorTree::ActiveAttackers>(BT_AttackersKey))
+				{
+					if (attackers->find(&ship) != attackers->end())
+					{
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
 	void SpaceLevelBase::startLevel_v()
 	{
 		LevelBase::startLevel_v();
 
+		getAILodScheduler().setPlayerRelevance(&isFightingPlayer);
+
 		generationRNG = GameBase::get().getRNGSystem().getTimeInfluencedRNG(); //create a default
 
 		forwardShadedModelShader = new_sp<SA::Shader>(spaceModelShader_forward_vs, spaceModelShader_forward_fs, false);
@@ -696,6 +786,7 @@ namespace SA
 		//transitioning levels being a slow process currently, so each level gets its own shaders.
 		forwardShadedModelShader = nullptr;
 		highlightForwardModelShader = nullptr;
+		shipKinematics.clear();
 
 		LevelBase::endLevel_v();
 	}
@@ -704,8 +795,6 @@ namespace SA
 	{
 		createTypedGrid<AvoidanceSphere>(glm::vec3(128));
 
-		stencilHighlightEntities.reserve(6);
-		
 		starField = onCreateStarField();
 		{ 
 			bGeneratingLocalStars = true;
@@ -729,6 +818,9 @@ namespace SA
 	{
 		LevelBase::tick_v(dt_sec);
 
+		//ships queued their movement while the level ticked entities; move them all together now
+		shipKinematics.run(dt_sec);
+
 		for (sp<Planet>& planet : planets)
 		{
 			planet->tick(dt_sec);
@@ -769,6 +861,16 @@ namespace SA
 		if (spawned)
 		{
 			spawned->onDestroyedEvent->addWeakObj(sp_this(), &SpaceLevelBase::handleEntityDestroyed);
+
+			//asteroids never move so they are baked into the shared static field; carriers carry their field with them
+			if (const AvoidMesh* avoidMesh = dynamic_cast<const AvoidMesh*>(spawned.get()))
+			{
+				avoidanceFields.addStaticOwner(spawned, avoidMesh->getAvoidanceSpheres());
+			}
+			else if (const Ship* ship = dynamic_cast<const Ship*>(spawned.get()))
+			{
+				avoidanceFields.addRigidOwner(spawned, ship->getAvoidanceSpheres());
+			}
 		}
 	}
 
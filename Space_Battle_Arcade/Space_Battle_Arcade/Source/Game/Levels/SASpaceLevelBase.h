@@ -1,6 +1,7 @@
 #pragma once
 #include "GameFramework/SALevel.h"
 #include "Game/Environment/StarJumpData.h"
+#include "Game/SAShipKinematics.h"
 
 
 #include "Game/Environment/Planet.h" //included for init data... probably should be refactored so we can forward declare
@@ -48,6 +49,7 @@ namespace SA
 		bool isStarJumping() const;
 		static void transitionToMainMenu_s();
 		void transitionToMainMenu() { transitionToMainMenu_s(); }
+		ShipKinematicsPhase& getShipKinematics() { return shipKinematics; }
 	public://debug
 		void debug_correctNormalMapSeamsOverride(std::optional<bool> correctNormalMapSeams);
 		void debug_useNormalMappingOverride(std::optional<bool> useNormalMapping);
@@ -58,6 +60,7 @@ namespace SA
 		virtual void endLevel_v() override;
 		virtual void postConstruct() override;
 		virtual void tick_v(float dt_sec) override;
+		virtual void cacheRenderData_v(RenderData& frameRenderData, const std::vector<const RenderModelEntity*>& visibleEntities) override;
 		virtual sp<ServerGameMode_Base> onServerCreateGameMode() override;
 		virtual void onEntitySpawned_v(const sp<WorldEntity>& spawned) override;
 		void handleEntityDestroyed(const sp<GameEntity>& entity);
@@ -88,7 +91,6 @@ namespace SA
 		sp<SA::Shader> debugNormalMapShader;
 		bool bDebugNormals = false;
 		size_t renderMode = 0;
-		std::vector<class RenderModelEntity*> stencilHighlightEntities;
 		StarJumpData sj;
 	protected:
 		sp<ServerGameMode_SpaceBase> spaceGameMode = nullptr;
@@ -97,6 +99,7 @@ namespace SA
 		sp<RNG> generationRNG = nullptr;
 	private: //fields
 		std::vector<sp<TeamCommander>> commanders;
+		ShipKinematicsPhase shipKinematics;
 		sp<const SpaceLevelConfig> levelConfig = nullptr;
 	private: //debug
 		std::optional<bool> useNormalMappingOverride;
@@ -1,4 +1,5 @@
 #include <type_traits>
+#include <algorithm>
 
 #include "Game/SAShip.h"
 
@@ -33,11 +34,15 @@
 #include "Game/GameSystems/SAModSystem.h"
 #include "Game/GameSystems/SAProjectileSystem.h"
 #include "Game/Levels/SASpaceLevelBase.h"
+#include "Game/SAShipKinematics.h"
+#include "ReferenceCode/OpenGL/Algorithms/GJK/GJKNarrowphase.h"
 #include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SpatialHashingComponent.h"
 #include "Rendering/Lights/PointLight_Deferred.h"
+#include "Rendering/RenderData.h"
 #include "Game/SAPlayer.h"
 #include "Game/SAShipPlacements.h"
 #include "Game/SpaceArcade.h"
+#include "Tools/Algorithms/SphereAvoidance/AvoidanceField.h"
 #include "Tools/Algorithms/SphereAvoidance/AvoidanceSphere.h"
 #include "Tools/DataStructures/AdvancedPtrs.h"
 #include "Tools/ModelLoading/SAModel.h"
@@ -444,6 +449,34 @@ namespace SA
 		renderPlacements(turretEntities, shader);
 	}
 
+	void Ship::cacheDraws(RenderData& frameData, const glm::mat4& rawModel) const
+	{
+		//mirrors render, but captures each draw so the frame can be drawn after the ship has moved on
+		frameData.modelDraws.push_back(RenderData::ModelDraw{ getModel(), rawModel * collisionData->getRootXform(), cachedTeamData.teamTint });
+
+		if (avoidanceSpheres.size() > 0 && Ship::bRenderAvoidanceSpheres)
+		{
+			for (const sp<AvoidanceSphere>& avoidSphere : avoidanceSpheres)
+			{
+				avoidSphere->render(); //debug shapes are already queued per frame
+			}
+		}
+
+		static const auto& cachePlacementDraws = [](const std::vector<sp<ShipPlacementEntity>>& placements, RenderData& frameData, const glm::mat4& rawModel)
+		{
+			for (const sp<ShipPlacementEntity>& placement : placements)
+			{
+				if (placement)
+				{
+					placement->cacheDraws(frameData, rawModel);
+				}
+			}
+		};
+		cachePlacementDraws(generatorEntities, frameData, rawModel);
+		cachePlacementDraws(communicationEntities, frameData, rawModel);
+		cachePlacementDraws(turretEntities, frameData, rawModel);
+	}
+
 	void Ship::onDestroyed()
 	{
 		RenderModelEntity::onDestroyed();
@@ -803,8 +836,22 @@ namespace SA
 		////////////////////////////////////////////////////////
 		// handle kinematics
 		////////////////////////////////////////////////////////
-		tickKinematic(dt_sec);
+		//space levels batch ship kinematics so they can run in parallel; the rest of the tick happens after the batch commits
+		SpaceLevelBase* spaceLevel = dynamic_cast<SpaceLevelBase*>(getWorld());
+		if (spaceLevel && collisionHandle)
+		{
+			kinematicPrepare(dt_sec);
+			spaceLevel->getShipKinematics().enqueue(sp_this());
+		}
+		else
+		{
+			tickKinematic(dt_sec);
+			tickPostKinematic(dt_sec);
+		}
+	}
 
+	void Ship::tickPostKinematic(float dt_sec)
+	{
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		// handle VFX
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1004,96 +1051,175 @@ namespace SA
 
 	void Ship::tickKinematic(float dt_sec)
 	{
-		using namespace glm;
-
-		bool bAnyCollision = false;
-		glm::vec4 lastMTV = glm::vec4(0.f);
+		kinematicPrepare(dt_sec);
+		kinematicMove(dt_sec);
+		kinematicResolve();
+		kinematicCommit();
+	}
 
+	void Ship::kinematicPrepare(float dt_sec)
+	{
+		//avoidance may rotate the ship, which broadcasts transform events; so it must happen before the concurrent stages
 		std::optional<glm::vec3> avoidanceVelDir_n = updateAvoidance(dt_sec);
+		kinematicStep.velocity = getVelocity(avoidanceVelDir_n.value_or(velocityDir_n)); //allow an avoidance corrected velocity dir to be used if one exists
+	}
 
-		Transform xform = getTransform();
+	void Ship::kinematicMove(float dt_sec)
+	{
+		kinematicStep.xform = getTransform();
+		kinematicStep.xform.position += kinematicStep.velocity * dt_sec;
+		kinematicStep.lastMTV = glm::vec4(0.f);
+		kinematicStep.lastContactNormal = glm::vec3(0.f);
+		kinematicStep.lastContactPoint = glm::vec3(0.f);
+		kinematicStep.bAnyCollision = false;
 
-		xform.position += getVelocity(avoidanceVelDir_n.value_or(velocityDir_n)) * dt_sec; //allow an avoidance corrected velocity dir to be used if one exists
-		glm::mat4 movedXform_m = xform.getModelMatrix();
+		NAN_BREAK(kinematicStep.xform.position);
 
-		NAN_BREAK(xform.position);
+		//update collision data; other ships will test against these shapes during resolve
+		collisionData->updateToNewWorldTransform(kinematicStep.xform.getModelMatrix());
+	}
 
-		//update collision data
-		collisionData->updateToNewWorldTransform(movedXform_m);
+	void Ship::kinematicResolve()
+	{
+		//only touches this ship's state; the grid and other entities' collision data are read only here
+		using namespace glm;
+		using ShapeData = CollisionData::ShapeData;
 
 		LevelBase* world = getWorld();
-		if (world && collisionHandle)
+		if (!world || !collisionHandle)
 		{
-			SH::SpatialHashGrid<WorldEntity>& worldGrid = world->getWorldGrid();
-			worldGrid.updateEntry(collisionHandle, collisionData->getWorldOBB());
+			return;
+		}
+
+		Transform& xform = kinematicStep.xform;
+		const std::vector<ShapeData>& myShapeData = collisionData->getShapeData();
+
+		if (kinematicShapeProxies.size() != myShapeData.size() || !kinematicOBBProxy)
+		{
+			static const auto& makeProxy = [](const SAT::Shape& source)
+			{
+				return new_sp<SAT::Shape>(source.getLocalPoints(), source.getDebugEdgeIdxs(), source.getDebugFaceIdxs());
+			};
+			kinematicShapeProxies.clear();
+			for (const ShapeData& myShape : myShapeData)
+			{
+				kinematicShapeProxies.push_back(makeProxy(*myShape.shape));
+			}
+			kinematicOBBProxy = makeProxy(*collisionData->getOBBShape());
+		}
+
+		const auto& updateProxies = [&](const glm::mat4& shipXform)
+		{
+			for (size_t shapeIdx = 0; shapeIdx < myShapeData.size(); ++shapeIdx)
+			{
+				kinematicShapeProxies[shapeIdx]->updateTransform(shipXform * myShapeData[shapeIdx].localXform);
+			}
+			kinematicOBBProxy->updateTransform(shipXform * collisionData->getAABBLocalXform());
+		};
+		updateProxies(xform.getModelMatrix());
 
-			//test against all overlapping grid nodes
-			overlappingNodes_SH.clear();
-			worldGrid.lookupNodesInCells(*collisionHandle, overlappingNodes_SH);
-			for (sp <SH::GridNode<WorldEntity>> node : overlappingNodes_SH)
+		//the grid still holds last frame's cells for every entity; that snapshot is what makes this stage safe to run concurrently
+		SH::SpatialHashGrid<WorldEntity>& worldGrid = world->getWorldGrid();
+		worldGrid.lookupCellsForOOB(collisionData->getWorldOBB(), overlappingCells_SH);
+		overlappingNodes_SH.clear();
+		overlappingNodesFound_SH.clear();
+		for (const sp<const SH::HashCell<WorldEntity>>& cell : overlappingCells_SH)
+		{
+			for (const sp<SH::GridNode<WorldEntity>>& node : cell->nodeBucket)
 			{
-				CollisionComponent* otherCollisionComp = node->element.getGameComponent<CollisionComponent>();
-				if (otherCollisionComp && otherCollisionComp->requestsCollisionChecks())
+				if (&node->element != this && overlappingNodesFound_SH.insert(node.get()).second)
 				{
-					if (CollisionData* otherCollisionData = otherCollisionComp->getCollisionData()) //#todo #optimize so component will always have this data, but it can contain no shapes, to avoid branches. similar to nullobject pattern
-					{
-						using ShapeData = CollisionData::ShapeData;
-						const std::vector<ShapeData>& myShapeData = collisionData->getShapeData();
-						const std::vector<ShapeData>& otherShapeData = otherCollisionData->getShapeData();
+					overlappingNodes_SH.push_back(node);
+				}
+			}
+		}
+
+		//test against all overlapping grid nodes
+		for (const sp<SH::GridNode<WorldEntity>>& node : overlappingNodes_SH)
+		{
+			CollisionComponent* otherCollisionComp = node->element.getGameComponent<CollisionComponent>();
+			if (otherCollisionComp && otherCollisionComp->requestsCollisionChecks())
+			{
+				if (CollisionData* otherCollisionData = otherCollisionComp->getCollisionData()) //#todo #optimize so component will always have this data, but it can contain no shapes, to avoid branches. similar to nullobject pattern
+				{
+					const std::vector<ShapeData>& otherShapeData = otherCollisionData->getShapeData();
 
-						//make sure OOB's collide as an optimization
-						if (SAT::Shape::CollisionTest(*collisionData->getOBBShape(), *otherCollisionData->getOBBShape()))
+					//make sure OOB's collide as an optimization
+					if (SAT::Shape::CollisionTest(*kinematicOBBProxy, *otherCollisionData->getOBBShape()))
+					{
+						bool bCollision = false;
+						size_t numAttempts = 3;
+						size_t attempt = 0;
+						do
 						{
-							bool bCollision = false;
-							size_t numAttempts = 3;
-							size_t attempt = 0;
-							do
-							{
-								attempt++;
-								bCollision = false;
+							attempt++;
+							bCollision = false;
 
-								glm::vec4 largestMTV = glm::vec4(0.f);
-								float largestMTV_len2 = 0.f;
-								for (const ShapeData& myShape : myShapeData)
+							glm::vec4 largestMTV = glm::vec4(0.f);
+							float largestMTV_len2 = 0.f;
+							for (const sp<SAT::Shape>& myShape : kinematicShapeProxies)
+							{
+								for (const ShapeData& worldShape : otherShapeData)
 								{
-									for (const ShapeData& worldShape : otherShapeData)
+									assert(myShape && worldShape.shape);
+									GJK::ContactResult contact;
+									if (GJK::penetration(*myShape, *worldShape.shape, contact))
 									{
-										assert(myShape.shape && worldShape.shape);
-										glm::vec4 mtv;
-										if (SAT::Shape::CollisionTest(*myShape.shape, *worldShape.shape, mtv))
+										glm::vec4 mtv = glm::vec4(contact.getMTV() * SAT::Shape::floatMTVCorrectionFactor, 0.f);
+										float mtv_len2 = glm::length2(mtv);
+										if (mtv_len2 > largestMTV_len2)
 										{
-											float mtv_len2 = glm::length2(mtv);
-											if (mtv_len2 > largestMTV_len2)
-											{
-												largestMTV_len2 = mtv_len2;
-												largestMTV = lastMTV = mtv;
-												bCollision = bAnyCollision = true;
-											}
+											largestMTV_len2 = mtv_len2;
+											largestMTV = kinematicStep.lastMTV = mtv;
+											kinematicStep.lastContactNormal = contact.normal;
+											kinematicStep.lastContactPoint = contact.getContactPoint();
+											bCollision = kinematicStep.bAnyCollision = true;
 										}
 									}
 								}
-								if (bCollision)
-								{
-									xform.position += glm::vec3(largestMTV);
-									collisionData->updateToNewWorldTransform(xform.getModelMatrix());
-								}
-							} while (bCollision && attempt < numAttempts);
-							//perhaps we should revert back to original xform is it fails collision tests for all attempts.
-						}
+							}
+							if (bCollision)
+							{
+								xform.position += glm::vec3(largestMTV);
+								updateProxies(xform.getModelMatrix());
+							}
+						} while (bCollision && attempt < numAttempts);
+						//perhaps we should revert back to original xform is it fails collision tests for all attempts.
 					}
 				}
 			}
+		}
+	}
+
+	void Ship::kinematicCommit()
+	{
+		using namespace glm;
+
+		LevelBase* world = getWorld();
+		if (world && collisionHandle)
+		{
+			Transform& xform = kinematicStep.xform;
+
+			//resolution only moved the proxies, bring the real collision data along
+			if (kinematicStep.bAnyCollision)
+			{
+				collisionData->updateToNewWorldTransform(xform.getModelMatrix());
+			}
+
+			SH::SpatialHashGrid<WorldEntity>& worldGrid = world->getWorldGrid();
+			worldGrid.updateEntry(collisionHandle, collisionData->getWorldOBB());
+
 #if SA_CAPTURE_SPATIAL_HASH_CELLS
 			SpatialHashCellDebugVisualizer::appendCells(worldGrid, *collisionHandle);
 #endif //SA_CAPTURE_SPATIAL_HASH_CELLS
 
-			if (bAnyCollision)
+			if (kinematicStep.bAnyCollision)
 			{
 				if (bCollisionReflectForward)
 				{
-					//MTV in the case of faces will be something like the face normal; however this may not look to great for deflecting off of edges
+					//the contact normal follows the touching features, so edge and corner hits deflect along the surface that was actually hit
 					glm::vec4 forward_n = getForwardDir();
-					glm::vec4 reflectedForward_n = normalize(glm::reflect(forward_n, glm::normalize(lastMTV))); //may not need to normalize
+					glm::vec4 reflectedForward_n = normalize(glm::reflect(forward_n, glm::vec4(kinematicStep.lastContactNormal, 0.f))); //may not need to normalize
 					setVelocityDir(reflectedForward_n);
 					xform.rotQuat = Utils::getRotationBetween(forward_n, reflectedForward_n) * xform.rotQuat;
 				}
@@ -1102,7 +1228,7 @@ namespace SA
 
 			setTransform(xform); //set after collision is handled so we do not continually update/broadcast events
 
-			if (bAnyCollision && onCollided.numBound() > 0) { onCollided.broadcast(); } //broadcasting after we've updated transform
+			if (kinematicStep.bAnyCollision && onCollided.numBound() > 0) { onCollided.broadcast(); } //broadcasting after we've updated transform
 
 #define EXTRA_SHIP_DEBUG_INFO 0
 #if EXTRA_SHIP_DEBUG_INFO
@@ -1342,7 +1468,22 @@ namespace SA
 			static LevelSystem& levelSystem = GameBase::get().getLevelSystem();
 			if (const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel())
 			{
-				if (SH::SpatialHashGrid<AvoidanceSphere>* avoidGrid = currentLevel->getTypedGrid<AvoidanceSphere>())
+				const AvoidanceFieldSet& avoidanceFields = currentLevel->getAvoidanceFields();
+				if (avoidanceFields.hasFields())
+				{
+					//every avoidance sphere in the level is baked into a field; a few trilinear samples replace the grid walk
+					const vec4 push = avoidanceFields.sample(getTransform().position, this);
+					const float pushLength = glm::length(vec3(push));
+
+					adjustVel_n = velocityDir_n;
+					float avoidStrength = glm::min(pushLength, 1.f) * avoidanceSensitivity; //some use cases (eg targeting player) require depended avoidance with known cost of collision
+					if (avoidStrength > 0.01f)
+					{
+						dampenAvoidanceVelocity(*adjustVel_n, vec3(push) / pushLength, avoidStrength);
+						accumulatedStrength += push.w * avoidanceSensitivity;
+					}
+				}
+				else if (SH::SpatialHashGrid<AvoidanceSphere>* avoidGrid = currentLevel->getTypedGrid<AvoidanceSphere>())
 				{
 					static std::vector<sp<const SH::HashCell<AvoidanceSphere>>> nearbyCells;
 					static const int oneTimeInit = [](decltype(nearbyCells)& initVector) { initVector.reserve(10); return 0; } (nearbyCells);
@@ -1374,40 +1515,16 @@ namespace SA
 
 					for (AvoidanceSphere* avoid : uniqueNodes)
 					{
-						//#TODO this whole logic can probably be inverted to be clear(being based on vectors towards center), but avoiding changing atm as this is known to work
 						const vec3 toMe_v = myXform.position - avoid->getWorldPosition();
-						float toMeLen = glm::length(toMe_v);
-						float radiusFrac = toMeLen / avoid->getRadius(); //This needs clamping [0,1] after processing. should never be zero, avoidance sphere asserts if set to zero radius. 
-
-						radiusFrac = glm::clamp(radiusFrac, 0.f, 1.f);
-						float maxAvoidAtRadiusFrac = avoid->getRadiusFractForMaxAvoidance(); //range [0,1]
-						float remappedRadiusFrac = glm::clamp(radiusFrac - maxAvoidAtRadiusFrac, 0.f, 1.f); //makes a new range [0,1]
-						remappedRadiusFrac /= (1.0f - maxAvoidAtRadiusFrac); //bring this back to a [0,1] range
-						float avoidStrength = 1.f - remappedRadiusFrac;
-
+						float avoidStrength = avoidanceStrength(glm::length(toMe_v), avoid->getRadius(), avoid->getRadiusFractForMaxAvoidance());
 						avoidStrength *= avoidanceSensitivity; //some use cases (eg targeting player) require depended avoidance with known cost of collision
 
 						if (avoidStrength > 0.01f)
 						{
-							////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-							// Project the velocity onto the vector to radius, this gives us a component of velocity that is going towards
-							// the sphere center. We dampen this part of the velocity only. Effectively we trim out this part of the velocity
-							////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-							const vec3 toSphereCenter_n = glm::normalize(-toMe_v);
-							float velocityProjection = glm::dot(toSphereCenter_n, * adjustVel_n);
-							velocityProjection = glm::clamp(velocityProjection, 0.f, 1.f);	//clamp out velocity pointing AWAY from radius
-							vec3 dampenVector_v = -(toSphereCenter_n * velocityProjection); //this logic oculd be simplified by moving -s around and just using toMe_v; but expresssed this way it may be more clear what is happening geometrically?
-
-							dampenVector_v *= avoidStrength; //have a smooth dampening effect based on distance to radius
-							vec3 dampenedVel_v = *adjustVel_n + dampenVector_v; //must normalize for next projection
-							//don't make velocity a zero vector
-							if (!Utils::float_equals(glm::length2(*adjustVel_n), 0.0f))
-							{
-								adjustVel_n = normalize(dampenedVel_v);
+							dampenAvoidanceVelocity(*adjustVel_n, glm::normalize(toMe_v), avoidStrength);
 
-								//if this line below is flashing, it is likely we're generating zero vectors (not yet seen, but consciously putting this in branch so that can be indicated)
-								if constexpr (constexpr bool bDebugToMeVec = false) { SpaceArcade::get().getDebugRenderSystem().renderLine(myXform.position, avoid->getWorldPosition(), 0.5f*color::metalicgold()); }
-							}
+							//if this line below is flashing, it is likely we're generating zero vectors (not yet seen, but consciously putting this in branch so that can be indicated)
+							if constexpr (constexpr bool bDebugToMeVec = false) { SpaceArcade::get().getDebugRenderSystem().renderLine(myXform.position, avoid->getWorldPosition(), 0.5f*color::metalicgold()); }
 
 							accumulatedStrength += avoidStrength;
 						}
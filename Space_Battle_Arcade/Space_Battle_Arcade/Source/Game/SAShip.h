@@ -1,5 +1,6 @@
 #pragma once
 #include <optional>
+#include <unordered_set>
 #include "Game/AssetConfigs/SASpawnConfig.h"
 #include "GameFramework/Components/GameplayComponents.h"
 #include "GameFramework/Interfaces/SAIControllable.h"
@@ -73,6 +74,7 @@ namespace SA
 		// Interface and Virtuals
 		////////////////////////////////////////////////////////
 		virtual void render(Shader& shader) override;
+		virtual void cacheDraws(RenderData& frameData, const glm::mat4& modelMatrix) const override;
 		//virtual void onLevelRender() override;
 		void onDestroyed() override;
 
@@ -171,6 +173,7 @@ namespace SA
 		static void setRenderAvoidanceSpheres(bool bNewRenderAvoidance);
 		void debugRender_avoidance(float accumulatedAvoidanceStrength) const;
 		bool hasAvoidanceSpheres() { return avoidanceSpheres.size() > 0; }
+		const std::vector<sp<class AvoidanceSphere>>& getAvoidanceSpheres() const { return avoidanceSpheres; }
 		////////////////////////////////////////////////////////
 		// objectives
 		////////////////////////////////////////////////////////
@@ -197,7 +200,14 @@ namespace SA
 		virtual void tick(float deltatime) override;
 	private:
 		friend class ShipCameraTweakerWidget; //allow camera tweaker widget to modify ship properties in real time.
+		friend class ShipKinematicsPhase;
 		void tickKinematic(float dt_sec);
+		void tickPostKinematic(float dt_sec);
+		//kinematic stages, see ShipKinematicsPhase; prepare and commit are serial, move and resolve may run concurrently with other ships
+		void kinematicPrepare(float dt_sec);
+		void kinematicMove(float dt_sec);
+		void kinematicResolve();
+		void kinematicCommit();
 		void tickSounds();
 		std::optional<glm::vec3> updateAvoidance(float dt_sec);
 		virtual void notifyProjectileCollision(const Projectile& hitProjectile, glm::vec3 hitLoc) override;
@@ -226,6 +236,9 @@ namespace SA
 #endif //COMPILE_CHEATS
 	public:
 		MultiDelegate<> onCollided;
+		/** world space contact of the deepest collision from the last kinematic step; valid while handling onCollided */
+		glm::vec3 getLastContactPoint() const { return kinematicStep.lastContactPoint; }
+		glm::vec3 getLastContactNormal() const { return kinematicStep.lastContactNormal; }
 	private: //statics
 		static bool bRenderAvoidanceSpheres;
 	private: //cheat flags
@@ -233,6 +246,24 @@ namespace SA
 	private:
 		//helper data structures
 		std::vector<sp<SH::GridNode<WorldEntity>>> overlappingNodes_SH;
+		std::vector<sp<const SH::HashCell<WorldEntity>>> overlappingCells_SH;
+		std::unordered_set<const SH::GridNode<WorldEntity>*> overlappingNodesFound_SH; //dedupes while keeping cell order, so resolution order never depends on heap addresses
+
+		/** state carried between the kinematic stages within a frame */
+		struct KinematicStep
+		{
+			Transform xform;
+			glm::vec3 velocity{ 0.f };
+			glm::vec4 lastMTV{ 0.f };
+			glm::vec3 lastContactNormal{ 0.f };
+			glm::vec3 lastContactPoint{ 0.f };
+			bool bAnyCollision = false;
+		};
+		KinematicStep kinematicStep;
+
+		/** private copies of the collision shapes used for collision resolution, so other ships can read the real shapes while this ship resolves */
+		std::vector<sp<SAT::Shape>> kinematicShapeProxies;
+		sp<SAT::Shape> kinematicOBBProxy;
 	private:
 		up<SH::HashEntry<WorldEntity>> collisionHandle = nullptr; //#TODO not sure if this should be on the collision component, keeping it off the component encapsulates it better.
 		const sp<CollisionData> collisionData; //#TODO perhaps just reference what's in the component so we don't have two pointers
@@ -0,0 +1,55 @@
+#include "Game/SAShipKinematics.h"
+
+#include <cassert>
+
+#include "Game/SAShip.h"
+#include "GameFramework/SAGameBase.h"
+
+namespace SA
+{
+	void ShipKinematicsPhase::enqueue(const sp<Ship>& ship)
+	{
+		assert(!bRunning);
+		pendingShips.push_back(ship);
+	}
+
+	void ShipKinematicsPhase::run(float dt_sec)
+	{
+		//swap out the pending ships so anything spawned while committing is picked up next frame
+		runningShips.clear();
+		std::swap(runningShips, pendingShips);
+		bRunning = true;
+
+		//a handful of ships per batch keeps the workers balanced between fighters and much more expensive carriers
+		constexpr size_t shipsPerBatch = 4;
+		JobSystem& jobSystem = GameBase::get().getJobSystem();
+
+		jobSystem.parallelFor(runningShips.size(), shipsPerBatch, [this, dt_sec](size_t shipIdx) {
+			runningShips[shipIdx]->kinematicMove(dt_sec);
+		});
+
+		//resolve reads other ships' moved shapes, so every move must be complete before it starts
+		jobSystem.parallelFor(runningShips.size(), shipsPerBatch, [this](size_t shipIdx) {
+			runningShips[shipIdx]->kinematicResolve();
+		});
+
+		//ships destroyed since they queued are skipped, including those destroyed by an earlier commit's onCollided
+		for (const sp<Ship>& ship : runningShips)
+		{
+			if (!ship->isPendingDestroy())
+			{
+				ship->kinematicCommit();
+			}
+		}
+		bRunning = false;
+
+		for (const sp<Ship>& ship : runningShips)
+		{
+			if (!ship->isPendingDestroy())
+			{
+				ship->tickPostKinematic(dt_sec);
+			}
+		}
+		runningShips.clear();
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+
+#include "GameFramework/SAGameEntity.h"
+
+namespace SA
+{
+	class Ship;
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Batches ship movement and collision resolution for every ship ticked this frame.
+	//
+	// Ships enqueue themselves during their tick, then the level runs the phase once all entities have ticked:
+	//		1. move (parallel): each ship moves to its new transform and updates its own collision shapes.
+	//		2. resolve (parallel): each ship finds neighbours in the spatial hash, which still holds last frame's
+	//			cells, and resolves collisions using private copies of its shapes. Nothing shared is written.
+	//		3. commit (serial, in enqueue order): grid updates, transform updates and onCollided broadcasts.
+	//		4. the remainder of each ship's tick (vfx, placements, spawning) runs, serially.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class ShipKinematicsPhase
+	{
+	public:
+		void enqueue(const sp<Ship>& ship);
+		void run(float dt_sec);
+		void clear() { pendingShips.clear(); }
+
+	private:
+		std::vector<sp<Ship>> pendingShips;
+		std::vector<sp<Ship>> runningShips;
+		bool bRunning = false;
+	};
+}
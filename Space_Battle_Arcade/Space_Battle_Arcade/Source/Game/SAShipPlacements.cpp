@@ -132,6 +132,15 @@ namespace SA
 		}
 	}
 
+	void ShipPlacementEntity::cacheDraws(RenderData& frameData, const glm::mat4& /*shipModelMatrix*/) const
+	{
+		//the ship keeps cachedModelMat_PxL in step with its own transform, so it already matches the frame being cached
+		if (!isPendingDestroy() && getModel())
+		{
+			frameData.modelDraws.push_back(RenderData::ModelDraw{ getModel(), cachedModelMat_PxL, std::nullopt });
+		}
+	}
+
 	glm::vec3 ShipPlacementEntity::getWorldPosition() const
 	{
 		//#TODO #scenenodes this may need updating
@@ -1201,30 +1210,41 @@ namespace SA
 	{
 		Parent::render(shader);
 
-		using namespace glm;
 		if (activeSeeker)
 		{
 			static RenderSystem& renderSystem = GameBase::get().getRenderSystem();
 			if (const RenderData* frd = renderSystem.getFrameRenderData_Read(GameBase::get().getFrameNumber()))
 			{
-				seekerShader->use();
-				mat4 model = activeSeeker->xform.getModelMatrix();
-				mat4 projection_view = frd->projection * frd->view;
+				renderHealSeeker(activeSeeker->xform.getModelMatrix(), frd->projection * frd->view);
+			}
+		}
+	}
 
-				seekerShader->setUniformMatrix4fv("projection_view", 1, GL_FALSE, glm::value_ptr(projection_view));
-				seekerShader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(model));
-				seekerShader->setUniform3f("uniformColor", color::green() * (GameBase::get().getRenderSystem().isUsingHDR() ? 3.f : 1.f)); //@hdr_tweak
-				
-				const uint32_t textureSlot = GL_TEXTURE0;
-				ec(glActiveTexture(textureSlot));
-				ec(glBindTexture(GL_TEXTURE_2D, tessellatedTextureID));
-				seekerShader->setUniform1i("tessellateTex", textureSlot - GL_TEXTURE0);
+	void CommunicationPlacement::cacheDraws(RenderData& frameData, const glm::mat4& shipModelMatrix) const
+	{
+		Parent::cacheDraws(frameData, shipModelMatrix);
 
-				seekerModel->draw(*seekerShader, false);
-			}
+		if (activeSeeker && !isPendingDestroy())
+		{
+			frameData.healSeekers.push_back(activeSeeker->xform.getModelMatrix());
 		}
 	}
 
+	void CommunicationPlacement::renderHealSeeker(const glm::mat4& model, const glm::mat4& projection_view)
+	{
+		seekerShader->use();
+		seekerShader->setUniformMatrix4fv("projection_view", 1, GL_FALSE, glm::value_ptr(projection_view));
+		seekerShader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(model));
+		seekerShader->setUniform3f("uniformColor", color::green() * (GameBase::get().getRenderSystem().isUsingHDR() ? 3.f : 1.f)); //@hdr_tweak
+
+		const uint32_t textureSlot = GL_TEXTURE0;
+		ec(glActiveTexture(textureSlot));
+		ec(glBindTexture(GL_TEXTURE_2D, tessellatedTextureID));
+		seekerShader->setUniform1i("tessellateTex", textureSlot - GL_TEXTURE0);
+
+		seekerModel->draw(*seekerShader, false);
+	}
+
 	void CommunicationPlacement::onTargetSet(TargetType* rawTarget)
 	{
 		Parent::onTargetSet(rawTarget);
@@ -68,6 +68,7 @@ namespace SA
 		virtual void onDestroyed() override; 
 	public:
 		virtual void render(Shader& shader) override;
+		virtual void cacheDraws(RenderData& frameData, const glm::mat4& shipModelMatrix) const override;
 		virtual glm::vec3 getWorldPosition() const override;
 		glm::vec3 getWorldForward_n() const;
 		glm::vec3 getLocalForward_n() const { return forward_ln; }
@@ -213,7 +214,11 @@ namespace SA
 		virtual void replacePlacementConfig(const PlacementSubConfig& newConfig, const ConfigBase& owningConfig) override;
 		virtual void onDestroyed() override;
 		virtual void render(Shader& shader) override;
+		virtual void cacheDraws(RenderData& frameData, const glm::mat4& shipModelMatrix) const override;
 		virtual void onTargetSet(TargetType* rawTarget) override;
+	public:
+		/** Draws one heal seeker; render passes the seekers captured in a frame's render data */
+		static void renderHealSeeker(const glm::mat4& model, const glm::mat4& projection_view);
 	private:
 		static sp<Model3D> seekerModel;
 		static sp<Shader> seekerShader;
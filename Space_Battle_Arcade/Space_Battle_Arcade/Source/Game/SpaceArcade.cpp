@@ -1,7 +1,11 @@
 #include "Game/SpaceArcade.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <random>
+#include <sstream>
 
 #include "Rendering/SAWindow.h"
 #include "Rendering/OpenGLHelpers.h"
@@ -14,6 +18,7 @@
 #include "GameFramework/Input/SAInput.h"
 #include "GameFramework/SAAssetSystem.h"
 #include "GameFramework/SALevelSystem.h"
+#include "GameFramework/SALogBackend.h"
 
 #include "Tools/SAUtilities.h"
 #include "Tools/ModelLoading/SAModel.h"
@@ -142,9 +147,53 @@ namespace SA
 #endif //IGNORE_INCOMPLETE_DEFERRED_RENDER_CODE
 	}
 
+	SA::HeadlessResult SpaceArcade::runHeadless(const HeadlessConfig& config, const std::string& levelName)
+	{
+		headlessLevelName = levelName;
+		return startHeadless(config);
+	}
+
+	void SpaceArcade::startUp_Headless()
+	{
+		//only simulation state; shaders, UI, and the console all need a window
+		sp<SAPlayer> playerZero = getPlayerSystem().createPlayer<SAPlayer>();
+		collisionShapeFactory = new_sp<CollisionShapeFactory>();
+
+		fpsCamera = new_sp<SA::CameraFPS>(45.f, 0.f, 0.f);
+		playerZero->setCamera(fpsCamera);
+
+		sp<LevelBase> headlessLevel = nullptr;
+		if (headlessLevelName == "stress")
+		{
+			headlessLevel = new_sp<StressTestLevel>();
+		}
+		else if (const sp<Mod>& activeMod = modSystem->getActiveMod())
+		{
+			const std::map<std::string, sp<SpaceLevelConfig>>& levelConfigs = activeMod->getLevelConfigs();
+			auto findResult = levelConfigs.find(headlessLevelName);
+			if (findResult != levelConfigs.end())
+			{
+				sp<SpaceLevelBase> spaceLevel = new_sp<SpaceLevelBase>();
+				spaceLevel->setConfig(findResult->second);
+				headlessLevel = spaceLevel;
+			}
+		}
+
+		if (!headlessLevel)
+		{
+			logf_sa(__FUNCTION__, LogLevel::LOG_ERROR, "Headless: no level named \"%s\" in the active mod", headlessLevelName.c_str());
+			startShutdown();
+			return;
+		}
+		getLevelSystem().loadLevel(headlessLevel);
+	}
+
 	void SpaceArcade::onShutDown() 
 	{
-		fpsCamera->deregisterToWindowCallbacks_v();
+		if (fpsCamera)
+		{
+			fpsCamera->deregisterToWindowCallbacks_v();
+		}
 	}
 
 	void SpaceArcade::toggleEditorUIMainMenuVisible()
@@ -196,6 +245,11 @@ namespace SA
 	{
 		using glm::vec3; using glm::vec4; using glm::mat4;
 
+		if (isHeadless())
+		{
+			return; //no input, console, or editor UI without a window; systems and the level still tick
+		}
+
 		const sp<Window>& window = getWindowSystem().getPrimaryWindow();
 		if (!window)
 		{
@@ -251,10 +305,17 @@ namespace SA
 					FRD.view = camera->getView();
 					FRD.projection = camera->getPerspective();
 					FRD.projection_view = FRD.projection * FRD.view;
+					FRD.bHasCameraFrustum = true;
 					FRD.playerCamerasPositions[0] = camera->getPosition();
+					FRD.camera = RenderData::CameraSnapshot{ camera->getPosition(), camera->getFront(), camera->getRight(), camera->getUp(), camera->getQuat(), camera->getFOV(), camera->getNear() };
 				}
 			}
 		}
+
+		if (projectileSystem)
+		{
+			projectileSystem->cacheRenderData(FRD);
+		}
 	}
 
 	void SpaceArcade::renderLoop_begin(float deltaTimeSecs)
@@ -533,11 +594,139 @@ namespace
 
 		return 0;
 	}
+
+	/** usage: -headless <levelName|stress> [frames] [seed]; prints the world state hash so runs can be compared */
+	int headlessMain(int argc, char** argv)
+	{
+		if (argc < 3)
+		{
+			std::cerr << "usage: -headless <levelName|stress> [frames] [seed]" << std::endl;
+			return 1;
+		}
+
+		SA::HeadlessConfig config;
+		std::string levelName = argv[2];
+		if (argc > 3) { config.numFrames = std::strtoull(argv[3], nullptr, 10); }
+		if (argc > 4) { config.rngSeed = uint32_t(std::strtoul(argv[4], nullptr, 10)); }
+
+		SA::HeadlessResult result;
+		{
+			SA::SpaceArcade& game = SA::SpaceArcade::get();
+			result = game.runHeadless(config, levelName);
+		}
+
+		std::cout << "headless " << levelName << " seed " << config.rngSeed
+			<< " frames " << result.simulatedFrames
+			<< " sim " << result.wallSecs << "s"
+			<< " hash " << std::hex << result.worldStateHash << std::dec << std::endl;
+		return result.simulatedFrames == config.numFrames ? 0 : 1;
+	}
+
+	/** usage: -determinism <levelName|stress> [frames] [seed] [runs]; runs the headless simulation in fresh processes and
+		fails unless every run ends with the same world state hash. The game is a singleton, so runs can't share a process. */
+	int determinismMain(int argc, char** argv)
+	{
+		if (argc < 3)
+		{
+			std::cerr << "usage: -determinism <levelName|stress> [frames] [seed] [runs]" << std::endl;
+			return 1;
+		}
+
+		const std::string levelName = argv[2];
+		const std::string frames = argc > 3 ? argv[3] : std::to_string(SA::HeadlessConfig{}.numFrames);
+		const std::string seed = argc > 4 ? argv[4] : std::to_string(SA::HeadlessConfig{}.rngSeed);
+		const size_t numRuns = std::max<size_t>(2, argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 2);
+
+		std::vector<std::string> runHashes;
+		for (size_t run = 0; run < numRuns; ++run)
+		{
+			const std::filesystem::path runOutput = std::filesystem::temp_directory_path() / ("sa_determinism_run" + std::to_string(run) + ".txt");
+			std::string command = "\"" + std::string(argv[0]) + "\" -headless \"" + levelName + "\" " + frames + " " + seed + " > \"" + runOutput.string() + "\"";
+#ifdef _WIN32
+			command = "\"" + command + "\""; //cmd strips the outer quotes of a command line that starts with a quote
+#endif
+			const int exitCode = std::system(command.c_str());
+
+			std::ifstream outputFile(runOutput);
+			std::stringstream output;
+			output << outputFile.rdbuf();
+			outputFile.close();
+			std::error_code ignored;
+			std::filesystem::remove(runOutput, ignored);
+
+			const std::string outputText = output.str();
+			const size_t hashPos = outputText.rfind(" hash ");
+			if (exitCode != 0 || hashPos == std::string::npos)
+			{
+				std::cerr << "determinism: run " << run << " failed (exit code " << exitCode << ")" << std::endl << outputText;
+				return 1;
+			}
+			std::istringstream hashStream(outputText.substr(hashPos + 6));
+			std::string hash;
+			hashStream >> hash;
+			runHashes.push_back(hash);
+			std::cout << "run " << run << ": " << outputText;
+		}
+
+		const bool bDeterministic = std::all_of(runHashes.begin(), runHashes.end(), [&](const std::string& hash) { return hash == runHashes.front(); });
+		std::cout << "determinism " << levelName << " seed " << seed << " frames " << frames << ": "
+			<< (bDeterministic ? "all runs match" : "RUNS DIVERGED") << std::endl;
+		return bDeterministic ? 0 : 1;
+	}
+
+	/** usage: -decodelog <binaryLog> [textOut]; renders a log written through BINARY_LOG_PATH as text, to stdout if no output is given */
+	int decodeLogMain(int argc, char** argv)
+	{
+		if (argc < 3)
+		{
+			std::cerr << "usage: -decodelog <binaryLog> [textOut]" << std::endl;
+			return 1;
+		}
+
+		std::ifstream binaryLog(argv[2], std::ios::binary);
+		if (!binaryLog.is_open())
+		{
+			std::cerr << "could not open " << argv[2] << std::endl;
+			return 1;
+		}
+
+		std::ofstream textFile;
+		if (argc > 3)
+		{
+			textFile.open(argv[3]);
+			if (!textFile.is_open())
+			{
+				std::cerr << "could not open " << argv[3] << std::endl;
+				return 1;
+			}
+		}
+
+		std::string error;
+		const bool bDecoded = SA::logging::decodeBinaryLog(binaryLog, textFile.is_open() ? textFile : std::cout, error);
+		if (!bDecoded)
+		{
+			std::cerr << argv[2] << ": " << error << std::endl;
+		}
+		return bDecoded ? 0 : 1;
+	}
 }
 
 
-int main()
+int main(int argc, char** argv)
 {
+	if (argc > 1 && std::string(argv[1]) == "-headless")
+	{
+		return headlessMain(argc, argv);
+	}
+	if (argc > 1 && std::string(argv[1]) == "-determinism")
+	{
+		return determinismMain(argc, argv);
+	}
+	if (argc > 1 && std::string(argv[1]) == "-decodelog")
+	{
+		return decodeLogMain(argc, argv);
+	}
+
 	int result = trueMain();
 	return result;
 }
\ No newline at end of file
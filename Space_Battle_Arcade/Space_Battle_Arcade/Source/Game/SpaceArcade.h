@@ -5,6 +5,7 @@
 #include<GLFW/glfw3.h>
 #include <vector>
 #include <map>
+#include <string>
 #include "GameFramework/RenderModelEntity.h"
 #include "SAUniformResourceLocators.h"
 #include "Game/OptionalCompilationMacros.h"
@@ -38,9 +39,13 @@ namespace SA
 	{
 	public:
 		static SpaceArcade& get();
+
+		/** Simulates levelName without a window; "stress" runs the stress test level, anything else names a level config in the active mod. */
+		HeadlessResult runHeadless(const HeadlessConfig& config, const std::string& levelName);
 	private:
 		virtual sp<Window> makeInitialWindow() override;
 		virtual void startUp() override; 
+		virtual void startUp_Headless() override;
 		virtual void onShutDown() override;
 		virtual void tickGameLoop(float deltaTimeSecs) override;
 		virtual void cacheRenderDataForCurrentFrame(struct RenderData& frameRenderData) override;
@@ -134,6 +139,7 @@ namespace SA
 
 	private:
 		sp<SA::CameraFPS> fpsCamera;
+		std::string headlessLevelName;
 
 		//shaders
 		sp<Shader> litObjShader;
@@ -5,6 +5,8 @@
 #include "GameFramework/SAWorldEntity.h"
 #include "Game/Components/FighterSpawnComponent.h"
 
+#include <limits>
+
 namespace SA
 {
 	TeamCommander::TeamCommander(size_t team)
@@ -20,44 +22,15 @@ namespace SA
 		}
 	}
 
-	sp<WorldEntity> TeamCommander::getTargetOnTeam(size_t team)
-	{
-		if (pendingTargetsByTeam.size() >= team + 1)
-		{
-			std::stack<lp<WorldEntity>>& targetStack = pendingTargetsByTeam[team];
-			
-			lp<WorldEntity> target;
-			while (!target && targetStack.size() > 0)
-			{
-				target = targetStack.top();
-				targetStack.pop();
-			}
-
-			if (target)
-			{
-				return target.toSP();
-			}
-		}
-
-		return sp<WorldEntity>(nullptr);
-	}
-
 	bool TeamCommander::queueTarget(const sp<WorldEntity>& target)
 	{
 		TeamComponent* myTeamComp = getGameComponent<TeamComponent>();
-		if (TeamComponent* spawnTeamCom = target->getGameComponent<TeamComponent>())
+		if (TeamComponent* targetTeamCom = target->getGameComponent<TeamComponent>())
 		{
-			size_t spawnedTeam = spawnTeamCom->getTeam();
-			if (spawnedTeam != myTeamComp->getTeam())
+			if (targetTeamCom->getTeam() != myTeamComp->getTeam())
 			{
-				if (pendingTargetsByTeam.size() < spawnedTeam + 1)
-				{
-					pendingTargetsByTeam.resize(spawnedTeam + 1);
-				}
-
-				std::stack<lp<WorldEntity>>& targets = pendingTargetsByTeam[spawnedTeam];
-				targets.push(target);
-
+				//returned targets are found again by the next nearest enemy query that reaches them
+				assignedTargets.erase(target->getSpawnId());
 				return true;
 			}
 		}
@@ -79,15 +52,23 @@ namespace SA
 		}
 	}
 
-	sp<SA::WorldEntity> TeamCommander::getTarget()
+	sp<SA::WorldEntity> TeamCommander::getTarget(const glm::vec3& requesterPosition)
 	{
-		for (size_t teamId = 0; teamId < pendingTargetsByTeam.size(); ++teamId)
+		static LevelSystem& levelSystem = SpaceArcade::get().getLevelSystem();
+		const sp<LevelBase>& currentLevel = levelSystem.getCurrentLevel();
+		if (!currentLevel)
 		{
-			if (teamId == cachedTeamId) continue;
+			return nullptr;
+		}
 
-			if (sp<WorldEntity> target = getTargetOnTeam(teamId))
+		//carriers are never handed out as targets, fighters are sent at them through objectives
+		static const TeamSpatialQueries::Filter notCarriers = [](const WorldEntity& entity) { return !entity.hasGameComponent<FighterSpawnComponent>(); };
+		currentLevel->getTeamQueries().kNearestEnemies(requesterPosition, cachedTeamId, NUM_TARGET_CANDIDATES, std::numeric_limits<float>::infinity(), queryScratch, queryHits, notCarriers);
+		for (const TeamSpatialQueries::Hit& hit : queryHits)
+		{
+			if (assignedTargets.insert(hit.entity->getSpawnId()).second)
 			{
-				return target;
+				return hit.entity->requestTypedReference_Nonsafe<WorldEntity>().lock();
 			}
 		}
 
@@ -107,7 +88,6 @@ namespace SA
 
 			for (const sp<WorldEntity>& entity : spaceLevel->getWorldEntities())
 			{
-				//stack up the target data
 				handleEntitySpawned(entity);
 			}
 		}
@@ -115,14 +95,11 @@ namespace SA
 
 	void TeamCommander::handleEntitySpawned(const sp<WorldEntity>& spawned)
 	{
+		//enemies are found through the level's team queries when targets are requested; only carriers need tracking
 		if (bool bIsCarrier = spawned && spawned->hasGameComponent<FighterSpawnComponent>())
 		{
 			handleCarrierSpawned(spawned);
 		}
-		else
-		{
-			queueTarget(spawned);
-		}
 	}
 
 }
@@ -1,13 +1,14 @@
 #pragma once
 
+#include <unordered_set>
 #include <vector>
-#include <stack>
 
 #include "GameFramework/Components/SAComponentEntity.h"
 #include "GameFramework/Components/GameplayComponents.h"
 #include "Tools/DataStructures/SATransform.h"
 #include "Tools/DataStructures/LifetimePointer.h"
 #include "Tools/DataStructures/AdvancedPtrs.h"
+#include "GameFramework/SATeamSpatialQueries.h"
 
 namespace SA
 {
@@ -18,8 +19,11 @@ namespace SA
 	public:
 		TeamCommander(size_t team);
 
-		sp<WorldEntity> getTarget();
-		sp<WorldEntity> getTargetOnTeam(size_t team);
+		/** The nearest enemy to requesterPosition that has not already been handed out, so fighters spread over the enemy fleet.
+			Null when the nearest few enemies are all taken; callers then fall back to a plain nearest enemy search. */
+		sp<WorldEntity> getTarget(const glm::vec3& requesterPosition);
+
+		/** Hands a target from getTarget back so it can be assigned again */
 		bool queueTarget(const sp<WorldEntity>& target);
 		void handleCarrierSpawned(const sp<WorldEntity>& target);
 		glm::vec3 getCommanderPosition() { return glm::vec3(0, 0, 0); } //#TODO hook up commander positions tied to leader ship
@@ -33,10 +37,13 @@ namespace SA
 		void handleEntitySpawned(const sp<WorldEntity>& spawned);
 
 	private:
+		static constexpr size_t NUM_TARGET_CANDIDATES = 8;
+
 		size_t cachedTeamId;
 
-		//indices represent team number
-		std::vector<std::stack<lp<WorldEntity>>> pendingTargetsByTeam;
+		std::unordered_set<uint64_t> assignedTargets; //spawn ids of enemies handed out and not returned
+		TeamSpatialQueries::QueryScratch queryScratch;
+		std::vector<TeamSpatialQueries::Hit> queryHits;
 		std::vector<fwp<WorldEntity>> carriers;
 
 	};
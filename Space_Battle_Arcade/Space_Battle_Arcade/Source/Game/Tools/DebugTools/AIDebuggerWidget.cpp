@@ -327,7 +327,7 @@ namespace SA
 	{
 		if (const sp<LevelBase>& world = SpaceArcade::get().getLevelSystem().getCurrentLevel())
 		{
-			const std::set<sp<WorldEntity>>& worldEntities = world->getWorldEntities();
+			const LevelBase::WorldEntitySet& worldEntities = world->getWorldEntities();
 			for (const sp<WorldEntity>& entity : worldEntities)
 			{
 				if(Ship* shipPtr = dynamic_cast<Ship*>(entity.get()))
@@ -442,7 +442,7 @@ namespace SA
 				// find an objective
 				////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 				sp<Ship> enemyCarrier = nullptr;
-				const std::set<sp<WorldEntity>>& worldEntities = currentLevel->getWorldEntities();
+				const LevelBase::WorldEntitySet& worldEntities = currentLevel->getWorldEntities();
 				for (const sp<WorldEntity>& worldEntity : worldEntities)
 				{
 					const FighterSpawnComponent* spawnComp = worldEntity->getGameComponent<FighterSpawnComponent>();
@@ -518,10 +518,10 @@ namespace SA
 		//do additional any last minute additional transformations to the instance data
 		if (offscreenMode.has_value() || bForceCameraRelative)
 		{
-			if (CameraBase* cam = ui_rd.camera())
+			if (ui_rd.camera())
 			{
 				glm::quat camRot = ui_rd.camQuat(); //if not using quaternion camera, this will be a unit quaternion and apply no rotation
-				glm::vec3 pos = cam->getPosition();
+				glm::vec3 pos = ui_rd.camPos(); //the camera of the frame being drawn, not the live camera
 
 				//adjust positions so that they are camera relative
 				anim_End.end = pos + (camRot * anim_End.camToEnd);
@@ -24,6 +24,8 @@
 #include "Game/Levels/MainMenuLevel.h"
 #include "Tools/PlatformUtils.h"
 #include "GameFramework/Input/SAInput.h"
+#include "Rendering/RenderData.h"
+#include "Tools/SAUtilities.h"
 
 using namespace glm;
 
@@ -190,19 +192,13 @@ namespace SA
 		{
 			tryRegenerateTeamWidgets();
 
-			bool bPlayerSlomoReady = false;
-			const sp<PlayerBase>& playerBase = GameBase::get().getPlayerSystem().getPlayer(playerIdx);
-			if (playerBase && slowmoText)
+			//player state comes from the frame's snapshot so the hud agrees with the world it is drawn over
+			RenderData::PlayerHUDSnapshot playerHUD;
+			if (Utils::isValidIndex(rd_game->playerHUDs, playerIdx))
 			{
-				if (playerBase->hasControlTarget())
-				{
-					//sucks to dynamic cast here every frame, but I don't want to make a separate component just for this; we could static cast but that is dangerous territory as it creates a refactoring hidden bomb 
-					if (SAPlayer* player = dynamic_cast<SAPlayer*>(playerBase.get()))
-					{
-						bPlayerSlomoReady = player->canDilateTime();
-					}
-				}
+				playerHUD = rd_game->playerHUDs[playerIdx];
 			}
+			bool bPlayerSlomoReady = slowmoText && playerHUD.bHasControlTarget && playerHUD.bCanDilateTime;
 
 			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 			// this is a bit of a hack. originally I anticipated a distance of 10.f in front of hud was a good amount
@@ -213,10 +209,10 @@ namespace SA
 			// for the in game hud. So we copy the hud data and recalcualte it at a new distnace
 			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 			HUDData3D hudData = rd_ui.getHUDData3D(); //make a copy
-			if (CameraBase* gameCam = rd_ui.camera())
+			if (rd_game->bHasCameraFrustum)
 			{
 				hudData.frontOffsetDist = 1.f; //be careful, this must be beyond near clip plane!
-				calculateHUDData3D(hudData, *gameCam, rd_ui);
+				calculateHUDData3D(hudData, *rd_game, rd_ui);
 			}
 			float distScaleCorrection = hudData.frontOffsetDist / 10.f; //10.f is the default distance for hudData
 
@@ -247,9 +243,7 @@ namespace SA
 			////////////////////////////////////////////////////////
 #define RENDER_PLAYER_HUD_ELEMENTS 1
 #if RENDER_PLAYER_HUD_ELEMENTS
-			const sp<PlayerBase>& player = GameBase::get().getPlayerSystem().getPlayer(playerIdx);
-			IControllable* controlTarget = player ? player->getControlTarget() : nullptr;
-			bool bHasControlTarget = controlTarget != nullptr;
+			bool bHasControlTarget = playerHUD.bHasControlTarget;
 
 			vec3 hudCenterPoint = hudData.camPos + (hudData.frontOffsetDist * hudData.camFront);
 			vec2 statusBarOffsetPerc{ 0.75f, -0.8f};
@@ -1,18 +1,15 @@
 #include "PlayerPilotAssistUI.h"
 
-#include "Game/AI/GlobalSpaceArcadeBehaviorTreeKeys.h"
-#include "Game/AI/SAShipBehaviorTreeNodes.h"
 #include "Game/GameSystems/SAUISystem_Game.h"
 #include "Game/SpaceArcade.h"
 #include "GameFramework/Components/GameplayComponents.h"
 #include "GameFramework/Interfaces/SAIControllable.h"
-#include "GameFramework/SABehaviorTree.h"
 #include "GameFramework/SADebugRenderSystem.h"
 #include "GameFramework/SAGameBase.h"
 #include "GameFramework/SAPlayerBase.h"
 #include "GameFramework/SAPlayerSystem.h"
-#include "Rendering/Camera/SACameraBase.h"
 #include "Rendering/OpenGLHelpers.h"
+#include "Rendering/RenderData.h"
 #include "Tools/color_utils.h"
 
 namespace SA
@@ -34,53 +31,25 @@ namespace SA
 
 	void PlayerPilotAssistUI::handleGameUIRender(GameUIRenderData& rd_ui)
 	{
-		const std::vector<sp<PlayerBase>>& players = SpaceArcade::get().getPlayerSystem().getAllPlayers();
-		for (const sp<PlayerBase>& player : players)
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// render player attackers
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		if (const RenderData* frameRenderData = rd_ui.renderData())
 		{
-			if (IControllable* controlTarget = player->getControlTarget())
+			for (const RenderData::AttackerSnapshot& attacker : frameRenderData->playerAttackers)
 			{
-				if (WorldEntity* controlTarget_we = controlTarget->asWorldEntity())
-				{
-					if (const BrainComponent* ctBrainComp = controlTarget_we->getGameComponent<BrainComponent>())
-					{
-						if (const BehaviorTree::Tree* tree = ctBrainComp->getTree())
-						{
-							using namespace BehaviorTree;
-							Memory& memory = tree->getMemory();
-
-							////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-							// render player attackers
-							////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-							if (const BehaviorTree::ActiveAttackers* attackers = memory.getReadValueAs<BehaviorTree::ActiveAttackers>(BT_AttackersKey))
-							{
-								size_t attackerIdx = 0;
-								for (auto& iter : *attackers)
-								{
-									if (iter.second.attacker)
-									{
-										renderPlayerAttacker(*controlTarget_we, *iter.second.attacker.fastGet(), attackerIdx);
-									}
-									attackerIdx++;
-								}
-							}
-						}
-					}
-				}
+				renderPlayerAttacker(attacker.targetPosition, attacker.attackerPosition, attacker.attackerIdx);
 			}
 		}
 
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		// dispatch the accumulated instance render
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		dispatchInstancedRender();
+		dispatchInstancedRender(rd_ui);
 	}
 
-	void PlayerPilotAssistUI::renderPlayerAttacker(const WorldEntity& playerShip, const WorldEntity& attacker, size_t attackerIdx)
+	void PlayerPilotAssistUI::renderPlayerAttacker(const glm::vec3& playerPos, const glm::vec3& attackerPos, size_t attackerIdx)
 	{
-		//TEMP
-		vec3 playerPos = playerShip.getWorldPosition();
-		vec3 attackerPos = attacker.getWorldPosition();
-
 		//tweak the color based on this frames number of attackers so that user can easily track who they are trying to destroy
 		vec3 scaledRed = color::red() * clamp(1.f - (attackerIdx / 4.f), 0.25f, 1.f);
 
@@ -110,11 +79,9 @@ namespace SA
 		frameData.lineData.push_back(shearMatrix);
 	}
 
-	void PlayerPilotAssistUI::dispatchInstancedRender()
+	void PlayerPilotAssistUI::dispatchInstancedRender(GameUIRenderData& rd_ui)
 	{
-		static PlayerSystem& playerSystem = GameBase::get().getPlayerSystem();
-		const sp<PlayerBase>& player = playerSystem.getPlayer(0);
-		const sp<CameraBase> camera = player ? player->getCamera() : sp<CameraBase>(nullptr);
+		const RenderData* frameRenderData = rd_ui.renderData();
 
 		if (frameData.lineData.size() > 0)
 		{
@@ -144,9 +111,9 @@ namespace SA
 			ec(glVertexAttribDivisor(3, 1));
 			ec(glVertexAttribDivisor(4, 1));
 
-			if (camera)
+			if (frameRenderData && frameRenderData->bHasCameraFrustum)
 			{
-				lineRenderer->setProjectionViewMatrix(camera->getPerspective() * camera->getView());
+				lineRenderer->setProjectionViewMatrix(frameRenderData->projection_view);
 				lineRenderer->instanceRender(frameData.lineData.size());
 			}
 		}
@@ -32,8 +32,8 @@ namespace SA
 	private:
 		void handleGameUIRender(GameUIRenderData& rd_ui);
 		void handleGameUIRenderComplete();
-		void renderPlayerAttacker(const WorldEntity& playerShip, const WorldEntity& attacker, size_t attackerIdx);
-		void dispatchInstancedRender();
+		void renderPlayerAttacker(const glm::vec3& playerPos, const glm::vec3& attackerPos, size_t attackerIdx);
+		void dispatchInstancedRender(GameUIRenderData& rd_ui);
 	private:
 		sp<DebugLineRender> lineRenderer; //NOTE currently there is no reason for this to be different than debug renderer, so using that class. 
 		FrameData_PlayerPilotAssistUI frameData;
@@ -16,6 +16,7 @@
 #include "GameFramework/SAPlayerBase.h"
 #include "GameFramework/SAPlayerSystem.h"
 #include "GameFramework/SAWorldEntity.h"
+#include "Rendering/RenderData.h"
 #include "Tools/PlatformUtils.h"
 #include "Tools/SAUtilities.h"
 namespace SA
@@ -31,6 +32,12 @@ namespace SA
 		textProgressBar->renderGameUI(rd_ui);
 	}
 
+	const RenderData::PlayerHUDSnapshot* Widget3D_PlayerStatusBarBase::getPlayerHUD(GameUIRenderData& rd_ui) const
+	{
+		const RenderData* frameRenderData = rd_ui.renderData();
+		return frameRenderData && Utils::isValidIndex(frameRenderData->playerHUDs, assignedPlayerIdx) ? &frameRenderData->playerHUDs[assignedPlayerIdx] : nullptr;
+	}
+
 	void Widget3D_PlayerStatusBarBase::setTextTransform(Transform xform)
 	{
 		textProgressBar->myText->setXform(xform);
@@ -66,9 +73,8 @@ namespace SA
 
 	void Widget3D_PlayerStatusBarBase::handlePlayerControlTargetSet(IControllable* oldTarget, IControllable* newTarget)
 	{
-		if (WorldEntity* controlTarget_we = newTarget ? newTarget->asWorldEntity() : nullptr)
+		if (newTarget && newTarget->asWorldEntity())
 		{
-			myControlTarget = controlTarget_we->requestTypedReference_Safe<WorldEntity>();
 			activate(true);
 		}
 		else
@@ -109,12 +115,12 @@ namespace SA
 
 	void Widget3D_HealthBar::renderGameUI(GameUIRenderData& rd)
 	{
-		if (myControlTarget)
+		const RenderData::PlayerHUDSnapshot* playerHUD = getPlayerHUD(rd);
+		if (playerHUD && playerHUD->bHasControlTarget)
 		{
-			if (const HitPointComponent* hpComp = myControlTarget->getGameComponent<HitPointComponent>() )
+			if (playerHUD->health)
 			{
-				const HitPoints& hp = hpComp->getHP();
-				textProgressBar->myProgressBar->setProgressOnRange(hp.current, 0, hp.max);
+				textProgressBar->myProgressBar->setProgressOnRange(playerHUD->health->x, 0, playerHUD->health->y);
 			}
 			else
 			{
@@ -144,13 +150,12 @@ namespace SA
 
 	void Widget3D_EnergyBar::renderGameUI(GameUIRenderData& rd)
 	{
-		if (myControlTarget)
+		const RenderData::PlayerHUDSnapshot* playerHUD = getPlayerHUD(rd);
+		if (playerHUD && playerHUD->bHasControlTarget)
 		{
-			if (const ShipEnergyComponent* energyComp = myControlTarget->getGameComponent<ShipEnergyComponent>() )
+			if (playerHUD->energy)
 			{
-				float energy = energyComp->getEnergy();
-				float maxEnergy = energyComp->getMaxEnergy();
-				textProgressBar->myProgressBar->setProgressOnRange(energy, 0, maxEnergy);
+				textProgressBar->myProgressBar->setProgressOnRange(playerHUD->energy->x, 0, playerHUD->energy->y);
 			}
 			else
 			{
@@ -199,13 +204,12 @@ namespace SA
 
 	void Widget3D_TeamProgressBar::renderGameUI(GameUIRenderData& renderData)
 	{
-		if (cacheGM)
+		const RenderData* frameRenderData = renderData.renderData();
+		if (cacheGM && frameRenderData)
 		{
-			const std::vector<GameModeTeamData> gmTeamData = cacheGM->getTeamData();
-			if (Utils::isValidIndex(gmTeamData, teamIdx))
+			if (Utils::isValidIndex(frameRenderData->teamObjectivesAlive, teamIdx))
 			{
-				const GameModeTeamData& td = gmTeamData[teamIdx];
-				textProgressBar->myProgressBar->setProgressNormalized(td.percentAlive_Objectives);
+				textProgressBar->myProgressBar->setProgressNormalized(frameRenderData->teamObjectivesAlive[teamIdx]);
 			}
 			else
 			{
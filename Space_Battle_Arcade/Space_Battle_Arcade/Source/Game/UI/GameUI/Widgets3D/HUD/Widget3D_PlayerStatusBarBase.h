@@ -3,6 +3,7 @@
 #include "Game/UI/GameUI/Widgets3D/Widget3D_Base.h"
 #include "Game/UI/GameUI/Widgets3D/MainMenuScreens/Widget3D_ActivatableBase.h"
 #include "Tools/DataStructures/AdvancedPtrs.h"
+#include "Rendering/RenderData.h"
 
 namespace SA
 {
@@ -27,6 +28,7 @@ namespace SA
 		virtual void postConstruct() override;
 		virtual void onActivationChanged(bool bActive) override;
 		const fwp<PlayerBase>& getMyPlayer() { return myPlayer; }
+		const RenderData::PlayerHUDSnapshot* getPlayerHUD(GameUIRenderData& rd_ui) const;
 	private:
 		void registerPlayerEvents();
 		void handlePlayerControlTargetSet(IControllable* oldTarget, IControllable* newTarget);
@@ -34,7 +36,6 @@ namespace SA
 		virtual void onPlayerControlTargetSet(IControllable* oldTarget, IControllable* newTarget) {};
 	protected:
 		sp<Widget3D_TextProgressBar> textProgressBar;
-		fwp<WorldEntity> myControlTarget = nullptr;
 	private:
 		size_t assignedPlayerIdx = 0;
 		fwp<PlayerBase> myPlayer = nullptr; //warning, watch out for circular references here. wp so HUD will not create circular reference with player.
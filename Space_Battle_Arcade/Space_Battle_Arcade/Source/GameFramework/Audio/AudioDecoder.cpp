@@ -0,0 +1,131 @@
+#include "GameFramework/Audio/AudioDecoder.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include <Libraries/dr_lib/dr_wav.h>
+#include <Libraries/dr_lib/dr_mp3.h>
+#include <Libraries/dr_lib/dr_flac.h>
+
+namespace SA
+{
+	uint64_t AudioDecoder::getTotalFrames()
+	{
+		if (!bTotalFramesKnown)
+		{
+			totalFrames = countTotalFrames();
+			bTotalFramesKnown = true;
+		}
+		return totalFrames;
+	}
+
+	float AudioDecoder::getDurationSec()
+	{
+		return sampleRate > 0 ? float(double(getTotalFrames()) / double(sampleRate)) : 0.f;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// wav
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class WavDecoder final : public AudioDecoder
+	{
+	public:
+		~WavDecoder() { if (bOpen) { drwav_uninit(&wav); } }
+
+		bool open(const std::string& filePath)
+		{
+			bOpen = drwav_init_file(&wav, filePath.c_str(), nullptr);
+			if (bOpen)
+			{
+				channels = wav.channels;
+				sampleRate = wav.sampleRate;
+				totalFrames = wav.totalPCMFrameCount;
+			}
+			return bOpen;
+		}
+		virtual uint64_t readFrames(int16_t* outSamples, uint64_t numFrames) override { return drwav_read_pcm_frames_s16(&wav, numFrames, outSamples); }
+		virtual bool seekToFrame(uint64_t frameIdx) override { return drwav_seek_to_pcm_frame(&wav, frameIdx); }
+	private:
+		drwav wav;
+		bool bOpen = false;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// mp3
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class Mp3Decoder final : public AudioDecoder
+	{
+	public:
+		~Mp3Decoder() { if (bOpen) { drmp3_uninit(&mp3); } }
+
+		bool open(const std::string& filePath)
+		{
+			bOpen = drmp3_init_file(&mp3, filePath.c_str(), nullptr);
+			if (bOpen)
+			{
+				channels = mp3.channels;
+				sampleRate = mp3.sampleRate;
+				bTotalFramesKnown = false; //streaming playback never needs the length, so don't pay for the scan here
+			}
+			return bOpen;
+		}
+		virtual uint64_t readFrames(int16_t* outSamples, uint64_t numFrames) override { return drmp3_read_pcm_frames_s16(&mp3, numFrames, outSamples); }
+		virtual bool seekToFrame(uint64_t frameIdx) override { return drmp3_seek_to_pcm_frame(&mp3, frameIdx); }
+	protected:
+		//scans every frame header, then seeks back to the current frame
+		virtual uint64_t countTotalFrames() override { return drmp3_get_pcm_frame_count(&mp3); }
+	private:
+		drmp3 mp3;
+		bool bOpen = false;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// flac
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class FlacDecoder final : public AudioDecoder
+	{
+	public:
+		~FlacDecoder() { if (flac) { drflac_close(flac); } }
+
+		bool open(const std::string& filePath)
+		{
+			flac = drflac_open_file(filePath.c_str(), nullptr);
+			if (flac)
+			{
+				channels = flac->channels;
+				sampleRate = flac->sampleRate;
+				totalFrames = flac->totalPCMFrameCount;
+			}
+			return flac != nullptr;
+		}
+		virtual uint64_t readFrames(int16_t* outSamples, uint64_t numFrames) override { return drflac_read_pcm_frames_s16(flac, numFrames, outSamples); }
+		virtual bool seekToFrame(uint64_t frameIdx) override { return drflac_seek_to_pcm_frame(flac, frameIdx); }
+	private:
+		drflac* flac = nullptr;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// factory
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename DecoderType>
+	static sp<AudioDecoder> openDecoder(const std::string& filePath)
+	{
+		sp<DecoderType> decoder = new_sp<DecoderType>();
+		if (decoder->open(filePath) && decoder->getChannels() > 0 && decoder->getSampleRate() > 0)
+		{
+			return decoder;
+		}
+		return nullptr;
+	}
+
+	sp<AudioDecoder> AudioDecoder::open(const std::string& filePath)
+	{
+		std::string extension = filePath.substr(std::min(filePath.find_last_of('.'), filePath.size()));
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+
+		if (extension == ".wav") { return openDecoder<WavDecoder>(filePath); }
+		if (extension == ".mp3") { return openDecoder<Mp3Decoder>(filePath); }
+		if (extension == ".flac") { return openDecoder<FlacDecoder>(filePath); }
+		return nullptr;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#include "GameFramework/SAGameEntity.h"
+#include "Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Incremental decoder to interleaved signed 16 bit pcm. Opening only reads the header, so a sound can be
+	// decoded a chunk at a time instead of all at once. Supports wav, and the compressed mp3 and flac formats.
+	// mp3 has no length in its header; its length is only counted, by scanning the file, when first asked for.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AudioDecoder : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		/** Picks a decoder from the file extension; returns null if the format is unknown or the file can't be opened */
+		static sp<AudioDecoder> open(const std::string& filePath);
+
+		virtual ~AudioDecoder() = default;
+
+		/** Returns frames written; fewer than requested means the end of the sound was reached */
+		virtual uint64_t readFrames(int16_t* outSamples, uint64_t numFrames) = 0;
+		virtual bool seekToFrame(uint64_t frameIdx) = 0;
+
+		uint32_t getChannels() const { return channels; }
+		uint32_t getSampleRate() const { return sampleRate; }
+
+		/** May scan the whole file on first call (mp3); prefer a cached duration where one is available */
+		uint64_t getTotalFrames();
+		float getDurationSec();
+
+	protected:
+		/** Formats whose header has no length override this and clear bTotalFramesKnown; called at most once */
+		virtual uint64_t countTotalFrames() { return totalFrames; }
+
+	protected:
+		uint32_t channels = 0;
+		uint32_t sampleRate = 0;
+		uint64_t totalFrames = 0;
+		bool bTotalFramesKnown = true;
+	};
+}
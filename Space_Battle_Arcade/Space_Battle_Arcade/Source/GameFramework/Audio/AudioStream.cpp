@@ -0,0 +1,168 @@
+#include "GameFramework/Audio/AudioStream.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "GameFramework/Audio/AudioDecoder.h"
+
+namespace SA
+{
+	AudioStream::AudioStream(const sp<AudioDecoder>& inDecoder, uint32_t framesPerChunk, uint32_t numChunks, bool bInLooping)
+		: decoder(inDecoder), bLooping(bInLooping)
+	{
+		channels = decoder ? decoder->getChannels() : 0;
+		sampleRate = decoder ? decoder->getSampleRate() : 0;
+
+		chunks.resize(std::max(numChunks, 1u));
+		for (Chunk& chunk : chunks)
+		{
+			chunk.samples.resize(size_t(std::max(framesPerChunk, 1u)) * channels);
+		}
+
+		if (!decoder || channels == 0)
+		{
+			bDecoderDone.store(true, std::memory_order_release);
+		}
+	}
+
+	bool AudioStream::decodeNextChunk()
+	{
+		const uint32_t decoded = numDecoded.load(std::memory_order_relaxed);
+		if (bDecoderDone.load(std::memory_order_relaxed) || decoded - numTaken.load(std::memory_order_acquire) >= chunks.size())
+		{
+			return false;
+		}
+
+		Chunk& chunk = chunks[decoded % chunks.size()];
+		const uint64_t chunkFrames = chunk.samples.size() / channels;
+		uint64_t framesRead = decoder->readFrames(chunk.samples.data(), chunkFrames);
+		bool bReachedEnd = framesRead < chunkFrames;
+		if (bReachedEnd && bLooping && decoder->seekToFrame(0))
+		{
+			//wrap within the chunk so the loop point has no gap
+			while (framesRead < chunkFrames)
+			{
+				const uint64_t wrappedFrames = decoder->readFrames(chunk.samples.data() + framesRead * channels, chunkFrames - framesRead);
+				if (wrappedFrames == 0) { break; } //empty sound, nothing to loop
+				framesRead += wrappedFrames;
+				if (framesRead < chunkFrames) { decoder->seekToFrame(0); }
+			}
+			bReachedEnd = framesRead < chunkFrames;
+		}
+		chunk.numFrames = uint32_t(framesRead);
+
+		//publish the final chunk before flagging done; isFinished must never see done while the last chunk is still unpublished
+		if (framesRead > 0)
+		{
+			numDecoded.store(decoded + 1, std::memory_order_release); //publishes the chunk's samples to the consumer
+		}
+		if (bReachedEnd)
+		{
+			bDecoderDone.store(true, std::memory_order_release);
+		}
+		return framesRead > 0;
+	}
+
+	const AudioStream::Chunk* AudioStream::peekChunk() const
+	{
+		const uint32_t taken = numTaken.load(std::memory_order_relaxed);
+		if (taken == numDecoded.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &chunks[taken % chunks.size()];
+	}
+
+	void AudioStream::popChunk()
+	{
+		const uint32_t taken = numTaken.load(std::memory_order_relaxed);
+		if (taken != numDecoded.load(std::memory_order_acquire))
+		{
+			numTaken.store(taken + 1, std::memory_order_release); //hands the chunk back to the producer
+		}
+	}
+
+	bool AudioStream::isFinished() const
+	{
+		//check done first; the final chunk is published before done is set, so it is then visible to the count comparison
+		return bDecoderDone.load(std::memory_order_acquire) && numTaken.load(std::memory_order_relaxed) == numDecoded.load(std::memory_order_acquire);
+	}
+
+	size_t AudioStream::getResidentBytes() const
+	{
+		size_t numBytes = 0;
+		for (const Chunk& chunk : chunks)
+		{
+			numBytes += chunk.samples.size() * sizeof(int16_t);
+		}
+		return numBytes;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Decoder thread
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	AudioStreamDecoderThread::AudioStreamDecoderThread()
+	{
+		thread = std::thread(&AudioStreamDecoderThread::run, this);
+	}
+
+	AudioStreamDecoderThread::~AudioStreamDecoderThread()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			bStopRequested = true;
+		}
+		wakeCondition.notify_one();
+		thread.join();
+	}
+
+	void AudioStreamDecoderThread::addStream(const sp<AudioStream>& stream)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			streams.push_back(stream);
+			bWakeRequested = true;
+		}
+		wakeCondition.notify_one();
+	}
+
+	void AudioStreamDecoderThread::removeStream(const sp<AudioStream>& stream)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		streams.erase(std::remove(streams.begin(), streams.end(), stream), streams.end());
+	}
+
+	void AudioStreamDecoderThread::wake()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			bWakeRequested = true;
+		}
+		wakeCondition.notify_one();
+	}
+
+	void AudioStreamDecoderThread::run()
+	{
+		//copies keep streams alive while decoding, even if they are removed in the meantime
+		std::vector<sp<AudioStream>> workingStreams;
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wakeCondition.wait_for(lock, std::chrono::milliseconds(10), [this]() { return bWakeRequested || bStopRequested; });
+				if (bStopRequested)
+				{
+					return;
+				}
+				bWakeRequested = false;
+				workingStreams = streams;
+			}
+
+			for (const sp<AudioStream>& stream : workingStreams)
+			{
+				while (stream->decodeNextChunk()) {}
+			}
+			workingStreams.clear();
+		}
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "GameFramework/SAGameEntity.h"
+#include "Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	class AudioDecoder;
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// A small ring of decoded pcm chunks for one playing sound, so long sounds never need to be fully decoded.
+	//
+	// Single producer, single consumer: a decoder thread fills chunks and the audio system takes them in order
+	// to upload into the api's queued buffers. Looping streams seek back to the start of the sound themselves.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AudioStream final : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		struct Chunk
+		{
+			std::vector<int16_t> samples; //interleaved; sized for a full chunk, only numFrames are valid
+			uint32_t numFrames = 0;
+		};
+
+	public:
+		AudioStream(const sp<AudioDecoder>& decoder, uint32_t framesPerChunk, uint32_t numChunks, bool bLooping);
+
+		/** Producer. Decodes into the next free chunk; returns false if the ring is full or the sound has ended. */
+		bool decodeNextChunk();
+
+		/** Consumer. The oldest decoded chunk, or null if none is ready. Valid until popChunk. */
+		const Chunk* peekChunk() const;
+		void popChunk();
+
+		/** Every frame has been decoded and taken; never true for looping streams */
+		bool isFinished() const;
+
+		uint32_t getChannels() const { return channels; }
+		uint32_t getSampleRate() const { return sampleRate; }
+
+		/** Decoded pcm this stream holds at most, regardless of how long the sound is */
+		size_t getResidentBytes() const;
+
+	private:
+		sp<AudioDecoder> decoder;
+		std::vector<Chunk> chunks;
+		uint32_t channels = 0;
+		uint32_t sampleRate = 0;
+		bool bLooping = false;
+
+		std::atomic<uint32_t> numDecoded{ 0 };	//only written by the producer
+		std::atomic<uint32_t> numTaken{ 0 };	//only written by the consumer
+		std::atomic<bool> bDecoderDone{ false };
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Background thread that keeps every registered stream's ring full.
+	// It sleeps until woken or a short timeout passes, so a consumer that forgets to wake it only adds latency.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AudioStreamDecoderThread final : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		AudioStreamDecoderThread();
+		~AudioStreamDecoderThread();
+
+		void addStream(const sp<AudioStream>& stream);
+		void removeStream(const sp<AudioStream>& stream);
+
+		/** Call after taking chunks so the freed space is refilled promptly */
+		void wake();
+
+	private:
+		void run();
+
+	private:
+		std::mutex mutex;
+		std::condition_variable wakeCondition;
+		std::vector<sp<AudioStream>> streams;
+		bool bWakeRequested = false;
+		bool bStopRequested = false;
+		std::thread thread;
+	};
+}
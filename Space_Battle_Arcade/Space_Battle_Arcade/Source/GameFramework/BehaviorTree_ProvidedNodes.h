@@ -74,7 +74,7 @@ namespace SA
 			virtual void handleNodeAborted() override {}
 
 		protected: //node properties
-			const std::string memoryKey;
+			const MemoryKey memoryKey;
 			const T value;
 		private: //node properties
 			std::function<bool(T, T)> opFunc;
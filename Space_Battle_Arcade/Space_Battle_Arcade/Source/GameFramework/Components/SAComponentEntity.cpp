@@ -1,10 +1,21 @@
 #include "SAComponentEntity.h"
+#include <atomic>
 
 namespace SA
 {
-	/*static*/ size_t GameplayComponentEntity::nextComponentCreationIndex = 0; 
-
-
-
+	size_t registerGameComponentType(const char* debugName)
+	{
+		//function local so it is constructed before any GameComponentId that asks for an id, whatever the TU order
+		static std::atomic<size_t> nextId{ 1 };
 
+		size_t id = nextId++;
+		if (id >= MAX_GAME_COMPONENT_TYPES)
+		{
+			//logging isn't available during static initialization
+			fprintf(stderr, "GameComponentSystem : no slot left for %s; raise MAX_GAME_COMPONENT_TYPES\n", debugName);
+			assert(false);
+			return 0;
+		}
+		return id;
+	}
 }
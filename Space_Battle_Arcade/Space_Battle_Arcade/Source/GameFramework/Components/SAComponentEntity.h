@@ -1,5 +1,6 @@
 #pragma once
 #include "GameFramework/SAGameEntity.h"
+#include <array>
 #include <vector>
 #include <map>
 #include <typeindex>
@@ -113,26 +114,46 @@ namespace SA
 	};
 
 
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// GameComponentId - dense id for each game component type.
+	//		Ids are handed out during static initialization, before main, so a lookup never has to check whether its
+	//		type has been registered yet. Id 0 is reserved for "not registered"; its slot is never written, so a lookup
+	//		from another static initializer that runs first safely finds nothing.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	constexpr size_t MAX_GAME_COMPONENT_TYPES = 16;
+
+	/** returns the next free id, or 0 if every slot is taken */
+	size_t registerGameComponentType(const char* debugName);
+
+	template<typename ComponentType>
+	struct GameComponentId
+	{
+		static const size_t value;
+	};
+
+	template<typename ComponentType>
+	const size_t GameComponentId<ComponentType>::value = registerGameComponentType(typeid(ComponentType).name());
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// ComponentEntity - Component entity is an game entity that manages modular components
 	//		This primary is to have a dynamic "hasA" relationship.
 	//
 	//	Implementation details: subject to change 
-	//		In order to make an extremely fast component retrieval system, templates are used.
-	//		Each component gets its own instantiated method, for free, without any set up needed.
-	//		This comes at a memory cost. each component entity holds an array of (shared) pointers
-	//		the size of the total components in the game, regardless if the object has all of those components.
+	//		In order to make an extremely fast component retrieval system, each game component type gets a dense id
+	//		(see GameComponentId) and every entity holds a fixed array of (shared) pointers indexed by that id. A lookup
+	//		is a single indexed load with no branch on registration and no writes, so gets are safe from several threads 
+	//		at once (eg ship kinematics). This comes at a memory cost: each entity holds MAX_GAME_COMPONENT_TYPES 
+	//		pointers regardless if the object has all of those components.
 	//		Profiling this system (see learningcpprepro "TestComponentSystemPerformance.cpp") for performance
 	//		shown this ordering for potential systems: TemplateMethod < DynamicCast < Map < HashMap. 
 	//		to save memory, this should be switched to a map based system. But practically there should be a
-	//		a small set of actual components in the engine, so the TemplateMethod based approach is used for now.
+	//		a small set of actual components in the engine, so the indexed approach is used for now.
 	//
 	//  If this component isn't needed in rapid access (ie in a tick function) then it may be better to use the 
 	//		system component system instead. All GameplayComponentEntities are SystemComponentEntities too.
-	//		adding gameplay components increase the memory profile of all gameplay component entities by a managed pointer
-	//		(it is nullptr if the entity doesn't have that component); this makes the system not scale well if a large
-	//		number of components are used - hence the careful thought around creating a new gameplay component should be given.
-	//		that being said, if you're doing dynamic_casts in tick methods / gamescenarios then
+	//		adding gameplay components beyond MAX_GAME_COMPONENT_TYPES requires raising it, which increases the memory
+	//		profile of all gameplay component entities - hence the careful thought around creating a new gameplay 
+	//		component should be given. that being said, if you're doing dynamic_casts in tick methods / gamescenarios then
 	//		the gameplay component is probably worth the memory overhead.
 	//		
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -144,114 +165,70 @@ namespace SA
 		ComponentType* createGameComponent()
 		{
 			static_assert(std::is_base_of<GameComponentBase, ComponentType>::value);
-			return _componentOperation<ComponentType>(ComponentOp::CREATE_OP);
+			const size_t id = GameComponentId<ComponentType>::value;
+			if (id == 0)
+			{
+				log("component system", LogLevel::LOG_ERROR, "creating component whose type has no id; raise MAX_GAME_COMPONENT_TYPES");
+				assert(false);
+				return nullptr;
+			}
+
+			sp<GameComponentBase>& slot = componentSlots[id];
+			if (slot == nullptr)
+			{
+				slot = new_sp<ComponentType>();
+				return static_cast<ComponentType*>(slot.get());
+			}
+			else
+			{
+				log("component system", LogLevel::LOG_WARNING, "creating component that already exists");
+				assert(false);
+				return nullptr;
+			}
 		}
 
 		template<typename ComponentType>
 		void deleteGameComponent()
 		{
 			static_assert(std::is_base_of<GameComponentBase, ComponentType>::value);
-			_componentOperation<ComponentType>(ComponentOp::DELETE_OP);
+			sp<GameComponentBase>& slot = componentSlots[GameComponentId<ComponentType>::value];
+			if (slot)
+			{
+				slot = nullptr;
+			}
+			else
+			{
+				log("component system", LogLevel::LOG_WARNING, "deleting component that doesn't exist");
+				assert(false);
+			}
 		}
 
 		template<typename ComponentType>
-		bool hasGameComponent()
+		bool hasGameComponent() const
 		{
 			static_assert(std::is_base_of<GameComponentBase, ComponentType>::value);
-			return _componentOperation<ComponentType>(ComponentOp::GET_OP) != nullptr;
+			return componentSlots[GameComponentId<ComponentType>::value] != nullptr;
 		}
 
 		template<typename ComponentType>
 		ComponentType* getGameComponent()
 		{
 			static_assert(std::is_base_of<GameComponentBase, ComponentType>::value);
-			return _componentOperation<ComponentType>(ComponentOp::GET_OP);
-		}
 
-		/** All operations are funneled through _componentOperation<> and it is nonconst. Const methods
-			also need to be funneled through this method. Because create/delete operations are inherently non-const,
-			_componentOperation<> must be none const. In order const version of has/getComponent, we use const_cast considering
-			all the above. */
-		template<typename ComponentType>
-		const ComponentType* getGameComponent() const
-		{
-			GameplayComponentEntity* nonConstThis = const_cast<GameplayComponentEntity*>(this);
-			return nonConstThis->getGameComponent<ComponentType>();
-		}
-
-		template<typename ComponentType>
-		bool hasGameComponent() const
-		{
-			GameplayComponentEntity* nonConstThis = const_cast<GameplayComponentEntity*>(this);
-			return nonConstThis->hasGameComponent<ComponentType>();
+			//static cast is safe since the id is a proxy for RTTI
+			return static_cast<ComponentType*>(componentSlots[GameComponentId<ComponentType>::value].get());
 		}
 
-
-	private:
-		/** Operations into the single method generated for each component */
-		enum class ComponentOp : uint8_t { GET_OP, CREATE_OP, DELETE_OP };	//_COMP added to avoid namespace collisions with windows macros
-
-		/** method generated for each component type in the system. */
 		template<typename ComponentType>
-		inline ComponentType* _componentOperation(ComponentOp operation)
+		const ComponentType* getGameComponent() const
 		{
-			//this will create many different functions that automatically know the index of the type
-			//operations all live in the same function so that the this_type_index is always the same
-
 			static_assert(std::is_base_of<GameComponentBase, ComponentType>::value);
-			static size_t this_type_index = nextComponentCreationIndex++; //first time this is called, it gets a new index for fast compile time lookup
-			static int calledOneTimeAtIncrement = []()->int
-			{
-				char msg[2048];
-				snprintf(msg, sizeof(msg), "GameComponentSystem : component num:{%zd} entry array min bytes: {%zd bytes}", nextComponentCreationIndex, sizeof(sp<ComponentType>) * nextComponentCreationIndex);
-				log("Memory", LogLevel::LOG, msg);
-				return 0;
-			}();
-
-			if (componentArray.size() < this_type_index + 1)
-			{
-				componentArray.resize(this_type_index + 1, nullptr);
-			}
-
-			ComponentType* ret = nullptr;
-
-			//avoid switch because I heard they aren't great with cache... probably should try and test that.
-			if (operation == ComponentOp::GET_OP)
-			{
-				//static cast is safe since we're using index look up as a proxy for RTTI
-				ret = static_cast<ComponentType*>(componentArray[this_type_index].get());
-			}
-			else if (operation == ComponentOp::CREATE_OP)
-			{
-				if (componentArray[this_type_index] == nullptr)
-				{
-					componentArray[this_type_index] = new_sp<ComponentType>();
-					ret = static_cast<ComponentType*>(componentArray[this_type_index].get());
-				}
-				else
-				{
-					log("component system", LogLevel::LOG_WARNING, "creating component that already exists");
-					assert(false);
-				}
-			}
-			else if (operation == ComponentOp::DELETE_OP)
-			{
-				if (sp<GameComponentBase>& comp = componentArray[this_type_index])
-				{
-					componentArray[this_type_index] = nullptr;
-				}
-				else
-				{
-					log("component system", LogLevel::LOG_WARNING, "deleting component that doesn't exist");
-					assert(false);
-				}
-			}
-			return ret;
+			return static_cast<const ComponentType*>(componentSlots[GameComponentId<ComponentType>::value].get());
 		}
-	private:
 
-		static size_t nextComponentCreationIndex;
-		std::vector<sp<GameComponentBase>> componentArray;
+	private:
+		/** slot 0 is the unregistered slot and always stays null */
+		std::array<sp<GameComponentBase>, MAX_GAME_COMPONENT_TYPES> componentSlots;
 	};
 	
 	/** This is a lazy function that shouldn't be part of the normal work flow. This is because it can accidentally create bugs or waste space
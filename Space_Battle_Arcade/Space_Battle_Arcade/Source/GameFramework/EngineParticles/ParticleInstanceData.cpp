@@ -0,0 +1,244 @@
+#include "GameFramework/EngineParticles/ParticleInstanceData.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include "GameFramework/SAParticleSystem.h"
+#include "Tools/SAUtilities.h"
+
+namespace SA
+{
+	/////////////////////////////////////////////////////////////////////////////
+	// Compiled keyframes
+	/////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	static void appendFrames(Particle::CompiledKeyFrames& compiled, const std::vector<Particle::KeyFrame<T>>& frames, size_t laneStart)
+	{
+		constexpr size_t numComponents = sizeof(T) / sizeof(float);
+
+		float chainTime = 0.f;
+		for (const Particle::KeyFrame<T>& frame : frames)
+		{
+			compiled.frameStartTimes.push_back(chainTime);
+			//a zero length frame jumps straight to its end value
+			compiled.frameInvDurations.push_back(frame.durationSec > 0.f ? 1.f / frame.durationSec : std::numeric_limits<float>::max());
+			compiled.frameFirstLanes.push_back(static_cast<uint32_t>(laneStart + numComponents * frame.dataIdx));
+			compiled.frameNumLanes.push_back(static_cast<uint32_t>(numComponents));
+			compiled.frameFirstValues.push_back(static_cast<uint32_t>(compiled.startValues.size()));
+
+			//glm types are tightly packed floats
+			const float* startComponents = reinterpret_cast<const float*>(&frame.startValue);
+			const float* endComponents = reinterpret_cast<const float*>(&frame.endValue);
+			for (size_t component = 0; component < numComponents; ++component)
+			{
+				compiled.startValues.push_back(startComponents[component]);
+				compiled.deltaValues.push_back(endComponents[component] - startComponents[component]);
+			}
+
+			chainTime += frame.durationSec;
+		}
+	}
+
+	template<typename T>
+	static void growSlotCount(const std::vector<Particle::KeyFrame<T>>& frames, size_t& inOutNumSlots)
+	{
+		for (const Particle::KeyFrame<T>& frame : frames)
+		{
+			inOutNumSlots = std::max(inOutNumSlots, frame.dataIdx + 1);
+		}
+	}
+
+	void Particle::CompiledKeyFrames::compile(const Effect& effect)
+	{
+		*this = CompiledKeyFrames{};
+
+		size_t numFloats = 0;
+		size_t numVec3s = 3; //built-in position, rotation, scale
+		size_t numVec4s = 0;
+		size_t numMat4s = 0;
+		for (const KeyFrameChain& chain : effect.keyFrameChains)
+		{
+			growSlotCount(chain.floatKeyFrames, numFloats);
+			growSlotCount(chain.vec3KeyFrames, numVec3s);
+			growSlotCount(chain.vec4KeyFrames, numVec4s);
+			growSlotCount(chain.mat4KeyFrames, numMat4s);
+		}
+
+		vec3LaneStart = numFloats;
+		vec4LaneStart = vec3LaneStart + 3 * numVec3s;
+		mat4LaneStart = vec4LaneStart + 4 * numVec4s;
+		laneDefaults.assign(mat4LaneStart + 16 * numMat4s, 0.f);
+		for (size_t component = 0; component < 3; ++component)
+		{
+			laneDefaults[vec3Lane(MutableEffectData::SCALE_VEC3_IDX) + component] = 1.f;
+		}
+		for (size_t mat4Idx = 0; mat4Idx < numMat4s; ++mat4Idx)
+		{
+			for (size_t diagonal = 0; diagonal < 4; ++diagonal)
+			{
+				laneDefaults[mat4LaneStart + 16 * mat4Idx + 5 * diagonal] = 1.f;
+			}
+		}
+
+		for (const KeyFrameChain& chain : effect.keyFrameChains)
+		{
+			appendFrames(*this, chain.floatKeyFrames, 0);
+			appendFrames(*this, chain.vec3KeyFrames, vec3LaneStart);
+			appendFrames(*this, chain.vec4KeyFrames, vec4LaneStart);
+			appendFrames(*this, chain.mat4KeyFrames, mat4LaneStart);
+
+			for (const KeyFrame<glm::vec3>& frame : chain.vec3KeyFrames)
+			{
+				bAnimatesRotation |= frame.dataIdx == MutableEffectData::ROT_VEC3_IDX;
+			}
+		}
+
+		durationSec = effect.effectDuration.value_or(0.f);
+	}
+
+	void Particle::CompiledKeyFrames::evaluate(const float* timeAlive, size_t begin, size_t end, size_t laneStride, float* lanes) const
+	{
+		//chunked so the per frame lerp factors stay in small stack buffers
+		constexpr size_t chunkSize = 256;
+		float alphas[chunkSize];
+		float startedWeights[chunkSize];
+
+		for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += chunkSize)
+		{
+			const size_t chunkCount = std::min(chunkSize, end - chunkBegin);
+			const float* chunkTimes = timeAlive + chunkBegin;
+
+			for (size_t lane = 0; lane < laneDefaults.size(); ++lane)
+			{
+				float* laneOut = lanes + lane * laneStride + chunkBegin;
+				std::fill(laneOut, laneOut + chunkCount, laneDefaults[lane]);
+			}
+
+			for (size_t frameIdx = 0; frameIdx < frameStartTimes.size(); ++frameIdx)
+			{
+				const float startTime = frameStartTimes[frameIdx];
+				const float invDuration = frameInvDurations[frameIdx];
+
+				//frames that have not started get a weight of 0 and leave the lane alone; finished frames clamp to their end value
+				for (size_t i = 0; i < chunkCount; ++i)
+				{
+					alphas[i] = std::min(std::max((chunkTimes[i] - startTime) * invDuration, 0.f), 1.f);
+					startedWeights[i] = chunkTimes[i] >= startTime ? 1.f : 0.f;
+				}
+
+				const uint32_t firstLane = frameFirstLanes[frameIdx];
+				const uint32_t firstValue = frameFirstValues[frameIdx];
+				for (uint32_t laneOffset = 0; laneOffset < frameNumLanes[frameIdx]; ++laneOffset)
+				{
+					const float startValue = startValues[firstValue + laneOffset];
+					const float deltaValue = deltaValues[firstValue + laneOffset];
+					float* laneOut = lanes + (firstLane + laneOffset) * laneStride + chunkBegin;
+					for (size_t i = 0; i < chunkCount; ++i)
+					{
+						//weights are exactly 0 or 1, so this blend picks one value exactly; gcc will not vectorize the equivalent ternary
+						const float frameValue = startValue + alphas[i] * deltaValue;
+						laneOut[i] = laneOut[i] * (1.f - startedWeights[i]) + frameValue * startedWeights[i];
+					}
+				}
+			}
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////
+	// Effect instance data
+	/////////////////////////////////////////////////////////////////////////////
+
+	/** grows geometrically so buffers settle at the peak instance count */
+	template<typename T>
+	static void growToFit(std::vector<T>& buffer, size_t count)
+	{
+		if (buffer.size() < count)
+		{
+			buffer.resize(std::max(count, buffer.size() * 2));
+		}
+	}
+
+	void EffectInstanceData::initialize(const sp<Particle::Effect>& effect)
+	{
+		effectData = effect;
+		compiledKeyFrames.compile(*effect);
+
+		//below are += to add to built-in passed data (such as model matrix and effect time alive)
+		numMat4PerInstance += effect->numCustomMat4sPerInstance;
+		numVec4PerInstance += effect->numCustomVec4sPerInstance;
+
+		const size_t estimate = effect->estimateMaxSimultaneousEffects;
+		timeAlive.resize(estimate);
+		groupModelMats.resize(estimate);
+		laneValues.resize(compiledKeyFrames.numLanes() * estimate);
+		mat4Data.resize(numMat4PerInstance * estimate);
+		vec4Data.resize(numVec4PerInstance * estimate);
+		numInstancesThisFrame = 0;
+	}
+
+	void EffectInstanceData::addInstance(float instanceTimeAlive, const glm::mat4& groupModelMat)
+	{
+		growToFit(timeAlive, numInstancesThisFrame + 1);
+		growToFit(groupModelMats, numInstancesThisFrame + 1);
+
+		timeAlive[numInstancesThisFrame] = instanceTimeAlive;
+		groupModelMats[numInstancesThisFrame] = groupModelMat;
+		++numInstancesThisFrame;
+	}
+
+	void EffectInstanceData::prepareInstanceBuffers()
+	{
+		growToFit(laneValues, compiledKeyFrames.numLanes() * numInstancesThisFrame);
+		growToFit(mat4Data, numMat4PerInstance * numInstancesThisFrame);
+		growToFit(vec4Data, numVec4PerInstance * numInstancesThisFrame);
+	}
+
+	void EffectInstanceData::updateInstances(size_t begin, size_t end)
+	{
+		using glm::vec3; using glm::vec4; using glm::mat4;
+
+		const size_t laneStride = numInstancesThisFrame;
+		compiledKeyFrames.evaluate(timeAlive.data(), begin, end, laneStride, laneValues.data());
+
+		auto vec3Lanes = [this, laneStride](size_t vec3Idx) { return laneValues.data() + compiledKeyFrames.vec3Lane(vec3Idx) * laneStride; };
+		const float* position = vec3Lanes(MutableEffectData::POS_VEC3_IDX);
+		const float* rotation = vec3Lanes(MutableEffectData::ROT_VEC3_IDX);
+		const float* scale = vec3Lanes(MutableEffectData::SCALE_VEC3_IDX);
+
+		const float durationSec = compiledKeyFrames.durationSec;
+		for (size_t i = begin; i < end; ++i)
+		{
+			const mat4& groupModelMat = groupModelMats[i];
+			const vec3 effectPosition(position[i], position[i + laneStride], position[i + 2 * laneStride]);
+			const vec3 effectScale(scale[i], scale[i + laneStride], scale[i + 2 * laneStride]);
+
+			mat4 effectWorldModelMat;
+			if (compiledKeyFrames.bAnimatesRotation)
+			{
+				const vec3 effectRotation(rotation[i], rotation[i + laneStride], rotation[i + 2 * laneStride]);
+				mat4 effectModelMat = glm::translate(mat4(1.f), effectPosition);
+				effectModelMat = effectModelMat * glm::toMat4(Utils::degreesVecToQuat(effectRotation));
+				effectModelMat = glm::scale(effectModelMat, effectScale);
+				effectWorldModelMat = groupModelMat * effectModelMat;
+			}
+			else
+			{
+				//group * translate * scale without the full matrix multiplies
+				effectWorldModelMat[0] = groupModelMat[0] * effectScale.x;
+				effectWorldModelMat[1] = groupModelMat[1] * effectScale.y;
+				effectWorldModelMat[2] = groupModelMat[2] * effectScale.z;
+				effectWorldModelMat[3] = groupModelMat * vec4(effectPosition, 1.f);
+			}
+
+			//first matrix is always model; the user defined matrices follow
+			mat4Data[i * numMat4PerInstance] = effectWorldModelMat;
+
+			//vec4 that is available for every effect; x=time alive, y=effect duration
+			vec4Data[i * numVec4PerInstance] = vec4(timeAlive[i], durationSec, 0.f, 0.f);
+		}
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "GameFramework/SAGameEntity.h"
+
+namespace SA
+{
+	namespace Particle
+	{
+		struct Effect;
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// An effect's keyframe chains compiled into flat arrays.
+		//
+		// Every typed slot of MutableEffectData is split into scalar lanes (a vec3 is 3 lanes,
+		// a mat4 is 16) and every keyframe becomes a lerp over a run of lanes. Keyframe values
+		// only depend on time alive, so all instances of an effect are evaluated together,
+		// one lane at a time, in loops the compiler can vectorize.
+		/////////////////////////////////////////////////////////////////////////////////////
+		struct CompiledKeyFrames
+		{
+			void compile(const Effect& effect);
+
+			/** Writes lane values for instances [begin, end). lanes is lane major: lane L of instance I is lanes[L * laneStride + I]. */
+			void evaluate(const float* timeAlive, size_t begin, size_t end, size_t laneStride, float* lanes) const;
+
+			size_t numLanes() const { return laneDefaults.size(); }
+			size_t vec3Lane(size_t vec3Idx) const { return vec3LaneStart + 3 * vec3Idx; }
+
+			//lane layout: floats, then vec3s, then vec4s, then mat4s
+			size_t vec3LaneStart = 0;
+			size_t vec4LaneStart = 0;
+			size_t mat4LaneStart = 0;
+			std::vector<float> laneDefaults;
+
+			//one entry per keyframe, in chain order so later frames overwrite earlier frames that target the same slot
+			std::vector<float> frameStartTimes;
+			std::vector<float> frameInvDurations;
+			std::vector<uint32_t> frameFirstLanes;
+			std::vector<uint32_t> frameNumLanes;
+			std::vector<uint32_t> frameFirstValues;
+
+			//indexed by frameFirstValues[frame] + lane offset within the frame
+			std::vector<float> startValues;
+			std::vector<float> deltaValues;
+
+			float durationSec = 0.f;
+			bool bAnimatesRotation = false;
+		};
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Structure for storing arbitrary instance data.
+	//
+	// Instanced data allows rendering a large number of objects (models, meshes) with a single draw call.
+	//
+	// Buffers are sized for the most instances seen so far and are reused every frame; only the
+	// first numInstancesThisFrame instances are valid.
+	/////////////////////////////////////////////////////////////////////////////////////
+	struct EffectInstanceData
+	{
+		friend class ParticleSystem; //allow particle system to view this as a struct
+
+		sp<Particle::Effect> effectData;
+		Particle::CompiledKeyFrames compiledKeyFrames;
+
+		//order for which data is applied vertex attributes is the top-to-bottom order of this class.
+		size_t numMat4PerInstance = 1; //#TODO increment in custom steps
+		std::vector<glm::mat4> mat4Data;
+
+		size_t numVec4PerInstance = 1; //#TODO increment in custom steps
+		std::vector<glm::vec4> vec4Data;
+
+		//per instance inputs, gathered from the active particle groups each frame
+		std::vector<float> timeAlive;
+		std::vector<glm::mat4> groupModelMats;
+
+		//keyframe results, see CompiledKeyFrames::evaluate; the lane stride is numInstancesThisFrame
+		std::vector<float> laneValues;
+		size_t numInstancesThisFrame = 0;
+
+		/** Sets up buffers for an effect; the effect's duration must be up to date. */
+		void initialize(const sp<Particle::Effect>& effect);
+
+		/** Instances are re-gathered every frame; buffers keep their size so steady state does not allocate */
+		void clearFrameData() { numInstancesThisFrame = 0; }
+		void addInstance(float instanceTimeAlive, const glm::mat4& groupModelMat);
+
+		/** Call once after the last instance is added and before any updateInstances */
+		void prepareInstanceBuffers();
+
+		/** Evaluates keyframes and writes render data for instances [begin, end). Disjoint ranges may be updated concurrently. */
+		void updateInstances(size_t begin, size_t end);
+	};
+}
@@ -1,6 +1,7 @@
 #include "RenderModelEntity.h"
 #include "SAWorldEntity.h"
 #include "Rendering/SAShader.h"
+#include "Rendering/RenderData.h"
 
 namespace SA
 {
@@ -14,4 +15,12 @@ namespace SA
 	{
 		getModel()->draw(shader);
 	}
+
+	void RenderModelEntity::cacheDraws(RenderData& frameData, const glm::mat4& modelMatrix) const
+	{
+		if (getModel())
+		{
+			frameData.modelDraws.push_back(RenderData::ModelDraw{ getModel(), modelMatrix, std::nullopt });
+		}
+	}
 }
@@ -6,6 +6,7 @@
 namespace SA
 {
 	class Shader;
+	struct RenderData;
 
 	class RenderModelEntity : public WorldEntity
 	{
@@ -17,6 +18,8 @@ namespace SA
 		{}
 		const sp<const Model3D>& getModel() const { return constView; }
 		virtual void render(Shader& shader);
+		/** Appends what render draws for this entity to a frame's render data, so render never needs the entity itself */
+		virtual void cacheDraws(RenderData& frameData, const glm::mat4& modelMatrix) const;
 		virtual void onLevelRender() {};
 	protected:
 		const sp<Model3D>& getMyModel() const { return model; }
@@ -7,6 +7,8 @@
 #include "GameFramework/SALevel.h"
 #include "GameFramework/SABehaviorTree.h"
 #include "GameFramework/SATimeManagementSystem.h"
+#include "GameFramework/SAAILodScheduler.h"
+#include "GameFramework/SAWorldEntity.h"
 
 namespace SA
 {
@@ -27,8 +29,13 @@ namespace SA
 
 		if (const sp<LevelBase>& currentLevel = GameBase::get().getLevelSystem().getCurrentLevel())
 		{
+			//the tree is the agent key so the tree's ticking tasks share this brain's tier
+			AILodScheduler& aiScheduler = currentLevel->getAILodScheduler();
+			WorldEntity* anchor = getLodAnchor();
+			aiScheduler.addAgent(behaviorTree.get(), anchor ? fwp<WorldEntity>(anchor->requestTypedReference_Nonsafe<WorldEntity>()) : fwp<WorldEntity>(nullptr));
+
 			behaviorTree->start();
-			currentLevel->getWorldTimeManager()->registerTicker(sp_this());
+			aiScheduler.registerTicker(sp_this(), behaviorTree.get());
 			tickingOnLevel = currentLevel;
 			return true;
 		}
@@ -41,7 +48,9 @@ namespace SA
 
 		if (!tickingOnLevel.expired())
 		{
-			tickingOnLevel.lock()->getWorldTimeManager()->removeTicker(sp_this());
+			AILodScheduler& aiScheduler = tickingOnLevel.lock()->getAILodScheduler();
+			aiScheduler.removeTicker(sp_this());
+			aiScheduler.removeAgent(behaviorTree.get());
 		}
 	}
 
@@ -16,6 +16,7 @@ namespace SA
 		class Tree;
 	}
 	class LevelBase;
+	class WorldEntity;
 
 	//#TODO this probably needs to exist separately in another header, so  player can do pattern of having protected member return a key
 	/** Special key to allows brains (ai/player) to access methods
@@ -68,6 +69,9 @@ namespace SA
 	protected:
 		virtual bool tick(float dt_sec) override;
 
+		/** The entity the level's AI lod scheduler measures this brain from; brains without one always tick at full rate */
+		virtual WorldEntity* getLodAnchor() { return nullptr; }
+
 	protected:
 		sp<BehaviorTree::Tree> behaviorTree;
 		wp<LevelBase> tickingOnLevel;
@@ -0,0 +1,245 @@
+#include "GameFramework/SAAILodScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include <glm/gtx/norm.hpp>
+
+#include "GameFramework/SAWorldEntity.h"
+#include "Rendering/RenderData.h"
+
+namespace SA
+{
+	using LodClock = std::chrono::steady_clock;
+
+	void AILodScheduler::addAgent(const void* agentKey, const fwp<WorldEntity>& anchor)
+	{
+		auto insertResult = agents.insert({ agentKey, Agent{} });
+		Agent& agent = insertResult.first->second;
+		agent.anchor = anchor;
+		if (insertResult.second)
+		{
+			//consecutive phases land on different frames for every tier interval, which is what spreads a tier's work evenly
+			agent.phase = nextPhase++;
+		}
+	}
+
+	void AILodScheduler::removeAgent(const void* agentKey)
+	{
+		agents.erase(agentKey);
+	}
+
+	void AILodScheduler::registerTicker(const sp<ITickable>& tickable, const void* agentKey)
+	{
+		if (!tickable || hasRegisteredTicker(tickable))
+		{
+			return;
+		}
+
+		TickerEntry entry;
+		entry.tickable = tickable;
+		entry.agentKey = agentKey;
+		if (bTicking)
+		{
+			pendingTickers.push_back(entry);
+		}
+		else
+		{
+			tickerToIdx.insert({ tickable.get(), tickers.size() });
+			tickers.push_back(entry);
+		}
+	}
+
+	void AILodScheduler::removeTicker(const sp<ITickable>& tickable)
+	{
+		auto findResult = tickerToIdx.find(tickable.get());
+		if (findResult != tickerToIdx.end())
+		{
+			tickers[findResult->second].bRemoved = true;
+			tickerToIdx.erase(findResult);
+			bHasRemovedTickers = true; //compacted at the start of the next tick
+			return;
+		}
+
+		auto pendingIter = std::find_if(pendingTickers.begin(), pendingTickers.end(), [&tickable](const TickerEntry& entry) { return entry.tickable == tickable; });
+		if (pendingIter != pendingTickers.end())
+		{
+			pendingTickers.erase(pendingIter);
+		}
+	}
+
+	bool AILodScheduler::hasRegisteredTicker(const sp<ITickable>& tickable) const
+	{
+		return tickerToIdx.find(tickable.get()) != tickerToIdx.end()
+			|| std::any_of(pendingTickers.begin(), pendingTickers.end(), [&tickable](const TickerEntry& entry) { return entry.tickable == tickable; });
+	}
+
+	void AILodScheduler::clear()
+	{
+		agents.clear();
+		tickers.clear();
+		tickerToIdx.clear();
+		pendingTickers.clear();
+		bHasRemovedTickers = false;
+		tierStats = {};
+		numPlayerRelevantAgents = 0;
+	}
+
+	void AILodScheduler::setViewers(const RenderData& frameRenderData)
+	{
+		if (frameRenderData.bHasCameraFrustum)
+		{
+			setViewers(frameRenderData.playerCamerasPositions, frameRenderData.projection_view);
+		}
+		else
+		{
+			clearViewers();
+		}
+	}
+
+	void AILodScheduler::setViewers(const std::vector<glm::vec3>& inCameraPositions, const glm::mat4& projection_view)
+	{
+		cameraPositions = inCameraPositions;
+		cameraFrustum = FrustumPlanes::fromProjectionView(projection_view);
+		bHasViewers = cameraPositions.size() > 0;
+	}
+
+	void AILodScheduler::clearViewers()
+	{
+		cameraPositions.clear();
+		bHasViewers = false;
+	}
+
+	AILodScheduler::ETier AILodScheduler::getAgentTier(const void* agentKey) const
+	{
+		auto findResult = agents.find(agentKey);
+		return findResult != agents.end() ? findResult->second.tier : ETier::FULL;
+	}
+
+	AILodScheduler::ETier AILodScheduler::chooseTier(const WorldEntity& anchor)
+	{
+		if (playerRelevance && playerRelevance(anchor))
+		{
+			++numPlayerRelevantAgents;
+			return ETier::FULL;
+		}
+
+		const glm::vec3 position = anchor.getWorldPosition();
+		float nearestCamera2 = std::numeric_limits<float>::max();
+		for (const glm::vec3& cameraPosition : cameraPositions)
+		{
+			nearestCamera2 = glm::min(nearestCamera2, glm::distance2(position, cameraPosition));
+		}
+
+		size_t tierIdx = 0;
+		while (tierIdx < tierDistances.size() && nearestCamera2 >= tierDistances[tierIdx] * tierDistances[tierIdx])
+		{
+			++tierIdx;
+		}
+
+		if (bDemoteOffscreen)
+		{
+			for (const glm::vec4& plane : cameraFrustum.planes)
+			{
+				if (glm::dot(glm::vec3(plane), position) + plane.w < -offscreenMargin)
+				{
+					tierIdx = glm::min(tierIdx + 1, NUM_TIERS - 1);
+					break;
+				}
+			}
+		}
+		return ETier(tierIdx);
+	}
+
+	bool AILodScheduler::tick(float dt_sec)
+	{
+		++frame;
+		compactTickers();
+		tierStats = {};
+		numPlayerRelevantAgents = 0;
+
+		////////////////////////////////////////////////////////
+		// tier every agent from this frame's cameras
+		////////////////////////////////////////////////////////
+		LodClock::time_point tieringStart = LodClock::now();
+		for (auto& iter : agents)
+		{
+			Agent& agent = iter.second;
+			const WorldEntity* anchor = agent.anchor.get();
+			agent.tier = (bHasViewers && anchor) ? chooseTier(*anchor) : ETier::FULL;
+			++tierStats[size_t(agent.tier)].numAgents;
+		}
+		tieringMs = std::chrono::duration<double, std::milli>(LodClock::now() - tieringStart).count();
+
+		////////////////////////////////////////////////////////
+		// tick whatever is due; registration changes made by tickers are deferred until the loop is over
+		////////////////////////////////////////////////////////
+		bTicking = true;
+		for (size_t tickerIdx = 0; tickerIdx < tickers.size(); ++tickerIdx)
+		{
+			TickerEntry& entry = tickers[tickerIdx];
+			if (entry.bRemoved)
+			{
+				continue;
+			}
+			entry.accumulatedDt += dt_sec;
+
+			ETier tier = ETier::FULL;
+			uint32_t phase = 0;
+			auto agentIter = agents.find(entry.agentKey);
+			if (agentIter != agents.end())
+			{
+				tier = agentIter->second.tier;
+				phase = agentIter->second.phase;
+			}
+
+			TierStats& stats = tierStats[size_t(tier)];
+			++stats.numTickers;
+			if (((frame + phase) & (getTickInterval(tier) - 1)) != 0)
+			{
+				continue;
+			}
+
+			const float tickDt = entry.accumulatedDt;
+			entry.accumulatedDt = 0.f;
+
+			LodClock::time_point tickStart = LodClock::now();
+			const bool bKeepTicking = entry.tickable->tick(tickDt);
+			stats.tickMs += std::chrono::duration<double, std::milli>(LodClock::now() - tickStart).count();
+			++stats.numTicks;
+
+			if (!bKeepTicking && !tickers[tickerIdx].bRemoved)
+			{
+				removeTicker(tickers[tickerIdx].tickable);
+			}
+		}
+		bTicking = false;
+
+		for (TickerEntry& pending : pendingTickers)
+		{
+			tickerToIdx.insert({ pending.tickable.get(), tickers.size() });
+			tickers.push_back(std::move(pending));
+		}
+		pendingTickers.clear();
+
+		return true;
+	}
+
+	void AILodScheduler::compactTickers()
+	{
+		if (!bHasRemovedTickers)
+		{
+			return;
+		}
+
+		//stable so tick order stays the registration order
+		tickers.erase(std::remove_if(tickers.begin(), tickers.end(), [](const TickerEntry& entry) { return entry.bRemoved; }), tickers.end());
+		tickerToIdx.clear();
+		for (size_t tickerIdx = 0; tickerIdx < tickers.size(); ++tickerIdx)
+		{
+			tickerToIdx.insert({ tickers[tickerIdx].tickable.get(), tickerIdx });
+		}
+		bHasRemovedTickers = false;
+	}
+}
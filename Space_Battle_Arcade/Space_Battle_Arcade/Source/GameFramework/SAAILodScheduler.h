@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "GameFramework/Interfaces/SATickable.h"
+#include "Rendering/FrustumCulling.h"
+#include "Tools/DataStructures/AdvancedPtrs.h"
+#include "Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	class WorldEntity;
+	struct RenderData;
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Ticks AI at a rate that depends on how close it is to what the players are looking at.
+	//
+	// An agent is a brain plus the ticking tasks of its tree; they are keyed by the same pointer (the brain's tree) so
+	// they always share a tier. Each frame an agent's tier comes from the distance between its anchor entity and the
+	// nearest player camera, and agents outside the first camera's frustum drop one more tier. A tier at 1/N rate ticks
+	// an agent every Nth frame; agents get consecutive phases as they are added, so each frame handles about 1/N of a
+	// tier. That is the spreading AmortizeLoopTool does, but it survives agents moving between tiers every frame.
+	// Skipped tickers accumulate dt and receive all of it on their next tick, so no simulated time is lost.
+	//
+	// Agents the game reports as relevant to a player (eg targeting or targeted by a player) always tick at full rate,
+	// as does everything while there is no camera (eg headless runs).
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AILodScheduler final : public ITickable, public RemoveCopies, public RemoveMoves
+	{
+	public:
+		enum class ETier : uint8_t { FULL = 0, HALF, QUARTER, EIGHTH, COUNT };
+		static constexpr size_t NUM_TIERS = size_t(ETier::COUNT);
+		static constexpr uint32_t getTickInterval(ETier tier) { return 1u << uint32_t(tier); }
+
+		/** Numbers from the last tick, for tuning budgets */
+		struct TierStats
+		{
+			size_t numAgents = 0;
+			size_t numTickers = 0;
+			size_t numTicks = 0; //tickers that actually ticked
+			double tickMs = 0.0;
+		};
+
+		using PlayerRelevance = std::function<bool(const WorldEntity& anchor)>;
+
+	public:
+		/** Agents without an anchor, or whose anchor was destroyed, tick at full rate */
+		void addAgent(const void* agentKey, const fwp<WorldEntity>& anchor);
+		void removeAgent(const void* agentKey);
+
+		/** Tickers not belonging to a known agent tick at full rate. Safe to call while ticking; takes effect next tick. */
+		void registerTicker(const sp<ITickable>& tickable, const void* agentKey);
+		void removeTicker(const sp<ITickable>& tickable);
+		bool hasRegisteredTicker(const sp<ITickable>& tickable) const;
+		void clear();
+
+		/** Cameras used for the next tiering; frames without a camera frustum leave everything at full rate */
+		void setViewers(const RenderData& frameRenderData);
+		void setViewers(const std::vector<glm::vec3>& cameraPositions, const glm::mat4& projection_view);
+		void clearViewers();
+
+		void setPlayerRelevance(const PlayerRelevance& inPlayerRelevance) { playerRelevance = inPlayerRelevance; }
+
+		/** Distances where each tier after FULL starts */
+		void setTierDistances(const std::array<float, NUM_TIERS - 1>& inTierDistances) { tierDistances = inTierDistances; }
+		void setDemoteOffscreen(bool bDemote) { bDemoteOffscreen = bDemote; }
+
+		ETier getAgentTier(const void* agentKey) const;
+		const TierStats& getTierStats(ETier tier) const { return tierStats[size_t(tier)]; }
+		size_t getNumPlayerRelevantAgents() const { return numPlayerRelevantAgents; }
+		double getTieringMs() const { return tieringMs; }
+		size_t getNumAgents() const { return agents.size(); }
+
+		virtual bool tick(float dt_sec) override;
+
+	private:
+		struct Agent
+		{
+			fwp<WorldEntity> anchor;
+			uint32_t phase = 0;
+			ETier tier = ETier::FULL;
+		};
+
+		struct TickerEntry
+		{
+			sp<ITickable> tickable;
+			const void* agentKey = nullptr;
+			float accumulatedDt = 0.f;
+			bool bRemoved = false; //kept alive until the tick is over, it may be the ticker doing the removing
+		};
+
+		ETier chooseTier(const WorldEntity& anchor);
+		void compactTickers();
+
+	private:
+		std::unordered_map<const void*, Agent> agents;
+		std::vector<TickerEntry> tickers;
+		std::unordered_map<const ITickable*, size_t> tickerToIdx;
+		std::vector<TickerEntry> pendingTickers;
+		bool bTicking = false;
+		bool bHasRemovedTickers = false;
+
+		uint32_t frame = 0;
+		uint32_t nextPhase = 0;
+
+		std::vector<glm::vec3> cameraPositions;
+		FrustumPlanes cameraFrustum;
+		bool bHasViewers = false;
+		bool bDemoteOffscreen = true;
+		float offscreenMargin = 20.f; //roughly a ship's radius, so ships at the screen edge are not demoted
+		std::array<float, NUM_TIERS - 1> tierDistances = { 250.f, 1000.f, 4000.f };
+		PlayerRelevance playerRelevance;
+
+		std::array<TierStats, NUM_TIERS> tierStats;
+		size_t numPlayerRelevantAgents = 0;
+		double tieringMs = 0.0;
+	};
+}
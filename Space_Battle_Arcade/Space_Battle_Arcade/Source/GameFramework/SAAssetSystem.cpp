@@ -8,6 +8,7 @@
 #include "Rendering/OpenGLHelpers.h"
 #include "Rendering/Camera/Texture_2D.h"
 #include <Libraries/dr_lib/dr_wav.h>
+#include "Audio/AudioDecoder.h"
 #include "Audio/SoundRawData.h"
 #include "Audio/OpenALUtilities.h"
 #include "SAAudioSystem.h"
@@ -77,34 +78,15 @@ namespace SA
 
 	AssetHandle<SoundRawData> AssetSystem::loadSound(const std::string& relative_filepath)
 	{
-		SoundRawData loadedData;
-		drwav_int16* pSampleData = drwav_open_file_and_read_pcm_frames_s16(relative_filepath.c_str(), &loadedData.channels, &loadedData.sampleRate, &loadedData.totalPCMFrameCount, nullptr);
-
-		bool bSuccess = true;
-		if (pSampleData == nullptr)
-		{
-			std::cerr << "failed to load audio file" << std::endl;
-			bSuccess = false;
-		}
-		if (loadedData.getTotalSamples() > drwav_uint64(std::numeric_limits<size_t>::max()))
+		auto findIter = loadedSoundPcmData.find(relative_filepath);
+		if (findIter != loadedSoundPcmData.end())
 		{
-			std::cerr << "too much data in file for 32bit addressed vector" << std::endl;
-			bSuccess = false;
+			return findIter->second; //decoded ahead of time, eg by mod loading
 		}
 
-		sp<SoundRawData> loadedDataPtr = nullptr;
-
-		if (bSuccess)
+		sp<SoundRawData> loadedDataPtr = decodeSound(relative_filepath);
+		if (loadedDataPtr)
 		{
-			loadedData.pcmData.resize(size_t(loadedData.getTotalSamples()));
-			std::memcpy(loadedData.pcmData.data(), pSampleData, loadedData.pcmData.size() * /*twobytes_in_s16*/2);
-			loadedDataPtr = new_sp<SoundRawData>(std::move(loadedData));
-			//loadedData should now be considered empty!
-
-			//sample rate is samples per sec (generally 44100 hz)
-			//total frame count should be the same regardless if it is mono,stereo, etc.
-			loadedDataPtr->durationSec = float(loadedDataPtr->totalPCMFrameCount) / float(loadedDataPtr->sampleRate);
-
 			loadedSoundPcmData.insert({ relative_filepath, loadedDataPtr });
 		}
 		else
@@ -113,11 +95,50 @@ namespace SA
 			STOP_DEBUGGER_HERE();
 		}
 
-		drwav_free(pSampleData, /*allocation callbacks*/nullptr);
+		return loadedDataPtr;
+	}
+
+	/*static*/ sp<SoundRawData> AssetSystem::decodeSound(const std::string& relative_filepath)
+	{
+		sp<AudioDecoder> decoder = AudioDecoder::open(relative_filepath);
+		if (!decoder)
+		{
+			std::cerr << "failed to load audio file" << std::endl;
+			return nullptr;
+		}
+
+		SoundRawData loadedData;
+		loadedData.channels = decoder->getChannels();
+		loadedData.sampleRate = decoder->getSampleRate();
+		loadedData.totalPCMFrameCount = decoder->getTotalFrames();
+		if (loadedData.getTotalSamples() > drwav_uint64(std::numeric_limits<size_t>::max()))
+		{
+			std::cerr << "too much data in file for 32bit addressed vector" << std::endl;
+			return nullptr;
+		}
+
+		loadedData.pcmData.resize(size_t(loadedData.getTotalSamples()));
+		loadedData.totalPCMFrameCount = decoder->readFrames(reinterpret_cast<int16_t*>(loadedData.pcmData.data()), loadedData.totalPCMFrameCount);
+		loadedData.pcmData.resize(size_t(loadedData.getTotalSamples())); //compressed formats may report a slightly different length than they decode
+
+		sp<SoundRawData> loadedDataPtr = new_sp<SoundRawData>(std::move(loadedData));
+		//loadedData should now be considered empty!
+
+		//sample rate is samples per sec (generally 44100 hz)
+		//total frame count should be the same regardless if it is mono,stereo, etc.
+		loadedDataPtr->durationSec = float(loadedDataPtr->totalPCMFrameCount) / float(loadedDataPtr->sampleRate);
 
 		return loadedDataPtr;
 	}
 
+	void AssetSystem::addDecodedSound(const std::string& relative_filepath, const sp<SoundRawData>& soundData)
+	{
+		if (soundData)
+		{
+			loadedSoundPcmData.insert({ relative_filepath, soundData });
+		}
+	}
+
 	AssetHandle<SoundRawData> AssetSystem::getSound(const std::string& relative_filepath)
 	{
 		auto findIter = loadedSoundPcmData.find(relative_filepath);
@@ -241,6 +262,7 @@ namespace SA
 						if (error == AL_NO_ERROR)
 						{
 							assetPathToloadedAlBuffers.insert({ relative_filepath, alWrapper});
+							loadedSoundPcmData.erase(relative_filepath); //the api owns a copy now; keeping ours would double the residency
 							return alWrapper;
 						}
 						else
@@ -292,6 +314,12 @@ namespace SA
 
 	bool AssetSystem::loadTexture_internal(unsigned char* textureData, int img_width, int img_height, int img_nrChannels, const char* relative_filepath, GLuint& outTexId, int texture_unit /*= -1*/, bool useGammaCorrection /*= false*/)
 	{
+		if (GameBase::isHeadless())
+		{
+			outTexId = 0; //no GL context; nothing will sample it since render dispatch doesn't run
+			return true;
+		}
+
 		GLuint textureID;
 		ec(glGenTextures(1, &textureID));
 
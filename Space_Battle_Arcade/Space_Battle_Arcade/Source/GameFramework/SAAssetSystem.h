@@ -34,6 +34,12 @@ namespace SA
 		sp<Model3D> getModel(const std::string& key) const;
 		AssetHandle<SoundRawData> loadSound(const std::string& relative_filepath);
 		AssetHandle<SoundRawData> getSound(const std::string& relative_filepath);
+
+		/** Decodes a sound file without touching asset system state, so it is safe to call from worker threads. Returns null on failure. */
+		static sp<SoundRawData> decodeSound(const std::string& relative_filepath);
+
+		/** Caches sound data decoded off the game thread (see decodeSound); a later loadSound of the same path uses it instead of decoding again */
+		void addDecodedSound(const std::string& relative_filepath, const sp<SoundRawData>& soundData);
 		sp<Texture_2D> getNullBlackTexture() const;
 
 		bool loadTexture(const char* relative_filepath, GLuint& outTexId, int texture_unit = -1, bool useGammaCorrection = false);
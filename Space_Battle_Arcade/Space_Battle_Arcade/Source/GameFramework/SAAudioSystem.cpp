@@ -1,5 +1,7 @@
 #include "SAAudioSystem.h"
 
+#include "Audio/AudioDecoder.h"
+#include "Audio/AudioStream.h"
 #include "Audio/OpenALUtilities.h"
 #include "GameFramework/SAAssetSystem.h"
 #include "GameFramework/SAGameBase.h"
@@ -22,6 +24,11 @@ namespace SA
 {
 #define IGNORE_AUDIO_COMPILE_TODOS 1
 
+	//streamed sounds: ~0.19s chunks at 44.1khz; the decoder ring and the api queue each hold a few of them
+	constexpr uint32_t STREAM_CHUNK_FRAMES = 8192;
+	constexpr uint32_t STREAM_RING_CHUNKS = 4;
+	constexpr size_t STREAM_QUEUED_BUFFERS = 4;
+
 
 //defines whether extra logging should be compiled to debug resource management
 #define VERBOSE_AUDIO_RESOURCE_LOGGING 0
@@ -237,6 +244,20 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 #if USE_OPENAL_API
 		const std::string& path = emitter.userData.sfxAssetPath;
 
+		if (hasValidOpenALDevice() && shouldStreamEmitter(emitter))
+		{
+			emitter.hardwareData.bufferIdx.reset();
+			if (emitter.hardwareData.sourceIdx.has_value())
+			{
+				startEmitterStream(emitter);
+			}
+			return;
+		}
+		else if (emitter.hardwareData.stream)
+		{
+			stopEmitterStream(emitter); //path changed to a sound that is played from a static buffer
+		}
+
 		ALBufferWrapper bufferData;
 
 		auto findResult = audioBuffers.find(path);
@@ -288,6 +309,7 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		{
 			ALuint source = *emitter.hardwareData.sourceIdx;
 			CONDITIONAL_VERBOSE_RESOURCE_LOG_MESSAGE("stoping source %d", source);
+			stopEmitterStream(emitter);
 
 			//if user requested stop, then stop immediately; don't let system fade it out
 			alec(alSourceStop(source));
@@ -392,6 +414,16 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		return rawGain * systemWideVolume * (bIsMusic ? musicVolume : 1.f);
 	}
 
+	void AudioSystem::cacheSoundDuration(const std::string& filePath, float durationSec)
+	{
+#if USE_OPENAL_API
+		SoundHeader header;
+		header.durationSec = durationSec;
+		header.bValid = true;
+		soundHeaders[filePath] = header;
+#endif //USE_OPENAL_API
+	}
+
 #if USE_OPENAL_API
 	void AudioSystem::updateSourceProperties(AudioEmitter& emitterSource)
 	{
@@ -463,7 +495,8 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 			}
 			if (md.dirtyFlags.bLooping) 
 			{ 
-				alec(alSourcei(src, AL_LOOPING, ALint(ud.bLooping)));
+				//streams loop by seeking their decoder; looping the api queue would replay only the queued chunks
+				alec(alSourcei(src, AL_LOOPING, ALint(ud.bLooping && !emitterSource.hardwareData.stream)));
 				md.dirtyFlags.bLooping = false; 
 			}
 			if (md.dirtyFlags.bReferenceDistance)
@@ -499,6 +532,164 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		alec(alDeleteSources(1, &source));
 	}
 
+	bool AudioSystem::shouldStreamEmitter(AudioEmitter& emitter)
+	{
+		const std::string& path = emitter.userData.sfxAssetPath;
+		auto findResult = soundHeaders.find(path);
+		if (findResult == soundHeaders.end())
+		{
+			//sounds the mod loader measured are already cached; otherwise measure once here. For mp3 that scans the whole file
+			SoundHeader header;
+			if (sp<AudioDecoder> decoder = AudioDecoder::open(path))
+			{
+				header.durationSec = decoder->getDurationSec();
+				header.bValid = true;
+			}
+			findResult = soundHeaders.insert({ path, header }).first;
+		}
+
+		const SoundHeader& header = findResult->second;
+		if (header.bValid && shouldStreamSound(header.durationSec, emitter.userData.bIsMusic))
+		{
+			emitter.systemMetaData.audioDurationSec = header.durationSec;
+			return true;
+		}
+		return false;
+	}
+
+	void AudioSystem::startEmitterStream(AudioEmitter& emitter)
+	{
+		stopEmitterStream(emitter);
+
+		EmitterHardwareData& hw = emitter.hardwareData;
+		ALuint source = *hw.sourceIdx;
+		alec(alSourceStop(source));
+		alec(alSourcei(source, AL_BUFFER, 0)); //detach any static buffer so the source can take a queue
+
+		sp<AudioDecoder> decoder = AudioDecoder::open(emitter.userData.sfxAssetPath);
+		if (!decoder)
+		{
+			logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "Failed to open sound for streaming %s", emitter.userData.sfxAssetPath.c_str());
+			return;
+		}
+
+		hw.stream = new_sp<AudioStream>(decoder, STREAM_CHUNK_FRAMES, STREAM_RING_CHUNKS, emitter.userData.bLooping);
+
+		//prime on this thread so the source has audio the moment it plays; the decoder thread takes over once the stream is registered
+		while (hw.stream->decodeNextChunk()) {}
+
+		for (size_t bufferNum = 0; bufferNum < STREAM_QUEUED_BUFFERS; ++bufferNum)
+		{
+			std::optional<ALuint> opt_buffer = streamBufferPool.getInstance();
+			if (!opt_buffer.has_value())
+			{
+				ALuint newBuffer = 0;
+				alec(alGenBuffers(1, &newBuffer));
+				if (newBuffer)
+				{
+					generatedStreamBuffers.push_back(newBuffer);
+					opt_buffer = newBuffer;
+				}
+			}
+			if (opt_buffer.has_value())
+			{
+				hw.streamBuffers.push_back(*opt_buffer);
+				hw.idleStreamBuffers.push_back(*opt_buffer);
+			}
+		}
+		queueIdleStreamBuffers(emitter);
+
+		if (streamDecoderThread)
+		{
+			streamDecoderThread->addStream(hw.stream);
+		}
+	}
+
+	void AudioSystem::updateEmitterStream(AudioEmitter& emitter)
+	{
+		EmitterHardwareData& hw = emitter.hardwareData;
+		ALuint source = *hw.sourceIdx;
+
+		ALint numProcessed = 0;
+		alec(alGetSourcei(source, AL_BUFFERS_PROCESSED, &numProcessed));
+		for (ALint processedIdx = 0; processedIdx < numProcessed; ++processedIdx)
+		{
+			ALuint buffer = 0;
+			alec(alSourceUnqueueBuffers(source, 1, &buffer));
+			hw.idleStreamBuffers.push_back(buffer);
+		}
+
+		if (!streamDecoderThread)
+		{
+			while (hw.stream->decodeNextChunk()) {}
+		}
+
+		const size_t numIdleBefore = hw.idleStreamBuffers.size();
+		queueIdleStreamBuffers(emitter);
+
+		//a source that drained its queue before the decoder caught up stops; restart it now that it has audio again
+		ALint sourceState = 0;
+		alec(alGetSourcei(source, AL_SOURCE_STATE, &sourceState));
+		if (sourceState == AL_STOPPED && hw.idleStreamBuffers.size() < numIdleBefore)
+		{
+			alec(alSourcePlay(source));
+		}
+
+		if (numProcessed > 0 && streamDecoderThread)
+		{
+			streamDecoderThread->wake();
+		}
+	}
+
+	void AudioSystem::stopEmitterStream(AudioEmitter& emitter)
+	{
+		EmitterHardwareData& hw = emitter.hardwareData;
+		if (!hw.stream)
+		{
+			return;
+		}
+
+		if (hw.sourceIdx.has_value())
+		{
+			alec(alSourceStop(*hw.sourceIdx));
+			alec(alSourcei(*hw.sourceIdx, AL_BUFFER, 0)); //unqueues every buffer
+		}
+		for (ALuint buffer : hw.streamBuffers)
+		{
+			streamBufferPool.releaseInstance(buffer);
+		}
+		hw.streamBuffers.clear();
+		hw.idleStreamBuffers.clear();
+
+		if (streamDecoderThread)
+		{
+			streamDecoderThread->removeStream(hw.stream);
+		}
+		hw.stream = nullptr;
+	}
+
+	void AudioSystem::queueIdleStreamBuffers(AudioEmitter& emitter)
+	{
+		EmitterHardwareData& hw = emitter.hardwareData;
+		AudioStream& stream = *hw.stream;
+		const ALenum format = stream.getChannels() > 1 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
+
+		while (!hw.idleStreamBuffers.empty())
+		{
+			const AudioStream::Chunk* chunk = stream.peekChunk();
+			if (!chunk)
+			{
+				break;
+			}
+
+			ALuint buffer = hw.idleStreamBuffers.back();
+			alec(alBufferData(buffer, format, chunk->samples.data(), ALsizei(chunk->numFrames * stream.getChannels() * sizeof(int16_t)), ALsizei(stream.getSampleRate())));
+			alec(alSourceQueueBuffers(*hw.sourceIdx, 1, &buffer));
+			hw.idleStreamBuffers.pop_back();
+			stream.popChunk();
+		}
+	}
+
 #endif
 
 	void AudioSystem::initSystem()
@@ -521,77 +712,88 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 #endif
 
 
-#if COMPILE_AUDIO
-#if USE_OPENAL_API
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		// find the default audio device
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		const ALCchar* defaultDeviceString = alcGetString(/*device*/nullptr, ALC_DEFAULT_DEVICE_SPECIFIER);
-		device = alcOpenDevice(defaultDeviceString);
-		if (!device)
+		if (GameBase::isHeadless())
 		{
-			log("AudioSystem - OpenAL", LogLevel::LOG_ERROR, "FATAL: failed to get the default device for OpenAL");
-			return; //consider fatal
+			//null device: emitters still update, but none are ever given a hardware source
+			api_MaxMonoSources = 0;
 		}
-
-		std::string deviceLogString = std::string("OpenAL Device: ") + alcGetString(device, ALC_DEVICE_SPECIFIER);
-		log("AudioSystem - OpenAL", LogLevel::LOG, deviceLogString.c_str());
-
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		// Create an OpenAL audio context from the device
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		context = alcCreateContext(device, /*attrlist*/ nullptr);
-
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		// Activate this context so that OpenAL state modifications are applied to the context
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		if (!context || !alcMakeContextCurrent(context))
+		else
 		{
-			log("AudioSystem - OpenAL", LogLevel::LOG_ERROR, "FATAL: failed to make the OpenAL context the current context");
-			return; //consider fatal
-		}
-		OpenAL_ErrorCheck("Make context current"); //NOTE: we shouldn't error check until we have a nonnull context
-
-		//query device data
-		ALCint numAttributes;
-		alec(alcGetIntegerv(device, ALC_ATTRIBUTES_SIZE, 1, &numAttributes));
+#if COMPILE_AUDIO
+#if USE_OPENAL_API
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			// find the default audio device
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			const ALCchar* defaultDeviceString = alcGetString(/*device*/nullptr, ALC_DEFAULT_DEVICE_SPECIFIER);
+			device = alcOpenDevice(defaultDeviceString);
+			if (!device)
+			{
+				log("AudioSystem - OpenAL", LogLevel::LOG_ERROR, "FATAL: failed to get the default device for OpenAL");
+				return; //consider fatal
+			}
 
-		std::vector<ALCint> contextAttributes(numAttributes);
-		alec(alcGetIntegerv(device, ALC_ALL_ATTRIBUTES, numAttributes, &contextAttributes[0]));
+			std::string deviceLogString = std::string("OpenAL Device: ") + alcGetString(device, ALC_DEVICE_SPECIFIER);
+			log("AudioSystem - OpenAL", LogLevel::LOG, deviceLogString.c_str());
 
-		//attribute appear to be packed in pairs, hence this loop jumps 2 spaces at a time
-		for (size_t attributeIdx = 0; attributeIdx < contextAttributes.size(); attributeIdx += 2)
-		{
-			ALCint attribute = contextAttributes[attributeIdx];
-			size_t valueIdx = attributeIdx + 1;
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			// Create an OpenAL audio context from the device
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			context = alcCreateContext(device, /*attrlist*/ nullptr);
 
-			if (attribute == ALC_MONO_SOURCES)
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			// Activate this context so that OpenAL state modifications are applied to the context
+			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+			if (!context || !alcMakeContextCurrent(context))
 			{
-				if (Utils::isValidIndex(contextAttributes, valueIdx))
-				{
-					api_MaxMonoSources = size_t(contextAttributes[valueIdx]);
-					logf_sa(__FUNCTION__, LogLevel::LOG, "OpenAL max audio mono sources: %d", int(api_MaxMonoSources));
-				}
-				else
-				{
-					log(__FUNCTION__, LogLevel::LOG_ERROR, "cannot read max mono sources attribute value as value index is invalid"); STOP_DEBUGGER_HERE();
-				}
+				log("AudioSystem - OpenAL", LogLevel::LOG_ERROR, "FATAL: failed to make the OpenAL context the current context");
+				return; //consider fatal
 			}
-			else if (attribute == ALC_STEREO_SOURCES)
+			OpenAL_ErrorCheck("Make context current"); //NOTE: we shouldn't error check until we have a nonnull context
+
+			//query device data
+			ALCint numAttributes;
+			alec(alcGetIntegerv(device, ALC_ATTRIBUTES_SIZE, 1, &numAttributes));
+
+			std::vector<ALCint> contextAttributes(numAttributes);
+			alec(alcGetIntegerv(device, ALC_ALL_ATTRIBUTES, numAttributes, &contextAttributes[0]));
+
+			//attribute appear to be packed in pairs, hence this loop jumps 2 spaces at a time
+			for (size_t attributeIdx = 0; attributeIdx < contextAttributes.size(); attributeIdx += 2)
 			{
-				if (Utils::isValidIndex(contextAttributes, valueIdx))
+				ALCint attribute = contextAttributes[attributeIdx];
+				size_t valueIdx = attributeIdx + 1;
+
+				if (attribute == ALC_MONO_SOURCES)
 				{
-					api_MaxStereoSources = size_t(contextAttributes[valueIdx]);
-					logf_sa(__FUNCTION__, LogLevel::LOG, "OpenAL max audio stereo sources: %d", int(api_MaxStereoSources));
+					if (Utils::isValidIndex(contextAttributes, valueIdx))
+					{
+						api_MaxMonoSources = size_t(contextAttributes[valueIdx]);
+						logf_sa(__FUNCTION__, LogLevel::LOG, "OpenAL max audio mono sources: %d", int(api_MaxMonoSources));
+					}
+					else
+					{
+						log(__FUNCTION__, LogLevel::LOG_ERROR, "cannot read max mono sources attribute value as value index is invalid"); STOP_DEBUGGER_HERE();
+					}
 				}
-				else
+				else if (attribute == ALC_STEREO_SOURCES)
 				{
-					log(__FUNCTION__, LogLevel::LOG_ERROR, "cannot read max stereo sources attribute value as value index is invalid"); STOP_DEBUGGER_HERE();
+					if (Utils::isValidIndex(contextAttributes, valueIdx))
+					{
+						api_MaxStereoSources = size_t(contextAttributes[valueIdx]);
+						logf_sa(__FUNCTION__, LogLevel::LOG, "OpenAL max audio stereo sources: %d", int(api_MaxStereoSources));
+					}
+					else
+					{
+						log(__FUNCTION__, LogLevel::LOG_ERROR, "cannot read max stereo sources attribute value as value index is invalid"); STOP_DEBUGGER_HERE();
+					}
 				}
 			}
-		}
+
+			//only long sounds use this, but starting it with the device keeps stream setup off of the first long sound's frame
+			streamDecoderThread = new_sp<AudioStreamDecoderThread>();
 #endif //USE_OPENAL_API
 #endif //ENABLE_AUDIO
+		}
 
 		//!!! must come after we've queried how many sound sources we can use !!!
 		sourcePool.reserve(api_MaxMonoSources);
@@ -612,9 +814,11 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		{
 			if (emitter && emitter->hardwareData.sourceIdx.has_value())
 			{
+				stopEmitterStream(*emitter);
 				teardownALSource(*emitter->hardwareData.sourceIdx);
 			}
 		}
+		streamDecoderThread = nullptr;
 
 		//drain the pool of sources that can be claimed
 		while (std::optional<ALuint> optionalSource= sourcePool.getInstance())
@@ -625,6 +829,12 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		logf_sa(__FUNCTION__, LogLevel::LOG, "begin cleanup al buffers");
 
 		GameBase::get().getAssetSystem().unloadAllOpenALBuffers();
+		if (!generatedStreamBuffers.empty())
+		{
+			alec(alDeleteBuffers(ALsizei(generatedStreamBuffers.size()), generatedStreamBuffers.data()));
+			generatedStreamBuffers.clear();
+			streamBufferPool.clear();
+		}
 
 		logf_sa(__FUNCTION__, LogLevel::LOG, "end cleanup al buffers");
 
@@ -686,6 +896,10 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 		if (listenerData.size() > 0)
 		{
 #if USE_OPENAL_API
+			if (!context)
+			{
+				return; //headless or the device failed to open
+			}
 			const ListenerData& listener = listenerData[0];
 
 			alec(alListener3f(AL_POSITION, listener.position.x, listener.position.y, listener.position.z));
@@ -1030,6 +1244,10 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 			if (emitterSource)
 			{
 #if USE_OPENAL_API
+				if (emitterSource->hardwareData.stream && emitterSource->hardwareData.sourceIdx.has_value())
+				{
+					updateEmitterStream(*emitterSource);
+				}
 				updateSourceProperties(*emitterSource);
 			}
 #else
@@ -1070,6 +1288,7 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 					if (emitter->hardwareData.sourceIdx.has_value())
 					{
 						ALuint source = *emitter->hardwareData.sourceIdx;
+						stopEmitterStream(*emitter);
 						teardownALSource(source);
 					}
 					emitter->hardwareData.sourceIdx.reset();
@@ -1147,6 +1366,8 @@ logf_sa(__FUNCTION__, LogLevel::LOG, msg, __VA_ARGS__);
 #if USE_OPENAL_API
 		if (emitter.hardwareData.sourceIdx.has_value())
 		{
+			stopEmitterStream(emitter);
+
 			ALuint source = *emitter.hardwareData.sourceIdx;
 			emitter.hardwareData.sourceIdx.reset();
 
@@ -24,6 +24,8 @@
 namespace SA
 {
 	class LevelBase;
+	class AudioStream;
+	class AudioStreamDecoderThread;
 
 
 	enum class AudioEmitterPriority : uint8_t
@@ -58,6 +60,9 @@ namespace SA
 #if USE_OPENAL_API
 		std::optional<ALuint> bufferIdx;
 		std::optional<ALuint> sourceIdx;
+		sp<AudioStream> stream;					//long sounds are decoded a chunk at a time into a queue of buffers rather than played from one static buffer
+		std::vector<ALuint> streamBuffers;		//every queue buffer owned by the stream
+		std::vector<ALuint> idleStreamBuffers;	//played buffers waiting for the next decoded chunk
 #endif
 	};
 
@@ -191,6 +196,11 @@ namespace SA
 		void updateSourceProperties(AudioEmitter& emitterSource);
 		void teardownALSource(ALuint source);
 #endif //USE_OPENAL_API
+		/** Sounds this long (and all music) are streamed instead of being fully decoded into a buffer */
+		static bool shouldStreamSound(float durationSec, bool bIsMusic) { return bIsMusic || durationSec >= 8.f; }
+
+		/** Lets a loader that already measured a sound hand over its duration, so deciding whether to stream it never reopens the file */
+		void cacheSoundDuration(const std::string& filePath, float durationSec);
 	public:
 		struct EmitterPrivateKey 
 		{
@@ -224,6 +234,13 @@ namespace SA
 		void addToUserActiveList(const sp<AudioEmitter>& emitter);
 		void removeFromActiveList(size_t idx);
 		void removeHardwareResources(AudioEmitter& emitter);
+#if USE_OPENAL_API
+		bool shouldStreamEmitter(AudioEmitter& emitter);
+		void startEmitterStream(AudioEmitter& emitter);
+		void updateEmitterStream(AudioEmitter& emitter);
+		void stopEmitterStream(AudioEmitter& emitter);
+		void queueIdleStreamBuffers(AudioEmitter& emitter);
+#endif //USE_OPENAL_API
 	private:
 		void handlePreLevelChange(const sp<LevelBase>& currentLevel, const sp<LevelBase>& newLevel);
 	private:
@@ -252,6 +269,15 @@ namespace SA
 		std::unordered_map</*filePath*/std::string, ALBufferWrapper> audioBuffers; 
 		std::set<ALSourceData> generatedSources;
 		PrimitivePool<ALuint> sourcePool;
+		struct SoundHeader
+		{
+			float durationSec = 0.f;
+			bool bValid = false;
+		};
+		std::unordered_map</*filePath*/std::string, SoundHeader> soundHeaders; //measured once per path, by the mod loader or on first play, to decide whether to stream
+		sp<AudioStreamDecoderThread> streamDecoderThread;
+		PrimitivePool<ALuint> streamBufferPool;
+		std::vector<ALuint> generatedStreamBuffers;
 #endif //USE_OPENAL_API
 		sp<class RNG> pitchVariabilityRNG = nullptr;
 		float cachedTimeDilation = 1.f;
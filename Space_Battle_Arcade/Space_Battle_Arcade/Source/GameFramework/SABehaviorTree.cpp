@@ -7,6 +7,7 @@
 #include "GameFramework/SAGameBase.h"
 #include "GameFramework/SALevel.h"
 #include <map>
+#include <mutex>
 #include "SARandomNumberGenerationSystem.h"
 
 
@@ -17,6 +18,45 @@ namespace SA
 	namespace BehaviorTree
 	{
 		Tree* volatile targetDebugTree = nullptr;
+		thread_local Tree* executingTree = nullptr;
+
+		namespace
+		{
+			/** Lets shared nodes find the state of the tree walking them */
+			struct ScopedExecutingTree
+			{
+				ScopedExecutingTree(Tree* tree) : previousTree(executingTree) { executingTree = tree; }
+				~ScopedExecutingTree() { executingTree = previousTree; }
+				Tree* const previousTree;
+			};
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Tree definition
+		/////////////////////////////////////////////////////////////////////////////////////
+		TreeDefinition::TreeDefinition(const std::string& name, const sp<NodeBase>& root)
+			: name(name), root(root)
+		{
+			compileNode(root);
+		}
+
+		void TreeDefinition::compileNode(const sp<NodeBase>& node)
+		{
+			if (!node->isSharedAcrossTrees() && !node->makeAgentCopy)
+			{
+				//sharing this node would have every tree stomp its members
+				throw std::runtime_error("invalid tree definition; node \"" + node->getName() + "\" cannot be shared across trees, make it with perAgentNode.");
+			}
+
+			node->priority = uint32_t(nodes.size());
+			nodes.push_back(node.get());
+			numPerAgentNodes += node->makeAgentCopy ? 1 : 0;
+
+			for (const sp<NodeBase>& childNode : node->children)
+			{
+				compileNode(childNode);
+			}
+		}
 
 		/////////////////////////////////////////////////////////////////////////////////////
 		// Behavior tree
@@ -24,18 +64,58 @@ namespace SA
 		Tree::Tree(const std::string& name, const sp<NodeBase>& root, std::vector<std::pair<std::string, sp<GameEntity>>> initializedMemory)
 			: NodeBase(name), root(root)
 		{
-			memory = new_sp<Memory>();
-			this->assignedMemory = this->memory.get(); //make sure that if this is accessed as a node, it returns correct memory.
-			for (const auto& kv_pair : initializedMemory)
-			{
-				memory->replaceValue(kv_pair.first, kv_pair.second);
-			}
+			initializeMemory(initializedMemory);
 
 			//tree structure is now set; prioritize tree nodes (eg for aborting of lower priority sub-trees)
 			uint32_t startNodePriority = 0;
 			possessNodes(root, startNodePriority);
 			numNodes = startNodePriority;
+			nodeStates.resize(numNodes);
+		}
+
+		Tree::Tree(const sp<const TreeDefinition>& definition, std::vector<std::pair<std::string, sp<GameEntity>>> initializedMemory)
+			: NodeBase(definition->getName()), definition(definition)
+		{
+			initializeMemory(initializedMemory);
+
+			numNodes = definition->getNumNodes();
+			nodes = definition->nodes;
+			nodeStates.resize(numNodes);
+
+			agentNodes.reserve(definition->getNumPerAgentNodes());
+			for (uint32_t nodePriority = 0; nodePriority < numNodes; ++nodePriority)
+			{
+				if (nodes[nodePriority]->makeAgentCopy)
+				{
+					agentNodes.push_back(nodes[nodePriority]->makeAgentCopy());
+					possessNode(*agentNodes.back(), nodePriority);
+				}
+			}
+
+			//reverse pre-order notifies children before their parents, same as possessNodes
+			for (auto agentNode = agentNodes.rbegin(); agentNode != agentNodes.rend(); ++agentNode)
+			{
+				(*agentNode)->notifyTreeEstablished();
+			}
+		}
 
+		RNG& Tree::getRNG()
+		{
+			if (!rng)
+			{
+				rng = GameBase::get().getRNGSystem().getTimeInfluencedRNG();
+			}
+			return *rng;
+		}
+
+		void Tree::initializeMemory(const std::vector<std::pair<std::string, sp<GameEntity>>>& initializedMemory)
+		{
+			memory = new_sp<Memory>();
+			this->assignedMemory = this->memory.get(); //make sure that if this is accessed as a node, it returns correct memory.
+			for (const auto& kv_pair : initializedMemory)
+			{
+				memory->replaceValue(kv_pair.first, kv_pair.second);
+			}
 		}
 
 		void Tree::start()
@@ -52,6 +132,8 @@ namespace SA
 		{
 			if (bExecutingTree)
 			{
+				ScopedExecutingTree scopedExecutingTree(this);
+
 				//clear execution stack using abort feature.
 				abort(0);
 				ExecutionState mockState;
@@ -99,9 +181,7 @@ namespace SA
 
 		void Tree::possessNodes(const sp<NodeBase>& node, uint32_t& currentPriority)
 		{
-			node->priority = currentPriority++;
-			node->owningTree = this;
-			node->assignedMemory = this->memory.get();
+			possessNode(*node, currentPriority++);
 			for (const sp<NodeBase>& childNode : node->children)
 			{
 				possessNodes(childNode, currentPriority);
@@ -109,6 +189,19 @@ namespace SA
 			node->notifyTreeEstablished();
 		}
 
+		void Tree::possessNode(NodeBase& node, uint32_t nodePriority)
+		{
+			node.priority = nodePriority;
+			node.owningTree = this;
+			node.assignedMemory = this->memory.get();
+
+			if (nodes.size() <= nodePriority)
+			{
+				nodes.resize(nodePriority + 1, nullptr);
+			}
+			nodes[nodePriority] = &node;
+		}
+
 		/*
 			Tip Debugging this method: I recommend putting the currentState and CurrentNode->nodeName in watch window
 			This will give a clear picture of the what the state machine is doing.
@@ -130,6 +223,7 @@ namespace SA
 			*/
 			if (bExecutingTree)
 			{
+				ScopedExecutingTree scopedExecutingTree(this);
 				if (NodeBase* currentNode = executionStack.back())
 				{
 					ExecutionState currentState = ExecutionState::STARTING;
@@ -166,8 +260,9 @@ namespace SA
 						{
 							if (NodeBase* child = currentNode->getNextChild())
 							{
+								child = nodes[child->priority]; //parents may hand back a definition's node; swap in this tree's copy
 								executionStack.push_back(child);
-								child->bOnExecutionStack = true; //#suggested it may be worth-while to have a "onPushedToExecutionStack" and "onPopedFromStack" methods that do this and other things
+								nodeStates[child->priority].bOnExecutionStack = true; //#suggested it may be worth-while to have a "onPushedToExecutionStack" and "onPopedFromStack" methods that do this and other things
 								currentState = ExecutionState::PUSHED_CHILD;
 								currentNode = child;
 								nodesVisited++;
@@ -287,8 +382,9 @@ namespace SA
 		/////////////////////////////////////////////////////////////////////////////////////
 		void SingleChildNode::notifyCurrentChildResult(bool childResult)
 		{
-			bChildExecutionResult = childResult;
-			bChildReturned = true;
+			NodeState& state = getNodeState();
+			state.bChildResult = childResult;
+			state.bChildReturned = true;
 		}
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -302,27 +398,29 @@ namespace SA
 				//efficient tree structures meaning not bounds checking child index
 				throw std::runtime_error("invalid multichild node; no children passed. This will corrupt efficient tree structures and cannot be permitted.");
 			}
-
-			childResults = std::vector<bool>(children.size(), false);
-			childHasReturned = std::vector<bool>(children.size(), false);
-
-			resetMultiNode();
+			if (children.size() > MAX_CHILDREN)
+			{
+				throw std::runtime_error("invalid multichild node; too many children for the node state's result bits.");
+			}
 		}
 
 		void MultiChildNode::notifyCurrentChildResult(bool childResult)
 		{
-			if (childIdx < childResults.size())
+			NodeState& state = getNodeState();
+			if (state.childIdx < children.size())
 			{
-				childResults[childIdx] = childResult;
-				childHasReturned[childIdx] = true;
+				const uint64_t childBit = uint64_t(1) << state.childIdx;
+				state.childResults = childResult ? (state.childResults | childBit) : (state.childResults & ~childBit);
+				state.childHasReturned |= childBit;
 			}
 		}
 
 		bool MultiChildNode::tryIncrementChild()
 		{
-			if (childIdx < children.size() - 1)
+			NodeState& state = getNodeState();
+			if (state.childIdx < children.size() - 1)
 			{
-				childIdx++;
+				state.childIdx++;
 				return true;
 			}
 			else
@@ -333,21 +431,18 @@ namespace SA
 
 		void MultiChildNode::resetMultiNode()
 		{
-			/* non virtual; intended to be safe to call within constructor; be careful adding virtual calls here*/
+			/* non virtual; be careful adding virtual calls here*/
 			NodeBase::resetNode();
-			childIdx = 0;
 
-			assert(childResults.size() == childHasReturned.size());
-			for (size_t childIdx = 0; childIdx < childResults.size(); ++childIdx)
-			{
-				childResults[childIdx] = false;
-				childHasReturned[childIdx] = false;
-			}
+			NodeState& state = getNodeState();
+			state.childIdx = 0;
+			state.childResults = 0;
+			state.childHasReturned = 0;
 		}
 
 		NodeBase* MultiChildNode::getNextChild()
 		{
-			return children[childIdx].get();
+			return children[getCurrentChildIdx()].get();
 		}
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -357,9 +452,9 @@ namespace SA
 		{
 			size_t childIdx = getCurrentChildIdx();
 
-			if (childHasReturned[childIdx])
+			if (childHasReturned(childIdx))
 			{
-				if (childResults[childIdx])
+				if (childResult(childIdx))
 				{
 					//current child succeeded! select this one
 					return false;
@@ -393,7 +488,7 @@ namespace SA
 		NodeBase* Selector::getNextChild()
 		{
 			size_t childIdx = getCurrentChildIdx();
-			if (childHasReturned[childIdx] && !childResults[childIdx])
+			if (childHasReturned(childIdx) && !childResult(childIdx))
 			{
 				//current child has failed, try the next one.
 				tryIncrementChild();
@@ -405,7 +500,7 @@ namespace SA
 		bool Selector::result() const
 		{
 			//state machine should never call this when the results are not ready.
-			return childResults[getCurrentChildIdx()];
+			return childResult(getCurrentChildIdx());
 		}
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -415,9 +510,9 @@ namespace SA
 		{
 			size_t childIdx = getCurrentChildIdx();
 
-			if (childHasReturned[childIdx])
+			if (childHasReturned(childIdx))
 			{
-				if (!childResults[childIdx])
+				if (!childResult(childIdx))
 				{
 					//this child failed, the whole sequence has failed.
 					return false;
@@ -450,7 +545,7 @@ namespace SA
 		SA::BehaviorTree::NodeBase* Sequence::getNextChild()
 		{
 			size_t childIdx = getCurrentChildIdx();
-			if (childHasReturned[childIdx] && childResults[childIdx])
+			if (childHasReturned(childIdx) && childResult(childIdx))
 			{
 				//current child has succeeded, try the next one.
 				//note: if the current child failed, then the state machine won't be calling this method.
@@ -464,7 +559,7 @@ namespace SA
 		{
 			//state machine should never call this when the results are not ready.
 			//state machine may call this on non-last child, if the sequence failed before the end
-			return childResults[getCurrentChildIdx()];
+			return childResult(getCurrentChildIdx());
 		}
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -614,13 +709,13 @@ namespace SA
 			}
 			else
 			{
-				return currentLoop >= numLoops;
+				return getNodeState().currentLoop >= numLoops;
 			}
 		}
 
 		void Loop::notifyCurrentChildResult(bool childResult)
 		{
-			currentLoop += 1;
+			getNodeState().currentLoop += 1;
 			SingleChildNode::notifyCurrentChildResult(childResult);
 		}
 
@@ -646,16 +741,17 @@ namespace SA
 			uint64_t thisFrame = game.getFrameNumber();
 
 			//signal this node is processing if it already looped this frame
-			bool bAlreadyTickedThisFrame = lastFrameTicked == thisFrame;
+			NodeState& state = getNodeState();
+			bool bAlreadyTickedThisFrame = state.lastFrameTicked == thisFrame;
 
-			lastFrameTicked = thisFrame;
+			state.lastFrameTicked = thisFrame;
 
 			return bAlreadyTickedThisFrame;
 		}
 
 		void Loop::resetNode()
 		{
-			currentLoop = 0;
+			getNodeState().currentLoop = 0;
 			SingleChildNode::resetNode();
 		}
 
@@ -668,8 +764,6 @@ namespace SA
 			const std::vector<sp<NodeBase>>& inChildren) 
 			: MultiChildNode(name, inChildren)
 		{
-			rng = GameBase::get().getRNGSystem().getTimeInfluencedRNG();
-
 			std::map<std::string, NodeBase*> nameToNodeMap;
 
 			for (size_t childIdx = 0; childIdx < children.size(); ++childIdx)
@@ -721,37 +815,58 @@ namespace SA
 
 		bool Random::hasPendingChildren() const
 		{
-			return !randomChoice.has_value();
+			return !getNodeState().bChoseChild;
 		}
 
 		void Random::resetNode()
 		{
-			randomChoice.reset();
-			childResult.reset();
+			NodeState& state = getNodeState();
+			state.bChoseChild = false;
+			state.bChildReturned = false;
+			state.bChildResult = false;
 		}
 
 		SA::BehaviorTree::NodeBase* Random::getNextChild()
 		{
 			//this should only ever be called if there is no current random choice (see hasPendingChildren)
-			randomChoice = rng->getInt<size_t>(0, chanceBucket.size()-1);
-			return chanceBucket[*randomChoice];
+			NodeState& state = getNodeState();
+			state.childIdx = uint32_t(getTree().getRNG().getInt<size_t>(0, chanceBucket.size()-1));
+			state.bChoseChild = true;
+			return chanceBucket[state.childIdx];
 		}
 
 		void Random::notifyCurrentChildResult(bool inChildResult)
 		{
-			childResult = inChildResult;
+			NodeState& state = getNodeState();
+			state.bChildResult = inChildResult;
+			state.bChildReturned = true;
 		}
 
 		bool Random::resultReady() const
 		{
 			//alternatively the random node could keep choosing until it finds a successful child
 			//but I am leaning towards the simple design. It is basically "choose one child, run that child, return its result"
-			return childResult.has_value();
+			return getNodeState().bChildReturned;
 		}
 
 		bool Random::result() const
 		{
-			return *childResult;
+			return getNodeState().bChildResult;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Memory keys
+		/////////////////////////////////////////////////////////////////////////////////////
+		MemoryKey::MemoryKey(const std::string& inName)
+		{
+			//function static so keys defined at namespace scope can intern during static init
+			static std::mutex internMutex;
+			static std::unordered_map<std::string, uint32_t> internedIds; //node based, so name pointers stay valid as it grows
+
+			std::lock_guard<std::mutex> lock(internMutex);
+			auto insertResult = internedIds.insert({ inName, uint32_t(internedIds.size()) });
+			id = insertResult.first->second;
+			name = &insertResult.first->first;
 		}
 
 	}
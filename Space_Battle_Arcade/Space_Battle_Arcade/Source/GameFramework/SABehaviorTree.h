@@ -7,6 +7,8 @@
 #include <vector>
 #include <optional>
 #include <unordered_map>
+#include <functional>
+#include <tuple>
 #include <assert.h>
 #include "Tools/DataStructures/MultiDelegate.h"
 
@@ -20,7 +22,29 @@ namespace SA
 	namespace BehaviorTree
 	{
 		class Tree;
+		class TreeDefinition;
 		class Memory;
+		class NodeBase;
+
+		template<typename T, typename... Args>
+		sp<NodeBase> perAgentNode(Args&&... args);
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Execution state of a single node. Each tree keeps one of these per node in a 
+		// contiguous block indexed by node priority; this is what lets trees share nodes.
+		/////////////////////////////////////////////////////////////////////////////////////
+		struct NodeState
+		{
+			uint64_t childResults = 0;		//multi child nodes; a bit per child
+			uint64_t childHasReturned = 0;	//multi child nodes; a bit per child
+			uint64_t lastFrameTicked = 0;	//loop
+			uint32_t childIdx = 0;			//multi child nodes; current child, or random's chosen child
+			uint32_t currentLoop = 0;		//loop
+			bool bOnExecutionStack = false;
+			bool bChildReturned = false;	//single child nodes and random
+			bool bChildResult = false;		//single child nodes and random
+			bool bChoseChild = false;		//random
+		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
 		// Base class for behavior tree nodes
@@ -28,10 +52,17 @@ namespace SA
 		class NodeBase : public GameEntity
 		{
 			friend BehaviorTree::Tree;
+			friend BehaviorTree::TreeDefinition;
+			template<typename T, typename... Args>
+			friend sp<NodeBase> perAgentNode(Args&&... args);
 
 		public:
 			NodeBase(const std::string& name) : nodeName(name) {}
 
+			/** Shared nodes keep all of their execution state in the tree's NodeState block, so a single instance can be used 
+				by every tree built from a TreeDefinition. Nodes with their own members (timers, subscriptions, cached targets) must not be shared. */
+			virtual bool isSharedAcrossTrees() const { return false; }
+
 		private: //tree state machine methods. End users should not be calling these methods directly.
 			friend Tree;
 			virtual bool hasPendingChildren() const = 0;
@@ -42,7 +73,7 @@ namespace SA
 		protected: //tree state machine methods where subclasses are required to call parent
 			virtual void notifyCurrentChildResult(bool childResult) = 0;
 			virtual NodeBase* getNextChild() { return nullptr; }
-			virtual void resetNode() { bOnExecutionStack = false; }
+			virtual void resetNode() { getNodeState().bOnExecutionStack = false; }
 
 			/* Notifies users that abort happened; cancel any pending timers in your override. */
 			virtual void handleNodeAborted() = 0;
@@ -53,19 +84,13 @@ namespace SA
 
 		protected: //subclass helpers
 			/* Gives child nodes access to memory, if accessing a behavior  */
-			inline Memory& getMemory() const
-			{
-				assert(assignedMemory);
-				return *assignedMemory;
-			}
+			inline Memory& getMemory() const;
 
-			inline Tree& getTree() const
-			{
-				assert(owningTree);
-				return *owningTree;
-			}
+			/* Shared nodes have no owning tree; they see whichever tree is executing them */
+			inline Tree& getTree() const;
+			inline NodeState& getNodeState() const;
 			inline uint32_t getPriority() const { return priority; }
-			inline bool isOnExecutionStack() const { return bOnExecutionStack; }
+			inline bool isOnExecutionStack() const { return getNodeState().bOnExecutionStack; }
 
 		protected:
 			/** The first descendant children of this node */
@@ -75,11 +100,15 @@ namespace SA
 			/** a user and debugging friendly name */
 			std::string nodeName;
 
-			/** Assigned by the owning tree*/
+			/** Assigned by the owning tree or definition; pre-order index of the node, so it also indexes the tree's node state block */
 			uint32_t priority = 0;
+
+			/** Assigned by the owning tree; null for nodes shared by a definition's trees */
 			Tree* owningTree = nullptr;
 			Memory* assignedMemory = nullptr;
-			bool bOnExecutionStack = false;
+
+			/** Set by perAgentNode; trees built from a definition construct their own copy of the node with this */
+			std::function<sp<NodeBase>()> makeAgentCopy;
 		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -90,23 +119,20 @@ namespace SA
 		public:
 			SingleChildNode(const std::string& name, const sp<NodeBase>& child) : NodeBase(name) { children.push_back(child); }
 		private:
-			virtual bool resultReady() const override { return bChildReturned; };
-			virtual bool result() const override { return bChildExecutionResult; }
+			virtual bool resultReady() const override { return getNodeState().bChildReturned; };
+			virtual bool result() const override { return getNodeState().bChildResult; }
 
 		protected:
 			virtual void notifyCurrentChildResult(bool childResult) override;
 			virtual NodeBase* getNextChild() override { return children.size() > 0 ? children[0].get() : nullptr; }
-			virtual bool hasPendingChildren() const override { return !bChildReturned; }
+			virtual bool hasPendingChildren() const override { return !getNodeState().bChildReturned; }
 			virtual void resetNode() override
 			{
-				bChildReturned = false;
-				bChildExecutionResult = false;
+				NodeState& state = getNodeState();
+				state.bChildReturned = false;
+				state.bChildResult = false;
 				NodeBase::resetNode();
 			}
-
-		protected:
-			bool bChildReturned = false;
-			bool bChildExecutionResult = false;
 		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -211,17 +237,18 @@ namespace SA
 			virtual void notifyCurrentChildResult(bool childResult) override;
 			virtual NodeBase* getNextChild() override;
 		protected:
-			inline size_t getCurrentChildIdx() const { return childIdx; } //shouldn't really be known about outside of subclasses
+			inline size_t getCurrentChildIdx() const { return getNodeState().childIdx; } //shouldn't really be known about outside of subclasses
 			/** return true if there exists a new child and successfully incremented to that child*/
 			bool tryIncrementChild();
+			inline bool childHasReturned(size_t childIdx) const { return (getNodeState().childHasReturned >> childIdx) & 1; }
+			inline bool childResult(size_t childIdx) const { return (getNodeState().childResults >> childIdx) & 1; }
+
+		public:
+			/** child results are bits in the node state */
+			static constexpr size_t MAX_CHILDREN = 64;
 
 		private:
 			void resetMultiNode();
-		private:
-			size_t childIdx = 0; //private ensures child classes cannot corrupt index and we don't have to do bounds checking
-		protected:
-			std::vector<bool> childResults;
-			std::vector<bool> childHasReturned;
 		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -233,6 +260,7 @@ namespace SA
 		{
 		public:
 			Selector(const std::string& name, const std::vector<sp<NodeBase>>& children) : MultiChildNode(name, children) {}
+			virtual bool isSharedAcrossTrees() const override { return true; }
 
 			virtual bool isProcessing() const override { return false; }; //selector's children may be processing, but the selector should always be immediately complete
 			virtual void evaluate() override { /* Selectors should not need to do any evaluation/processing */ }
@@ -252,6 +280,7 @@ namespace SA
 		{
 		public:
 			Sequence(const std::string& name, const std::vector<sp<NodeBase>>& children) : MultiChildNode(name, children) {}
+			virtual bool isSharedAcrossTrees() const override { return true; }
 			virtual bool isProcessing() const override { return false; }; //sequence's children may be processing, but the sequence should always be immediately complete
 			virtual void evaluate() override { /* Sequences should not need to do any evaluation/processing */ }
 			virtual bool hasPendingChildren() const override;
@@ -273,6 +302,7 @@ namespace SA
 				bInifinteLoop(inNumLoops == 0)
 			{
 			}
+			virtual bool isSharedAcrossTrees() const override { return true; }
 			virtual bool resultReady() const override;
 			virtual bool hasPendingChildren() const override { return !resultReady(); }
 
@@ -285,8 +315,6 @@ namespace SA
 		private:
 			const uint32_t numLoops = 1;
 			const bool bInifinteLoop = false;
-			uint32_t currentLoop = 0;
-			mutable uint64_t lastFrameTicked = 0;
 		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -308,6 +336,7 @@ namespace SA
 
 		public:
 			Random(const std::string& name, const std::vector<ChildChance> childChances, const std::vector<sp<NodeBase>>& children);
+			virtual bool isSharedAcrossTrees() const override { return true; }
 
 			virtual bool isProcessing() const override { return false; }; //children may be processing, but the RandomNode should always be immediately complete
 			virtual void evaluate() override { /* Nothing to do here, get next child does random selection*/}
@@ -322,9 +351,6 @@ namespace SA
 			/** A bucket of children ptr copies; a simplisitic approach to mapping probability to child
 				example: A(1/6), B(2/6) c(3/6) will look like {A,B,B,C,C,C} */
 			std::vector<NodeBase*> chanceBucket;
-			std::optional<size_t> randomChoice;
-			std::optional<bool> childResult;
-			sp<RNG> rng = nullptr;
 		};
 		using Chances = std::vector<Random::ChildChance>;
 
@@ -335,6 +361,38 @@ namespace SA
 		template<typename T> struct PrimitiveWrapper;
 		template<typename T> class ScopedUpdateNotifier;
 
+		////////////////////////////////////////////////////////
+		// Interned memory key. Interning a name hashes the string once; after that the key is a dense
+		// index into every tree's memory slots. Nodes should hold these rather than strings so per tick
+		// memory access does not hash. Implicitly constructible from strings so string keys still work.
+		////////////////////////////////////////////////////////
+		class MemoryKey
+		{
+		public:
+			MemoryKey(const std::string& name);
+			MemoryKey(const char* name) : MemoryKey(std::string(name)) {}
+
+			inline uint32_t getId() const { return id; }
+			inline const std::string& getName() const { return *name; }
+
+			inline bool operator==(const MemoryKey& other) const { return id == other.id; }
+			inline bool operator!=(const MemoryKey& other) const { return id != other.id; }
+			friend bool operator==(const std::string& lhs, const MemoryKey& rhs) { return lhs == rhs.getName(); }
+			friend bool operator==(const MemoryKey& lhs, const std::string& rhs) { return lhs.getName() == rhs; }
+
+		private:
+			uint32_t id = 0;
+			const std::string* name = nullptr; //owned by the intern table, which never removes names
+		};
+
+		/** A unique address per type, used to remember the last cast made on a memory entry */
+		template<typename T>
+		inline const void* memoryTypeTag()
+		{
+			static const char tag = 0;
+			return &tag;
+		}
+
 		////////////////////////////////////////////////////////
 		// Grants ability to dynamic cast memory of primitive type
 		////////////////////////////////////////////////////////
@@ -345,6 +403,11 @@ namespace SA
 			T value;
 		};
 
+		template<typename T>
+		struct IsPrimitiveWrapper : std::false_type {};
+		template<typename T>
+		struct IsPrimitiveWrapper<PrimitiveWrapper<T>> : std::true_type { using Wrapped = T; };
+
 		////////////////////////////////////////////////////////
 		// The entry used for holding memory. This allows memory
 		// values to have auxiliary data such as update delegates 
@@ -358,6 +421,10 @@ namespace SA
 			sp<GameEntity> value;
 			Modified_MemoryDelegate onValueModified;
 			Replaced_MemoryDelegate onValueReplaced;
+
+			/** The value cast to the type it was stored as, so reads of that type skip RTTI. Only written by replaceValue; reads never touch it. */
+			const void* cachedCastType = nullptr;
+			void* cachedCastValue = nullptr;
 		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -423,6 +490,9 @@ namespace SA
 		//			-RAII structure is designed to not be cachable by client code as it uses raw pointers rather than smart pointers
 		//		-reading values should be const correct if there will be no writing
 		//		-optimize access of arbitrary types; profiling suggested that dynamic_cast is more performant than caching type_index in set
+		//			-each entry caches its value cast to the stored type when replaced, so only reads as some other type pay for a dynamic_cast
+		//			-reads do not write the cache, so const reads of one memory from several threads are safe
+		//		-keys are interned MemoryKeys that index a slot vector; string keys are interned on the way in
 		//		-class is designed to be const correct; const operations will not modify memory entries, but may modify what is within those entries.
 		//		-"replace value" means the object in memory gets replaced
 		//		-"modify value" means the object in memory has its properties changed, but it is still the same object.
@@ -431,12 +501,12 @@ namespace SA
 		/////////////////////////////////////////////////////////////////////////////////////
 		class Memory : public GameEntity
 		{
-			//hashmap of keys to values
-			std::unordered_map<std::string, sp<MemoryEntry>> memory;
+			//indexed by MemoryKey id; null slots are keys this memory has never seen
+			std::vector<sp<MemoryEntry>> memory;
 
 		public:
 			template<typename T>
-			const T* getReadValueAs(const std::string& key) const
+			const T* getReadValueAs(const MemoryKey& key) const
 			{
 				if (MemoryEntry* memEntry = _getMemoryEntry(key))
 				{
@@ -451,7 +521,7 @@ namespace SA
 			/* This does not return the scoped wrapper because that requires exposing move/copy ctor; which could accidently be
 				abused to cache this value and hence allow dangling pointers */
 			template<typename T>
-			bool getWriteValueAs(const std::string& key, ScopedUpdateNotifier<T>& outWriteAccess)
+			bool getWriteValueAs(const MemoryKey& key, ScopedUpdateNotifier<T>& outWriteAccess)
 			{
 				if (MemoryEntry* memEntry = _getMemoryEntry(key))
 				{
@@ -475,78 +545,85 @@ namespace SA
 					-it has become clear, through use, that reading/writing memory every frame is expensive. Perhaps there should be a smart interface where
 						one can cache memory values (since I'm doing that anyways in space arcade through the backdoor or requesting a reference). Such an interface should expose a way to broadcast
 						that the memory value was updated or replaced. Perhaps a direct handle to the memory entry?
+						-interned MemoryKeys and the per entry cast cache now remove the string hash and dynamic_cast from per frame access; what remains is the shared_ptr indirection.
 
 			*/
 			template<typename T>
-			sp<const T> getMemoryReference(const std::string& key)
+			sp<const T> getMemoryReference(const MemoryKey& key)
 			{
 				if (MemoryEntry* memEntry = _getMemoryEntry(key))
 				{
-					//profiling suggests just using dynamic cast is faster than caching rtti info in hash_set<std::type_index> and bypassing with static casts. 
-					return std::dynamic_pointer_cast<T>(memEntry->value);
+					if (T* castValue = _tryCast<T>(*memEntry))
+					{
+						return sp<const T>(memEntry->value, castValue); //aliasing ctor shares ownership with the stored value
+					}
 				}
 
 				return sp<const T>(nullptr);
 			}
 
 			/** Warning: modifying values in response to this delegate will lead to infinite recursion; if required use next tick */
-			Modified_MemoryDelegate& getModifiedDelegate(const std::string& key)
+			Modified_MemoryDelegate& getModifiedDelegate(const MemoryKey& key)
 			{
 				MemoryEntry& memEntry = _findOrMakeMemoryEntry(key);
 				return memEntry.onValueModified;
 			}
 
 			/** Warning: replacing values in response to this delegate will lead to infinite recursion; if required use next tick */
-			Replaced_MemoryDelegate& getReplacedDelegate(const std::string& key)
+			Replaced_MemoryDelegate& getReplacedDelegate(const MemoryKey& key)
 			{
 				MemoryEntry& memEntry = _findOrMakeMemoryEntry(key);
 				return memEntry.onValueReplaced;
 			}
 
 			template<typename T>
-			T* replaceValue(const std::string& key, const sp<T>& newValue)
+			T* replaceValue(const MemoryKey& key, const sp<T>& newValue)
 			{
 				static_assert(std::is_base_of<GameEntity, T>(), "Value must be of GameEntity. For primitive/integral values, use provided PrimitiveWrapper");
 
-				sp<MemoryEntry> memoryEntry = nullptr;
-				sp<GameEntity> oldValue = nullptr;
-
-				auto findResult = memory.find(key);
-				if (findResult != memory.end())
+				if (key.getId() >= memory.size())
 				{
-					memoryEntry = findResult->second;
-					oldValue = memoryEntry->value;
+					memory.resize(key.getId() + 1);
 				}
-				else
+				sp<MemoryEntry>& slot = memory[key.getId()];
+				if (!slot)
 				{
-					memoryEntry = new_sp<MemoryEntry>();
-					memoryEntry->key = key;
+					slot = new_sp<MemoryEntry>();
+					slot->key = key.getName();
 				}
+				sp<MemoryEntry> memoryEntry = slot; //hold a ref; listeners may erase the entry
+				sp<GameEntity> oldValue = memoryEntry->value;
 				memoryEntry->value = newValue;
-				memory.insert({ key, memoryEntry });
+				if constexpr (IsPrimitiveWrapper<T>::value)
+				{
+					//primitives are read as the wrapped type, not the wrapper
+					memoryEntry->cachedCastType = memoryTypeTag<typename IsPrimitiveWrapper<T>::Wrapped>();
+					memoryEntry->cachedCastValue = newValue ? &newValue->value : nullptr;
+				}
+				else
+				{
+					memoryEntry->cachedCastType = memoryTypeTag<T>();
+					memoryEntry->cachedCastValue = newValue.get();
+				}
 
 				//must take care that old value is not ref collected before this; storing old value as shared pointer will do the trick
-				memoryEntry->onValueReplaced.broadcast(key, oldValue.get(), newValue.get());
-				memoryEntry->onValueModified.broadcast(key, memoryEntry->value.get());
+				memoryEntry->onValueReplaced.broadcast(memoryEntry->key, oldValue.get(), newValue.get());
+				memoryEntry->onValueModified.broadcast(memoryEntry->key, memoryEntry->value.get());
 
 				return newValue.get();
 			}
 
-			bool hasValue(const std::string& key)
+			bool hasValue(const MemoryKey& key)
 			{
-				auto findResult = memory.find(key);
-				if (findResult != memory.end())
-				{
-					return findResult->second->value.get() != nullptr;
-				}
-				return false;
+				MemoryEntry* memEntry = _getMemoryEntry(key);
+				return memEntry && memEntry->value.get() != nullptr;
 			}
 
 			/**
 				Prefer this method for removing values; it will let listeners know that value has been replaced.
 				It will also not corrupt listeners to memory entries.
 			*/
-			bool removeValue(const std::string& key)
+			bool removeValue(const MemoryKey& key)
 			{
 				//we do not want to clear subscribers to memory value modified/replaced. So insert a null.
 				MemoryEntry* MemEntry = _getMemoryEntry(key);
@@ -562,59 +639,61 @@ namespace SA
 				The normal behavior tree workflow is to specify all the memory that will be used up front.
 				Then remove values as it sees fit, but leaving delegate listeners in tack so they can react
 			*/
-			bool eraseEntry(const std::string& key)
+			bool eraseEntry(const MemoryKey& key)
 			{
 				//this path should be avoided in 99% of cases
 				// /*onErasing.broadcast(key);*/	//I want to avoid making this a thing because then users will have to subscrib to it to be safe
 				//in reality removing they memory entry should be discouraged unless under very niche scenarios (task creates and them)
 				//in fact, this method should probably be removed. But then there is a way to create memory entries but no way to remove them, which seems strange.
 				removeValue(key);
-				return memory.erase(key) > 0;
+				const bool bHadEntry = key.getId() < memory.size() && memory[key.getId()];
+				if (bHadEntry)
+				{
+					memory[key.getId()] = nullptr;
+				}
+				return bHadEntry;
 			}
 
 		private:
-			inline MemoryEntry* _getMemoryEntry(const std::string key) const
+			inline MemoryEntry* _getMemoryEntry(const MemoryKey& key) const
 			{
-				auto findResult = memory.find(key);
-				if (findResult != memory.end())
-				{
-					return findResult->second.get();
-				}
-				return nullptr;
+				return key.getId() < memory.size() ? memory[key.getId()].get() : nullptr;
 			}
 
 			template<typename T>
-			inline T* _tryCast(MemoryEntry& memoryEntry) const
+			inline T* _tryCast(const MemoryEntry& memoryEntry) const
 			{
+				if (memoryEntry.cachedCastType == memoryTypeTag<std::remove_const_t<T>>())
+				{
+					return static_cast<T*>(memoryEntry.cachedCastValue);
+				}
+
+				T* castValue = nullptr;
 				if constexpr (std::is_base_of<GameEntity, T>())
 				{
-					//profiling suggests just using dynamic cast is faster than caching rtti info in hash_set<std::type_index> and bypassing with static casts. 
-					return dynamic_cast<T*>(memoryEntry.value.get());
+					castValue = dynamic_cast<T*>(memoryEntry.value.get());
 				}
 				else
 				{
 					if (PrimitiveWrapper<T>* wrappedObj = dynamic_cast<PrimitiveWrapper<T>*>(memoryEntry.value.get()))
 					{
-						return &(wrappedObj->value);
+						castValue = &(wrappedObj->value);
 					}
 				}
-				return nullptr;
+
+				return castValue;
 			}
 
-			MemoryEntry& _findOrMakeMemoryEntry(const std::string& key)
+			MemoryEntry& _findOrMakeMemoryEntry(const MemoryKey& key)
 			{
-				auto findResult = memory.find(key);
-				if (findResult != memory.end())
-				{
-					return *(findResult->second.get());
-				}
-				else
+				if (MemoryEntry* memEntry = _getMemoryEntry(key))
 				{
-					replaceValue<GameEntity>(key, sp <GameEntity>{ nullptr });
-					auto findNewValue = memory.find(key);
-					assert(findNewValue != memory.end());
-					return *(findNewValue->second.get());
+					return *memEntry;
 				}
+				replaceValue<GameEntity>(key, sp <GameEntity>{ nullptr });
+				MemoryEntry* newEntry = _getMemoryEntry(key);
+				assert(newEntry);
+				return *newEntry;
 			}
 		};
 
@@ -627,16 +706,58 @@ namespace SA
 			bool bChildResult;
 		};
 
+		/////////////////////////////////////////////////////////////////////////////////////
+		// A compiled, immutable tree structure that any number of trees can be built from.
+		//		-nodes that report isSharedAcrossTrees are used by every tree as is; their execution state lives in each tree's NodeState block
+		//		-nodes with their own state must be made with perAgentNode; each tree constructs its own copy of those
+		//		-build one per brain type and keep it around; building a tree from it is then a few allocations rather than one per node
+		//		-a node may only be part of a single definition, since the definition assigns its priority
+		/////////////////////////////////////////////////////////////////////////////////////
+		class TreeDefinition : public GameEntity
+		{
+		public:
+			TreeDefinition(const std::string& name, const sp<NodeBase>& root);
+			const std::string& getName() const { return name; }
+			uint32_t getNumNodes() const { return uint32_t(nodes.size()); }
+			uint32_t getNumPerAgentNodes() const { return numPerAgentNodes; }
+
+		private:
+			friend Tree;
+			void compileNode(const sp<NodeBase>& node);
+
+		private:
+			const std::string name;
+			const sp<NodeBase> root;
+			std::vector<NodeBase*> nodes; //pre-order, so index is node priority
+			uint32_t numPerAgentNodes = 0;
+		};
+
+		/** Makes a node that trees built from a TreeDefinition each get their own copy of; the arguments are kept to construct those copies. */
+		template<typename T, typename... Args>
+		sp<NodeBase> perAgentNode(Args&&... args)
+		{
+			sp<NodeBase> node = new_sp<T>(args...);
+			node->makeAgentCopy = [ctorArgs = std::make_tuple(args...)]()
+			{
+				return std::apply([](const auto&... copiedArgs) { return sp<NodeBase>(new_sp<T>(copiedArgs...)); }, ctorArgs);
+			};
+			return node;
+		}
+
 		/////////////////////////////////////////////////////////////////////////////////////
 		// The behavior tree composed of nodes.
 		/////////////////////////////////////////////////////////////////////////////////////
 		static constexpr bool LOG_TREE_STATE = false;	//if true, this will hit performance hard, but gives a stream of state changes.
 		extern Tree* volatile targetDebugTree;			//use a debugger to set this tree and logging will only print for this instance. hint1: set by name "SA::BehaviorTree::targetDebugTree ptr_address_value". hint2 set conditional breakpoints in nodes using "owningTree == SA::BehaviorTree::targetDebugTree"
+		extern thread_local Tree* executingTree;		//the tree currently walking its nodes; how shared nodes find their state
 		/////////////////////////////////////////////////////////////////////////////////////
 		class Tree : public NodeBase
 		{
 		public:
+			/** Builds a tree that owns its nodes */
 			Tree(const std::string& name, const sp<NodeBase>& root, std::vector<std::pair<std::string, sp<GameEntity>>> initializedMemory = {});
+			/** Builds a tree from a shared definition; only the definition's per agent nodes are constructed */
+			Tree(const sp<const TreeDefinition>& definition, std::vector<std::pair<std::string, sp<GameEntity>>> initializedMemory = {});
 			void start();
 			void tick(float delta_sec);
 			void stop();
@@ -648,12 +769,20 @@ namespace SA
 			Memory& getMemory() const;	//marked as const and memory should be considered mutable
 			float getFrameDeltaTimeSecs() const { return frame_dt_sec; }
 
+			/** Generator for the random choices of this tree's nodes; nodes are shared between trees, so they must not own one.
+				Trees draw from a time influenced generator unless given one with setRNG. */
+			RNG& getRNG();
+			void setRNG(const sp<RNG>& inRNG) { rng = inRNG; }
+
 		public: //debug utils
 			void makeTreeDebugTarget() { targetDebugTree = this; }
 			void makeTreeDebugTarget() const { targetDebugTree = const_cast<Tree*>(this); } //this is a debug utility, so I am okay with casting away const.
 
 		private:
+			friend NodeBase;
+			void initializeMemory(const std::vector<std::pair<std::string, sp<GameEntity>>>& initializedMemory);
 			void possessNodes(const sp<NodeBase>& node, uint32_t& currentPriority);
+			void possessNode(NodeBase& node, uint32_t nodePriority);
 			void processAborts(NodeBase*& inOut_CurrentNode, ExecutionState& inOut_currentState);
 			void treeLog(ExecutionState state, NodeBase* currentNode, uint32_t nodesVisited);
 			void treeLogAbortInstigator();
@@ -661,19 +790,27 @@ namespace SA
 		private: //node interface
 			virtual bool hasPendingChildren() const override { return true; }
 			virtual bool resultReady() const override { return false; }
-			virtual NodeBase* getNextChild() override { return root.get(); }
+			virtual NodeBase* getNextChild() override { return nodes.size() > 0 ? nodes[0] : nullptr; }
 			virtual void handleNodeAborted() override {}
+			virtual void resetNode() override {} //the tree shares priority 0 with its root, so it must not touch the root's state
 		private: //providing defaults for require node virtuals
 			virtual bool isProcessing() const override { return false; };
 			virtual bool result() const override { return true; }
 			virtual void evaluate() override {}
 			virtual void notifyCurrentChildResult(bool childResult) override {};
 		private:
-			/** The root node; tree structure does not change once defined */
+			/** The root node; tree structure does not change once defined. Null if built from a definition */
 			const sp<NodeBase> root;
+			const sp<const TreeDefinition> definition;
+			/** This tree's node for each priority; either owned by root, shared from the definition, or one of agentNodes */
+			std::vector<NodeBase*> nodes;
+			std::vector<sp<NodeBase>> agentNodes;
+			/** Execution state of every node, indexed by priority */
+			std::vector<NodeState> nodeStates;
 			/** Represents the path of current nodes being executed. Life time of nodes is controlled by the root node */
 			std::vector<NodeBase*> executionStack;
 			sp<Memory> memory = nullptr;
+			sp<RNG> rng = nullptr; //created on first use, most trees never make a random choice
 
 			/* Raw pointer is safe since tree owns lifetime of nodes */
 			NodeBase* abortInstigator = nullptr;
@@ -686,5 +823,24 @@ namespace SA
 			float frame_dt_sec = 1.f;
 		};
 
+		inline Tree& NodeBase::getTree() const
+		{
+			Tree* tree = owningTree ? owningTree : executingTree;
+			assert(tree);
+			return *tree;
+		}
+
+		inline Memory& NodeBase::getMemory() const
+		{
+			return assignedMemory ? *assignedMemory : getTree().getMemory();
+		}
+
+		inline NodeState& NodeBase::getNodeState() const
+		{
+			Tree& tree = getTree();
+			assert(priority < tree.nodeStates.size());
+			return tree.nodeStates[priority];
+		}
+
 	}
 }
\ No newline at end of file
@@ -60,11 +60,18 @@ namespace SA
 		sp<SAT::Shape> modelCollision = nullptr;
 		try
 		{
+			//a cooked hull skips loading the model entirely; the render model is never needed for collision
+			if (sp<TriangleProcessor> cookedHull = loadCookedCollisionTriangles(fullFilePath))
+			{
+				return new_sp<SAT::DynamicTriangleMeshShape>(*cookedHull);
+			}
+
 			AssetSystem& assetSystem = GameBase::get().getAssetSystem();
 			newModel = assetSystem.loadModel(fullFilePath);
 			if (newModel)
 			{
 				TriangleProcessor processedModel = modelToCollisionTriangles(*newModel); //#TODO_minor this function perhaps should exist in this file
+				cookCollisionTriangles(fullFilePath, *newModel, processedModel);
 				modelCollision = new_sp<SAT::DynamicTriangleMeshShape>(processedModel);
 				return modelCollision; //early out so failure log isn't printed at end of this function.
 			}
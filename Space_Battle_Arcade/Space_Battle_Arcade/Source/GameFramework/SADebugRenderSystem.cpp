@@ -16,13 +16,17 @@ namespace SA
 {
 	void DebugRenderSystem::initSystem()
 	{
-		lineRenderer = new_sp<DebugLineRender>();
-		cubeRenderer = new_sp<DebugCubeRender>();
-		sphereRenderer = new_sp<DebugSphereRender>();
-
 		GameBase& gameBase = GameBase::get();
-		gameBase.onRenderDispatch.addWeakObj(sp_this(), &DebugRenderSystem::handleRenderDispatch);
 		gameBase.onFrameOver.addWeakObj(sp_this(), &DebugRenderSystem::handleFrameOver);
+
+		//renderers own GL buffers; headless runs never dispatch rendering so they are not needed
+		if (!GameBase::isHeadless())
+		{
+			lineRenderer = new_sp<DebugLineRender>();
+			cubeRenderer = new_sp<DebugCubeRender>();
+			sphereRenderer = new_sp<DebugSphereRender>();
+			gameBase.onRenderDispatch.addWeakObj(sp_this(), &DebugRenderSystem::handleRenderDispatch);
+		}
 	}
 
 	void DebugRenderSystem::handleRenderDispatch(float dt_sec_system)
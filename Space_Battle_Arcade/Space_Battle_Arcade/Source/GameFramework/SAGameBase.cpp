@@ -12,9 +12,12 @@
 
 #include "Rendering/SAWindow.h"
 #include "GameFramework/SALog.h"
+#include "GameFramework/SALogBackend.h"
 #include "SARandomNumberGenerationSystem.h"
 #include "SADebugRenderSystem.h"
 #include "GameFramework/SARenderSystem.h"
+#include "GameFramework/SALevel.h"
+#include "Rendering/RenderData.h"
 #include "GameFramework/CheatSystemBase.h"
 #include "CurveSystem.h"
 #include "TimeManagement/TickGroupManager.h"
@@ -29,6 +32,9 @@ namespace SA
 	//globally available check for systems that may require engine services but will not in the event the engine has been destroyed.
 	static bool bIsEngineShutdown = false;
 
+	//globally available so that systems owning window, GPU, or audio device resources can stub themselves out.
+	static bool bIsHeadless = false;
+
 	GameBase::GameBase()
 	{
 		bIsEngineShutdown = false;
@@ -68,11 +74,7 @@ namespace SA
 		//DEV-NOTE: this method should be kept simple, as it provides a high level overview of the engine.
 		if (!bStarted)
 		{
-			onInitEngineConstants(configuredConstants);	//this should happen before the subclass game has started. this means systems can read it.
-			registerTickGroups();						//tick groups created very early, these are effectively static and not intended to be initialized with dnyamic logic from systems. Thus these are created before systems.
-			createEngineSystems();
-			//systems are initialized after all systems have been created; this way cross-system interaction can be achieved during initailization (ie subscribing to events, etc.)
-			for (const sp<SystemBase>& system : systems) { system->initSystem(); }
+			initSystems(nullptr);
 
  			windowSystem->makeWindowPrimary(makeInitialWindow());
 			startUp();
@@ -88,15 +90,88 @@ namespace SA
 
 			//begin shutdown process
 			onShutDown();
+			shutdownSystems();
+		}
+	}
+
+	HeadlessResult GameBase::startHeadless(const HeadlessConfig& config)
+	{
+		HeadlessResult result;
+		if (bStarted)
+		{
+			log("GameFramework", LogLevel::LOG_ERROR, "Cannot start headless, game has already been started");
+			return result;
+		}
+
+		bIsHeadless = true;
+		timeSystem.setFixedDeltaTime(TimeSystem::PrivateKey{}, config.fixedDeltaSecs);
+
+		initSystems(&config);
+		startUp_Headless();
+		bStarted = true;
+
+		using Clock = std::chrono::steady_clock;
+		Clock::time_point simulationStart = Clock::now();
+
+		//no window, so no framerate sleep and no render dispatch; see tickGameloop_GameBase
+		onGameloopBeginning.broadcast();
+		while (!bExitGame && frameNumber < config.numFrames)
+		{
+			tickGameloop_GameBase();
+		}
+
+		result.wallSecs = std::chrono::duration<double>(Clock::now() - simulationStart).count();
+		result.simulatedFrames = frameNumber;
+		if (const sp<LevelBase>& currentLevel = levelSystem->getCurrentLevel())
+		{
+			result.worldStateHash = currentLevel->hashWorldState();
+		}
 
-			//shutdown systems after game client has been shutdown
-			for (const sp<SystemBase>& system : systems){system->shutdown();}
+		if (!bExitGame)
+		{
+			bExitGame = true;
+			onShutDown();
+		}
+		shutdownSystems();
 
-			//tick a few more times for any frame deferred processes
-			for (size_t shutdownTick = 0; shutdownTick < 3; ++shutdownTick){ tickGameloop_GameBase(); }
+		return result;
+	}
 
-			onShutdownGameloopTicksOver.broadcast();
+	void GameBase::initSystems(const HeadlessConfig* headlessConfig)
+	{
+		onInitEngineConstants(configuredConstants);	//this should happen before the subclass game has started. this means systems can read it.
+		if (configuredConstants.ASYNC_LOGGING)
+		{
+			AsyncLogBackend::Config logConfig;
+			logConfig.binaryLogPath = configuredConstants.BINARY_LOG_PATH;
+			if (!logging::startAsyncBackend(logConfig))
+			{
+				log(__FUNCTION__, LogLevel::LOG_WARNING, "async log backend was already running; keeping it");
+			}
+		}
+		registerTickGroups();						//tick groups created very early, these are effectively static and not intended to be initialized with dnyamic logic from systems. Thus these are created before systems.
+		createEngineSystems();
+		if (headlessConfig)
+		{
+			//reseed before systems init so that generators they cache come from the configured seed
+			systemRNG->reseed(headlessConfig->rngSeed);
 		}
+		//systems are initialized after all systems have been created; this way cross-system interaction can be achieved during initailization (ie subscribing to events, etc.)
+		for (const sp<SystemBase>& system : systems) { system->initSystem(); }
+	}
+
+	void GameBase::shutdownSystems()
+	{
+		//shutdown systems after game client has been shutdown
+		for (const sp<SystemBase>& system : systems){system->shutdown();}
+
+		//tick a few more times for any frame deferred processes
+		for (size_t shutdownTick = 0; shutdownTick < 3; ++shutdownTick){ tickGameloop_GameBase(); }
+
+		onShutdownGameloopTicksOver.broadcast();
+
+		//anything logged from here on goes straight to the console
+		logging::stopAsyncBackend();
 	}
 
 	bool GameBase::isEngineShutdown()
@@ -104,6 +179,11 @@ namespace SA
 		return bIsEngineShutdown;
 	}
 
+	bool GameBase::isHeadless()
+	{
+		return bIsHeadless;
+	}
+
 	void GameBase::startShutdown()
 	{
 		log("GameFramework", LogLevel::LOG, "Shutdown Initiated");
@@ -117,33 +197,66 @@ namespace SA
 		timeSystem.updateTime(TimeSystem::PrivateKey{});
 		float deltaTimeSecs = systemTimeManager->getDeltaTimeSecs();
 
+		jobSystem.resetFrameScratch();
+
 		GameEntity::cleanupPendingDestroy(GameEntity::CleanKey{});
 
 		//the engine will tick a few times after shutdown to clean up deferred tasks.
 		if (!bExitGame)
 		{
 			//#consider having system pass a reference to the system time manager, rather than a float; That way critical systems can ignore manipulation time effects or choose to use time affects. Passing raw time means systems will be forced to use time effects (such as dilation)
-			for (const sp<SystemBase>& system : systems) { system->tick(deltaTimeSecs);	}
+			//systems that declare their tick thread safe run as jobs alongside the systems that tick on the game thread
+			JobCounter concurrentSystemTicks;
+			for (const sp<SystemBase>& system : systems)
+			{
+				if (system->canTickConcurrently())
+				{
+					SystemBase* rawSystem = system.get();
+					jobSystem.run([rawSystem, deltaTimeSecs]() { rawSystem->tick(deltaTimeSecs); }, &concurrentSystemTicks);
+				}
+			}
+			for (const sp<SystemBase>& system : systems) 
+			{ 
+				if (!system->canTickConcurrently()) { system->tick(deltaTimeSecs); }
+			}
+			jobSystem.waitFor(concurrentSystemTicks);
 
 			//NOTE: there probably needs to be a priority based pre/post loop; but not needed yet so it is not implemented (priorities should probably be defined in a single file via template specliazations)
 			onPreGameloopTick.broadcast(deltaTimeSecs);
 			tickGameLoop(deltaTimeSecs);
 			onPostGameloopTick.broadcast(deltaTimeSecs);
 
-			cacheRenderDataForCurrentFrame(*renderSystem->getFrameRenderData_Write(frameNumber, identityKey));
-			renderLoop_begin(deltaTimeSecs);
-			onRenderDispatch.broadcast(deltaTimeSecs); //perhaps this needs to be a sorted structure with prioritizes; but that may get hard to maintain. Needs to be a systematic way for UI to come after other rendering.
-			renderLoop_end(deltaTimeSecs);
-			onRenderDispatchEnded.broadcast(deltaTimeSecs); 
-
-			//perhaps this should be a subscription service since few systems care about post render //TODO this sytem should probably be removed and instead just subscribe to delegate
-			for (const sp<SystemBase>& system : postRenderNotifys) { system->handlePostRender();}
+			//headless runs have no window or render backend, the simulation is all that ticks
+			if (!bIsHeadless)
+			{
+				//render reads from snapshots so it never sees the simulation mid-update; with a render delay it draws an older snapshot
+				RenderData& frameRenderData = *renderSystem->getFrameRenderData_Write(frameNumber, identityKey);
+				cacheRenderDataForCurrentFrame(frameRenderData);
+				cacheEngineRenderData(frameRenderData);
+				renderLoop_begin(deltaTimeSecs);
+				onRenderDispatch.broadcast(deltaTimeSecs); //perhaps this needs to be a sorted structure with prioritizes; but that may get hard to maintain. Needs to be a systematic way for UI to come after other rendering.
+				renderLoop_end(deltaTimeSecs);
+				onRenderDispatchEnded.broadcast(deltaTimeSecs); 
+
+				//perhaps this should be a subscription service since few systems care about post render //TODO this sytem should probably be removed and instead just subscribe to delegate
+				for (const sp<SystemBase>& system : postRenderNotifys) { system->handlePostRender();}
+			}
 		}
 
 		//broadcast current frame and increment the frame number.
 		onFrameOver.broadcast(frameNumber++);
 	}
 
+	void GameBase::cacheEngineRenderData(RenderData& frameRenderData)
+	{
+		if (const sp<LevelBase>& currentLevel = levelSystem->getCurrentLevel())
+		{
+			currentLevel->cacheRenderData(frameRenderData);
+		}
+		particleSystem->cacheRenderData(frameRenderData);
+		renderSystem->cachePointLights(frameRenderData);
+	}
+
 	void GameBase::createEngineSystems()
 	{
 		// !!! REFACTOR WARNING !!  do not place this within the ctor; polymorphic systems are designed to be instantiated via virtual functions; virutal functions shouldn't be called within a ctor!
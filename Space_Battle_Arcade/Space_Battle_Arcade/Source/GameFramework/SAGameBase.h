@@ -1,10 +1,12 @@
 #pragma once
 #include <set>
+#include <string>
 
 #include "GameFramework/SAGameEntity.h"
 #include "Tools/RemoveSpecialMemberFunctionUtils.h"
 #include "Tools/DataStructures/MultiDelegate.h"
 #include "GameFramework/SATimeManagementSystem.h"
+#include "GameFramework/SAJobSystem.h"
 
 namespace SA
 {
@@ -32,8 +34,25 @@ namespace SA
 	//////////////////////////////////////////////////////////////////////////////////////
 	struct EngineConstants
 	{
-		int8_t RENDER_DELAY_FRAMES = 0;
+		int8_t RENDER_DELAY_FRAMES = 1; //frames render lags the simulation by, 0 to 2; render draws the snapshot while the next frame simulates
 		uint32_t MAX_DIR_LIGHTS = 4;
+		uint32_t MAX_POINT_LIGHTS = 512; //point lights drawn per frame; the least important are dropped past this
+		uint32_t PROJECTILE_RESERVE = 24000; //projectile slots allocated up front; large battles keep 20k+ in flight, the store still grows past this
+		bool ASYNC_LOGGING = true; //log calls only queue records, a background thread writes them
+		std::string BINARY_LOG_PATH = ""; //when set, records are also written here in the binary log format; read it back with -decodelog
+	};
+	//////////////////////////////////////////////////////////////////////////////////////
+	struct HeadlessConfig
+	{
+		uint64_t numFrames = 600;
+		float fixedDeltaSecs = 1.f / 60.f;
+		uint32_t rngSeed = 1;
+	};
+	struct HeadlessResult
+	{
+		uint64_t simulatedFrames = 0;
+		uint64_t worldStateHash = 0;	//hash of the current level's world entity transforms after the last frame
+		double wallSecs = 0.0;			//time spent simulating, excludes start up and shutdown
 	};
 	//////////////////////////////////////////////////////////////////////////////////////
 	struct GamebaseIdentityKey : public RemoveCopies, public RemoveMoves
@@ -79,13 +98,23 @@ namespace SA
 		static bool isEngineShutdown();
 		bool isExiting() { return bExitGame; };
 		MultiDelegate<> onShutdownInitiated;
+
+		/** Runs the simulation for a fixed number of frames without a window, render or audio device. Time advances
+			by a fixed step and the RNG system is seeded from the config, so identical seeds produce identical world state. */
+		HeadlessResult startHeadless(const HeadlessConfig& config);
+		static bool isHeadless();
 	protected:
 		/** Child game classes should set up pre-gameloop state here.
 			#return value Provide an initial primary window on startup.	*/
 		virtual sp<Window> makeInitialWindow() = 0;
 		virtual void startUp() = 0;
 		virtual void onShutDown() = 0;
+		/** Headless counterpart of startUp; there is no window or GPU. Should load the level to simulate. */
+		virtual void startUp_Headless() {};
 	private: //starting systems
+		void initSystems(const HeadlessConfig* headlessConfig);
+		void shutdownSystems();
+	private:
 		bool bStarted = false;
 		bool bExitGame = false;
 
@@ -104,6 +133,8 @@ namespace SA
 
 	private: 
 		void tickGameloop_GameBase();
+		/** Snapshots engine owned render state (level entities, particles, point lights) after the game has cached its data */
+		void cacheEngineRenderData(struct RenderData& frameRenderData);
 	protected:
 		virtual void tickGameLoop(float deltaTimeSecs) = 0;
 		virtual void cacheRenderDataForCurrentFrame(struct RenderData& frameRenderData) = 0;
@@ -208,12 +239,15 @@ namespace SA
 		TimeManager& getSystemTimeManager(){ return *systemTimeManager; }
 		TickGroups& tickGroups() { return *tickGroupData; }
 		TickGroupManager& getTickGroupManager() { return *tickGroupManager; }
+		JobSystem& getJobSystem() { return jobSystem; }
 	private:
 		void registerTickGroups();
 		virtual sp<TickGroups> onRegisterTickGroups();
 	private: //time management 
 		/** Time management needs to be separate from systems since their tick relies on its results. */
 		TimeSystem timeSystem;
+		/** Jobs are scheduled by systems and tick groups, so like time the job system lives above them. Frame scratch is reset at the start of each frame. */
+		JobSystem jobSystem;
 		sp<TimeManager> systemTimeManager;
 		sp<TickGroups> tickGroupData = nullptr;
 		sp<TickGroupManager> tickGroupManager = nullptr;
@@ -0,0 +1,322 @@
+#include "GameFramework/SAJobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace SA
+{
+	namespace
+	{
+		//lets a thread find its own deque; threads that are not workers of a given system use queue 0
+		thread_local const JobSystem* tl_jobSystem = nullptr;
+		thread_local size_t tl_queueIdx = 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Frame scratch
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void* FrameScratchAllocator::allocate(size_t bytes, size_t alignment)
+	{
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+		for (;;)
+		{
+			if (currentBlock < blocks.size())
+			{
+				Block& block = blocks[currentBlock];
+				uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+				size_t alignedOffset = ((base + currentOffset + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+				if (alignedOffset + bytes <= block.size)
+				{
+					currentOffset = alignedOffset + bytes;
+					bytesUsedThisFrame += bytes;
+					return block.memory.get() + alignedOffset;
+				}
+
+				//does not fit; move on to the next block and leave the tail of this one unused
+				++currentBlock;
+				currentOffset = 0;
+			}
+			else
+			{
+				Block newBlock;
+				newBlock.size = std::max(blockSize, bytes + alignment);
+				newBlock.memory = std::make_unique<char[]>(newBlock.size);
+				blocks.push_back(std::move(newBlock));
+			}
+		}
+	}
+
+	void FrameScratchAllocator::reset()
+	{
+		if (blocks.size() > 1)
+		{
+			//last frame needed more than one block; a single block that size means the next frame will not need to chain
+			size_t totalSize = 0;
+			for (const Block& block : blocks)
+			{
+				totalSize += block.size;
+			}
+			blocks.clear();
+
+			Block mergedBlock;
+			mergedBlock.size = totalSize;
+			mergedBlock.memory = std::make_unique<char[]>(totalSize);
+			blocks.push_back(std::move(mergedBlock));
+		}
+		currentBlock = 0;
+		currentOffset = 0;
+		bytesUsedThisFrame = 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Job system
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	size_t JobSystem::defaultWorkerCount()
+	{
+		size_t hardwareThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		return hardwareThreads - 1;
+	}
+
+	JobSystem::JobSystem(size_t numWorkers)
+	{
+		for (size_t queueIdx = 0; queueIdx < numWorkers + 1; ++queueIdx)
+		{
+			queues.push_back(std::make_unique<WorkQueue>());
+			frameScratch.push_back(std::make_unique<FrameScratchAllocator>());
+		}
+
+		//all queues must exist before any worker can try to steal from them
+		for (size_t workerIdx = 0; workerIdx < numWorkers; ++workerIdx)
+		{
+			workers.emplace_back([this, workerIdx]() { workerLoop(workerIdx + 1); });
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			bShutdown = true;
+		}
+		wakeWorkers.notify_all();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	void JobSystem::run(std::function<void()> work, JobCounter* counter)
+	{
+		if (counter)
+		{
+			counter->pending.fetch_add(1, std::memory_order_relaxed);
+		}
+		schedule(Job{ std::move(work), counter });
+	}
+
+	void JobSystem::runAfter(JobCounter& dependency, std::function<void()> work, JobCounter* counter)
+	{
+		//count the job now, rather than when it is scheduled, so waiting on counter also waits on dependency
+		if (counter)
+		{
+			counter->pending.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(dependency.continuationMutex);
+			if (dependency.pending.load(std::memory_order_acquire) > 0)
+			{
+				dependency.continuations.push_back(Job{ std::move(work), counter });
+				return;
+			}
+		}
+		schedule(Job{ std::move(work), counter });
+	}
+
+	void JobSystem::waitFor(JobCounter& counter)
+	{
+		const size_t queueIdx = getQueueIdx();
+		while (!counter.isDone())
+		{
+			if (!tryRunJob(queueIdx))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		//the last job decrements inside this lock; taking it makes sure that job is done with the counter before the caller can destroy it
+		std::lock_guard<std::mutex> lock(counter.continuationMutex);
+	}
+
+	void JobSystem::parallelFor(size_t count, size_t batchSize, const std::function<void(size_t)>& body)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		batchSize = std::max<size_t>(batchSize, 1);
+		const size_t numBatches = (count + batchSize - 1) / batchSize;
+		if (workers.empty() || numBatches == 1)
+		{
+			for (size_t idx = 0; idx < count; ++idx)
+			{
+				body(idx);
+			}
+			return;
+		}
+
+		//jobs capture a pointer to this and their batch index, which fits std::function's small buffer so queueing does not allocate
+		struct ParallelForTask
+		{
+			const std::function<void(size_t)>* body;
+			size_t count;
+			size_t batchSize;
+
+			void runBatch(size_t batchIdx) const
+			{
+				const size_t end = std::min(count, (batchIdx + 1) * batchSize);
+				for (size_t idx = batchIdx * batchSize; idx < end; ++idx)
+				{
+					(*body)(idx);
+				}
+			}
+		};
+		const ParallelForTask task{ &body, count, batchSize };
+
+		JobCounter batchesDone;
+		for (size_t batchIdx = 1; batchIdx < numBatches; ++batchIdx)
+		{
+			run([&task, batchIdx]() { task.runBatch(batchIdx); }, &batchesDone);
+		}
+		task.runBatch(0);
+		waitFor(batchesDone);
+	}
+
+	FrameScratchAllocator& JobSystem::getFrameScratch()
+	{
+		return *frameScratch[getQueueIdx()];
+	}
+
+	void JobSystem::resetFrameScratch()
+	{
+		assert(queuedJobs.load() == 0);
+		for (const std::unique_ptr<FrameScratchAllocator>& scratch : frameScratch)
+		{
+			scratch->reset();
+		}
+	}
+
+	void JobSystem::schedule(Job&& job)
+	{
+		//count the job before it is visible, otherwise a worker can pop it and decrement first, underflowing the count
+		queuedJobs.fetch_add(1);
+		WorkQueue& queue = *queues[getQueueIdx()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(std::move(job));
+		}
+
+		if (workers.size() > 0)
+		{
+			//taking the sleep lock orders this with a worker checking queuedJobs before it sleeps, so the wake can't be missed
+			{ std::lock_guard<std::mutex> lock(sleepMutex); }
+			wakeWorkers.notify_one();
+		}
+	}
+
+	bool JobSystem::popJob(size_t queueIdx, Job& outJob)
+	{
+		//own queue is LIFO
+		{
+			WorkQueue& ownQueue = *queues[queueIdx];
+			std::lock_guard<std::mutex> lock(ownQueue.mutex);
+			if (!ownQueue.jobs.empty())
+			{
+				outJob = std::move(ownQueue.jobs.back());
+				ownQueue.jobs.pop_back();
+				queuedJobs.fetch_sub(1);
+				return true;
+			}
+		}
+
+		//steal the oldest job from someone else, starting with our neighbour so thieves spread out
+		for (size_t offset = 1; offset < queues.size(); ++offset)
+		{
+			WorkQueue& victim = *queues[(queueIdx + offset) % queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.jobs.empty())
+			{
+				outJob = std::move(victim.jobs.front());
+				victim.jobs.pop_front();
+				queuedJobs.fetch_sub(1);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool JobSystem::tryRunJob(size_t queueIdx)
+	{
+		Job job;
+		if (popJob(queueIdx, job))
+		{
+			job.work();
+			finishJob(job.counter);
+			return true;
+		}
+		return false;
+	}
+
+	void JobSystem::finishJob(JobCounter* counter)
+	{
+		if (!counter)
+		{
+			return;
+		}
+
+		std::vector<Job> readyJobs;
+		{
+			std::lock_guard<std::mutex> lock(counter->continuationMutex);
+			if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				readyJobs.swap(counter->continuations);
+			}
+		}
+
+		//counter may be destroyed from here on; only the local copies of its continuations are used
+		for (Job& job : readyJobs)
+		{
+			schedule(std::move(job));
+		}
+	}
+
+	size_t JobSystem::getQueueIdx() const
+	{
+		return tl_jobSystem == this ? tl_queueIdx : 0;
+	}
+
+	void JobSystem::workerLoop(size_t queueIdx)
+	{
+		tl_jobSystem = this;
+		tl_queueIdx = queueIdx;
+
+		for (;;)
+		{
+			if (tryRunJob(queueIdx))
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			wakeWorkers.wait(lock, [this]() { return bShutdown || queuedJobs.load() > 0; });
+			if (bShutdown && queuedJobs.load() == 0)
+			{
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	class JobSystem;
+	class JobCounter;
+
+	struct Job
+	{
+		std::function<void()> work;
+		JobCounter* counter = nullptr;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Counts unfinished jobs. Running a job with a counter increments it; the counter is decremented when the job finishes.
+	// Dependencies are expressed by scheduling jobs to start once a counter reaches zero (see JobSystem::runAfter).
+	//
+	// Always JobSystem::waitFor a counter before it goes out of scope; a worker may still be touching it just after
+	// the final job finishes.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class JobCounter final : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		JobCounter() = default;
+		bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend JobSystem;
+		std::atomic<uint32_t> pending{ 0 };
+		std::mutex continuationMutex;
+		std::vector<Job> continuations;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Linear allocator whose memory is only valid until the end of the frame. Each thread has its own, so allocation
+	// never takes a lock. Only trivially destructible types may be placed in it, nothing is destroyed on reset.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class FrameScratchAllocator final : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		FrameScratchAllocator(size_t inBlockSize = 64 * 1024) : blockSize(inBlockSize) {}
+		void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		T* allocateArray(size_t count)
+		{
+			static_assert(std::is_trivially_destructible<T>::value, "frame scratch memory is released without calling destructors");
+			return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		/** Invalidates everything allocated since the last reset. If last frame overflowed into extra blocks, they are merged into one block big enough for all of it. */
+		void reset();
+		size_t getBytesUsed() const { return bytesUsedThisFrame; }
+
+	private:
+		struct Block
+		{
+			std::unique_ptr<char[]> memory;
+			size_t size = 0;
+		};
+		std::vector<Block> blocks;
+		size_t blockSize;
+		size_t currentBlock = 0;
+		size_t currentOffset = 0;
+		size_t bytesUsedThisFrame = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Work stealing job system.
+	//
+	// Each worker owns a deque of jobs. Workers push and pop the back of their own deque (most recent work first, which
+	// is cache friendly for jobs that spawn jobs) and steal from the front of other deques when they run dry. Threads
+	// that are not workers (eg the game thread) share one more deque. A thread waiting on a counter runs jobs while it
+	// waits rather than blocking, so waiting from inside a job can not deadlock.
+	//
+	// With zero workers every job runs on the thread that waits for it, which keeps the system usable headless and
+	// deterministic in tests.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class JobSystem final : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		/** One less than the hardware thread count, leaving a core for the game thread */
+		static size_t defaultWorkerCount();
+
+		explicit JobSystem(size_t numWorkers = defaultWorkerCount());
+		~JobSystem();
+
+	public:
+		/** Queues a job. If a counter is provided it must outlive the job; wait on it to know the job is done. */
+		void run(std::function<void()> work, JobCounter* counter = nullptr);
+
+		/** Queues a job once every job currently counted by dependency has finished */
+		void runAfter(JobCounter& dependency, std::function<void()> work, JobCounter* counter = nullptr);
+
+		/** Runs queued jobs on the calling thread until the counter reaches zero */
+		void waitFor(JobCounter& counter);
+
+		/**
+			Calls body(idx) for every idx in [0, count), handing out batchSize indices per job. Blocks until done, with
+			the calling thread helping. body must be safe to call concurrently for different indices. May be nested.
+		*/
+		void parallelFor(size_t count, size_t batchSize, const std::function<void(size_t)>& body);
+
+		/** Number of threads jobs can run on, including the thread that waits */
+		size_t getThreadCount() const { return workers.size() + 1; }
+
+	public: //frame scratch
+		/** The calling thread's scratch allocator. Threads that are not workers share one allocator, so only the game thread should use it. */
+		FrameScratchAllocator& getFrameScratch();
+
+		/** Resets every thread's scratch allocator. Must be called while no jobs are in flight; GameBase calls this at the start of each frame. */
+		void resetFrameScratch();
+
+	private:
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		void schedule(Job&& job);
+		bool tryRunJob(size_t queueIdx);
+		bool popJob(size_t queueIdx, Job& outJob);
+		void finishJob(JobCounter* counter);
+		size_t getQueueIdx() const;
+		void workerLoop(size_t queueIdx);
+
+	private:
+		//queue 0 is shared by threads that are not workers; worker N owns queue N+1
+		std::vector<std::unique_ptr<WorkQueue>> queues;
+		std::vector<std::unique_ptr<FrameScratchAllocator>> frameScratch;
+		std::vector<std::thread> workers;
+
+		std::mutex sleepMutex;
+		std::condition_variable wakeWorkers;
+		std::atomic<size_t> queuedJobs{ 0 };
+		bool bShutdown = false;
+	};
+}
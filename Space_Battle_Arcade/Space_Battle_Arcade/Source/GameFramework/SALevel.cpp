@@ -2,6 +2,10 @@
 #include "GameFramework/SAGameBase.h"
 #include "GameFramework/SALog.h"
 #include "GameMode/ServerGameMode_Base.h"
+#include "Rendering/RenderData.h"
+
+#include <cstring>
+#include <limits>
 
 namespace SA
 {
@@ -18,6 +22,7 @@ namespace SA
 		//be very careful about accessing/destroying resources from gamebase in ctor/dtor
 
 		worldTimeManager = GameBase::get().getTimeSystem().createManager();
+		aiLodScheduler = new_sp<AILodScheduler>();
 	}
 
 	LevelBase::~LevelBase()
@@ -39,6 +44,7 @@ namespace SA
 	{
 		//base behavior should go here, before the subclass callbacks
 		bLevelActive = true;
+		worldTimeManager->registerTicker(aiLodScheduler);
 
 		//start subclass specific behavior after base behavior (ctor/dtor pattern)
 		startLevel_v();
@@ -68,6 +74,10 @@ namespace SA
 		}
 		worldEntities.clear();
 		renderEntities.clear();
+		teamQueries.clear();
+		avoidanceFields.clear();
+		aiLodScheduler->clear();
+		worldTimeManager->removeTicker(aiLodScheduler);
 
 		//#todo #future perhaps the level system should do this after postlevelchagne is broadcast because it means world time manager will be null
 		//also, seems better that we shouldn't destroy it separately from level, instead we should just deregister it and let it be cleaned up in level dtor
@@ -75,6 +85,88 @@ namespace SA
 		GameBase::get().getTimeSystem().destroyManager(worldTimeManager);
 	}
 
+	uint64_t LevelBase::hashWorldState() const
+	{
+		//worldEntities walks in spawn order, so entity hashes are chained; swapping two entities' states changes the hash
+		uint64_t worldHash = 14695981039346656037ull ^ worldEntities.size();
+		for (const sp<WorldEntity>& entity : worldEntities)
+		{
+			const Transform& xform = entity->getTransform();
+			const float components[] = {
+				xform.position.x, xform.position.y, xform.position.z,
+				xform.rotQuat.w, xform.rotQuat.x, xform.rotQuat.y, xform.rotQuat.z,
+				xform.scale.x, xform.scale.y, xform.scale.z
+			};
+
+			//FNV-1a over the float bits; then a splitmix finalizer so entities with similar transforms hash far apart
+			uint64_t entityHash = 14695981039346656037ull;
+			for (float component : components)
+			{
+				uint32_t bits = 0;
+				std::memcpy(&bits, &component, sizeof(bits));
+				entityHash = (entityHash ^ bits) * 1099511628211ull;
+			}
+			entityHash = (entityHash ^ (entityHash >> 30)) * 0xbf58476d1ce4e5b9ull;
+			entityHash = (entityHash ^ (entityHash >> 27)) * 0x94d049bb133111ebull;
+			entityHash ^= entityHash >> 31;
+
+			worldHash = (worldHash ^ entityHash) * 1099511628211ull;
+		}
+		return worldHash;
+	}
+
+	void LevelBase::cacheRenderData(RenderData& frameRenderData)
+	{
+		renderCuller.clear();
+		cullCandidates.clear();
+		cullCandidateMatrices.clear();
+
+		//bounding spheres come from the model's cached AABB under this frame's transform; collision OBBs are not updated for every entity type
+		for (const sp<RenderModelEntity>& renderEntity : renderEntities)
+		{
+			const glm::mat4 modelMatrix = renderEntity->getTransform().getModelMatrix();
+			float radius = std::numeric_limits<float>::max(); //no model bounds, never cull
+			glm::vec3 center = glm::vec3(modelMatrix[3]);
+			if (const sp<const Model3D>& model = renderEntity->getModel())
+			{
+				std::tuple<glm::vec3, glm::vec3> aabb = model->getAABB();
+				const glm::vec3 aabbSize = std::get<1>(aabb) - std::get<0>(aabb);
+				center = glm::vec3(modelMatrix * glm::vec4(std::get<0>(aabb) + 0.5f * aabbSize, 1.f));
+
+				const float maxScale = glm::max(glm::length(glm::vec3(modelMatrix[0])), glm::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+				radius = 0.5f * glm::length(aabbSize) * maxScale;
+			}
+			renderCuller.addSphere(center, radius);
+			cullCandidates.push_back(&renderEntity);
+			cullCandidateMatrices.push_back(modelMatrix);
+		}
+
+		if (frameRenderData.bHasCameraFrustum && bFrustumCullRenderEntities)
+		{
+			renderCuller.cull(frameRenderData.projection_view, frameRenderData.playerCamerasPositions[0]);
+		}
+		else
+		{
+			renderCuller.acceptAll();
+		}
+
+		frameRenderData.entities.reserve(renderCuller.getVisibleIndices().size());
+		visibleRenderEntities.clear();
+		for (uint32_t visibleIdx : renderCuller.getVisibleIndices())
+		{
+			const RenderModelEntity& visibleEntity = **cullCandidates[visibleIdx];
+			frameRenderData.addEntity(visibleEntity, cullCandidateMatrices[visibleIdx], renderCuller.getLodHint(visibleIdx));
+			visibleRenderEntities.push_back(&visibleEntity);
+		}
+		cullCandidates.clear(); //don't hold pointers into the entity set past this call
+
+		cacheRenderData_v(frameRenderData, visibleRenderEntities);
+		visibleRenderEntities.clear();
+
+		//the simulation ticks before this frame's render data is cached, so ai is tiered against the previous frame's cameras
+		aiLodScheduler->setViewers(frameRenderData);
+	}
+
 	void LevelBase::startLevel_v()
 	{
 	}
@@ -106,6 +198,8 @@ namespace SA
 			{
 				entity->tick(dilated_dt_sec);
 			}
+			teamQueries.refresh();
+			avoidanceFields.refresh();
 
 			tick_v(dilated_dt_sec);
 		}
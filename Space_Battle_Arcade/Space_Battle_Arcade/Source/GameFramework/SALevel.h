@@ -15,6 +15,10 @@
 #include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SpatialHashingComponent.h"
 #include "Tools/DataStructures/MultiDelegate.h"
 #include "Rendering/Lights/SADirectionLight.h"
+#include "Rendering/FrustumCulling.h"
+#include "GameFramework/SATeamSpatialQueries.h"
+#include "GameFramework/SAAILodScheduler.h"
+#include "Tools/Algorithms/SphereAvoidance/AvoidanceField.h"
 
 namespace SA
 {
@@ -22,6 +26,7 @@ namespace SA
 	class TimeManager;
 	class ServerGameMode_Base;
 	struct DirectionLight;
+	struct RenderData;
 
 	struct LevelInitializer
 	{
@@ -38,6 +43,9 @@ namespace SA
 		LevelBase(const LevelInitializer& init = {});
 		virtual ~LevelBase();
 
+	public:
+		using WorldEntitySet = std::set<sp<WorldEntity>, SpawnOrder>;
+
 	public:
 		MultiDelegate<const sp<WorldEntity>&> onSpawnedEntity;
 		MultiDelegate<const sp<WorldEntity>&> onUnspawningEntity;
@@ -54,6 +62,16 @@ namespace SA
 		/** Get this level's collision grid */
 		inline SH::SpatialHashGrid<WorldEntity>& getWorldGrid() { return worldCollisionGrid; }
 
+		/** Nearest enemy and cone queries over spawned entities that have a team; refreshed each level tick */
+		inline const TeamSpatialQueries& getTeamQueries() const { return teamQueries; }
+
+		/** Precomputed avoidance sphere pushes; the static field is rebuilt during the level tick when static owners change */
+		inline AvoidanceFieldSet& getAvoidanceFields() { return avoidanceFields; }
+		inline const AvoidanceFieldSet& getAvoidanceFields() const { return avoidanceFields; }
+
+		/** Ticks brains and their ticking tasks at a rate based on distance to the player cameras */
+		inline AILodScheduler& getAILodScheduler() { return *aiLodScheduler; }
+
 		//#SUGGESTED refactor this to just return reference, a level should always have a valid time manager.
 		inline const sp<TimeManager>& getWorldTimeManager() { return worldTimeManager; }
 
@@ -62,11 +80,19 @@ namespace SA
 
 		/** returns const to prevent modification; use spawn and unspawn entity to add/remove. 
 			#concern this may be an encapsulation issue. Perhaps accessing entities should only be done through the world grid.*/
-		const std::set<sp<WorldEntity>>& getWorldEntities() { return worldEntities; }
+		const WorldEntitySet& getWorldEntities() { return worldEntities; }
 		const std::vector<DirectionLight>& getDirectionalLights() const { return dirLights; }
 		glm::vec3 getAmbientLight() const { return ambientLight; }
 
 		virtual bool isEditorLevel() { return false; }
+
+		/** Hash of every world entity's transform bits, in spawn order, so equal simulations hash equal across runs. */
+		uint64_t hashWorldState() const;
+
+		/** Culls render entities against the frame's camera and copies the visible ones into the frame's snapshot */
+		void cacheRenderData(RenderData& frameRenderData);
+		FrustumCuller& getRenderCuller() { return renderCuller; }
+		void setFrustumCullRenderEntities(bool bEnable) { bFrustumCullRenderEntities = bEnable; }
 	private:
 		void startLevel();
 		void endLevel();
@@ -79,20 +105,31 @@ namespace SA
 		virtual sp<ServerGameMode_Base> onServerCreateGameMode();
 	protected:
 		virtual void tick_v(float dt_sec) {}
+		/** Adds level specific data to a frame's snapshot; visibleEntities is parallel to frameRenderData.entities and only valid during the call */
+		virtual void cacheRenderData_v(RenderData& /*frameRenderData*/, const std::vector<const RenderModelEntity*>& /*visibleEntities*/) {}
 	private: //virtuals; private indicates subclasses inherit when function called, but not how function is completed.
 		void tick(float dt_sec);
 	public:
 		virtual void render(float dt_sec, const glm::mat4& view, const glm::mat4& projection) {}; //#TODO #replace this with function that takes as parameter render data
 	protected: 
-		std::set<sp<WorldEntity>> worldEntities; //O(n) walks, but walks will not be very cache friendly as a lot of indirection. 
-		std::set<sp<RenderModelEntity>> renderEntities;
+		WorldEntitySet worldEntities; //O(n) walks, but walks will not be very cache friendly as a lot of indirection. 
+		std::set<sp<RenderModelEntity>, SpawnOrder> renderEntities;
 		SH::SpatialHashGrid<WorldEntity> worldCollisionGrid;
+		TeamSpatialQueries teamQueries;
+		AvoidanceFieldSet avoidanceFields;
+		sp<AILodScheduler> aiLodScheduler;
 		sp<TimeManager> worldTimeManager;
 		sp<ServerGameMode_Base> gameModeBase = nullptr; //only valid on server
 		std::vector<DirectionLight> dirLights;
 		glm::vec3 ambientLight{0.f};
 	private:
+		FrustumCuller renderCuller;
+		bool bFrustumCullRenderEntities = true;
+		std::vector<const sp<RenderModelEntity>*> cullCandidates; //parallel to the culler's spheres; only valid while caching
+		std::vector<glm::mat4> cullCandidateMatrices;
+		std::vector<const RenderModelEntity*> visibleRenderEntities;
 		bool bLevelActive = false;
+		uint64_t nextSpawnId = 1;
 	};
 
 	///////////////////////////////////////////////////////////////////////////////////
@@ -103,8 +140,10 @@ namespace SA
 		{
 			spawnCompileCheck<T>();
 			sp<T> entity = new_sp<T>(std::forward<Args>(args)...);
+			entity->spawnId = nextSpawnId++;
 			worldEntities.insert(entity);
 			renderEntities.insert(entity);
+			teamQueries.addEntity(entity);
 			onEntitySpawned_v(entity);
 			onSpawnedEntity.broadcast(entity);
 			return entity;
@@ -119,6 +158,8 @@ namespace SA
 			bool foundInAllLocations = renderEntities.find(entity) != renderEntities.end() && worldEntities.find(entity) != worldEntities.end();
 			worldEntities.erase(entity);
 			renderEntities.erase(entity);
+			teamQueries.removeEntity(entity.get());
+			avoidanceFields.removeOwner(entity.get());
 
 			onEntityUnspawned_v(entity);
 			onUnspawningEntity.broadcast(entity);
@@ -1,18 +1,30 @@
 #include "GameFramework/SALog.h"
 #include <iostream>
 #include "GameFramework/SAGameBase.h"
+#include "GameFramework/SALogBackend.h"
 #include <string>
 
 namespace SA
 {
 	namespace logging
 	{
-		char formatBuffer[10240];
+		thread_local char formatBuffer[10240];
 	}
 
 	void log(const char* logName, LogLevel level, const char* msg)
 	{
+		const uint16_t categoryId = logging::getCategoryId(logName);
+		if (!logging::isEnabled(categoryId, level))
+		{
+			return;
+		}
+
 		static GameBase& game = GameBase::get();
+		if (logging::pushToAsyncBackend(categoryId, level, game.getFrameNumber(), msg))
+		{
+			return;
+		}
+
 		std::string frame = "[" + std::to_string(game.getFrameNumber()) + "]";
 
 		std::ostream& output = (level == LogLevel::LOG_WARNING || level == LogLevel::LOG_ERROR) ? std::cerr : std::cout;
@@ -25,4 +37,3 @@ namespace SA
 
 
 }
-
@@ -11,12 +11,17 @@ namespace SA
 		LOG_ERROR
 	};
 
-	/** #TODO Logging system will probably need more fleshing out*/
+	/** Writes through the async log backend once GameBase has started it (see SALogBackend.h), otherwise straight to the console */
 	void log(const char* logName, LogLevel level, const char* msg);
 
 	namespace logging
 	{
-		extern char formatBuffer[10240];
+		extern thread_local char formatBuffer[10240];
+
+		/** Runtime filtering; messages below a category's level are discarded before they are formatted or queued */
+		void setCategoryLevel(const char* logName, LogLevel minLevel);
+		void setDefaultLevel(LogLevel minLevel); //for categories without their own level
+		bool isEnabled(const char* logName, LogLevel level);
 	}
 
 //NOTE: msvc and clang divergence here. 
@@ -34,7 +39,10 @@ namespace SA
 //So for now will use it here, but we may need to do some specific compiler checks here to compile out to different versions of the macro.
 #define logf_sa(logName, logLevel, msg, ...)\
 	{\
-		snprintf(logging::formatBuffer, sizeof(logging::formatBuffer), msg, ##__VA_ARGS__);\
-		log(logName, logLevel, logging::formatBuffer);\
+		if (logging::isEnabled(logName, logLevel))\
+		{\
+			snprintf(logging::formatBuffer, sizeof(logging::formatBuffer), msg, ##__VA_ARGS__);\
+			log(logName, logLevel, logging::formatBuffer);\
+		}\
 	}
 }
\ No newline at end of file
@@ -0,0 +1,786 @@
+#include "GameFramework/SALogBackend.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+
+namespace SA
+{
+	using LogClock = std::chrono::steady_clock;
+	using namespace logging;
+
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// categories
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	namespace
+	{
+		constexpr size_t MAX_CATEGORIES = size_t(UINT16_MAX) + 1;
+
+		struct CategoryRegistry
+		{
+			std::mutex mutex;
+			std::deque<std::string> names; //deque so names cached by other threads stay put as categories are added
+			std::vector<bool> hasOwnLevel;
+			std::unordered_map<std::string, uint16_t> nameToId;
+			LogLevel defaultLevel = LogLevel::LOG;
+
+			//indexed by id without locking; every id a uint16_t can hold has a slot
+			std::array<std::atomic<uint8_t>, MAX_CATEGORIES> minLevels{};
+		};
+
+		/** function local so logging during static initialization finds it constructed */
+		CategoryRegistry& getRegistry()
+		{
+			static CategoryRegistry registry;
+			return registry;
+		}
+
+		/** registry.mutex must be held */
+		uint16_t findOrAddCategory(CategoryRegistry& registry, const char* logName)
+		{
+			auto findResult = registry.nameToId.find(logName);
+			if (findResult != registry.nameToId.end())
+			{
+				return findResult->second;
+			}
+			if (registry.names.size() == MAX_CATEGORIES)
+			{
+				return uint16_t(MAX_CATEGORIES - 1); //out of ids, the rest share the last one
+			}
+
+			const uint16_t categoryId = uint16_t(registry.names.size());
+			registry.names.emplace_back(logName);
+			registry.hasOwnLevel.push_back(false);
+			registry.nameToId.insert({ registry.names.back(), categoryId });
+			registry.minLevels[categoryId].store(uint8_t(registry.defaultLevel), std::memory_order_relaxed);
+			return categoryId;
+		}
+
+		struct CachedCategory
+		{
+			uint16_t categoryId = 0;
+			const std::string* name = nullptr;
+		};
+	}
+
+	uint16_t logging::getCategoryId(const char* logName)
+	{
+		//log names are nearly always literals or __FUNCTION__, so their address finds them; the compare catches reused buffers
+		thread_local std::unordered_map<const char*, CachedCategory> cache;
+		auto findResult = cache.find(logName);
+		if (findResult != cache.end() && std::strcmp(findResult->second.name->c_str(), logName) == 0)
+		{
+			return findResult->second.categoryId;
+		}
+
+		CategoryRegistry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		const uint16_t categoryId = findOrAddCategory(registry, logName);
+		cache[logName] = CachedCategory{ categoryId, &registry.names[categoryId] };
+		return categoryId;
+	}
+
+	std::string logging::getCategoryName(uint16_t categoryId)
+	{
+		CategoryRegistry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		return categoryId < registry.names.size() ? registry.names[categoryId] : std::string{};
+	}
+
+	bool logging::isEnabled(uint16_t categoryId, LogLevel level)
+	{
+		return uint8_t(level) >= getRegistry().minLevels[categoryId].load(std::memory_order_relaxed);
+	}
+
+	bool logging::isEnabled(const char* logName, LogLevel level)
+	{
+		return isEnabled(getCategoryId(logName), level);
+	}
+
+	void logging::setCategoryLevel(const char* logName, LogLevel minLevel)
+	{
+		CategoryRegistry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		const uint16_t categoryId = findOrAddCategory(registry, logName);
+		registry.hasOwnLevel[categoryId] = true;
+		registry.minLevels[categoryId].store(uint8_t(minLevel), std::memory_order_relaxed);
+	}
+
+	void logging::setDefaultLevel(LogLevel minLevel)
+	{
+		CategoryRegistry& registry = getRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.defaultLevel = minLevel;
+		for (size_t categoryId = 0; categoryId < registry.names.size(); ++categoryId)
+		{
+			if (!registry.hasOwnLevel[categoryId])
+			{
+				registry.minLevels[categoryId].store(uint8_t(minLevel), std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// text and binary formats
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	static const char* levelName(LogLevel level)
+	{
+		switch (level)
+		{
+			case LogLevel::LOG_WARNING: return "WARNING";
+			case LogLevel::LOG_ERROR: return "ERROR";
+			default: return "LOG";
+		}
+	}
+
+	void logging::formatRecord(std::string& out, const DecodedRecord& record, bool bDetailed)
+	{
+		if (bDetailed)
+		{
+			char prefix[64];
+			snprintf(prefix, sizeof(prefix), "[%12.6f] %-7s ", double(record.header.timestampNs) * 1e-9, levelName(record.header.level));
+			out += prefix;
+		}
+
+		out += record.category;
+		out += " [";
+		out += std::to_string(record.header.frame);
+		out += "] : ";
+		if (record.header.type == ERecordType::DROPPED)
+		{
+			out += "dropped " + std::to_string(record.dropped.byLevel[0]) + " log, " + std::to_string(record.dropped.byLevel[1]) + " warning and "
+				+ std::to_string(record.dropped.byLevel[2]) + " error records, the log ring was full";
+		}
+		else
+		{
+			out += record.payload;
+			if (record.header.flags & RECORD_FLAG_TRUNCATED)
+			{
+				out += " ...(truncated)";
+			}
+		}
+		out += '\n';
+	}
+
+	static bool readFileHeader(std::istream& in, LogFileHeader& outHeader, std::string& outError)
+	{
+		const LogFileHeader expected;
+		in.read(reinterpret_cast<char*>(&outHeader), sizeof(outHeader));
+		if (!in || std::memcmp(outHeader.magic, expected.magic, sizeof(expected.magic)) != 0)
+		{
+			outError = "not a binary log";
+			return false;
+		}
+		if (outHeader.version != expected.version || outHeader.recordHeaderBytes < sizeof(LogRecordHeader))
+		{
+			outError = "unsupported binary log version " + std::to_string(outHeader.version);
+			return false;
+		}
+		return true;
+	}
+
+	static bool readRecords(std::istream& in, const LogFileHeader& fileHeader, std::vector<DecodedRecord>& outRecords, std::string& outError)
+	{
+		std::vector<std::string> categoryNames;
+		std::string payload;
+		for (;;)
+		{
+			LogRecordHeader header;
+			in.read(reinterpret_cast<char*>(&header), sizeof(header));
+			if (in.gcount() == 0 && in.eof())
+			{
+				return true;
+			}
+			if (size_t(in.gcount()) != sizeof(header))
+			{
+				outError = "binary log is cut short in a record header";
+				return false;
+			}
+			in.ignore(fileHeader.recordHeaderBytes - sizeof(header)); //header fields added by later versions
+
+			payload.resize(header.payloadBytes);
+			in.read(&payload[0], header.payloadBytes);
+			if (size_t(in.gcount()) != header.payloadBytes)
+			{
+				outError = "binary log is cut short in a record payload";
+				return false;
+			}
+
+			switch (header.type)
+			{
+				case ERecordType::CATEGORY:
+				{
+					categoryNames.resize(std::max<size_t>(categoryNames.size(), size_t(header.categoryId) + 1));
+					categoryNames[header.categoryId] = payload;
+					break;
+				}
+				case ERecordType::MESSAGE:
+				{
+					DecodedRecord record;
+					record.header = header;
+					const bool bKnownCategory = header.categoryId < categoryNames.size() && !categoryNames[header.categoryId].empty();
+					record.category = bKnownCategory ? categoryNames[header.categoryId] : "category_" + std::to_string(header.categoryId);
+					record.payload = payload;
+					outRecords.push_back(std::move(record));
+					break;
+				}
+				case ERecordType::DROPPED:
+				{
+					DecodedRecord record;
+					record.header = header;
+					record.category = "Log";
+					std::memcpy(&record.dropped, payload.data(), std::min(payload.size(), sizeof(record.dropped)));
+					outRecords.push_back(std::move(record));
+					break;
+				}
+				default:
+					break; //record types added by later versions
+			}
+		}
+	}
+
+	bool logging::readBinaryLog(std::istream& in, std::vector<DecodedRecord>& outRecords, std::string& outError)
+	{
+		LogFileHeader fileHeader;
+		return readFileHeader(in, fileHeader, outError) && readRecords(in, fileHeader, outRecords, outError);
+	}
+
+	bool logging::decodeBinaryLog(std::istream& in, std::ostream& out, std::string& outError)
+	{
+		LogFileHeader fileHeader;
+		if (!readFileHeader(in, fileHeader, outError))
+		{
+			return false;
+		}
+
+		const std::time_t startSecs = std::time_t(fileHeader.startUnixMicros / 1000000);
+		char startText[64] = "unknown time";
+		if (const std::tm* startUtc = std::gmtime(&startSecs))
+		{
+			std::strftime(startText, sizeof(startText), "%Y-%m-%d %H:%M:%S UTC", startUtc);
+		}
+		out << "# log started " << startText << ", times are seconds since then\n";
+
+		//decode everything that is readable even if the log was cut short (eg the game crashed mid write)
+		std::vector<DecodedRecord> records;
+		const bool bComplete = readRecords(in, fileHeader, records, outError);
+		std::string line;
+		for (const DecodedRecord& record : records)
+		{
+			line.clear();
+			formatRecord(line, record, true);
+			out << line;
+		}
+		return bComplete;
+	}
+
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// AsyncLogBackend
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	static uint64_t slotsForRecord(size_t payloadBytes)
+	{
+		return (sizeof(LogRecordHeader) + payloadBytes + AsyncLogBackend::SLOT_BYTES - 1) / AsyncLogBackend::SLOT_BYTES;
+	}
+
+	AsyncLogBackend::AsyncLogBackend(const Config& inConfig)
+		: config(inConfig)
+	{
+		size_t numSlots = 16;
+		while (numSlots < config.ringSlots)
+		{
+			numSlots <<= 1;
+		}
+		slots = std::vector<Slot>(numSlots);
+		for (uint64_t slotIdx = 0; slotIdx < numSlots; ++slotIdx)
+		{
+			slots[slotIdx].sequence.store(slotIdx, std::memory_order_relaxed);
+		}
+		ringMask = numSlots - 1;
+
+		//a record may take at most a quarter of the ring so a single message can never wedge it
+		maxPayloadBytes = std::min(MAX_PAYLOAD_BYTES, (numSlots / 4) * SLOT_BYTES - sizeof(LogRecordHeader));
+
+		startTime = LogClock::now();
+		if (!config.binaryLogPath.empty())
+		{
+			binaryFile.open(config.binaryLogPath, std::ios::binary | std::ios::trunc);
+			if (binaryFile.is_open())
+			{
+				LogFileHeader fileHeader;
+				fileHeader.recordHeaderBytes = uint16_t(sizeof(LogRecordHeader));
+				fileHeader.startUnixMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+				binaryFile.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+			}
+			else
+			{
+				//the log cannot report its own failure through itself
+				std::cerr << "Log : could not open binary log " << config.binaryLogPath << std::endl;
+			}
+		}
+
+		thread = std::thread(&AsyncLogBackend::run, this);
+	}
+
+	AsyncLogBackend::~AsyncLogBackend()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			bStopRequested = true;
+		}
+		wakeCondition.notify_one();
+		if (thread.joinable())
+		{
+			thread.join();
+		}
+	}
+
+	bool AsyncLogBackend::push(uint16_t categoryId, LogLevel level, uint64_t frame, const char* msg)
+	{
+		LogRecordHeader header;
+		header.timestampNs = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(LogClock::now() - startTime).count());
+		header.frame = frame;
+		header.categoryId = categoryId;
+		header.level = level;
+
+		size_t msgBytes = std::strlen(msg);
+		if (msgBytes > maxPayloadBytes)
+		{
+			msgBytes = maxPayloadBytes;
+			header.flags |= RECORD_FLAG_TRUNCATED;
+		}
+		header.payloadBytes = uint16_t(msgBytes);
+		const uint64_t numRecordSlots = slotsForRecord(msgBytes);
+
+		////////////////////////////////////////////////////////
+		// claim consecutive slots; the writer frees slots in order, so if the last one is free they all are
+		////////////////////////////////////////////////////////
+		uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+		for (uint32_t attempt = 0;;)
+		{
+			const uint64_t lastPos = pos + numRecordSlots - 1;
+			const int64_t lap = int64_t(slots[lastPos & ringMask].sequence.load(std::memory_order_acquire)) - int64_t(lastPos);
+			if (lap == 0)
+			{
+				if (enqueuePos.compare_exchange_weak(pos, pos + numRecordSlots, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (lap < 0)
+			{
+				//full; errors give the writer a little time to catch up, everything else is dropped right away
+				wakeWriter();
+				if (level != LogLevel::LOG_ERROR || attempt++ >= config.errorRetries)
+				{
+					droppedSinceWrite[size_t(level)].fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				std::this_thread::yield();
+				pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+			else
+			{
+				pos = enqueuePos.load(std::memory_order_relaxed); //another producer claimed them first
+			}
+		}
+
+		////////////////////////////////////////////////////////
+		// copy in and publish; the first slot is published last as it is the one the writer waits on
+		////////////////////////////////////////////////////////
+		auto copyIn = [this, pos](size_t offset, const void* src, size_t bytes)
+		{
+			const uint8_t* srcBytes = static_cast<const uint8_t*>(src);
+			while (bytes > 0)
+			{
+				Slot& slot = slots[(pos + offset / SLOT_BYTES) & ringMask];
+				const size_t slotOffset = offset % SLOT_BYTES;
+				const size_t chunk = std::min(bytes, SLOT_BYTES - slotOffset);
+				std::memcpy(slot.bytes + slotOffset, srcBytes, chunk);
+				srcBytes += chunk;
+				offset += chunk;
+				bytes -= chunk;
+			}
+		};
+		copyIn(0, &header, sizeof(header));
+		copyIn(sizeof(header), msg, msgBytes);
+		for (uint64_t slotIdx = numRecordSlots; slotIdx-- > 0;)
+		{
+			slots[(pos + slotIdx) & ringMask].sequence.store(pos + slotIdx + 1, std::memory_order_release);
+		}
+
+		//wake the writer early for errors, and whenever the ring passes another half so it never sits full while the writer sleeps
+		const uint64_t halfRing = (ringMask + 1) / 2;
+		if (level == LogLevel::LOG_ERROR || (pos / halfRing) != ((pos + numRecordSlots) / halfRing))
+		{
+			wakeWriter();
+		}
+		return true;
+	}
+
+	void AsyncLogBackend::wakeWriter()
+	{
+		if (!bWakePending.exchange(true, std::memory_order_acq_rel))
+		{
+			wakeCondition.notify_one(); //without the mutex so producers never block; a missed wake costs at most one flush interval
+		}
+	}
+
+	void AsyncLogBackend::flush()
+	{
+		if (std::this_thread::get_id() == thread.get_id())
+		{
+			return; //the writer would wait on itself
+		}
+
+		const uint64_t target = enqueuePos.load(std::memory_order_acquire);
+		std::unique_lock<std::mutex> lock(mutex);
+		while (writtenPos < target && thread.joinable() && !bStopRequested)
+		{
+			bWakePending.store(true, std::memory_order_release);
+			wakeCondition.notify_one();
+			writtenCondition.wait_for(lock, std::chrono::milliseconds(config.flushIntervalMs));
+		}
+	}
+
+	AsyncLogBackend::Stats AsyncLogBackend::getStats() const
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		Stats result = stats;
+		for (size_t levelIdx = 0; levelIdx < NUM_LOG_LEVELS; ++levelIdx)
+		{
+			result.numDropped[levelIdx] += droppedSinceWrite[levelIdx].load(std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+	void AsyncLogBackend::run()
+	{
+		std::vector<DecodedRecord> batch;
+		for (;;)
+		{
+			bool bStopping = false;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wakeCondition.wait_for(lock, std::chrono::milliseconds(config.flushIntervalMs),
+					[this]() { return bStopRequested || bWakePending.load(std::memory_order_acquire); });
+				bWakePending.store(false, std::memory_order_release);
+				bStopping = bStopRequested;
+			}
+
+			//producers have stopped by the time a stop is requested, so one more full drain writes everything
+			while (size_t numRecords = drain(batch))
+			{
+				write(batch, numRecords);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					writtenPos = readPos;
+				}
+				writtenCondition.notify_all();
+			}
+
+			if (bStopping)
+			{
+				writtenCondition.notify_all();
+				return;
+			}
+		}
+	}
+
+	size_t AsyncLogBackend::drain(std::vector<DecodedRecord>& batch)
+	{
+		constexpr size_t MAX_BATCH = 1024;
+		if (batch.size() < MAX_BATCH)
+		{
+			batch.resize(MAX_BATCH);
+		}
+
+		const uint64_t inUse = enqueuePos.load(std::memory_order_relaxed) - readPos;
+		size_t numRecords = 0;
+		while (numRecords < MAX_BATCH)
+		{
+			Slot& head = slots[readPos & ringMask];
+			if (head.sequence.load(std::memory_order_acquire) != readPos + 1)
+			{
+				break; //nothing published yet
+			}
+
+			DecodedRecord& record = batch[numRecords++];
+			auto copyOut = [this](size_t offset, void* dst, size_t bytes)
+			{
+				uint8_t* dstBytes = static_cast<uint8_t*>(dst);
+				while (bytes > 0)
+				{
+					const Slot& slot = slots[(readPos + offset / SLOT_BYTES) & ringMask];
+					const size_t slotOffset = offset % SLOT_BYTES;
+					const size_t chunk = std::min(bytes, SLOT_BYTES - slotOffset);
+					std::memcpy(dstBytes, slot.bytes + slotOffset, chunk);
+					dstBytes += chunk;
+					offset += chunk;
+					bytes -= chunk;
+				}
+			};
+			copyOut(0, &record.header, sizeof(record.header));
+			record.payload.resize(record.header.payloadBytes);
+			copyOut(sizeof(record.header), &record.payload[0], record.header.payloadBytes);
+
+			//free in order, so a producer seeing the last slot of its claim free knows the rest are
+			const uint64_t numRecordSlots = slotsForRecord(record.header.payloadBytes);
+			for (uint64_t slotIdx = 0; slotIdx < numRecordSlots; ++slotIdx)
+			{
+				slots[(readPos + slotIdx) & ringMask].sequence.store(readPos + slotIdx + ringMask + 1, std::memory_order_release);
+			}
+			readPos += numRecordSlots;
+			lastFrame = std::max(lastFrame, record.header.frame);
+		}
+
+		DroppedCounts dropped;
+		bool bDropped = false;
+		for (size_t levelIdx = 0; levelIdx < NUM_LOG_LEVELS; ++levelIdx)
+		{
+			dropped.byLevel[levelIdx] = uint32_t(droppedSinceWrite[levelIdx].exchange(0, std::memory_order_relaxed));
+			bDropped |= dropped.byLevel[levelIdx] > 0;
+		}
+		if (bDropped)
+		{
+			if (numRecords == batch.size())
+			{
+				batch.emplace_back();
+			}
+			DecodedRecord& record = batch[numRecords++];
+			record.header = LogRecordHeader{};
+			record.header.timestampNs = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(LogClock::now() - startTime).count());
+			record.header.frame = lastFrame;
+			record.header.type = ERecordType::DROPPED;
+			record.header.level = dropped.byLevel[2] > 0 ? LogLevel::LOG_ERROR : LogLevel::LOG_WARNING;
+			record.header.payloadBytes = uint16_t(sizeof(dropped));
+			record.dropped = dropped;
+			record.payload.clear();
+
+			std::lock_guard<std::mutex> lock(mutex);
+			for (size_t levelIdx = 0; levelIdx < NUM_LOG_LEVELS; ++levelIdx)
+			{
+				stats.numDropped[levelIdx] += dropped.byLevel[levelIdx];
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.slotsHighWater = std::max(stats.slotsHighWater, inUse);
+		return numRecords;
+	}
+
+	void AsyncLogBackend::write(std::vector<DecodedRecord>& batch, size_t numRecords)
+	{
+		std::ostream* currentStream = nullptr;
+		textBuffer.clear();
+		binaryBuffer.clear();
+
+		uint64_t numMessages = 0;
+		for (size_t recordIdx = 0; recordIdx < numRecords; ++recordIdx)
+		{
+			DecodedRecord& record = batch[recordIdx];
+			if (record.header.type == ERecordType::MESSAGE)
+			{
+				++numMessages;
+				const uint16_t categoryId = record.header.categoryId;
+				if (categoryId >= writerCategoryNames.size())
+				{
+					writerCategoryNames.resize(size_t(categoryId) + 1);
+				}
+				if (writerCategoryNames[categoryId].empty())
+				{
+					writerCategoryNames[categoryId] = getCategoryName(categoryId);
+				}
+				record.category = writerCategoryNames[categoryId];
+			}
+			else
+			{
+				record.category = "Log";
+			}
+
+			if (binaryFile.is_open())
+			{
+				if (record.header.type == ERecordType::MESSAGE)
+				{
+					const uint16_t categoryId = record.header.categoryId;
+					if (categoryId >= binaryCategoriesWritten.size())
+					{
+						binaryCategoriesWritten.resize(size_t(categoryId) + 1, false);
+					}
+					if (!binaryCategoriesWritten[categoryId])
+					{
+						LogRecordHeader categoryHeader;
+						categoryHeader.timestampNs = record.header.timestampNs;
+						categoryHeader.frame = record.header.frame;
+						categoryHeader.categoryId = categoryId;
+						categoryHeader.type = ERecordType::CATEGORY;
+						categoryHeader.payloadBytes = uint16_t(std::min<size_t>(record.category.size(), UINT16_MAX));
+						appendBinary(categoryHeader, record.category.data());
+						binaryCategoriesWritten[categoryId] = true;
+					}
+					appendBinary(record.header, record.payload.data());
+				}
+				else
+				{
+					appendBinary(record.header, &record.dropped);
+				}
+			}
+
+			if (config.bWriteConsole)
+			{
+				//warnings and errors go to stderr as they always have; keep the interleaving of the two streams
+				std::ostream* stream = record.header.level == LogLevel::LOG ? &std::cout : &std::cerr;
+				if (stream != currentStream && currentStream)
+				{
+					*currentStream << textBuffer << std::flush;
+					textBuffer.clear();
+				}
+				currentStream = stream;
+				formatRecord(textBuffer, record, false);
+			}
+
+			if (config.extraSink)
+			{
+				config.extraSink(record);
+			}
+		}
+
+		if (currentStream && !textBuffer.empty())
+		{
+			*currentStream << textBuffer << std::flush;
+		}
+		if (binaryFile.is_open())
+		{
+			binaryFile.write(binaryBuffer.data(), std::streamsize(binaryBuffer.size()));
+			binaryFile.flush();
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.numWritten += numMessages;
+	}
+
+	void AsyncLogBackend::appendBinary(const LogRecordHeader& header, const void* payload)
+	{
+		const char* headerBytes = reinterpret_cast<const char*>(&header);
+		const char* payloadBytes = static_cast<const char*>(payload);
+		binaryBuffer.insert(binaryBuffer.end(), headerBytes, headerBytes + sizeof(header));
+		binaryBuffer.insert(binaryBuffer.end(), payloadBytes, payloadBytes + header.payloadBytes);
+	}
+
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// the backend SA::log writes through
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	namespace
+	{
+		std::atomic<AsyncLogBackend*> activeBackend{ nullptr };
+
+		//users count themselves in before loading activeBackend, so stop can wait out everyone still holding the old pointer
+		std::atomic<uint32_t> numBackendUsers{ 0 };
+
+		template<typename Fn>
+		bool useActiveBackend(Fn&& fn)
+		{
+			//sequentially consistent, pairs with stopAsyncBackend: either this sees the cleared pointer or stop sees this user
+			numBackendUsers.fetch_add(1);
+			AsyncLogBackend* backend = activeBackend.load();
+			if (backend)
+			{
+				fn(*backend);
+			}
+			numBackendUsers.fetch_sub(1, std::memory_order_release);
+			return backend != nullptr;
+		}
+
+		std::mutex& getBackendLifetimeMutex()
+		{
+			static std::mutex lifetimeMutex;
+			return lifetimeMutex;
+		}
+
+		std::unique_ptr<AsyncLogBackend>& getOwnedBackend()
+		{
+			static std::unique_ptr<AsyncLogBackend> ownedBackend;
+			return ownedBackend;
+		}
+
+		//the records queued just before a crash are the ones that explain it; write them out before the process goes down
+		std::terminate_handler previousTerminateHandler = nullptr;
+
+		void flushActiveBackend()
+		{
+			useActiveBackend([](AsyncLogBackend& backend) { backend.flush(); });
+		}
+
+		void flushOnTerminate()
+		{
+			flushActiveBackend();
+			if (previousTerminateHandler)
+			{
+				previousTerminateHandler();
+			}
+			std::abort();
+		}
+
+		void flushOnSignal(int signalNumber)
+		{
+			//flush is not async signal safe; this is best effort as the process is going down either way
+			flushActiveBackend();
+			std::signal(signalNumber, SIG_DFL);
+			std::raise(signalNumber);
+		}
+
+		void installCrashHandlers()
+		{
+			static bool bInstalled = false;
+			if (!bInstalled)
+			{
+				bInstalled = true;
+				previousTerminateHandler = std::set_terminate(&flushOnTerminate);
+				std::signal(SIGABRT, &flushOnSignal); //failed asserts
+				std::signal(SIGSEGV, &flushOnSignal);
+			}
+		}
+	}
+
+	bool logging::startAsyncBackend(const AsyncLogBackend::Config& config)
+	{
+		std::lock_guard<std::mutex> lock(getBackendLifetimeMutex());
+		if (getOwnedBackend())
+		{
+			return false;
+		}
+		getOwnedBackend() = std::make_unique<AsyncLogBackend>(config);
+		activeBackend.store(getOwnedBackend().get(), std::memory_order_release);
+		installCrashHandlers();
+		return true;
+	}
+
+	void logging::stopAsyncBackend()
+	{
+		std::lock_guard<std::mutex> lock(getBackendLifetimeMutex());
+		activeBackend.store(nullptr);
+
+		//new users now see no backend; the ones already in are mid push, which the writer is still running to make room for
+		while (numBackendUsers.load(std::memory_order_acquire) != 0)
+		{
+			std::this_thread::yield();
+		}
+		getOwnedBackend().reset(); //writes out everything queued
+	}
+
+	bool logging::pushToAsyncBackend(uint16_t categoryId, LogLevel level, uint64_t frame, const char* msg)
+	{
+		return useActiveBackend([&](AsyncLogBackend& backend) { backend.push(categoryId, level, frame, msg); });
+	}
+
+	AsyncLogBackend* logging::getAsyncBackend()
+	{
+		return activeBackend.load(std::memory_order_acquire);
+	}
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameFramework/SALog.h"
+#include "Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	namespace logging
+	{
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Binary log format
+		//
+		// A LogFileHeader, then records back to back: a LogRecordHeader followed by payloadBytes of payload. Everything
+		// is little endian, as written by the machine that ran the game. Before the first message of a category the
+		// writer emits a CATEGORY record whose payload is the category's name, so every log decodes on its own.
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		enum class ERecordType : uint8_t
+		{
+			MESSAGE,
+			CATEGORY,	//categoryId is being defined, payload is its name
+			DROPPED		//payload is DroppedCounts: records lost to a full ring since the previous DROPPED record
+		};
+
+		struct LogFileHeader
+		{
+			char magic[4] = { 'S', 'A', 'L', 'G' };
+			uint16_t version = 1;
+			uint16_t recordHeaderBytes = 0;
+			int64_t startUnixMicros = 0; //wall clock time record timestamps count from
+		};
+		static_assert(sizeof(LogFileHeader) == 16, "binary log file header must not change size");
+
+		struct LogRecordHeader
+		{
+			uint64_t timestampNs = 0; //since the backend started
+			uint64_t frame = 0;
+			uint16_t categoryId = 0;
+			LogLevel level = LogLevel::LOG;
+			ERecordType type = ERecordType::MESSAGE;
+			uint16_t payloadBytes = 0;
+			uint16_t flags = 0;
+		};
+		static_assert(sizeof(LogRecordHeader) == 24, "binary log record header must not change size");
+
+		constexpr uint16_t RECORD_FLAG_TRUNCATED = 1;
+		constexpr size_t NUM_LOG_LEVELS = 3;
+
+		struct DroppedCounts
+		{
+			std::array<uint32_t, NUM_LOG_LEVELS> byLevel{};
+		};
+
+		/** A record read back from a binary log, or handed to a backend's extra sink */
+		struct DecodedRecord
+		{
+			LogRecordHeader header;
+			std::string category;
+			std::string payload;
+			DroppedCounts dropped; //only for DROPPED records
+		};
+
+		/** Category ids are interned names; ids are stable for the life of the process */
+		uint16_t getCategoryId(const char* logName);
+		std::string getCategoryName(uint16_t categoryId);
+		bool isEnabled(uint16_t categoryId, LogLevel level);
+
+		/** The console line for a record; bDetailed prefixes the time since start and the level, as the decoder does */
+		void formatRecord(std::string& out, const DecodedRecord& record, bool bDetailed);
+
+		/** Reads every MESSAGE and DROPPED record; returns false with outError set if the stream is not a binary log or is cut short */
+		bool readBinaryLog(std::istream& in, std::vector<DecodedRecord>& outRecords, std::string& outError);
+		bool decodeBinaryLog(std::istream& in, std::ostream& out, std::string& outError);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Asynchronous log writer.
+	//
+	// Producers copy a record into a ring of cache line sized slots and return; they never lock, allocate or touch
+	// a stream. A record (header and whole message) takes as many consecutive slots as it needs and is claimed with
+	// a single compare-exchange, bounded MPMC queue style, where each slot carries the sequence number of the lap it
+	// is free or published for. A background thread drains the ring in order, writing text to the console and/or
+	// records to a binary log.
+	//
+	// When the ring is full, LOG and LOG_WARNING records are dropped at once. Errors retry a bounded number of times
+	// for the writer to catch up before they are dropped too. Drops are counted and written as a DROPPED record.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AsyncLogBackend final : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		static constexpr size_t SLOT_BYTES = 56; //with the sequence number, a slot is a cache line
+		static constexpr size_t MAX_PAYLOAD_BYTES = 4000; //longer messages are truncated
+
+		using RecordSink = std::function<void(const logging::DecodedRecord& record)>;
+
+		struct Config
+		{
+			uint32_t ringSlots = 1 << 14; //rounded up to a power of two
+			bool bWriteConsole = true;
+			std::string binaryLogPath; //empty for no binary log
+			uint32_t flushIntervalMs = 5; //the writer also wakes early for errors and a half full ring
+			uint32_t errorRetries = 2000;
+			RecordSink extraSink; //called on the writer thread for every record, eg for an in game console
+		};
+
+		struct Stats
+		{
+			uint64_t numWritten = 0;
+			std::array<uint64_t, logging::NUM_LOG_LEVELS> numDropped{};
+			uint64_t slotsHighWater = 0; //most slots in use seen by the writer
+		};
+
+	public:
+		explicit AsyncLogBackend(const Config& config);
+		~AsyncLogBackend(); //writes everything pushed so far
+
+		/** Producer, any thread. Returns false if the record was dropped. */
+		bool push(uint16_t categoryId, LogLevel level, uint64_t frame, const char* msg);
+
+		/** Blocks until everything pushed before the call has been written. Returns at once on the writer thread, eg from a sink. */
+		void flush();
+
+		Stats getStats() const;
+		bool isWritingBinary() const { return binaryFile.is_open(); }
+		size_t getRingSlots() const { return slots.size(); }
+
+	private:
+		struct alignas(64) Slot
+		{
+			std::atomic<uint64_t> sequence{ 0 };
+			uint8_t bytes[SLOT_BYTES];
+		};
+		static_assert(sizeof(Slot) == 64, "slots are sized to a cache line");
+
+		void wakeWriter();
+		void run();
+		size_t drain(std::vector<logging::DecodedRecord>& batch);
+		void write(std::vector<logging::DecodedRecord>& batch, size_t numRecords);
+		void appendBinary(const logging::LogRecordHeader& header, const void* payload);
+
+	private:
+		std::vector<Slot> slots;
+		uint64_t ringMask = 0;
+		size_t maxPayloadBytes = MAX_PAYLOAD_BYTES;
+
+		alignas(64) std::atomic<uint64_t> enqueuePos{ 0 };
+		alignas(64) std::array<std::atomic<uint64_t>, logging::NUM_LOG_LEVELS> droppedSinceWrite{};
+		std::atomic<bool> bWakePending{ false };
+
+		//writer thread state
+		uint64_t readPos = 0;
+		std::vector<std::string> writerCategoryNames;
+		std::vector<bool> binaryCategoriesWritten;
+		uint64_t lastFrame = 0;
+		std::string textBuffer;
+		std::vector<char> binaryBuffer; //a batch's records, written to the binary log in one go
+
+		Config config;
+		std::chrono::steady_clock::time_point startTime;
+		std::ofstream binaryFile;
+
+		mutable std::mutex mutex;
+		std::condition_variable wakeCondition;
+		std::condition_variable writtenCondition;
+		uint64_t writtenPos = 0;
+		Stats stats;
+		bool bStopRequested = false;
+		std::thread thread;
+	};
+
+	namespace logging
+	{
+		/** Routes SA::log through a new backend. Producers use the running backend without a lock, so it is never replaced;
+			returns false if one is already running. Also installs terminate and abort handlers that flush the backend before the process dies. */
+		bool startAsyncBackend(const AsyncLogBackend::Config& config);
+
+		/** Waits for producers already pushing to the backend, writes out everything queued and returns SA::log to writing straight to the console.
+			Threads may keep logging while this runs; their records go to the console once the backend is gone. */
+		void stopAsyncBackend();
+
+		/** Pushes to the running backend; returns false if none is running. The backend cannot be freed while a push is in flight. */
+		bool pushToAsyncBackend(uint16_t categoryId, LogLevel level, uint64_t frame, const char* msg);
+
+		/** Only for checking which backend is running; the pointer may be freed by stopAsyncBackend at any time, so never push through it. */
+		AsyncLogBackend* getAsyncBackend();
+	}
+}
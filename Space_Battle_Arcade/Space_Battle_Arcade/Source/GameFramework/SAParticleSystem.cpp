@@ -15,6 +15,7 @@
 #include "Rendering/OpenGLHelpers.h"
 #include "Rendering/DeferredRendering/DeferredRendererStateMachine.h"
 #include "GameFramework/SARenderSystem.h"
+#include "Rendering/RenderData.h"
 
 namespace SA
 {
@@ -26,26 +27,6 @@ namespace SA
 		return owningModDir + std::string("Assets/Particles/") + fileName + std::string(".json");
 	}
 
-	void ParticleConfig::generateMutableEffectData(std::vector<MutableEffectData>& outEffectData) const
-	{
-		outEffectData.clear();
-		outEffectData.reserve(effects.size());
-
-		for (const sp<Particle::Effect>& effect : effects)
-		{
-			outEffectData.emplace_back();
-			MutableEffectData& med = outEffectData.back();
-
-			//Reserve built-in locations
-			med.vec3Array.resize(3);
-			med.vec3Array[MutableEffectData::POS_VEC3_IDX] = { 0, 0, 0 }; //position
-			med.vec3Array[MutableEffectData::ROT_VEC3_IDX] = { 0, 0, 0 }; //rotation
-			med.vec3Array[MutableEffectData::SCALE_VEC3_IDX] = { 1, 1, 1 }; //scale
-
-			//#TODO reserve custom data locations
-		}
-	}
-
 	void ParticleConfig::onSerialize(json& outData)
 	{
 	}
@@ -118,23 +99,11 @@ namespace SA
 					shaderToInstanceDataIndex[effect->forwardShader] = nextId;
 					findIter = shaderToInstanceDataIndex.find(effect->forwardShader);
 
-					//set up the configured instance data to contain correct attributes and uniforms
-					// #suggested perhaps set this init in an "init/ctor" function on EffectInstanceData class
-					EffectInstanceData& EIData = instancedEffectsData.back();
-					EIData.effectData = effect;
-
-					//below are += to add to built-in passed data (such as model matrix and effect time alive)
-					EIData.numMat4PerInstance += effect->numCustomMat4sPerInstance;
-					EIData.numVec4PerInstance += effect->numCustomVec4sPerInstance;
-
-					//#TODO #optimize Need system for reserving more data if needed; perhaps a "buffer" class  that wraps vector that can auto-resize based on configuration
-					EIData.mat4Data.reserve(EIData.numMat4PerInstance * effect->estimateMaxSimultaneousEffects);
-					EIData.vec4Data.reserve(EIData.numVec4PerInstance * effect->estimateMaxSimultaneousEffects);
-
-					EIData.numInstancesThisFrame = 0;
-					
 					//this is the first time we're using this effect, precalculate its value dependent state. (tweaking at runtime will require updating again)
 					effect->updateEffectDuration();
+
+					//set up the configured instance data to contain correct attributes and uniforms, and compile the keyframes for batch evaluation
+					instancedEffectsData.back().initialize(effect);
 				}
 
 				//find iter is now definitely pointing to data
@@ -150,11 +119,8 @@ namespace SA
 			newParticle.xform = params.xform;
 			newParticle.durationDilation = params.durationDilation;
 			newParticle.parentXform_m = params.parentXform;
-			params.particle->generateMutableEffectData(newParticle.mutableEffectData);
-			assert(newParticle.mutableEffectData.size() == params.particle->effects.size());
 
-			//update particle and populate add to effect instance data
-			updateActiveParticleGroup(newParticle, 0);
+			//instance data is gathered from every active particle during the post game loop tick, which will pick up this particle
 
 			//#concern perhaps particle alias? user can corrupt data with bad memory access. But user needs to modify transform directly and stop loops.
 			spawnResult = newParticlePtr;
@@ -188,46 +154,17 @@ namespace SA
 
 		bool bAllEffectsDone = true;
 
-		for (size_t effectIdx = 0; effectIdx < activeParticle.particle->effects.size(); ++effectIdx)
-		{
-			sp<Particle::Effect>& effect = activeParticle.particle->effects[effectIdx];
-			MutableEffectData& meData = activeParticle.mutableEffectData[effectIdx];
-
-			///Let effects update particle data
-			activeParticle.timeAlive += (dt_sec_world * activeParticle.durationDilation);
+		activeParticle.timeAlive += (dt_sec_world * activeParticle.durationDilation);
 
-			for (Particle::KeyFrameChain& KFChain : effect->keyFrameChains)
-			{
-				bAllEffectsDone &= KFChain.update(meData, activeParticle.timeAlive);
-			}
-
-			///package active particle mutable data into instanced rendering format; 
+		for (const sp<Particle::Effect>& effect : activeParticle.particle->effects)
+		{
+			//keyframes are evaluated later for all instances of the effect at once; only the inputs are gathered here
 			///#future this may need to be a 2-pass thing so we can sort distance for transparency effects
 			EffectInstanceData& effectData = instancedEffectsData[*effect->assignedShaderIndex];
-			int thisInstanceIdx = effectData.numInstancesThisFrame;
-
-			effectData.numInstancesThisFrame += 1;
-			effectData.timeAlive.push_back(activeParticle.timeAlive);
-
-			Transform effectXform;
-			effectXform.position = meData.vec3Array[MutableEffectData::POS_VEC3_IDX];
-			effectXform.rotQuat = Utils::degreesVecToQuat(meData.vec3Array[MutableEffectData::ROT_VEC3_IDX]);
-			effectXform.scale = meData.vec3Array[MutableEffectData::SCALE_VEC3_IDX];
-			glm::mat4 effectWorldModelMat = particleGroupModelMat * effectXform.getModelMatrix();
-
-			//package matrix data 
-			effectData.mat4Data.push_back(effectWorldModelMat);	//first matrix is always model
-			//second matrix can be defined by the user 
-
-			//package vec4 data that is assumed to be available for every effect 
-			glm::vec4 builtinvec4;
-			builtinvec4.x = activeParticle.timeAlive;
-			builtinvec4.y = *effect->effectDuration; 
-			//builtinvec4.z = ?;
-			//builtinvec4.a = ?;
-			effectData.vec4Data.push_back(builtinvec4);
-
-			//#TODO package custom data?
+			effectData.addInstance(activeParticle.timeAlive, particleGroupModelMat);
+
+			//every keyframe chain is finished once the effect's longest chain is
+			bAllEffectsDone &= activeParticle.timeAlive > *effect->effectDuration;
 		}
 
 		bool bShouldRemove = false;
@@ -261,23 +198,35 @@ namespace SA
 		return bShouldRemove;
 	}
 
+	void ParticleSystem::cacheRenderData(RenderData& frameRenderData) const
+	{
+		frameRenderData.particleBatches.resize(instancedEffectsData.size());
+		for (size_t effectIdx = 0; effectIdx < instancedEffectsData.size(); ++effectIdx)
+		{
+			frameRenderData.particleBatches[effectIdx].copyFrom(instancedEffectsData[effectIdx]);
+		}
+	}
+
 	void ParticleSystem::handleRenderDispatch(float delta_sec)
 	{
-		static PlayerSystem& playerSystem = GameBase::get().getPlayerSystem();
-		const sp<PlayerBase>& player = playerSystem.getPlayer(0);
-		const sp<CameraBase> camera = player ? player->getCamera() : sp<CameraBase>(nullptr); //#TODO perhaps just listen to camera changing
+		GameBase& game = GameBase::get();
+		const RenderData* frd = game.getRenderSystem().getFrameRenderData_Read(game.getFrameNumber());
 
-		if (instanceMat4VBO_opt.has_value() && instanceVec4VBO_opt.has_value() && camera)
+		if (instanceMat4VBO_opt.has_value() && instanceVec4VBO_opt.has_value() && frd)
 		{
-			const glm::mat4 projection_view = camera->getPerspective() * camera->getView(); //calculate early 
-			const glm::vec3 camPos = camera->getPosition();
+			//camera and instances come from the frame snapshot so they agree with each other when render lags the simulation
+			const glm::mat4& projection_view = frd->projection_view;
+			const glm::vec3 camPos = frd->playerCamerasPositions[0];
 
 			GLuint instanceMat4VBO = *instanceMat4VBO_opt;
 			GLuint instanceVec4VBO = *instanceVec4VBO_opt;
 
-			for (EffectInstanceData& eid : instancedEffectsData)
+			//effects are only ever appended, so a batch index always refers to the same effect
+			for (size_t effectIdx = 0; effectIdx < frd->particleBatches.size() && effectIdx < instancedEffectsData.size(); ++effectIdx)
 			{
-				if (eid.numInstancesThisFrame > 0 && eid.effectData->mesh->getVAOs().size() > 0)
+				const RenderData::ParticleBatchSnapshot& batch = frd->particleBatches[effectIdx];
+				EffectInstanceData& eid = instancedEffectsData[effectIdx];
+				if (batch.numInstances > 0 && eid.effectData->mesh->getVAOs().size() > 0)
 				{
 					//at least 16 attributes to use for vertices. (see glGet documentation). query GL_MAX_VERTEX_ATTRIBS
 					//assumed vertex attributes:
@@ -294,11 +243,12 @@ namespace SA
 					// ---- BUFFER data ---- before binding it to all VAOs (model's may have multiple meshes, each with their own VAO)
 					//#TODO check sizes of EID data before trying to bind optional buffers
 					//#TODO investigate using glBufferSubData and glMapBuffer and GL_DYNAMIC_DRAW here; may be more efficient if we're not reallocating each time? It appears glBufferData will re-allocate
+					//instance buffers are kept at their peak size, only upload this frame's instances
 					ec(glBindBuffer(GL_ARRAY_BUFFER, instanceMat4VBO));
-					ec(glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * eid.mat4Data.size(), &eid.mat4Data[0], GL_STATIC_DRAW)); //#TODO this needs to go before binding of VAOs
+					ec(glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * batch.mat4Data.size(), batch.mat4Data.data(), GL_STATIC_DRAW)); //#TODO this needs to go before binding of VAOs
 
 					ec(glBindBuffer(GL_ARRAY_BUFFER, instanceVec4VBO));
-					ec(glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * eid.vec4Data.size(), &eid.vec4Data[0], GL_STATIC_DRAW));
+					ec(glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * batch.vec4Data.size(), batch.vec4Data.data(), GL_STATIC_DRAW));
 
 					for (GLuint effectVAO : eid.effectData->mesh->getVAOs())
 					{
@@ -308,7 +258,7 @@ namespace SA
 						{ //set up mat4 buffer
 
 							ec(glBindBuffer(GL_ARRAY_BUFFER, instanceMat4VBO));
-							GLsizei numVec4AttribsInBuffer = 4 * eid.numMat4PerInstance;
+							GLsizei numVec4AttribsInBuffer = GLsizei(4 * batch.numMat4PerInstance);
 							size_t packagedVec4Idx_matbuffer = 0;
 
 							//pass built-in data into instanced array vertex attribute
@@ -343,7 +293,7 @@ namespace SA
 							ec(glBindBuffer(GL_ARRAY_BUFFER, instanceVec4VBO));
 
 							//#TODO set num vec4s in stride based on custom data
-							GLsizei numVec4AttribsInBuffer = eid.numVec4PerInstance;
+							GLsizei numVec4AttribsInBuffer = GLsizei(batch.numVec4PerInstance);
 
 							size_t packagedVec4Idx_v4buffer = 0;
 							{
@@ -389,8 +339,7 @@ namespace SA
 					for (Particle::UniformData<glm::mat4>& uniformData : eid.effectData->mat4Uniforms) { shader->setUniformMatrix4fv(uniformData.uniformName.c_str(), 1, GL_FALSE, glm::value_ptr(uniformData.data)); }
 
 					//instanced render
-					eid.effectData->mesh->instanceRender(eid.numInstancesThisFrame);
-					eid.clearFrameData();
+					eid.effectData->mesh->instanceRender(batch.numInstances);
 				}
 			}
 		}
@@ -399,8 +348,6 @@ namespace SA
 
 	void ParticleSystem::handlePostGameloopTick(float deltaSec)
 	{
-		using KeyFrameChain = Particle::KeyFrameChain;
-
 		static PlayerSystem& playerSystem = GameBase::get().getPlayerSystem();
 		const sp<PlayerBase>& player = playerSystem.getPlayer(0);
 		const sp<CameraBase> camera = player ? player->getCamera() : sp<CameraBase>(nullptr); //#TODO perhaps just listen to camera changing
@@ -409,6 +356,11 @@ namespace SA
 		static std::vector<sp<ActiveParticleGroup>> removeParticleContainer;
 		static int oneTimeReserve = [](std::vector<sp<ActiveParticleGroup>> toRemoveContainer) { toRemoveContainer.reserve(100); return 0; }(removeParticleContainer);
 
+		for (EffectInstanceData& eid : instancedEffectsData)
+		{
+			eid.clearFrameData();
+		}
+
 		if (currentLevel && camera)
 		{
 			const sp<TimeManager>& worldTimeManager = currentLevel->getWorldTimeManager();
@@ -422,6 +374,8 @@ namespace SA
 					removeParticleContainer.push_back(activeParticle);
 				}
 			}
+
+			updateInstanceData();
 		}
 
 		for (sp<ActiveParticleGroup>& particle : removeParticleContainer)
@@ -431,6 +385,28 @@ namespace SA
 		removeParticleContainer.clear();
 	}
 
+	void ParticleSystem::updateInstanceData()
+	{
+		//large enough to amortize scheduling, small enough that a busy effect spreads across every worker
+		constexpr size_t instancesPerJob = 1024;
+
+		JobSystem& jobSystem = GameBase::get().getJobSystem();
+		for (EffectInstanceData& eid : instancedEffectsData)
+		{
+			if (eid.numInstancesThisFrame == 0)
+			{
+				continue;
+			}
+
+			eid.prepareInstanceBuffers();
+			size_t numJobs = (eid.numInstancesThisFrame + instancesPerJob - 1) / instancesPerJob;
+			jobSystem.parallelFor(numJobs, 1, [&eid](size_t jobIdx) {
+				size_t begin = jobIdx * instancesPerJob;
+				eid.updateInstances(begin, std::min(begin + instancesPerJob, eid.numInstancesThisFrame));
+			});
+		}
+	}
+
 	void ParticleSystem::initSystem()
 	{
 		LevelSystem& levelSystem = GameBase::get().getLevelSystem();
@@ -854,7 +830,7 @@ namespace SA
 
 	
 
-	bool Particle::KeyFrameChain::update(MutableEffectData& meData, float timeAliveSecs)
+	bool Particle::KeyFrameChain::update(MutableEffectData& meData, float timeAliveSecs) const
 	{
 		bool bFloatsDone = updateFrames<float>(meData.floatsArray, floatKeyFrames, timeAliveSecs);
 		bool bVec3Done = updateFrames<glm::vec3>(meData.vec3Array, vec3KeyFrames, timeAliveSecs);
@@ -13,6 +13,7 @@
 #include "GameFramework/SAGameEntity.h"
 #include "Tools/DataStructures/SATransform.h"
 #include "Game/AssetConfigs/SAConfigBase.h"
+#include "GameFramework/EngineParticles/ParticleInstanceData.h"
 
 #define DISABLE_PARTICLE_SYSTEM 0
 
@@ -22,6 +23,7 @@ namespace SA
 	class ShapeMesh;
 	class Shader;
 	class Window;
+	struct RenderData;
 
 	class ActiveParticleGroup;
 	struct MutableEffectData;
@@ -33,39 +35,6 @@ namespace SA
 	}
 
 	
-	/////////////////////////////////////////////////////////////////////////////////////
-	// Structure for storing arbitrary instance data.
-	//
-	// Instanced data allows rendering a large number of objects (models, meshes) with a single draw call.
-	// 
-	//		NOTE: for performance, vector.reserve() an estimate of the number of instances 
-	/////////////////////////////////////////////////////////////////////////////////////
-	struct EffectInstanceData
-	{
-		friend class ParticleSystem; //allow particle system to view this as a struct
-
-		sp<Particle::Effect> effectData; 
-
-		//order for which data is applied vertex attributes is the top-to-bottom order of this class.
-		size_t numMat4PerInstance = 1; //#TODO increment in custom steps
-		std::vector<glm::mat4> mat4Data;
-
-		size_t numVec4PerInstance = 1; //#TODO increment in custom steps
-		std::vector<glm::vec4> vec4Data;
-
-		//#TODO #BEFORE_SUBMIT make sure these vectors get size reserved somewhere; before tick? after tick to see actual size? init?
-		std::vector<float> timeAlive;
-		size_t numInstancesThisFrame = 0;
- 
-		void clearFrameData()
-		{
-			numInstancesThisFrame = 0;
-			timeAlive.clear();
-			mat4Data.clear();
-			vec4Data.clear();
-		}
-	};
-
 	namespace Particle
 	{
 		template<typename T>
@@ -91,10 +60,11 @@ namespace SA
 			std::vector<KeyFrame<glm::vec4>> vec4KeyFrames;
 			std::vector<KeyFrame<glm::mat4>> mat4KeyFrames;
 
-			bool update(MutableEffectData& particle, float timeAliveSecs);
+			/** Evaluates a single particle's chain; the particle system evaluates compiled chains for every instance at once instead (see CompiledKeyFrames) */
+			bool update(MutableEffectData& particle, float timeAliveSecs) const;
 
 			template <typename T>
-			inline bool updateFrames(std::vector<T>& elementArray, std::vector<KeyFrame<T>> frames, float timeAlive);
+			inline static bool updateFrames(std::vector<T>& elementArray, const std::vector<KeyFrame<T>>& frames, float timeAlive);
 		};
 
 		/////////////////////////////////////////////////////////////////////////////////////
@@ -180,8 +150,6 @@ namespace SA
 
 		virtual std::string getRepresentativeFilePath() override;
 
-		/* Generates data for the effect that can be manipulated over time */
-		void generateMutableEffectData(std::vector<MutableEffectData>& outEffectData) const;
 		float getDurationSecs();
 
 		void handleDirtyValues();
@@ -226,7 +194,6 @@ namespace SA
 		// data
 		////////////////////////////////////////////////////////
 	private:
-		std::vector<MutableEffectData> mutableEffectData;
 		sp<ParticleConfig> particle{ nullptr };
 		std::optional<glm::vec3> velocity;
 		float timeAlive = 0.f;
@@ -269,12 +236,16 @@ namespace SA
 
 		wp<ActiveParticleGroup> spawnParticle(const SpawnParams& params);
 
+		/** Copies this frame's instance buffers into the frame's render data; render only draws from that copy */
+		void cacheRenderData(RenderData& frameRenderData) const;
+
 	private:
 		virtual void postConstruct() override;
 		virtual void initSystem() override;
 		virtual void shutdown() override;
 		virtual void tick(float deltaSec) override;
 		inline bool updateActiveParticleGroup(ActiveParticleGroup& particleGroup, float dt_sec_world);
+		void updateInstanceData();
 		void handleRenderDispatch(float deltaSec);
 		void handlePostGameloopTick(float deltaSec);
 
@@ -298,8 +269,8 @@ namespace SA
 		std::map<sp<Shader>, size_t> shaderToInstanceDataIndex;
 
 		/////////////////////////////////////////////////////////////////////////////////////
-		// data for instanced rendering; the contained data is cleared and regenerated each 
-		// frame and used for drawing a large number of particles. 
+		// data for instanced rendering; the contained data is regenerated each frame and 
+		// used for drawing a large number of particles. 
 		/////////////////////////////////////////////////////////////////////////////////////
 		std::vector<EffectInstanceData> instancedEffectsData;
 		std::optional<unsigned int> instanceMat4VBO_opt;
@@ -363,11 +334,11 @@ namespace SA
 
 
 	template <typename T>
-	inline bool Particle::KeyFrameChain::updateFrames(std::vector<T>& elementArray, std::vector<Particle::KeyFrame<T>> frames, float timeAlive)
+	inline bool Particle::KeyFrameChain::updateFrames(std::vector<T>& elementArray, const std::vector<Particle::KeyFrame<T>>& frames, float timeAlive)
 	{
 		bool frameTypeIsDone = true;
 		float chainTime = 0;
-		for (Particle::KeyFrame<T>& thisKF : frames)
+		for (const Particle::KeyFrame<T>& thisKF : frames)
 		{
 			//find chain for this time
 			if (timeAlive <= thisKF.durationSec + chainTime)
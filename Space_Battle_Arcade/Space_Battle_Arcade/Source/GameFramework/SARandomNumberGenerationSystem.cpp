@@ -47,6 +47,13 @@ namespace SA
 		}
 	}
 
+	void RNGSystem::reseed(uint32_t seed)
+	{
+		rootNamedRNG = sp<RNG>(new RNG{ std::initializer_list<uint32_t> {seed, 54u, 11u, 29u, 0u} });
+		rootTimeInfluencedRNG = sp<RNG>(new RNG{ std::initializer_list<uint32_t> {seed, 3u, 107u, 67u, 9u} });
+		namedGenerators.clear();
+	}
+
 	sp<RNG> RNGSystem::createNewRNG(sp<RNG>& seedSrcRNG)
 	{
 		uint32_t seed = seedSrcRNG->getInt<uint32_t>();
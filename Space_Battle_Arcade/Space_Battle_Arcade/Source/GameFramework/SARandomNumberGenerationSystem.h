@@ -39,6 +39,9 @@ namespace SA
 		sp<RNG> getNamedRNG(const std::string rngName);
 		sp<RNG> getSeededRNG(uint32_t seed);
 
+		/** Restarts the root generators from seed and forgets named generators. Generators handed out before this keep their old sequence. */
+		void reseed(uint32_t seed);
+
 	protected:
 		virtual void postConstruct() override;
 	private:
@@ -14,37 +14,61 @@ namespace SA
 	void RenderSystem::initSystem()
 	{
 		const EngineConstants& constants = GameBase::getConstants();
-		renderFrameCircularBuffer.reserve(constants.RENDER_DELAY_FRAMES);
-
-		//+1 because we need a 0 frame data
-		for (uint64_t frameDataIdx = 0; frameDataIdx < (constants.RENDER_DELAY_FRAMES + 1); ++frameDataIdx)
-		{
-			renderFrameCircularBuffer.push_back(new_sp<RenderData>());
-		}
+		renderFrameRing = new_sp<RenderFrameRing>(constants.MAX_DIR_LIGHTS);
+		setRenderDelayFrames(uint8_t(std::max<int8_t>(constants.RENDER_DELAY_FRAMES, 0)));
 
 		forwardRenderer = new_sp<ForwardRenderingStateMachine>();
 
 		amort_PointLight_GC.chunkSize = 10;
 	}
 
-	RenderData* RenderSystem::getFrameRenderData(uint64_t frameNumber)
+	const RenderData* RenderSystem::getFrameRenderData_Read(uint64_t frameNumber)
+	{
+		return &renderFrameRing->read(frameNumber);
+	}
+
+	RenderData* RenderSystem::getFrameRenderData_Write(uint64_t frameNumber, const GamebaseIdentityKey& privateKey)
+	{
+		return &renderFrameRing->beginWrite(frameNumber);
+	}
+
+	void RenderSystem::setRenderDelayFrames(uint8_t delayFrames)
+	{
+		renderFrameRing->setDelayFrames(delayFrames);
+	}
+
+	uint8_t RenderSystem::getRenderDelayFrames() const
 	{
-		static GameBase& game = GameBase::get();
-		assert(frameNumber == game.getFrameNumber()); //do not yet support frame delayed rendering
-
-		//temporary, just return first item
-		return renderFrameCircularBuffer[0].get();
-
-		//#TODO #frame_delayed_rendering
-		//static uint64_t delayFrames = GameBase::getConstants().RENDER_DELAY_FRAMES;
-		//int8_t deltaFrame = int8_t(game.getFrameNumber() - frameNumber);
-		//if (deltaFrame <= delayFrames)
-		//{
-		//	TODO calculate wrap around or use some datastructure with wrap around built in; preferable the later? 
-		//}
-		//return nullptr;
-
-		//#TODO #frame_delayed_rendering note also, we're going to have to build a few frames data before rendering. Not sure where this will go.
+		return renderFrameRing->getDelayFrames();
+	}
+
+	void RenderSystem::cachePointLights(RenderData& frameRenderData)
+	{
+		adoptPendingPointLights();
+
+		LightClusterGrid& lightClusters = frameRenderData.lightClusters;
+		lightClusters.setLightBudget(GameBase::getConstants().MAX_POINT_LIGHTS);
+
+		for (const sp<PointLight_Deferred>& pointLight : userPointLights)
+		{
+			if (pointLight && pointLight->getUserData().bActive)
+			{
+				frameRenderData.addPointLight(*pointLight);
+
+				const RenderData::PointLightSnapshot& snapshot = frameRenderData.pointLights.back();
+				const glm::vec3& diffuse = snapshot.userData.diffuseIntensity;
+				lightClusters.addLight(snapshot.userData.position, snapshot.maxRadius, diffuse.r + diffuse.g + diffuse.b);
+			}
+		}
+
+		if (frameRenderData.bHasCameraFrustum)
+		{
+			lightClusters.bin(frameRenderData.view, frameRenderData.projection);
+		}
+		else
+		{
+			lightClusters.acceptAll();
+		}
 	}
 
 	void RenderSystem::enableDeferredRenderer(bool bEnable)
@@ -77,6 +101,8 @@ namespace SA
 		// right now just doing this because it is a simple way to solve the problem of letting users create pointlights 
 		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		{
+			adoptPendingPointLights();
+
 			static std::vector<size_t> pointLight_gcIndices;
 			pointLight_gcIndices.reserve(amort_PointLight_GC.chunkSize);
 			pointLight_gcIndices.clear();
@@ -114,11 +140,20 @@ namespace SA
 	{
 		sp<PointLight_Deferred> newPointLight = new_sp<PointLight_Deferred>(PointLight_Deferred::PrivateConstructionKey{});
 
-		userPointLights.push_back(newPointLight);
+		//tick may be walking the live lights on a worker, so new lights wait in a staging list
+		std::lock_guard<std::mutex> lock(pendingPointLightsMutex);
+		pendingPointLights.push_back(newPointLight);
 
 		return newPointLight;
 	}
 
+	void RenderSystem::adoptPendingPointLights()
+	{
+		std::lock_guard<std::mutex> lock(pendingPointLightsMutex);
+		userPointLights.insert(userPointLights.end(), pendingPointLights.begin(), pendingPointLights.end());
+		pendingPointLights.clear();
+	}
+
 	bool RenderSystem::isUsingHDR()
 	{
 		if (deferredRenderer) { return true; }
@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <mutex>
 #include "GameFramework/SASystemBase.h"
 #include "Tools/Algorithms/AmortizeLoopTool.h"
 #include "Tools/DataStructures/SATransform.h"
@@ -7,6 +8,7 @@
 namespace SA
 {
 	struct RenderData;
+	class RenderFrameRing;
 	struct GamebaseIdentityKey;
 	class GameBase;
 
@@ -26,28 +28,42 @@ namespace SA
 	class RenderSystem final : public SystemBase
 	{
 	public:
-		/** Subclasses of GameBase can write to a frames data, whereas everyone else can only read from the data */
-		const RenderData* getFrameRenderData_Read(uint64_t frameNumber)														{ return getFrameRenderData(frameNumber); }
-		RenderData*		  getFrameRenderData_Write(uint64_t frameNumber, const GamebaseIdentityKey& privateKey)		{ return getFrameRenderData(frameNumber); }
+		/** Subclasses of GameBase can write to a frames data, whereas everyone else can only read from the data.
+			Reads return the snapshot that is RENDER_DELAY_FRAMES behind; writing resets the frame's snapshot. */
+		const RenderData* getFrameRenderData_Read(uint64_t frameNumber);
+		RenderData*		  getFrameRenderData_Write(uint64_t frameNumber, const GamebaseIdentityKey& privateKey);
+
+		/** Frames render lags the simulation by, clamped to [0, RenderFrameRing::MAX_DELAY_FRAMES].
+			Render only reads the snapshot, so the simulation is free to move or destroy entities of the frame being drawn. */
+		void setRenderDelayFrames(uint8_t delayFrames);
+		uint8_t getRenderDelayFrames() const;
+
+		/** Snapshots the active point lights and bins them into view clusters; render reads the lights from the frame data */
+		void cachePointLights(RenderData& frameRenderData);
 
 		void enableDeferredRenderer(bool bEnable);
 		bool usingDeferredRenderer() { return deferredRenderer != nullptr; }
 		DeferredRendererStateMachine* getDeferredRenderer(){ return deferredRenderer.get(); };
 		ForwardRenderingStateMachine* getForwardRenderer() { return forwardRenderer.get(); }
-		const std::vector<sp<PointLight_Deferred>>& getFramePointLights() { return userPointLights; }
+		const std::vector<sp<PointLight_Deferred>>& getFramePointLights() { adoptPendingPointLights(); return userPointLights; }
+
+		/** Safe to call while the render system ticks; the light joins the live lights before the next use of them */
 		const sp<PointLight_Deferred> createPointLight();
 		bool isUsingHDR();
 	protected:
 		virtual void tick(float dt_sec) override;;
-	private:
-		/** Private to allow deciding whether to return this as constant data or mutable data.*/
-		RenderData* getFrameRenderData(uint64_t frameNumber);
+
+		/** Tick only garbage collects point lights this system owns; new lights are staged, so it can run alongside the level tick */
+		virtual bool canTickConcurrently() const override { return true; }
 	private:
 		virtual void initSystem() override;
+		void adoptPendingPointLights();
 	private:
 		AmortizeLoopTool amort_PointLight_GC;
-		std::vector<sp<RenderData>> renderFrameCircularBuffer;
-		std::vector<sp<PointLight_Deferred>> userPointLights; //#todo if end up saving previous frame data (ie the circular buffer) then these need their state saved each frame (ie just copy struct into RenderData struct)
+		sp<RenderFrameRing> renderFrameRing = nullptr;
+		std::vector<sp<PointLight_Deferred>> userPointLights; //live lights; their state is copied into each frame's RenderData
+		std::vector<sp<PointLight_Deferred>> pendingPointLights; //created since the live lights were last used; guarded by pendingPointLightsMutex
+		std::mutex pendingPointLightsMutex;
 		sp<DeferredRendererStateMachine> deferredRenderer = nullptr;
 		sp<ForwardRenderingStateMachine> forwardRenderer = nullptr;
 	};
@@ -19,6 +19,9 @@ namespace SA
 
 		virtual void tick(float deltaSec){};
 
+		/** Return true if tick only touches this system's own data; it will then run as a job while the other systems tick. */
+		virtual bool canTickConcurrently() const { return false; }
+
 		/** Called when main game systems can safely be accessed; though not all may be initialized */
 		virtual void initSystem() {};
 
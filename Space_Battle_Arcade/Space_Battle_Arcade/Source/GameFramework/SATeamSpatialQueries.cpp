@@ -0,0 +1,313 @@
+#include "GameFramework/SATeamSpatialQueries.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtx/norm.hpp>
+
+#include "GameFramework/Components/GameplayComponents.h"
+#include "GameFramework/SAWorldEntity.h"
+
+namespace SA
+{
+	/** A cone capped at maxDistance, with how far it reaches along each axis so whole branches of a tree can be skipped */
+	struct TeamSpatialQueries::ConeBounds
+	{
+		glm::vec3 apex;
+		glm::vec3 dir_n;
+		float cosHalfAngle;
+		float maxDistance2;
+		glm::vec3 minExtent;
+		glm::vec3 maxExtent;
+	};
+
+	void TeamSpatialQueries::addEntity(const sp<WorldEntity>& entity)
+	{
+		const TeamComponent* teamCom = entity ? entity->getGameComponent<TeamComponent>() : nullptr;
+		if (!teamCom || entityToEntry.find(entity.get()) != entityToEntry.end())
+		{
+			return;
+		}
+
+		uint32_t entryIdx = 0;
+		if (freeEntries.size() > 0)
+		{
+			entryIdx = freeEntries.back();
+			freeEntries.pop_back();
+		}
+		else
+		{
+			entryIdx = uint32_t(entries.size());
+			entries.emplace_back();
+		}
+
+		Entry& entry = entries[entryIdx];
+		entry.entity = entity;
+		entry.rawEntity = entity.get();
+		entry.serial = nextSerial++;
+		entry.team = teamCom->getTeam();
+
+		entityToEntry.insert({ entity.get(), entryIdx });
+	}
+
+	void TeamSpatialQueries::removeEntity(const WorldEntity* entity)
+	{
+		auto findResult = entityToEntry.find(entity);
+		if (findResult != entityToEntry.end())
+		{
+			const uint32_t entryIdx = findResult->second;
+			entityToEntry.erase(findResult);
+
+			//queries skip free entries; tree nodes may point here until the next refresh so don't hand the slot out yet
+			entries[entryIdx] = Entry{};
+			pendingFreeEntries.push_back(entryIdx);
+		}
+	}
+
+	void TeamSpatialQueries::clear()
+	{
+		entries.clear();
+		freeEntries.clear();
+		pendingFreeEntries.clear();
+		entityToEntry.clear();
+		treesByTeam.clear();
+	}
+
+	void TeamSpatialQueries::refresh()
+	{
+		for (std::vector<TreeNode>& tree : treesByTeam)
+		{
+			tree.clear();
+		}
+
+		for (uint32_t entryIdx = 0; entryIdx < entries.size(); ++entryIdx)
+		{
+			Entry& entry = entries[entryIdx];
+			if (!entry.rawEntity)
+			{
+				continue;
+			}
+			if (!entry.entity.isValid())
+			{
+				//destroyed without being unspawned; the address may be reused, so forget it now
+				removeEntity(entry.rawEntity);
+				continue;
+			}
+
+			if (const TeamComponent* teamCom = entry.rawEntity->getGameComponent<TeamComponent>())
+			{
+				entry.team = teamCom->getTeam();
+			}
+			if (treesByTeam.size() <= entry.team)
+			{
+				treesByTeam.resize(entry.team + 1);
+			}
+			treesByTeam[entry.team].push_back(TreeNode{ entry.rawEntity->getWorldPosition(), entryIdx, 0 });
+		}
+
+		//no node refers to removed entries anymore
+		freeEntries.insert(freeEntries.end(), pendingFreeEntries.begin(), pendingFreeEntries.end());
+		pendingFreeEntries.clear();
+
+		for (std::vector<TreeNode>& tree : treesByTeam)
+		{
+			buildTree(tree, 0, tree.size());
+		}
+	}
+
+	void TeamSpatialQueries::buildTree(std::vector<TreeNode>& nodes, size_t begin, size_t end)
+	{
+		if (end - begin <= 1)
+		{
+			return;
+		}
+
+		//split on the widest axis so clustered fleets still produce tight branches
+		glm::vec3 minPos = nodes[begin].position;
+		glm::vec3 maxPos = minPos;
+		for (size_t nodeIdx = begin + 1; nodeIdx < end; ++nodeIdx)
+		{
+			minPos = glm::min(minPos, nodes[nodeIdx].position);
+			maxPos = glm::max(maxPos, nodes[nodeIdx].position);
+		}
+		const glm::vec3 extent = maxPos - minPos;
+		const uint32_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+		const size_t mid = begin + (end - begin) / 2;
+		std::nth_element(nodes.begin() + begin, nodes.begin() + mid, nodes.begin() + end,
+			[axis](const TreeNode& a, const TreeNode& b) { return a.position[axis] < b.position[axis]; });
+		nodes[mid].axis = axis;
+
+		buildTree(nodes, begin, mid);
+		buildTree(nodes, mid + 1, end);
+	}
+
+	size_t TeamSpatialQueries::kNearestEnemies(const glm::vec3& position, size_t team, size_t k, float maxDistance, QueryScratch& scratch, std::vector<Hit>& outHits, const Filter& filter /*= nullptr*/) const
+	{
+		return kNearest(position, team, true, k, maxDistance, scratch, outHits, filter);
+	}
+
+	size_t TeamSpatialQueries::kNearestAllies(const glm::vec3& position, size_t team, size_t k, float maxDistance, QueryScratch& scratch, std::vector<Hit>& outHits, const Filter& filter /*= nullptr*/) const
+	{
+		return kNearest(position, team, false, k, maxDistance, scratch, outHits, filter);
+	}
+
+	size_t TeamSpatialQueries::kNearest(const glm::vec3& position, size_t team, bool bEnemies, size_t k, float maxDistance, QueryScratch& scratch, std::vector<Hit>& outHits, const Filter& filter) const
+	{
+		outHits.clear();
+		std::vector<RankedHit>& heap = scratch.rankedHits;
+		heap.clear();
+		if (k == 0)
+		{
+			return 0;
+		}
+
+		//a max heap, so the worst of the best k is on top
+		for (size_t treeTeam = 0; treeTeam < treesByTeam.size(); ++treeTeam)
+		{
+			if ((treeTeam != team) == bEnemies)
+			{
+				const std::vector<TreeNode>& tree = treesByTeam[treeTeam];
+				nearestInTree(tree, 0, tree.size(), position, k, maxDistance * maxDistance, heap, filter);
+			}
+		}
+
+		std::sort_heap(heap.begin(), heap.end(), &TeamSpatialQueries::isCloser);
+		for (const RankedHit& hit : heap)
+		{
+			outHits.push_back(hit.first);
+		}
+		return outHits.size();
+	}
+
+	void TeamSpatialQueries::nearestInTree(const std::vector<TreeNode>& nodes, size_t begin, size_t end, const glm::vec3& position, size_t k, float maxDistance2, std::vector<RankedHit>& heap, const Filter& filter) const
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		const size_t mid = begin + (end - begin) / 2;
+		const TreeNode& node = nodes[mid];
+		const Entry& entry = entries[node.entryIdx];
+
+		RankedHit candidate{ Hit{ entry.rawEntity, glm::distance2(node.position, position) }, entry.serial };
+		if (entry.rawEntity && candidate.first.distance2 <= maxDistance2 && (!filter || filter(*entry.rawEntity)))
+		{
+			if (heap.size() < k)
+			{
+				heap.push_back(candidate);
+				std::push_heap(heap.begin(), heap.end(), &TeamSpatialQueries::isCloser);
+			}
+			else if (isCloser(candidate, heap.front()))
+			{
+				std::pop_heap(heap.begin(), heap.end(), &TeamSpatialQueries::isCloser);
+				heap.back() = candidate;
+				std::push_heap(heap.begin(), heap.end(), &TeamSpatialQueries::isCloser);
+			}
+		}
+
+		const float planeOffset = position[node.axis] - node.position[node.axis];
+		const bool bNearIsLow = planeOffset < 0.f;
+		nearestInTree(nodes, bNearIsLow ? begin : mid + 1, bNearIsLow ? mid : end, position, k, maxDistance2, heap, filter);
+
+		//the far side can only help if the splitting plane is closer than the worst accepted hit (ties included, they may win on serial)
+		const float worstAccepted2 = heap.size() == k ? heap.front().first.distance2 : maxDistance2;
+		if (planeOffset * planeOffset <= worstAccepted2)
+		{
+			nearestInTree(nodes, bNearIsLow ? mid + 1 : begin, bNearIsLow ? end : mid, position, k, maxDistance2, heap, filter);
+		}
+	}
+
+	void TeamSpatialQueries::kNearestEnemies(const std::vector<NearestQuery>& queries, QueryScratch& scratch, std::vector<Hit>& outHits, std::vector<size_t>& outOffsets, const Filter& filter /*= nullptr*/) const
+	{
+		outHits.clear();
+		outOffsets.clear();
+		outOffsets.reserve(queries.size() + 1);
+
+		std::vector<Hit>& queryHits = scratch.queryHits;
+		for (const NearestQuery& query : queries)
+		{
+			outOffsets.push_back(outHits.size());
+			kNearestEnemies(query.position, query.team, query.k, query.maxDistance, scratch, queryHits, filter);
+			outHits.insert(outHits.end(), queryHits.begin(), queryHits.end());
+		}
+		outOffsets.push_back(outHits.size());
+	}
+
+	size_t TeamSpatialQueries::enemiesInCone(const glm::vec3& apex, const glm::vec3& dir_n, float halfAngleRad, size_t team, float maxDistance, QueryScratch& scratch, std::vector<Hit>& outHits, const Filter& filter /*= nullptr*/) const
+	{
+		outHits.clear();
+		std::vector<RankedHit>& hits = scratch.rankedHits;
+		hits.clear();
+
+		ConeBounds cone;
+		cone.apex = apex;
+		cone.dir_n = dir_n;
+		cone.cosHalfAngle = std::cos(halfAngleRad);
+		cone.maxDistance2 = maxDistance * maxDistance;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			//furthest the cone reaches along +axis and -axis: the direction inside the cone closest to that axis
+			const float angleToPositive = std::acos(glm::clamp(dir_n[axis], -1.f, 1.f));
+			const float angleToNegative = glm::pi<float>() - angleToPositive;
+			cone.maxExtent[axis] = apex[axis] + maxDistance * std::cos(glm::min(glm::max(angleToPositive - halfAngleRad, 0.f), glm::pi<float>()));
+			cone.minExtent[axis] = apex[axis] - maxDistance * std::cos(glm::min(glm::max(angleToNegative - halfAngleRad, 0.f), glm::pi<float>()));
+			cone.maxExtent[axis] = glm::max(cone.maxExtent[axis], apex[axis]); //the apex itself is in the cone
+			cone.minExtent[axis] = glm::min(cone.minExtent[axis], apex[axis]);
+		}
+
+		for (size_t treeTeam = 0; treeTeam < treesByTeam.size(); ++treeTeam)
+		{
+			if (treeTeam != team)
+			{
+				const std::vector<TreeNode>& tree = treesByTeam[treeTeam];
+				coneInTree(tree, 0, tree.size(), cone, hits, filter);
+			}
+		}
+
+		std::sort(hits.begin(), hits.end(), &TeamSpatialQueries::isCloser);
+		for (const RankedHit& hit : hits)
+		{
+			outHits.push_back(hit.first);
+		}
+		return outHits.size();
+	}
+
+	void TeamSpatialQueries::coneInTree(const std::vector<TreeNode>& nodes, size_t begin, size_t end, const ConeBounds& cone, std::vector<RankedHit>& hits, const Filter& filter) const
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		const size_t mid = begin + (end - begin) / 2;
+		const TreeNode& node = nodes[mid];
+		const Entry& entry = entries[node.entryIdx];
+
+		const glm::vec3 toNode = node.position - cone.apex;
+		const float distance2 = glm::length2(toNode);
+		if (entry.rawEntity
+			&& distance2 <= cone.maxDistance2
+			&& (distance2 == 0.f || glm::dot(toNode, cone.dir_n) >= cone.cosHalfAngle * std::sqrt(distance2))
+			&& (!filter || filter(*entry.rawEntity)))
+		{
+			hits.push_back(RankedHit{ Hit{ entry.rawEntity, distance2 }, entry.serial });
+		}
+
+		const float split = node.position[node.axis];
+		if (cone.minExtent[node.axis] <= split)
+		{
+			coneInTree(nodes, begin, mid, cone, hits, filter);
+		}
+		if (cone.maxExtent[node.axis] >= split)
+		{
+			coneInTree(nodes, mid + 1, end, cone, hits, filter);
+		}
+	}
+
+	bool TeamSpatialQueries::isCloser(const RankedHit& a, const RankedHit& b)
+	{
+		return a.first.distance2 < b.first.distance2 || (a.first.distance2 == b.first.distance2 && a.second < b.second);
+	}
+}
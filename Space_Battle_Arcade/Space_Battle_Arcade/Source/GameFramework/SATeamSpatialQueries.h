@@ -0,0 +1,114 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "GameFramework/SAGameEntity.h"
+#include "Tools/DataStructures/AdvancedPtrs.h"
+#include "Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	class WorldEntity;
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Team partitioned spatial queries over a level's world entities.
+	//
+	// Every entity with a TeamComponent is tracked incrementally (add on spawn, remove on unspawn). refresh() re-reads
+	// positions and teams once per tick and rebuilds a balanced kd tree per team over the packed positions. Ships move every
+	// tick, so rebuilding (n log n over a flat array) is cheaper than keeping a dynamic tree balanced. Queries then walk only
+	// the branches that can hold an answer, roughly O(log n + k) instead of walking every entity.
+	//
+	// Queries see the world as of the last refresh; entities added since then show up after the next one.
+	// Results are raw pointers; they are valid until the entity is removed (ie unspawned).
+	// Ties in distance are broken by the order entities were added, so results do not depend on allocation addresses.
+	// Queries keep no state of their own; the caller passes in working memory, so queries with separate scratch may run concurrently.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class TeamSpatialQueries final : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		struct Hit
+		{
+			WorldEntity* entity = nullptr;
+			float distance2 = 0.f;
+		};
+
+		struct NearestQuery
+		{
+			glm::vec3 position{ 0.f };
+			size_t team = 0;
+			size_t k = 1;
+			float maxDistance = 0.f;
+		};
+
+		/** Optional extra test on candidates, eg to only accept ships */
+		using Filter = std::function<bool(const WorldEntity&)>;
+
+		using RankedHit = std::pair<Hit, uint64_t/*serial*/>;
+
+		/** Caller owned working memory for queries; keep one around (per caller or per thread) so steady state queries don't allocate */
+		struct QueryScratch
+		{
+			std::vector<RankedHit> rankedHits;
+			std::vector<Hit> queryHits;
+		};
+
+	public:
+		void addEntity(const sp<WorldEntity>& entity);
+		void removeEntity(const WorldEntity* entity);
+		void clear();
+
+		/** Picks up movement and team changes; call once per tick after entities have moved */
+		void refresh();
+
+		/** The k nearest entities not on `team` within maxDistance, nearest first. Returns number of hits written. */
+		size_t kNearestEnemies(const glm::vec3& position, size_t team, size_t k, float maxDistance, QueryScratch& scratch, std::vector<Hit>& outHits, const Filter& filter = nullptr) const;
+
+		/** Runs each query; hits for query i are outHits[outOffsets[i] .. outOffsets[i + 1]) */
+		void kNearestEnemies(const std::vector<NearestQuery>& queries, QueryScratch& scratch, std::vector<Hit>& outHits, std::vector<size_t>& outOffsets, const Filter& filter = nullptr) const;
+
+		/** The k nearest entities on `team` within maxDistance, nearest first, eg for healers looking for a friendly ship */
+		size_t kNearestAllies(const glm::vec3& position, size_t team, size_t k, float maxDistance, QueryScratch& scratch, std::vector<Hit>& outHits, const Filter& filter = nullptr) const;
+
+		/** Entities not on `team` within maxDistance whose direction from the apex is within halfAngleRad of dir_n; nearest first */
+		size_t enemiesInCone(const glm::vec3& apex, const glm::vec3& dir_n, float halfAngleRad, size_t team, float maxDistance, QueryScratch& scratch, std::vector<Hit>& outHits, const Filter& filter = nullptr) const;
+
+		size_t getNumEntities() const { return entityToEntry.size(); }
+
+	private:
+		struct Entry
+		{
+			fwp<WorldEntity> entity;
+			WorldEntity* rawEntity = nullptr; //null if this entry is free
+			uint64_t serial = 0; //add order; breaks distance ties deterministically
+			size_t team = 0;
+		};
+
+		/** Implicit tree: a range's median is its node, the halves before and after it are the children */
+		struct TreeNode
+		{
+			glm::vec3 position;
+			uint32_t entryIdx;
+			uint32_t axis;
+		};
+
+		struct ConeBounds;
+		static bool isCloser(const RankedHit& a, const RankedHit& b);
+
+		static void buildTree(std::vector<TreeNode>& nodes, size_t begin, size_t end);
+		size_t kNearest(const glm::vec3& position, size_t team, bool bEnemies, size_t k, float maxDistance, QueryScratch& scratch, std::vector<Hit>& outHits, const Filter& filter) const;
+		void nearestInTree(const std::vector<TreeNode>& nodes, size_t begin, size_t end, const glm::vec3& position, size_t k, float maxDistance2, std::vector<RankedHit>& heap, const Filter& filter) const;
+		void coneInTree(const std::vector<TreeNode>& nodes, size_t begin, size_t end, const ConeBounds& cone, std::vector<RankedHit>& hits, const Filter& filter) const;
+
+	private:
+		std::vector<Entry> entries;
+		std::vector<uint32_t> freeEntries;
+		std::vector<uint32_t> pendingFreeEntries; //reusable after the next refresh, once no tree node refers to them
+		std::unordered_map<const WorldEntity*, uint32_t> entityToEntry;
+		std::vector<std::vector<TreeNode>> treesByTeam; //index is team
+		uint64_t nextSerial = 0;
+	};
+}
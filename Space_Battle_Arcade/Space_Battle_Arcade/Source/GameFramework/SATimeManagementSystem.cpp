@@ -8,6 +8,7 @@
 #include "TimeManagement/TickGroupManager.h"
 #include "Tools/PlatformUtils.h"
 #include "GameFramework/SAGameBase.h"
+#include "GameFramework/SAJobSystem.h"
 
 namespace
 {
@@ -18,48 +19,6 @@ namespace
 namespace SA
 {
 
-	void Timer::reset()
-	{
-		durationSecs = 0.f;
-		currentTime = 0.f;
-		bLoop = false;
-		userCallback = nullptr;
-	}
-
-	void Timer::set(const sp<MultiDelegate<>>& inCallbackDelegate, float inDurationSecs, bool inbLoop, float delaySecs)
-	{
-		reset();
-		userCallback = inCallbackDelegate;
-		durationSecs = inDurationSecs;
-		bLoop = inbLoop;
-
-		//set the timer into negative region for the delay
-		currentTime = -delaySecs; 
-	}
-
-	bool Timer::update(float dt_dilatedSecs)
-	{
-		if (!userCallback) { return true; }
-		if (userCallback->numBound() == 0) { return true; }
-
-		currentTime += dt_dilatedSecs;
-
-		//if timer should have ticked twice in time-frame, then tick it twice.
-		//the alternative may cause unexpected behavior for user
-		while (currentTime > durationSecs)
-		{
-			userCallback->broadcast();
-			currentTime -= durationSecs;
-
-			if (!bLoop)
-			{
-				return true;
-			}
-		}
-
-		return false;
-	}
-
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Time Manager
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -87,14 +46,10 @@ namespace SA
 		//tick timers
 		////////////////////////////////////////////////////////
 		{
+			//only timers that come due are visited; everything else waits in the queue untouched
 			bTickingTimers = true;
-			for (const sp<Timer>& timer : timers)
-			{
-				if (timer->update(dt_dilatedSecs))
-				{
-					timersToRemoveWhenTickingOver.emplace_back(timer);
-				}
-			}
+			timerClockSecs += dt_dilatedSecs;
+			timers.fireExpired(timerClockSecs, timersToRemoveWhenTickingOver);
 			bTickingTimers = false;
 		}
 
@@ -124,7 +79,7 @@ namespace SA
 		{
 			if (MultiDelegate<>* delegateHandle = timer->getUserCallback().get())
 			{
-				timers.insert(timer);
+				timers.schedule(timer, timerClockSecs);
 				delegateToTimerMap.insert({ delegateHandle , timer });
 			}
 			else
@@ -161,8 +116,29 @@ namespace SA
 		////////////////////////////////////////////////////////
 		for (TickGroupEntry& tickGroup : tickGroups)
 		{
-			//delegate already cover subscription/removal edge cases, they do not need to be covered here. Just let someone attempt to register to event and it will be applied after broadcast.
+			if (tickGroup.concurrentTicks.empty())
+			{
+				//delegate already cover subscription/removal edge cases, they do not need to be covered here. Just let someone attempt to register to event and it will be applied after broadcast.
+				tickGroup.onTick->broadcast(dt_dilatedSecs);
+				continue;
+			}
+
+			//jobs hold copies of the owner and work, so handlers may add or remove concurrent ticks during the broadcast
+			JobSystem& jobSystem = GameBase::get().getJobSystem();
+			JobCounter concurrentWork;
+			for (const ConcurrentTick& concurrentTick : tickGroup.concurrentTicks)
+			{
+				if (sp<GameEntity> owner = concurrentTick.owner.lock())
+				{
+					jobSystem.run([owner, work = concurrentTick.work, dt_sec = dt_dilatedSecs]() { work(dt_sec); }, &concurrentWork);
+				}
+			}
 			tickGroup.onTick->broadcast(dt_dilatedSecs);
+			jobSystem.waitFor(concurrentWork);
+
+			tickGroup.concurrentTicks.erase(
+				std::remove_if(tickGroup.concurrentTicks.begin(), tickGroup.concurrentTicks.end(), [](const ConcurrentTick& concurrentTick) { return concurrentTick.owner.expired(); }),
+				tickGroup.concurrentTicks.end());
 		}
 	}
 
@@ -184,6 +160,7 @@ namespace SA
 			tickGroup.name = tgDef.name;
 			tickGroup.priority = tgDef.priority;
 			tickGroup.sortIdx = tgDef.sortIdx();
+			tickGroup.bConcurrent = tgDef.bConcurrent;
 			tickGroup.onTick = new_sp<MultiDelegate<float /*dt_sec*/>>(); //this makes copies shallow, which is what we want. Currently no copies should be possible.
 		}
 
@@ -239,7 +216,7 @@ namespace SA
 			timerInstance->set(callbackDelegate, durationSec, bLoop, delaySecs);
 
 			delegateToTimerMap.insert({ callbackDelegate.get(), timerInstance });
-			timers.insert(timerInstance);
+			timers.schedule(timerInstance, timerClockSecs);
 		}
 
 		return ETimerOperationResult::SUCCESS;
@@ -252,7 +229,7 @@ namespace SA
 		{
 			if (!bTickingTimers)
 			{
-				timers.remove(findResult->second);
+				timers.unschedule(*findResult->second);
 				timerPool.releaseInstance(findResult->second);
 
 				findResult->second->reset();
@@ -314,6 +291,36 @@ namespace SA
 		return *tickGroups[tickGroupData.sortIdx()].onTick;
 	}
 
+	void TimeManager::addConcurrentTick(const TickGroupDefinition& tickGroupData, const sp<GameEntity>& owner, const std::function<void(float /*dt_sec*/)>& work)
+	{
+#ifdef DEBUG_BUILD
+		assert(tickGroups.size() > tickGroupData.sortIdx() && tickGroupData.isRegistered());
+#endif 
+		TickGroupEntry& tickGroup = tickGroups[tickGroupData.sortIdx()];
+		if (!tickGroup.bConcurrent)
+		{
+			//only groups declared concurrent promise their event handlers can tolerate work running alongside them
+			log("TimeManager", LogLevel::LOG_ERROR, "Attempting to add concurrent work to a tick group that is not concurrent; work ignored.");
+			STOP_DEBUGGER_HERE();
+			return;
+		}
+		if (owner)
+		{
+			tickGroup.concurrentTicks.push_back(ConcurrentTick{ owner, work });
+		}
+	}
+
+	void TimeManager::removeConcurrentTicks(const TickGroupDefinition& tickGroupData, const sp<GameEntity>& owner)
+	{
+#ifdef DEBUG_BUILD
+		assert(tickGroups.size() > tickGroupData.sortIdx() && tickGroupData.isRegistered());
+#endif 
+		std::vector<ConcurrentTick>& concurrentTicks = tickGroups[tickGroupData.sortIdx()].concurrentTicks;
+		concurrentTicks.erase(
+			std::remove_if(concurrentTicks.begin(), concurrentTicks.end(), [&owner](const ConcurrentTick& concurrentTick) { return concurrentTick.owner.lock() == owner; }),
+			concurrentTicks.end());
+	}
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Time System
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -322,7 +329,7 @@ namespace SA
 	{
 		bUpdatingTime = true;
 
-		float currentTime = static_cast<float>(glfwGetTime());
+		float currentTime = fixedDeltaTimeSecs > 0.f ? lastFrameTime + fixedDeltaTimeSecs : static_cast<float>(glfwGetTime());
 		rawDeltaTimeSecs = currentTime - lastFrameTime;
 		rawDeltaTimeSecs = rawDeltaTimeSecs > MAX_DELTA_TIME_SECS ? MAX_DELTA_TIME_SECS : rawDeltaTimeSecs;
 		deltaTimeSecs = rawDeltaTimeSecs;
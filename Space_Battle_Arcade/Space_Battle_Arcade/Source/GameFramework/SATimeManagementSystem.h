@@ -3,11 +3,13 @@
 #include "GameFramework/SAGameEntity.h"
 #include <set>
 #include <string>
+#include <functional>
 #include "Tools/RemoveSpecialMemberFunctionUtils.h"
 #include "Tools/DataStructures/MultiDelegate.h"
 #include "Tools/DataStructures/IterableHashSet.h"
 #include <unordered_map>
 #include "GameFramework/Interfaces/SATickable.h"
+#include "GameFramework/TimeManagement/TimerQueue.h"
 
 namespace SA
 {
@@ -29,22 +31,6 @@ namespace SA
 		DEFERRED
 	};
 
-	struct Timer
-	{
-	public:
-		/* @returns true when timer is complete and should be removed */
-		bool update(float dt_sec_dilated);
-		void reset();
-		void set(const sp<MultiDelegate<>>& callbackDelegate, float duration, bool bLoop, float delaySecs);
-		const sp<MultiDelegate<>>& getUserCallback() { return userCallback; }
-
-	private:
-		float durationSecs = 0.f;
-		float currentTime = 0.f;
-		bool bLoop = false;
-		sp<MultiDelegate<>> userCallback;
-	};
-
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	//An object that manipulates time; this allows creating time systems based on the true time, but with effects like 
 	//time dilation and time stepping and setting timers influenced on those effects
@@ -75,6 +61,10 @@ namespace SA
 		inline bool isFrameStepping() const { return bFreezeTime && framesToStep > 0; }
 		MultiDelegate<float /*dt_sec*/>& getEvent(const TickGroupDefinition& tickGroupDeclaration);
 
+		/** Work for a concurrent tick group; it runs as a job while the group's event is broadcast, so it must not touch anything the event's handlers do. Removed once owner is destroyed. */
+		void addConcurrentTick(const TickGroupDefinition& tickGroupDeclaration, const sp<GameEntity>& owner, const std::function<void(float /*dt_sec*/)>& work);
+		void removeConcurrentTicks(const TickGroupDefinition& tickGroupDeclaration, const sp<GameEntity>& owner);
+
 	public: //timers
 		/** timer functions returning bool indicate success/failure */
 		ETimerOperationResult createTimer(const sp<MultiDelegate<>>& callbackDelegate, float durationSec, bool bLoop = false, float delaySecs = 0.f);
@@ -104,7 +94,9 @@ namespace SA
 
 		bool bTickingTimers = false;
 
-		IterableHashSet<sp<Timer>> timers;
+		/** dilated time that timer deadlines are measured in; double so long sessions do not lose short timers to rounding */
+		double timerClockSecs = 0.0;
+		TimerQueue timers;
 		std::unordered_map<MultiDelegate<>*, sp<Timer>> delegateToTimerMap;
 
 		////////////////////////////////////////////////////////
@@ -127,12 +119,19 @@ namespace SA
 		IterableHashSet<sp<ITickable>> pendingAddTickables;
 
 		//#todo perhaps replace ITickable and only have tick groups. I think ITickable currently has better performance.
+		struct ConcurrentTick
+		{
+			wp<GameEntity> owner;
+			std::function<void(float /*dt_sec*/)> work;
+		};
 		struct TickGroupEntry 
 		{
 			std::string name;
 			float priority = 0.f;
 			size_t sortIdx = 0;
+			bool bConcurrent = false;
 			sp<MultiDelegate<float /*dt_sec*/>> onTick = nullptr;
+			std::vector<ConcurrentTick> concurrentTicks;
 		};
 		std::vector<TickGroupEntry> tickGroups;
 	};
@@ -155,6 +154,8 @@ namespace SA
 		struct PrivateKey { private: friend class GameBase; PrivateKey() {}; };
 		void updateTime(PrivateKey);
 		void markManagerCritical(PrivateKey, sp<TimeManager>& manager);
+		/** When positive, each update advances time by exactly this step instead of reading the wall clock (headless runs) */
+		void setFixedDeltaTime(PrivateKey, float fixedDeltaSecs) { fixedDeltaTimeSecs = fixedDeltaSecs; }
 
 	public:
 		sp<TimeManager> createManager();
@@ -166,6 +167,7 @@ namespace SA
 		float rawDeltaTimeSecs = 0;
 		float deltaTimeSecs = 0.f;
 		float MAX_DELTA_TIME_SECS = 0.5f;
+		float fixedDeltaTimeSecs = 0.f;
 
 		bool bUpdatingTime = false;
 
@@ -26,6 +26,11 @@ namespace SA
 
 	void WindowSystem::tick(float deltaSec)
 	{
+		if (GameBase::isHeadless())
+		{
+			return; //glfw is never initialized without a window
+		}
+
 		glfwPollEvents();
 
 		if (focusedWindow)
@@ -25,6 +25,7 @@ namespace SA
 	*/
 	class WorldEntity : public GameplayComponentEntity, public Tickable
 	{
+		friend LevelBase;
 	public:
 		WorldEntity(Transform spawnTransform = Transform{})
 			: transform(spawnTransform)
@@ -38,6 +39,9 @@ namespace SA
 		virtual glm::vec3 getWorldPosition() const { return transform.position; } //#scenenodes todo update
 		glm::mat4 getModelMatrix() const { return transform.getModelMatrix(); } //#scenenodes todo update
 
+		/** Order this entity was spawned into its level, 0 if never spawned. Stable across runs, unlike addresses, so use it to order or tie-break entities. */
+		uint64_t getSpawnId() const { return spawnId; }
+
 	protected:
 		/** World returns a raw pointer because caching a world sp will often result cyclic references. 
 			A raw pointer should make a programmer think about how to safely cache it and find this message.*/
@@ -47,5 +51,13 @@ namespace SA
 
 	private:
 		Transform transform; //#TODO #scenenodes #componentize
+		uint64_t spawnId = 0;
+	};
+
+	/** Orders entities by spawn id, so walks over a level's entities happen in the same order every run */
+	struct SpawnOrder
+	{
+		template<typename A, typename B>
+		bool operator()(const sp<A>& a, const sp<B>& b) const { return a->getSpawnId() < b->getSpawnId(); }
 	};
 }
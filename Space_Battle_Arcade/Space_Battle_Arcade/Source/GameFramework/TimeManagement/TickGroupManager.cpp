@@ -22,7 +22,7 @@ namespace SA
 	}
 
 
-	TickGroupDefinition::TickGroupDefinition(const std::string& inGroupName, float inPriority) :name(inGroupName), priority(inPriority)
+	TickGroupDefinition::TickGroupDefinition(const std::string& inGroupName, float inPriority, bool bInConcurrent) :name(inGroupName), priority(inPriority), bConcurrent(bInConcurrent)
 	{
 		if (GameBase::get().getTickGroupManager().registerTickGroup(*this, TickGroupManager::TickGroupKey{}))
 		{
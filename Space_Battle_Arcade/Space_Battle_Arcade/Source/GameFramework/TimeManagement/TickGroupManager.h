@@ -7,15 +7,17 @@ namespace SA
 	/////////////////////////////////////////////////////////////////////////////////////
 	// Represents a named group that is ticked together. Priority determines tick order 
 	//  relative to other tick groups. This should be treated as plain old data.
+	//  Concurrent groups accept work that runs as jobs while the group's event is broadcast (see TimeManager::addConcurrentTick).
 	/////////////////////////////////////////////////////////////////////////////////////
 	struct TickGroupDefinition final
 	{
 	public:
-		TickGroupDefinition(const std::string& inGroupName, float inPriority);
+		TickGroupDefinition(const std::string& inGroupName, float inPriority, bool bInConcurrent = false);
 		bool isRegistered() const{ return bRegistered; } //registration sorts tick groups up front so that array only needs to be sorted once.
 	public:
 		std::string name;
 		float priority;
+		bool bConcurrent;
 		inline size_t sortIdx() const { return _sortIdx; }
 	private:
 		friend class TickGroupManager;
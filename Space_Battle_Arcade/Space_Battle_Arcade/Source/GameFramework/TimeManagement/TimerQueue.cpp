@@ -0,0 +1,148 @@
+#include "TimerQueue.h"
+
+namespace SA
+{
+	void Timer::reset()
+	{
+		durationSecs = 0.f;
+		delaySecs = 0.f;
+		bLoop = false;
+		userCallback = nullptr;
+		deadlineSecs = 0.0;
+		sequence = 0;
+		heapIdx = INVALID_HEAP_IDX;
+	}
+
+	void Timer::set(const sp<MultiDelegate<>>& inCallbackDelegate, float inDurationSecs, bool inbLoop, float inDelaySecs)
+	{
+		reset();
+		userCallback = inCallbackDelegate;
+		durationSecs = inDurationSecs;
+		bLoop = inbLoop;
+		delaySecs = inDelaySecs;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Timer Queue
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void TimerQueue::schedule(const sp<Timer>& timer, double clockSecs)
+	{
+		if (timer->isScheduled())
+		{
+			unschedule(*timer);
+		}
+		timer->deadlineSecs = clockSecs + double(timer->delaySecs) + double(timer->durationSecs);
+		timer->sequence = nextSequence++;
+
+		heap.push_back(timer);
+		timer->heapIdx = heap.size() - 1;
+		siftUp(heap.size() - 1);
+	}
+
+	void TimerQueue::unschedule(Timer& timer)
+	{
+		if (!timer.isScheduled())
+		{
+			return;
+		}
+
+		size_t idx = timer.heapIdx;
+		timer.heapIdx = Timer::INVALID_HEAP_IDX;
+
+		sp<Timer> last = std::move(heap.back());
+		heap.pop_back();
+		if (idx < heap.size())
+		{
+			//fill the hole with the last timer; it may need to move either way
+			place(idx, last);
+			siftUp(idx);
+			siftDown(last->heapIdx);
+		}
+	}
+
+	void TimerQueue::fireExpired(double clockSecs, std::vector<sp<Timer>>& outFinished)
+	{
+		while (!heap.empty() && clockSecs > heap.front()->deadlineSecs)
+		{
+			sp<Timer> timer = heap.front(); //copy; broadcasts may unschedule or reorder the heap
+
+			if (!timer->userCallback || timer->userCallback->numBound() == 0)
+			{
+				unschedule(*timer);
+				outFinished.push_back(timer);
+				continue;
+			}
+
+			timer->userCallback->broadcast();
+			if (!timer->isScheduled())
+			{
+				continue; //the timer was released while broadcasting
+			}
+
+			if (timer->bLoop)
+			{
+				//zero length loops fire once per advance instead of spinning
+				timer->deadlineSecs = timer->durationSecs > 0.f ? timer->deadlineSecs + double(timer->durationSecs) : clockSecs;
+				siftDown(timer->heapIdx);
+			}
+			else
+			{
+				unschedule(*timer);
+				outFinished.push_back(timer);
+			}
+		}
+	}
+
+	bool TimerQueue::firesBefore(const Timer& a, const Timer& b) const
+	{
+		return a.deadlineSecs < b.deadlineSecs || (a.deadlineSecs == b.deadlineSecs && a.sequence < b.sequence);
+	}
+
+	void TimerQueue::place(size_t idx, const sp<Timer>& timer)
+	{
+		timer->heapIdx = idx;
+		heap[idx] = timer;
+	}
+
+	void TimerQueue::siftUp(size_t idx)
+	{
+		sp<Timer> timer = heap[idx];
+		while (idx > 0)
+		{
+			size_t parentIdx = (idx - 1) / 2;
+			if (!firesBefore(*timer, *heap[parentIdx]))
+			{
+				break;
+			}
+			place(idx, heap[parentIdx]);
+			idx = parentIdx;
+		}
+		place(idx, timer);
+	}
+
+	void TimerQueue::siftDown(size_t idx)
+	{
+		sp<Timer> timer = heap[idx];
+		const size_t count = heap.size();
+		while (true)
+		{
+			size_t childIdx = 2 * idx + 1;
+			if (childIdx >= count)
+			{
+				break;
+			}
+			if (childIdx + 1 < count && firesBefore(*heap[childIdx + 1], *heap[childIdx]))
+			{
+				++childIdx;
+			}
+			if (!firesBefore(*heap[childIdx], *timer))
+			{
+				break;
+			}
+			place(idx, heap[childIdx]);
+			idx = childIdx;
+		}
+		place(idx, timer);
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Tools/DataStructures/MultiDelegate.h"
+
+namespace SA
+{
+	struct Timer
+	{
+	public:
+		void reset();
+		void set(const sp<MultiDelegate<>>& callbackDelegate, float duration, bool bLoop, float delaySecs);
+		const sp<MultiDelegate<>>& getUserCallback() { return userCallback; }
+		bool isScheduled() const { return heapIdx != INVALID_HEAP_IDX; }
+
+	private:
+		friend class TimerQueue;
+		static constexpr size_t INVALID_HEAP_IDX = size_t(-1);
+
+		float durationSecs = 0.f;
+		float delaySecs = 0.f;
+		bool bLoop = false;
+		sp<MultiDelegate<>> userCallback;
+
+		/** in the owning queue's clock; only valid while scheduled */
+		double deadlineSecs = 0.0;
+		uint64_t sequence = 0;
+		size_t heapIdx = INVALID_HEAP_IDX;
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Min-heap of timers keyed on their deadline in a dilated clock owned by the caller.
+	//  Only timers that expire are touched when the clock advances, so thousands of pending
+	//  timers (AI services, fire rates, FX) cost nothing until they come due.
+	//  Timers with the same deadline fire in the order they were scheduled.
+	/////////////////////////////////////////////////////////////////////////////////////
+	class TimerQueue final
+	{
+	public:
+		/** deadline is clockSecs + delay + duration; the timer first fires once the clock passes it */
+		void schedule(const sp<Timer>& timer, double clockSecs);
+		void unschedule(Timer& timer);
+
+		/**
+			Broadcasts every timer whose deadline is behind clockSecs, earliest first. Looping timers are rescheduled and
+			fire again if more than one period fit in the elapsed time. Finished timers, and timers whose delegate has
+			nothing bound, are unscheduled and appended to outFinished for the owner to release.
+		*/
+		void fireExpired(double clockSecs, std::vector<sp<Timer>>& outFinished);
+
+		size_t size() const { return heap.size(); }
+		bool empty() const { return heap.empty(); }
+
+	private:
+		bool firesBefore(const Timer& a, const Timer& b) const;
+		void place(size_t idx, const sp<Timer>& timer);
+		void siftUp(size_t idx);
+		void siftDown(size_t idx);
+
+	private:
+		std::vector<sp<Timer>> heap;
+		uint64_t nextSequence = 0;
+	};
+}
@@ -0,0 +1,642 @@
+#include "GJKNarrowphase.h"
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#include "ReferenceCode/OpenGL/Algorithms/SeparatingAxisTheorem/SATComponent.h"
+
+namespace GJK
+{
+	using glm::vec3; using glm::vec4;
+
+	namespace
+	{
+		constexpr int MAX_GJK_ITERATIONS = 64;
+		constexpr int MAX_EPA_ITERATIONS = 64;
+		constexpr size_t MAX_EPA_VERTS = MAX_EPA_ITERATIONS + 4;
+		constexpr size_t MAX_EPA_FACES = 2 * MAX_EPA_VERTS;	//a closed triangle mesh has 2V - 4 faces
+		constexpr size_t MAX_EPA_HORIZON = 3 * MAX_EPA_FACES;
+
+		/** GJK stops when the support point improves the distance by less than this fraction */
+		constexpr float RELATIVE_TOLERANCE = 1e-6f;
+		/** Float rounding of dot products, relative to the size of the shapes; keeps GJK from chasing noise on nearly flat simplices */
+		constexpr float ROUNDING_TOLERANCE = 1e-5f;
+		/** EPA stops when the support point extends the closest face by less than this (scaled by the shapes' size) */
+		constexpr float EPA_TOLERANCE = 1e-4f;
+
+		/** A vertex of the Minkowski difference, remembering which point of each shape produced it */
+		struct SupportPoint
+		{
+			vec3 w;	//a - b
+			vec3 a;
+			vec3 b;
+		};
+
+		vec3 supportOf(const SAT::Shape& shape, const vec3& dir)
+		{
+			//linear scan; collision hulls are a handful of (deduplicated) points, so this beats any adjacency walk
+			const std::vector<vec4>& pnts = shape.getTransformedPoints();
+			size_t bestIdx = 0;
+			float bestProj = -std::numeric_limits<float>::infinity();
+			for (size_t pntIdx = 0; pntIdx < pnts.size(); ++pntIdx)
+			{
+				float proj = glm::dot(vec3(pnts[pntIdx]), dir);
+				if (proj > bestProj)
+				{
+					bestProj = proj;
+					bestIdx = pntIdx;
+				}
+			}
+			return vec3(pnts[bestIdx]);
+		}
+
+		SupportPoint support(const SAT::Shape& moving, const SAT::Shape& stationary, const vec3& dir)
+		{
+			SupportPoint pnt;
+			pnt.a = supportOf(moving, dir);
+			pnt.b = supportOf(stationary, -dir);
+			pnt.w = pnt.a - pnt.b;
+			return pnt;
+		}
+
+		float maxExtent2(const SAT::Shape& shape)
+		{
+			float result = 0.f;
+			for (const vec4& pnt : shape.getTransformedPoints())
+			{
+				result = glm::max(result, glm::dot(vec3(pnt), vec3(pnt)));
+			}
+			return result;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// Simplex: closest point to the origin, keeping only the vertices that support it
+		/////////////////////////////////////////////////////////////////////////////////////
+		struct Simplex
+		{
+			SupportPoint pnts[4];
+			float bary[4];
+			int size = 0;
+
+			void keep(std::initializer_list<std::pair<int, float>> kept)
+			{
+				SupportPoint oldPnts[4] = { pnts[0], pnts[1], pnts[2], pnts[3] };
+				size = 0;
+				for (const std::pair<int, float>& pair : kept)
+				{
+					pnts[size] = oldPnts[pair.first];
+					bary[size] = pair.second;
+					++size;
+				}
+			}
+
+			vec3 closestPoint() const
+			{
+				vec3 result(0.f);
+				for (int idx = 0; idx < size; ++idx) { result += bary[idx] * pnts[idx].w; }
+				return result;
+			}
+
+			void witnessPoints(vec3& outA, vec3& outB) const
+			{
+				outA = outB = vec3(0.f);
+				for (int idx = 0; idx < size; ++idx)
+				{
+					outA += bary[idx] * pnts[idx].a;
+					outB += bary[idx] * pnts[idx].b;
+				}
+			}
+
+			bool contains(const vec3& w) const
+			{
+				for (int idx = 0; idx < size; ++idx)
+				{
+					if (pnts[idx].w == w) { return true; }
+				}
+				return false;
+			}
+		};
+
+		void solveSegment(Simplex& simplex, int i0, int i1)
+		{
+			const vec3& a = simplex.pnts[i0].w;
+			const vec3& b = simplex.pnts[i1].w;
+			vec3 ab = b - a;
+			float abLen2 = glm::dot(ab, ab);
+			float t = abLen2 > 0.f ? glm::dot(-a, ab) / abLen2 : 0.f;
+			if (t <= 0.f)		{ simplex.keep({ { i0, 1.f } }); }
+			else if (t >= 1.f)	{ simplex.keep({ { i1, 1.f } }); }
+			else				{ simplex.keep({ { i0, 1.f - t }, { i1, t } }); }
+		}
+
+		/** Ericson's closest point on triangle, with the origin as the query point */
+		void solveTriangle(Simplex& simplex, int i0, int i1, int i2)
+		{
+			const vec3& a = simplex.pnts[i0].w;
+			const vec3& b = simplex.pnts[i1].w;
+			const vec3& c = simplex.pnts[i2].w;
+			vec3 ab = b - a, ac = c - a;
+
+			float d1 = glm::dot(ab, -a), d2 = glm::dot(ac, -a);
+			if (d1 <= 0.f && d2 <= 0.f) { simplex.keep({ { i0, 1.f } }); return; }
+
+			float d3 = glm::dot(ab, -b), d4 = glm::dot(ac, -b);
+			if (d3 >= 0.f && d4 <= d3) { simplex.keep({ { i1, 1.f } }); return; }
+
+			float vc = d1 * d4 - d3 * d2;
+			if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+			{
+				float v = d1 / (d1 - d3);
+				simplex.keep({ { i0, 1.f - v }, { i1, v } });
+				return;
+			}
+
+			float d5 = glm::dot(ab, -c), d6 = glm::dot(ac, -c);
+			if (d6 >= 0.f && d5 <= d6) { simplex.keep({ { i2, 1.f } }); return; }
+
+			float vb = d5 * d2 - d1 * d6;
+			if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+			{
+				float w = d2 / (d2 - d6);
+				simplex.keep({ { i0, 1.f - w }, { i2, w } });
+				return;
+			}
+
+			float va = d3 * d6 - d5 * d4;
+			if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+			{
+				float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+				simplex.keep({ { i1, 1.f - w }, { i2, w } });
+				return;
+			}
+
+			float sum = va + vb + vc;
+			if (sum <= 0.f)
+			{
+				//collinear triangle; the interior region does not exist so take the best edge
+				Simplex bestEdge;
+				float bestDist2 = std::numeric_limits<float>::infinity();
+				const int edges[3][2] = { { i0, i1 }, { i0, i2 }, { i1, i2 } };
+				for (const auto& edge : edges)
+				{
+					Simplex candidate = simplex;
+					solveSegment(candidate, edge[0], edge[1]);
+					vec3 closest = candidate.closestPoint();
+					if (glm::dot(closest, closest) < bestDist2)
+					{
+						bestDist2 = glm::dot(closest, closest);
+						bestEdge = candidate;
+					}
+				}
+				simplex = bestEdge;
+				return;
+			}
+			float v = vb / sum;
+			float w = vc / sum;
+			simplex.keep({ { i0, 1.f - v - w }, { i1, v }, { i2, w } });
+		}
+
+		/** Returns true if the origin is inside the tetrahedron. Tetrahedrons flatter than flatTolerance are treated as having no inside. */
+		bool solveTetrahedron(Simplex& simplex, float flatTolerance)
+		{
+			const int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };	//3 face verts then the opposite vert
+
+			bool bOutsideAnyFace = false;
+			bool bOutside[4];
+			for (int faceIdx = 0; faceIdx < 4; ++faceIdx)
+			{
+				const int* f = faces[faceIdx];
+				const vec3& a = simplex.pnts[f[0]].w;
+				vec3 n = glm::cross(simplex.pnts[f[1]].w - a, simplex.pnts[f[2]].w - a);
+				float originSide = glm::dot(n, -a);
+				float oppositeSide = glm::dot(n, simplex.pnts[f[3]].w - a);
+
+				//a flat tetrahedron has no inside; treat every face as a candidate
+				bOutside[faceIdx] = glm::abs(oppositeSide) <= flatTolerance * glm::length(n) || originSide * oppositeSide < 0.f;
+				bOutsideAnyFace |= bOutside[faceIdx];
+			}
+			if (!bOutsideAnyFace)
+			{
+				return true;
+			}
+
+			Simplex best;
+			float bestDist2 = std::numeric_limits<float>::infinity();
+			for (int faceIdx = 0; faceIdx < 4; ++faceIdx)
+			{
+				if (bOutside[faceIdx])
+				{
+					Simplex candidate = simplex;
+					solveTriangle(candidate, faces[faceIdx][0], faces[faceIdx][1], faces[faceIdx][2]);
+					vec3 closest = candidate.closestPoint();
+					if (glm::dot(closest, closest) < bestDist2)
+					{
+						bestDist2 = glm::dot(closest, closest);
+						best = candidate;
+					}
+				}
+			}
+			simplex = best;
+			return false;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// GJK
+		/////////////////////////////////////////////////////////////////////////////////////
+		enum class EGJKResult : uint8_t { SEPARATED, OVERLAPPING, EARLY_OUT };
+
+		struct GJKQuery
+		{
+			float earlyOutDistance = std::numeric_limits<float>::infinity();
+			bool bBooleanOnly = false;
+		};
+
+		/** On SEPARATED, simplex holds the closest feature. On EARLY_OUT, outLowerBound holds the proven minimum distance. */
+		EGJKResult runGJK(const SAT::Shape& moving, const SAT::Shape& stationary, const GJKQuery& query, Simplex& simplex, float& outLowerBound)
+		{
+			const float scale2 = glm::max(maxExtent2(moving), maxExtent2(stationary));
+			const float overlapTolerance2 = 1e-12f * glm::max(scale2, 1.f);
+			const float roundingTolerance = ROUNDING_TOLERANCE * 2.f * glm::sqrt(scale2);	//minkowski points are up to twice the extent
+			const float earlyOut2 = query.earlyOutDistance * query.earlyOutDistance;
+
+			simplex = Simplex{};
+			simplex.pnts[0] = support(moving, stationary, vec3(1.f, 0.f, 0.f));
+			simplex.bary[0] = 1.f;
+			simplex.size = 1;
+			vec3 v = simplex.pnts[0].w;
+
+			for (int iteration = 0; iteration < MAX_GJK_ITERATIONS; ++iteration)
+			{
+				float vLen2 = glm::dot(v, v);
+				if (vLen2 <= overlapTolerance2)
+				{
+					return EGJKResult::OVERLAPPING;
+				}
+
+				SupportPoint newPnt = support(moving, stationary, -v);
+				float vw = glm::dot(v, newPnt.w);
+
+				//v.w / |v| is a lower bound on the distance; once positive, -v is a separating direction
+				if (vw > 0.f)
+				{
+					if (query.bBooleanOnly)
+					{
+						return EGJKResult::SEPARATED;
+					}
+					if (vw * vw > earlyOut2 * vLen2)
+					{
+						outLowerBound = vw / glm::sqrt(vLen2);
+						return EGJKResult::EARLY_OUT;
+					}
+				}
+
+				if (vLen2 - vw <= RELATIVE_TOLERANCE * vLen2 + roundingTolerance * glm::sqrt(vLen2) || simplex.contains(newPnt.w))
+				{
+					//within rounding of the origin, or stalled without a separating direction, GJK cannot tell touching from overlapping; let EPA settle it
+					return vLen2 <= roundingTolerance * roundingTolerance || vw <= 0.f ? EGJKResult::OVERLAPPING : EGJKResult::SEPARATED;
+				}
+
+				simplex.pnts[simplex.size] = newPnt;
+				simplex.size++;
+				switch (simplex.size)
+				{
+					case 2: solveSegment(simplex, 0, 1); break;
+					case 3: solveTriangle(simplex, 0, 1, 2); break;
+					case 4: if (solveTetrahedron(simplex, roundingTolerance)) { return EGJKResult::OVERLAPPING; } break;
+				}
+				v = simplex.closestPoint();
+			}
+
+			//out of iterations; v is still the best estimate, report by whether it is meaningfully away from the origin
+			return glm::dot(v, v) <= overlapTolerance2 ? EGJKResult::OVERLAPPING : EGJKResult::SEPARATED;
+		}
+
+		void fillSeparated(const Simplex& simplex, ContactResult& outResult)
+		{
+			outResult.bColliding = false;
+			outResult.penetrationDepth = 0.f;
+			simplex.witnessPoints(outResult.pointOnMoving, outResult.pointOnStationary);
+			vec3 separation = outResult.pointOnMoving - outResult.pointOnStationary;
+			outResult.distance = glm::length(separation);
+			outResult.normal = outResult.distance > 0.f ? separation / outResult.distance : vec3(0.f);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// EPA
+		/////////////////////////////////////////////////////////////////////////////////////
+		struct EPAFace
+		{
+			uint8_t idx[3];
+			vec3 normal;
+			float dist;
+		};
+
+		struct EPAEdge
+		{
+			uint8_t a;
+			uint8_t b;
+		};
+
+		/** Grows a GJK simplex that ended touching or containing the origin into a tetrahedron. Returns false for flat shapes. */
+		bool buildTetrahedron(const SAT::Shape& moving, const SAT::Shape& stationary, Simplex& simplex, float tolerance)
+		{
+			static const vec3 axes[6] = { vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1) };
+
+			if (simplex.size == 1)
+			{
+				for (const vec3& axis : axes)
+				{
+					SupportPoint pnt = support(moving, stationary, axis);
+					if (glm::length(pnt.w - simplex.pnts[0].w) > tolerance)
+					{
+						simplex.pnts[simplex.size++] = pnt;
+						break;
+					}
+				}
+				if (simplex.size < 2) { return false; }
+			}
+
+			if (simplex.size == 2)
+			{
+				vec3 line = simplex.pnts[1].w - simplex.pnts[0].w;
+				vec3 lineDir = glm::normalize(line);
+
+				//search perpendicular to the segment, rotating around it 60 degrees at a time
+				vec3 leastAligned = glm::abs(lineDir.x) < 0.577f ? vec3(1, 0, 0) : (glm::abs(lineDir.y) < 0.577f ? vec3(0, 1, 0) : vec3(0, 0, 1));
+				vec3 perp = glm::normalize(glm::cross(lineDir, leastAligned));
+				vec3 perp2 = glm::cross(lineDir, perp);
+				for (int step = 0; step < 6 && simplex.size < 3; ++step)
+				{
+					float angle = glm::radians(60.f * step);
+					vec3 dir = glm::cos(angle) * perp + glm::sin(angle) * perp2;
+					SupportPoint pnt = support(moving, stationary, dir);
+					vec3 offset = pnt.w - simplex.pnts[0].w;
+					if (glm::length(offset - glm::dot(offset, lineDir) * lineDir) > tolerance)
+					{
+						simplex.pnts[simplex.size++] = pnt;
+					}
+				}
+				if (simplex.size < 3) { return false; }
+			}
+
+			if (simplex.size == 3)
+			{
+				vec3 n = glm::normalize(glm::cross(simplex.pnts[1].w - simplex.pnts[0].w, simplex.pnts[2].w - simplex.pnts[0].w));
+				for (const vec3& dir : { n, -n })
+				{
+					SupportPoint pnt = support(moving, stationary, dir);
+					if (glm::abs(glm::dot(n, pnt.w - simplex.pnts[0].w)) > tolerance)
+					{
+						simplex.pnts[simplex.size++] = pnt;
+						break;
+					}
+				}
+				if (simplex.size < 4) { return false; }
+			}
+			return true;
+		}
+
+		bool makeFace(const SupportPoint* verts, uint8_t a, uint8_t b, uint8_t c, EPAFace& outFace)
+		{
+			vec3 n = glm::cross(verts[b].w - verts[a].w, verts[c].w - verts[a].w);
+			float nLen = glm::length(n);
+			if (!(nLen > 0.f))
+			{
+				return false;
+			}
+			outFace.idx[0] = a; outFace.idx[1] = b; outFace.idx[2] = c;
+			outFace.normal = n / nLen;
+			outFace.dist = glm::dot(outFace.normal, verts[a].w);
+			return true;
+		}
+
+		void fillFromFace(const SupportPoint* verts, const EPAFace& face, ContactResult& outResult)
+		{
+			//barycentric coordinates of the origin's projection onto the face give the matching points on each shape
+			const SupportPoint& pa = verts[face.idx[0]];
+			const SupportPoint& pb = verts[face.idx[1]];
+			const SupportPoint& pc = verts[face.idx[2]];
+			vec3 p = face.normal * face.dist;
+			vec3 v0 = pb.w - pa.w, v1 = pc.w - pa.w, v2 = p - pa.w;
+			float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d11 = glm::dot(v1, v1);
+			float d20 = glm::dot(v2, v0), d21 = glm::dot(v2, v1);
+			float denom = d00 * d11 - d01 * d01;
+			float v = denom != 0.f ? (d11 * d20 - d01 * d21) / denom : 0.f;
+			float w = denom != 0.f ? (d00 * d21 - d01 * d20) / denom : 0.f;
+			float u = 1.f - v - w;
+
+			outResult.bColliding = true;
+			outResult.distance = 0.f;
+			outResult.penetrationDepth = glm::max(face.dist, 0.f);
+			outResult.normal = -face.normal; //face normal points out of the minkowski difference; moving has to go the other way
+			outResult.pointOnMoving = u * pa.a + v * pb.a + w * pc.a;
+			outResult.pointOnStationary = u * pa.b + v * pb.b + w * pc.b;
+		}
+
+		enum class EEPAExpansion : uint8_t { VALID, FOLDED, OVERFLOW };
+
+		/** Marks the faces the new vertex can see and builds the faces that close the hole they leave, without modifying the polytope */
+		EEPAExpansion planExpansion(const SupportPoint* verts, const EPAFace* faces, size_t numFaces, uint8_t newIdx, float visibleTolerance, float minFaceDist,
+			bool* outVisible, std::array<EPAEdge, MAX_EPA_HORIZON>& horizon, std::array<EPAFace, MAX_EPA_FACES>& outNewFaces, size_t& outNumNewFaces)
+		{
+			const vec3& newPnt = verts[newIdx].w;
+			size_t numHorizon = 0;
+			for (size_t faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+			{
+				const EPAFace& face = faces[faceIdx];
+				outVisible[faceIdx] = glm::dot(face.normal, newPnt - verts[face.idx[0]].w) > visibleTolerance;
+				if (!outVisible[faceIdx])
+				{
+					continue;
+				}
+				for (int edgeIdx = 0; edgeIdx < 3; ++edgeIdx)
+				{
+					EPAEdge edge{ face.idx[edgeIdx], face.idx[(edgeIdx + 1) % 3] };
+
+					//an edge shared with another visible face is interior to the hole
+					bool bShared = false;
+					for (size_t horizonIdx = 0; horizonIdx < numHorizon; ++horizonIdx)
+					{
+						if (horizon[horizonIdx].a == edge.b && horizon[horizonIdx].b == edge.a)
+						{
+							horizon[horizonIdx] = horizon[--numHorizon];
+							bShared = true;
+							break;
+						}
+					}
+					if (!bShared)
+					{
+						if (numHorizon == horizon.size()) { return EEPAExpansion::OVERFLOW; }
+						horizon[numHorizon++] = edge;
+					}
+				}
+			}
+
+			if (numHorizon > outNewFaces.size())
+			{
+				return EEPAExpansion::OVERFLOW;
+			}
+			outNumNewFaces = 0;
+			for (size_t horizonIdx = 0; horizonIdx < numHorizon; ++horizonIdx)
+			{
+				//the polytope only grows, so a new face closer than the face being expanded means it folded over a near coplanar neighbor
+				EPAFace& face = outNewFaces[outNumNewFaces++];
+				if (!makeFace(verts, horizon[horizonIdx].a, horizon[horizonIdx].b, newIdx, face) || face.dist < minFaceDist)
+				{
+					return EEPAExpansion::FOLDED;
+				}
+			}
+			return EEPAExpansion::VALID;
+		}
+
+		bool runEPA(const SAT::Shape& moving, const SAT::Shape& stationary, Simplex& simplex, ContactResult& outResult)
+		{
+			const float scale = glm::sqrt(glm::max(maxExtent2(moving), maxExtent2(stationary)));
+			const float tolerance = EPA_TOLERANCE * glm::max(scale, 1.f);
+			//minkowski differences of polytopes have many coplanar vertices; a face only counts as visible if the point is clearly in front of it,
+			//otherwise rounding can remove one of two coplanar faces and fold a new face back over the other
+			const float visibleTolerance = ROUNDING_TOLERANCE * 2.f * glm::max(scale, 1.f);
+
+			if (!buildTetrahedron(moving, stationary, simplex, tolerance))
+			{
+				return false;
+			}
+
+			std::array<SupportPoint, MAX_EPA_VERTS> verts;
+			std::array<EPAFace, MAX_EPA_FACES> faces;
+			std::array<EPAEdge, MAX_EPA_HORIZON> horizon;
+			std::array<EPAFace, MAX_EPA_FACES> newFaces;
+			std::array<bool, MAX_EPA_FACES> bVisible;
+			size_t numVerts = 4;
+			size_t numFaces = 0;
+			for (int idx = 0; idx < 4; ++idx) { verts[idx] = simplex.pnts[idx]; }
+
+			//wind the tetrahedron's faces so their normals point away from its interior
+			const vec3 centroid = 0.25f * (verts[0].w + verts[1].w + verts[2].w + verts[3].w);
+			const uint8_t tetraFaces[4][3] = { { 0, 1, 2 }, { 0, 3, 1 }, { 0, 2, 3 }, { 1, 3, 2 } };
+			for (const auto& tri : tetraFaces)
+			{
+				EPAFace face;
+				if (!makeFace(verts.data(), tri[0], tri[1], tri[2], face)) { return false; }
+				if (glm::dot(face.normal, centroid - verts[tri[0]].w) > 0.f)
+				{
+					makeFace(verts.data(), tri[0], tri[2], tri[1], face);
+				}
+				faces[numFaces++] = face;
+			}
+
+			size_t closestIdx = 0;
+			for (int iteration = 0; iteration < MAX_EPA_ITERATIONS; ++iteration)
+			{
+				closestIdx = 0;
+				for (size_t faceIdx = 1; faceIdx < numFaces; ++faceIdx)
+				{
+					if (faces[faceIdx].dist < faces[closestIdx].dist) { closestIdx = faceIdx; }
+				}
+				const EPAFace closest = faces[closestIdx];
+
+				SupportPoint newPnt = support(moving, stationary, closest.normal);
+				float newDist = glm::dot(newPnt.w, closest.normal);
+				if (newDist - closest.dist <= tolerance || numVerts == MAX_EPA_VERTS)
+				{
+					break;
+				}
+
+				//a near coplanar face is normally left in place; if that folds a new face back over it, count any face in front as visible
+				const uint8_t newIdx = uint8_t(numVerts);
+				verts[numVerts] = newPnt;
+				size_t numNewFaces = 0;
+				EEPAExpansion expansion = EEPAExpansion::FOLDED;
+				for (float threshold : { visibleTolerance, 0.f })
+				{
+					expansion = planExpansion(verts.data(), faces.data(), numFaces, newIdx, threshold, closest.dist - tolerance, bVisible.data(), horizon, newFaces, numNewFaces);
+					if (expansion != EEPAExpansion::FOLDED) { break; }
+				}
+
+				size_t numKept = 0;
+				for (size_t faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+				{
+					numKept += bVisible[faceIdx] ? 0 : 1;
+				}
+				if (expansion != EEPAExpansion::VALID || numKept + numNewFaces > faces.size() || numKept + numNewFaces == 0)
+				{
+					faces[0] = closest; //degenerate or beyond the fixed budget; settle for the closest face found
+					closestIdx = 0;
+					break;
+				}
+
+				numKept = 0;
+				for (size_t faceIdx = 0; faceIdx < numFaces; ++faceIdx)
+				{
+					if (!bVisible[faceIdx]) { faces[numKept++] = faces[faceIdx]; }
+				}
+				for (size_t newFaceIdx = 0; newFaceIdx < numNewFaces; ++newFaceIdx)
+				{
+					faces[numKept++] = newFaces[newFaceIdx];
+				}
+				numFaces = numKept;
+				++numVerts;
+			}
+
+			fillFromFace(verts.data(), faces[closestIdx], outResult);
+			return true;
+		}
+	}
+
+	bool intersects(const SAT::Shape& moving, const SAT::Shape& stationary)
+	{
+		Simplex simplex;
+		float lowerBound = 0.f;
+		GJKQuery query;
+		query.bBooleanOnly = true;
+		return runGJK(moving, stationary, query, simplex, lowerBound) == EGJKResult::OVERLAPPING;
+	}
+
+	bool closestPoints(const SAT::Shape& moving, const SAT::Shape& stationary, ContactResult& outResult, float earlyOutDistance)
+	{
+		Simplex simplex;
+		float lowerBound = 0.f;
+		GJKQuery query;
+		query.earlyOutDistance = earlyOutDistance;
+
+		outResult = ContactResult{};
+		switch (runGJK(moving, stationary, query, simplex, lowerBound))
+		{
+			case EGJKResult::OVERLAPPING:
+				outResult.bColliding = true;
+				return true;
+			case EGJKResult::EARLY_OUT:
+				outResult.distance = lowerBound;
+				return false;
+			case EGJKResult::SEPARATED:
+			default:
+				fillSeparated(simplex, outResult);
+				return outResult.distance <= earlyOutDistance;
+		}
+	}
+
+	bool penetration(const SAT::Shape& moving, const SAT::Shape& stationary, ContactResult& outResult)
+	{
+		Simplex simplex;
+		float lowerBound = 0.f;
+		GJKQuery query;
+
+		outResult = ContactResult{};
+		if (runGJK(moving, stationary, query, simplex, lowerBound) == EGJKResult::SEPARATED)
+		{
+			fillSeparated(simplex, outResult);
+			return false;
+		}
+
+		if (!runEPA(moving, stationary, simplex, outResult))
+		{
+			//flat or degenerate shapes that only touch; there is no volume to push out of
+			outResult.bColliding = true;
+			simplex.witnessPoints(outResult.pointOnMoving, outResult.pointOnStationary);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <limits>
+
+#include <glm/glm.hpp>
+
+namespace SAT
+{
+	class Shape;
+}
+
+namespace GJK
+{
+	/**
+		GJK + EPA narrowphase over the transformed points of SAT shapes.
+
+		Shapes are treated as the convex hull of their points, which is what SAT already assumes, so any SAT::Shape
+		(cubes, capsules, DynamicTriangleMeshShapes from the collision shape factory) works without conversion.
+		GJK searches the Minkowski difference (moving - stationary) with support points instead of generating
+		edge x edge axes; EPA expands the final GJK simplex to find the penetration depth when shapes overlap.
+
+		Everything runs on the stack; these functions do not allocate and are safe to call from concurrent stages.
+	*/
+
+	struct ContactResult
+	{
+		bool bColliding = false;
+
+		/** Unit direction to move the moving shape so it separates (colliding) or separates further (not colliding) */
+		glm::vec3 normal{ 0.f };
+
+		/** Only set when colliding */
+		float penetrationDepth = 0.f;
+
+		/** Only set when not colliding. After an early out this is a lower bound rather than the exact distance */
+		float distance = 0.f;
+
+		/** Deepest point of each shape inside the other when colliding; closest points when not colliding */
+		glm::vec3 pointOnMoving{ 0.f };
+		glm::vec3 pointOnStationary{ 0.f };
+
+		glm::vec3 getContactPoint() const { return 0.5f * (pointOnMoving + pointOnStationary); }
+
+		/** Same meaning as the SAT minimum translation vector, without SAT's correction factor */
+		glm::vec3 getMTV() const { return normal * penetrationDepth; }
+	};
+
+	/** Overlap test only; stops at the first separating direction */
+	bool intersects(const SAT::Shape& moving, const SAT::Shape& stationary);
+
+	/**
+		Separation distance, normal, and closest points. Overlapping shapes report bColliding with no depth (see penetration).
+		Returns false without refining further once the shapes are proven farther apart than earlyOutDistance.
+	*/
+	bool closestPoints(const SAT::Shape& moving, const SAT::Shape& stationary, ContactResult& outResult, float earlyOutDistance = std::numeric_limits<float>::infinity());
+
+	/** Full contact query. Returns true if colliding, with depth, normal, and contact points; otherwise fills in the separation like closestPoints */
+	bool penetration(const SAT::Shape& moving, const SAT::Shape& stationary, ContactResult& outResult);
+}
@@ -1,5 +1,9 @@
 #include "SATComponent.h"
 #include <glm/gtx/norm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <unordered_map>
 
 namespace SAT
 {
@@ -14,48 +18,209 @@ namespace SAT
 		return CollisionTest(moving, stationary, dummyMtv);
 	}
 
-	/*static*/ bool Shape::CollisionTest(const Shape& moving, const Shape& stationary, glm::vec4& outMTV)
+	namespace
 	{
-		//SAT collision test. 3d SAT requires not only the faces of the shape be tested, but
-		//also to test edge x edge pairs. Below you will see we get axes for faces and edgexedge pairs.
-		using std::vector; using glm::vec4; using glm::vec3;
+		/** Keeps the shortest overlap seen so far; the MTV vector is only built for the winning axis */
+		struct MTVAccumulator
+		{
+			glm::vec3 unitAxis = glm::vec3(0.0f);
+			float distance = 0.0f;
+
+			/** returns false if the axis separates the two projections */
+			bool overlapsOnAxis(const glm::vec3& axis, const SAT::ProjectionRange& movProj, const SAT::ProjectionRange& staProj)
+			{
+				bool disjoint = movProj.max < staProj.min || staProj.max < movProj.min;
+				if (disjoint)
+				{
+					return false;
+				}
 
-		vector<vec3> normalizedAxes;
-		normalizedAxes.clear();
-		normalizedAxes.reserve(moving.faces.size() + stationary.faces.size() + moving.edges.size() * stationary.edges.size());
+				/*vectors are known to overlap (not disjoint); certain assumptions can be made (eg no 0 len MTV)*/
+				float candidate = Shape::calculateMinimumTranslationDistance(movProj, staProj);
 
-		moving.appendFaceAxes(normalizedAxes);
-		stationary.appendFaceAxes(normalizedAxes);
-		appendEdgeXEdgeAxes(moving, stationary, normalizedAxes);
+				//float zero comparision should be safe in this case; it is just to catch first MTV
+				if (candidate * candidate < distance * distance || distance == 0.0f)
+				{
+					distance = candidate;
+					unitAxis = axis;
+				}
+				return true;
+			}
+		};
 
-		vec3 mtv(0.0f);		//mtv = minimum translation vector to get out of collision
-		for (const vec3& axis : normalizedAxes)
+		struct BoxProjector
 		{
-			SAT::ProjectionRange movProj = moving.projectToAxis(axis);
-			SAT::ProjectionRange staProj = stationary.projectToAxis(axis);
+			glm::vec3 center;
+			glm::vec3 halfEdges[3];
 
-			bool disjoint = movProj.max < staProj.min || staProj.max < movProj.min;
-			if (disjoint)
+			SAT::ProjectionRange operator()(const glm::vec3& normalizedAxis) const
 			{
-				outMTV = vec4(0.0f);
-				return false;
+				float centerProj = glm::dot(center, normalizedAxis);
+				float radius = glm::abs(glm::dot(halfEdges[0], normalizedAxis))
+							 + glm::abs(glm::dot(halfEdges[1], normalizedAxis))
+							 + glm::abs(glm::dot(halfEdges[2], normalizedAxis));
+				SAT::ProjectionRange range;
+				range.min = centerProj - radius;
+				range.max = centerProj + radius;
+				return range;
 			}
-			else /*vectors are known to overlap (not disjoint); certain assumptions can be made (eg no 0 len MTV)*/
+		};
+
+		struct PointProjector
+		{
+			const Shape& shape;
+			SAT::ProjectionRange operator()(const glm::vec3& normalizedAxis) const { return shape.projectToAxis(normalizedAxis); }
+		};
+
+		/**
+			Fixed capacity set of axes on the stack. Parallel and anti-parallel axes give the same overlap, so only the first is kept.
+			Axes are found through a small open addressed table keyed on the squared components, which an axis and its negation share,
+			snapped to a grid; a near duplicate that lands in another grid cell is simply tested again. Once full, axes are still looked
+			up but no longer stored.
+		*/
+		template<size_t Capacity>
+		struct UniqueAxisBuffer
+		{
+			static constexpr float QUANTUM = 1e-4f;
+			static constexpr float PARALLEL_SIN2 = 1e-10f; //axes within ~1e-5 radians are the same axis
+			static constexpr size_t NUM_SLOTS = Capacity * 2;
+			static constexpr uint16_t EMPTY_SLOT = 0xFFFF;
+			static_assert((NUM_SLOTS & (NUM_SLOTS - 1)) == 0 && Capacity < EMPTY_SLOT, "slots are masked and store axis indices");
+
+			glm::vec3 axes[Capacity];
+			uint16_t slots[NUM_SLOTS];
+			size_t count = 0;
+
+			UniqueAxisBuffer() { std::fill(std::begin(slots), std::end(slots), EMPTY_SLOT); }
+
+			/** returns false if an equivalent axis was already added */
+			bool addIfUnique(const glm::vec3& axis)
 			{
-				glm::vec3 candidateMTV = calculateMinimumTranslationVec(axis, movProj, staProj);
-				float newMTVLength2 = glm::length2(candidateMTV);
-				float oldMTVLength2 = glm::length2(mtv);
+				//unit axis, so z*z is implied by the other two; truncation is fine for a hash and avoids rounding branches
+				const uint32_t cellX = uint32_t(axis.x * axis.x * (1.0f / QUANTUM));
+				const uint32_t cellY = uint32_t(axis.y * axis.y * (1.0f / QUANTUM));
+				size_t slot = size_t((cellX * 73856093u) ^ (cellY * 19349663u)) & (NUM_SLOTS - 1);
 
-				//float zero comparision should be safe in this case; it is just to catch first MTV
-				if (newMTVLength2 < oldMTVLength2 || oldMTVLength2 == 0.0f)
+				for (; slots[slot] != EMPTY_SLOT; slot = (slot + 1) & (NUM_SLOTS - 1))
+				{
+					if (glm::length2(glm::cross(axes[slots[slot]], axis)) <= PARALLEL_SIN2)
+					{
+						return false;
+					}
+				}
+				if (count < Capacity)
+				{
+					axes[count] = axis;
+					slots[slot] = uint16_t(count++);
+				}
+				return true;
+			}
+		};
+
+		/** Tests moving faces, stationary faces, then edge x edge axes; the order axes were historically collected in, so equal length MTVs resolve the same way */
+		template<typename MovingProjector, typename StationaryProjector>
+		bool testAllAxes(
+			const std::vector<glm::vec3>& movingFaceAxes, const std::vector<glm::vec3>& stationaryFaceAxes,
+			const std::vector<glm::vec3>& movingEdges, const std::vector<glm::vec3>& stationaryEdges,
+			const MovingProjector& projectMoving, const StationaryProjector& projectStationary,
+			glm::vec4& outMTV)
+		{
+			using glm::vec3; using glm::vec4;
+
+			MTVAccumulator mtv;
+			for (const vec3& axis : movingFaceAxes)
+			{
+				if (!mtv.overlapsOnAxis(axis, projectMoving(axis), projectStationary(axis))) { outMTV = vec4(0.0f); return false; }
+			}
+			for (const vec3& axis : stationaryFaceAxes)
+			{
+				if (!mtv.overlapsOnAxis(axis, projectMoving(axis), projectStationary(axis))) { outMTV = vec4(0.0f); return false; }
+			}
+			for (const vec3& movEdge : movingEdges)
+			{
+				for (const vec3& statEdge : stationaryEdges)
 				{
-					mtv = candidateMTV;
+					//direction of cross product doesn't matter; projections will be consistent
+					vec3 axis = glm::normalize(glm::cross(movEdge, statEdge));
+					if (glm::isnan(axis.x) || glm::isnan(axis.y) || glm::isnan(axis.z))
+					{
+						continue; //parallel edges
+					}
+					if (!mtv.overlapsOnAxis(axis, projectMoving(axis), projectStationary(axis))) { outMTV = vec4(0.0f); return false; }
 				}
 			}
+
+			outMTV = vec4(mtv.distance * mtv.unitAxis, 0.0f);
+			outMTV *= Shape::floatMTVCorrectionFactor;
+			return true;
+		}
+	}
+
+	/*static*/ bool Shape::CollisionTest(const Shape& moving, const Shape& stationary, glm::vec4& outMTV)
+	{
+		//SAT collision test. 3d SAT requires not only the faces of the shape be tested, but
+		//also to test edge x edge pairs. The kernels walk face axes and edge x edge pairs without storing them.
+		if (moving.shapeType == EShapeType::CUBE && stationary.shapeType == EShapeType::CUBE)
+		{
+			return boxBoxCollisionTest(moving, stationary, outMTV);
 		}
+		return convexCollisionTest(moving, stationary, outMTV);
+	}
+
+	/*static*/ bool Shape::boxBoxCollisionTest(const Shape& moving, const Shape& stationary, glm::vec4& outMTV)
+	{
+		//a box projects to center.axis +- sum(|halfEdge.axis|); 3 dots instead of 8 per shape per axis
+		auto makeProjector = [](const Shape& box)
+		{
+			//F-RB and B-LT are opposite corners and the 3 cached edges span the cube; see CubeShape::shapePnts
+			return BoxProjector{
+				0.5f * glm::vec3(box.transformedPoints[0] + box.transformedPoints[6]),
+				{ 0.5f * box.transformedEdgeVecs[0], 0.5f * box.transformedEdgeVecs[1], 0.5f * box.transformedEdgeVecs[2] }
+			};
+		};
+		return testAllAxes(
+			moving.transformedFaceAxes, stationary.transformedFaceAxes,
+			moving.transformedEdgeVecs, stationary.transformedEdgeVecs,
+			makeProjector(moving), makeProjector(stationary),
+			outMTV);
+	}
+
+	/*static*/ bool Shape::convexCollisionTest(const Shape& moving, const Shape& stationary, glm::vec4& outMTV)
+	{
+		using glm::vec3; using glm::vec4;
 
-		outMTV = vec4(mtv, 0.0f);
-		outMTV *= floatMTVCorrectionFactor;
+		//projecting every point is the expensive part here, so axes that repeat an earlier one are dropped before projecting.
+		//a capsule pair has 61 candidate axes; larger hull pairs dedup their first 128 and still check the rest against those
+		UniqueAxisBuffer<128> testedAxes;
+		MTVAccumulator mtv;
+		auto overlapsOnNewAxis = [&](const vec3& axis)
+		{
+			return !testedAxes.addIfUnique(axis) || mtv.overlapsOnAxis(axis, moving.projectToAxis(axis), stationary.projectToAxis(axis));
+		};
+
+		for (const vec3& axis : moving.transformedFaceAxes)
+		{
+			if (!overlapsOnNewAxis(axis)) { outMTV = vec4(0.0f); return false; }
+		}
+		for (const vec3& axis : stationary.transformedFaceAxes)
+		{
+			if (!overlapsOnNewAxis(axis)) { outMTV = vec4(0.0f); return false; }
+		}
+		for (const vec3& movEdge : moving.transformedEdgeVecs)
+		{
+			for (const vec3& statEdge : stationary.transformedEdgeVecs)
+			{
+				vec3 axis = glm::normalize(glm::cross(movEdge, statEdge));
+				if (glm::isnan(axis.x) || glm::isnan(axis.y) || glm::isnan(axis.z))
+				{
+					continue; //parallel edges
+				}
+				if (!overlapsOnNewAxis(axis)) { outMTV = vec4(0.0f); return false; }
+			}
+		}
+
+		outMTV = vec4(mtv.distance * mtv.unitAxis, 0.0f);
+		outMTV *= Shape::floatMTVCorrectionFactor;
 		return true;
 	}
 
@@ -87,6 +252,10 @@ namespace SAT
 				transformedPoints[faceIdx.edge2.indexB]
 			);
 		}
+
+		transformedFaceAxes.resize(faces.size());
+		transformedEdgeVecs.resize(edges.size());
+		updateCachedAxes();
 	}
 
 	void Shape::updateTransform(const glm::mat4& inTransform)
@@ -102,30 +271,38 @@ namespace SAT
 			transformedPoints[pnt] = transform * localPoints[pnt];
 		}
 		transformedOrigin = transform * localOrigin;
+		updateCachedAxes();
 	}
 
-	void Shape::appendFaceAxes(std::vector<glm::vec3>& outAxes) const
+	void Shape::updateCachedAxes()
 	{
 		using glm::vec3; using glm::vec4;
-		for (const FaceRef& face : faces)
+		for (size_t faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
 		{
+			const FaceRef& face = faces[faceIdx];
 			vec4 e1 = face.edge1.pntA - face.edge1.pntB;
 			vec4 e2 = face.edge2.pntA - face.edge2.pntB;
-			vec3 axis = glm::normalize(glm::cross(vec3(e1), vec3(e2)));
-			outAxes.push_back(axis);
+			transformedFaceAxes[faceIdx] = glm::normalize(glm::cross(vec3(e1), vec3(e2)));
+		}
+		for (size_t edgeIdx = 0; edgeIdx < edges.size(); ++edgeIdx)
+		{
+			transformedEdgeVecs[edgeIdx] = vec3(edges[edgeIdx].pntA - edges[edgeIdx].pntB);
 		}
 	}
 
+	void Shape::appendFaceAxes(std::vector<glm::vec3>& outAxes) const
+	{
+		outAxes.insert(outAxes.end(), transformedFaceAxes.begin(), transformedFaceAxes.end());
+	}
+
 	void Shape::appendEdgeXEdgeAxes(const Shape& moving, const Shape& stationary, std::vector<glm::vec3>& normalizedAxes)
 	{
 		using std::vector; using glm::vec4; using glm::vec3;
 
-		for (const EdgeRef& moveEdgeRef : moving.edges)
+		for (const vec3& movEdge : moving.transformedEdgeVecs)
 		{
-			for (const EdgeRef& stationaryEdgeRef : stationary.edges)
+			for (const vec3& statEdge : stationary.transformedEdgeVecs)
 			{
-				vec3 movEdge = moveEdgeRef.pntA - moveEdgeRef.pntB;
-				vec3 statEdge = stationaryEdgeRef.pntA - stationaryEdgeRef.pntB;
 				//direction of cross product doesn't matter; projections will be consistent
 				vec3 axis = glm::normalize(cross(movEdge, statEdge));
 				if (!glm::isnan(axis.x) && !glm::isnan(axis.y) && !glm::isnan(axis.z))
@@ -140,6 +317,11 @@ namespace SAT
 	{
 		using glm::vec3; using glm::vec4;
 
+		if (shapeType == EShapeType::CUBE)
+		{
+			return projectBoxToAxis(normalizedAxis);
+		}
+
 		SAT::ProjectionRange projRange;
 
 		for (const glm::vec4& pnt4 : transformedPoints)
@@ -155,6 +337,15 @@ namespace SAT
 		return projRange;
 	}
 
+	SAT::ProjectionRange Shape::projectBoxToAxis(const glm::vec3& normalizedAxis) const
+	{
+		BoxProjector projector{
+			0.5f * glm::vec3(transformedPoints[0] + transformedPoints[6]),
+			{ 0.5f * transformedEdgeVecs[0], 0.5f * transformedEdgeVecs[1], 0.5f * transformedEdgeVecs[2] }
+		};
+		return projector(normalizedAxis);
+	}
+
 	void Shape::overrideLocalOrigin(glm::vec4 newLocalOriginPoint)
 	{
 		localOrigin = newLocalOriginPoint;
@@ -162,6 +353,11 @@ namespace SAT
 	}
 
 	/*static*/ glm::vec3 Shape::calculateMinimumTranslationVec(const glm::vec3& unitAxis, const SAT::ProjectionRange& movingProj, const SAT::ProjectionRange& stationaryProj)
+	{
+		return calculateMinimumTranslationDistance(movingProj, stationaryProj) * unitAxis;
+	}
+
+	/*static*/ float Shape::calculateMinimumTranslationDistance(const SAT::ProjectionRange& movingProj, const SAT::ProjectionRange& stationaryProj)
 	{
 		//INVARIANT: the two projects are not disjoint, and there is known overlap.
 		//	this method assumes that the collision test has already failed;
@@ -204,20 +400,20 @@ namespace SAT
 			//MTV is in direction of shorter distance; but include full size of inner object
 			//  (-|----|------)			
 			//  <--
-			glm::vec3 mtv(0.0f);
+			float mtv = 0.0f;
 			if (rightDist > leftDist) //move left (negative)
 			{
-				mtv = unitAxis * -(leftDist + (InsideObject.max -InsideObject.min));
+				mtv = -(leftDist + (InsideObject.max -InsideObject.min));
 			}
 			else if (rightDist < leftDist) //move right (positive)
 			{
-				mtv = unitAxis * (rightDist + (InsideObject.max - InsideObject.min));
+				mtv = (rightDist + (InsideObject.max - InsideObject.min));
 			
 			}
 			else //two are perfectly aligned; move full distance
 			{
 				//arbitrary direction since perfect alignment; both choices valid; must move full size
-				mtv = (BiggerObject.max - BiggerObject.min) * unitAxis;
+				mtv = (BiggerObject.max - BiggerObject.min);
 			}
 
 			//In cases moveable object has moved to now surround the stationary object, we will return the mtv for the stationary object
@@ -231,13 +427,13 @@ namespace SAT
 		{
 			// |--(--|---)
 			//    <--  vector needed
-			return (s.min - m.max) * unitAxis;
+			return (s.min - m.max);
 		}
 		else //movOnRight
 		{
 			//(--|---)--|		
 			//   ---->  vector needed
-			return (s.max - m.min) * unitAxis;
+			return (s.max - m.min);
 		}
 	}
 
@@ -292,7 +488,7 @@ namespace SAT
 	CubeShape::CubeShape() :
 		Shape(shapePnts, edgePntIndices, facePntIndices)
 	{
-
+		shapeType = EShapeType::CUBE;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////
@@ -430,6 +626,39 @@ namespace SAT
 	{
 	}
 
+	DynamicTriangleMeshShape::TriangleProcessor::TriangleProcessor(std::vector<glm::vec4> processedPoints, std::vector<EdgePointIndices> processedEdges, std::vector<FacePointIndices> processedFaces)
+		: points(std::move(processedPoints)), edgeIndices(std::move(processedEdges)), faceIndices(std::move(processedFaces))
+	{
+	}
+
+	namespace
+	{
+		struct QuantizedPoint
+		{
+			static constexpr float QUANTUM = 1e-5f; //model space; far below any feature size of a collision mesh
+
+			explicit QuantizedPoint(const glm::vec4& pnt)
+				: x(std::llround(pnt.x / QUANTUM)), y(std::llround(pnt.y / QUANTUM)), z(std::llround(pnt.z / QUANTUM))
+			{}
+			bool operator==(const QuantizedPoint& other) const { return x == other.x && y == other.y && z == other.z; }
+
+			struct Hash
+			{
+				size_t operator()(const QuantizedPoint& pnt) const
+				{
+					uint64_t hash = 14695981039346656037ull;
+					for (long long coord : { pnt.x, pnt.y, pnt.z })
+					{
+						hash = (hash ^ uint64_t(coord)) * 1099511628211ull;
+					}
+					return size_t(hash);
+				}
+			};
+
+			long long x, y, z;
+		};
+	}
+
 	DynamicTriangleMeshShape::TriangleProcessor::TriangleProcessor(const std::vector<TriangleCCW>& triangles, float considerDotsSameIfWithin)
 	{
 		using glm::cross; using glm::normalize; using glm::vec3; using glm::vec4; using glm::dot;
@@ -447,14 +676,25 @@ namespace SAT
 		faceIndices.reserve(triangles.size() / mirrorRedundancyHeuristic);
 		edgeIndices.reserve((3 * triangles.size()) / mirrorRedundancyHeuristic);
 
+		//triangles share corners; storing each corner once keeps projections (and GJK support scans) proportional to unique vertices.
+		//corners are hashed on a fine grid, so exporter float noise between copies of a corner does not split it
+		std::unordered_map<QuantizedPoint, uint32_t, QuantizedPoint::Hash> pointIndices;
+		pointIndices.reserve(triangles.size() * 3);
+		auto findOrAddPoint = [this, &pointIndices](const vec4& pnt) -> uint32_t
+		{
+			auto insertResult = pointIndices.insert({ QuantizedPoint(pnt), uint32_t(points.size()) });
+			if (insertResult.second)
+			{
+				points.push_back(pnt);
+			}
+			return insertResult.first->second;
+		};
+
 		for (const TriangleCCW& tri : triangles)
 		{
-			points.push_back(tri.pntA);
-			points.push_back(tri.pntB);
-			points.push_back(tri.pntC);
-			uint32_t aIdx = points.size() - 3;
-			uint32_t bIdx = points.size() - 2;
-			uint32_t cIdx = points.size() - 1;
+			uint32_t aIdx = findOrAddPoint(tri.pntA);
+			uint32_t bIdx = findOrAddPoint(tri.pntB);
+			uint32_t cIdx = findOrAddPoint(tri.pntC);
 
 			float vecsSameIfGreaterOrEqualThanThis = 1.0f - considerDotsSameIfWithin;
 
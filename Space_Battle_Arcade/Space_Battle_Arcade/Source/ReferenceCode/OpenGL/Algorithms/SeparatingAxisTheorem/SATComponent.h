@@ -70,10 +70,13 @@ namespace SAT
 		Non-uniform scales are safe since axis vectors are derivations from transformed points.
 
 		For now, this class is defined without virtuals for speed; if virtuals are added please mark dtor
-		virtual and remove this last sentence.
+		virtual and remove this last sentence. Subclasses that have a faster specialized kernel tag themselves with EShapeType instead.
 	 */
 	class Shape
 	{
+	public:
+		enum class EShapeType : uint8_t { GENERIC, CUBE };
+
 	public: //ctor arguments; these correspond to the faces and edge structs
 		struct EdgePointIndices 
 		{ 
@@ -109,11 +112,30 @@ namespace SAT
 		/* Not provided in ctor because normally the origin will be at the center of shapes; see default value*/
 		void overrideLocalOrigin(glm::vec4 newLocalOriginPoint);
 		glm::vec4 getTransformedOrigin() const { return transformedOrigin; }
+		const glm::mat4& getTransform() const { return transform; }
+		EShapeType getShapeType() const { return shapeType; }
 
-	private:
 		/** INVARIANT: Unit Axis is a normalized vector;INVARIANT: The two projections are not disjoint	*/
 		static glm::vec3 calculateMinimumTranslationVec(const glm::vec3& unitAxis, const SAT::ProjectionRange& movingProj, const SAT::ProjectionRange& stationaryProj);
 
+		/** Signed distance along the axis that calculateMinimumTranslationVec scales the unit axis by; same invariant */
+		static float calculateMinimumTranslationDistance(const SAT::ProjectionRange& movingProj, const SAT::ProjectionRange& stationaryProj);
+
+	protected:
+		EShapeType shapeType = EShapeType::GENERIC;
+
+	private:
+		/** Closed form box test over at most 15 axes; both shapes must be CubeShapes */
+		static bool boxBoxCollisionTest(const Shape& moving, const Shape& stationary, glm::vec4& outMTV);
+
+		/** Generic convex test; axes are tested as they are generated, skipping any parallel to one already tested (tracked in a fixed stack buffer) */
+		static bool convexCollisionTest(const Shape& moving, const Shape& stationary, glm::vec4& outMTV);
+
+		/** Projects the 8 corners of a transformed CubeShape without visiting them; center.a +- sum |halfEdge.a| */
+		SAT::ProjectionRange projectBoxToAxis(const glm::vec3& normalizedAxis) const;
+
+		void updateCachedAxes();
+
 	public: //debugging helpers; provided to allow visualization of collision shapes as points and visual unique edges/faces
 		/** The following are debug methods are debug methods and not intended for normal SAT usage*/
 		const std::vector<glm::vec4>& getTransformedPoints() const { return transformedPoints; };
@@ -138,6 +160,9 @@ namespace SAT
 		std::vector<FaceRef> faces;
 		std::vector<EdgeRef> edges;
 
+		//axes only change with the transform, so they are built once per transform rather than once per collision test
+		std::vector<glm::vec3> transformedFaceAxes;	//normalized
+		std::vector<glm::vec3> transformedEdgeVecs;	//pntA - pntB, not normalized
 	};
 
 
@@ -219,6 +244,13 @@ namespace SAT
 				glm::vec4 pntC;
 			};
 			TriangleProcessor(const std::vector<TriangleCCW>& triangles, float considerDotsSameIfWithin);
+
+			/** adopts the output of a previous processing pass (eg from a cooked asset), skipping the unique normal/edge scans */
+			TriangleProcessor(std::vector<glm::vec4> processedPoints, std::vector<EdgePointIndices> processedEdges, std::vector<FacePointIndices> processedFaces);
+
+			const std::vector<glm::vec4>& getPoints() const { return points; }
+			const std::vector<EdgePointIndices>& getEdgeIndices() const { return edgeIndices; }
+			const std::vector<FacePointIndices>& getFaceIndices() const { return faceIndices; }
 		private:
 			friend DynamicTriangleMeshShape;
 			std::vector<glm::vec4> points;
@@ -102,8 +102,8 @@ namespace SH
 		drawDebugLines(debugShader, color, linesToDraw, model, view, projection);
 	}
 
-	template<typename T, typename Shader>
-	void drawAABBGrid(const SH::SpatialHashGrid<T>& spatialHash, const glm::vec3& gridColor, Shader& debugGridShader,
+	template<typename T, typename Shader, template<typename> class GridType>
+	void drawAABBGrid(const GridType<T>& spatialHash, const glm::vec3& gridColor, Shader& debugGridShader,
 		const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection)
 	{
 		static std::vector<glm::vec4> linesToDraw;
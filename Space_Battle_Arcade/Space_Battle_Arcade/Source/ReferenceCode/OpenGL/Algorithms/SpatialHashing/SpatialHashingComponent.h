@@ -7,6 +7,8 @@
 #define HASH_MAP_UNORDERED_MULTIMAP 1
 #define HASH_MAP_UNORDERED_SET 0
 #define HASH_MAP_MANUAL_HASH_ARRAY 0
+//Flat open addressing backend is its own grid type (see SpatialHashingFlatGrid.h); this switch picks which grid SH::Grid<T> refers to
+#define HASH_MAP_FLAT_OPEN_ADDRESSING 0
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -197,6 +199,13 @@ namespace SH
 		std::list<std::shared_ptr<GridNode<T>>> nodeBucket;
 	};
 
+	///////////////////////////////////////////////////////////////////////////////////////
+	// Grid math shared between grid backends; these only depend on the cell size of the grid
+	///////////////////////////////////////////////////////////////////////////////////////
+	inline glm::ivec3 convertPntToCellLoc(const glm::vec3& gridCellSize, const glm::vec3 pnt);
+	inline void projectOBBToCellRanges(const glm::vec3& gridCellSize, Range<int>& xCellIndices, Range<int>& yCellIndices, Range<int>& zCellIndices, const std::array<glm::vec4, 8>& localSpaceOBB);
+	inline void traceCellLocationsForLine(const glm::vec3& gridCellSize, const glm::vec3& start, const glm::vec3& end, std::vector<glm::ivec3>& outCells, float nudgeIntersectionBias = 0.01f);
+
 
 	template<typename T>
 	class SpatialHashGrid : public RemoveCopies, public RemoveMoves
@@ -905,6 +914,104 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 
 	template<typename T>
 	glm::ivec3 SH::SpatialHashGrid<T>::convertPntToCellLoc(const glm::vec3 pnt)
+	{
+		return SH::convertPntToCellLoc(gridCellSize, pnt);
+	}
+
+	template<typename T>
+	void SH::SpatialHashGrid<T>::findCellLocationsForLine(const glm::vec3& start, const glm::vec3& end, std::vector<glm::ivec3>& outCells, float nudgeIntersectionBias)
+	{
+		traceCellLocationsForLine(gridCellSize, start, end, outCells, nudgeIntersectionBias);
+	}
+
+	template<typename T>
+	void SH::SpatialHashGrid<T>::lookupCellsForLine(const glm::vec3& start, const glm::vec3& end, std::vector<std::shared_ptr<const SH::HashCell<T>>>& outCells)
+	{
+		static std::vector<glm::ivec3> cellIdices;
+		static const int singleInvokeInit = [&]() { cellIdices.reserve(20); return 0; }();
+
+		cellIdices.clear();
+		findCellLocationsForLine(start, end, cellIdices);
+
+		outCells.clear();
+		for (const glm::vec3& cellIdx : cellIdices)
+		{
+			uint64_t hashVal = hash(cellIdx);
+			if (std::shared_ptr<const SH::HashCell<T>> cell = findCellForHash(hashVal, cellIdx))
+			{
+				outCells.push_back(cell);
+			}
+		}
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	void SpatialHashGrid<T>::logDebugInformation()
+	{
+#if HASH_MAP_UNORDERED_MULTIMAP || HASH_MAP_UNORDERED_SET
+		std::cout << "bucket count:" << hashMap.bucket_count() << std::endl;
+#endif
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	bool SpatialHashGrid<T>::remove(HashEntry<T>& toRemove, bool bRemoveFromValidEntries)
+	{
+		const Range<int>& xCellIndices = toRemove.xGridCells;
+		const Range<int>& yCellIndices = toRemove.yGridCells;
+		const Range<int>& zCellIndices = toRemove.zGridCells;
+
+		bool allRemoved = true;
+
+		BEGIN_FOR_EVERY_CELL(xCellIndices, yCellIndices, zCellIndices)
+					allRemoved &= hashRemove(toRemove.insertedNode, { cellX, cellY, cellZ });
+		END_FOR_EVERY_CELL
+
+		if(bRemoveFromValidEntries)
+		{
+			const auto& iter = validEntries.find(&toRemove);
+			assert(iter != validEntries.end());
+			validEntries.erase(iter);
+		}
+
+		return allRemoved;
+	}
+
+	template<typename T>
+	SpatialHashGrid<T>::~SpatialHashGrid()
+	{
+		//Proper spatial hash usage requires the spatial hash always outlives its entries.
+		//But for a simple API, this isn't enforced. The cost is a slow loop in destructor 
+		if (validEntries.size() > 0) //O(1)
+		{
+#ifdef LOG_LIFETIME_ERRORS
+			std::cerr << "WARNING: spatial hash was outlived by its entries; this is likely a design issue" << std::endl;
+			std::cerr << "walking distance " << std::distance(validEntries.begin(), validEntries.end()) << " to invalidate entries" << std::endl;
+#endif // LOG_LIFETIME_ERRORS
+			for (HashEntry<T>* entry : validEntries) //O(n + m)
+			{
+				entry->gridValid = false;
+			}
+		}
+	}
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+	template<typename T>
+	inline void SpatialHashGrid<T>::projectOBBToCells(Range<int>& xCellIndices, Range<int>& yCellIndices, Range<int>& zCellIndices, const std::array<glm::vec4, 8>& localSpaceOBB)
+	{
+		projectOBBToCellRanges(gridCellSize, xCellIndices, yCellIndices, zCellIndices, localSpaceOBB);
+	}
+
+
+///////////////////////////////////////////////////////////////////////////////////////
+// shared grid math
+///////////////////////////////////////////////////////////////////////////////////////
+
+	inline glm::ivec3 convertPntToCellLoc(const glm::vec3& gridCellSize, const glm::vec3 pnt)
 	{
 		float startX = std::floor(pnt.x / gridCellSize.x);
 		float startY = std::floor(pnt.y / gridCellSize.y);
@@ -919,11 +1026,10 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 		return cellIdx;
 	}
 
-	template<typename T>
-	void SH::SpatialHashGrid<T>::findCellLocationsForLine(const glm::vec3& start, const glm::vec3& end, std::vector<glm::ivec3>& outCells, float nudgeIntersectionBias)
+	inline void traceCellLocationsForLine(const glm::vec3& gridCellSize, const glm::vec3& start, const glm::vec3& end, std::vector<glm::ivec3>& outCells, float nudgeIntersectionBias)
 	{
 		// -- find cell ray starts within --
-		glm::ivec3 startIdx = convertPntToCellLoc(start);
+		glm::ivec3 startIdx = convertPntToCellLoc(gridCellSize, start);
 
 		//perhaps should rely on caller to clear this data structure, but that will make the api more fragile
 		outCells.clear(); 
@@ -952,10 +1058,10 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 		//		there is no collision because it exited the x plane before it penetrated the z plane
 		//it seems that, if it is within the cube, the entrance planes will all have negative t values
 
-		auto getLargerMagnitudeCellBounds = [this](const glm::ivec3& loc) {
+		auto getLargerMagnitudeCellBounds = [&gridCellSize](const glm::ivec3& loc) {
 			return glm::vec3{ loc.x * gridCellSize.x, loc.y * gridCellSize.x, loc.z * gridCellSize.z };
 		};
-		auto getSmallerMagnitudeCellBounds = [this, getLargerMagnitudeCellBounds](glm::ivec3 locCopy) {
+		auto getSmallerMagnitudeCellBounds = [getLargerMagnitudeCellBounds](glm::ivec3 locCopy) {
 			//adjust the location by 1 and get the  value
 			locCopy.x = locCopy.x < 0 ? locCopy.x + 1 : locCopy.x - 1;
 			locCopy.y = locCopy.y < 0 ? locCopy.y + 1 : locCopy.y - 1;
@@ -1048,7 +1154,7 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 
 				if (previousT <= endT)
 				{
-					glm::ivec3 cellLoc = convertPntToCellLoc(intersectPoint);
+					glm::ivec3 cellLoc = convertPntToCellLoc(gridCellSize, intersectPoint);
 					if (outCells.size() > 0)
 					{
 						if (outCells.back() == cellLoc)
@@ -1073,84 +1179,7 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 		} while (previousT < endT);
 	}
 
-	template<typename T>
-	void SH::SpatialHashGrid<T>::lookupCellsForLine(const glm::vec3& start, const glm::vec3& end, std::vector<std::shared_ptr<const SH::HashCell<T>>>& outCells)
-	{
-		static std::vector<glm::ivec3> cellIdices;
-		static const int singleInvokeInit = [&]() { cellIdices.reserve(20); return 0; }();
-
-		cellIdices.clear();
-		findCellLocationsForLine(start, end, cellIdices);
-
-		outCells.clear();
-		for (const glm::vec3& cellIdx : cellIdices)
-		{
-			uint64_t hashVal = hash(cellIdx);
-			if (std::shared_ptr<const SH::HashCell<T>> cell = findCellForHash(hashVal, cellIdx))
-			{
-				outCells.push_back(cell);
-			}
-		}
-	}
-
-///////////////////////////////////////////////////////////////////////////////////////
-///////////////////////////////////////////////////////////////////////////////////////
-
-	template<typename T>
-	void SpatialHashGrid<T>::logDebugInformation()
-	{
-#if HASH_MAP_UNORDERED_MULTIMAP || HASH_MAP_UNORDERED_SET
-		std::cout << "bucket count:" << hashMap.bucket_count() << std::endl;
-#endif
-	}
-
-///////////////////////////////////////////////////////////////////////////////////////
-///////////////////////////////////////////////////////////////////////////////////////
-
-	template<typename T>
-	bool SpatialHashGrid<T>::remove(HashEntry<T>& toRemove, bool bRemoveFromValidEntries)
-	{
-		const Range<int>& xCellIndices = toRemove.xGridCells;
-		const Range<int>& yCellIndices = toRemove.yGridCells;
-		const Range<int>& zCellIndices = toRemove.zGridCells;
-
-		bool allRemoved = true;
-
-		BEGIN_FOR_EVERY_CELL(xCellIndices, yCellIndices, zCellIndices)
-					allRemoved &= hashRemove(toRemove.insertedNode, { cellX, cellY, cellZ });
-		END_FOR_EVERY_CELL
-
-		if(bRemoveFromValidEntries)
-		{
-			const auto& iter = validEntries.find(&toRemove);
-			assert(iter != validEntries.end());
-			validEntries.erase(iter);
-		}
-
-		return allRemoved;
-	}
-
-	template<typename T>
-	SpatialHashGrid<T>::~SpatialHashGrid()
-	{
-		//Proper spatial hash usage requires the spatial hash always outlives its entries.
-		//But for a simple API, this isn't enforced. The cost is a slow loop in destructor 
-		if (validEntries.size() > 0) //O(1)
-		{
-#ifdef LOG_LIFETIME_ERRORS
-			std::cerr << "WARNING: spatial hash was outlived by its entries; this is likely a design issue" << std::endl;
-			std::cerr << "walking distance " << std::distance(validEntries.begin(), validEntries.end()) << " to invalidate entries" << std::endl;
-#endif // LOG_LIFETIME_ERRORS
-			for (HashEntry<T>* entry : validEntries) //O(n + m)
-			{
-				entry->gridValid = false;
-			}
-		}
-	}
-///////////////////////////////////////////////////////////////////////////////////////
-///////////////////////////////////////////////////////////////////////////////////////
-	template<typename T>
-	inline void SpatialHashGrid<T>::projectOBBToCells(Range<int>& xCellIndices, Range<int>& yCellIndices, Range<int>& zCellIndices, const std::array<glm::vec4, 8>& localSpaceOBB)
+	inline void projectOBBToCellRanges(const glm::vec3& gridCellSize, Range<int>& xCellIndices, Range<int>& yCellIndices, Range<int>& zCellIndices, const std::array<glm::vec4, 8>& localSpaceOBB)
 	{
 		//__project points onto grid cell axes__
 		Range<float> xProjRange, yProjRange, zProjRange;
@@ -1211,6 +1240,7 @@ for (int cellX = xCellIndices.min; cellX < xCellIndices.max; ++cellX)\
 	}
 
 
+
 ///////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////
 
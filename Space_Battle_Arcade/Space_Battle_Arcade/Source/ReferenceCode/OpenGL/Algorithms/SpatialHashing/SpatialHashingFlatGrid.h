@@ -0,0 +1,538 @@
+#pragma once
+
+#include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SpatialHashingComponent.h"
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cassert>
+#include <iostream>
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+// Flat open addressing spatial hash grid.
+//
+// Same insert/updateEntry/lookup* interface as SpatialHashGrid, but with no shared_ptrs and no node lists.
+//	-cells are keyed by their packed ivec3 location in a power-of-two linear probing table
+//	-cells live in a pool and keep a contiguous array of node pointers; empty cells are recycled (keeping their capacity)
+//	-nodes live inside their hash entry, so the RAII entry is the only allocation an inserted object pays for
+//	-lookups de-duplicate nodes with a query stamp rather than an unordered_set
+//
+// Pointers handed out by lookup functions are only valid until the next insert/update/remove on the grid.
+/////////////////////////////////////////////////////////////////////////////////////////////
+namespace SH
+{
+	template<typename T>
+	class FlatSpatialHashGrid;
+
+	template<typename T>
+	struct FlatGridNode
+	{
+		T& element;
+
+		FlatGridNode(T& inElement) : element(inElement) {}
+
+	private:
+		friend FlatSpatialHashGrid<T>;
+		uint32_t lastQueryStamp = 0;
+	};
+
+	template<typename T>
+	struct FlatHashCell
+	{
+		FlatHashCell() = default;
+		FlatHashCell(const FlatHashCell& copy) = delete;
+		FlatHashCell& operator=(const FlatHashCell& copy) = delete;
+		FlatHashCell(FlatHashCell&& move) = default;
+		FlatHashCell& operator=(FlatHashCell&& move) = default;
+
+		glm::ivec3 location;
+		std::vector<FlatGridNode<T>*> nodeBucket;
+	};
+
+	template<typename T>
+	struct FlatHashEntry final : public RemoveCopies, public RemoveMoves
+	{
+		FlatGridNode<T>* getInsertedNode() { return &insertedNode; }
+
+		const Range<int> getXGridCells() { return xGridCells; }
+		const Range<int> getYGridCells() { return yGridCells; }
+		const Range<int> getZGridCells() { return zGridCells; }
+
+		FlatSpatialHashGrid<T>& owningGrid;
+
+		~FlatHashEntry()
+		{
+			if (gridValid)
+			{
+				owningGrid.remove(*this);
+			}
+#ifdef LOG_LIFETIME_ERRORS
+			else
+			{
+				std::cerr << "Hash Entry outlived spatial hash; this is probably an error as it requires slow clean up." << std::endl;
+			}
+#endif // LOG_LIFETIME_ERRORS
+		}
+
+	private:
+		friend FlatSpatialHashGrid<T>;
+
+		FlatHashEntry(T& obj, const Range<int>& inXGridCells, const Range<int>& inYGridCells, const Range<int>& inZGridCells, FlatSpatialHashGrid<T>& inOwningGrid)
+			: owningGrid(inOwningGrid),
+			xGridCells(inXGridCells), yGridCells(inYGridCells), zGridCells(inZGridCells),
+			insertedNode(obj)
+		{ }
+
+		Range<int> xGridCells;
+		Range<int> yGridCells;
+		Range<int> zGridCells;
+		FlatGridNode<T> insertedNode;
+		size_t validEntryIdx = 0;
+		bool gridValid = true;
+	};
+
+	template<typename T>
+	class FlatSpatialHashGrid : public RemoveCopies, public RemoveMoves
+	{
+	public: //methods
+		FlatSpatialHashGrid(const glm::vec3& inGridCellSize, std::size_t estimatedNumCells = 10000);
+		~FlatSpatialHashGrid();
+
+		std::unique_ptr<FlatHashEntry<T>> insert(T& obj, const std::array<glm::vec4, 8>& OBB_hashLocalSpace);
+		void updateEntry(std::unique_ptr<FlatHashEntry<T>>& entry, const std::array<glm::vec4, 8>& newLocalSpaceOBB);
+
+		inline void lookupNodesInCells(const SH::FlatHashEntry<T>& cellSource, std::vector<SH::FlatGridNode<T>*>& outNodes, bool filterOutSource = true);
+		inline void lookupCellsForEntry(const SH::FlatHashEntry<T>& cellSource, std::vector<const SH::FlatHashCell<T>*>& outCells);
+		inline void lookupCellsForOOB(const std::array<glm::vec4, 8>& OBB_hashLocalSpace, std::vector<const SH::FlatHashCell<T>*>& outCells);
+
+		inline void findCellLocationsForLine(const glm::vec3& start_hashLocalSpace, const glm::vec3& end_hashLocalSpace, std::vector<glm::ivec3>& outCells, float nudgeIntersectionBias = 0.01f);
+		inline void lookupCellsForLine(const glm::vec3& start_hashLocalSpace, const glm::vec3& end_hashLocalSpace, std::vector<const SH::FlatHashCell<T>*>& outCells);
+		inline void logDebugInformation();
+
+	private: //methods
+		friend FlatHashEntry<T>;
+		inline bool remove(FlatHashEntry<T>& toRemove, bool bRemoveFromValidEntries = true);
+
+		inline static uint64_t packLocation(const glm::ivec3& location);
+		inline static uint64_t mix(uint64_t key);
+
+		inline uint32_t findCellIdx(const glm::ivec3& location) const;
+		inline void hashInsert(FlatGridNode<T>& gridNode, const glm::ivec3& location);
+		inline bool hashRemove(FlatGridNode<T>& gridNode, const glm::ivec3& location);
+		inline void eraseSlot(size_t slotIdx);
+		inline void growTable();
+
+	public: //variables
+		const glm::vec3 gridCellSize;
+
+	private: //variables
+		static constexpr uint64_t EMPTY_KEY = ~uint64_t(0); //packed keys only use the lower 63 bits, so this can never be a real key
+		static constexpr uint32_t INVALID_CELL = ~uint32_t(0);
+
+		struct Slot
+		{
+			uint64_t key = EMPTY_KEY;
+			uint32_t cellIdx = INVALID_CELL;
+		};
+
+		/** power of two sized so probing can mask rather than mod */
+		std::vector<Slot> slots;
+		size_t slotMask = 0;
+		size_t numOccupiedSlots = 0;
+
+		std::vector<FlatHashCell<T>> cellPool;
+		std::vector<uint32_t> freeCells;
+
+		std::vector<FlatHashEntry<T>*> validEntries;
+		std::vector<glm::ivec3> lineCellScratch;
+		uint32_t queryStamp = 0;
+	};
+
+	///////////////////////////////////////////////////////////////////////////////////////
+	// Grid selection; code that wants to be agnostic to the backend should use these
+	///////////////////////////////////////////////////////////////////////////////////////
+#if HASH_MAP_FLAT_OPEN_ADDRESSING
+	template<typename T> using Grid = FlatSpatialHashGrid<T>;
+	template<typename T> using GridEntry = FlatHashEntry<T>;
+	template<typename T> using GridNodeRef = FlatGridNode<T>*;
+	template<typename T> using GridCellRef = const FlatHashCell<T>*;
+#else
+	template<typename T> using Grid = SpatialHashGrid<T>;
+	template<typename T> using GridEntry = HashEntry<T>;
+	template<typename T> using GridNodeRef = std::shared_ptr<GridNode<T>>;
+	template<typename T> using GridCellRef = std::shared_ptr<const HashCell<T>>;
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////////////
+/// function implementations for flat spatial hash
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	FlatSpatialHashGrid<T>::FlatSpatialHashGrid(const glm::vec3& inGridCellSize, std::size_t estimatedNumCells)
+		: gridCellSize(inGridCellSize)
+	{
+		//keep load factor at or below 0.5 for the estimated cell count so probe chains stay short
+		size_t capacity = 16;
+		while (capacity < estimatedNumCells * 2) { capacity <<= 1; }
+
+		slots.resize(capacity);
+		slotMask = capacity - 1;
+		cellPool.reserve(estimatedNumCells);
+	}
+
+	template<typename T>
+	FlatSpatialHashGrid<T>::~FlatSpatialHashGrid()
+	{
+		if (validEntries.size() > 0)
+		{
+#ifdef LOG_LIFETIME_ERRORS
+			std::cerr << "WARNING: spatial hash was outlived by its entries; this is likely a design issue" << std::endl;
+			std::cerr << "invalidating " << validEntries.size() << " entries" << std::endl;
+#endif // LOG_LIFETIME_ERRORS
+			for (FlatHashEntry<T>* entry : validEntries)
+			{
+				entry->gridValid = false;
+			}
+		}
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	uint64_t FlatSpatialHashGrid<T>::packLocation(const glm::ivec3& location)
+	{
+		//21 bits per axis, biased so negative cells pack without sign extension; this covers cells [-2^20, 2^20)
+		constexpr int32_t BIAS = 1 << 20;
+		constexpr uint64_t MASK = (uint64_t(1) << 21) - 1;
+		assert(location.x >= -BIAS && location.x < BIAS);
+		assert(location.y >= -BIAS && location.y < BIAS);
+		assert(location.z >= -BIAS && location.z < BIAS);
+
+		uint64_t x = uint64_t(uint32_t(location.x + BIAS)) & MASK;
+		uint64_t y = uint64_t(uint32_t(location.y + BIAS)) & MASK;
+		uint64_t z = uint64_t(uint32_t(location.z + BIAS)) & MASK;
+		return (x << 42) | (y << 21) | z;
+	}
+
+	template<typename T>
+	uint64_t FlatSpatialHashGrid<T>::mix(uint64_t key)
+	{
+		//splitmix64 finalizer; neighbouring cells have neighbouring keys so they need to be scattered before masking
+		key ^= key >> 30;
+		key *= 0xbf58476d1ce4e5b9ull;
+		key ^= key >> 27;
+		key *= 0x94d049bb133111ebull;
+		key ^= key >> 31;
+		return key;
+	}
+
+	template<typename T>
+	uint32_t FlatSpatialHashGrid<T>::findCellIdx(const glm::ivec3& location) const
+	{
+		const uint64_t key = packLocation(location);
+		for (size_t slotIdx = mix(key) & slotMask; ; slotIdx = (slotIdx + 1) & slotMask)
+		{
+			const Slot& slot = slots[slotIdx];
+			if (slot.key == key)
+			{
+				return slot.cellIdx;
+			}
+			else if (slot.key == EMPTY_KEY)
+			{
+				return INVALID_CELL;
+			}
+		}
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::growTable()
+	{
+		std::vector<Slot> oldSlots = std::move(slots);
+		slots.clear();
+		slots.resize(oldSlots.size() * 2);
+		slotMask = slots.size() - 1;
+
+		for (const Slot& oldSlot : oldSlots)
+		{
+			if (oldSlot.key != EMPTY_KEY)
+			{
+				size_t slotIdx = mix(oldSlot.key) & slotMask;
+				while (slots[slotIdx].key != EMPTY_KEY) { slotIdx = (slotIdx + 1) & slotMask; }
+				slots[slotIdx] = oldSlot;
+			}
+		}
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::hashInsert(FlatGridNode<T>& gridNode, const glm::ivec3& location)
+	{
+		const uint64_t key = packLocation(location);
+
+		size_t slotIdx = mix(key) & slotMask;
+		while (slots[slotIdx].key != EMPTY_KEY && slots[slotIdx].key != key)
+		{
+			slotIdx = (slotIdx + 1) & slotMask;
+		}
+
+		if (slots[slotIdx].key == EMPTY_KEY)
+		{
+			//create the cell, reusing a recycled cell if possible so its node array keeps its capacity
+			uint32_t cellIdx;
+			if (freeCells.size() > 0)
+			{
+				cellIdx = freeCells.back();
+				freeCells.pop_back();
+			}
+			else
+			{
+				cellIdx = static_cast<uint32_t>(cellPool.size());
+				cellPool.emplace_back();
+			}
+			cellPool[cellIdx].location = location;
+
+			slots[slotIdx].key = key;
+			slots[slotIdx].cellIdx = cellIdx;
+			++numOccupiedSlots;
+
+			cellPool[cellIdx].nodeBucket.push_back(&gridNode);
+
+			if (numOccupiedSlots * 2 > slots.size())
+			{
+				growTable();
+			}
+		}
+		else
+		{
+			cellPool[slots[slotIdx].cellIdx].nodeBucket.push_back(&gridNode);
+		}
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::eraseSlot(size_t slotIdx)
+	{
+		//backward shift deletion; keeps probe chains intact without tombstones
+		size_t hole = slotIdx;
+		size_t next = (hole + 1) & slotMask;
+		while (slots[next].key != EMPTY_KEY)
+		{
+			size_t home = mix(slots[next].key) & slotMask;
+
+			//only shift the entry back if the hole lies between its home slot and where it currently sits (cyclically)
+			bool bCanShift = ((next - home) & slotMask) >= ((next - hole) & slotMask);
+			if (bCanShift)
+			{
+				slots[hole] = slots[next];
+				hole = next;
+			}
+			next = (next + 1) & slotMask;
+		}
+		slots[hole] = Slot{};
+		--numOccupiedSlots;
+	}
+
+	template<typename T>
+	bool FlatSpatialHashGrid<T>::hashRemove(FlatGridNode<T>& gridNode, const glm::ivec3& location)
+	{
+		const uint64_t key = packLocation(location);
+
+		size_t slotIdx = mix(key) & slotMask;
+		while (slots[slotIdx].key != key)
+		{
+			if (slots[slotIdx].key == EMPTY_KEY)
+			{
+				//removals should always be associated with a present cell!
+				assert(false);
+				return false;
+			}
+			slotIdx = (slotIdx + 1) & slotMask;
+		}
+
+		const uint32_t cellIdx = slots[slotIdx].cellIdx;
+		std::vector<FlatGridNode<T>*>& bucket = cellPool[cellIdx].nodeBucket;
+
+		bool bFoundRemove = false;
+		for (size_t nodeIdx = 0; nodeIdx < bucket.size(); ++nodeIdx)
+		{
+			if (bucket[nodeIdx] == &gridNode)
+			{
+				//order within a cell is not meaningful, swap and pop
+				bucket[nodeIdx] = bucket.back();
+				bucket.pop_back();
+				bFoundRemove = true;
+				break;
+			}
+		}
+		assert(bFoundRemove);
+
+		if (bucket.size() == 0)
+		{
+			eraseSlot(slotIdx);
+			freeCells.push_back(cellIdx);
+		}
+		return bFoundRemove;
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	std::unique_ptr<FlatHashEntry<T>> FlatSpatialHashGrid<T>::insert(T& obj, const std::array<glm::vec4, 8>& localSpaceOBB)
+	{
+		Range<int> xCellIndices, yCellIndices, zCellIndices;
+		projectOBBToCellRanges(gridCellSize, xCellIndices, yCellIndices, zCellIndices, localSpaceOBB);
+
+		//constructor is private, see HashEntry for why make_unique is not used
+		std::unique_ptr<FlatHashEntry<T>> hashEntry = std::unique_ptr<FlatHashEntry<T>>(
+			new FlatHashEntry<T>(obj, xCellIndices, yCellIndices, zCellIndices, *this)
+		);
+
+		BEGIN_FOR_EVERY_CELL(xCellIndices, yCellIndices, zCellIndices)
+			hashInsert(hashEntry->insertedNode, { cellX, cellY, cellZ });
+		END_FOR_EVERY_CELL
+
+		hashEntry->validEntryIdx = validEntries.size();
+		validEntries.push_back(hashEntry.get());
+		return hashEntry;
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::updateEntry(std::unique_ptr<FlatHashEntry<T>>& entry, const std::array<glm::vec4, 8>& newLocalSpaceOBB)
+	{
+		assert(&entry->owningGrid == this);
+		if (&entry->owningGrid != this)
+		{
+			return;
+		}
+
+		Range<int> xCellIndices, yCellIndices, zCellIndices;
+		projectOBBToCellRanges(gridCellSize, xCellIndices, yCellIndices, zCellIndices, newLocalSpaceOBB);
+
+		//only update if there is a change in the occupied cells
+		if (xCellIndices != entry->xGridCells || yCellIndices != entry->yGridCells || zCellIndices != entry->zGridCells)
+		{
+			remove(*entry, /*remove from valid entries */ false);
+
+			entry->xGridCells = xCellIndices;
+			entry->yGridCells = yCellIndices;
+			entry->zGridCells = zCellIndices;
+
+			BEGIN_FOR_EVERY_CELL(xCellIndices, yCellIndices, zCellIndices)
+				hashInsert(entry->insertedNode, { cellX, cellY, cellZ });
+			END_FOR_EVERY_CELL
+		}
+	}
+
+	template<typename T>
+	bool FlatSpatialHashGrid<T>::remove(FlatHashEntry<T>& toRemove, bool bRemoveFromValidEntries)
+	{
+		bool allRemoved = true;
+
+		BEGIN_FOR_EVERY_CELL(toRemove.xGridCells, toRemove.yGridCells, toRemove.zGridCells)
+			allRemoved &= hashRemove(toRemove.insertedNode, { cellX, cellY, cellZ });
+		END_FOR_EVERY_CELL
+
+		if (bRemoveFromValidEntries)
+		{
+			size_t idx = toRemove.validEntryIdx;
+			assert(idx < validEntries.size() && validEntries[idx] == &toRemove);
+
+			validEntries[idx] = validEntries.back();
+			validEntries[idx]->validEntryIdx = idx;
+			validEntries.pop_back();
+		}
+
+		return allRemoved;
+	}
+
+///////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::lookupNodesInCells(const SH::FlatHashEntry<T>& cellSource, std::vector<SH::FlatGridNode<T>*>& outNodes, bool filterOutSource)
+	{
+		outNodes.clear();
+
+		//stamp nodes as they are found rather than tracking them in a set; on wrap around clear all stamps so stale stamps can't match
+		if (++queryStamp == 0)
+		{
+			for (FlatHashCell<T>& cell : cellPool)
+			{
+				for (FlatGridNode<T>* node : cell.nodeBucket) { node->lastQueryStamp = 0; }
+			}
+			queryStamp = 1;
+		}
+
+		const FlatGridNode<T>* sourceNode = &cellSource.insertedNode;
+
+		BEGIN_FOR_EVERY_CELL(cellSource.xGridCells, cellSource.yGridCells, cellSource.zGridCells)
+			uint32_t cellIdx = findCellIdx({ cellX, cellY, cellZ });
+			if (cellIdx != INVALID_CELL)
+			{
+				for (FlatGridNode<T>* node : cellPool[cellIdx].nodeBucket)
+				{
+					bool bFilterFail = filterOutSource && (&node->element == &sourceNode->element);
+					if (node->lastQueryStamp != queryStamp && !bFilterFail)
+					{
+						node->lastQueryStamp = queryStamp;
+						outNodes.push_back(node);
+					}
+				}
+			}
+		END_FOR_EVERY_CELL
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::lookupCellsForEntry(const SH::FlatHashEntry<T>& cellSource, std::vector<const SH::FlatHashCell<T>*>& outCells)
+	{
+		outCells.clear();
+
+		BEGIN_FOR_EVERY_CELL(cellSource.xGridCells, cellSource.yGridCells, cellSource.zGridCells)
+			uint32_t cellIdx = findCellIdx({ cellX, cellY, cellZ });
+			if (cellIdx != INVALID_CELL) { outCells.push_back(&cellPool[cellIdx]); }
+		END_FOR_EVERY_CELL
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::lookupCellsForOOB(const std::array<glm::vec4, 8>& localSpaceOBB, std::vector<const SH::FlatHashCell<T>*>& outCells)
+	{
+		outCells.clear();
+		Range<int> xCellIndices, yCellIndices, zCellIndices;
+		projectOBBToCellRanges(gridCellSize, xCellIndices, yCellIndices, zCellIndices, localSpaceOBB);
+
+		BEGIN_FOR_EVERY_CELL(xCellIndices, yCellIndices, zCellIndices)
+			uint32_t cellIdx = findCellIdx({ cellX, cellY, cellZ });
+			if (cellIdx != INVALID_CELL) { outCells.push_back(&cellPool[cellIdx]); }
+		END_FOR_EVERY_CELL
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::findCellLocationsForLine(const glm::vec3& start, const glm::vec3& end, std::vector<glm::ivec3>& outCells, float nudgeIntersectionBias)
+	{
+		traceCellLocationsForLine(gridCellSize, start, end, outCells, nudgeIntersectionBias);
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::lookupCellsForLine(const glm::vec3& start, const glm::vec3& end, std::vector<const SH::FlatHashCell<T>*>& outCells)
+	{
+		findCellLocationsForLine(start, end, lineCellScratch);
+
+		outCells.clear();
+		for (const glm::ivec3& cellLoc : lineCellScratch)
+		{
+			uint32_t cellIdx = findCellIdx(cellLoc);
+			if (cellIdx != INVALID_CELL) { outCells.push_back(&cellPool[cellIdx]); }
+		}
+	}
+
+	template<typename T>
+	void FlatSpatialHashGrid<T>::logDebugInformation()
+	{
+		std::cout << "slot count:" << slots.size() << " occupied slots:" << numOccupiedSlots
+			<< " pooled cells:" << cellPool.size() << " free cells:" << freeCells.size() << std::endl;
+	}
+}
@@ -13,6 +13,7 @@
 #include <tuple>
 #include <array>
 #include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SpatialHashingComponent.h"
+#include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SpatialHashingFlatGrid.h"
 #include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SHDebugUtils.h"
 #include <functional>
 #include <cstdint>
@@ -244,7 +245,7 @@ namespace
 		glm::vec3 velocity;
 		glm::vec3 color;
 		glm::vec3 gravityPnt;
-		std::unique_ptr<SH::HashEntry<GameEntity>> spatialHashEntry;
+		std::unique_ptr<SH::GridEntry<GameEntity>> spatialHashEntry;
 	};
 
 	////////////////////////////////////////////////////////////////////////////////////////////
@@ -304,7 +305,7 @@ namespace
 		glm::vec3 axisOffset{ 0, 0.005f, 0 };
 		glm::vec3 cachedVelocity;
 
-		SH::SpatialHashGrid<GameEntity> spatialHash{ glm::vec4{4,4,4,1} };
+		SH::Grid<GameEntity> spatialHash{ glm::vec4{4,4,4,1} }; //backend chosen by HASH_MAP_FLAT_OPEN_ADDRESSING
 
 		Utility::FrameRateDisplay fpsDisplay;
 
@@ -511,12 +512,12 @@ namespace
 				for (CubeEntity& cube : cubes)
 				{
 					//this is going to be slow
-					std::vector<std::shared_ptr<const SH::HashCell<GameEntity>>> cells;
+					std::vector<SH::GridCellRef<GameEntity>> cells;
 					
 					spatialHash.lookupCellsForEntry(*cube.spatialHashEntry, cells);
 					std::vector<glm::ivec3> cellLocs;
 					cellLocs.reserve(cells.size());
-					for (const std::shared_ptr<const SH::HashCell<GameEntity>>& cell : cells)
+					for (const SH::GridCellRef<GameEntity>& cell : cells)
 					{
 						cellLocs.push_back(cell->location);
 					}
@@ -0,0 +1,165 @@
+#include<iostream>
+#include<cstdint>
+#include<random>
+#include<chrono>
+#include<vector>
+#include<array>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SpatialHashingComponent.h"
+#include "ReferenceCode/OpenGL/Algorithms/SpatialHashing/SpatialHashingFlatGrid.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+// Headless benchmark comparing SpatialHashGrid against FlatSpatialHashGrid.
+//
+// Reproduces the SpatialHashingVisualized_ManyObjectsPerfTest scenario (cubes gravitating towards
+// random points in 4x4x4 cells) without a window, so it can be run on machines without a GPU.
+// Each frame every cube moves, is re-hashed, and queries its neighbours like a collision pass would.
+////////////////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+	class GameEntity
+	{
+	};
+
+	struct ColumnBasedTransform
+	{
+		glm::vec3 position = { 0, 0, 0 };
+		glm::quat rotQuat;
+		glm::vec3 scale = { 1, 1, 1 };
+
+		glm::mat4 getModelMatrix()
+		{
+			glm::mat4 model(1.0f);
+			model = glm::translate(model, position);
+			model = model * glm::toMat4(rotQuat);
+			model = glm::scale(model, scale);
+			return model;
+		}
+	};
+
+	template<template<typename> class EntryType>
+	struct CubeEntity : public GameEntity
+	{
+		std::array<glm::vec4, 8> getOBB()
+		{
+			glm::mat4 xform = transform.getModelMatrix();
+			std::array<glm::vec4, 8> OBB;
+			for (size_t vert = 0; vert < OBB.size(); ++vert)
+			{
+				OBB[vert] = xform * SH::AABB[vert];
+			}
+			return OBB;
+		}
+
+		ColumnBasedTransform transform;
+		glm::vec3 velocity;
+		glm::vec3 gravityPnt;
+		std::unique_ptr<EntryType<GameEntity>> spatialHashEntry;
+	};
+
+	struct BenchmarkResult
+	{
+		double insertMs = 0.0;
+		double updateMsPerFrame = 0.0;
+		double lookupMsPerFrame = 0.0;
+		size_t neighboursFound = 0;
+	};
+
+	template<template<typename> class GridType, template<typename> class EntryType, typename NodeRef>
+	BenchmarkResult runScenario(uint32_t numCubes, uint32_t numFrames, uint32_t seed)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		using Cube = CubeEntity<EntryType>;
+
+		BenchmarkResult result;
+
+		GridType<GameEntity> spatialHash{ glm::vec3{4, 4, 4} };
+		std::vector<Cube> cubes(numCubes);
+
+		//same distributions as the visualized perf test, but seeded so both backends see identical motion
+		std::mt19937 rng_eng(seed);
+		std::uniform_real_distribution<float> startDist(-50.f, 50.f);
+		std::uniform_real_distribution<float> gravityDist(-25.f, 25.f);
+		std::uniform_real_distribution<float> distSpeed(0, 3);
+		const float gravityDapeningFactor = 0.001f;
+		const float deltaTime = 1.f / 60.f;
+
+		Clock::time_point insertStart = Clock::now();
+		for (Cube& cube : cubes)
+		{
+			cube.transform.position = glm::vec3(startDist(rng_eng), startDist(rng_eng), startDist(rng_eng));
+			cube.gravityPnt = glm::vec3(gravityDist(rng_eng), gravityDist(rng_eng), gravityDist(rng_eng));
+
+			glm::vec3 startVelocity(startDist(rng_eng), startDist(rng_eng), startDist(rng_eng));
+			startVelocity = startVelocity == glm::vec3(0.f) ? glm::vec3(1, 0, 0) : startVelocity;
+			cube.velocity = glm::normalize(startVelocity) * (glm::abs(distSpeed(rng_eng)) + 1.0f);
+
+			cube.spatialHashEntry = spatialHash.insert(cube, cube.getOBB());
+		}
+		result.insertMs = std::chrono::duration<double, std::milli>(Clock::now() - insertStart).count();
+
+		std::vector<NodeRef> overlappingNodes;
+		double totalUpdateMs = 0.0;
+		double totalLookupMs = 0.0;
+		for (uint32_t frame = 0; frame < numFrames; ++frame)
+		{
+			Clock::time_point updateStart = Clock::now();
+			for (Cube& cube : cubes)
+			{
+				cube.transform.position += cube.velocity * deltaTime;
+				spatialHash.updateEntry(cube.spatialHashEntry, cube.getOBB());
+				cube.velocity += gravityDapeningFactor * (cube.gravityPnt - cube.transform.position);
+			}
+			Clock::time_point lookupStart = Clock::now();
+			for (Cube& cube : cubes)
+			{
+				spatialHash.lookupNodesInCells(*cube.spatialHashEntry, overlappingNodes);
+				result.neighboursFound += overlappingNodes.size();
+			}
+			Clock::time_point frameEnd = Clock::now();
+
+			totalUpdateMs += std::chrono::duration<double, std::milli>(lookupStart - updateStart).count();
+			totalLookupMs += std::chrono::duration<double, std::milli>(frameEnd - lookupStart).count();
+		}
+		result.updateMsPerFrame = totalUpdateMs / numFrames;
+		result.lookupMsPerFrame = totalLookupMs / numFrames;
+
+		//entries must release before the grid
+		cubes.clear();
+		return result;
+	}
+
+	void true_main()
+	{
+		const uint32_t numFrames = 120;
+		const uint32_t seed = 1337;
+
+		std::cout << "spatial hash benchmark: " << numFrames << " frames per run" << std::endl;
+		for (uint32_t numCubes : { 5000u, 10000u, 20000u })
+		{
+			BenchmarkResult legacy = runScenario<SH::SpatialHashGrid, SH::HashEntry, std::shared_ptr<SH::GridNode<GameEntity>>>(numCubes, numFrames, seed);
+			BenchmarkResult flat = runScenario<SH::FlatSpatialHashGrid, SH::FlatHashEntry, SH::FlatGridNode<GameEntity>*>(numCubes, numFrames, seed);
+
+			if (legacy.neighboursFound != flat.neighboursFound)
+			{
+				std::cerr << "FAILED: grid backends disagree on neighbours found " << legacy.neighboursFound << " vs " << flat.neighboursFound << std::endl;
+			}
+
+			double legacyFrameMs = legacy.updateMsPerFrame + legacy.lookupMsPerFrame;
+			double flatFrameMs = flat.updateMsPerFrame + flat.lookupMsPerFrame;
+			std::cout << numCubes << " entities" << std::endl;
+			std::cout << "\tunordered_multimap: insert " << legacy.insertMs << "ms | update " << legacy.updateMsPerFrame << "ms/frame | lookup " << legacy.lookupMsPerFrame << "ms/frame" << std::endl;
+			std::cout << "\tflat open address:  insert " << flat.insertMs << "ms | update " << flat.updateMsPerFrame << "ms/frame | lookup " << flat.lookupMsPerFrame << "ms/frame" << std::endl;
+			std::cout << "\tspeedup: " << legacyFrameMs / flatFrameMs << "x" << std::endl;
+		}
+	}
+}
+
+//int main()
+//{
+//	true_main();
+//}
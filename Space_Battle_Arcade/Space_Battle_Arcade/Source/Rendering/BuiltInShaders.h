@@ -195,6 +195,47 @@ namespace SA
 				}
 			)";
 
+	//instanced version of the emissive shader; model and color come from per instance attributes (see ModelInstance)
+	const char* const forwardShadedModel_InstancedEmissive_vertSrc = R"(
+				#version 330 core
+				layout (location = 0) in vec3 position;			
+				layout (location = 1) in vec3 normal;	
+				layout (location = 2) in vec2 textureCoordinates;
+				layout (location = 7) in vec4 instanceColor;
+				layout (location = 8) in mat4 instanceModel;
+				
+				uniform mat4 view;
+				uniform mat4 projection;
+
+				out vec3 fragNormal;
+				out vec3 fragPosition;
+				out vec2 interpTextCoords;
+				out vec3 fragLightColor;
+
+				void main(){
+					gl_Position = projection * view * instanceModel * vec4(position, 1);
+					fragPosition = vec3(instanceModel * vec4(position, 1));
+					fragNormal = normalize(mat3(transpose(inverse(instanceModel))) * normal);
+					interpTextCoords = textureCoordinates;
+					fragLightColor = instanceColor.rgb;
+				}
+			)";
+
+	const char* const forwardShadedModel_InstancedEmissive_fragSrc = R"(
+				#version 330 core
+
+				out vec4 fragmentColor;
+
+				in vec3 fragNormal;
+				in vec3 fragPosition;
+				in vec2 interpTextCoords;
+				in vec3 fragLightColor;
+
+				void main(){
+					fragmentColor = vec4(fragLightColor, 1.0f);
+				}
+			)";
+
 
 	const char* const forwardShadedModel_vertSrc = R"(
 				#version 330 core
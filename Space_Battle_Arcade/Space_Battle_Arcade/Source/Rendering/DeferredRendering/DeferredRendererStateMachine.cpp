@@ -530,7 +530,6 @@ namespace SA
 	void DeferredRendererStateMachine::beginLightPass()
 	{
 		RenderSystem& renderSystem = GameBase::get().getRenderSystem();
-		const std::vector<sp<PointLight_Deferred>>& framePointLights = renderSystem.getFramePointLights();
 		const RenderData* frd = renderSystem.getFrameRenderData_Read(GameBase::get().getFrameNumber());
 
 		if (frd 
@@ -595,65 +594,62 @@ namespace SA
 			stencilWriterShader->setUniformMatrix4fv("view", 1, GL_FALSE, glm::value_ptr(view));
 			stencilWriterShader->setUniformMatrix4fv("projection", 1, GL_FALSE, glm::value_ptr(projection));
 
-			//perhaps we should do a processing step that gets all point light data ready, and sorted, so we can only render a set number
-			for (size_t idx = 0; idx < framePointLights.size(); ++idx)
+			//lights come from the frame snapshot; they were cleaned when the snapshot was taken
+			//only lights that reach a view cluster are drawn, most important first and capped to the light budget
+			for (uint32_t lightIdx : frd->lightClusters.getVisibleLights())
 			{
-				if (const sp<PointLight_Deferred>& light = framePointLights[idx])
-				{
-					if (light->getSystemData().bUserDataDirty) { light->clean(); }
-
-					//select between debug radius and real radius like a ternary
-					float lightRadius = light->getSystemData().maxRadius*float(!bDebugLightVolumes) + (1.f* float(bDebugLightVolumes));
-
-					//note: lights have been disabled as arrays for my light volumes; so they must be updated one at a time.
-					glm::mat4 sphereModelMatrix;
-					sphereModelMatrix = glm::translate(sphereModelMatrix, light->getUserData().position);
-					sphereModelMatrix = glm::scale(sphereModelMatrix, glm::vec3(lightRadius));
-
-					stencilWriterShader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(sphereModelMatrix));
-
-					//------STENCIL PASS---------
-					ec(glDisable(GL_CULL_FACE));			//make sure we process back faces, we need them to increment stencil (like below image)
-					ec(glClearStencil(0));					//sets value for clearing stencil, for debugging you can change this value 
-					ec(glStencilMask(0xFF));				//enable writing to stencil buffer
-					ec(glClear(GL_STENCIL_BUFFER_BIT));		//clear stencil before we mark volume
-					ec(glStencilFunc(GL_ALWAYS, 0, 0xFF)); //always write stencil results
-
-					// set it up so stencil is only written on depth failures, consider below to understand the set up.
-					//  light volume sphere                                   X
-					//      _____			        _____	                 _____			            _____
-					//    +  +1  +			      +  +1   +	               +   +0  +	              +   +1  +
-					//  +          +		    +          +             +          +		        +     X    +
-					// |            |		   |     X      |           |            |		       |            |
-					//  +          +		    +          +             +          +		    --- +     vp   +  -----
-					//    +  -1   +			      +       +	               +   +0  +		 	|     +      + not    |
-					//      -----			        -----	                 -----			    |behind ----- rendered|
-					//        X                                                                 |_____________________|
-					//      vp                       vp                       vp
-					//
-					// X is object; vp is viewer's position. When stencil is 0, no lighting is applied
-					//
-					// stencil = 0;                stencil = +1              stencil = 0               stencil = +1
-					ec(glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP)); //note this is "DEPTH FAILS", less intuitive than depth pass but works better
-					ec(glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP)); //note: stencil does not have negative numbers according to spec
-
-					stencilWriterShader->use();
-					sphereMesh->render();
-
-					//------LIGHTING PASS--------
-					ec(glDisable(GL_DEPTH_TEST)); //don't allow depth to stop rendering a sphere
-					ec(glEnable(GL_CULL_FACE));
-					ec(glCullFace(GL_FRONT)); //use back of sphere for lighting so that if camera is inside sphere lighting is still rendered
-					lightingStage_LightVolume_PointLight_Shader->use();
-					lightingStage_LightVolume_PointLight_Shader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(sphereModelMatrix));
-					light->applyUniforms(*lightingStage_LightVolume_PointLight_Shader); //make this not a function of light? assumes a lot about uniform names
-
-					ec(glStencilMask(0)); //disable writing
-					ec(glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP));
-					ec(glStencilFunc(GL_NOTEQUAL, 0, 0xFF)); //only write if passed behind front_face (-1) and infront of  back_face(+1); (-1 + 1 = 0);
-					sphereMesh->render(); 
-					ec(glEnable(GL_DEPTH_TEST)); //reenable
-				}
+				const RenderData::PointLightSnapshot& light = frd->pointLights[lightIdx];
+				//select between debug radius and real radius like a ternary
+				float lightRadius = light.maxRadius*float(!bDebugLightVolumes) + (1.f* float(bDebugLightVolumes));
+
+				//note: lights have been disabled as arrays for my light volumes; so they must be updated one at a time.
+				glm::mat4 sphereModelMatrix;
+				sphereModelMatrix = glm::translate(sphereModelMatrix, light.userData.position);
+				sphereModelMatrix = glm::scale(sphereModelMatrix, glm::vec3(lightRadius));
+
+				stencilWriterShader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(sphereModelMatrix));
+
+				//------STENCIL PASS---------
+				ec(glDisable(GL_CULL_FACE));			//make sure we process back faces, we need them to increment stencil (like below image)
+				ec(glClearStencil(0));					//sets value for clearing stencil, for debugging you can change this value 
+				ec(glStencilMask(0xFF));				//enable writing to stencil buffer
+				ec(glClear(GL_STENCIL_BUFFER_BIT));		//clear stencil before we mark volume
+				ec(glStencilFunc(GL_ALWAYS, 0, 0xFF)); //always write stencil results
+
+				// set it up so stencil is only written on depth failures, consider below to understand the set up.
+				//  light volume sphere                                   X
+				//      _____			        _____	                 _____			            _____
+				//    +  +1  +			      +  +1   +	               +   +0  +	              +   +1  +
+				//  +          +		    +          +             +          +		        +     X    +
+				// |            |		   |     X      |           |            |		       |            |
+				//  +          +		    +          +             +          +		    --- +     vp   +  -----
+				//    +  -1   +			      +       +	               +   +0  +		 	|     +      + not    |
+				//      -----			        -----	                 -----			    |behind ----- rendered|
+				//        X                                                                 |_____________________|
+				//      vp                       vp                       vp
+				//
+				// X is object; vp is viewer's position. When stencil is 0, no lighting is applied
+				//
+				// stencil = 0;                stencil = +1              stencil = 0               stencil = +1
+				ec(glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP)); //note this is "DEPTH FAILS", less intuitive than depth pass but works better
+				ec(glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP)); //note: stencil does not have negative numbers according to spec
+
+				stencilWriterShader->use();
+				sphereMesh->render();
+
+				//------LIGHTING PASS--------
+				ec(glDisable(GL_DEPTH_TEST)); //don't allow depth to stop rendering a sphere
+				ec(glEnable(GL_CULL_FACE));
+				ec(glCullFace(GL_FRONT)); //use back of sphere for lighting so that if camera is inside sphere lighting is still rendered
+				lightingStage_LightVolume_PointLight_Shader->use();
+				lightingStage_LightVolume_PointLight_Shader->setUniformMatrix4fv("model", 1, GL_FALSE, glm::value_ptr(sphereModelMatrix));
+				PointLight_Deferred::applyUniforms(*lightingStage_LightVolume_PointLight_Shader, light.userData); //make this not a function of light? assumes a lot about uniform names
+
+				ec(glStencilMask(0)); //disable writing
+				ec(glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP));
+				ec(glStencilFunc(GL_NOTEQUAL, 0, 0xFF)); //only write if passed behind front_face (-1) and infront of  back_face(+1); (-1 + 1 = 0);
+				sphereMesh->render(); 
+				ec(glEnable(GL_DEPTH_TEST)); //reenable
 			}
 			////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 			// clean up point light set up 
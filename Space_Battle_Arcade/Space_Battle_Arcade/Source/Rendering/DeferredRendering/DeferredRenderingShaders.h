@@ -77,3 +77,50 @@ const char* const gbufferShader_emissive_fs = R"(
 		albedo_spec.a = 1.f;
 	}
 )";
+
+//instanced emissive geometry; model and color come from per instance attributes (see ModelInstance)
+const char* const gbufferShader_instancedEmissive_vs = R"(
+	#version 330 core
+	layout (location = 0) in vec3 position;			
+	layout (location = 1) in vec3 normal;	
+	layout (location = 2) in vec2 textureCoordinates;
+	layout (location = 7) in vec4 instanceColor;
+	layout (location = 8) in mat4 instanceModel;
+				
+	uniform mat4 view;
+	uniform mat4 projection;
+
+	out vec3 fragNormal;
+	out vec3 fragPosition;
+	out vec2 interpTextCoords;
+	out vec3 fragLightColor;
+
+	void main(){
+		gl_Position = projection * view * instanceModel * vec4(position, 1);
+		fragPosition = vec3(instanceModel * vec4(position, 1));
+		fragNormal = normalize(mat3(transpose(inverse(instanceModel))) * normal);
+		interpTextCoords = textureCoordinates;
+		fragLightColor = instanceColor.rgb;
+	}
+)";
+
+const char* const gbufferShader_instancedEmissive_fs = R"(
+	#version 330 core
+
+	//framebuffer locations 
+	layout (location = 0) out vec3 position;
+	layout (location = 1) out vec3 normal;
+	layout (location = 2) out vec4 albedo_spec;
+
+	in vec3 fragNormal;
+	in vec3 fragPosition;
+	in vec2 interpTextCoords;
+	in vec3 fragLightColor;
+
+	void main(){
+		position.rgb = fragPosition;
+		normal.rgb = fragNormal;
+		albedo_spec.rgb = fragLightColor;
+		albedo_spec.a = 1.f;
+	}
+)";
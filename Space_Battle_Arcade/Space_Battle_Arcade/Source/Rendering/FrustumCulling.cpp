@@ -0,0 +1,111 @@
+#include "Rendering/FrustumCulling.h"
+
+namespace SA
+{
+	FrustumPlanes FrustumPlanes::fromProjectionView(const glm::mat4& projection_view)
+	{
+		//glm is column major, so row i is the ith component of each column
+		const glm::mat4& m = projection_view;
+		glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+		glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+		glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+		glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+		FrustumPlanes frustum;
+		frustum.planes[PLANE_LEFT] = row3 + row0;
+		frustum.planes[PLANE_RIGHT] = row3 - row0;
+		frustum.planes[PLANE_BOTTOM] = row3 + row1;
+		frustum.planes[PLANE_TOP] = row3 - row1;
+		frustum.planes[PLANE_NEAR] = row3 + row2;
+		frustum.planes[PLANE_FAR] = row3 - row2;
+
+		//normalize so plane distances are in world units and can be compared against sphere radii
+		for (glm::vec4& plane : frustum.planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+		return frustum;
+	}
+
+	void FrustumCuller::clear()
+	{
+		centersX.clear();
+		centersY.clear();
+		centersZ.clear();
+		radii.clear();
+		visibleIndices.clear();
+	}
+
+	uint32_t FrustumCuller::addSphere(const glm::vec3& center, float radius)
+	{
+		centersX.push_back(center.x);
+		centersY.push_back(center.y);
+		centersZ.push_back(center.z);
+		radii.push_back(radius);
+		return uint32_t(radii.size() - 1);
+	}
+
+	void FrustumCuller::acceptAll()
+	{
+		lodHints.assign(radii.size(), 0);
+		visibleIndices.clear();
+		for (uint32_t sphereIdx = 0; sphereIdx < radii.size(); ++sphereIdx)
+		{
+			visibleIndices.push_back(sphereIdx);
+		}
+	}
+
+	void FrustumCuller::cull(const glm::mat4& projection_view, const glm::vec3& cameraPosition)
+	{
+		const size_t count = radii.size();
+		visibleMask.resize(count);
+		lodHints.resize(count);
+		visibleIndices.clear();
+
+		//hoist everything into locals so the loop body only reads the sphere arrays
+		const FrustumPlanes frustum = FrustumPlanes::fromProjectionView(projection_view);
+		const glm::vec4 p0 = frustum.planes[0], p1 = frustum.planes[1], p2 = frustum.planes[2];
+		const glm::vec4 p3 = frustum.planes[3], p4 = frustum.planes[4], p5 = frustum.planes[5];
+		const float camX = cameraPosition.x, camY = cameraPosition.y, camZ = cameraPosition.z;
+		const float lod1Sq = lodDistances[0] * lodDistances[0];
+		const float lod2Sq = lodDistances[1] * lodDistances[1];
+		const float lod3Sq = lodDistances[2] * lodDistances[2];
+		const float maxDist = maxDrawDistance;
+
+		const float* xs = centersX.data();
+		const float* ys = centersY.data();
+		const float* zs = centersZ.data();
+		const float* rs = radii.data();
+		int32_t* visible = visibleMask.data();
+		int32_t* lods = lodHints.data();
+
+		//branchless so this vectorizes; every test is evaluated and the results are and-ed together
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			const float x = xs[idx], y = ys[idx], z = zs[idx], negRadius = -rs[idx];
+
+			int32_t bInside = int32_t(p0.x * x + p0.y * y + p0.z * z + p0.w >= negRadius);
+			bInside &= int32_t(p1.x * x + p1.y * y + p1.z * z + p1.w >= negRadius);
+			bInside &= int32_t(p2.x * x + p2.y * y + p2.z * z + p2.w >= negRadius);
+			bInside &= int32_t(p3.x * x + p3.y * y + p3.z * z + p3.w >= negRadius);
+			bInside &= int32_t(p4.x * x + p4.y * y + p4.z * z + p4.w >= negRadius);
+			bInside &= int32_t(p5.x * x + p5.y * y + p5.z * z + p5.w >= negRadius);
+
+			const float dx = x - camX, dy = y - camY, dz = z - camZ;
+			const float distSq = dx * dx + dy * dy + dz * dz;
+			const float reach = maxDist - negRadius;
+			bInside &= int32_t(distSq <= reach * reach);
+
+			visible[idx] = bInside;
+			lods[idx] = int32_t(distSq > lod1Sq) + int32_t(distSq > lod2Sq) + int32_t(distSq > lod3Sq);
+		}
+
+		for (uint32_t sphereIdx = 0; sphereIdx < count; ++sphereIdx)
+		{
+			if (visible[sphereIdx])
+			{
+				visibleIndices.push_back(sphereIdx);
+			}
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace SA
+{
+	/** Normalized planes pointing into the frustum; xyz is the normal and w the offset */
+	struct FrustumPlanes
+	{
+		enum : size_t { PLANE_LEFT = 0, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, NUM_PLANES }; //not NEAR/FAR, windows headers define those as macros
+
+		/** Gribb/Hartmann plane extraction from an OpenGL style projection * view matrix */
+		static FrustumPlanes fromProjectionView(const glm::mat4& projection_view);
+
+		std::array<glm::vec4, NUM_PLANES> planes;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Culls bounding spheres against a camera frustum and max draw distance, and buckets visible ones by distance.
+	//
+	// Spheres are stored structure-of-arrays and culled in a single branchless loop so the compiler can
+	// vectorize it; compaction into the visible list is a separate scalar pass. Buffers keep their capacity
+	// between frames. This does not touch GL or game state, so it can be tested and benchmarked headless.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class FrustumCuller
+	{
+	public:
+		static constexpr uint8_t NUM_LOD_BUCKETS = 4;
+
+		void clear();
+
+		/** Returns the index used by getVisibleIndices and getLodHint */
+		uint32_t addSphere(const glm::vec3& center, float radius);
+
+		void cull(const glm::mat4& projection_view, const glm::vec3& cameraPosition);
+
+		/** Marks every sphere visible at the nearest lod, for frames with no camera or when culling is turned off */
+		void acceptAll();
+
+		/** Indices of spheres that survived the last cull, in the order they were added */
+		const std::vector<uint32_t>& getVisibleIndices() const { return visibleIndices; }
+
+		/** 0 is nearest; only meaningful for visible spheres */
+		uint8_t getLodHint(uint32_t sphereIdx) const { return uint8_t(lodHints[sphereIdx]); }
+
+		size_t size() const { return radii.size(); }
+
+		/** Distances where each lod bucket after the first starts */
+		void setLodDistances(const std::array<float, NUM_LOD_BUCKETS - 1>& inLodDistances) { lodDistances = inLodDistances; }
+		void setMaxDrawDistance(float inMaxDrawDistance) { maxDrawDistance = inMaxDrawDistance; }
+
+	private:
+		std::vector<float> centersX;
+		std::vector<float> centersY;
+		std::vector<float> centersZ;
+		std::vector<float> radii;
+		std::vector<int32_t> visibleMask;	//int32 lanes match the float lanes, so the cull loop vectorizes
+		std::vector<int32_t> lodHints;
+		std::vector<uint32_t> visibleIndices;
+
+		std::array<float, NUM_LOD_BUCKETS - 1> lodDistances = { 250.f, 1000.f, 4000.f };
+		float maxDrawDistance = 100000.f;
+	};
+}
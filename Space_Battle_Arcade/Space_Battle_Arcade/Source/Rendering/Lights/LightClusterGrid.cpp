@@ -0,0 +1,114 @@
+#include "Rendering/Lights/LightClusterGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SA
+{
+	void LightClusterGrid::clear()
+	{
+		positions.clear();
+		radii.clear();
+		intensities.clear();
+		visibleLights.clear();
+		numDroppedByBudget = 0;
+	}
+
+	uint32_t LightClusterGrid::addLight(const glm::vec3& position, float radius, float intensity)
+	{
+		positions.push_back(position);
+		radii.push_back(radius);
+		intensities.push_back(intensity);
+		return uint32_t(radii.size() - 1);
+	}
+
+	void LightClusterGrid::bin(const glm::mat4& view, const glm::mat4& projection)
+	{
+		//glm::perspective: [2][2] = -(f+n)/(f-n), [3][2] = -2fn/(f-n)
+		nearZ = projection[3][2] / (projection[2][2] - 1.f);
+		farZ = projection[3][2] / (projection[2][2] + 1.f);
+		if (!(nearZ > 0.f)) { nearZ = 0.1f; }
+		if (!std::isfinite(farZ) || farZ <= nearZ) { farZ = nearZ * 100000.f; } //infinite projection
+
+		const size_t numLights = radii.size();
+		importance.resize(numLights);
+		visibleLights.clear();
+
+		/////////////////////////////////////////////////////////////////////////////////////
+		// bound each light against the frustum
+		/////////////////////////////////////////////////////////////////////////////////////
+		for (uint32_t lightIdx = 0; lightIdx < numLights; ++lightIdx)
+		{
+			const glm::vec3 center_v = glm::vec3(view * glm::vec4(positions[lightIdx], 1.f));
+			const float radius = radii[lightIdx];
+			const float depth = -center_v.z;
+
+			const float minDepth = std::max(depth - radius, nearZ);
+			const float maxDepth = std::min(depth + radius, farZ);
+			if (minDepth > maxDepth)
+			{
+				continue; //behind the camera or past the far plane
+			}
+
+			//the projection of the sphere's view space box, clamped in front of the near plane, contains the projected sphere
+			glm::vec2 ndcMin{ std::numeric_limits<float>::max() };
+			glm::vec2 ndcMax{ std::numeric_limits<float>::lowest() };
+			for (int corner = 0; corner < 8; ++corner)
+			{
+				const glm::vec4 corner_v{
+					center_v.x + ((corner & 1) ? radius : -radius),
+					center_v.y + ((corner & 2) ? radius : -radius),
+					(corner & 4) ? -maxDepth : -minDepth,
+					1.f };
+				const glm::vec4 corner_clip = projection * corner_v;
+				const glm::vec2 corner_ndc = glm::vec2(corner_clip) / corner_clip.w;
+				ndcMin = glm::min(ndcMin, corner_ndc);
+				ndcMax = glm::max(ndcMax, corner_ndc);
+			}
+			if (ndcMax.x < -1.f || ndcMin.x > 1.f || ndcMax.y < -1.f || ndcMin.y > 1.f)
+			{
+				continue; //off screen
+			}
+
+			//brightness scaled by a rough solid angle; lights the camera is inside cover the whole screen
+			const float coverage = std::min(radius / std::max(depth, nearZ), 1.f);
+			importance[lightIdx] = intensities[lightIdx] * coverage * coverage;
+			visibleLights.push_back(lightIdx);
+		}
+
+		rankAndApplyBudget();
+	}
+
+	void LightClusterGrid::acceptAll()
+	{
+		const size_t numLights = radii.size();
+		importance.resize(numLights);
+		visibleLights.clear();
+		for (uint32_t lightIdx = 0; lightIdx < numLights; ++lightIdx)
+		{
+			importance[lightIdx] = intensities[lightIdx] * radii[lightIdx] * radii[lightIdx];
+			visibleLights.push_back(lightIdx);
+		}
+		rankAndApplyBudget();
+	}
+
+	void LightClusterGrid::rankAndApplyBudget()
+	{
+		auto moreImportant = [this](uint32_t a, uint32_t b) { return firstIsMoreImportant(a, b); };
+
+		numDroppedByBudget = 0;
+		if (visibleLights.size() > maxLights)
+		{
+			std::nth_element(visibleLights.begin(), visibleLights.begin() + maxLights, visibleLights.end(), moreImportant);
+			numDroppedByBudget = uint32_t(visibleLights.size() - maxLights);
+			visibleLights.resize(maxLights);
+		}
+		std::sort(visibleLights.begin(), visibleLights.end(), moreImportant);
+	}
+
+	bool LightClusterGrid::firstIsMoreImportant(uint32_t lightA, uint32_t lightB) const
+	{
+		//ties go to the earlier light so the ranking does not flicker between frames
+		return importance[lightA] > importance[lightB] || (importance[lightA] == importance[lightB] && lightA < lightB);
+	}
+}
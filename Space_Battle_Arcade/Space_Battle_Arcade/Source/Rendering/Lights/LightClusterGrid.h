@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Culls and ranks point lights for the light pass.
+	//
+	// Each light's sphere is bounded conservatively in NDC and depth; lights that cannot reach the view frustum
+	// are culled. When more lights survive than the budget allows, the least important ones (intensity scaled by
+	// how much of the screen they may cover) are dropped. This does not touch GL or game state, so it can be
+	// tested and benchmarked headless.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class LightClusterGrid
+	{
+	public:
+		/** Most lights kept after binning; less important lights past this are dropped */
+		void setLightBudget(uint32_t inMaxLights) { maxLights = inMaxLights; }
+
+		void clear();
+
+		/** Returns the index used by getVisibleLights. Intensity only matters for ranking. */
+		uint32_t addLight(const glm::vec3& position, float radius, float intensity);
+
+		/** Expects an OpenGL style perspective projection; near and far planes are read from it */
+		void bin(const glm::mat4& view, const glm::mat4& projection);
+
+		/** Keeps every light up to the budget without culling, for frames with no camera */
+		void acceptAll();
+
+		/** Lights that survived the last bin, most important first */
+		const std::vector<uint32_t>& getVisibleLights() const { return visibleLights; }
+		uint32_t getNumDroppedByBudget() const { return numDroppedByBudget; }
+		size_t size() const { return radii.size(); }
+
+		/** Near and far planes read from the projection of the last bin */
+		float getNear() const { return nearZ; }
+		float getFar() const { return farZ; }
+
+	private:
+		void rankAndApplyBudget();
+		bool firstIsMoreImportant(uint32_t lightA, uint32_t lightB) const;
+
+	private:
+		uint32_t maxLights = std::numeric_limits<uint32_t>::max();
+
+		std::vector<glm::vec3> positions;
+		std::vector<float> radii;
+		std::vector<float> intensities;
+
+		//per bin, indexed by light
+		std::vector<float> importance;
+
+		std::vector<uint32_t> visibleLights;
+		uint32_t numDroppedByBudget = 0;
+
+		float nearZ = 0.1f;
+		float farZ = 1000.f;
+	};
+}
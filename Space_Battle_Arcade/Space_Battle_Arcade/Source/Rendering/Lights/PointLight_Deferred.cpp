@@ -7,7 +7,7 @@ namespace SA
 {
 
 
-	void PointLight_Deferred::applyUniforms(Shader& shader)
+	void PointLight_Deferred::applyUniforms(Shader& shader, const UserData& lightData)
 	{
 		/* --UNIFORM TO UPDATE--
 		struct PointLight
@@ -19,13 +19,13 @@ namespace SA
 		uniform PointLight pointLights
 		*/
 
-		shader.setUniform3f("pointLights.ambientIntensity", userData.ambientIntensity);
-		shader.setUniform3f("pointLights.diffuseIntensity", userData.diffuseIntensity);
-		shader.setUniform3f("pointLights.specularIntensity", userData.specularIntensity);
-		shader.setUniform3f("pointLights.position", userData.position);
-		shader.setUniform1f("pointLights.constant", userData.attenuationConstant);
-		shader.setUniform1f("pointLights.linear", userData.attenuationLinear);
-		shader.setUniform1f("pointLights.quadratic", userData.attenuationQuadratic);
+		shader.setUniform3f("pointLights.ambientIntensity", lightData.ambientIntensity);
+		shader.setUniform3f("pointLights.diffuseIntensity", lightData.diffuseIntensity);
+		shader.setUniform3f("pointLights.specularIntensity", lightData.specularIntensity);
+		shader.setUniform3f("pointLights.position", lightData.position);
+		shader.setUniform1f("pointLights.constant", lightData.attenuationConstant);
+		shader.setUniform1f("pointLights.linear", lightData.attenuationLinear);
+		shader.setUniform1f("pointLights.quadratic", lightData.attenuationQuadratic);
 	}
 
 	void PointLight_Deferred::clean()
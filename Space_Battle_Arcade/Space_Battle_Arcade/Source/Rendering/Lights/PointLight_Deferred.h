@@ -42,7 +42,8 @@ namespace SA
 			return userData;
 		}
 		const SystemMetaData& getSystemData() { return systemMetaData; }
-		void applyUniforms(Shader& shader);
+		void applyUniforms(Shader& shader) { applyUniforms(shader, userData); }
+		static void applyUniforms(Shader& shader, const UserData& lightData);
 		void clean();
 	public:
 		UserData userData = {};
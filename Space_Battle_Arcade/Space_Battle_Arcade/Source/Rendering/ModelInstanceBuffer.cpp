@@ -0,0 +1,66 @@
+#include "Rendering/ModelInstanceBuffer.h"
+#include "Rendering/ModelInstanceStream.h"
+#include "Rendering/OpenGLHelpers.h"
+#include "Tools/ModelLoading/SAModel.h"
+
+#include <algorithm>
+
+namespace SA
+{
+	void ModelInstanceBuffer::upload(const ModelInstanceStream& stream)
+	{
+		if (!hasAcquiredResources() || stream.size() == 0)
+		{
+			return;
+		}
+
+		const size_t streamBytes = sizeof(ModelInstance) * stream.size();
+		ec(glBindBuffer(GL_ARRAY_BUFFER, instanceVBO));
+		if (streamBytes > capacityBytes)
+		{
+			//grow geometrically so battles ramping up don't reallocate every frame
+			capacityBytes = std::max(streamBytes, capacityBytes * 2);
+			ec(glBufferData(GL_ARRAY_BUFFER, capacityBytes, nullptr, GL_STREAM_DRAW));
+		}
+		ec(glBufferSubData(GL_ARRAY_BUFFER, 0, streamBytes, stream.getInstances().data()));
+	}
+
+	void ModelInstanceBuffer::bindInstanceAttributes(const Model3D& model, uint32_t firstInstance) const
+	{
+		const GLsizei stride = sizeof(ModelInstance);
+		const size_t runOffset = size_t(firstInstance) * sizeof(ModelInstance);
+
+		ec(glBindBuffer(GL_ARRAY_BUFFER, instanceVBO));
+		for (const Mesh3D& mesh : model.getMeshes())
+		{
+			ec(glBindVertexArray(mesh.getVAO()));
+
+			//attribute 7 = color
+			ec(glEnableVertexAttribArray(7));
+			ec(glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(runOffset + offsetof(ModelInstance, color))));
+			ec(glVertexAttribDivisor(7, 1));
+
+			//attributes 8-11 = model matrix, one vec4 column per attribute
+			for (GLuint column = 0; column < 4; ++column)
+			{
+				ec(glEnableVertexAttribArray(8 + column));
+				ec(glVertexAttribPointer(8 + column, 4, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(runOffset + offsetof(ModelInstance, model) + column * sizeof(glm::vec4))));
+				ec(glVertexAttribDivisor(8 + column, 1));
+			}
+		}
+		ec(glBindVertexArray(0));
+	}
+
+	void ModelInstanceBuffer::onAcquireGPUResources()
+	{
+		ec(glGenBuffers(1, &instanceVBO));
+		capacityBytes = 0;
+	}
+
+	void ModelInstanceBuffer::onReleaseGPUResources()
+	{
+		ec(glDeleteBuffers(1, &instanceVBO));
+		instanceVBO = 0;
+		capacityBytes = 0;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Rendering/SAGPUResource.h"
+#include <glad/glad.h>
+
+namespace SA
+{
+	class Model3D;
+	class ModelInstanceStream;
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Persistent GPU buffer for a ModelInstanceStream.
+	//
+	// The buffer is only reallocated when a frame has more instances than any frame before it; otherwise the
+	// stream is written into the existing storage.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class ModelInstanceBuffer : public GPUResource
+	{
+	public:
+		void upload(const ModelInstanceStream& stream);
+
+		/** Points the instance attributes of each of the model's meshes at the run starting at firstInstance */
+		void bindInstanceAttributes(const Model3D& model, uint32_t firstInstance) const;
+	private:
+		virtual void onAcquireGPUResources() override;
+		virtual void onReleaseGPUResources() override;
+	private:
+		GLuint instanceVBO = 0;
+		size_t capacityBytes = 0;
+	};
+}
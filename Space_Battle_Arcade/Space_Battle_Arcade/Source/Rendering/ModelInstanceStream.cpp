@@ -0,0 +1,41 @@
+#include "Rendering/ModelInstanceStream.h"
+
+namespace SA
+{
+	void ModelInstanceStream::build(const glm::mat4* xforms, const glm::vec3* colors, const uint16_t* modelIds, size_t count, size_t numModels)
+	{
+		//counting sort by model; there are only a handful of models so this is two linear passes
+		modelCursors.assign(numModels, 0);
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			++modelCursors[modelIds[idx]];
+		}
+
+		batches.clear();
+		uint32_t runningStart = 0;
+		for (size_t modelId = 0; modelId < numModels; ++modelId)
+		{
+			const uint32_t modelCount = modelCursors[modelId];
+			if (modelCount > 0)
+			{
+				batches.push_back(ModelInstanceBatch{ static_cast<uint16_t>(modelId), runningStart, modelCount });
+			}
+			modelCursors[modelId] = runningStart;
+			runningStart += modelCount;
+		}
+
+		instances.resize(count);
+		for (size_t idx = 0; idx < count; ++idx)
+		{
+			ModelInstance& instance = instances[modelCursors[modelIds[idx]]++];
+			instance.model = xforms[idx];
+			instance.color = glm::vec4(colors[idx], 1.f);
+		}
+	}
+
+	void ModelInstanceStream::clear()
+	{
+		instances.clear();
+		batches.clear();
+	}
+}
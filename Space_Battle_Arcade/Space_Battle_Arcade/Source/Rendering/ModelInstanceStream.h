@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace SA
+{
+	/** Per instance vertex data, interleaved. Vertex attribute 7 is color and 8-11 is the model matrix, the same slots particle instancing uses. */
+	struct ModelInstance
+	{
+		glm::mat4 model{ 1.f };
+		glm::vec4 color{ 1.f };
+	};
+
+	/** A run of instances that share a model, drawn with one instanced call */
+	struct ModelInstanceBatch
+	{
+		uint16_t modelId = 0;
+		uint32_t firstInstance = 0;
+		uint32_t numInstances = 0;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// CPU side instance stream for instanced model rendering.
+	//
+	// Instances are grouped by model id so each model is a contiguous run that can be drawn with a single
+	// instanced call. Buffers keep their capacity so rebuilding every frame does not allocate once warmed up.
+	// This does not touch GL; see ModelInstanceBuffer for the upload.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class ModelInstanceStream
+	{
+	public:
+		/** Rebuilds the stream from parallel arrays of count entries. Model ids must be less than numModels. */
+		void build(const glm::mat4* xforms, const glm::vec3* colors, const uint16_t* modelIds, size_t count, size_t numModels);
+		void clear();
+
+		const std::vector<ModelInstance>& getInstances() const { return instances; }
+		const std::vector<ModelInstanceBatch>& getBatches() const { return batches; }
+		size_t size() const { return instances.size(); }
+
+	private:
+		std::vector<ModelInstance> instances;
+		std::vector<ModelInstanceBatch> batches;
+		std::vector<uint32_t> modelCursors;
+	};
+}
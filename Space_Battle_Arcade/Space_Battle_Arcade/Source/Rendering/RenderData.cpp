@@ -1,30 +1,141 @@
 #include "Rendering/RenderData.h"
 
+#include <algorithm>
+
 #include "GameFramework/SAGameBase.h"
+#include "GameFramework/RenderModelEntity.h"
+#include "GameFramework/EngineParticles/ParticleInstanceData.h"
 
 namespace SA
 {
 	RenderData::RenderData()
+		: RenderData(GameBase::getConstants().MAX_DIR_LIGHTS)
+	{
+	}
+
+	RenderData::RenderData(uint32_t numDirLights)
 	{
-		//dirLights.reserve(GameBase::getConstants().MAX_DIR_LIGHTS);
-		dirLights.resize(GameBase::getConstants().MAX_DIR_LIGHTS);
+		dirLights.resize(numDirLights);
 		reset();
 	}
 
 	void RenderData::reset()
 	{
-		for (size_t idx = 0; idx < GameBase::getConstants().MAX_DIR_LIGHTS; ++idx)
+		for (DirectionLight& dirLight : dirLights)
 		{
-			dirLights[idx] = DirectionLight{};
+			dirLight = DirectionLight{};
 		}
 		view = glm::mat4{ 1.f };
 		projection = glm::mat4{ 1.f };
+		projection_view = glm::mat4{ 1.f };
+		bHasCameraFrustum = false;
 		ambientLightIntensity = glm::vec3{ 0.f };
 		playerCamerasPositions.resize(1); //shrink to 1 player camera
 		playerCamerasPositions[0] = glm::vec3(0.f); //zero out the camera
 		dt_sec = 0.f;
 		renderClearColor = glm::vec3(0.f);
+		camera = CameraSnapshot{};
+
+		modelDraws.clear();
+		entities.clear();
+		highlights.clear();
+		playerEntities.clear();
+		playerHUDs.clear();
+		teamObjectivesAlive.clear();
+		playerAttackers.clear();
+		healSeekers.clear();
+		pointLights.clear();
+		lightClusters.clear();
+		projectileInstances.clear();
+		for (ParticleBatchSnapshot& batch : particleBatches)
+		{
+			batch.numInstances = 0; //keep the buffers, particle counts are similar frame to frame
+		}
 	}
 
-}
+	RenderData::EntitySnapshot RenderData::snapshotEntity(const RenderModelEntity& entity, const glm::mat4& modelMatrix, uint8_t lodHint)
+	{
+		EntitySnapshot snapshot{ modelMatrix, lodHint, uint32_t(modelDraws.size()), 0 };
+		entity.cacheDraws(*this, modelMatrix);
+		snapshot.numDraws = uint32_t(modelDraws.size()) - snapshot.firstDraw;
+		return snapshot;
+	}
+
+	void RenderData::addEntity(const RenderModelEntity& entity, const glm::mat4& modelMatrix, uint8_t lodHint)
+	{
+		entities.push_back(snapshotEntity(entity, modelMatrix, lodHint));
+	}
+
+	void RenderData::addEntity(const RenderModelEntity& entity)
+	{
+		addEntity(entity, entity.getTransform().getModelMatrix());
+	}
+
+	void RenderData::addPointLight(PointLight_Deferred& light)
+	{
+		if (light.getSystemData().bUserDataDirty)
+		{
+			light.clean();
+		}
+		pointLights.push_back(PointLightSnapshot{ light.getUserData(), light.getSystemData().maxRadius });
+	}
+
+	void RenderData::ParticleBatchSnapshot::copyFrom(const EffectInstanceData& eid)
+	{
+		numInstances = eid.numInstancesThisFrame;
+		numMat4PerInstance = eid.numMat4PerInstance;
+		numVec4PerInstance = eid.numVec4PerInstance;
+
+		//assign reuses capacity
+		mat4Data.assign(eid.mat4Data.begin(), eid.mat4Data.begin() + numMat4PerInstance * numInstances);
+		vec4Data.assign(eid.vec4Data.begin(), eid.vec4Data.begin() + numVec4PerInstance * numInstances);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Frame ring
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	RenderFrameRing::RenderFrameRing(uint32_t numDirLights)
+	{
+		//+1 for the frame being written, +1 so the next frame can be written while render reads the oldest
+		for (size_t slotIdx = 0; slotIdx < size_t(MAX_DELAY_FRAMES) + 2; ++slotIdx)
+		{
+			slots.push_back(new_sp<RenderData>(numDirLights));
+		}
+	}
+
+	RenderData& RenderFrameRing::beginWrite(uint64_t frameNumber)
+	{
+		if (!bAnyWritten)
+		{
+			bAnyWritten = true;
+			firstWrittenFrame = frameNumber;
+		}
+		newestWrittenFrame = frameNumber;
+
+		RenderData& frameData = slotFor(frameNumber);
+		frameData.reset();
+		return frameData;
+	}
+
+	const RenderData& RenderFrameRing::read(uint64_t frameNumber) const
+	{
+		if (!bAnyWritten)
+		{
+			return *slots[0]; //nothing simulated yet, default data
+		}
+
+		//reads made while simulating a frame see the last frame that was cached
+		uint64_t readFrame = std::max(std::min(frameNumber, newestWrittenFrame), firstWrittenFrame);
 
+		//until enough frames have been cached, render the oldest one rather than a slot that was never written
+		readFrame -= std::min<uint64_t>(delayFrames, readFrame - firstWrittenFrame);
+
+		return slotFor(readFrame);
+	}
+
+	void RenderFrameRing::setDelayFrames(uint8_t inDelayFrames)
+	{
+		delayFrames = std::min(inDelayFrames, MAX_DELAY_FRAMES);
+	}
+}
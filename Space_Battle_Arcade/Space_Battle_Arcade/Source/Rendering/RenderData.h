@@ -1,27 +1,165 @@
 #pragma once
 #include <vector>
+#include <cstdint>
+#include <optional>
+#include <glm/gtc/quaternion.hpp>
 #include "GameFramework/SAGameEntity.h"
 #include "Game/SASpaceArcadeGlobalConstants.h"
 #include "Rendering/Lights/SADirectionLight.h"
+#include "Rendering/Lights/PointLight_Deferred.h"
+#include "Rendering/Lights/LightClusterGrid.h"
+#include "Rendering/ModelInstanceStream.h"
 
 namespace SA
 {
+	class Model3D;
+	class RenderModelEntity;
+	struct EffectInstanceData;
+
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// A globally accessible struct of shared data used for rendering the current scene in a given frame.
 	//
+	// Everything render needs from the simulation is copied in here when the frame is cached. Renderers
+	// read the snapshot rather than live simulation objects, so render may lag the simulation by a few frames.
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	struct RenderData : public GameEntity
 	{
 		RenderData();
+		explicit RenderData(uint32_t numDirLights);
 		void reset();
 
+		/** One model draw; models are immutable shared assets, so holding one never reaches back into the simulation */
+		struct ModelDraw
+		{
+			sp<const Model3D> model;
+			glm::mat4 modelMatrix{ 1.f };
+			std::optional<glm::vec3> tint; //objectTint uniform; left untouched when unset
+		};
+
+		/** An entity as it was when the frame was cached; its draws are a range of modelDraws */
+		struct EntitySnapshot
+		{
+			glm::mat4 modelMatrix{ 1.f };
+			uint8_t lodHint = 0; //distance bucket from the cull, 0 is nearest
+			uint32_t firstDraw = 0;
+			uint32_t numDraws = 0;
+		};
+
+		struct HighlightSnapshot
+		{
+			EntitySnapshot entity;
+			bool bFriendly = false; //false draws the enemy color
+		};
+
+		struct CameraSnapshot
+		{
+			glm::vec3 position{ 0.f };
+			glm::vec3 front{ 0.f, 0.f, 1.f };
+			glm::vec3 right{ 1.f, 0.f, 0.f };
+			glm::vec3 up{ 0.f, 1.f, 0.f };
+			glm::quat rotation{ 1.f, 0.f, 0.f, 0.f };
+			float fovY_deg = 45.f;
+			float nearZ = 1.f;
+		};
+
+		/** Values the HUD shows for a player */
+		struct PlayerHUDSnapshot
+		{
+			bool bHasControlTarget = false;
+			bool bCanDilateTime = false;
+			std::optional<glm::vec2> health; //current and max; unset when the control target has no hit points
+			std::optional<glm::vec2> energy; //current and max
+		};
+
+		/** A line from a player's control target to something attacking it */
+		struct AttackerSnapshot
+		{
+			glm::vec3 targetPosition{ 0.f };
+			glm::vec3 attackerPosition{ 0.f };
+			uint32_t attackerIdx = 0; //order in the target's attacker map, used to fade the color
+		};
+
+		struct PointLightSnapshot
+		{
+			PointLight_Deferred::UserData userData;
+			float maxRadius = 1.f;
+		};
+
+		/** One effect's instance buffers; vectors keep their capacity between frames so steady state copies do not allocate */
+		struct ParticleBatchSnapshot
+		{
+			void copyFrom(const EffectInstanceData& eid);
+
+			size_t numInstances = 0;
+			size_t numMat4PerInstance = 0;
+			size_t numVec4PerInstance = 0;
+			std::vector<glm::mat4> mat4Data;
+			std::vector<glm::vec4> vec4Data;
+		};
+
+		/** Appends the entity's draws at modelMatrix and returns a snapshot that indexes them */
+		EntitySnapshot snapshotEntity(const RenderModelEntity& entity, const glm::mat4& modelMatrix, uint8_t lodHint = 0);
+		void addEntity(const RenderModelEntity& entity, const glm::mat4& modelMatrix, uint8_t lodHint = 0);
+		void addEntity(const RenderModelEntity& entity);
+
+		/** Cleans dirty lights so render never has to touch the live light */
+		void addPointLight(PointLight_Deferred& light);
+
 		std::vector<DirectionLight> dirLights;
 		glm::vec3 renderClearColor{ 0.f };
 		glm::vec3 ambientLightIntensity{ 0.f };
-		glm::mat4 view{ 1.f }; //note: perhaps it will be better to make a classes that shift their data from frames. So one can just ask the camera for its frame data. No copies required.
+		glm::mat4 view{ 1.f };
 		glm::mat4 projection{ 1.f };
 		glm::mat4 projection_view{ 1.f };
+		bool bHasCameraFrustum = false; //when false, projection_view is not a camera and nothing is frustum culled
 		std::vector<glm::vec3> playerCamerasPositions = { glm::vec3{0.f} }; //default to a zero position to simply code from having to check array bounds
+		CameraSnapshot camera; //player 0's camera; only captured when bHasCameraFrustum is set. #todo #splitscreen
 		float dt_sec = 0.f;
+
+		std::vector<ModelDraw> modelDraws; //flat for every snapshot below
+		std::vector<EntitySnapshot> entities; //only entities that passed the frustum cull
+		std::vector<HighlightSnapshot> highlights; //stencil highlighted entities; may include entities outside the cull
+		std::vector<EntitySnapshot> playerEntities; //player control targets, still drawn while the world is hidden for a star jump
+		std::vector<PlayerHUDSnapshot> playerHUDs; //indexed by player
+		std::vector<float> teamObjectivesAlive; //normalized, indexed by team; empty when there is no game mode
+		std::vector<AttackerSnapshot> playerAttackers;
+		std::vector<glm::mat4> healSeekers; //model matrices of communication placement seekers
+		std::vector<PointLightSnapshot> pointLights;
+		LightClusterGrid lightClusters; //indexes pointLights; lights outside the view or over budget are left out
+		std::vector<ParticleBatchSnapshot> particleBatches; //indexed the same as the particle system's effect instance data
+		ModelInstanceStream projectileInstances; //grouped by projectile model id
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Ring of frame snapshots. The simulation writes frame N while render reads frame N - delay.
+	//
+	// There is one more slot than the largest delay needs, so the simulation of the next frame may be
+	// written while render is still reading the oldest frame it uses.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class RenderFrameRing
+	{
+	public:
+		static constexpr uint8_t MAX_DELAY_FRAMES = 2;
+
+		explicit RenderFrameRing(uint32_t numDirLights);
+
+		/** Reset slot for frameNumber; reads treat it as the newest frame from here on */
+		RenderData& beginWrite(uint64_t frameNumber);
+
+		/** The snapshot render should use on frameNumber. Frames that are not cached yet read the newest cached frame. */
+		const RenderData& read(uint64_t frameNumber) const;
+
+		void setDelayFrames(uint8_t inDelayFrames);
+		uint8_t getDelayFrames() const { return delayFrames; }
+
+	private:
+		RenderData& slotFor(uint64_t frameNumber) const { return *slots[frameNumber % slots.size()]; }
+
+	private:
+		std::vector<sp<RenderData>> slots;
+		uint8_t delayFrames = 0;
+		bool bAnyWritten = false;
+		uint64_t firstWrittenFrame = 0;
+		uint64_t newestWrittenFrame = 0;
 	};
 }
@@ -0,0 +1,365 @@
+#include "AvoidanceField.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include <glm/gtx/norm.hpp>
+
+#include "GameFramework/SAWorldEntity.h"
+#include "Tools/Algorithms/SphereAvoidance/AvoidanceSphere.h"
+#include "Tools/SAUtilities.h"
+
+namespace SA
+{
+	using namespace glm;
+
+	float avoidanceStrength(float distance, float radius, float radiusFractForMaxAvoidance)
+	{
+		float radiusFrac = glm::clamp(distance / radius, 0.f, 1.f);
+		float remappedRadiusFrac = glm::clamp(radiusFrac - radiusFractForMaxAvoidance, 0.f, 1.f); //makes a new range [0,1]
+		remappedRadiusFrac /= (1.0f - radiusFractForMaxAvoidance); //bring this back to a [0,1] range
+		return 1.f - remappedRadiusFrac;
+	}
+
+	void dampenAvoidanceVelocity(glm::vec3& velocity_n, const glm::vec3& away_n, float strength)
+	{
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		// Project the velocity onto the vector to the sphere center, this gives us a component of velocity that is going towards
+		// the sphere center. We dampen this part of the velocity only. Effectively we trim out this part of the velocity
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		const vec3 toSphereCenter_n = -away_n;
+		float velocityProjection = glm::dot(toSphereCenter_n, velocity_n);
+		velocityProjection = glm::clamp(velocityProjection, 0.f, 1.f);	//clamp out velocity pointing AWAY from radius
+		const vec3 dampenVector_v = -(toSphereCenter_n * velocityProjection) * strength; //smooth dampening effect based on distance to radius
+		const vec3 dampenedVel_v = velocity_n + dampenVector_v;
+
+		//don't make velocity a zero vector
+		if (!Utils::float_equals(glm::length2(velocity_n), 0.0f) && !Utils::float_equals(glm::length2(dampenedVel_v), 0.0f))
+		{
+			velocity_n = glm::normalize(dampenedVel_v);
+		}
+	}
+
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// AvoidanceField
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	float AvoidanceField::chooseCellSize(const std::vector<AvoidanceFieldSphere>& spheres, float cellsPerMinRadius /*= 8.f*/, size_t maxBricks /*= 4096*/)
+	{
+		if (spheres.empty())
+		{
+			return 1.f;
+		}
+
+		float minRadius = spheres[0].radius;
+		for (const AvoidanceFieldSphere& sphere : spheres)
+		{
+			minRadius = glm::min(minRadius, sphere.radius);
+		}
+
+		float cellSize = minRadius / cellsPerMinRadius;
+		std::unordered_set<uint64_t> coveredBricks;
+		for (;;)
+		{
+			//count the bricks a build would allocate; overlapping spheres share most of theirs
+			coveredBricks.clear();
+			const float invSize = 1.f / cellSize;
+			for (const AvoidanceFieldSphere& sphere : spheres)
+			{
+				const ivec3 minBrick = brickOf(ivec3(glm::floor((sphere.position - sphere.radius) * invSize)));
+				const ivec3 maxBrick = brickOf(ivec3(glm::floor((sphere.position + sphere.radius) * invSize)));
+				for (int32_t z = minBrick.z; z <= maxBrick.z && coveredBricks.size() <= maxBricks; ++z)
+				{
+					for (int32_t y = minBrick.y; y <= maxBrick.y; ++y)
+					{
+						for (int32_t x = minBrick.x; x <= maxBrick.x; ++x)
+						{
+							coveredBricks.insert(packBrickKey(ivec3(x, y, z)));
+						}
+					}
+				}
+			}
+			if (coveredBricks.size() <= maxBricks)
+			{
+				return cellSize;
+			}
+			cellSize *= 2.f;
+		}
+	}
+
+	glm::vec4 AvoidanceField::evaluate(const std::vector<AvoidanceFieldSphere>& spheres, const glm::vec3& point)
+	{
+		vec4 push{ 0.f };
+		for (const AvoidanceFieldSphere& sphere : spheres)
+		{
+			const vec3 toPoint_v = point - sphere.position;
+			const float distance = glm::length(toPoint_v);
+			if (distance >= sphere.radius)
+			{
+				continue;
+			}
+
+			const float strength = avoidanceStrength(distance, sphere.radius, sphere.radiusFractForMaxAvoidance);
+			if (distance > 0.f)
+			{
+				push += vec4((toPoint_v / distance) * strength, 0.f);
+			}
+			push.w += strength;
+		}
+		return push;
+	}
+
+	void AvoidanceField::build(const std::vector<AvoidanceFieldSphere>& spheres, float inCellSize)
+	{
+		clear();
+		cellSize = inCellSize;
+		invCellSize = 1.f / inCellSize;
+		if (spheres.empty())
+		{
+			return;
+		}
+
+		vec3 minBounds = spheres[0].position - spheres[0].radius;
+		vec3 maxBounds = spheres[0].position + spheres[0].radius;
+		for (const AvoidanceFieldSphere& sphere : spheres)
+		{
+			minBounds = glm::min(minBounds, sphere.position - sphere.radius);
+			maxBounds = glm::max(maxBounds, sphere.position + sphere.radius);
+		}
+		boundsCenter = 0.5f * (minBounds + maxBounds);
+		boundsRadius = 0.f;
+		for (const AvoidanceFieldSphere& sphere : spheres)
+		{
+			boundsRadius = glm::max(boundsRadius, glm::distance(boundsCenter, sphere.position) + sphere.radius);
+		}
+
+		//allocate every brick a sphere overlaps and remember which spheres can reach it
+		std::vector<glm::ivec3> brickCoords;
+		std::vector<std::vector<AvoidanceFieldSphere>> brickSpheres;
+		for (const AvoidanceFieldSphere& sphere : spheres)
+		{
+			const ivec3 minBrick = brickOf(ivec3(glm::floor((sphere.position - sphere.radius) * invCellSize)));
+			const ivec3 maxBrick = brickOf(ivec3(glm::floor((sphere.position + sphere.radius) * invCellSize)));
+			for (int32_t z = minBrick.z; z <= maxBrick.z; ++z)
+			{
+				for (int32_t y = minBrick.y; y <= maxBrick.y; ++y)
+				{
+					for (int32_t x = minBrick.x; x <= maxBrick.x; ++x)
+					{
+						const ivec3 brickCoord{ x, y, z };
+						auto insertResult = brickLookup.insert({ packBrickKey(brickCoord), uint32_t(brickCoords.size()) });
+						if (insertResult.second)
+						{
+							brickCoords.push_back(brickCoord);
+							brickSpheres.emplace_back();
+						}
+						brickSpheres[insertResult.first->second].push_back(sphere);
+					}
+				}
+			}
+		}
+
+		bricks.resize(brickCoords.size());
+		for (size_t brickIdx = 0; brickIdx < bricks.size(); ++brickIdx)
+		{
+			const ivec3 firstCorner = brickCoords[brickIdx] * BRICK_CELLS;
+			Brick& brick = bricks[brickIdx];
+			for (int32_t z = 0; z < BRICK_CORNERS; ++z)
+			{
+				for (int32_t y = 0; y < BRICK_CORNERS; ++y)
+				{
+					for (int32_t x = 0; x < BRICK_CORNERS; ++x)
+					{
+						const vec3 cornerPosition = vec3(firstCorner + ivec3(x, y, z)) * cellSize;
+						brick[(z * BRICK_CORNERS + y) * BRICK_CORNERS + x] = evaluate(brickSpheres[brickIdx], cornerPosition);
+					}
+				}
+			}
+		}
+	}
+
+	void AvoidanceField::clear()
+	{
+		bricks.clear();
+		brickLookup.clear();
+		boundsCenter = vec3(0.f);
+		boundsRadius = 0.f;
+	}
+
+	glm::vec4 AvoidanceField::sample(const glm::vec3& position) const
+	{
+		const vec3 gridPosition = position * invCellSize;
+		const vec3 cellFloor = glm::floor(gridPosition);
+		const ivec3 cell{ cellFloor };
+		const vec3 t = gridPosition - cellFloor;
+
+		const ivec3 brickCoord = brickOf(cell);
+		auto findResult = brickLookup.find(packBrickKey(brickCoord));
+		if (findResult == brickLookup.end())
+		{
+			return vec4(0.f);
+		}
+
+		const Brick& brick = bricks[findResult->second];
+		const ivec3 local = cell - brickCoord * BRICK_CELLS;
+		const size_t base = size_t((local.z * BRICK_CORNERS + local.y) * BRICK_CORNERS + local.x);
+		constexpr size_t strideY = BRICK_CORNERS;
+		constexpr size_t strideZ = BRICK_CORNERS * BRICK_CORNERS;
+
+		const vec4 x00 = glm::mix(brick[base], brick[base + 1], t.x);
+		const vec4 x10 = glm::mix(brick[base + strideY], brick[base + strideY + 1], t.x);
+		const vec4 x01 = glm::mix(brick[base + strideZ], brick[base + strideZ + 1], t.x);
+		const vec4 x11 = glm::mix(brick[base + strideZ + strideY], brick[base + strideZ + strideY + 1], t.x);
+		return glm::mix(glm::mix(x00, x10, t.y), glm::mix(x01, x11, t.y), t.z);
+	}
+
+	glm::vec4 AvoidanceField::sampleInFrame(const glm::vec3& worldPosition, const glm::vec3& framePosition, const glm::quat& frameRotation) const
+	{
+		const vec3 localPosition = glm::inverse(frameRotation) * (worldPosition - framePosition);
+		if (glm::distance2(localPosition, boundsCenter) >= boundsRadius * boundsRadius)
+		{
+			return vec4(0.f);
+		}
+
+		const vec4 localPush = sample(localPosition);
+		return vec4(frameRotation * vec3(localPush), localPush.w);
+	}
+
+	uint64_t AvoidanceField::packBrickKey(const glm::ivec3& brickCoord)
+	{
+		constexpr uint64_t mask = (uint64_t(1) << 21) - 1;
+		return ((uint64_t(uint32_t(brickCoord.x)) & mask) << 42) | ((uint64_t(uint32_t(brickCoord.y)) & mask) << 21) | (uint64_t(uint32_t(brickCoord.z)) & mask);
+	}
+
+	glm::ivec3 AvoidanceField::brickOf(const glm::ivec3& cell)
+	{
+		//floor division so negative cells land in the brick below zero rather than sharing brick 0
+		auto floorDiv = [](int32_t value) { return value >= 0 ? value / BRICK_CELLS : (value - BRICK_CELLS + 1) / BRICK_CELLS; };
+		return ivec3(floorDiv(cell.x), floorDiv(cell.y), floorDiv(cell.z));
+	}
+
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	/// AvoidanceFieldSet
+	/// ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	static AvoidanceFieldSphere toFieldSphere(const AvoidanceSphere& sphere, const glm::vec3& position)
+	{
+		return AvoidanceFieldSphere{ position, sphere.getRadius(), sphere.getRadiusFractForMaxAvoidance() };
+	}
+
+	void AvoidanceFieldSet::addStaticOwner(const sp<WorldEntity>& owner, const std::vector<sp<AvoidanceSphere>>& spheres)
+	{
+		if (!owner || spheres.empty())
+		{
+			return;
+		}
+		removeOwner(owner.get());
+
+		StaticOwner staticOwner;
+		staticOwner.owner = owner;
+		staticOwner.rawOwner = owner.get();
+		staticOwner.spheres.assign(spheres.begin(), spheres.end());
+		staticOwner.bakedTransform = owner->getTransform();
+		staticOwners.push_back(std::move(staticOwner));
+		bStaticFieldDirty = true;
+	}
+
+	void AvoidanceFieldSet::addRigidOwner(const sp<WorldEntity>& owner, const std::vector<sp<AvoidanceSphere>>& spheres)
+	{
+		if (!owner || spheres.empty())
+		{
+			return;
+		}
+		removeOwner(owner.get());
+
+		//spheres are parented to the owner's model matrix; without its translation and rotation that leaves only its scale
+		const vec3 ownerScale = owner->getTransform().scale;
+		std::vector<AvoidanceFieldSphere> frameSpheres;
+		for (const sp<AvoidanceSphere>& sphere : spheres)
+		{
+			frameSpheres.push_back(toFieldSphere(*sphere, ownerScale * sphere->getLocalPosition()));
+		}
+
+		RigidOwner rigidOwner;
+		rigidOwner.owner = owner;
+		rigidOwner.rawOwner = owner.get();
+		rigidOwner.field.build(frameSpheres, AvoidanceField::chooseCellSize(frameSpheres));
+		rigidOwners.push_back(std::move(rigidOwner));
+	}
+
+	void AvoidanceFieldSet::removeOwner(const WorldEntity* owner)
+	{
+		auto staticIter = std::find_if(staticOwners.begin(), staticOwners.end(), [owner](const StaticOwner& entry) { return entry.rawOwner == owner; });
+		if (staticIter != staticOwners.end())
+		{
+			staticOwners.erase(staticIter);
+			bStaticFieldDirty = true;
+		}
+
+		auto rigidIter = std::find_if(rigidOwners.begin(), rigidOwners.end(), [owner](const RigidOwner& entry) { return entry.rawOwner == owner; });
+		if (rigidIter != rigidOwners.end())
+		{
+			rigidOwners.erase(rigidIter);
+		}
+	}
+
+	void AvoidanceFieldSet::clear()
+	{
+		staticOwners.clear();
+		rigidOwners.clear();
+		staticField.clear();
+		bStaticFieldDirty = false;
+	}
+
+	void AvoidanceFieldSet::refresh()
+	{
+		//owners destroyed without being unspawned; their addresses may be reused
+		auto isExpired = [](const auto& entry) { return !entry.owner.isValid(); };
+		rigidOwners.erase(std::remove_if(rigidOwners.begin(), rigidOwners.end(), isExpired), rigidOwners.end());
+		const size_t numStaticOwners = staticOwners.size();
+		staticOwners.erase(std::remove_if(staticOwners.begin(), staticOwners.end(), isExpired), staticOwners.end());
+		bStaticFieldDirty |= numStaticOwners != staticOwners.size();
+
+		//static owners can still be moved by hand (eg level editing)
+		for (StaticOwner& staticOwner : staticOwners)
+		{
+			const Transform& xform = staticOwner.owner.fastGet()->getTransform();
+			if (xform.position != staticOwner.bakedTransform.position || xform.rotQuat != staticOwner.bakedTransform.rotQuat || xform.scale != staticOwner.bakedTransform.scale)
+			{
+				staticOwner.bakedTransform = xform;
+				bStaticFieldDirty = true;
+			}
+		}
+
+		if (bStaticFieldDirty)
+		{
+			std::vector<AvoidanceFieldSphere> worldSpheres;
+			for (const StaticOwner& staticOwner : staticOwners)
+			{
+				for (const wp<AvoidanceSphere>& weakSphere : staticOwner.spheres)
+				{
+					if (sp<AvoidanceSphere> sphere = weakSphere.lock())
+					{
+						worldSpheres.push_back(toFieldSphere(*sphere, sphere->getWorldPosition()));
+					}
+				}
+			}
+			staticField.build(worldSpheres, AvoidanceField::chooseCellSize(worldSpheres));
+			bStaticFieldDirty = false;
+		}
+	}
+
+	glm::vec4 AvoidanceFieldSet::sample(const glm::vec3& worldPosition, const WorldEntity* ignoreOwner /*= nullptr*/) const
+	{
+		vec4 push = staticField.sample(worldPosition);
+		for (const RigidOwner& rigidOwner : rigidOwners)
+		{
+			if (rigidOwner.rawOwner != ignoreOwner && rigidOwner.owner.isValid())
+			{
+				const Transform& xform = rigidOwner.owner.fastGet()->getTransform();
+				push += rigidOwner.field.sampleInFrame(worldPosition, xform.position, xform.rotQuat);
+			}
+		}
+		return push;
+	}
+}
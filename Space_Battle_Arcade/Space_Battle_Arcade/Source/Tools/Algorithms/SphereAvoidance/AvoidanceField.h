@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Tools/DataStructures/AdvancedPtrs.h"
+#include "Tools/DataStructures/SATransform.h"
+#include "Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	class AvoidanceSphere;
+	class WorldEntity;
+
+	/** The parts of an avoidance sphere the avoidance math needs, in whatever space a field is built in */
+	struct AvoidanceFieldSphere
+	{
+		glm::vec3 position{ 0.f };
+		float radius = 1.f;
+		float radiusFractForMaxAvoidance = 0.8f;
+	};
+
+	/** How hard a sphere pushes at `distance` from its center; 1 within radiusFractForMaxAvoidance of the radius, fading to 0 at the surface */
+	float avoidanceStrength(float distance, float radius, float radiusFractForMaxAvoidance);
+
+	/** Trims the part of velocity_n heading against away_n (towards the sphere), scaled by strength. velocity_n stays normalized. */
+	void dampenAvoidanceVelocity(glm::vec3& velocity_n, const glm::vec3& away_n, float strength);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Precomputed avoidance pushes on a sparse voxel grid.
+	//
+	// Every grid corner stores the summed push of the spheres around it: xyz is the sum of each sphere's away-from-center
+	// direction scaled by its strength, w is the summed strength. Only bricks of BRICK_CELLS^3 cells that a sphere overlaps
+	// are allocated; a sample is one hash lookup and a trilinear blend of 8 corners inside that brick (corners on brick
+	// faces are duplicated so a sample never crosses bricks). Outside every brick the push is zero.
+	//
+	// Summing is exact for a single sphere. Where spheres overlap, the per sphere dampening ships used to do one after
+	// another becomes one dampening along the summed push, with strength clamped to 1. That is close when overlapping
+	// spheres push the same way, which is the common case for carriers and asteroid clusters.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AvoidanceField
+	{
+	public:
+		static constexpr int32_t BRICK_CELLS = 4;
+		static constexpr int32_t BRICK_CORNERS = BRICK_CELLS + 1;
+
+		/** Cells are a fraction of the smallest radius, made coarser until the grid fits in maxBricks */
+		static float chooseCellSize(const std::vector<AvoidanceFieldSphere>& spheres, float cellsPerMinRadius = 8.f, size_t maxBricks = 4096);
+
+		/** The exact summed push at a point, ie what a grid corner stores */
+		static glm::vec4 evaluate(const std::vector<AvoidanceFieldSphere>& spheres, const glm::vec3& point);
+
+	public:
+		void build(const std::vector<AvoidanceFieldSphere>& spheres, float cellSize);
+		void clear();
+
+		/** Trilinear blend of the stored pushes; position is in the space the field was built in */
+		glm::vec4 sample(const glm::vec3& position) const;
+
+		/** For a field built in a rigid body's frame: brings the world point into the frame and the push back out */
+		glm::vec4 sampleInFrame(const glm::vec3& worldPosition, const glm::vec3& framePosition, const glm::quat& frameRotation) const;
+
+		bool isEmpty() const { return bricks.empty(); }
+		size_t getNumBricks() const { return bricks.size(); }
+		size_t getMemoryBytes() const { return bricks.size() * sizeof(Brick) + brickLookup.size() * (sizeof(uint64_t) + sizeof(uint32_t)); }
+		float getCellSize() const { return cellSize; }
+
+		/** A sphere around everything the field stores, for skipping whole fields */
+		const glm::vec3& getBoundsCenter() const { return boundsCenter; }
+		float getBoundsRadius() const { return boundsRadius; }
+
+	private:
+		using Brick = std::array<glm::vec4, BRICK_CORNERS * BRICK_CORNERS * BRICK_CORNERS>;
+		static uint64_t packBrickKey(const glm::ivec3& brickCoord);
+		static glm::ivec3 brickOf(const glm::ivec3& cell);
+
+	private:
+		std::vector<Brick> bricks;
+		std::unordered_map<uint64_t, uint32_t> brickLookup;
+		float cellSize = 1.f;
+		float invCellSize = 1.f;
+		glm::vec3 boundsCenter{ 0.f };
+		float boundsRadius = 0.f;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// The avoidance fields of a level.
+	//
+	// Static owners (eg asteroid avoid meshes) share one world space field, rebuilt only when a static owner is added,
+	// removed or moved. Rigid owners (eg carriers) each get a field baked once in their own frame (translation and
+	// rotation; their scale never changes), which moves with them for free.
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	class AvoidanceFieldSet final : public RemoveCopies, public RemoveMoves
+	{
+	public:
+		void addStaticOwner(const sp<WorldEntity>& owner, const std::vector<sp<AvoidanceSphere>>& spheres);
+		void addRigidOwner(const sp<WorldEntity>& owner, const std::vector<sp<AvoidanceSphere>>& spheres);
+		void removeOwner(const WorldEntity* owner);
+		void clear();
+
+		/** Rebuilds the static field if static owners changed; call once per tick after entities have moved */
+		void refresh();
+
+		/** Summed push of every field at a point, skipping the fields of ignoreOwner (eg a carrier's own spheres) */
+		glm::vec4 sample(const glm::vec3& worldPosition, const WorldEntity* ignoreOwner = nullptr) const;
+
+		bool hasFields() const { return !staticOwners.empty() || !rigidOwners.empty(); }
+		const AvoidanceField& getStaticField() const { return staticField; }
+		size_t getNumRigidFields() const { return rigidOwners.size(); }
+
+	private:
+		struct StaticOwner
+		{
+			fwp<WorldEntity> owner;
+			const WorldEntity* rawOwner = nullptr;
+			std::vector<wp<AvoidanceSphere>> spheres;
+			Transform bakedTransform;
+		};
+		struct RigidOwner
+		{
+			fwp<WorldEntity> owner;
+			const WorldEntity* rawOwner = nullptr;
+			AvoidanceField field;
+		};
+
+	private:
+		//vectors rather than maps so pushes are summed in the same order every run
+		std::vector<StaticOwner> staticOwners;
+		std::vector<RigidOwner> rigidOwners;
+		AvoidanceField staticField;
+		bool bStaticFieldDirty = false;
+	};
+}
@@ -29,6 +29,7 @@ namespace SA
 		void setParentXform(const glm::mat4& newParentXform);
 		const fwp<GameEntity>& getOwner() { return owningEntity; }
 		glm::vec3 getWorldPosition() const;//#TODO_minor perhaps just use glm::vec4?
+		glm::vec3 getLocalPosition() const { return localXform.position; }
 		float getRadius() const { return radiusScaleCorrected; } //#TODO perhaps radius should be defined by transforms too (eg transforming a radius vector)
 		float getRadiusFractForMaxAvoidance() const { return radiusFractForMaxAvoidance; }
 		void setParentScalesRadius(bool bEnable);
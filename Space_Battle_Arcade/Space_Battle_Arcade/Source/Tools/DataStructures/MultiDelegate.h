@@ -11,48 +11,74 @@
 #include <assert.h>
 #include <vector>
 #include <functional>
+#include <cstdint>
+#include <cstring>
 
 namespace SA
 {
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// Dev Notes:
-	// I considered making subscribers a super class to both weak and strong subscribers, but that will require dynamic casting within
-	// the delegate itself to determine it is should remove stale weak pointers. It also begs to have a shared virtual function
-	// "invoke" that checks if the pointer is valid in the weak pointer case and immediately calls the function in the shared pointer case.
-	// I believe the overhead of virtual functions can be avoided here by just maintaining different lists of subscribers. Thus, the
-	// need for true polymorphic subscriber parent class is very small. 
-	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-	// Dev Concerns / Todos
-	//
-	//---Variadic argument concern---
-	//	declarations like:
-	//			struct StrongAgnosticSubscriber : public Subscriber<Args...>
-	//	 May should be 
-	//			struct StrongAgnosticSubscriber : public Subscriber<Args&&...>
-	//
-	//	Both of the above compile.
+	// Subscribers are stored by value in flat vectors; a binding is the raw object pointer, the member function pointer bytes, and a
+	// plain function pointer instantiated for the concrete type that knows how to cast and call. Broadcasting is then an index walk
+	// with one indirect call per subscriber: no virtual dispatch, no shared_ptr copies, and nothing is allocated.
 	//
-	//   I believe the <Args...> variant should be okay.
-	//	 Since Args is a collection of types, eg {int, double&, char&&}, I do not think the lvalue/rvalueness of those types is lost in the declaration of the super-class types.
-	//	 Where as in functions parameters, the rvalues are given a name and become lvalues (hence requiring forwarding). eg "void foo(int&& rvalues_lvaluename)"
-	//	 It doesn't seem this is the cast for passing template parameter packs? It doesn't seem like we're giving them a name and converting them to lvalues.
-
-	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// Strong and weak subscribers are still kept in separate lists. Strong entries own a shared_ptr to keep the object alive; weak
+	// entries keep a weak_ptr that is locked for the duration of each callback, so a subscriber whose last owner releases it during a
+	// broadcast is not destroyed mid-callback.
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	/**
-	* Top level class that provides virtual invoke.
-	* This is agnostic of the bound type;
-	* the delegate container need not specify concrete types
-	*/
+	/** A type erased member function binding; trivially copyable so it can live in contiguous storage */
 	template<typename... Args>
-	struct Subscriber
+	struct DelegateBinding
 	{
+		//pointers to members of classes with multiple or virtual bases are larger than a code pointer on some compilers
+		static constexpr size_t MEMBER_FUNC_BYTES = 3 * sizeof(void*);
+		using Invoker = void(*)(SA::GameEntity* obj, const unsigned char* memberFunc, Args&&... args);
+
+		SA::GameEntity* obj = nullptr;
+		Invoker invoker = nullptr;
+		alignas(void*) unsigned char memberFunc[MEMBER_FUNC_BYTES];
 		bool bMarkedForDelete = false;
 
-		//void changing the return type from void, that way this can be used as the return type for return val delegates
-		virtual void invoke(Args&&... args) = 0;
+		template<typename T>
+		static DelegateBinding make(T* inObj, void(T::*fptr)(Args...))
+		{
+			using MemberFunc = void(T::*)(Args...);
+			static_assert(sizeof(MemberFunc) <= MEMBER_FUNC_BYTES, "Member function pointer does not fit in the delegate binding.");
+
+			DelegateBinding binding;
+			binding.obj = inObj;
+			binding.invoker = &invokeMember<T>;
+			std::memset(binding.memberFunc, 0, MEMBER_FUNC_BYTES);
+			std::memcpy(binding.memberFunc, &fptr, sizeof(MemberFunc));
+			return binding;
+		}
+
+		/** Same object and same function; the invoker identifies the bound type */
+		template<typename T>
+		bool matches(const SA::GameEntity* inObj, void(T::*fptr)(Args...)) const
+		{
+			using MemberFunc = void(T::*)(Args...);
+			if (obj != inObj || invoker != &invokeMember<T>)
+			{
+				return false;
+			}
+			MemberFunc boundFunc;
+			std::memcpy(&boundFunc, memberFunc, sizeof(MemberFunc));
+			return boundFunc == fptr;
+		}
+
+		template<typename T>
+		static void invokeMember(SA::GameEntity* inObj, const unsigned char* inMemberFunc, Args&&... args)
+		{
+			//MODIFICATION NOTE: preserve that repeatedly "step into" when debugging quickly gets to callbacks and not other functions
+			using MemberFunc = void(T::*)(Args...);
+			MemberFunc boundFunc;
+			std::memcpy(&boundFunc, inMemberFunc, sizeof(MemberFunc));
+
+			//static cast is safe because game entity is a required base class
+			(static_cast<T*>(inObj)->*boundFunc)(std::forward<Args>(args)...);
+		}
 	};
 
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -62,44 +88,12 @@ namespace SA
 	// This can cause resource leaks if delegates are not cleaned up before an object is released.
 	// Becareful, Strong subscribers cannot be cleaned up in the dtor class types because the strong object itself
 	// will prevent the dtor from ever being called.
-	//
-	// Strong subscribers may provide a performance benefit compared to weak subscribers. Weak subscribers require locking
-	// of a weak pointer, which will require atomic thread operations, which are generally slow.
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-	/** Holds a shared_ptr to an object, delegate will keep object alive if it is not removed*/
 	template<typename... Args>
-	struct StrongAgnosticSubscriber : public Subscriber<Args...>
+	struct StrongSubscriber
 	{
-		//Type is always GameEntity; this allows containers to hold multiple types
-		//and use polymorphism mechanisms to invoke on different types
+		DelegateBinding<Args...> binding;
 		sp<SA::GameEntity> strongObj;
-
-		StrongAgnosticSubscriber(const sp<SA::GameEntity>& obj) : strongObj(obj) {}
-	};
-
-	/** Strong subscriber that knows it concrete type and therefore can invoke the delegate callback */
-	template<typename T, typename... Args>
-	struct StrongSubscriber : public StrongAgnosticSubscriber<Args...>
-	{
-		static_assert(std::is_base_of<SA::GameEntity, T>::value, "Smart Subscribers must be GameEntity Objects.");
-
-		StrongSubscriber(const sp<T>& obj, void(T::*fptr)(Args...))
-			: StrongAgnosticSubscriber<Args...>(obj), boundFunc(fptr)
-		{
-		}
-
-		using MemberFunc = void(T::*)(Args...);
-		MemberFunc boundFunc;
-
-		virtual void invoke(Args&&... args) override
-		{
-			//MODIFICATION NOTE: preserve that repeatedly "step into" when debugging quickly gets to callbacks and not other functions
-
-			//static cast is safe because game entity is a required base class
-			//collapsing above code into one line for faster debugging
-			((*std::static_pointer_cast<T>(this->strongObj)).*boundFunc)(std::forward<Args>(args)...);
-		}
 	};
 
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -108,54 +102,12 @@ namespace SA
 	// Weak subscribers hold weak pointers to their subscribers
 	// This are less bug prone because they will be automatically cleaned up if the subscriber object has went out of scope
 	// and been destroyed. 
-	//
-	// However, there is some overhead associated with using weak pointers. Weak pointers require an thread atomic operation
-	// to access the control block. This is probably the equivalent of locking a mutex when ever a shared pointer is obtained
-	// from the weak pointer.
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-
-	/** Holds a weak pointer to the object, delegate will not exert control over pointer liftime */
 	template<typename... Args>
-	struct WeakAgnosticSubscriber : public Subscriber<Args...>
+	struct WeakSubscriber
 	{
-		//Type is always GameEntity; this allows containers to hold multiple types
-		//and use polymorphism mechanisms to invoke on different types
+		DelegateBinding<Args...> binding;
 		wp<SA::GameEntity> weakObj;
-
-		/** Intentionally not using delegate system to avoid recusrive complexities*/
-		std::function<void()> notifyStaleSubscriber;
-
-		WeakAgnosticSubscriber(const sp<SA::GameEntity>& obj) : weakObj(obj) {}
-	};
-
-	/** Weak subscriber that knows it concrete type and therefore can invoke the delegate callback */
-	template<typename T, typename... Args>
-	struct WeakSubscriber : public WeakAgnosticSubscriber<Args...>
-	{
-		static_assert(std::is_base_of<SA::GameEntity, T>::value, "Smart Subscribers must be GameEntity Objects.");
-
-		WeakSubscriber(const sp<T> obj, void(T::*fptr)(Args...)) : WeakAgnosticSubscriber<Args...>(obj), boundFunc(fptr) {}
-
-		using MemberFunc = void(T::*)(Args...);
-		MemberFunc boundFunc;
-
-		virtual void invoke(Args&&... args) override
-		{
-			//MODIFICATION NOTE: preserve that repeatedly "step into" when debugging quickly gets to callbacks and not other functions
-
-			//lock and cast object to appropriate type for member function invoking.
-			if (sp<T> obj = std::static_pointer_cast<T>(this->weakObj.lock()))
-			{
-				((*obj).*boundFunc)(std::forward<Args>(args)...);
-			}
-			else
-			{
-				//avoiding using return type of invoke to indicate failure because this will likely
-				//be the exact same pattern for return type delegates
-				this->notifyStaleSubscriber();
-			}
-		}
 	};
 
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -179,20 +131,31 @@ namespace SA
 			//NOTE WHEN CHANGING: preserve that repeatedly "step into" when debugging quickly gets to callbacks and not other functions
 			//Debugging delegates in other systems is extremely annoying, doing the above makes it a lot less annoying :)
 
-			broadcasting = true;
-			for (const auto& key_value_pair : strongSubscribers)	//std::map has O(n) walk
+			//subscriber vectors are not resized while broadcasting (adds are queued, removes only mark), so indices stay valid
+			++broadcastDepth;
+			for (size_t subIdx = 0; subIdx < strongSubscribers.size(); ++subIdx)
 			{
-				sp<StrongAgnosticSubscriber<Args...>> subscriber = key_value_pair.second;
-				subscriber->invoke(std::forward<Args>(args)...);
+				const DelegateBinding<Args...>& binding = strongSubscribers[subIdx].binding;
+				binding.invoker(binding.obj, binding.memberFunc, std::forward<Args>(args)...);
 			}
-			for (const auto& key_value_pair : weakSubscribers)		//std::map has O(n) walk
+			for (size_t subIdx = 0; subIdx < weakSubscribers.size(); ++subIdx)
 			{
-				sp<WeakAgnosticSubscriber<Args...>> subscriber = key_value_pair.second;
-				subscriber->invoke(std::forward<Args>(args)...);
+				const WeakSubscriber<Args...>& subscriber = weakSubscribers[subIdx];
+				if (sp<SA::GameEntity> pinnedObj = subscriber.weakObj.lock())
+				{
+					subscriber.binding.invoker(subscriber.binding.obj, subscriber.binding.memberFunc, std::forward<Args>(args)...);
+				}
+				else
+				{
+					bDetectedStaleWeakSubscriber = true;
+				}
 			}
-			broadcasting = false;
+			--broadcastDepth;
 
-			completeQueuedOperations();
+			if (broadcastDepth == 0)
+			{
+				completeQueuedOperations();
+			}
 		}
 
 		/**
@@ -205,21 +168,16 @@ namespace SA
 		{
 			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
 
-			//store the concrete type (T) into a type (WeakSubscriber) that hides (WeakAgnosticSubscriber) the concrete template type for storage
-			sp<WeakAgnosticSubscriber<Args...>> subscriber = new_sp<WeakSubscriber<T, Args...>>(obj, fptr);
-
-			//a new lambda will need to be set if delegate copying behavior is ever supported; or an array of lambdas if shared subscribers
-			subscriber->notifyStaleSubscriber = [this]() { this->bDetecftedStaleWeakSubscriber = true; };
+			WeakSubscriber<Args...> subscriber{ DelegateBinding<Args...>::make(obj.get(), fptr), std::static_pointer_cast<SA::GameEntity>(obj) };
 
 			//add must consider if broadcasting is happening
-			if (!broadcasting)
+			if (!isBroadcasting())
 			{
-				SA::GameEntity* objAddress = obj.get();
-				weakSubscribers.emplace(objAddress, subscriber);
+				weakSubscribers.push_back(std::move(subscriber));
 			}
 			else
 			{
-				pendingWeakAdds.push_back(subscriber);
+				pendingWeakAdds.push_back(std::move(subscriber));
 			}
 		}
 
@@ -234,18 +192,16 @@ namespace SA
 		{
 			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
 
-			//store the concrete type (T) into a type (StrongSubscriber) that hides (StrongAgnosticSubscriber) the concrete template type for storage
-			sp<StrongAgnosticSubscriber<Args...>> subscriber = new_sp<StrongSubscriber<T, Args...>>(obj, fptr);
+			StrongSubscriber<Args...> subscriber{ DelegateBinding<Args...>::make(obj.get(), fptr), std::static_pointer_cast<SA::GameEntity>(obj) };
 
 			//add must consider if broadcasting is happening
-			if (!broadcasting)
+			if (!isBroadcasting())
 			{
-				SA::GameEntity* objAddress = obj.get();
-				strongSubscribers.emplace(objAddress, subscriber);
+				strongSubscribers.push_back(std::move(subscriber));
 			}
 			else
 			{
-				pendingStrongAdds.push_back(subscriber);
+				pendingStrongAdds.push_back(std::move(subscriber));
 			}
 		}
 
@@ -256,10 +212,11 @@ namespace SA
 			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
 
 			//remove must consider if broadcasting is happening
-			if (!broadcasting)
+			if (!isBroadcasting())
 			{
-				strongSubscribers.erase(obj.get());
-				weakSubscribers.erase(obj.get());
+				const SA::GameEntity* objAddress = obj.get();
+				eraseIf(strongSubscribers, [objAddress](const StrongSubscriber<Args...>& sub) { return sub.binding.obj == objAddress; });
+				eraseIf(weakSubscribers, [objAddress](const WeakSubscriber<Args...>& sub) { return sub.binding.obj == objAddress; });
 			}
 			else
 			{
@@ -275,45 +232,7 @@ namespace SA
 		void removeStrong(const sp<T>& obj, void(T::*fptr)(Args...))
 		{
 			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
-
-			const std::pair<StrongIter, StrongIter>& start_end = strongSubscribers.equal_range(obj.get());
-			StrongIter start = start_end.first;
-			StrongIter end = start_end.second;
-
-			for (StrongIter iter = start; iter != end; ++iter)
-			{
-				const sp<StrongAgnosticSubscriber<Args...>>& sub = iter->second;
-				SA::GameEntity* key = iter->first;
-
-				assert(key == obj.get());
-
-				/**A dynamic_point_cast might be necessary, but trying to avoid. The member function belong to type T
-				theoretically we can just static cast if object matches and compare the function addresses.
-				Inheritance might complicate this, that is if someone binds a super class function with a child class obj;
-				Ts will not match in that case so function doesn't compile. But There may be cases where same obj might be
-				registered twice (once as super, once as child) and thus it seems static_casting is inappropriate. To avoid
-				this entirely, I could return handles and remove via handles but I'd like to avoid that.
-				*/
-				if (sp<StrongSubscriber<T, Args...>> castSub = std::dynamic_pointer_cast<StrongSubscriber<T, Args...>>(sub))
-				{
-					if (castSub->boundFunc == fptr && !castSub->bMarkedForDelete)
-					{
-						if (!broadcasting)
-						{
-							strongSubscribers.erase(iter);
-						}
-						else
-						{
-							//according to cppreference.com multimap iterators are not invalidated from insertions/erases of iterators
-							//so we can cache the iterators to remove until broadcasting is done
-							castSub->bMarkedForDelete = true;
-							pendingStrongRemoves.push_back(iter);
-						}
-
-						return; //early out, we've found the removal; duplicate adds should be handled with duplicate removes
-					}
-				}
-			}
+			removeFirstMatch(strongSubscribers, obj.get(), fptr);
 		}
 
 		template<typename T>
@@ -321,116 +240,113 @@ namespace SA
 		{
 			static_assert(std::is_base_of<SA::GameEntity, T>::value, "Delegates are only supported for game entity inheriting classes.");
 
-			const std::pair<WeakIter, WeakIter>& start_end = weakSubscribers.equal_range(obj.get());
-			WeakIter start = start_end.first;
-			WeakIter end = start_end.second;
-
-			for (WeakIter iter = start; iter != end; ++iter)
-			{
-				const sp<WeakAgnosticSubscriber<Args...>>& sub = iter->second;
-
-				SA::GameEntity* key = iter->first;
-
-				assert(key == obj.get());
-
-				/** see addStrong for notes on dynamic cast vs static cast potential */
-				if (sp<WeakSubscriber<T, Args...>> castSub = std::dynamic_pointer_cast<WeakSubscriber<T, Args...>>(sub))
-				{
-					//do not check for expired weak ptrs if this is used as mechanism to remove stale bindings
-					if (castSub->boundFunc == fptr && !castSub->bMarkedForDelete)
-					{
-						if (!broadcasting)
-						{
-							weakSubscribers.erase(iter);
-						}
-						else
-						{
-							castSub->bMarkedForDelete = true;
-							pendingWeakRemoves.push_back(iter);
-						}
-
-						return; //early out, we've found the removal; duplicate adds should be handled with duplicate removes
-					}
-				}
-			}
+			//do not check for expired weak ptrs if this is used as mechanism to remove stale bindings
+			removeFirstMatch(weakSubscribers, obj.get(), fptr);
 		}
 
 		void completeQueuedOperations()
 		{
 			//must not be broadcasting when this is called, otherwise we can get in an infinite loop on adds
-			assert(!broadcasting);
+			assert(!isBroadcasting());
 
 			for (const sp<SA::GameEntity>& entity : QueuedRemoveAlls)
 			{
 				//remove all this
 				removeAll(entity);
 			}
+			QueuedRemoveAlls.clear();
 
-			for (StrongIter iter : pendingStrongRemoves)
+			if (bPendingMarkedRemoves)
 			{
-				strongSubscribers.erase(iter);
+				eraseIf(strongSubscribers, [](const StrongSubscriber<Args...>& sub) { return sub.binding.bMarkedForDelete; });
+				eraseIf(weakSubscribers, [](const WeakSubscriber<Args...>& sub) { return sub.binding.bMarkedForDelete; });
+				bPendingMarkedRemoves = false;
 			}
-			pendingStrongRemoves.clear();
 
-			//must come before pending weak removes
-			if (bDetecftedStaleWeakSubscriber)
+			if (bDetectedStaleWeakSubscriber)
 			{
-				//O(n) walk over std::map
-				std::vector<WeakIter> toRemove;
-				for (WeakIter iter = weakSubscribers.begin(); iter != weakSubscribers.end(); ++iter)
-				{
-					sp<WeakAgnosticSubscriber<Args...>> subscriber = iter->second;
-					if (subscriber->weakObj.expired())
-					{
-						pendingWeakRemoves.push_back(iter);
-					}
-				}
-			}
-
-			for (WeakIter iter : pendingWeakRemoves)
-			{
-				weakSubscribers.erase(iter);
+				eraseIf(weakSubscribers, [](const WeakSubscriber<Args...>& sub) { return sub.weakObj.expired(); });
+				bDetectedStaleWeakSubscriber = false;
 			}
-			pendingWeakRemoves.clear();
 
-
-			for (sp<StrongAgnosticSubscriber<Args...>>& newStrongSub : pendingStrongAdds)
+			for (StrongSubscriber<Args...>& newStrongSub : pendingStrongAdds)
 			{
-				SA::GameEntity* objAddress = newStrongSub->strongObj.get();
-				strongSubscribers.emplace(objAddress, newStrongSub);
+				strongSubscribers.push_back(std::move(newStrongSub));
 			}
 			pendingStrongAdds.clear();
 
-			for (sp<WeakAgnosticSubscriber<Args...>> newWeakSub : pendingWeakAdds)
+			for (WeakSubscriber<Args...>& newWeakSub : pendingWeakAdds)
 			{
-				if (sp<SA::GameEntity> obj = newWeakSub->weakObj.lock())
+				if (!newWeakSub.weakObj.expired())
 				{
-					weakSubscribers.emplace(obj.get(), newWeakSub);
+					weakSubscribers.push_back(std::move(newWeakSub));
 				}
 			}
 			pendingWeakAdds.clear();
 		}
 
-		bool hasBoundStrong(const GameEntity& const_obj)
+		bool hasBoundStrong(const GameEntity& obj) const
 		{
-			//add/removes use non-const pointers because callbacks will potentially change state, this may can be removed
-			//with clever designing. Unfortunately there are compile errors with trying to find the const version directly
-			//within strongSubscribers, so const casting const since the query will not change the value of the pointer
-			GameEntity* obj = const_cast<GameEntity*>(&const_obj);
-			return strongSubscribers.find(obj) != strongSubscribers.end();
+			for (const StrongSubscriber<Args...>& sub : strongSubscribers)
+			{
+				if (sub.binding.obj == &obj) { return true; }
+			}
+			return false;
 		}
-		bool hasBoundWeak(const GameEntity& const_obj)
+		bool hasBoundWeak(const GameEntity& obj) const
 		{
-			//add/removes use non-const pointers because callbacks will potentially change state, this may can be removed
-			//with clever designing. Unfortunately there are compile errors with trying to find the const version directly
-			//within strongSubscribers, so const casting const since the query will not change the value of the pointer
-			GameEntity* obj = const_cast<GameEntity*>(&const_obj);
-			return weakSubscribers.find(obj) != weakSubscribers.end();
+			for (const WeakSubscriber<Args...>& sub : weakSubscribers)
+			{
+				if (sub.binding.obj == &obj) { return true; }
+			}
+			return false;
 		}
 
-		std::size_t numBound() { return numStrong() + numWeak(); }
-		std::size_t numStrong() { return strongSubscribers.size(); }
-		std::size_t numWeak() { return weakSubscribers.size(); }
+		std::size_t numBound() const { return numStrong() + numWeak(); }
+		std::size_t numStrong() const { return strongSubscribers.size(); }
+		std::size_t numWeak() const { return weakSubscribers.size(); }
+
+	private:
+		bool isBroadcasting() const { return broadcastDepth != 0; }
+
+		template<typename SubscriberType, typename Pred>
+		static void eraseIf(std::vector<SubscriberType>& subscribers, const Pred& pred)
+		{
+			//stable so broadcast order stays the order subscribers were added
+			size_t keep = 0;
+			for (size_t subIdx = 0; subIdx < subscribers.size(); ++subIdx)
+			{
+				if (!pred(subscribers[subIdx]))
+				{
+					if (keep != subIdx) { subscribers[keep] = std::move(subscribers[subIdx]); }
+					++keep;
+				}
+			}
+			subscribers.resize(keep);
+		}
+
+		template<typename SubscriberType, typename T>
+		void removeFirstMatch(std::vector<SubscriberType>& subscribers, const SA::GameEntity* obj, void(T::*fptr)(Args...))
+		{
+			for (size_t subIdx = 0; subIdx < subscribers.size(); ++subIdx)
+			{
+				DelegateBinding<Args...>& binding = subscribers[subIdx].binding;
+				if (!binding.bMarkedForDelete && binding.matches(obj, fptr))
+				{
+					if (!isBroadcasting())
+					{
+						subscribers.erase(subscribers.begin() + subIdx);
+					}
+					else
+					{
+						//the vector cannot shrink under an active broadcast; the binding still finishes this broadcast
+						binding.bMarkedForDelete = true;
+						bPendingMarkedRemoves = true;
+					}
+					return; //early out, we've found the removal; duplicate adds should be handled with duplicate removes
+				}
+			}
+		}
 
 	public:
 		MultiDelegate() = default;
@@ -452,7 +368,7 @@ namespace SA
 			this->weakSubscribers = copy.weakSubscribers;
 			throw std::runtime_error("copying stale weak delegate binding not yet implemented");
 #ifndef SUPPRESS_BROADCAST_COPY_WARNINGS
-			if (copy.broadcasting)
+			if (copy.isBroadcasting())
 			{
 				std::cerr << "Copied Delegate while broadcasting, this may cause hard to detect bugs! See special member functions of multidelegate to supress this warning" << std::endl;
 			}
@@ -465,7 +381,7 @@ namespace SA
 			this->weakSubscribers = copy.weakSubscribers;
 			throw std::runtime_error("copying stale weak delegate binding not yet implemented");
 #ifndef SUPPRESS_BROADCAST_COPY_WARNINGS
-			if (copy.broadcasting)
+			if (copy.isBroadcasting())
 			{
 				std::cerr << "Copied Delegate while broadcasting, this may cause hard to detect bugs! See special member functions of multidelegate to supress this warning" << std::endl;
 			}
@@ -485,25 +401,20 @@ namespace SA
 
 	private: //these are explicitly ordered for appearance in debugger!
 
-		/* type independent storage for subscribers; uses virtual function to invoke member functions */
-		std::multimap< SA::GameEntity*, sp<StrongAgnosticSubscriber<Args...>> > strongSubscribers;
-		std::multimap< SA::GameEntity*, sp<WeakAgnosticSubscriber<Args...>> > weakSubscribers;
-
-		/* flag for reentrant code that prevents add/remove operations from occurring during broadcasting */
-		bool broadcasting = false;
+		/* subscribers in the order they were added; strong subscribers broadcast before weak subscribers */
+		std::vector<StrongSubscriber<Args...>> strongSubscribers;
+		std::vector<WeakSubscriber<Args...>> weakSubscribers;
 
-		/* Storage of removals queued up during a broadcast*/
-		using StrongIter = typename decltype(strongSubscribers)::iterator;
-		using WeakIter = typename decltype(weakSubscribers)::iterator;
-		std::vector<StrongIter> pendingStrongRemoves;
-		std::vector<WeakIter> pendingWeakRemoves;
+		/* reentrant broadcasts nest; add/remove operations are deferred until the outermost broadcast completes */
+		uint32_t broadcastDepth = 0;
 
 		/* Storage for adds queued up during a broadcast  */
-		std::vector< sp<StrongAgnosticSubscriber<Args...>> > pendingStrongAdds;
-		std::vector< sp<WeakAgnosticSubscriber<Args...>> > pendingWeakAdds;
+		std::vector<StrongSubscriber<Args...>> pendingStrongAdds;
+		std::vector<WeakSubscriber<Args...>> pendingWeakAdds;
 
 		std::vector<sp<SA::GameEntity>> QueuedRemoveAlls;
 
-		bool bDetecftedStaleWeakSubscriber = false;
+		bool bPendingMarkedRemoves = false;
+		bool bDetectedStaleWeakSubscriber = false;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,473 @@
+#include "Tools/ModelLoading/SACookedAsset.h"
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif //_WIN32
+
+#include "GameFramework/SALog.h"
+
+namespace SA
+{
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// on disk layout; every section starts on a SECTION_ALIGNMENT boundary so views can be read in place
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	namespace
+	{
+		constexpr char COOKED_MAGIC[4] = { 'S', 'A', 'C', 'K' };
+		constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+		struct CookedHeader
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t vertexStride;
+			uint32_t normalDataStride;
+			int64_t sourceWriteTime;
+			uint64_t sourceSize;
+			uint64_t fileSize;
+
+			float aabbMin[3];
+			float aabbMax[3];
+
+			uint32_t numMeshes;
+			uint32_t numTextures;
+			uint64_t meshTableOffset;
+			uint64_t textureTableOffset;
+			uint64_t stringTableOffset;
+			uint64_t stringTableSize;
+
+			uint32_t bHasHull;
+			uint32_t hullNumPoints;
+			uint32_t hullNumEdges;
+			uint32_t hullNumFaces;
+			uint64_t hullPointsOffset;
+			uint64_t hullEdgesOffset;
+			uint64_t hullFacesOffset;
+		};
+
+		struct CookedMeshEntry
+		{
+			uint64_t verticesOffset;
+			uint64_t normalDataOffset;
+			uint64_t indicesOffset;
+			uint32_t numVertices;
+			uint32_t numIndices;
+			uint32_t firstTexture;
+			uint32_t numTextures;
+		};
+
+		struct CookedTextureEntry
+		{
+			uint32_t typeOffset;
+			uint32_t typeLength;
+			uint32_t pathOffset;
+			uint32_t pathLength;
+		};
+
+		struct SourceStamp
+		{
+			int64_t writeTime = 0;
+			uint64_t size = 0;
+		};
+
+		bool readSourceStamp(const std::string& sourcePath, SourceStamp& outStamp)
+		{
+			std::error_code ec;
+			std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(sourcePath, ec);
+			if (ec) { return false; }
+			uintmax_t size = std::filesystem::file_size(sourcePath, ec);
+			if (ec) { return false; }
+
+			outStamp.writeTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+			outStamp.size = static_cast<uint64_t>(size);
+			return true;
+		}
+
+		/** a temp path no other writer can share; process id covers concurrent cooks, thread id and counter cover threads within one */
+		std::string makeUniqueTempPath(const std::string& path)
+		{
+			static std::atomic<uint64_t> tempCounter{ 0 };
+#ifdef _WIN32
+			const uint64_t processId = uint64_t(GetCurrentProcessId());
+#else
+			const uint64_t processId = uint64_t(getpid());
+#endif //_WIN32
+			const uint64_t threadHash = uint64_t(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+			return path + "." + std::to_string(processId) + "." + std::to_string(threadHash) + "." + std::to_string(tempCounter.fetch_add(1)) + ".tmp";
+		}
+
+		/** appends bytes to the blob at the next aligned offset and returns that offset */
+		uint64_t appendSection(std::vector<uint8_t>& blob, const void* bytes, size_t numBytes)
+		{
+			uint64_t offset = (blob.size() + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+			blob.resize(size_t(offset) + numBytes);
+			if (numBytes > 0)
+			{
+				std::memcpy(blob.data() + offset, bytes, numBytes);
+			}
+			return offset;
+		}
+
+		template<typename T>
+		uint64_t appendSection(std::vector<uint8_t>& blob, const std::vector<T>& items)
+		{
+			return appendSection(blob, items.data(), items.size() * sizeof(T));
+		}
+	}
+
+	std::string getCookedPath(const std::string& sourcePath)
+	{
+		return sourcePath + ".sacooked";
+	}
+
+	bool writeCookedAsset(const std::string& sourcePath, const CookedAssetData& data)
+	{
+		SourceStamp stamp;
+		if (!readSourceStamp(sourcePath, stamp))
+		{
+			return false;
+		}
+
+		CookedHeader header;
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.magic, COOKED_MAGIC, sizeof(COOKED_MAGIC));
+		header.version = COOKED_ASSET_VERSION;
+		header.vertexStride = sizeof(Vertex);
+		header.normalDataStride = sizeof(NormalData);
+		header.sourceWriteTime = stamp.writeTime;
+		header.sourceSize = stamp.size;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			header.aabbMin[axis] = data.aabbMin[axis];
+			header.aabbMax[axis] = data.aabbMax[axis];
+		}
+
+		std::vector<uint8_t> blob(sizeof(CookedHeader));
+
+		std::string stringTable;
+		std::vector<CookedMeshEntry> meshTable;
+		std::vector<CookedTextureEntry> textureTable;
+		for (const CookedMeshData& mesh : data.meshes)
+		{
+			CookedMeshEntry entry;
+			entry.verticesOffset = appendSection(blob, mesh.vertices);
+			entry.normalDataOffset = appendSection(blob, mesh.normalData);
+			entry.indicesOffset = appendSection(blob, mesh.indices);
+			entry.numVertices = uint32_t(mesh.vertices.size());
+			entry.numIndices = uint32_t(mesh.indices.size());
+			entry.firstTexture = uint32_t(textureTable.size());
+			entry.numTextures = uint32_t(mesh.textures.size());
+			meshTable.push_back(entry);
+
+			for (const CookedTextureRef& texture : mesh.textures)
+			{
+				CookedTextureEntry textureEntry;
+				textureEntry.typeOffset = uint32_t(stringTable.size());
+				textureEntry.typeLength = uint32_t(texture.type.size());
+				stringTable += texture.type;
+				textureEntry.pathOffset = uint32_t(stringTable.size());
+				textureEntry.pathLength = uint32_t(texture.path.size());
+				stringTable += texture.path;
+				textureTable.push_back(textureEntry);
+			}
+		}
+
+		header.numMeshes = uint32_t(meshTable.size());
+		header.numTextures = uint32_t(textureTable.size());
+		header.meshTableOffset = appendSection(blob, meshTable);
+		header.textureTableOffset = appendSection(blob, textureTable);
+		header.stringTableOffset = appendSection(blob, stringTable.data(), stringTable.size());
+		header.stringTableSize = stringTable.size();
+
+		if (data.bHasHull)
+		{
+			header.bHasHull = 1;
+			header.hullNumPoints = uint32_t(data.hull.points.size());
+			header.hullNumEdges = uint32_t(data.hull.edges.size());
+			header.hullNumFaces = uint32_t(data.hull.faces.size());
+			header.hullPointsOffset = appendSection(blob, data.hull.points);
+			header.hullEdgesOffset = appendSection(blob, data.hull.edges);
+			header.hullFacesOffset = appendSection(blob, data.hull.faces);
+		}
+
+		header.fileSize = blob.size();
+		std::memcpy(blob.data(), &header, sizeof(header));
+
+		const std::string cookedPath = getCookedPath(sourcePath);
+		const std::string tempPath = makeUniqueTempPath(cookedPath);
+		std::error_code ec;
+		{
+			std::ofstream outFile(tempPath, std::ios::binary | std::ios::trunc);
+			if (!outFile.is_open())
+			{
+				logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "could not open %s for writing", tempPath.c_str());
+				return false;
+			}
+			outFile.write(reinterpret_cast<const char*>(blob.data()), std::streamsize(blob.size()));
+			outFile.close();
+			if (!outFile.good())
+			{
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		//every writer has its own temp file, so concurrent cooks of the same asset never interleave; the last rename wins with a complete file
+		std::filesystem::rename(tempPath, cookedPath, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			logf_sa(__FUNCTION__, LogLevel::LOG_WARNING, "could not replace %s", cookedPath.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// MappedFile
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open(const std::string& path)
+	{
+		close();
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+		fileHandle = file;
+		mappingHandle = mapping;
+		data = static_cast<const uint8_t*>(view);
+		size = size_t(fileSize.QuadPart);
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			::close(fd);
+			return false;
+		}
+		void* view = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd); //the mapping keeps its own reference to the file
+		if (view == MAP_FAILED)
+		{
+			return false;
+		}
+		data = static_cast<const uint8_t*>(view);
+		size = size_t(fileStat.st_size);
+#endif //_WIN32
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (!data)
+		{
+			return;
+		}
+#ifdef _WIN32
+		UnmapViewOfFile(data);
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+		mappingHandle = nullptr;
+		fileHandle = nullptr;
+#else
+		munmap(const_cast<uint8_t*>(data), size);
+#endif //_WIN32
+		data = nullptr;
+		size = 0;
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	// CookedAsset
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	sp<CookedAsset> CookedAsset::open(const std::string& sourcePath)
+	{
+		sp<CookedAsset> cooked = new_sp<CookedAsset>();
+		if (!cooked->file.open(getCookedPath(sourcePath)) || !cooked->validate(sourcePath))
+		{
+			return nullptr;
+		}
+		return cooked;
+	}
+
+	bool CookedAsset::validate(const std::string& sourcePath) const
+	{
+		const size_t fileSize = file.getSize();
+		if (fileSize < sizeof(CookedHeader))
+		{
+			return false;
+		}
+
+		const CookedHeader& header = *at<CookedHeader>(0);
+		if (std::memcmp(header.magic, COOKED_MAGIC, sizeof(COOKED_MAGIC)) != 0
+			|| header.version != COOKED_ASSET_VERSION
+			|| header.vertexStride != sizeof(Vertex)
+			|| header.normalDataStride != sizeof(NormalData)
+			|| header.fileSize != fileSize)
+		{
+			return false;
+		}
+
+		SourceStamp stamp;
+		if (!readSourceStamp(sourcePath, stamp) || stamp.writeTime != header.sourceWriteTime || stamp.size != header.sourceSize)
+		{
+			return false; //source was edited after cooking (or removed); caller falls back to assimp
+		}
+
+		//a truncated or corrupt blob must not hand out views past the end of the mapping
+		auto sectionFits = [fileSize](uint64_t offset, uint64_t count, uint64_t stride)
+		{
+			return offset <= fileSize && count <= (fileSize - offset) / stride;
+		};
+		if (!sectionFits(header.meshTableOffset, header.numMeshes, sizeof(CookedMeshEntry))
+			|| !sectionFits(header.textureTableOffset, header.numTextures, sizeof(CookedTextureEntry))
+			|| !sectionFits(header.stringTableOffset, header.stringTableSize, 1))
+		{
+			return false;
+		}
+
+		const CookedMeshEntry* meshTable = at<CookedMeshEntry>(header.meshTableOffset);
+		for (uint32_t meshIdx = 0; meshIdx < header.numMeshes; ++meshIdx)
+		{
+			const CookedMeshEntry& mesh = meshTable[meshIdx];
+			if (!sectionFits(mesh.verticesOffset, mesh.numVertices, sizeof(Vertex))
+				|| !sectionFits(mesh.normalDataOffset, mesh.numVertices, sizeof(NormalData))
+				|| !sectionFits(mesh.indicesOffset, mesh.numIndices, sizeof(uint32_t))
+				|| uint64_t(mesh.firstTexture) + mesh.numTextures > header.numTextures)
+			{
+				return false;
+			}
+		}
+
+		const CookedTextureEntry* textureTable = at<CookedTextureEntry>(header.textureTableOffset);
+		for (uint32_t textureIdx = 0; textureIdx < header.numTextures; ++textureIdx)
+		{
+			const CookedTextureEntry& texture = textureTable[textureIdx];
+			if (uint64_t(texture.typeOffset) + texture.typeLength > header.stringTableSize
+				|| uint64_t(texture.pathOffset) + texture.pathLength > header.stringTableSize)
+			{
+				return false;
+			}
+		}
+
+		if (header.bHasHull)
+		{
+			if (!sectionFits(header.hullPointsOffset, header.hullNumPoints, sizeof(glm::vec4))
+				|| !sectionFits(header.hullEdgesOffset, header.hullNumEdges, sizeof(glm::uvec2))
+				|| !sectionFits(header.hullFacesOffset, header.hullNumFaces, sizeof(glm::uvec4)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	uint32_t CookedAsset::getNumMeshes() const
+	{
+		return at<CookedHeader>(0)->numMeshes;
+	}
+
+	CookedAsset::MeshView CookedAsset::getMesh(uint32_t meshIdx) const
+	{
+		const CookedHeader& header = *at<CookedHeader>(0);
+		const CookedMeshEntry& entry = at<CookedMeshEntry>(header.meshTableOffset)[meshIdx];
+
+		MeshView view;
+		view.vertices = at<Vertex>(entry.verticesOffset);
+		view.normalData = at<NormalData>(entry.normalDataOffset);
+		view.numVertices = entry.numVertices;
+		view.indices = at<uint32_t>(entry.indicesOffset);
+		view.numIndices = entry.numIndices;
+
+		const char* strings = at<char>(header.stringTableOffset);
+		const CookedTextureEntry* textureTable = at<CookedTextureEntry>(header.textureTableOffset);
+		for (uint32_t textureIdx = entry.firstTexture; textureIdx < entry.firstTexture + entry.numTextures; ++textureIdx)
+		{
+			const CookedTextureEntry& texture = textureTable[textureIdx];
+			CookedTextureRef ref;
+			ref.type.assign(strings + texture.typeOffset, texture.typeLength);
+			ref.path.assign(strings + texture.pathOffset, texture.pathLength);
+			view.textures.push_back(std::move(ref));
+		}
+		return view;
+	}
+
+	bool CookedAsset::hasHull() const
+	{
+		return at<CookedHeader>(0)->bHasHull != 0;
+	}
+
+	CookedAsset::HullView CookedAsset::getHull() const
+	{
+		const CookedHeader& header = *at<CookedHeader>(0);
+
+		HullView view;
+		if (header.bHasHull)
+		{
+			view.points = at<glm::vec4>(header.hullPointsOffset);
+			view.numPoints = header.hullNumPoints;
+			view.edges = at<glm::uvec2>(header.hullEdgesOffset);
+			view.numEdges = header.hullNumEdges;
+			view.faces = at<glm::uvec4>(header.hullFacesOffset);
+			view.numFaces = header.hullNumFaces;
+		}
+		return view;
+	}
+
+	glm::vec3 CookedAsset::getAABBMin() const
+	{
+		const CookedHeader& header = *at<CookedHeader>(0);
+		return glm::vec3(header.aabbMin[0], header.aabbMin[1], header.aabbMin[2]);
+	}
+
+	glm::vec3 CookedAsset::getAABBMax() const
+	{
+		const CookedHeader& header = *at<CookedHeader>(0);
+		return glm::vec3(header.aabbMax[0], header.aabbMax[1], header.aabbMax[2]);
+	}
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "GameFramework/SAGameEntity.h"
+#include "Tools/ModelLoading/SAMesh.h"
+#include "Tools/RemoveSpecialMemberFunctionUtils.h"
+
+namespace SA
+{
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Cooked assets
+	//	A cooked asset is a binary blob written next to a model source ("model.obj" -> "model.obj.sacooked").
+	//	It holds the processed vertex/index data, the AABB, and optionally a preprocessed SAT hull,
+	//	laid out so a memory mapped file can be read in place without any parsing.
+	//	The blob records the source's write time and size; if the source changes the blob is
+	//	ignored and the asset is cooked again from the source after assimp loads it.
+	/////////////////////////////////////////////////////////////////////////////////////
+
+	/** bump whenever the layout below, Vertex, or NormalData changes */
+	constexpr uint32_t COOKED_ASSET_VERSION = 1;
+
+	std::string getCookedPath(const std::string& sourcePath);
+
+	struct CookedTextureRef
+	{
+		std::string type;
+		std::string path;
+	};
+
+	struct CookedMeshData
+	{
+		std::vector<Vertex> vertices;
+		std::vector<NormalData> normalData;
+		std::vector<uint32_t> indices;
+		std::vector<CookedTextureRef> textures;
+	};
+
+	/** mirrors SAT::Shape's points/edges/faces; edge = (indexA, indexB), face = (edge1.A, edge1.B, edge2.A, edge2.B) */
+	struct CookedHullData
+	{
+		std::vector<glm::vec4> points;
+		std::vector<glm::uvec2> edges;
+		std::vector<glm::uvec4> faces;
+	};
+
+	struct CookedAssetData
+	{
+		glm::vec3 aabbMin{ 0.f };
+		glm::vec3 aabbMax{ 0.f };
+		std::vector<CookedMeshData> meshes;
+		bool bHasHull = false;
+		CookedHullData hull;
+	};
+
+	/** writes to a temporary file and then swaps it in, so a crash mid-write never leaves a blob that looks valid */
+	bool writeCookedAsset(const std::string& sourcePath, const CookedAssetData& data);
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// Read only view of an entire file; unmapped on destruction
+	/////////////////////////////////////////////////////////////////////////////////////
+	class MappedFile : public RemoveCopies
+	{
+	public:
+		~MappedFile();
+		bool open(const std::string& path);
+		const uint8_t* getData() const { return data; }
+		size_t getSize() const { return size; }
+	private:
+		void close();
+	private:
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#endif //_WIN32
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	// A validated, mapped cooked asset. Views point directly into the mapping and are valid for the lifetime of this object.
+	/////////////////////////////////////////////////////////////////////////////////////
+	class CookedAsset : public RemoveCopies
+	{
+	public:
+		struct MeshView
+		{
+			const Vertex* vertices = nullptr;
+			const NormalData* normalData = nullptr;
+			uint32_t numVertices = 0;
+			const uint32_t* indices = nullptr;
+			uint32_t numIndices = 0;
+			std::vector<CookedTextureRef> textures;
+		};
+
+		struct HullView
+		{
+			const glm::vec4* points = nullptr;
+			uint32_t numPoints = 0;
+			const glm::uvec2* edges = nullptr;
+			uint32_t numEdges = 0;
+			const glm::uvec4* faces = nullptr;
+			uint32_t numFaces = 0;
+		};
+
+	public:
+		/** returns null if there is no blob, it is older than the source, or it was written by a different version */
+		static sp<CookedAsset> open(const std::string& sourcePath);
+
+		uint32_t getNumMeshes() const;
+		MeshView getMesh(uint32_t meshIdx) const;
+		bool hasHull() const;
+		HullView getHull() const;
+		glm::vec3 getAABBMin() const;
+		glm::vec3 getAABBMax() const;
+
+	private:
+		bool validate(const std::string& sourcePath) const;
+		template<typename T> const T* at(uint64_t offset) const { return reinterpret_cast<const T*>(file.getData() + offset); }
+	private:
+		MappedFile file;
+	};
+}
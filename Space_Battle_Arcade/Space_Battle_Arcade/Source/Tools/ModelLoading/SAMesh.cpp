@@ -7,6 +7,7 @@
 
 #include "Rendering/SAShader.h"
 #include "Rendering/OpenGLHelpers.h"
+#include "GameFramework/SAGameBase.h"
 
 
 namespace SA
@@ -14,6 +15,11 @@ namespace SA
 
 	void Mesh3D::setupMesh()
 	{
+		if (GameBase::isHeadless())
+		{
+			return; //vertex data stays on the CPU for collision; there is no GL context to upload to
+		}
+
 		ec(glBindVertexArray(0));
 		ec(glGenVertexArrays(1, &VAO));
 		ec(glGenBuffers(1, &VBO));
@@ -199,7 +205,7 @@ namespace SA
 	}
 
 	/** This really should be a private function, making visible for instancing tutorial */
-	GLuint Mesh3D::getVAO()
+	GLuint Mesh3D::getVAO() const
 	{
 		return VAO;
 	}
@@ -70,12 +70,14 @@ namespace SA
 
 		void draw(Shader& shader, bool bBindMaterials = true) const;
 		void drawInstanced(Shader& shader, unsigned int instanceCount, bool bBindTextures=true) const;
-		GLuint getVAO();
+		GLuint getVAO() const;
 		void setInstancedModelMatrixVBO(GLuint modelVBO);
 		void setInstancedModelMatricesData(glm::mat4* modelMatrices, unsigned int count);
 
 		const std::vector<Vertex>& getVertices() const { return vertices; }
 		const std::vector<unsigned int>& getIndices() const { return indices; }
+		const std::vector<NormalData>& getNormalData() const { return normalData; }
+		const std::vector<MaterialTexture>& getTextures() const { return textures; }
 
 		/** this is destructive and will invalidate any copies of this mesh as they share gpu resources; this is why encapsulation of mesh will be very important*/
 		void releaseGPUData();
@@ -1,4 +1,5 @@
 #include "Tools/ModelLoading/SAModel.h"
+#include "Tools/ModelLoading/SACookedAsset.h"
 
 #include <map>
 #include <chrono>
@@ -395,6 +396,11 @@ namespace SA
 
 	void Model3D::loadModel(std::string path)
 	{
+		if (loadCookedModel(path))
+		{
+			return;
+		}
+
 		//--------------------------------------------------------------------------------------------
 		//const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
 		//const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals); //smooth normals required for bob model
@@ -414,6 +420,13 @@ namespace SA
 		this->inverseSceneTransform.Inverse();
 
 		processNode(scene->mRootNode, scene);
+
+		//cook so later launches map the processed data instead of running assimp again
+		CookedAssetData cookedData;
+		if (buildCookedData(cookedData))
+		{
+			writeCookedAsset(path, cookedData);
+		}
 	}
 
 	void Model3D::processNode(aiNode* node, const aiScene* scene)
@@ -430,18 +443,79 @@ namespace SA
 		}
 	}
 
+	static const char* const DEFAULT_NORMAL_MAP_PATH = "GameData/engine_assets/NormalMap_Default.png";
+
 	MaterialTexture generateDefaultNormalMapTextures()
 	{
 		AssetSystem& assetSystem = GameBase::get().getAssetSystem();
 
 		MaterialTexture normalMap;
-		normalMap.path = "GameData/engine_assets/NormalMap_Default.png";
+		normalMap.path = DEFAULT_NORMAL_MAP_PATH;
 		normalMap.type = "texture_normalmap";
 		assetSystem.loadTexture(normalMap.path.c_str(), normalMap.id);
 
 		return normalMap;
 	}
 
+	bool Model3D::loadCookedModel(const std::string& path)
+	{
+		sp<CookedAsset> cooked = CookedAsset::open(path);
+		if (!cooked || cooked->getNumMeshes() == 0)
+		{
+			return false;
+		}
+
+		directory = path.substr(0, path.find_last_of('/'));
+		cachedScene = nullptr;
+		inverseSceneTransform = aiMatrix4x4{}; //identity; only used by bone animation, which is never cooked
+		cachedAABB = std::make_tuple(cooked->getAABBMin(), cooked->getAABBMax());
+
+		for (uint32_t meshIdx = 0; meshIdx < cooked->getNumMeshes(); ++meshIdx)
+		{
+			CookedAsset::MeshView view = cooked->getMesh(meshIdx);
+
+			std::vector<Vertex> vertices(view.vertices, view.vertices + view.numVertices);
+			std::vector<NormalData> normalData(view.normalData, view.normalData + view.numVertices);
+			std::vector<uint32_t> indices(view.indices, view.indices + view.numIndices);
+			std::vector<VertexBoneData> vertexBoneData(vertices.size());
+			std::map<std::string, Bone> nameToBoneMap;
+
+			std::vector<MaterialTexture> textures;
+			for (const CookedTextureRef& textureRef : view.textures)
+			{
+				textures.push_back(textureRef.path == DEFAULT_NORMAL_MAP_PATH ? generateDefaultNormalMapTextures() : loadModelRelativeTexture(textureRef.path, textureRef.type));
+			}
+
+			meshes.push_back(Mesh3D(vertices, textures, indices, normalData, vertexBoneData, nameToBoneMap));
+		}
+		return true;
+	}
+
+	bool Model3D::buildCookedData(CookedAssetData& outData) const
+	{
+		if (!allBonesByName.empty() || (cachedScene && cachedScene->HasAnimations()))
+		{
+			return false;
+		}
+
+		outData.aabbMin = std::get<0>(cachedAABB);
+		outData.aabbMax = std::get<1>(cachedAABB);
+		outData.meshes.clear();
+		for (const Mesh3D& mesh : meshes)
+		{
+			CookedMeshData cookedMesh;
+			cookedMesh.vertices = mesh.getVertices();
+			cookedMesh.normalData = mesh.getNormalData();
+			cookedMesh.indices.assign(mesh.getIndices().begin(), mesh.getIndices().end());
+			for (const MaterialTexture& texture : mesh.getTextures())
+			{
+				cookedMesh.textures.push_back(CookedTextureRef{ texture.type, texture.path });
+			}
+			outData.meshes.push_back(std::move(cookedMesh));
+		}
+		return true;
+	}
+
 
 	Mesh3D Model3D::processMesh(aiMesh* mesh, const aiScene* scene, const aiNode* parentNode)
 	{
@@ -587,35 +661,32 @@ namespace SA
 		{
 			aiString str;
 			mat->GetTexture(type, i, &str);
-			std::string relativePath = std::string(str.C_Str());
-
-			std::string filepath = directory + std::string("/") + relativePath;
-
-			bool bShouldSkip = false;
-			for (uint32_t textureIdx = 0; textureIdx < texturesLoaded.size(); ++textureIdx)
-			{
-				if (texturesLoaded[textureIdx].path == relativePath)
-				{
-					//already loaded this texture, just the cached texture information
-					textures.push_back(texturesLoaded[textureIdx]);
-					bShouldSkip = true;
-					break;
-				}
-			}
+			textures.push_back(loadModelRelativeTexture(std::string(str.C_Str()), typeName));
+		}
+		return textures;
+	}
 
-			if (!bShouldSkip)
+	MaterialTexture Model3D::loadModelRelativeTexture(const std::string& relativePath, const std::string& typeName)
+	{
+		for (uint32_t textureIdx = 0; textureIdx < texturesLoaded.size(); ++textureIdx)
+		{
+			if (texturesLoaded[textureIdx].path == relativePath)
 			{
-				MaterialTexture texture;
-				texture.id = Utils::loadTextureToOpengl(filepath.c_str());
-				texture.type = typeName;
-				texture.path = relativePath;
-				textures.push_back(texture);
-
-				//cache for later texture loads
-				texturesLoaded.push_back(texture);
+				//already loaded this texture, just the cached texture information
+				return texturesLoaded[textureIdx];
 			}
 		}
-		return textures;
+
+		std::string filepath = directory + std::string("/") + relativePath;
+
+		MaterialTexture texture;
+		texture.id = Utils::loadTextureToOpengl(filepath.c_str());
+		texture.type = typeName;
+		texture.path = relativePath;
+
+		//cache for later texture loads
+		texturesLoaded.push_back(texture);
+		return texture;
 	}
 
 	void Model3D::updateCachedAABB(const glm::vec3& vertexPosition)
@@ -15,6 +15,7 @@
 
 namespace SA
 {
+	struct CookedAssetData;
 
 	/** This probably isn't the ideal system for animations, but more a first pass to get interpolation working */
 	struct AnimationData
@@ -53,14 +54,19 @@ namespace SA
 		void getMeshVAOS(std::vector<unsigned int>& outVAOs);
 		const std::vector<Mesh3D>& getMeshes() const { return meshes; };
 
+		/** fills the cookable parts of this model; returns false for skinned/animated models, which still require the assimp scene */
+		bool buildCookedData(CookedAssetData& outData) const;
+
 	private://model/mesh methods
 
 		void loadModel(std::string path);
+		bool loadCookedModel(const std::string& path);
 
 		void processNode(aiNode* node, const aiScene* scene);
 		Mesh3D processMesh(aiMesh* mesh, const aiScene* scene, const aiNode* parentNode);
 
 		std::vector<MaterialTexture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+		MaterialTexture loadModelRelativeTexture(const std::string& relativePath, const std::string& typeName);
 
 	private: 
 		void releaseGPUData();
@@ -89,7 +95,7 @@ namespace SA
 		/** This dtor will clean up graphs loaded; thus, this is a member variable to make lifetime of assimp graphs the same as the instance of this object.*/
 		Assimp::Importer importer;
 		std::set<aiNode*> skeletonRelevantNode;		//memory managed by importer
-		const aiScene* cachedScene;					//memory managed by importer
+		const aiScene* cachedScene = nullptr;		//memory managed by importer; null when loaded from a cooked asset
 		aiMatrix4x4 inverseSceneTransform;
 
 		std::tuple<glm::vec3, glm::vec3> cachedAABB;
@@ -1,6 +1,7 @@
 #include "SACollisionHelpers.h"
 #include "ModelLoading/SAModel.h"
 #include "ModelLoading/SAMesh.h"
+#include "ModelLoading/SACookedAsset.h"
 #include "ReferenceCode/OpenGL/Algorithms/SeparatingAxisTheorem/SATRenderDebugUtils.h"
 #include "Rendering/RenderData.h"
 #include "GameFramework/SARenderSystem.h"
@@ -39,6 +40,72 @@ namespace SA
 		return triProcessor;
 	}
 
+	sp<SAT::DynamicTriangleMeshShape::TriangleProcessor> loadCookedCollisionTriangles(const std::string& modelPath)
+	{
+		using TriangleProcessor = SAT::DynamicTriangleMeshShape::TriangleProcessor;
+
+		sp<CookedAsset> cooked = CookedAsset::open(modelPath);
+		if (!cooked || !cooked->hasHull())
+		{
+			return nullptr;
+		}
+
+		CookedAsset::HullView hull = cooked->getHull();
+		std::vector<glm::vec4> points(hull.points, hull.points + hull.numPoints);
+
+		std::vector<SAT::Shape::EdgePointIndices> edges;
+		edges.reserve(hull.numEdges);
+		for (uint32_t edgeIdx = 0; edgeIdx < hull.numEdges; ++edgeIdx)
+		{
+			edges.push_back(SAT::Shape::EdgePointIndices{ hull.edges[edgeIdx].x, hull.edges[edgeIdx].y });
+		}
+
+		std::vector<SAT::Shape::FacePointIndices> faces;
+		faces.reserve(hull.numFaces);
+		for (uint32_t faceIdx = 0; faceIdx < hull.numFaces; ++faceIdx)
+		{
+			const glm::uvec4& face = hull.faces[faceIdx];
+			faces.push_back(SAT::Shape::FacePointIndices{ { face.x, face.y }, { face.z, face.w } });
+		}
+
+		//indices are trusted only as far as the point count; a bad blob should fall back rather than crash in SAT
+		for (const SAT::Shape::EdgePointIndices& edge : edges)
+		{
+			if (edge.indexA >= points.size() || edge.indexB >= points.size()) { return nullptr; }
+		}
+		for (const SAT::Shape::FacePointIndices& face : faces)
+		{
+			if (face.edge1.indexA >= points.size() || face.edge1.indexB >= points.size()
+				|| face.edge2.indexA >= points.size() || face.edge2.indexB >= points.size())
+			{
+				return nullptr;
+			}
+		}
+
+		return new_sp<TriangleProcessor>(std::move(points), std::move(edges), std::move(faces));
+	}
+
+	bool cookCollisionTriangles(const std::string& modelPath, const Model3D& model, const SAT::DynamicTriangleMeshShape::TriangleProcessor& triProcessor)
+	{
+		CookedAssetData cookedData;
+		if (!model.buildCookedData(cookedData))
+		{
+			return false;
+		}
+
+		cookedData.bHasHull = true;
+		cookedData.hull.points = triProcessor.getPoints();
+		for (const SAT::Shape::EdgePointIndices& edge : triProcessor.getEdgeIndices())
+		{
+			cookedData.hull.edges.emplace_back(edge.indexA, edge.indexB);
+		}
+		for (const SAT::Shape::FacePointIndices& face : triProcessor.getFaceIndices())
+		{
+			cookedData.hull.faces.emplace_back(face.edge1.indexA, face.edge1.indexB, face.edge2.indexA, face.edge2.indexB);
+		}
+		return writeCookedAsset(modelPath, cookedData);
+	}
+
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	// ShapeRenderWrapper
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 
 #include "ReferenceCode/OpenGL/Algorithms/SeparatingAxisTheorem/SATComponent.h"
 
@@ -22,6 +23,12 @@ namespace SA
 
 	SAT::DynamicTriangleMeshShape::TriangleProcessor modelToCollisionTriangles(const Model3D& model);
 
+	/** the preprocessed hull stored in a model's cooked asset; null if the blob is missing, stale, or was cooked without a hull */
+	sp<SAT::DynamicTriangleMeshShape::TriangleProcessor> loadCookedCollisionTriangles(const std::string& modelPath);
+
+	/** re-cooks the model with its processed hull so later loads skip both assimp and modelToCollisionTriangles */
+	bool cookCollisionTriangles(const std::string& modelPath, const Model3D& model, const SAT::DynamicTriangleMeshShape::TriangleProcessor& triProcessor);
+
 	//Clang require this be defined outside the scope of the ShapeRendererWrapper class because it uses default initializers.
 	struct ShapeRenderOverrides
 	{
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include "Rendering/SAShader.h"
 #include "Rendering/OpenGLHelpers.h"
+#include "GameFramework/SAGameBase.h"
 
 namespace SA
 {
@@ -69,6 +70,11 @@ namespace SA
 
 		GLuint loadTextureToOpengl(const char* relative_filepath, int texture_unit /*= -1*/, bool useGammaCorrection /*= false*/)
 		{
+			if (GameBase::isHeadless())
+			{
+				return 0; //no GL context; model materials are never bound without render dispatch
+			}
+
 			int img_width, img_height, img_nrChannels;
 			unsigned char* textureData = stbi_load(relative_filepath, &img_width, &img_height, &img_nrChannels, 0);
 			if (!textureData)
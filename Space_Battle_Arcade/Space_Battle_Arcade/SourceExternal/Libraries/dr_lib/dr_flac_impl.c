@@ -0,0 +1,5 @@
+//instructions for dr_lib's dr_flac require that you create a .c file and define a preprocessor macro before including the .h.
+//this seems to generate function bodies for the linker to link against.
+
+#define DR_FLAC_IMPLEMENTATION
+#include "Libraries/dr_lib/dr_flac.h"
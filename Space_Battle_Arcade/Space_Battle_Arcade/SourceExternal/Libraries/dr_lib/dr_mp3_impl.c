@@ -0,0 +1,5 @@
+//instructions for dr_lib's dr_mp3 require that you create a .c file and define a preprocessor macro before including the .h.
+//this seems to generate function bodies for the linker to link against.
+
+#define DR_MP3_IMPLEMENTATION
+#include "Libraries/dr_lib/dr_mp3.h"